@@ -188,7 +188,7 @@ static void isAnsweringMachine(struct tris_channel *chan, void *data)
 		TRIS_APP_ARG(argMaximumWordLength);
 	);
 
-	tris_verb(3, "AMD: %s %s %s (Fmt: %d)\n", chan->name ,chan->cid.cid_ani, chan->cid.cid_rdnis, chan->readformat);
+	tris_verb(3, "AMD: %s %s %s (Fmt: %lld)\n", chan->name ,chan->cid.cid_ani, chan->cid.cid_rdnis, (long long) chan->readformat);
 
 	/* Lets parse the arguments. */
 	if (!tris_strlen_zero(parse)) {
@@ -202,7 +202,7 @@ static struct tris_channel *start_3broadcast(const char *listenno, const char *a
 	tris_find_ourip(&ourip, bindaddr);
 	
 	char dest[128];
-	int format = TRIS_FORMAT_SLINEAR;
+	format_t format = TRIS_FORMAT_SLINEAR;
 	int reason = 0;
 	snprintf(dest, sizeof(dest), "%s@%s:5060", announcer, tris_inet_ntoa(ourip));
 	snprintf(data, sizeof(data), "broadcast.wav,,%s", drop_time);
@@ -368,7 +368,7 @@ static int record_exec(struct tris_channel *chan, void *data)
 	int maxduration = 0;		/* max duration of recording in milliseconds */
 	int gottimeout = 0;		/* did we timeout for maxduration exceeded? */
 	int terminator = '#';
-	int rfmt = 0;
+	format_t rfmt = 0;
 	int ioflags;
 	int waitres;
 	time_t now;
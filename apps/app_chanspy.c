@@ -1249,7 +1249,7 @@ static int chanspy_exec(struct tris_channel *chan, void *data)
 	char *recbase = NULL;
 	int fd = 0;
 	struct tris_flags flags;
-	int oldwf = 0;
+	format_t oldwf = 0;
 	int volfactor = 0;
 	int res;
 	char *mailbox = NULL;
@@ -1341,7 +1341,7 @@ static int extenspy_exec(struct tris_channel *chan, void *data)
 	char *recbase = NULL;
 	int fd = 0;
 	struct tris_flags flags;
-	int oldwf = 0;
+	format_t oldwf = 0;
 	int volfactor = 0;
 	int res;
 	char *mailbox = NULL;
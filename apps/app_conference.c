@@ -616,6 +616,8 @@ static int unload_module( void )
 	res |= tris_manager_unregister("VideoconfSetTalking");
 	res |= tris_manager_unregister("VideoconfUserDetail");
 
+	stop_conference_mixers() ;
+
 	return res;
 }
 
@@ -51,7 +51,7 @@ static char *app = "Echo";
 static int echo_exec(struct tris_channel *chan, void *data)
 {
 	int res = -1;
-	int format;
+	format_t format;
 
 	format = tris_best_codec(chan->nativeformats);
 	tris_set_write_format(chan, format);
@@ -362,8 +362,8 @@ struct tris_generator generator = {
 static int transmit_audio(fax_session *s)
 {
 	int res = -1;
-	int original_read_fmt = TRIS_FORMAT_SLINEAR;
-	int original_write_fmt = TRIS_FORMAT_SLINEAR;
+	format_t original_read_fmt = TRIS_FORMAT_SLINEAR;
+	format_t original_write_fmt = TRIS_FORMAT_SLINEAR;
 	fax_state_t fax;
 	t30_state_t *t30state;
 	struct tris_frame *inf = NULL;
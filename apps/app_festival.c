@@ -164,7 +164,7 @@ static int send_waveform_to_channel(struct tris_channel *chan, char *waveform, i
 	int fds[2];
 	int pid = -1;
 	int needed = 0;
-	int owriteformat;
+	format_t owriteformat;
 	struct tris_frame *f;
 	struct myframe {
 		struct tris_frame f;
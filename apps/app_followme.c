@@ -717,7 +717,7 @@ static struct tris_channel *wait_for_winner(struct findme_user_listptr *findme_u
 						tris_verb(3, "%s stopped sounds\n", winner->name);
 						break;
 					default:
-						tris_debug(1, "Dunno what to do with control type %d\n", f->subclass);
+						tris_debug(1, "Dunno what to do with control type %d\n", (int) f->subclass);
 						break;
 					}
 				} 
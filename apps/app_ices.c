@@ -111,7 +111,7 @@ static int ices_exec(struct tris_channel *chan, void *data)
 	int ms = -1;
 	int pid = -1;
 	int flags;
-	int oreadformat;
+	format_t oreadformat;
 	struct timeval last;
 	struct tris_frame *f;
 	char filename[256]="";
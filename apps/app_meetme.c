@@ -30,14 +30,18 @@
  */
 
 /*** MODULEINFO
-	<depend>dahdi</depend>
+	<use>dahdi</use>
  ***/
 
 #include "trismedia.h"
 
 TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 238185 $")
 
+#include <sys/socket.h>
+
+#ifdef HAVE_DAHDI
 #include <dahdi/user.h>
+#endif
 
 #include "trismedia/lock.h"
 #include "trismedia/file.h"
@@ -61,6 +65,8 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 238185 $")
 #include "trismedia/paths.h"
 #include "trismedia/acl.h"
 #include "trismedia/res_odbc.h"
+#include "trismedia/timing.h"
+#include "trismedia/mix.h"
 
 #include "enter.h"
 #include "leave.h"
@@ -207,8 +213,11 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 238185 $")
 			<para>Enters the user into a specified MeetMe conference.  If the <replaceable>confno</replaceable>
 			is omitted, the user will be prompted to enter one.  User can exit the conference by hangup, or
 			if the <literal>p</literal> option is specified, by pressing <literal>#</literal>.</para>
-			<note><para>The DAHDI kernel modules and at least one hardware driver (or dahdi_dummy)
-			must be present for conferencing to operate properly. In addition, the chan_dahdi channel driver
+			<note><para>Conferences are mixed by DAHDI when its kernel modules are present, and
+			by mixer threads in Trismedia otherwise.  The <literal>mixer</literal> setting in the
+			<literal>general</literal> section of <filename>meetme.conf</filename> picks one of
+			<literal>auto</literal>, <literal>dahdi</literal> or <literal>software</literal> when
+			the module loads.  When DAHDI mixes the conferences, the chan_dahdi channel driver
 			must be loaded for the <literal>i</literal> and <literal>r</literal> options to operate at
 			all.</para></note>
 		</description>
@@ -429,6 +438,13 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 238185 $")
 
 /*! each buffer is 20ms, so this is 640ms total */
 #define DEFAULT_AUDIO_BUFFERS  32
+#ifdef HAVE_DAHDI
+#define MIN_AUDIO_BUFFERS  DAHDI_DEFAULT_NUM_BUFS
+#define MAX_AUDIO_BUFFERS  DAHDI_MAX_NUM_BUFS
+#else
+#define MIN_AUDIO_BUFFERS  2
+#define MAX_AUDIO_BUFFERS  32
+#endif
 #define DEFAULT_MAX_ROOMS  10
 
 #define MAX_DIALS 256
@@ -625,7 +641,7 @@ struct tris_conference {
 	struct tris_channel *chan;               /*!< Announcements channel */
 	struct tris_channel *lchan;              /*!< Listen/Record channel */
 	int fd;                                 /*!< Announcements fd */
-	int dahdiconf;                            /*!< DAHDI Conf # */
+	int mixconf;                            /*!< Conf # of the mixer */
 	int users;                              /*!< Number of active users */
 	int markedusers;                        /*!< Number of marked users */
 	int maxusers;                           /*!< Participant limit if scheduled */
@@ -924,19 +940,929 @@ static char *istalking(int x)
 		return "(not talking)";
 }
 
+/*!
+ * \brief Conference modes of a pseudo channel
+ *
+ * These follow the DAHDI conference modes.  A pseudo channel in
+ * MEETME_CONF_CONF mode talks into the conference if MEETME_CONF_TALKER
+ * is set and hears it if MEETME_CONF_LISTENER is set.  MEETME_CONF_CONFANN
+ * always talks, MEETME_CONF_CONFMON always listens and MEETME_CONF_CONFANNMON
+ * does both.
+ */
+enum {
+	MEETME_CONF_CONF = 4,
+	MEETME_CONF_CONFANN = 5,
+	MEETME_CONF_CONFMON = 6,
+	MEETME_CONF_CONFANNMON = 7,
+	MEETME_CONF_MODE_MASK = 0xff,
+	MEETME_CONF_TALKER = (1 << 8),
+	MEETME_CONF_LISTENER = (1 << 9),
+};
+
+/*! \brief Conference a pseudo channel is in, 0 for none */
+struct meetme_confinfo {
+	int confno;
+	int confmode;
+};
+
+/*! \brief What mixes the conferences */
+enum meetme_mixer_type {
+	/*! DAHDI if /dev/dahdi/pseudo can be opened, the software mixer otherwise */
+	MEETME_MIXER_AUTO,
+	/*! The DAHDI kernel conferencing */
+	MEETME_MIXER_DAHDI,
+	/*! Mixer threads in Trismedia */
+	MEETME_MIXER_SOFTWARE,
+};
+
+static enum meetme_mixer_type mixer_type = MEETME_MIXER_AUTO;
+
+/*! Set when the DAHDI conferencing is used, decided when the module loads */
+static int use_dahdi;
+
+/*! \brief Samples in one mixing interval */
+#define MEETME_MIX_SAMPLES  (CONF_SIZE / 2)
+
+/*! \brief Length of one mixing interval in milliseconds */
+#define MEETME_MIX_INTERVAL  (MEETME_MIX_SAMPLES / 8)
+
+/*! \brief Intervals of audio buffered from a talker, older audio is dropped */
+#define MEETME_MIX_BUFFERS  4
+
+/*! \brief Most mixer threads, one is started per cpu up to this many */
+#define MEETME_MIXERS_MAX  8
+
+/*! \brief Intervals a mixer catches up on before it drops them */
+#define MEETME_MIX_MAX_BEHIND  5
+
+/*!
+ * \brief A pseudo channel of the software mixer
+ *
+ * The user of the pseudo channel gets one end of a socket pair and reads
+ * and writes audio on it like on a DAHDI pseudo channel, the mixer thread
+ * owns the other end.
+ */
+struct meetme_port {
+	/*! Mixer end of the socket pair */
+	int fd;
+	/*! End handed out by meetme_pseudo_open() */
+	int appfd;
+	int confmode;
+	/*! Signed linear audio, mu-law otherwise */
+	unsigned int linear:1;
+	/*! Contributed to the mix of the current interval */
+	unsigned int talking:1;
+	struct meetme_mixconf *conf;
+	/*! Samples received but not mixed yet */
+	int samples;
+	short buf[MEETME_MIX_SAMPLES * MEETME_MIX_BUFFERS];
+	/*! Audio mixed in the current interval */
+	short talk[MEETME_MIX_SAMPLES];
+	TRIS_LIST_ENTRY(meetme_port) list;
+};
+
+/*! \brief A conference of the software mixer */
+struct meetme_mixconf {
+	int confno;
+	struct meetme_mixer *mixer;
+	TRIS_LIST_HEAD_NOLOCK(, meetme_port) ports;
+	/*! Entry in the conferences of the mixer */
+	TRIS_LIST_ENTRY(meetme_mixconf) list;
+	/*! Entry in mixconfs */
+	TRIS_LIST_ENTRY(meetme_mixconf) entry;
+};
+
+/*! \brief A software mixer thread */
+struct meetme_mixer {
+	pthread_t thread;
+	/*! Timing source, NULL if none could be opened */
+	struct tris_timer *timer;
+	/*! Protects the conferences of this mixer and their ports */
+	tris_mutex_t lock;
+	tris_cond_t cond;
+	TRIS_LIST_HEAD_NOLOCK(, meetme_mixconf) confs;
+	/*! Number of conferences */
+	unsigned int count;
+	unsigned int stop:1;
+};
+
+static struct meetme_mixer mixers[MEETME_MIXERS_MAX];
+static int mixer_count;
+
+/*! \brief Software mixer conferences, by conference number */
+static TRIS_LIST_HEAD_NOLOCK_STATIC(mixconfs, meetme_mixconf);
+
+/*! \brief Protects mixconfs and the conference of every port, taken before a mixer lock */
+TRIS_MUTEX_DEFINE_STATIC(mixconfs_lock);
+
+static int mixconf_next = 1;
+
+/*! \brief Software mixer pseudo channels, by the fd handed out */
+static struct ao2_container *mixer_ports;
+
+#define MIXER_PORT_BUCKETS 127
+
+static int mixer_port_hash(const void *obj, const int flags)
+{
+	const struct meetme_port *port = obj;
+
+	return port->appfd;
+}
+
+static int mixer_port_cmp(void *obj, void *arg, int flags)
+{
+	struct meetme_port *port = obj, *port2 = arg;
+
+	return port->appfd == port2->appfd ? CMP_MATCH | CMP_STOP : 0;
+}
+
+static void mixer_port_destructor(void *obj)
+{
+	struct meetme_port *port = obj;
+
+	if (port->fd > -1) {
+		close(port->fd);
+	}
+}
+
+static struct meetme_port *mixer_port_find(int fd)
+{
+	struct meetme_port tmp = { .appfd = fd, };
+
+	return mixer_ports ? ao2_find(mixer_ports, &tmp, OBJ_POINTER) : NULL;
+}
+
+static inline int mixer_port_talks(int confmode)
+{
+	switch (confmode & MEETME_CONF_MODE_MASK) {
+	case MEETME_CONF_CONF:
+		return confmode & MEETME_CONF_TALKER;
+	case MEETME_CONF_CONFANN:
+	case MEETME_CONF_CONFANNMON:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static inline int mixer_port_listens(int confmode)
+{
+	switch (confmode & MEETME_CONF_MODE_MASK) {
+	case MEETME_CONF_CONF:
+		return confmode & MEETME_CONF_LISTENER;
+	case MEETME_CONF_CONFMON:
+	case MEETME_CONF_CONFANNMON:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/*!
+ * \brief Take the audio written to a port since the last interval
+ *
+ * Signed linear ports are fed as frames arrive on a channel, so when they
+ * get ahead of the mixer the oldest audio is dropped.  Mu-law ports carry
+ * announcements that are written as fast as the socket takes them, those
+ * are only read as far as there is room, which makes the writer wait.
+ *
+ * \note Called with the lock of the mixer held
+ */
+static void mixer_port_fill(struct meetme_port *port)
+{
+	unsigned char data[sizeof(port->buf)];
+	int room, res, samples, i;
+
+	for (;;) {
+		room = ARRAY_LEN(port->buf) - port->samples;
+
+		if (!port->linear) {
+			/* Find out how long the next announcement packet is without taking it */
+			res = recv(port->fd, data, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT);
+			if (res <= 0 || res > room) {
+				break;
+			}
+		}
+
+		if ((res = recv(port->fd, data, sizeof(data), MSG_DONTWAIT)) <= 0) {
+			break;
+		}
+
+		if (!mixer_port_talks(port->confmode)) {
+			continue;
+		}
+
+		samples = port->linear ? res / 2 : res;
+		if (samples > room) {
+			/* Drop the oldest audio to make room */
+			int drop = MIN(samples - room, port->samples);
+
+			memmove(port->buf, port->buf + drop, (port->samples - drop) * sizeof(port->buf[0]));
+			port->samples -= drop;
+			samples = MIN(samples, (int) ARRAY_LEN(port->buf) - port->samples);
+		}
+
+		if (port->linear) {
+			memcpy(port->buf + port->samples, data, samples * sizeof(port->buf[0]));
+		} else {
+			for (i = 0; i < samples; i++) {
+				port->buf[port->samples + i] = TRIS_MULAW(data[i]);
+			}
+		}
+		port->samples += samples;
+	}
+}
+
+/*!
+ * \brief Mix one interval of a conference
+ *
+ * \note Called with the lock of the mixer held
+ */
+static void mixer_conf_mix(struct meetme_mixconf *conf)
+{
+	struct meetme_port *port;
+	int acc[MEETME_MIX_SAMPLES];
+	short mix[MEETME_MIX_SAMPLES];
+	unsigned char law[MEETME_MIX_SAMPLES];
+	int samples, i;
+
+	memset(acc, 0, sizeof(acc));
+
+	TRIS_LIST_TRAVERSE(&conf->ports, port, list) {
+		mixer_port_fill(port);
+
+		port->talking = 0;
+		if (!port->samples) {
+			continue;
+		}
+
+		samples = MIN(port->samples, MEETME_MIX_SAMPLES);
+		memcpy(port->talk, port->buf, samples * sizeof(port->talk[0]));
+		memset(port->talk + samples, 0, (MEETME_MIX_SAMPLES - samples) * sizeof(port->talk[0]));
+		port->samples -= samples;
+		memmove(port->buf, port->buf + samples, port->samples * sizeof(port->buf[0]));
+
+		tris_mix_accumulate(acc, port->talk, MEETME_MIX_SAMPLES);
+		port->talking = 1;
+	}
+
+	TRIS_LIST_TRAVERSE(&conf->ports, port, list) {
+		if (!mixer_port_listens(port->confmode)) {
+			continue;
+		}
+
+		/* Nobody hears themselves */
+		tris_mix_minus(mix, acc, port->talking ? port->talk : NULL, MEETME_MIX_SAMPLES);
+
+		/* A listener that does not keep up misses this interval */
+		if (port->linear) {
+			send(port->fd, mix, sizeof(mix), MSG_DONTWAIT | MSG_NOSIGNAL);
+		} else {
+			for (i = 0; i < MEETME_MIX_SAMPLES; i++) {
+				law[i] = TRIS_LIN2MU(mix[i]);
+			}
+			send(port->fd, law, sizeof(law), MSG_DONTWAIT | MSG_NOSIGNAL);
+		}
+	}
+}
+
+/*!
+ * \brief Wait for the next interval of a mixer
+ *
+ * With a timing source the timer sets the pace, and next is pulled back
+ * when the timer fires before it.  Without one the thread sleeps until next.
+ */
+static void mixer_wait(struct meetme_mixer *mixer, struct timeval *next)
+{
+	struct timeval now = tris_tvnow();
+	int64_t late = tris_tvdiff_ms(now, *next);
+
+	if (late >= MEETME_MIX_INTERVAL * MEETME_MIX_MAX_BEHIND) {
+		/* Too far behind to catch up */
+		*next = now;
+		return;
+	} else if (late >= MEETME_MIX_INTERVAL) {
+		/* Behind, mix the next interval right away */
+		return;
+	}
+
+	if (mixer->timer) {
+		int fd = tris_timer_fd(mixer->timer);
+		int ms = MEETME_MIX_INTERVAL * 2;
+
+		if (tris_waitfor_n_fd(&fd, 1, &ms, NULL) == fd) {
+			tris_timer_ack(mixer->timer, 1);
+		}
+
+		now = tris_tvnow();
+		if (tris_tvcmp(now, *next) < 0) {
+			*next = now;
+		}
+	} else if (late < 0) {
+		usleep(-late * 1000);
+	}
+}
+
+static void *mixer_thread(void *data)
+{
+	struct meetme_mixer *mixer = data;
+	struct meetme_mixconf *conf;
+	struct timeval next = tris_tvnow();
+
+	tris_mutex_lock(&mixer->lock);
+	while (!mixer->stop) {
+		if (TRIS_LIST_EMPTY(&mixer->confs)) {
+			tris_cond_wait(&mixer->cond, &mixer->lock);
+			next = tris_tvnow();
+			continue;
+		}
+
+		TRIS_LIST_TRAVERSE(&mixer->confs, conf, list) {
+			mixer_conf_mix(conf);
+		}
+		tris_mutex_unlock(&mixer->lock);
+
+		next = tris_tvadd(next, tris_samp2tv(MEETME_MIX_SAMPLES, 8000));
+		mixer_wait(mixer, &next);
+
+		tris_mutex_lock(&mixer->lock);
+	}
+	tris_mutex_unlock(&mixer->lock);
+
+	return NULL;
+}
+
+static void mixers_stop(void)
+{
+	struct meetme_mixer *mixer;
+	int i;
+
+	for (i = 0; i < mixer_count; i++) {
+		mixer = &mixers[i];
+
+		tris_mutex_lock(&mixer->lock);
+		mixer->stop = 1;
+		tris_cond_signal(&mixer->cond);
+		tris_mutex_unlock(&mixer->lock);
+
+		pthread_join(mixer->thread, NULL);
+
+		if (mixer->timer) {
+			tris_timer_close(mixer->timer);
+		}
+		tris_cond_destroy(&mixer->cond);
+		tris_mutex_destroy(&mixer->lock);
+	}
+	mixer_count = 0;
+
+	if (mixer_ports) {
+		ao2_ref(mixer_ports, -1);
+		mixer_ports = NULL;
+	}
+}
+
+static int mixers_start(void)
+{
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int count = MAX(1, MIN(cpus, MEETME_MIXERS_MAX));
+	struct meetme_mixer *mixer;
+
+	if (!(mixer_ports = ao2_container_alloc(MIXER_PORT_BUCKETS, mixer_port_hash, mixer_port_cmp))) {
+		return -1;
+	}
+
+	while (mixer_count < count) {
+		mixer = &mixers[mixer_count];
+
+		memset(mixer, 0, sizeof(*mixer));
+		tris_mutex_init(&mixer->lock);
+		tris_cond_init(&mixer->cond, NULL);
+
+		if ((mixer->timer = tris_timer_open()) && tris_timer_set_rate(mixer->timer, 1000 / MEETME_MIX_INTERVAL)) {
+			tris_timer_close(mixer->timer);
+			mixer->timer = NULL;
+		}
+		if (!mixer->timer) {
+			tris_log(LOG_WARNING, "No timing source for MeetMe mixer %d, falling back to sleeping\n", mixer_count);
+		}
+
+		if (tris_pthread_create_background(&mixer->thread, NULL, mixer_thread, mixer)) {
+			tris_log(LOG_ERROR, "Unable to start MeetMe mixer %d\n", mixer_count);
+			if (mixer->timer) {
+				tris_timer_close(mixer->timer);
+			}
+			tris_cond_destroy(&mixer->cond);
+			tris_mutex_destroy(&mixer->lock);
+			break;
+		}
+		mixer_count++;
+	}
+
+	if (!mixer_count) {
+		mixers_stop();
+		return -1;
+	}
+
+	tris_verb(2, "MeetMe conferences are mixed by %d software mixer%s\n", mixer_count, ESS(mixer_count));
+
+	return 0;
+}
+
+/*!
+ * \brief Take a port out of its conference, the conference goes away with its last port
+ *
+ * \note Called with mixconfs_lock held
+ */
+static void mixer_port_leave(struct meetme_port *port)
+{
+	struct meetme_mixconf *conf = port->conf;
+	struct meetme_mixer *mixer;
+
+	port->confmode = 0;
+	if (!conf) {
+		return;
+	}
+	mixer = conf->mixer;
+
+	tris_mutex_lock(&mixer->lock);
+	TRIS_LIST_REMOVE(&conf->ports, port, list);
+	port->conf = NULL;
+	port->samples = 0;
+	if (TRIS_LIST_EMPTY(&conf->ports)) {
+		TRIS_LIST_REMOVE(&mixer->confs, conf, list);
+		mixer->count--;
+	} else {
+		conf = NULL;
+	}
+	tris_mutex_unlock(&mixer->lock);
+
+	if (conf) {
+		TRIS_LIST_REMOVE(&mixconfs, conf, entry);
+		tris_free(conf);
+	}
+}
+
+/*!
+ * \brief Find a conference, or create it on the least busy mixer
+ *
+ * \note Called with mixconfs_lock held
+ */
+static struct meetme_mixconf *mixer_conf_get(int confno)
+{
+	struct meetme_mixconf *conf;
+	struct meetme_mixer *mixer = NULL;
+	int i;
+
+	if (confno > 0) {
+		TRIS_LIST_TRAVERSE(&mixconfs, conf, entry) {
+			if (conf->confno == confno) {
+				return conf;
+			}
+		}
+	}
+
+	if (!mixer_count || !(conf = tris_calloc(1, sizeof(*conf)))) {
+		return NULL;
+	}
+
+	if (confno > 0) {
+		conf->confno = confno;
+	} else {
+		struct meetme_mixconf *cur;
+
+		/* Take the next number not in use */
+		do {
+			conf->confno = mixconf_next;
+			mixconf_next = (mixconf_next == INT_MAX) ? 1 : mixconf_next + 1;
+			TRIS_LIST_TRAVERSE(&mixconfs, cur, entry) {
+				if (cur->confno == conf->confno) {
+					break;
+				}
+			}
+		} while (cur);
+	}
+
+	for (i = 0; i < mixer_count; i++) {
+		if (!mixer || mixers[i].count < mixer->count) {
+			mixer = &mixers[i];
+		}
+	}
+	conf->mixer = mixer;
+	TRIS_LIST_INSERT_TAIL(&mixconfs, conf, entry);
+
+	tris_mutex_lock(&mixer->lock);
+	TRIS_LIST_INSERT_TAIL(&mixer->confs, conf, list);
+	mixer->count++;
+	tris_cond_signal(&mixer->cond);
+	tris_mutex_unlock(&mixer->lock);
+
+	return conf;
+}
+
+#ifdef HAVE_DAHDI
+static int dahdi_confmode(int confmode)
+{
+	int mode = 0;
+
+	switch (confmode & MEETME_CONF_MODE_MASK) {
+	case MEETME_CONF_CONF:
+		mode = DAHDI_CONF_CONF;
+		break;
+	case MEETME_CONF_CONFANN:
+		mode = DAHDI_CONF_CONFANN;
+		break;
+	case MEETME_CONF_CONFMON:
+		mode = DAHDI_CONF_CONFMON;
+		break;
+	case MEETME_CONF_CONFANNMON:
+		mode = DAHDI_CONF_CONFANNMON;
+		break;
+	}
+	if (confmode & MEETME_CONF_TALKER) {
+		mode |= DAHDI_CONF_TALKER;
+	}
+	if (confmode & MEETME_CONF_LISTENER) {
+		mode |= DAHDI_CONF_LISTENER;
+	}
+
+	return mode;
+}
+
+static int meetme_confmode(int mode)
+{
+	int confmode = 0;
+
+	switch (mode & DAHDI_CONF_MODE_MASK) {
+	case DAHDI_CONF_NORMAL:
+		return 0;
+	case DAHDI_CONF_CONF:
+		confmode = MEETME_CONF_CONF;
+		break;
+	case DAHDI_CONF_CONFANN:
+		confmode = MEETME_CONF_CONFANN;
+		break;
+	case DAHDI_CONF_CONFMON:
+		confmode = MEETME_CONF_CONFMON;
+		break;
+	case DAHDI_CONF_CONFANNMON:
+		confmode = MEETME_CONF_CONFANNMON;
+		break;
+	default:
+		/* Some other DAHDI mode, which still means the channel is busy */
+		return MEETME_CONF_MODE_MASK;
+	}
+	if (mode & DAHDI_CONF_TALKER) {
+		confmode |= MEETME_CONF_TALKER;
+	}
+	if (mode & DAHDI_CONF_LISTENER) {
+		confmode |= MEETME_CONF_LISTENER;
+	}
+
+	return confmode;
+}
+#endif
+
+/*!
+ * \brief Open a pseudo channel to put in a conference
+ *
+ * \param linear Non-blocking, buffered signed linear audio for a conference
+ *        user.  Otherwise the pseudo channel blocks and carries mu-law, which
+ *        is how the entrance and exit sounds are played.
+ *
+ * \return the fd of the pseudo channel, -1 on failure
+ */
+static int meetme_pseudo_open(int linear)
+{
+	struct meetme_port *port;
+	int fds[2], x;
+
+#ifdef HAVE_DAHDI
+	if (use_dahdi) {
+		struct dahdi_bufferinfo bi;
+		int fd;
+
+		if ((fd = open("/dev/dahdi/pseudo", O_RDWR | (linear ? O_NONBLOCK : 0))) < 0) {
+			tris_log(LOG_WARNING, "Unable to open pseudo channel: %s\n", strerror(errno));
+			return -1;
+		}
+		if (!linear) {
+			return fd;
+		}
+		/* Setup buffering information */
+		memset(&bi, 0, sizeof(bi));
+		bi.bufsize = CONF_SIZE / 2;
+		bi.txbufpolicy = DAHDI_POLICY_IMMEDIATE;
+		bi.rxbufpolicy = DAHDI_POLICY_IMMEDIATE;
+		bi.numbufs = audio_buffers;
+		if (ioctl(fd, DAHDI_SET_BUFINFO, &bi)) {
+			tris_log(LOG_WARNING, "Unable to set buffering information: %s\n", strerror(errno));
+			close(fd);
+			return -1;
+		}
+		x = 1;
+		if (ioctl(fd, DAHDI_SETLINEAR, &x)) {
+			tris_log(LOG_WARNING, "Unable to set linear mode: %s\n", strerror(errno));
+			close(fd);
+			return -1;
+		}
+		return fd;
+	}
+#endif
+
+	if (!(port = ao2_alloc(sizeof(*port), mixer_port_destructor))) {
+		return -1;
+	}
+	port->fd = -1;
+
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds)) {
+		tris_log(LOG_WARNING, "Unable to create pseudo channel: %s\n", strerror(errno));
+		ao2_ref(port, -1);
+		return -1;
+	}
+	port->appfd = fds[0];
+	port->fd = fds[1];
+	port->linear = linear ? 1 : 0;
+
+	/* Bound the audio a listener that is not reading has queued up, like the DAHDI buffers */
+	x = audio_buffers * CONF_SIZE;
+	setsockopt(port->fd, SOL_SOCKET, SO_SNDBUF, &x, sizeof(x));
+	fcntl(port->fd, F_SETFL, fcntl(port->fd, F_GETFL) | O_NONBLOCK);
+	if (linear) {
+		fcntl(port->appfd, F_SETFL, fcntl(port->appfd, F_GETFL) | O_NONBLOCK);
+	}
+
+	ao2_link(mixer_ports, port);
+	ao2_ref(port, -1);
+
+	return fds[0];
+}
+
+/*! \brief Close a pseudo channel opened with meetme_pseudo_open(), leaving its conference */
+static void meetme_pseudo_close(int fd)
+{
+	struct meetme_port *port;
+
+	if (!use_dahdi && (port = mixer_port_find(fd))) {
+		tris_mutex_lock(&mixconfs_lock);
+		mixer_port_leave(port);
+		tris_mutex_unlock(&mixconfs_lock);
+		ao2_unlink(mixer_ports, port);
+		ao2_ref(port, -1);
+	}
+
+	close(fd);
+}
+
+/*! \brief Get the conference of a pseudo channel, or of a DAHDI channel */
+static int meetme_getconf(int fd, struct meetme_confinfo *confinfo)
+{
+	struct meetme_port *port;
+
+#ifdef HAVE_DAHDI
+	if (use_dahdi) {
+		struct dahdi_confinfo dahdic = { 0, };
+
+		if (ioctl(fd, DAHDI_GETCONF, &dahdic)) {
+			return -1;
+		}
+		confinfo->confno = dahdic.confno;
+		confinfo->confmode = meetme_confmode(dahdic.confmode);
+		return 0;
+	}
+#endif
+
+	if (!(port = mixer_port_find(fd))) {
+		return -1;
+	}
+
+	tris_mutex_lock(&mixconfs_lock);
+	confinfo->confno = port->conf ? port->conf->confno : 0;
+	confinfo->confmode = port->confmode;
+	tris_mutex_unlock(&mixconfs_lock);
+
+	ao2_ref(port, -1);
+
+	return 0;
+}
+
+/*!
+ * \brief Put a pseudo channel, or a DAHDI channel, in a conference
+ *
+ * A confno of -1 creates a new conference, whose number is returned in
+ * confinfo.  A confmode of 0 takes the channel out of its conference.
+ */
+static int meetme_setconf(int fd, struct meetme_confinfo *confinfo)
+{
+	struct meetme_port *port;
+	struct meetme_mixconf *conf;
+
+#ifdef HAVE_DAHDI
+	if (use_dahdi) {
+		struct dahdi_confinfo dahdic = { 0, };
+
+		dahdic.chan = 0;
+		dahdic.confno = confinfo->confno;
+		dahdic.confmode = dahdi_confmode(confinfo->confmode);
+		if (ioctl(fd, DAHDI_SETCONF, &dahdic)) {
+			return -1;
+		}
+		confinfo->confno = dahdic.confno;
+		return 0;
+	}
+#endif
+
+	if (!(port = mixer_port_find(fd))) {
+		return -1;
+	}
+
+	tris_mutex_lock(&mixconfs_lock);
+
+	if (!confinfo->confno || !confinfo->confmode) {
+		mixer_port_leave(port);
+		confinfo->confno = 0;
+	} else if (port->conf && port->conf->confno == confinfo->confno) {
+		tris_mutex_lock(&port->conf->mixer->lock);
+		port->confmode = confinfo->confmode;
+		if (!mixer_port_talks(port->confmode)) {
+			/* Muted, drop what was said before */
+			port->samples = 0;
+		}
+		tris_mutex_unlock(&port->conf->mixer->lock);
+	} else {
+		mixer_port_leave(port);
+		if (!(conf = mixer_conf_get(confinfo->confno))) {
+			tris_mutex_unlock(&mixconfs_lock);
+			ao2_ref(port, -1);
+			return -1;
+		}
+		tris_mutex_lock(&conf->mixer->lock);
+		port->conf = conf;
+		port->confmode = confinfo->confmode;
+		TRIS_LIST_INSERT_TAIL(&conf->ports, port, list);
+		tris_mutex_unlock(&conf->mixer->lock);
+		confinfo->confno = conf->confno;
+	}
+
+	tris_mutex_unlock(&mixconfs_lock);
+
+	ao2_ref(port, -1);
+
+	return 0;
+}
+
+/*! \brief Throw away the audio queued in both directions of a pseudo channel */
+static int meetme_flush(int fd)
+{
+	struct meetme_port *port;
+	char buf[CONF_SIZE];
+
+#ifdef HAVE_DAHDI
+	if (use_dahdi) {
+		int x = DAHDI_FLUSH_ALL;
+
+		return ioctl(fd, DAHDI_FLUSH, &x);
+	}
+#endif
+
+	if (!(port = mixer_port_find(fd))) {
+		return -1;
+	}
+
+	tris_mutex_lock(&mixconfs_lock);
+	if (port->conf) {
+		tris_mutex_lock(&port->conf->mixer->lock);
+	}
+	while (recv(port->fd, buf, sizeof(buf), MSG_DONTWAIT) > 0) {
+	}
+	port->samples = 0;
+	if (port->conf) {
+		tris_mutex_unlock(&port->conf->mixer->lock);
+	}
+	tris_mutex_unlock(&mixconfs_lock);
+
+	while (recv(fd, buf, sizeof(buf), MSG_DONTWAIT) > 0) {
+	}
+
+	ao2_ref(port, -1);
+
+	return 0;
+}
+
+/*! \brief Private data of a software mixer pseudo channel */
+struct meetme_pseudo_pvt {
+	int fd;
+	struct tris_frame f;
+	char buf[TRIS_FRIENDLY_OFFSET + CONF_SIZE];
+};
+
+static int careful_write(int fd, unsigned char *data, int len, int block);
+
+static struct tris_frame *meetme_pseudo_read(struct tris_channel *chan)
+{
+	struct meetme_pseudo_pvt *pvt = chan->tech_pvt;
+	int res;
+
+	if ((res = read(pvt->fd, pvt->buf + TRIS_FRIENDLY_OFFSET, CONF_SIZE)) <= 0) {
+		return (res < 0 && errno == EAGAIN) ? &tris_null_frame : NULL;
+	}
+
+	memset(&pvt->f, 0, sizeof(pvt->f));
+	pvt->f.frametype = TRIS_FRAME_VOICE;
+	pvt->f.subclass = TRIS_FORMAT_SLINEAR;
+	pvt->f.datalen = res;
+	pvt->f.samples = res / 2;
+	pvt->f.data.ptr = pvt->buf + TRIS_FRIENDLY_OFFSET;
+	pvt->f.offset = TRIS_FRIENDLY_OFFSET;
+	pvt->f.src = "MeetMe";
+
+	return &pvt->f;
+}
+
+static int meetme_pseudo_write(struct tris_channel *chan, struct tris_frame *f)
+{
+	struct meetme_pseudo_pvt *pvt = chan->tech_pvt;
+
+	if (f->frametype == TRIS_FRAME_VOICE && f->subclass == TRIS_FORMAT_SLINEAR) {
+		careful_write(pvt->fd, f->data.ptr, f->datalen, 0);
+	}
+
+	return 0;
+}
+
+static int meetme_pseudo_hangup(struct tris_channel *chan)
+{
+	struct meetme_pseudo_pvt *pvt = chan->tech_pvt;
+
+	if (pvt) {
+		meetme_pseudo_close(pvt->fd);
+		tris_free(pvt);
+		chan->tech_pvt = NULL;
+	}
+
+	return 0;
+}
+
+static const struct tris_channel_tech meetme_pseudo_tech = {
+	.type = "MeetMe",
+	.description = "MeetMe software mixer pseudo channel",
+	.capabilities = TRIS_FORMAT_SLINEAR,
+	.read = meetme_pseudo_read,
+	.write = meetme_pseudo_write,
+	.hangup = meetme_pseudo_hangup,
+};
+
+/*! \brief Get a channel to play files into a conference, or to record it */
+static struct tris_channel *meetme_request_pseudo(void)
+{
+	static int seq;
+	struct meetme_pseudo_pvt *pvt;
+	struct tris_channel *chan;
+
+	if (use_dahdi) {
+		return tris_request("DAHDI", TRIS_FORMAT_SLINEAR, "pseudo", NULL, 0);
+	}
+
+	if (!(pvt = tris_calloc(1, sizeof(*pvt)))) {
+		return NULL;
+	}
+	if ((pvt->fd = meetme_pseudo_open(1)) < 0) {
+		tris_free(pvt);
+		return NULL;
+	}
+	if (!(chan = tris_channel_alloc(0, TRIS_STATE_UP, NULL, NULL, "", "", "", 0, "MeetMe/pseudo-%d", tris_atomic_fetchadd_int(&seq, +1)))) {
+		meetme_pseudo_close(pvt->fd);
+		tris_free(pvt);
+		return NULL;
+	}
+
+	chan->tech = &meetme_pseudo_tech;
+	chan->tech_pvt = pvt;
+	tris_channel_set_fd(chan, 0, pvt->fd);
+	chan->nativeformats = TRIS_FORMAT_SLINEAR;
+	chan->rawreadformat = chan->readformat = TRIS_FORMAT_SLINEAR;
+	chan->rawwriteformat = chan->writeformat = TRIS_FORMAT_SLINEAR;
+
+	return chan;
+}
+
 static int careful_write(int fd, unsigned char *data, int len, int block)
 {
 	int res;
 	int x;
 
 	while (len) {
-		if (block) {
+#ifdef HAVE_DAHDI
+		if (use_dahdi && block) {
 			x = DAHDI_IOMUX_WRITE | DAHDI_IOMUX_SIGEVENT;
 			res = ioctl(fd, DAHDI_IOMUX, &x);
 		} else
+#endif
 			res = 0;
-		if (res >= 0)
-			res = write(fd, data, len);
+		if (res >= 0) {
+			/* Each write is one packet on a software mixer pseudo channel, keep them to an interval */
+			x = use_dahdi ? len : MIN(len, CONF_SIZE);
+			res = write(fd, data, x);
+		}
 		if (res < 1) {
 			if (errno != EAGAIN) {
 				tris_log(LOG_WARNING, "Failed to write audio data to conference: %s\n", strerror(errno));
@@ -1093,7 +2019,7 @@ static void conf_play(struct tris_channel *chan, struct tris_conference *conf, e
 static struct tris_conference *build_conf(char *confno, char *pin, char *pinadmin, int make, int dynamic, int refcount, const struct tris_channel *chan)
 {
 	struct tris_conference *cnf;
-	struct dahdi_confinfo dahdic = { 0, };
+	struct meetme_confinfo confinfo = { 0, };
 	int confno_int = 0;
 
 	TRIS_LIST_LOCK(&confs);
@@ -1123,35 +2049,34 @@ static struct tris_conference *build_conf(char *confno, char *pin, char *pinadmi
 	tris_copy_string(cnf->uniqueid, chan->uniqueid, sizeof(cnf->uniqueid));
 	cnf->admin_chan = NULL;
 
-	/* Setup a new dahdi conference */
-	dahdic.confno = -1;
-	dahdic.confmode = DAHDI_CONF_CONFANN | DAHDI_CONF_CONFANNMON;
-	cnf->fd = open("/dev/dahdi/pseudo", O_RDWR);
-	if (cnf->fd < 0 || ioctl(cnf->fd, DAHDI_SETCONF, &dahdic)) {
+	/* Setup a new conference */
+	confinfo.confno = -1;
+	confinfo.confmode = MEETME_CONF_CONFANNMON;
+	cnf->fd = meetme_pseudo_open(0);
+	if (cnf->fd < 0 || meetme_setconf(cnf->fd, &confinfo)) {
 		tris_log(LOG_WARNING, "Unable to open pseudo device\n");
 		if (cnf->fd >= 0)
-			close(cnf->fd);
+			meetme_pseudo_close(cnf->fd);
 		tris_free(cnf);
 		cnf = NULL;
 		goto cnfout;
 	}
 
-	cnf->dahdiconf = dahdic.confno;
+	cnf->mixconf = confinfo.confno;
 
 	/* Setup a new channel for playback of audio files */
-	cnf->chan = tris_request("DAHDI", TRIS_FORMAT_SLINEAR, "pseudo", NULL, 0);
+	cnf->chan = meetme_request_pseudo();
 	if (cnf->chan) {
 		tris_set_read_format(cnf->chan, TRIS_FORMAT_SLINEAR);
 		tris_set_write_format(cnf->chan, TRIS_FORMAT_SLINEAR);
-		dahdic.chan = 0;
-		dahdic.confno = cnf->dahdiconf;
-		dahdic.confmode = DAHDI_CONF_CONFANN | DAHDI_CONF_CONFANNMON;
-		if (ioctl(cnf->chan->fds[0], DAHDI_SETCONF, &dahdic)) {
+		confinfo.confno = cnf->mixconf;
+		confinfo.confmode = MEETME_CONF_CONFANNMON;
+		if (meetme_setconf(cnf->chan->fds[0], &confinfo)) {
 			tris_log(LOG_WARNING, "Error setting conference\n");
 			if (cnf->chan)
 				tris_hangup(cnf->chan);
 			else
-				close(cnf->fd);
+				meetme_pseudo_close(cnf->fd);
 
 			tris_free(cnf);
 			cnf = NULL;
@@ -1163,7 +2088,7 @@ static struct tris_conference *build_conf(char *confno, char *pin, char *pinadmi
 	cnf->start = time(NULL);
 	cnf->maxusers = 0x7fffffff;
 	cnf->isdynamic = dynamic ? 1 : 0;
-	tris_verb(3, "Created MeetMe conference %d for conference '%s'\n", cnf->dahdiconf, cnf->confno);
+	tris_verb(3, "Created MeetMe conference %d for conference '%s'\n", cnf->mixconf, cnf->confno);
 	TRIS_LIST_INSERT_HEAD(&confs, cnf, list);
 
 	/* Reserve conference number in map */
@@ -1657,8 +2582,6 @@ static struct tris_cli_entry cli_meetme[] = {
 
 static void conf_flush(int fd, struct tris_channel *chan)
 {
-	int x;
-
 	/* read any frames that may be waiting on the channel
 	   and throw them away
 	*/
@@ -1678,8 +2601,7 @@ static void conf_flush(int fd, struct tris_channel *chan)
 	}
 
 	/* flush any data sitting in the pseudo channel */
-	x = DAHDI_FLUSH_ALL;
-	if (ioctl(fd, DAHDI_FLUSH, &x))
+	if (meetme_flush(fd))
 		tris_log(LOG_WARNING, "Error flushing channel\n");
 
 }
@@ -1750,7 +2672,7 @@ static int conf_free(struct tris_conference *conf)
 	if (conf->chan)
 		tris_hangup(conf->chan);
 	if (conf->fd >= 0)
-		close(conf->fd);
+		meetme_pseudo_close(conf->fd);
 	if (conf->recordingfilename) {
 		tris_free(conf->recordingfilename);
 	}
@@ -3076,7 +3998,7 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 	struct tris_dial *dials[MAX_DIALS];
 	int i, pos = 0;
 	int fd;
-	struct dahdi_confinfo dahdic, dahdic_empty;
+	struct meetme_confinfo confinfo, confinfo_empty;
 	struct tris_frame *f;
 	struct tris_channel *c;
 	struct tris_frame fr;
@@ -3110,7 +4032,6 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 	char members[10] = "";
 	int dtmf, opt_waitmarked_timeout = 0;
 	time_t timeout = 0;
-	struct dahdi_bufferinfo bi;
 	char __buf[CONF_SIZE + TRIS_FRIENDLY_OFFSET];
 	char *buf = __buf + TRIS_FRIENDLY_OFFSET;
 	char *exitkeys = NULL;
@@ -3242,13 +4163,12 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 	}
 
 	tris_mutex_lock(&conf->recordthreadlock);
-	if ((conf->recordthread == TRIS_PTHREADT_NULL) && (confflags & CONFFLAG_RECORDCONF) && ((conf->lchan = tris_request("DAHDI", TRIS_FORMAT_SLINEAR, "pseudo", NULL, 0)))) {
+	if ((conf->recordthread == TRIS_PTHREADT_NULL) && (confflags & CONFFLAG_RECORDCONF) && ((conf->lchan = meetme_request_pseudo()))) {
 		tris_set_read_format(conf->lchan, TRIS_FORMAT_SLINEAR);
 		tris_set_write_format(conf->lchan, TRIS_FORMAT_SLINEAR);
-		dahdic.chan = 0;
-		dahdic.confno = conf->dahdiconf;
-		dahdic.confmode = DAHDI_CONF_CONFANN | DAHDI_CONF_CONFANNMON;
-		if (ioctl(conf->lchan->fds[0], DAHDI_SETCONF, &dahdic)) {
+		confinfo.confno = conf->mixconf;
+		confinfo.confmode = MEETME_CONF_CONFANNMON;
+		if (meetme_setconf(conf->lchan->fds[0], &confinfo)) {
 			tris_log(LOG_WARNING, "Error starting listen channel\n");
 			tris_hangup(conf->lchan);
 			conf->lchan = NULL;
@@ -3442,52 +4362,33 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 		goto outrun;
 	}
 
-	retrydahdi = (strcasecmp(chan->tech->type, "DAHDI") || (chan->audiohooks || chan->monitor) ? 1 : 0);
+	retrydahdi = (!use_dahdi || strcasecmp(chan->tech->type, "DAHDI") || (chan->audiohooks || chan->monitor) ? 1 : 0);
 	user->dahdichannel = !retrydahdi;
 
  dahdiretry:
 	origfd = chan->fds[0];
 	if (retrydahdi) {
-		/* open pseudo in non-blocking mode */
-		fd = open("/dev/dahdi/pseudo", O_RDWR | O_NONBLOCK);
+		/* open pseudo in non-blocking linear mode */
+		fd = meetme_pseudo_open(1);
 		if (fd < 0) {
-			tris_log(LOG_WARNING, "Unable to open pseudo channel: %s\n", strerror(errno));
 			goto outrun;
 		}
 		using_pseudo = 1;
-		/* Setup buffering information */
-		memset(&bi, 0, sizeof(bi));
-		bi.bufsize = CONF_SIZE / 2;
-		bi.txbufpolicy = DAHDI_POLICY_IMMEDIATE;
-		bi.rxbufpolicy = DAHDI_POLICY_IMMEDIATE;
-		bi.numbufs = audio_buffers;
-		if (ioctl(fd, DAHDI_SET_BUFINFO, &bi)) {
-			tris_log(LOG_WARNING, "Unable to set buffering information: %s\n", strerror(errno));
-			close(fd);
-			goto outrun;
-		}
-		x = 1;
-		if (ioctl(fd, DAHDI_SETLINEAR, &x)) {
-			tris_log(LOG_WARNING, "Unable to set linear mode: %s\n", strerror(errno));
-			close(fd);
-			goto outrun;
-		}
 		nfds = 1;
 	} else {
 		/* XXX Make sure we're not running on a pseudo channel XXX */
 		fd = chan->fds[0];
 		nfds = 0;
 	}
-	memset(&dahdic, 0, sizeof(dahdic));
-	memset(&dahdic_empty, 0, sizeof(dahdic_empty));
+	memset(&confinfo, 0, sizeof(confinfo));
+	memset(&confinfo_empty, 0, sizeof(confinfo_empty));
 	/* Check to see if we're in a conference... */
-	dahdic.chan = 0;	
-	if (ioctl(fd, DAHDI_GETCONF, &dahdic)) {
+	if (meetme_getconf(fd, &confinfo)) {
 		tris_log(LOG_WARNING, "Error getting conference\n");
-		close(fd);
+		meetme_pseudo_close(fd);
 		goto outrun;
 	}
-	if (dahdic.confmode) {
+	if (confinfo.confmode) {
 		/* Whoa, already in a conference...  Retry... */
 		if (!retrydahdi) {
 			tris_debug(1, "DAHDI channel is in a conference already, retrying with pseudo\n");
@@ -3495,10 +4396,9 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 			goto dahdiretry;
 		}
 	}
-	memset(&dahdic, 0, sizeof(dahdic));
+	memset(&confinfo, 0, sizeof(confinfo));
 	/* Add us to the conference */
-	dahdic.chan = 0;	
-	dahdic.confno = conf->dahdiconf;
+	confinfo.confno = conf->mixconf;
 
 	if (tris_strlen_zero(optargs[OPT_ARG_DIALOUT_MAINCONFID]) && !(confflags & CONFFLAG_QUIET) && ((confflags & CONFFLAG_INTROUSER) || (confflags & CONFFLAG_INTROUSERNOREVIEW)) && conf->users > 1) {
 		struct announce_listitem *item;
@@ -3523,20 +4423,20 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 	}
 
 	if (confflags & CONFFLAG_WAITMARKED && !conf->markedusers)
-		dahdic.confmode = DAHDI_CONF_CONF;
+		confinfo.confmode = MEETME_CONF_CONF;
 	else if (confflags & CONFFLAG_MONITOR)
-		dahdic.confmode = DAHDI_CONF_CONFMON | DAHDI_CONF_LISTENER;
+		confinfo.confmode = MEETME_CONF_CONFMON | MEETME_CONF_LISTENER;
 	else if (confflags & CONFFLAG_TALKER)
-		dahdic.confmode = DAHDI_CONF_CONF | DAHDI_CONF_TALKER;
+		confinfo.confmode = MEETME_CONF_CONF | MEETME_CONF_TALKER;
 	else 
-		dahdic.confmode = DAHDI_CONF_CONF | DAHDI_CONF_TALKER | DAHDI_CONF_LISTENER;
+		confinfo.confmode = MEETME_CONF_CONF | MEETME_CONF_TALKER | MEETME_CONF_LISTENER;
 
-	if (ioctl(fd, DAHDI_SETCONF, &dahdic)) {
+	if (meetme_setconf(fd, &confinfo)) {
 		tris_log(LOG_WARNING, "Error setting conference\n");
-		close(fd);
+		meetme_pseudo_close(fd);
 		goto outrun;
 	}
-	tris_debug(1, "Placed channel %s in DAHDI conf %d\n", chan->name, conf->dahdiconf);
+	tris_debug(1, "Placed channel %s in %s conf %d\n", chan->name, use_dahdi ? "DAHDI" : "software mixer", conf->mixconf);
 
 	if (!sent_event) {
 		manager_event(EVENT_FLAG_CALL, "MeetmeJoin", 
@@ -3802,10 +4702,10 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 							}
 							break;
 						} else {
-							dahdic.confmode = DAHDI_CONF_CONF;
-							if (ioctl(fd, DAHDI_SETCONF, &dahdic)) {
+							confinfo.confmode = MEETME_CONF_CONF;
+							if (meetme_setconf(fd, &confinfo)) {
 								tris_log(LOG_WARNING, "Error setting conference\n");
-								close(fd);
+								meetme_pseudo_close(fd);
 								goto outrun;
 							}
 						}
@@ -3818,15 +4718,15 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 					/* Marked user entered, so cancel timeout */
 					timeout = 0;
 					if (confflags & CONFFLAG_MONITOR) {
-						dahdic.confmode = DAHDI_CONF_CONFMON | DAHDI_CONF_LISTENER;
+						confinfo.confmode = MEETME_CONF_CONFMON | MEETME_CONF_LISTENER;
 					} else if (confflags & CONFFLAG_TALKER) {
-						dahdic.confmode = DAHDI_CONF_CONF | DAHDI_CONF_TALKER;
+						confinfo.confmode = MEETME_CONF_CONF | MEETME_CONF_TALKER;
 					} else {
-						dahdic.confmode = DAHDI_CONF_CONF | DAHDI_CONF_TALKER | DAHDI_CONF_LISTENER;
+						confinfo.confmode = MEETME_CONF_CONF | MEETME_CONF_TALKER | MEETME_CONF_LISTENER;
 					}
-					if (ioctl(fd, DAHDI_SETCONF, &dahdic)) {
+					if (meetme_setconf(fd, &confinfo)) {
 						tris_log(LOG_WARNING, "Error setting conference\n");
-						close(fd);
+						meetme_pseudo_close(fd);
 						goto outrun;
 					}
 					if (musiconhold && (confflags & CONFFLAG_MOH)) {
@@ -3903,13 +4803,12 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 				}
 
 				tris_mutex_lock(&conf->recordthreadlock);
-				if ((conf->recordthread == TRIS_PTHREADT_NULL) && ((conf->lchan = tris_request("DAHDI", TRIS_FORMAT_SLINEAR, "pseudo", NULL, 0)))) {
+				if ((conf->recordthread == TRIS_PTHREADT_NULL) && ((conf->lchan = meetme_request_pseudo()))) {
 					tris_set_read_format(conf->lchan, TRIS_FORMAT_SLINEAR);
 					tris_set_write_format(conf->lchan, TRIS_FORMAT_SLINEAR);
-					dahdic.chan = 0;
-					dahdic.confno = conf->dahdiconf;
-					dahdic.confmode = DAHDI_CONF_CONFANN | DAHDI_CONF_CONFANNMON;
-					if (ioctl(conf->lchan->fds[0], DAHDI_SETCONF, &dahdic)) {
+					confinfo.confno = conf->mixconf;
+					confinfo.confmode = MEETME_CONF_CONFANNMON;
+					if (meetme_setconf(conf->lchan->fds[0], &confinfo)) {
 						tris_log(LOG_WARNING, "Error starting listen channel\n");
 						tris_hangup(conf->lchan);
 						conf->lchan = NULL;
@@ -3922,9 +4821,9 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 			}
 
 			/* If I should be muted but am still talker, mute me */
-			if ((user->adminflags & (ADMINFLAG_MUTED | ADMINFLAG_SELFMUTED)) && (dahdic.confmode & DAHDI_CONF_TALKER)) {
-				dahdic.confmode ^= DAHDI_CONF_TALKER;
-				if (ioctl(fd, DAHDI_SETCONF, &dahdic)) {
+			if ((user->adminflags & (ADMINFLAG_MUTED | ADMINFLAG_SELFMUTED)) && (confinfo.confmode & MEETME_CONF_TALKER)) {
+				confinfo.confmode ^= MEETME_CONF_TALKER;
+				if (meetme_setconf(fd, &confinfo)) {
 					tris_log(LOG_WARNING, "Error setting conference - Un/Mute \n");
 					ret = -1;
 					break;
@@ -3945,9 +4844,9 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 			}
 
 			/* If I should be un-muted but am not talker, un-mute me */
-			if (!(user->adminflags & (ADMINFLAG_MUTED | ADMINFLAG_SELFMUTED)) && !(confflags & CONFFLAG_MONITOR) && !(dahdic.confmode & DAHDI_CONF_TALKER)) {
-				dahdic.confmode |= DAHDI_CONF_TALKER;
-				if (ioctl(fd, DAHDI_SETCONF, &dahdic)) {
+			if (!(user->adminflags & (ADMINFLAG_MUTED | ADMINFLAG_SELFMUTED)) && !(confflags & CONFFLAG_MONITOR) && !(confinfo.confmode & MEETME_CONF_TALKER)) {
+				confinfo.confmode |= MEETME_CONF_TALKER;
+				if (meetme_setconf(fd, &confinfo)) {
 					tris_log(LOG_WARNING, "Error setting conference - Un/Mute \n");
 					ret = -1;
 					break;
@@ -4045,11 +4944,11 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 				if (c->fds[0] != origfd || (user->dahdichannel && (c->audiohooks || c->monitor))) {
 					if (using_pseudo) {
 						/* Kill old pseudo */
-						close(fd);
+						meetme_pseudo_close(fd);
 						using_pseudo = 0;
 					}
 					tris_debug(1, "Ooh, something swapped out under us, starting over\n");
-					retrydahdi = (strcasecmp(c->tech->type, "DAHDI") || (c->audiohooks || c->monitor) ? 1 : 0);
+					retrydahdi = (!use_dahdi || strcasecmp(c->tech->type, "DAHDI") || (c->audiohooks || c->monitor) ? 1 : 0);
 					user->dahdichannel = !retrydahdi;
 					goto dahdiretry;
 				}
@@ -4108,9 +5007,9 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 					if (confflags & CONFFLAG_PASS_DTMF) {
 						conf_queue_dtmf(conf, user, f);
 					}
-					if (ioctl(fd, DAHDI_SETCONF, &dahdic_empty)) {
+					if (meetme_setconf(fd, &confinfo_empty)) {
 						tris_log(LOG_WARNING, "Error setting conference\n");
-						close(fd);
+						meetme_pseudo_close(fd);
 						tris_frfree(f);
 						goto outrun;
 					}
@@ -4306,9 +5205,9 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 						conf_start_moh(chan, optargs[OPT_ARG_MOH_CLASS]);
 					}
 
-					if (ioctl(fd, DAHDI_SETCONF, &dahdic)) {
+					if (meetme_setconf(fd, &confinfo)) {
 						tris_log(LOG_WARNING, "Error setting conference\n");
-						close(fd);
+						meetme_pseudo_close(fd);
 						tris_frfree(f);
 						goto outrun;
 					}
@@ -4490,7 +5389,7 @@ static int conf_run(struct tris_channel *chan, struct tris_conference *conf, int
 				} else {
 					tris_debug(1, 
 						"Got unrecognized frame on channel %s, f->frametype=%d,f->subclass=%d\n",
-						chan->name, f->frametype, f->subclass);
+						chan->name, f->frametype, (int) f->subclass);
 				}
 				tris_frfree(f);
 			} else if (outfd > -1) {
@@ -4589,13 +5488,12 @@ bailoutandtrynormal:
 	}
 	
 	if (using_pseudo) {
-		close(fd);
+		meetme_pseudo_close(fd);
 	} else {
 		/* Take out of conference */
-		dahdic.chan = 0;	
-		dahdic.confno = 0;
-		dahdic.confmode = 0;
-		if (ioctl(fd, DAHDI_SETCONF, &dahdic)) {
+		confinfo.confno = 0;
+		confinfo.confmode = 0;
+		if (meetme_setconf(fd, &confinfo)) {
 			tris_log(LOG_WARNING, "Error setting conference\n");
 		}
 	}
@@ -6483,9 +7381,9 @@ static void load_config_meetme(void)
 		if ((sscanf(val, "%30d", &audio_buffers) != 1)) {
 			tris_log(LOG_WARNING, "audiobuffers setting must be a number, not '%s'\n", val);
 			audio_buffers = DEFAULT_AUDIO_BUFFERS;
-		} else if ((audio_buffers < DAHDI_DEFAULT_NUM_BUFS) || (audio_buffers > DAHDI_MAX_NUM_BUFS)) {
+		} else if ((audio_buffers < MIN_AUDIO_BUFFERS) || (audio_buffers > MAX_AUDIO_BUFFERS)) {
 			tris_log(LOG_WARNING, "audiobuffers setting must be between %d and %d\n",
-				DAHDI_DEFAULT_NUM_BUFS, DAHDI_MAX_NUM_BUFS);
+				MIN_AUDIO_BUFFERS, MAX_AUDIO_BUFFERS);
 			audio_buffers = DEFAULT_AUDIO_BUFFERS;
 		}
 		if (audio_buffers != DEFAULT_AUDIO_BUFFERS)
@@ -6500,6 +7398,18 @@ static void load_config_meetme(void)
 		tris_verbose("Meetme rooms set to %d\n", max_rooms);
 	}
 
+	/* Only used when the module loads, conferences cannot move between mixers */
+	mixer_type = MEETME_MIXER_AUTO;
+	if ((val = tris_variable_retrieve(cfg, "general", "mixer"))) {
+		if (!strcasecmp(val, "dahdi")) {
+			mixer_type = MEETME_MIXER_DAHDI;
+		} else if (!strcasecmp(val, "software")) {
+			mixer_type = MEETME_MIXER_SOFTWARE;
+		} else if (strcasecmp(val, "auto")) {
+			tris_log(LOG_WARNING, "mixer setting must be auto, dahdi or software, not '%s'\n", val);
+		}
+	}
+
 	if ((val = tris_variable_retrieve(cfg, "general", "schedule")))
 		rt_schedule = tris_true(val);
 	if ((val = tris_variable_retrieve(cfg, "general", "logmembercount")))
@@ -8441,6 +9351,34 @@ static struct tris_custom_function meetme_info_acf = {
 };
 
 
+/*! \brief Pick what mixes the conferences, DAHDI or the software mixer threads */
+static int meetme_mixer_init(void)
+{
+#ifdef HAVE_DAHDI
+	int fd;
+
+	if (mixer_type != MEETME_MIXER_SOFTWARE) {
+		if ((fd = open("/dev/dahdi/pseudo", O_RDWR)) >= 0) {
+			close(fd);
+			use_dahdi = 1;
+			tris_verb(2, "MeetMe conferences are mixed by DAHDI\n");
+			return 0;
+		}
+		if (mixer_type == MEETME_MIXER_DAHDI) {
+			tris_log(LOG_WARNING, "Unable to open /dev/dahdi/pseudo, using the software mixer\n");
+		}
+	}
+#else
+	if (mixer_type == MEETME_MIXER_DAHDI) {
+		tris_log(LOG_WARNING, "Built without DAHDI, using the software mixer\n");
+	}
+#endif
+
+	use_dahdi = 0;
+
+	return mixers_start();
+}
+
 static int load_config(int reload)
 {
 	load_config_meetme();
@@ -8478,6 +9416,8 @@ static int unload_module(void)
 	res |= tris_custom_function_unregister(&meetme_info_acf);
 	tris_unload_realtime("meetme");
 
+	mixers_stop();
+
 	return res;
 }
 
@@ -8487,6 +9427,11 @@ static int load_module(void)
 
 	res |= load_config(0);
 
+	if (meetme_mixer_init()) {
+		tris_log(LOG_ERROR, "Unable to start the MeetMe mixer\n");
+		return TRIS_MODULE_LOAD_DECLINE;
+	}
+
 	tris_cli_register_multiple(cli_meetme, ARRAY_LEN(cli_meetme));
 	res |= tris_manager_register("MeetmeRecord", 0, 
 				    action_meetmerecord, "Record a Meetme");
@@ -123,7 +123,7 @@ static int mp3_exec(struct tris_channel *chan, void *data)
 	int fds[2];
 	int ms = -1;
 	int pid = -1;
-	int owriteformat;
+	format_t owriteformat;
 	int timeout = 2000;
 	struct timeval next;
 	struct tris_frame *f;
@@ -111,7 +111,7 @@ static int NBScat_exec(struct tris_channel *chan, void *data)
 	int fds[2];
 	int ms = -1;
 	int pid = -1;
-	int owriteformat;
+	format_t owriteformat;
 	struct timeval next;
 	struct tris_frame *f;
 	struct myframe {
@@ -528,6 +528,7 @@ static struct tris_taskprocessor *devicestate_tps;
 #define DEFAULT_RETRY		5
 #define DEFAULT_TIMEOUT		15
 #define RECHECK			1		/*!< Recheck every second to see we we're at the top yet */
+#define QUEUE_TURN_RECHECK	10		/*!< Check our turn this often even when queue_dispatch() has not woken us */
 #define MAX_PERIODIC_ANNOUNCEMENTS 10           /*!< The maximum periodic announcements we can have */
 #define DEFAULT_MIN_ANNOUNCE_FREQUENCY 15       /*!< The minimum number of seconds between position announcements \
                                                      The default value of 15 provides backwards compatibility */
@@ -663,6 +664,9 @@ struct queue_ent {
 	struct tris_channel *chan;              /*!< Our channel */
 	TRIS_LIST_HEAD_NOLOCK(,penalty_rule) qe_rules; /*!< Local copy of the queue's penalty rules */
 	struct penalty_rule *pr;               /*!< Pointer to the next penalty rule to implement */
+	int wakeup[2];                         /*!< Pipe queue_dispatch() writes to when it may be our turn */
+	int dispatched;                        /*!< Woken by queue_dispatch() since our turn was last checked */
+	struct timeval dispatch_time;          /*!< When we could first be served, for the dispatch statistics */
 	struct queue_ent *next;                /*!< The next queue entry */
 };
 
@@ -817,6 +821,11 @@ struct call_queue {
 	 *       in, so this can not simply be replaced with ao2_container_count(). 
 	 */
 	int membercount;
+	int available;                      /*!< Members free to take a call, see member_is_available() */
+	int dispatches;                     /*!< Callers woken by queue_dispatch() */
+	int dispatch_rings;                 /*!< Woken callers who went on to ring members */
+	int64_t dispatch_us;                /*!< Total time from being served to ringing, over dispatch_rings */
+	int64_t dispatch_max_us;            /*!< Longest time from being served to ringing */
 	struct queue_ent *head;             /*!< Head of the list of callers */
 	TRIS_LIST_ENTRY(call_queue) list;    /*!< Next call queue */
 	TRIS_LIST_HEAD_NOLOCK(, penalty_rule) rules; /*!< The list of penalty rules to invoke */
@@ -1026,6 +1035,117 @@ struct statechange {
 	char dev[0];
 };
 
+/*! \brief Whether a member is free to take a call from its queue */
+static int member_is_available(struct call_queue *q, struct member *m)
+{
+	switch (m->status) {
+	case TRIS_DEVICE_INUSE:
+		if (!q->ringinuse)
+			return 0;
+		/* else fall through */
+	case TRIS_DEVICE_NOT_INUSE:
+	case TRIS_DEVICE_UNKNOWN:
+		return !m->paused;
+	}
+	return 0;
+}
+
+/*! \brief Get the number of members available to accept a call.
+ *
+ * If autofill is not enabled or if the queue's strategy is ringall, then
+ * we really don't care about the number of available members so much as we
+ * do that there is at least one available.
+ *
+ * In fact, we purposely will return from this function stating that only
+ * one member is available if either of those conditions hold. That way,
+ * functions which determine what action to take based on the number of available
+ * members will operate properly. The reasoning is that even if multiple
+ * members are available, only the head caller can actually be serviced.
+ *
+ * \note the queue's lock must be held
+ */
+static int num_available_members(struct call_queue *q)
+{
+	if ((!q->autofill || q->strategy == QUEUE_STRATEGY_RINGALL) && q->available)
+		return 1;
+	return q->available;
+}
+
+/*!
+ * \brief Wake the callers that the available members can serve now
+ *
+ * These are the callers is_our_turn() would let through.  Only they are
+ * woken, and each only once until it has checked its turn.
+ *
+ * \param q the queue, locked
+ * \param since when these callers could first be served
+ */
+static void queue_dispatch(struct call_queue *q, struct timeval since)
+{
+	struct queue_ent *qe;
+	int avl = num_available_members(q), idx = 0;
+
+	for (qe = q->head; qe && idx < avl; qe = qe->next) {
+		if (qe->pending)
+			continue;
+		/* Without autofill only the head of the queue may call */
+		if (!q->autofill && qe->pos != 1)
+			break;
+		idx++;
+		if (qe->dispatched)
+			continue;
+		qe->dispatched = 1;
+		qe->dispatch_time = since;
+		q->dispatches++;
+		if (qe->wakeup[1] > -1 && write(qe->wakeup[1], "", 1) < 0 && errno != EAGAIN)
+			tris_log(LOG_WARNING, "Unable to wake up %s: %s\n", qe->chan->name, strerror(errno));
+	}
+}
+
+/*!
+ * \brief Count a member in or out of the available members after its status or pause changed
+ * \param q the queue, locked
+ * \param m the member
+ * \param was_available member_is_available() before the change
+ */
+static void member_available_changed(struct call_queue *q, struct member *m, int was_available)
+{
+	int available = member_is_available(q, m);
+
+	if (available == was_available)
+		return;
+	if (available) {
+		q->available++;
+		queue_dispatch(q, tris_tvnow());
+	} else {
+		q->available--;
+	}
+}
+
+/*! \brief Count the available members again, after ringinuse changed
+ * \note the queue's lock must be held */
+static void recount_available(struct call_queue *q)
+{
+	struct member *mem;
+	struct ao2_iterator mem_iter;
+	int avl = 0, old = q->available;
+
+	if (!q->members)
+		return;
+
+	mem_iter = ao2_iterator_init(q->members, 0);
+	while ((mem = ao2_iterator_next(&mem_iter))) {
+		if (member_is_available(q, mem))
+			avl++;
+		ao2_ref(mem, -1);
+	}
+	ao2_iterator_destroy(&mem_iter);
+
+	q->available = avl;
+	if (avl > old)
+		queue_dispatch(q, tris_tvnow());
+}
+
 /*! \brief set a member's status based on device state of that member's state_interface.
  *  
  * Lock interface list find sc, iterate through each queues queue_member list for member to
@@ -1033,7 +1153,13 @@ struct statechange {
 */
 static int update_status(struct call_queue *q, struct member *m, const int status)
 {
+	int was_available;
+
+	ao2_lock(q);
+	was_available = member_is_available(q, m);
 	m->status = status;
+	member_available_changed(q, m, was_available);
+	ao2_unlock(q);
 
 	if (q->maskmemberstatus)
 		return 0;
@@ -1055,41 +1181,243 @@ static int update_status(struct call_queue *q, struct member *m, const int statu
 	return 0;
 }
 
-/*! \brief set a member's status based on device state of that member's interface*/
-static int handle_statechange(void *datap)
+/*! \brief One queue a member is in, as listed in a member index */
+struct member_queue {
+	struct member *member;              /*!< The member, with a reference */
+	TRIS_LIST_ENTRY(member_queue) list;
+	char queue[0];                      /*!< Name of the queue the member is in */
+};
+
+TRIS_LIST_HEAD_NOLOCK(member_queues, member_queue);
+
+/*! \brief The queue memberships found under one interface or device name */
+struct member_index {
+	char name[80];
+	struct member_queues queues;
+};
+
+#define MEMBER_INDEX_BUCKETS 1021
+
+/*! Queue memberships by member interface, for compare_weight() and shared_lastcall */
+static struct ao2_container *member_interfaces;
+/*! Queue memberships by the device a member reads its state from, for device state changes */
+static struct ao2_container *member_devices;
+
+static int member_index_hash_cb(const void *obj, const int flags)
 {
-	struct statechange *sc = datap;
-	struct ao2_iterator miter, qiter;
-	struct member *m;
-	struct call_queue *q;
-	char interface[80], *slash_pos;
-	int found = 0;
+	const struct member_index *mi = obj;
 
-	qiter = ao2_iterator_init(queues, 0);
-	while ((q = ao2_t_iterator_next(&qiter, "Iterate over queues"))) {
-		ao2_lock(q);
+	return tris_str_case_hash(mi->name);
+}
 
-		miter = ao2_iterator_init(q->members, 0);
-		for (; (m = ao2_iterator_next(&miter)); ao2_ref(m, -1)) {
-			tris_copy_string(interface, m->state_interface, sizeof(interface));
+static int member_index_cmp_cb(void *obj, void *arg, int flags)
+{
+	struct member_index *mi = obj, *mi2 = arg;
 
-			if ((slash_pos = strchr(interface, '/')))
-				if (!strncasecmp(interface, "Local/", 6) && (slash_pos = strchr(slash_pos + 1, '/')))
-					*slash_pos = '\0';
+	return !strcasecmp(mi->name, mi2->name) ? CMP_MATCH | CMP_STOP : 0;
+}
 
-			if (!strcasecmp(interface, sc->dev)) {
-				found = 1;
-				update_status(q, m, sc->state);
-				ao2_ref(m, -1);
+static void member_queue_free(struct member_queue *mq)
+{
+	ao2_ref(mq->member, -1);
+	tris_free(mq);
+}
+
+static void member_index_destroy(void *obj)
+{
+	struct member_index *mi = obj;
+	struct member_queue *mq;
+
+	while ((mq = TRIS_LIST_REMOVE_HEAD(&mi->queues, list)))
+		member_queue_free(mq);
+}
+
+/*! \brief The device name a member's state changes arrive under, Local channels without their /n */
+static void member_device(const struct member *m, char *device, size_t len)
+{
+	char *slash_pos;
+
+	tris_copy_string(device, m->state_interface, len);
+	if ((slash_pos = strchr(device, '/')))
+		if (!strncasecmp(device, "Local/", 6) && (slash_pos = strchr(slash_pos + 1, '/')))
+			*slash_pos = '\0';
+}
+
+static void member_index_add(struct ao2_container *index, const char *name, struct call_queue *q, struct member *m)
+{
+	struct member_index *mi, tmp;
+	struct member_queue *mq;
+
+	if (!index || !(mq = tris_calloc(1, sizeof(*mq) + strlen(q->name) + 1)))
+		return;
+	ao2_ref(m, 1);
+	mq->member = m;
+	strcpy(mq->queue, q->name);
+
+	/* Hold the index until the membership is in, or member_index_remove()
+	   could unlink an entry that is still empty */
+	tris_copy_string(tmp.name, name, sizeof(tmp.name));
+	ao2_lock(index);
+	if (!(mi = ao2_find(index, &tmp, OBJ_POINTER))) {
+		if (!(mi = ao2_alloc(sizeof(*mi), member_index_destroy))) {
+			ao2_unlock(index);
+			member_queue_free(mq);
+			return;
+		}
+		tris_copy_string(mi->name, name, sizeof(mi->name));
+		ao2_link(index, mi);
+	}
+	ao2_lock(mi);
+	TRIS_LIST_INSERT_TAIL(&mi->queues, mq, list);
+	ao2_unlock(mi);
+	ao2_unlock(index);
+	ao2_ref(mi, -1);
+}
+
+static void member_index_remove(struct ao2_container *index, const char *name, struct member *m)
+{
+	struct member_index *mi, tmp;
+	struct member_queue *mq;
+
+	if (!index)
+		return;
+
+	tris_copy_string(tmp.name, name, sizeof(tmp.name));
+	ao2_lock(index);
+	if ((mi = ao2_find(index, &tmp, OBJ_POINTER))) {
+		ao2_lock(mi);
+		TRIS_LIST_TRAVERSE_SAFE_BEGIN(&mi->queues, mq, list) {
+			if (mq->member == m) {
+				TRIS_LIST_REMOVE_CURRENT(list);
+				member_queue_free(mq);
 				break;
 			}
 		}
-		ao2_iterator_destroy(&miter);
+		TRIS_LIST_TRAVERSE_SAFE_END;
+		if (TRIS_LIST_EMPTY(&mi->queues))
+			ao2_unlink(index, mi);
+		ao2_unlock(mi);
+		ao2_ref(mi, -1);
+	}
+	ao2_unlock(index);
+}
 
-		ao2_unlock(q);
-		queue_t_unref(q, "Done with iterator");
+/*!
+ * \brief Copy the queue memberships listed under a name
+ *
+ * The copy is taken so that the queues can be locked without holding the
+ * index, as members are indexed with their queue already locked.  Free
+ * each entry with member_queue_free().
+ */
+static void member_index_copy(struct ao2_container *index, const char *name, struct member_queues *copy)
+{
+	struct member_index *mi, tmp;
+	struct member_queue *mq, *dup;
+
+	TRIS_LIST_HEAD_INIT_NOLOCK(copy);
+	tris_copy_string(tmp.name, name, sizeof(tmp.name));
+	if (!index || !(mi = ao2_find(index, &tmp, OBJ_POINTER)))
+		return;
+
+	ao2_lock(mi);
+	TRIS_LIST_TRAVERSE(&mi->queues, mq, list) {
+		if (!(dup = tris_calloc(1, sizeof(*dup) + strlen(mq->queue) + 1)))
+			break;
+		ao2_ref(mq->member, 1);
+		dup->member = mq->member;
+		strcpy(dup->queue, mq->queue);
+		TRIS_LIST_INSERT_TAIL(copy, dup, list);
+	}
+	ao2_unlock(mi);
+	ao2_ref(mi, -1);
+}
+
+/*!
+ * \brief Find the queue of a membership copied out of a member index, locked
+ * \return the queue with a reference, or NULL if the member has left it since
+ */
+static struct call_queue *member_queue_lock(struct member_queue *mq)
+{
+	struct call_queue *q, tmpq = {
+		.name = mq->queue,
+	};
+	struct member *mem;
+
+	if (!(q = ao2_t_find(queues, &tmpq, OBJ_POINTER, "Find the queue of an indexed member")))
+		return NULL;
+
+	ao2_lock(q);
+	if ((mem = ao2_find(q->members, mq->member, OBJ_POINTER))) {
+		ao2_ref(mem, -1);
+		if (mem == mq->member)
+			return q;
+	}
+	ao2_unlock(q);
+	queue_t_unref(q, "Member has left the queue");
+	return NULL;
+}
+
+/*! \brief Index a member of a queue by its interface and device
+ * \note the queue's lock must be held */
+static void member_index_link(struct call_queue *q, struct member *m)
+{
+	char device[80];
+
+	member_device(m, device, sizeof(device));
+	member_index_add(member_interfaces, m->interface, q, m);
+	member_index_add(member_devices, device, q, m);
+}
+
+/*! \brief Remove a member of a queue from the indexes
+ * \note the queue's lock must be held */
+static void member_index_unlink(struct call_queue *q, struct member *m)
+{
+	char device[80];
+
+	member_device(m, device, sizeof(device));
+	member_index_remove(member_interfaces, m->interface, m);
+	member_index_remove(member_devices, device, m);
+}
+
+/*! \brief Add a member to a queue and to the member indexes
+ * \note the queue's lock must be held */
+static void link_member(struct call_queue *q, struct member *m)
+{
+	ao2_link(q->members, m);
+	member_index_link(q, m);
+	member_available_changed(q, m, 0);
+}
+
+/*! \brief Remove a member from a queue and from the member indexes
+ * \note the queue's lock must be held */
+static void unlink_member(struct call_queue *q, struct member *m)
+{
+	if (member_is_available(q, m))
+		q->available--;
+	member_index_unlink(q, m);
+	ao2_unlink(q->members, m);
+}
+
+/*! \brief set a member's status based on device state of that member's interface*/
+static int handle_statechange(void *datap)
+{
+	struct statechange *sc = datap;
+	struct member_queues memberships;
+	struct member_queue *mq;
+	struct call_queue *q;
+	int found = 0;
+
+	/* Only the queues this device has members in */
+	member_index_copy(member_devices, sc->dev, &memberships);
+	while ((mq = TRIS_LIST_REMOVE_HEAD(&memberships, list))) {
+		if ((q = member_queue_lock(mq))) {
+			found = 1;
+			update_status(q, mq->member, sc->state);
+			ao2_unlock(q);
+			queue_t_unref(q, "Done with member's queue");
+		}
+		member_queue_free(mq);
 	}
-	ao2_iterator_destroy(&qiter);
 
 	if (found)
 		tris_debug(1, "Device '%s' changed to state '%d' (%s)\n", sc->dev, sc->state, tris_devstate2str(sc->state));
@@ -1121,7 +1449,8 @@ static void device_state_cb(const struct tris_event *event, void *unused)
 	}
 	sc->state = state;
 	strcpy(sc->dev, device);
-	if (tris_taskprocessor_push(devicestate_tps, handle_statechange, sc) < 0) {
+	/* updates for one device stay in order, different devices are handled in parallel */
+	if (tris_taskprocessor_push_keyed(devicestate_tps, sc->dev, handle_statechange, sc) < 0) {
 		tris_free(sc);
 	}
 }
@@ -1201,6 +1530,7 @@ static void init_queue(struct call_queue *q)
 	q->roundingseconds = 0; /* Default - don't announce seconds */
 	q->servicelevel = 0;
 	q->ringinuse = 1;
+	recount_available(q);
 	q->setinterfacevar = 0;
 	q->setqueuevar = 0;
 	q->setqueueentryvar = 0;
@@ -1500,6 +1830,7 @@ static void queue_set_param(struct call_queue *q, const char *param, const char
 			q->timeout = DEFAULT_TIMEOUT;
 	} else if (!strcasecmp(param, "ringinuse")) {
 		q->ringinuse = tris_true(val);
+		recount_available(q);
 	} else if (!strcasecmp(param, "setinterfacevar")) {
 		q->setinterfacevar = tris_true(val);
 	} else if (!strcasecmp(param, "setqueuevar")) {
@@ -1719,10 +2050,15 @@ static void rt_handle_member_record(struct call_queue *q, char *interface, const
  		if (!strcasecmp(m->rt_uniqueid, rt_uniqueid)) {
  			m->dead = 0;	/* Do not delete this one. */
  			tris_copy_string(m->rt_uniqueid, rt_uniqueid, sizeof(m->rt_uniqueid));
- 			if (paused_str)
+ 			if (paused_str) {
+				int was_available = member_is_available(q, m);
  				m->paused = paused;
+				member_available_changed(q, m, was_available);
+			}
  			if (strcasecmp(state_interface, m->state_interface)) {
+				member_index_unlink(q, m);
  				tris_copy_string(m->state_interface, state_interface, sizeof(m->state_interface));
+				member_index_link(q, m);
  			}	   
  			m->penalty = penalty;
  			found = 1;
@@ -1740,7 +2076,7 @@ static void rt_handle_member_record(struct call_queue *q, char *interface, const
 			m->realtime = 1;
 			tris_copy_string(m->rt_uniqueid, rt_uniqueid, sizeof(m->rt_uniqueid));
 			tris_queue_log(q->name, "REALTIME", m->interface, "ADDMEMBER", "%s", "");
-			ao2_link(q->members, m);
+			link_member(q, m);
 			ao2_ref(m, -1);
 			m = NULL;
 			q->membercount++;
@@ -1757,7 +2093,7 @@ static void free_members(struct call_queue *q, int all)
 
 	while ((cur = ao2_iterator_next(&mem_iter))) {
 		if (all || !cur->dynamic) {
-			ao2_unlink(q->members, cur);
+			unlink_member(q, cur);
 			q->membercount--;
 		}
 		ao2_ref(cur, -1);
@@ -1926,7 +2262,7 @@ static struct call_queue *find_queue_by_name_rt(const char *queuename, struct tr
 	while ((m = ao2_iterator_next(&mem_iter))) {
 		if (m->dead) {
 			tris_queue_log(q->name, "REALTIME", m->interface, "REMOVEMEMBER", "%s", "");
-			ao2_unlink(q->members, m);
+			unlink_member(q, m);
 			q->membercount--;
 		}
 		ao2_ref(m, -1);
@@ -2052,7 +2388,7 @@ static void update_realtime_members(struct call_queue *q)
 	while ((m = ao2_iterator_next(&mem_iter))) {
 		if (m->dead) {
 			tris_queue_log(q->name, "REALTIME", m->interface, "REMOVEMEMBER", "%s", "");
-			ao2_unlink(q->members, m);
+			unlink_member(q, m);
 			q->membercount--;
 		}
 		ao2_ref(m, -1);
@@ -2093,6 +2429,16 @@ static int join_queue(char *queuename, struct queue_ent *qe, enum queue_result *
 		/* There's space for us, put us at the right position inside
 		 * the queue.
 		 * Take into account the priority of the calling user */
+		if (pipe(qe->wakeup)) {
+			tris_log(LOG_WARNING, "Unable to create wakeup pipe, %s will poll for its turn: %s\n", qe->chan->name, strerror(errno));
+			qe->wakeup[0] = qe->wakeup[1] = -1;
+		} else {
+			fcntl(qe->wakeup[0], F_SETFL, fcntl(qe->wakeup[0], F_GETFL) | O_NONBLOCK);
+			fcntl(qe->wakeup[1], F_SETFL, fcntl(qe->wakeup[1], F_GETFL) | O_NONBLOCK);
+		}
+		/* Check our turn straight away */
+		qe->dispatched = 1;
+		qe->dispatch_time = tris_tvnow();
 		inserted = 0;
 		prev = NULL;
 		cur = q->head;
@@ -2384,12 +2730,19 @@ static void leave_queue(struct queue_ent *qe)
 			/* Free penalty rules */
 			while ((pr_iter = TRIS_LIST_REMOVE_HEAD(&qe->qe_rules, list)))
 				tris_free(pr_iter);
+			if (qe->wakeup[0] > -1) {
+				close(qe->wakeup[0]);
+				close(qe->wakeup[1]);
+				qe->wakeup[0] = qe->wakeup[1] = -1;
+			}
 		} else {
 			/* Renumber the people after us in the queue based on a new count */
 			current->pos = ++pos;
 			prev = current;
 		}
 	}
+	/* The callers behind us have moved up */
+	queue_dispatch(q, tris_tvnow());
 	ao2_unlock(q);
 
 	/*If the queue is a realtime queue, check to see if it's still defined in real time*/
@@ -2439,82 +2792,33 @@ static void hangupcalls(struct callattempt *outgoing, struct tris_channel *excep
  * \param[in] q The queue for which we are couting the number of available members
  * \return Return the number of available members in queue q
  */
-static int num_available_members(struct call_queue *q)
-{
-	struct member *mem;
-	int avl = 0;
-	struct ao2_iterator mem_iter;
-
-	mem_iter = ao2_iterator_init(q->members, 0);
-	while ((mem = ao2_iterator_next(&mem_iter))) {
-		switch (mem->status) {
-		case TRIS_DEVICE_INUSE:
-			if (!q->ringinuse)
-				break;
-			/* else fall through */
-		case TRIS_DEVICE_NOT_INUSE:
-		case TRIS_DEVICE_UNKNOWN:
-			if (!mem->paused) {
-				avl++;
-			}
-			break;
-		}
-		ao2_ref(mem, -1);
-
-		/* If autofill is not enabled or if the queue's strategy is ringall, then
-		 * we really don't care about the number of available members so much as we
-		 * do that there is at least one available.
-		 *
-		 * In fact, we purposely will return from this function stating that only
-		 * one member is available if either of those conditions hold. That way,
-		 * functions which determine what action to take based on the number of available
-		 * members will operate properly. The reasoning is that even if multiple
-		 * members are available, only the head caller can actually be serviced.
-		 */
-		if ((!q->autofill || q->strategy == QUEUE_STRATEGY_RINGALL) && avl) {
-			break;
-		}
-	}
-	ao2_iterator_destroy(&mem_iter);
-
-	return avl;
-}
-
 /* traverse all defined queues which have calls waiting and contain this member
    return 0 if no other queue has precedence (higher weight) or 1 if found  */
 static int compare_weight(struct call_queue *rq, struct member *member)
 {
 	struct call_queue *q;
-	struct member *mem;
+	struct member_queues memberships;
+	struct member_queue *mq;
 	int found = 0;
-	struct ao2_iterator queue_iter;
-	
+
 	/* q's lock and rq's lock already set by try_calling()
 	 * to solve deadlock */
-	queue_iter = ao2_iterator_init(queues, 0);
-	while ((q = ao2_t_iterator_next(&queue_iter, "Iterate through queues"))) {
-		if (q == rq) { /* don't check myself, could deadlock */
-			queue_t_unref(q, "Done with iterator");
-			continue;
-		}
-		ao2_lock(q);
-		if (q->count && q->members) {
-			if ((mem = ao2_find(q->members, member, OBJ_POINTER))) {
-				tris_debug(1, "Found matching member %s in queue '%s'\n", mem->interface, q->name);
+	member_index_copy(member_interfaces, member->interface, &memberships);
+	while ((mq = TRIS_LIST_REMOVE_HEAD(&memberships, list))) {
+		/* don't check myself, could deadlock */
+		if (!found && strcasecmp(mq->queue, rq->name) && (q = member_queue_lock(mq))) {
+			if (q->count) {
+				tris_debug(1, "Found matching member %s in queue '%s'\n", mq->member->interface, q->name);
 				if (q->weight > rq->weight && q->count >= num_available_members(q)) {
 					tris_debug(1, "Queue '%s' (weight %d, calls %d) is preferred over '%s' (weight %d, calls %d)\n", q->name, q->weight, q->count, rq->name, rq->weight, rq->count);
 					found = 1;
 				}
-				ao2_ref(mem, -1);
 			}
+			ao2_unlock(q);
+			queue_t_unref(q, "Done with member's queue");
 		}
-		ao2_unlock(q);
-		queue_t_unref(q, "Done with iterator");
-		if (found) {
-			break;
-		}
+		member_queue_free(mq);
 	}
-	ao2_iterator_destroy(&queue_iter);
 	return found;
 }
 
@@ -3227,7 +3531,7 @@ static struct callattempt *wait_for_answer(struct queue_ent *qe, struct callatte
 							/* Ignore going off hook */
 							break;
 						default:
-							tris_verb(3, "Dunno what to do with control type %d\n", f->subclass);
+							tris_verb(3, "Dunno what to do with control type %d\n", (int) f->subclass);
 						}
 					}
 					tris_frfree(f);
@@ -3262,13 +3566,13 @@ static struct callattempt *wait_for_answer(struct queue_ent *qe, struct callatte
 				return NULL;
 			}
 			if ((f->frametype == TRIS_FRAME_DTMF) && caller_disconnect && (f->subclass == '*')) {
-				tris_verb(3, "User hit %c to disconnect call.\n", f->subclass);
+				tris_verb(3, "User hit %c to disconnect call.\n", (int) f->subclass);
 				*to = 0;
 				tris_frfree(f);
 				return NULL;
 			}
 			if ((f->frametype == TRIS_FRAME_DTMF) && valid_exit(qe, f->subclass)) {
-				tris_verb(3, "User pressed digit: %c\n", f->subclass);
+				tris_verb(3, "User pressed digit: %c\n", (int) f->subclass);
 				*to = 0;
 				*digit = f->subclass;
 				tris_frfree(f);
@@ -3312,6 +3616,7 @@ static int is_our_turn(struct queue_ent *qe)
 	/* This needs a lock. How many members are available to be served? */
 	ao2_lock(qe->parent);
 
+	qe->dispatched = 0;
 	avl = num_available_members(qe->parent);
 
 	ch = qe->parent->head;
@@ -3324,7 +3629,6 @@ static int is_our_turn(struct queue_ent *qe)
 		ch = ch->next;			
 	}
 
-	ao2_unlock(qe->parent);
 	/* If the queue entry is within avl [the number of available members] calls from the top ... 
 	 * Autofill and position check added to support autofill=no (as only calls
 	 * from the front of the queue are valid when autofill is disabled)
@@ -3334,8 +3638,10 @@ static int is_our_turn(struct queue_ent *qe)
 		res = 1;
 	} else {
 		tris_debug(1, "It's not our turn (%s).\n", qe->chan->name);
+		qe->dispatch_time = tris_tv(0, 0);
 		res = 0;
 	}
+	ao2_unlock(qe->parent);
 
 	return res;
 }
@@ -3368,6 +3674,55 @@ static void update_qe_rule(struct queue_ent *qe)
 	qe->pr = TRIS_LIST_NEXT(qe->pr, list);
 }
 
+/*!
+ * \brief Wait for a digit like tris_waitfordigit(), but return 0 as soon as
+ * queue_dispatch() wakes the caller up
+ *
+ * \retval the digit pressed
+ * \retval 0 on timeout or wakeup
+ * \retval -1 on hangup
+ */
+static int queue_waitfordigit(struct queue_ent *qe, int ms)
+{
+	struct tris_channel *chan = qe->chan, *rchan;
+	struct tris_frame *f;
+	int outfd, res = 0;
+	char buf[16];
+
+	if (qe->wakeup[0] < 0)
+		return tris_waitfordigit(chan, ms);
+
+	if (tris_test_flag(chan, TRIS_FLAG_ZOMBIE) || tris_check_hangup(chan))
+		return -1;
+
+	tris_set_flag(chan, TRIS_FLAG_END_DTMF_ONLY);
+	while (ms && !res) {
+		outfd = -1;
+		errno = 0;
+		rchan = tris_waitfor_nandfds(&chan, 1, &qe->wakeup[0], 1, NULL, &outfd, &ms);
+		if (outfd > -1) {
+			while (read(qe->wakeup[0], buf, sizeof(buf)) > 0);
+			break;
+		} else if (rchan) {
+			if (!(f = tris_read(chan))) {
+				res = -1;
+				break;
+			}
+			if (f->frametype == TRIS_FRAME_DTMF_END)
+				res = f->subclass;
+			else if (f->frametype == TRIS_FRAME_CONTROL && f->subclass == TRIS_CONTROL_HANGUP)
+				res = -1;
+			tris_frfree(f);
+		} else if (ms && errno && errno != EINTR) {
+			tris_log(LOG_WARNING, "Wait failed (%s)\n", strerror(errno));
+			res = -1;
+		}
+	}
+	tris_clear_flag(chan, TRIS_FLAG_END_DTMF_ONLY);
+
+	return res;
+}
+
 /*! \brief The waiting areas for callers who are not actively calling members
  *
  * This function is one large loop. This function will return if a caller
@@ -3381,12 +3736,18 @@ static void update_qe_rule(struct queue_ent *qe)
 static int wait_our_turn(struct queue_ent *qe, int ringing, enum queue_result *reason)
 {
 	int res = 0;
+	time_t recheck = 0;
 
 	/* This is the holding pen for callers 2 through maxlen */
 	for (;;) {
 
-		if (is_our_turn(qe))
-			break;
+		/* queue_dispatch() wakes us when it may be our turn.  Look now and
+		 * then anyway, and every second if we can not be woken. */
+		if (qe->dispatched || qe->wakeup[0] < 0 || time(NULL) >= recheck) {
+			if (is_our_turn(qe))
+				break;
+			recheck = time(NULL) + QUEUE_TURN_RECHECK;
+		}
 
 		/* If we have timed out, break out */
 		if (qe->expire && (time(NULL) >= qe->expire)) {
@@ -3432,8 +3793,8 @@ static int wait_our_turn(struct queue_ent *qe, int ringing, enum queue_result *r
 			break;
 		}
 		
-		/* Wait a second before checking again */
-		if ((res = tris_waitfordigit(qe->chan, RECHECK * 1000))) {
+		/* Wait a second, or until woken, before checking again */
+		if ((res = queue_waitfordigit(qe, RECHECK * 1000))) {
 			if (res > 0 && !valid_exit(qe, res))
 				res = 0;
 			else
@@ -3458,24 +3819,23 @@ static int update_queue(struct call_queue *q, struct member *member, int callcom
 {
 	int oldtalktime;
 
-	struct member *mem;
 	struct call_queue *qtmp;
-	struct ao2_iterator queue_iter;	
+	struct member_queues memberships;
+	struct member_queue *mq;
 	
 	if (shared_lastcall) {
-		queue_iter = ao2_iterator_init(queues, 0);
-		while ((qtmp = ao2_t_iterator_next(&queue_iter, "Iterate through queues"))) {
-			ao2_lock(qtmp);
-			if ((mem = ao2_find(qtmp->members, member, OBJ_POINTER))) {
-				time(&mem->lastcall);
-				mem->calls++;
-				mem->lastqueue = q;
-				ao2_ref(mem, -1);
+		/* Every queue this interface is a member of */
+		member_index_copy(member_interfaces, member->interface, &memberships);
+		while ((mq = TRIS_LIST_REMOVE_HEAD(&memberships, list))) {
+			if ((qtmp = member_queue_lock(mq))) {
+				time(&mq->member->lastcall);
+				mq->member->calls++;
+				mq->member->lastqueue = q;
+				ao2_unlock(qtmp);
+				queue_t_unref(qtmp, "Done with member's queue");
 			}
-			ao2_unlock(qtmp);
-			queue_t_unref(qtmp, "Done with iterator");
+			member_queue_free(mq);
 		}
-		ao2_iterator_destroy(&queue_iter);
 	} else {
 		ao2_lock(q);
 		time(&member->lastcall);
@@ -4004,7 +4364,18 @@ static int try_calling(struct queue_ent *qe, const char *options, char *announce
 		}
 	}
 	orig = to;
+	if (!tris_tvzero(qe->dispatch_time)) {
+		int64_t us = tris_tvdiff_us(tris_tvnow(), qe->dispatch_time);
+
+		qe->parent->dispatch_rings++;
+		qe->parent->dispatch_us += us;
+		if (us > qe->parent->dispatch_max_us)
+			qe->parent->dispatch_max_us = us;
+		qe->dispatch_time = tris_tv(0, 0);
+	}
 	++qe->pending;
+	/* We no longer count toward the callers ahead of the rest */
+	queue_dispatch(qe->parent, tris_tvnow());
 	ao2_unlock(qe->parent);
 	ring_one(qe, outgoing, &numbusies);
 	if (need_weight)
@@ -4680,7 +5051,7 @@ static int remove_from_queue(const char *queuename, const char *interface)
 				"Location: %s\r\n"
 				"MemberName: %s\r\n",
 				q->name, mem->interface, mem->membername);
-			ao2_unlink(q->members, mem);
+			unlink_member(q, mem);
 			ao2_ref(mem, -1);
 
 			if (queue_persistent_members)
@@ -4722,7 +5093,7 @@ static int add_to_queue(const char *queuename, const char *interface, const char
 	if ((old_member = interface_exists(q, interface)) == NULL) {
 		if ((new_member = create_queue_member(interface, membername, penalty, paused, state_interface))) {
 			new_member->dynamic = 1;
-			ao2_link(q->members, new_member);
+			link_member(q, new_member);
 			q->membercount++;
 			manager_event(EVENT_FLAG_AGENT, "QueueMemberAdded",
 				"Queue: %s\r\n"
@@ -4765,7 +5136,7 @@ static int set_member_paused(const char *queuename, const char *interface, const
 	struct call_queue *q;
 	struct member *mem;
 	struct ao2_iterator queue_iter;
-	int failed;
+	int failed, was_available;
 
 	/* Special event for when all queues are paused - individual events still generated */
 	/* XXX In all other cases, we use the membername, but since this affects all queues, we cannot */
@@ -4794,7 +5165,9 @@ static int set_member_paused(const char *queuename, const char *interface, const
 					continue;
 				}	
 				found++;
+				was_available = member_is_available(q, mem);
 				mem->paused = paused;
+				member_available_changed(q, mem, was_available);
 
 				if (queue_persistent_members)
 					dump_queue_members(q);
@@ -6033,8 +6406,13 @@ static void reload_single_member(const char *memberdata, struct call_queue *q)
 	/* Find the old position in the list */
 	tris_copy_string(tmpmem.interface, interface, sizeof(tmpmem.interface));
 	cur = ao2_find(q->members, &tmpmem, OBJ_POINTER | OBJ_UNLINK);
+	if (cur) {
+		if (member_is_available(q, cur))
+			q->available--;
+		member_index_unlink(q, cur);
+	}
 	if ((newm = create_queue_member(interface, membername, penalty, cur ? cur->paused : 0, state_interface))) {
-		ao2_link(q->members, newm);
+		link_member(q, newm);
 		ao2_ref(newm, -1);
 	}
 	newm = NULL;
@@ -6059,6 +6437,7 @@ static int kill_dead_members(void *obj, void *arg, int flags)
 {
 	struct member *member = obj;
 	struct call_queue *q = arg;
+	int was_available;
 
 	if (!member->delme) {
 		if (member->dynamic) {
@@ -6067,10 +6446,15 @@ static int kill_dead_members(void *obj, void *arg, int flags)
 			 */
 			q->membercount++;
 		}
+		was_available = member_is_available(q, member);
 		member->status = tris_device_state(member->state_interface);
+		member_available_changed(q, member, was_available);
 		return 0;
 	} else {
 		q->membercount--;
+		if (member_is_available(q, member))
+			q->available--;
+		member_index_unlink(q, member);
 		return CMP_MATCH;
 	}
 }
@@ -6409,6 +6793,13 @@ static char *__queues_show(struct mansession *s, int fd, int argc, char **argv)
 			int2strat(q->strategy), q->holdtime, q->talktime, q->weight,
 			q->callscompleted, q->callsabandoned,sl,q->servicelevel);
 		do_print(s, fd, tris_str_buffer(out));
+		tris_str_set(&out, 0, "   %d available members, %d callers woken, ", q->available, q->dispatches);
+		if (q->dispatch_rings)
+			tris_str_append(&out, 0, "%.1fms average (%.1fms max) from being served to ringing",
+				q->dispatch_us / 1000.0 / q->dispatch_rings, q->dispatch_max_us / 1000.0);
+		else
+			tris_str_append(&out, 0, "none rang yet");
+		do_print(s, fd, tris_str_buffer(out));
 		if (!ao2_container_count(q->members))
 			do_print(s, fd, "   No Members");
 		else {
@@ -7473,6 +7864,10 @@ static int unload_module(void)
 	ao2_iterator_destroy(&q_iter);
 	ao2_ref(queues, -1);
 	devicestate_tps = tris_taskprocessor_unreference(devicestate_tps);
+	ao2_ref(member_interfaces, -1);
+	member_interfaces = NULL;
+	ao2_ref(member_devices, -1);
+	member_devices = NULL;
 	tris_unload_realtime("queue_members");
 	return res;
 }
@@ -7484,6 +7879,8 @@ static int load_module(void)
 	struct tris_flags mask = {TRIS_FLAGS_ALL, };
 
 	queues = ao2_container_alloc(MAX_QUEUE_BUCKETS, queue_hash_cb, queue_cmp_cb);
+	member_interfaces = ao2_container_alloc(MEMBER_INDEX_BUCKETS, member_index_hash_cb, member_index_cmp_cb);
+	member_devices = ao2_container_alloc(MEMBER_INDEX_BUCKETS, member_index_hash_cb, member_index_cmp_cb);
 
 	use_weight = 0;
 
@@ -7524,7 +7921,7 @@ static int load_module(void)
 	res |= tris_custom_function_register(&queuewaitingcount_function);
 	res |= tris_custom_function_register(&queuememberpenalty_function);
 
-	if (!(devicestate_tps = tris_taskprocessor_get("app_queue", 0))) {
+	if (!(devicestate_tps = tris_taskprocessor_get("app_queue", TPS_POOLED))) {
 		tris_log(LOG_WARNING, "devicestate taskprocessor reference failed - devicestate notifications will not occur\n");
 	}
 
@@ -149,7 +149,7 @@ static int record_exec(struct tris_channel *chan, void *data)
 	int maxduration = 0;		/* max duration of recording in milliseconds */
 	int gottimeout = 0;		/* did we timeout for maxduration exceeded? */
 	int terminator = '#';
-	int rfmt = 0;
+	format_t rfmt = 0;
 	int ioflags;
 	int waitres;
 	struct tris_silence_generator *silgen = NULL;
@@ -642,7 +642,7 @@ static int speech_background(struct tris_channel *chan, void *data)
 	int res = 0, done = 0, started = 0, quieted = 0, max_dtmf_len = 0;
 	struct tris_speech *speech = find_speech(chan);
 	struct tris_frame *f = NULL;
-	int oldreadformat = TRIS_FORMAT_SLINEAR;
+	format_t oldreadformat = TRIS_FORMAT_SLINEAR;
 	char dtmf[TRIS_MAX_EXTENSION] = "";
 	struct timeval start = { 0, 0 }, current;
 	struct tris_datastore *datastore = NULL;
@@ -836,7 +836,7 @@ static int speech_background(struct tris_channel *chan, void *data)
 						started = 1;
 					}
 					start = tris_tvnow();
-					snprintf(tmp, sizeof(tmp), "%c", f->subclass);
+					snprintf(tmp, sizeof(tmp), "%c", (int) f->subclass);
 					strncat(dtmf, tmp, sizeof(dtmf) - strlen(dtmf) - 1);
 					/* If the maximum length of the DTMF has been reached, stop now */
 					if (max_dtmf_len && strlen(dtmf) == max_dtmf_len)
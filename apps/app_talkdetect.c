@@ -87,7 +87,7 @@ static int background_detect_exec(struct tris_channel *chan, void *data)
 	int analysistime = -1;
 	int continue_analysis = 1;
 	int x;
-	int origrformat = 0;
+	format_t origrformat = 0;
 	struct tris_dsp *dsp = NULL;
 	TRIS_DECLARE_APP_ARGS(args,
 		TRIS_APP_ARG(filename);
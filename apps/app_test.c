@@ -87,7 +87,7 @@ static int measurenoise(struct tris_channel *chan, int ms, char *who)
 	short *foo;
 	struct timeval start;
 	struct tris_frame *f;
-	int rformat;
+	format_t rformat;
 	rformat = chan->readformat;
 	if (tris_set_read_format(chan, TRIS_FORMAT_SLINEAR)) {
 		tris_log(LOG_NOTICE, "Unable to set to linear mode!\n");
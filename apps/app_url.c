@@ -154,7 +154,7 @@ static int sendurl_exec(struct tris_channel *chan, void *data)
 					goto out;
 					break;
 				default:
-					tris_log(LOG_WARNING, "Don't know what to do with HTML subclass %d\n", f->subclass);
+					tris_log(LOG_WARNING, "Don't know what to do with HTML subclass %d\n", (int) f->subclass);
 				};
 			}
 			tris_frfree(f);
@@ -1097,7 +1097,7 @@ static struct tris_channel *wait_for_answer(struct tris_channel *in,
 					}
 					break;
 				default:
-					tris_debug(1, "Dunno what to do with control type %d\n", f->subclass);
+					tris_debug(1, "Dunno what to do with control type %d\n", (int) f->subclass);
 				}
 			} else if (single) {
 				switch (f->frametype) {
@@ -1148,7 +1148,7 @@ static struct tris_channel *wait_for_answer(struct tris_channel *in,
 					tris_channel_lock(in);
 					context = pbx_builtin_getvar_helper(in, "EXITCONTEXT");
 					if (onedigit_goto(in, context, (char) f->subclass, 1)) {
-						tris_verb(3, "User hit %c to disconnect call.\n", f->subclass);
+						tris_verb(3, "User hit %c to disconnect call.\n", (int) f->subclass);
 						*to = 0;
 						tris_cdr_noanswer(in->cdr);
 						*result = f->subclass;
@@ -1162,7 +1162,7 @@ static struct tris_channel *wait_for_answer(struct tris_channel *in,
 
 				if (tris_test_flag64(peerflags, OPT_CALLER_HANGUP) &&
 						(f->subclass == '*')) { /* hmm it it not guaranteed to be '*' anymore. */
-					tris_verb(3, "User hit %c to disconnect call.\n", f->subclass);
+					tris_verb(3, "User hit %c to disconnect call.\n", (int) f->subclass);
 					*to = 0;
 					strcpy(pa->status, "CANCEL");
 					tris_cdr_noanswer(in->cdr);
@@ -1185,7 +1185,7 @@ static struct tris_channel *wait_for_answer(struct tris_channel *in,
 				(f->subclass == TRIS_CONTROL_UNHOLD) ||
 				(f->subclass == TRIS_CONTROL_VIDUPDATE) ||
 				 (f->subclass == TRIS_CONTROL_SRCUPDATE))) {
-				tris_verb(3, "%s requested special control %d, passing it to %s\n", in->name, f->subclass, outgoing->chan->name);
+				tris_verb(3, "%s requested special control %d, passing it to %s\n", in->name, (int) f->subclass, outgoing->chan->name);
 				tris_indicate_data(outgoing->chan, f->subclass, f->data.ptr, f->datalen);
 			}
 			tris_frfree(f);
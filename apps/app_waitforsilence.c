@@ -125,7 +125,7 @@ static char *app_noise = "WaitForNoise";
 static int do_waiting(struct tris_channel *chan, int timereqd, time_t waitstart, int timeout, int wait_for_silence) {
 	struct tris_frame *f = NULL;
 	int dsptime = 0;
-	int rfmt = 0;
+	format_t rfmt = 0;
 	int res = 0;
 	struct tris_dsp *sildet;	 /* silence detector dsp */
  	time_t now;
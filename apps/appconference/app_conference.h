@@ -59,6 +59,7 @@
 #include "trismedia/file.h"
 //#include "trismedia/channel_pvt.h>
 #include "trismedia/cli.h"
+#include "trismedia/timing.h"
 
 
 #if (SILDET == 2)
@@ -178,6 +179,12 @@
 // milliseconds to wait between state notification updates
 #define TRIS_CONF_NOTIFICATION_SLEEP 200
 
+// most mixer threads, one per cpu up to this many
+#define TRIS_CONF_MIXERS_MAX 8
+
+// frame intervals a mixer catches up on before it drops them
+#define TRIS_CONF_MIXER_MAX_BEHIND 5
+
 //
 // warning threshold values
 //
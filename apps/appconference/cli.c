@@ -207,7 +207,8 @@ char* conference_show_stats( struct tris_cli_entry *e, int cmd, struct tris_cli_
 		s = &(stats[i]) ;
 
 		// output this conferences stats
-		tris_cli( a->fd, "%-20.20s\n", (char*)( &(s->name) )) ;
+		tris_cli( a->fd, "%-20.20s  ticks => %lu, missed => %lu, max late => %ldms\n", (char*)( &(s->name) ),
+			s->ticks, s->deadline_misses, s->max_late ) ;
 	}
 
 	tris_cli( a->fd, "\n" ) ;
@@ -47,425 +47,580 @@ static int conference_count = 0 ;
 
 
 //
-// main conference function
+// mixer threads
+//
+// a small pool of threads, each woken by a timer every
+// TRIS_CONF_FRAME_INTERVAL, mixes all of the conferences assigned to it.
+// the conferences a mixer runs are only touched by that mixer's thread,
+// new conferences are handed over through the pending list.
 //
 
-void conference_exec( struct tris_conference *conf )
+struct conference_mixer
 {
+	// index, shown by the cli
+	int id ;
+
+	pthread_t thread ;
+
+	// timing source, NULL if none could be opened
+	struct tris_timer *timer ;
+
+	// protects pending, count and stop
+	tris_mutex_t lock ;
+	tris_cond_t cond ;
+
+	// conferences handed to this mixer, not yet picked up
+	struct tris_conference *pending ;
+
+	// conferences run by this mixer, owned by its thread
+	struct tris_conference *active ;
+
+	// number of conferences on pending and active
+	int count ;
+
+	// ticks run and ticks that finished past their deadline
+	unsigned long ticks ;
+	unsigned long deadline_misses ;
 
+	int stop ;
+} ;
+
+static struct conference_mixer mixers[ TRIS_CONF_MIXERS_MAX ] ;
+static int mixer_count = 0 ;
+
+// process one frame interval of a conference.
+// returns -1, without processing anything, if the conference is empty.
+static int conference_tick( struct tris_conference *conf, struct timeval base, long time_diff, struct timeval curr )
+{
 	struct tris_conf_member *next_member;
-	struct tris_conf_member *member, *video_source_member, *dtmf_source_member;;
+	struct tris_conf_member *member, *video_source_member, *dtmf_source_member;
 	struct conf_frame *cfr, *spoken_frames, *send_frames;
 
 	// count number of speakers, number of listeners
 	int speaker_count ;
 	int listener_count ;
 
-	tris_log( TRIS_CONF_DEBUG, "Entered conference_exec, name => %s\n", conf->name ) ;
-
-	// timer timestamps
-	struct timeval base, curr, notify ;
-	base = notify = tris_tvnow();
+	// acquire conference mutex
+	TIMELOG(tris_mutex_lock( &conf->lock ),1,"conf thread conf lock");
 
-	// holds differences of curr and base
-	long time_diff = 0 ;
-	long time_sleep = 0 ;
+	if ( conf->membercount == 0 )
+	{
+		// release the conference mutex, the mixer removes the conference
+		tris_mutex_unlock( &conf->lock ) ;
+		return -1 ;
+	}
 
-	int since_ltris_slept = 0 ;
+	// update the current delivery time
+	conf->delivery_time = base ;
 
 	//
-	// variables for checking thread frequency
+	// loop through the list of members
+	// ( conf->memberlist is a single-linked list )
 	//
 
-	// count to TRIS_CONF_FRAMES_PER_SECOND
-	int tf_count = 0 ;
-	long tf_diff = 0 ;
-	float tf_frequency = 0.0 ;
+	// tris_log( TRIS_CONF_DEBUG, "begin processing incoming audio, name => %s\n", conf->name ) ;
 
-	struct timeval tf_base, tf_curr ;
-	tf_base = tris_tvnow();
+	// reset speaker and listener count
+	speaker_count = 0 ;
+	listener_count = 0 ;
 
-	//
-	// main conference thread loop
-	//
+	// get list of conference members
+	member = conf->memberlist ;
 
+	// reset pointer lists
+	spoken_frames = NULL ;
 
-	while ( 42 == 42 )
-	{
-		// update the current timestamp
-		curr = tris_tvnow();
+	// reset video source
+	video_source_member = NULL;
 
-		// calculate difference in timestamps
-		time_diff = tris_tvdiff_ms(curr, base);
+                // reset dtmf source
+	dtmf_source_member = NULL;
 
-		// calculate time we should sleep
-		time_sleep = TRIS_CONF_FRAME_INTERVAL - time_diff ;
+	// loop over member list to retrieve queued frames
+	while ( member != NULL )
+	{
+		// take note of next member - before it's too late
+		next_member = member->next;
 
-		if ( time_sleep > 0 )
-		{
-			// sleep for sleep_time ( as milliseconds )
-			usleep( time_sleep * 1000 ) ;
+		// this MIGHT delete member
+		member_process_spoken_frames(conf,member,&spoken_frames,time_diff,
+					     &listener_count, &speaker_count);
 
-			// reset since last slept counter
-			since_ltris_slept = 0 ;
+		// adjust our pointer to the next inline
+		member = next_member;
+	}
 
-			continue ;
-		}
-		else
-		{
-			// long sleep warning
-			if (
-				since_ltris_slept == 0
-				&& time_diff > TRIS_CONF_CONFERENCE_SLEEP * 2
-			)
-			{
-				tris_log(
-					TRIS_CONF_DEBUG,
-					"long scheduling delay, time_diff => %ld, TRIS_CONF_FRAME_INTERVAL => %d\n",
-					time_diff, TRIS_CONF_FRAME_INTERVAL
-				) ;
-			}
+	// tris_log( TRIS_CONF_DEBUG, "finished processing incoming audio, name => %s\n", conf->name ) ;
 
-			// increment times since last slept
-			++since_ltris_slept ;
 
-			// sleep every other time
-			if ( since_ltris_slept % 2 )
-				usleep( 0 ) ;
-		}
+	//---------------//
+	// MIXING FRAMES //
+	//---------------//
 
-		// adjust the timer base ( it will be used later to timestamp outgoing frames )
-		add_milliseconds( &base, TRIS_CONF_FRAME_INTERVAL ) ;
+	// mix frames and get batch of outgoing frames
+	send_frames = mix_frames( spoken_frames, speaker_count, listener_count ) ;
 
-		//
-		// check thread frequency
-		//
+	// accounting: if there are frames, count them as one incoming frame
+	if ( send_frames != NULL )
+	{
+		// set delivery timestamp
+		//set_conf_frame_delivery( send_frames, base ) ;
+//			tris_log ( LOG_WARNING, "base = %d,%d: conf->delivery_time = %d,%d\n",base.tv_sec,base.tv_usec, conf->delivery_time.tv_sec, conf->delivery_time.tv_usec);
 
-		if ( ++tf_count >= TRIS_CONF_FRAMES_PER_SECOND )
-		{
-			// update current timestamp
-			tf_curr = tris_tvnow();
+		// tris_log( TRIS_CONF_DEBUG, "base => %ld.%ld %d\n", base.tv_sec, base.tv_usec, ( int )( base.tv_usec / 1000 ) ) ;
 
-			// compute timestamp difference
-			tf_diff = tris_tvdiff_ms(tf_curr, tf_base);
+		conf->stats.frames_in++ ;
+	}
 
-			// compute sampling frequency
-			tf_frequency = ( float )( tf_diff ) / ( float )( tf_count ) ;
+	//-----------------//
+	// OUTGOING FRAMES //
+	//-----------------//
 
-			if (
-				( tf_frequency <= ( float )( TRIS_CONF_FRAME_INTERVAL - 1 ) )
-				|| ( tf_frequency >= ( float )( TRIS_CONF_FRAME_INTERVAL + 1 ) )
-			)
-			{
-				tris_log(
-					LOG_WARNING,
-					"processed frame frequency variation, name => %s, tf_count => %d, tf_diff => %ld, tf_frequency => %2.4f\n",
-					conf->name, tf_count, tf_diff, tf_frequency
-				) ;
-			}
+	//
+	// loop over member list to queue outgoing frames
+	//
+	for ( member = conf->memberlist ; member != NULL ; member = member->next )
+	{
+		member_process_outgoing_frames(conf, member, send_frames);
+	}
 
-			// reset values
-			tf_base = tf_curr ;
-			tf_count = 0 ;
-		}
+	//-------//
+	// VIDEO //
+	//-------//
 
-		//-----------------//
-		// INCOMING FRAMES //
-		//-----------------//
+	// loop over the incoming frames and send to all outgoing
+	// TODO: this is an O(n^2) algorithm. Can we speed it up without sacrificing per-member switching?
+	for (video_source_member = conf->memberlist;
+	     video_source_member != NULL;
+	     video_source_member = video_source_member->next)
+	{
+		while ((cfr = get_incoming_video_frame( video_source_member )))
+		{
+			for (member = conf->memberlist; member != NULL; member = member->next)
+			{
+				// skip members that are not ready or are not supposed to receive video
+				if ( !member->ready_for_outgoing || member->norecv_video )
+					continue ;
 
-		// tris_log( TRIS_CONF_DEBUG, "PROCESSING FRAMES, conference => %s, step => %d, ms => %ld\n",
-		//	conf->name, step, ( base.tv_usec / 20000 ) ) ;
+				if ( conf->video_locked )
+				{
+					// Always send video from the locked source
+					if ( conf->current_video_source_id == video_source_member->id )
+						queue_outgoing_video_frame(member, cfr->fr, conf->delivery_time);
+				} else
+				{
+					// If the member has vad switching disabled and dtmf switching enabled, use that
+					if ( member->dtmf_switch &&
+					     !member->vad_switch &&
+					     member->req_id == video_source_member->id
+					   )
+					{
+						queue_outgoing_video_frame(member, cfr->fr, conf->delivery_time);
+					} else if(member->vad_switch)
+					{
+						// If no dtmf switching, then do VAD switching
+						// The VAD switching decision code should make sure that our video source
+						// is legit
+						if ( (conf->current_video_source_id == video_source_member->id) ||
+						       (conf->current_video_source_id < 0 &&
+						        conf->default_video_source_id == video_source_member->id
+						       )
+						   )
+						{
+							queue_outgoing_video_frame(member, cfr->fr, conf->delivery_time);
+						}
+					} else {
+						if(member->req_id == video_source_member->id) {
+							queue_outgoing_video_frame(member, cfr->fr, conf->delivery_time);
+						}
+						if(video_source_member->receiver_channel_name != NULL && 
+							!strcmp(member->channel_name, video_source_member->receiver_channel_name)) {
+							queue_outgoing_video_frame(member, cfr->fr, conf->delivery_time);
+						}
+					}
 
-		//
-		// check if the conference is empty and if so
-		// remove it and break the loop
-		//
 
-		// acquire the conference list lock
-		tris_mutex_lock(&conflist_lock);
+				}
+			}
+			// Garbage collection
+			delete_conf_frame(cfr);
+		}
+	}
+		 
+	 //---------//
+	 // DESKTOP //
+	 //---------//
+
+	 struct tris_conf_member * default_member = get_default_member(conf);
+	 // loop over the incoming frames and send to all outgoing
+	 if (default_member) {
+		 while ((cfr = get_incoming_desktop_frame( default_member )))
+		 {
+			 for (member = conf->memberlist; member != NULL; member = member->next)
+			 {
+				 // skip members that are not ready or are not supposed to receive video
+				 if ( !member->ready_for_outgoing || member->norecv_desktop)
+					 continue ;
+	 
+				 queue_outgoing_desktop_frame(member, cfr->fr, conf->delivery_time);
+			 }
+			 // Garbage collection
+			 delete_conf_frame(cfr);
+		 }
+	 }
 
-		// acquire the conference mutex
-		tris_mutex_lock(&conf->lock);
+              //------//
+	// DTMF  //
+	//------//
 
-		if ( conf->membercount == 0 )
+	// loop over the incoming frames and send to all outgoing
+	for (dtmf_source_member = conf->memberlist; dtmf_source_member != NULL; dtmf_source_member = dtmf_source_member->next)
+	{
+		while ((cfr = get_incoming_dtmf_frame( dtmf_source_member )))
 		{
-			if (conf->debug_flag)
+			for (member = conf->memberlist; member != NULL; member = member->next)
 			{
-				tris_log( LOG_NOTICE, "removing conference, count => %d, name => %s\n", conf->membercount, conf->name ) ;
-			}
-			remove_conf( conf ) ; // stop the conference
+				// skip members that are not ready
+				if ( member->ready_for_outgoing == 0 )
+				{
+					continue ;
+				}
 
-			// We don't need to release the conf mutex, since it was destroyed anyway
+				if (member != dtmf_source_member)
+				{
+ 						// Send the latest frame
+					queue_outgoing_dtmf_frame(member, cfr->fr);
+				}
+			}
+			// Garbage collection
+			delete_conf_frame(cfr);
+		}
+	}
 
-			// release the conference list lock
-			tris_mutex_unlock(&conflist_lock);
+	//---------//
+	// CLEANUP //
+	//---------//
 
-			break ; // break from main processing loop
-		}
+	// clean up send frames
+	while ( send_frames != NULL )
+	{
+		// accouting: count all frames and mixed frames
+		if ( send_frames->member == NULL )
+			conf->stats.frames_out++ ;
+		else
+			conf->stats.frames_mixed++ ;
 
-		// release the conference mutex
-		tris_mutex_unlock(&conf->lock);
+		// delete the frame
+		send_frames = delete_conf_frame( send_frames ) ;
+	}
 
-		// release the conference list lock
-		tris_mutex_unlock(&conflist_lock);
+	//
+	// notify the manager of state changes every 100 milliseconds
+	// we piggyback on this for VAD switching logic
+	//
 
+	if ( ( tris_tvdiff_ms(curr, conf->notify) / TRIS_CONF_NOTIFICATION_SLEEP ) >= 1 )
+	{
+		// Do VAD switching logic
+		// We need to do this here since send_state_change_notifications
+		// resets the flags
+		if ( !conf->video_locked )
+			do_VAD_switching(conf);
 
-		//
-		// Start processing frames
-		//
+		// send the notifications
+		send_state_change_notifications( conf->memberlist ) ;
 
-		// acquire conference mutex
-		TIMELOG(tris_mutex_lock( &conf->lock ),1,"conf thread conf lock");
+		// increment the notification timer base
+		add_milliseconds( &conf->notify, TRIS_CONF_NOTIFICATION_SLEEP ) ;
+	}
 
-		if ( conf->membercount == 0 )
-		{
-			// release the conference mutex
-			tris_mutex_unlock(&conf->lock);
-			continue; // We'll check again at the top of the loop
-		}
+	conf->stats.ticks++ ;
 
-		// update the current delivery time
-		conf->delivery_time = base ;
+	// release conference mutex
+	tris_mutex_unlock( &conf->lock ) ;
 
-		//
-		// loop through the list of members
-		// ( conf->memberlist is a single-linked list )
-		//
+	return 0 ;
+}
 
-		// tris_log( TRIS_CONF_DEBUG, "begin processing incoming audio, name => %s\n", conf->name ) ;
+// called by the mixer thread when a conference had no members on its last tick.
+// returns 1 if the conference has been removed.
+static int conference_reap( struct tris_conference *conf )
+{
+	// new members are added with conflist_lock held, so once we hold it
+	// an empty conference stays empty
+	tris_mutex_lock( &conflist_lock ) ;
+	tris_mutex_lock( &conf->lock ) ;
 
-		// reset speaker and listener count
-		speaker_count = 0 ;
-		listener_count = 0 ;
+	if ( conf->membercount != 0 )
+	{
+		tris_mutex_unlock( &conf->lock ) ;
+		tris_mutex_unlock( &conflist_lock ) ;
+		return 0 ;
+	}
 
-		// get list of conference members
-		member = conf->memberlist ;
+	if ( conf->debug_flag )
+	{
+		tris_log( LOG_NOTICE, "removing conference, count => %d, name => %s\n", conf->membercount, conf->name ) ;
+	}
 
-		// reset pointer lists
-		spoken_frames = NULL ;
+	tris_mutex_lock( &conf->mixer->lock ) ;
+	--conf->mixer->count ;
+	tris_mutex_unlock( &conf->mixer->lock ) ;
 
-		// reset video source
-		video_source_member = NULL;
+	// we don't need to release the conf mutex, since it was destroyed anyway
+	remove_conf( conf ) ;
 
-                // reset dtmf source
-		dtmf_source_member = NULL;
+	tris_mutex_unlock( &conflist_lock ) ;
 
-		// loop over member list to retrieve queued frames
-		while ( member != NULL )
-		{
-			// take note of next member - before it's too late
-			next_member = member->next;
+	return 1 ;
+}
 
-			// this MIGHT delete member
-			member_process_spoken_frames(conf,member,&spoken_frames,time_diff,
-						     &listener_count, &speaker_count);
+// sleep until the next interval, usec from now.
+// with a timing source this returns when the timer fires, which may be
+// before or after the deadline the mixer keeps.
+static void conference_mixer_wait( struct conference_mixer *mixer, long usec )
+{
+	if ( mixer->timer != NULL )
+	{
+		int fd = tris_timer_fd( mixer->timer ) ;
+		int ms = TRIS_CONF_FRAME_INTERVAL * 2 ;
 
-			// adjust our pointer to the next inline
-			member = next_member;
-		}
+		if ( tris_waitfor_n_fd( &fd, 1, &ms, NULL ) == fd )
+			tris_timer_ack( mixer->timer, 1 ) ;
+	}
+	else if ( usec > 0 )
+	{
+		usleep( usec ) ;
+	}
+}
 
-		// tris_log( TRIS_CONF_DEBUG, "finished processing incoming audio, name => %s\n", conf->name ) ;
+static void *conference_mixer_thread( void *data )
+{
+	struct conference_mixer *mixer = data ;
+	struct tris_conference *conf, *next, **prev ;
+	struct timeval deadline, curr ;
+	long late, mixed, skipped ;
 
+	tris_log( TRIS_CONF_DEBUG, "entered conference mixer %d\n", mixer->id ) ;
 
-		//---------------//
-		// MIXING FRAMES //
-		//---------------//
+	deadline = tris_tvnow() ;
 
-		// mix frames and get batch of outgoing frames
-		send_frames = mix_frames( spoken_frames, speaker_count, listener_count ) ;
+	for ( ; ; )
+	{
+		tris_mutex_lock( &mixer->lock ) ;
 
-		// accounting: if there are frames, count them as one incoming frame
-		if ( send_frames != NULL )
+		// nothing to mix, sleep until a conference is handed to us
+		while ( !mixer->stop && mixer->active == NULL && mixer->pending == NULL )
 		{
-			// set delivery timestamp
-			//set_conf_frame_delivery( send_frames, base ) ;
-//			tris_log ( LOG_WARNING, "base = %d,%d: conf->delivery_time = %d,%d\n",base.tv_sec,base.tv_usec, conf->delivery_time.tv_sec, conf->delivery_time.tv_usec);
+			tris_cond_wait( &mixer->cond, &mixer->lock ) ;
+			deadline = tris_tvnow() ;
+		}
 
-			// tris_log( TRIS_CONF_DEBUG, "base => %ld.%ld %d\n", base.tv_sec, base.tv_usec, ( int )( base.tv_usec / 1000 ) ) ;
+		if ( mixer->stop )
+		{
+			tris_mutex_unlock( &mixer->lock ) ;
+			break ;
+		}
 
-			conf->stats.frames_in++ ;
+		// pick up new conferences
+		while ( ( conf = mixer->pending ) != NULL )
+		{
+			mixer->pending = conf->mixer_next ;
+			conf->mixer_next = mixer->active ;
+			mixer->active = conf ;
 		}
 
-		//-----------------//
-		// OUTGOING FRAMES //
-		//-----------------//
+		tris_mutex_unlock( &mixer->lock ) ;
 
-		//
-		// loop over member list to queue outgoing frames
-		//
-		for ( member = conf->memberlist ; member != NULL ; member = member->next )
+		curr = tris_tvnow() ;
+		late = tris_tvdiff_us( curr, deadline ) ;
+
+		if ( late < -TRIS_CONF_FRAME_INTERVAL * 1000 * 2 )
 		{
-			member_process_outgoing_frames(conf, member, send_frames);
+			// the clock went backwards, start over
+			deadline = curr ;
+			late = 0 ;
 		}
 
-		//-------//
-		// VIDEO //
-		//-------//
-
-		// loop over the incoming frames and send to all outgoing
-		// TODO: this is an O(n^2) algorithm. Can we speed it up without sacrificing per-member switching?
-		for (video_source_member = conf->memberlist;
-		     video_source_member != NULL;
-		     video_source_member = video_source_member->next)
+		// wait for the next interval, unless we are a whole interval behind
+		if ( late < 0 || ( mixer->timer != NULL && late < TRIS_CONF_FRAME_INTERVAL * 1000 ) )
 		{
-			while ((cfr = get_incoming_video_frame( video_source_member )))
+			conference_mixer_wait( mixer, -late ) ;
+
+			curr = tris_tvnow() ;
+			late = tris_tvdiff_us( curr, deadline ) ;
+
+			if ( late < 0 )
 			{
-				for (member = conf->memberlist; member != NULL; member = member->next)
-				{
-					// skip members that are not ready or are not supposed to receive video
-					if ( !member->ready_for_outgoing || member->norecv_video )
-						continue ;
+				if ( mixer->timer == NULL )
+					continue ;
 
-					if ( conf->video_locked )
-					{
-						// Always send video from the locked source
-						if ( conf->current_video_source_id == video_source_member->id )
-							queue_outgoing_video_frame(member, cfr->fr, conf->delivery_time);
-					} else
-					{
-						// If the member has vad switching disabled and dtmf switching enabled, use that
-						if ( member->dtmf_switch &&
-						     !member->vad_switch &&
-						     member->req_id == video_source_member->id
-						   )
-						{
-							queue_outgoing_video_frame(member, cfr->fr, conf->delivery_time);
-						} else if(member->vad_switch)
-						{
-							// If no dtmf switching, then do VAD switching
-							// The VAD switching decision code should make sure that our video source
-							// is legit
-							if ( (conf->current_video_source_id == video_source_member->id) ||
-							       (conf->current_video_source_id < 0 &&
-							        conf->default_video_source_id == video_source_member->id
-							       )
-							   )
-							{
-								queue_outgoing_video_frame(member, cfr->fr, conf->delivery_time);
-							}
-						} else {
-							if(member->req_id == video_source_member->id) {
-								queue_outgoing_video_frame(member, cfr->fr, conf->delivery_time);
-							}
-							if(video_source_member->receiver_channel_name != NULL && 
-								!strcmp(member->channel_name, video_source_member->receiver_channel_name)) {
-								queue_outgoing_video_frame(member, cfr->fr, conf->delivery_time);
-							}
-						}
+				// the timer sets the pace, line the deadline up with it
+				deadline = curr ;
+				late = 0 ;
+			}
+		}
 
+		// too far behind to catch up, drop the intervals we missed
+		if ( late >= TRIS_CONF_FRAME_INTERVAL * 1000 * TRIS_CONF_MIXER_MAX_BEHIND )
+		{
+			skipped = late / ( TRIS_CONF_FRAME_INTERVAL * 1000 ) ;
 
-					}
-				}
-				// Garbage collection
-				delete_conf_frame(cfr);
+			tris_log( TRIS_CONF_DEBUG, "conference mixer %d skipping %ld intervals\n", mixer->id, skipped ) ;
+
+			add_milliseconds( &deadline, skipped * TRIS_CONF_FRAME_INTERVAL ) ;
+			late -= skipped * TRIS_CONF_FRAME_INTERVAL * 1000 ;
+			mixer->deadline_misses += skipped ;
+
+			for ( conf = mixer->active ; conf != NULL ; conf = conf->mixer_next )
+			{
+				tris_mutex_lock( &conf->lock ) ;
+				conf->stats.deadline_misses += skipped ;
+				tris_mutex_unlock( &conf->lock ) ;
 			}
 		}
-			 
-		 //---------//
-		 // DESKTOP //
-		 //---------//
-
-		 struct tris_conf_member * default_member = get_default_member(conf);
-		 // loop over the incoming frames and send to all outgoing
-		 if (default_member) {
-			 while ((cfr = get_incoming_desktop_frame( default_member )))
-			 {
-				 for (member = conf->memberlist; member != NULL; member = member->next)
-				 {
-					 // skip members that are not ready or are not supposed to receive video
-					 if ( !member->ready_for_outgoing || member->norecv_desktop)
-						 continue ;
-		 
-					 queue_outgoing_desktop_frame(member, cfr->fr, conf->delivery_time);
-				 }
-				 // Garbage collection
-				 delete_conf_frame(cfr);
-			 }
-		 }
 
-              //------//
-		// DTMF  //
-		//------//
+		++mixer->ticks ;
 
-		// loop over the incoming frames and send to all outgoing
-		for (dtmf_source_member = conf->memberlist; dtmf_source_member != NULL; dtmf_source_member = dtmf_source_member->next)
+		// run one interval of every conference
+		prev = &mixer->active ;
+		while ( ( conf = *prev ) != NULL )
 		{
-			while ((cfr = get_incoming_dtmf_frame( dtmf_source_member )))
+			next = conf->mixer_next ;
+
+			if ( conference_tick( conf, deadline, late / 1000 + TRIS_CONF_FRAME_INTERVAL, curr ) )
 			{
-				for (member = conf->memberlist; member != NULL; member = member->next)
+				// conf is freed once it has been reaped
+				if ( conference_reap( conf ) )
 				{
-					// skip members that are not ready
-					if ( member->ready_for_outgoing == 0 )
-					{
-						continue ;
-					}
+					*prev = next ;
+					continue ;
+				}
+			}
+			else
+			{
+				// a conference misses its deadline when it is mixed after the next interval started
+				mixed = tris_tvdiff_us( tris_tvnow(), deadline ) ;
 
-					if (member != dtmf_source_member)
-					{
- 						// Send the latest frame
-						queue_outgoing_dtmf_frame(member, cfr->fr);
-					}
+				if ( mixed >= TRIS_CONF_FRAME_INTERVAL * 1000 )
+				{
+					tris_mutex_lock( &conf->lock ) ;
+					conf->stats.deadline_misses++ ;
+					if ( mixed / 1000 > conf->stats.max_late )
+						conf->stats.max_late = mixed / 1000 ;
+					tris_mutex_unlock( &conf->lock ) ;
 				}
-				// Garbage collection
-				delete_conf_frame(cfr);
 			}
+
+			prev = &conf->mixer_next ;
 		}
 
-		//---------//
-		// CLEANUP //
-		//---------//
+		if ( tris_tvdiff_us( tris_tvnow(), deadline ) >= TRIS_CONF_FRAME_INTERVAL * 1000 )
+			++mixer->deadline_misses ;
 
-		// clean up send frames
-		while ( send_frames != NULL )
-		{
-			// accouting: count all frames and mixed frames
-			if ( send_frames->member == NULL )
-				conf->stats.frames_out++ ;
-			else
-				conf->stats.frames_mixed++ ;
+		add_milliseconds( &deadline, TRIS_CONF_FRAME_INTERVAL ) ;
+	}
 
-			// delete the frame
-			send_frames = delete_conf_frame( send_frames ) ;
-		}
+	tris_log( TRIS_CONF_DEBUG, "exit conference mixer %d\n", mixer->id ) ;
 
-		//
-		// notify the manager of state changes every 100 milliseconds
-		// we piggyback on this for VAD switching logic
-		//
+	return NULL ;
+}
+
+// start the mixer threads, called with conflist_lock held
+static int start_conference_mixers( void )
+{
+	long cpus = sysconf( _SC_NPROCESSORS_ONLN ) ;
+	int count = ( cpus < 1 ) ? 1 : ( cpus > TRIS_CONF_MIXERS_MAX ) ? TRIS_CONF_MIXERS_MAX : cpus ;
+	struct conference_mixer *mixer ;
 
-		if ( ( tris_tvdiff_ms(curr, notify) / TRIS_CONF_NOTIFICATION_SLEEP ) >= 1 )
+	while ( mixer_count < count )
+	{
+		mixer = &mixers[ mixer_count ] ;
+
+		memset( mixer, 0, sizeof( *mixer ) ) ;
+		mixer->id = mixer_count ;
+		tris_mutex_init( &mixer->lock ) ;
+		tris_cond_init( &mixer->cond, NULL ) ;
+
+		if ( ( mixer->timer = tris_timer_open() ) != NULL )
 		{
-			// Do VAD switching logic
-			// We need to do this here since send_state_change_notifications
-			// resets the flags
-			if ( !conf->video_locked )
-				do_VAD_switching(conf);
+			if ( tris_timer_set_rate( mixer->timer, TRIS_CONF_FRAMES_PER_SECOND ) )
+			{
+				tris_timer_close( mixer->timer ) ;
+				mixer->timer = NULL ;
+			}
+		}
 
-			// send the notifications
-			send_state_change_notifications( conf->memberlist ) ;
+		if ( mixer->timer == NULL )
+			tris_log( LOG_WARNING, "no timing source for conference mixer %d, falling back to sleeping\n", mixer->id ) ;
 
-			// increment the notification timer base
-			add_milliseconds( &notify, TRIS_CONF_NOTIFICATION_SLEEP ) ;
+		if ( tris_pthread_create( &mixer->thread, NULL, conference_mixer_thread, mixer ) )
+		{
+			tris_log( LOG_ERROR, "unable to start conference mixer %d\n", mixer->id ) ;
+			if ( mixer->timer != NULL )
+				tris_timer_close( mixer->timer ) ;
+			tris_cond_destroy( &mixer->cond ) ;
+			tris_mutex_destroy( &mixer->lock ) ;
+			break ;
 		}
 
-		// release conference mutex
-		tris_mutex_unlock( &conf->lock ) ;
+		++mixer_count ;
+	}
+
+	return mixer_count ? 0 : -1 ;
+}
+
+// hand a new conference to the least loaded mixer, called with conflist_lock held
+static int add_conference_to_mixer( struct tris_conference *conf )
+{
+	struct conference_mixer *mixer = NULL ;
+	int i ;
 
-		// !!! TESTING !!!
-		// usleep( 1 ) ;
+	if ( start_conference_mixers() )
+		return -1 ;
+
+	for ( i = 0 ; i < mixer_count ; ++i )
+	{
+		if ( mixer == NULL || mixers[ i ].count < mixer->count )
+			mixer = &mixers[ i ] ;
 	}
-	// end while ( 42 == 42 )
 
-	//
-	// exit the conference thread
-	//
+	conf->mixer = mixer ;
 
-	tris_log( TRIS_CONF_DEBUG, "exit conference_exec\n" ) ;
+	tris_mutex_lock( &mixer->lock ) ;
+	conf->mixer_next = mixer->pending ;
+	mixer->pending = conf ;
+	++mixer->count ;
+	tris_cond_signal( &mixer->cond ) ;
+	tris_mutex_unlock( &mixer->lock ) ;
 
-	// exit the thread
-	pthread_exit( NULL ) ;
+	return 0 ;
+}
 
-	return ;
+// stop the mixer threads, called by app_conference.c:unload_module()
+void stop_conference_mixers( void )
+{
+	struct conference_mixer *mixer ;
+	int i ;
+
+	for ( i = 0 ; i < mixer_count ; ++i )
+	{
+		mixer = &mixers[ i ] ;
+
+		tris_mutex_lock( &mixer->lock ) ;
+		mixer->stop = 1 ;
+		tris_cond_signal( &mixer->cond ) ;
+		tris_mutex_unlock( &mixer->lock ) ;
+
+		pthread_join( mixer->thread, NULL ) ;
+
+		if ( mixer->timer != NULL )
+			tris_timer_close( mixer->timer ) ;
+		tris_cond_destroy( &mixer->cond ) ;
+		tris_mutex_destroy( &mixer->lock ) ;
+	}
+
+	mixer_count = 0 ;
 }
 
 //
@@ -581,7 +736,8 @@ struct tris_conference* create_conf( char* name, struct tris_conf_member* member
 	conf->memberlist = NULL ;
 
 	conf->membercount = 0 ;
-	conf->conference_thread = -1 ;
+	conf->mixer = NULL ;
+	conf->mixer_next = NULL ;
 
 	conf->debug_flag = 0 ;
 
@@ -597,6 +753,7 @@ struct tris_conference* create_conf( char* name, struct tris_conf_member* member
 
 	// record start time
 	conf->stats.time_entered = tris_tvnow();
+	conf->notify = conf->stats.time_entered ;
 
 	// copy name to conference
 	strncpy( (char*)&(conf->name), name, sizeof(conf->name) - 1 ) ;
@@ -621,33 +778,19 @@ struct tris_conference* create_conf( char* name, struct tris_conf_member* member
 	tris_log( TRIS_CONF_DEBUG, "added new conference to conflist, name => %s\n", name ) ;
 
 	//
-	// spawn thread for new conference, using conference_exec( conf )
+	// hand the new conference to a mixer thread
 	//
-	// acquire conference mutexes
-	tris_mutex_lock( &conf->lock ) ;
-
-	if ( tris_pthread_create( &conf->conference_thread, NULL, (void*)conference_exec, conf ) == 0 )
+	if ( add_conference_to_mixer( conf ) == 0 )
 	{
-		// detach the thread so it doesn't leak
-		pthread_detach( conf->conference_thread ) ;
-
 		// prepend new conference to conflist
 		conf->next = conflist ;
 		conflist = conf ;
 
-		// release conference mutexes
-		tris_mutex_unlock( &conf->lock ) ;
-
-		tris_log( TRIS_CONF_DEBUG, "started conference thread for conference, name => %s\n", conf->name ) ;
+		tris_log( TRIS_CONF_DEBUG, "started mixing conference, name => %s, mixer => %d\n", conf->name, conf->mixer->id ) ;
 	}
 	else
 	{
-		tris_log( LOG_ERROR, "unable to start conference thread for conference %s\n", conf->name ) ;
-
-		conf->conference_thread = -1 ;
-
-		// release conference mutexes
-		tris_mutex_unlock( &conf->lock ) ;
+		tris_log( LOG_ERROR, "unable to start mixing conference %s\n", conf->name ) ;
 
 		// clean up conference
 		free( conf ) ;
@@ -1149,6 +1292,8 @@ int get_conference_count( void )
 
 int show_conference_stats ( int fd )
 {
+	int i ;
+
         // no conferences exist
 	if ( conflist == NULL )
 	{
@@ -1161,15 +1306,24 @@ int show_conference_stats ( int fd )
 
 	struct tris_conference *conf = conflist ;
 
-	tris_cli( fd, "%-20.20s  %-40.40s\n", "Name", "Members") ;
+	tris_cli( fd, "%-20.20s  %-7.7s  %-5.5s  %-10.10s  %-8.8s  %-8.8s\n", "Name", "Members", "Mixer", "Ticks", "Missed", "Max late" ) ;
 
 	// loop through conf list
 	while ( conf != NULL )
 	{
-		tris_cli( fd, "%-20.20s %3d\n", conf->name, conf->membercount ) ;
+		tris_cli( fd, "%-20.20s  %7d  %5d  %10lu  %8lu  %6ldms\n", conf->name, conf->membercount,
+			conf->mixer->id, conf->stats.ticks, conf->stats.deadline_misses, conf->stats.max_late ) ;
 		conf = conf->next ;
 	}
 
+	tris_cli( fd, "\n%-5.5s  %-11.11s  %-10.10s  %-8.8s  %-6.6s\n", "Mixer", "Conferences", "Ticks", "Missed", "Timer" ) ;
+
+	for ( i = 0 ; i < mixer_count ; ++i )
+	{
+		tris_cli( fd, "%5d  %11d  %10lu  %8lu  %-6.6s\n", mixers[ i ].id, mixers[ i ].count,
+			mixers[ i ].ticks, mixers[ i ].deadline_misses, mixers[ i ].timer ? "yes" : "no" ) ;
+	}
+
 	// release mutex
 	tris_mutex_unlock( &conflist_lock ) ;
 
@@ -1956,7 +2110,7 @@ struct tris_conf_member *find_member (const char *chan, int lock)
 }
 
 // All the VAD-based video switching magic happens here
-// This function should be called inside conference_exec
+// This function should be called inside conference_tick
 // The conference mutex should be locked, we don't have to do it here
 void do_VAD_switching(struct tris_conference *conf)
 {
@@ -61,6 +61,12 @@ typedef struct tris_conference_stats
 	unsigned long frames_out ;
 	unsigned long frames_mixed ;
 
+	// frame intervals mixed, intervals mixed after their deadline
+	// and the worst lateness in milliseconds
+	unsigned long ticks ;
+	unsigned long deadline_misses ;
+	long max_late ;
+
 	struct timeval time_entered ;
 
 } tris_conference_stats ;
@@ -91,8 +97,11 @@ struct tris_conference
 	// Video source locked flag, 1 -> locked, 0 -> unlocked
 	short video_locked;
 
-	// conference thread id
-	pthread_t conference_thread ;
+	// mixer thread running this conference
+	struct conference_mixer* mixer ;
+
+	// next conference run by the same mixer
+	struct tris_conference* mixer_next ;
 
 	// conference data mutex
 	tris_mutex_t lock ;
@@ -109,6 +118,9 @@ struct tris_conference
 	// keep track of current delivery time
 	struct timeval delivery_time ;
 
+	// time of the last state change notification
+	struct timeval notify ;
+
 	// 1 => on, 0 => off
 	short debug_flag ;
 } ;
@@ -122,7 +134,7 @@ struct tris_conference
 
 struct tris_conference* start_conference( struct tris_conf_member* member ) ;
 
-void conference_exec( struct tris_conference* conf ) ;
+void stop_conference_mixers( void ) ;
 
 struct tris_conference* find_conf( const char* name ) ;
 struct tris_conference* create_conf( char* name, struct tris_conf_member* member ) ;
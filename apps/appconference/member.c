@@ -268,7 +268,7 @@ static int process_incoming(struct tris_conf_member *member, struct tris_confere
 				member->channel_name,
 				member->chan->cid.cid_num ? member->chan->cid.cid_num : "unknown",
 				member->chan->cid.cid_name ? member->chan->cid.cid_name : "unknown",
-				f->subclass
+				(int) f->subclass
 				) ;
 
 		}
@@ -589,7 +589,7 @@ static int process_outgoing(struct tris_conf_member *member)
 			{
 				// We have a sound frame now, but we need to make sure it's the same
 				// format as our channel write format
-				int wf = member->chan->writeformat & TRIS_FORMAT_AUDIO_MASK;
+				format_t wf = member->chan->writeformat & TRIS_FORMAT_AUDIO_MASK;
 				if ( f->frametype == TRIS_FRAME_VOICE && !(wf & f->subclass) )
 				{
 					// We need to change our channel's write format
@@ -1092,7 +1092,7 @@ int member_exec( struct tris_channel* chan, void* data )
 	struct timeval base, curr ;
 	base = tris_tvnow();
 
-	// tell conference_exec we're ready for frames
+	// tell conference_tick we're ready for frames
 	member->ready_for_outgoing = 1 ;
 	while ( 42 == 42 )
 	{
@@ -1716,7 +1716,7 @@ struct tris_conf_member* create_member( struct tris_channel *chan, const char* d
 	member->to_slinear = tris_translator_build_path( TRIS_FORMAT_SLINEAR, member->read_format ) ;
 	member->from_slinear = tris_translator_build_path( member->write_format, TRIS_FORMAT_SLINEAR ) ;
 
-	tris_log( TRIS_CONF_DEBUG, "TRIS_FORMAT_SLINEAR => %d\n", TRIS_FORMAT_SLINEAR ) ;
+	tris_log( TRIS_CONF_DEBUG, "TRIS_FORMAT_SLINEAR => %lld\n", (long long) TRIS_FORMAT_SLINEAR ) ;
 
 	// index for converted_frames array
 	switch ( member->write_format )
@@ -1830,8 +1830,8 @@ struct tris_conf_member* create_member( struct tris_channel *chan, const char* d
 	// finish up
 	//
 
-	tris_log( TRIS_CONF_DEBUG, "created member, type => %c, priority => %d, readformat => %d\n",
-		member->type, member->priority, chan->readformat ) ;
+	tris_log( TRIS_CONF_DEBUG, "created member, type => %c, priority => %d, readformat => %lld\n",
+		member->type, member->priority, (long long) chan->readformat ) ;
 
 	return member ;
 }
@@ -2318,7 +2318,7 @@ int queue_incoming_video_frame( struct tris_conf_member* member, const struct tr
 
 	//
 	// add new frame to speaking members incoming frame queue
-	// ( i.e. save this frame data, so we can distribute it in conference_exec later )
+	// ( i.e. save this frame data, so we can distribute it in conference_tick later )
 	//
 
 	if ( member->inVideoFrames == NULL )
@@ -2398,7 +2398,7 @@ int queue_incoming_desktop_frame( struct tris_conf_member* member, const struct
 
 	//
 	// add new frame to speaking members incoming frame queue
-	// ( i.e. save this frame data, so we can distribute it in conference_exec later )
+	// ( i.e. save this frame data, so we can distribute it in conference_tick later )
 	//
 
 	if ( member->inDesktopFrames == NULL )
@@ -2473,7 +2473,7 @@ int queue_incoming_dtmf_frame( struct tris_conf_member* member, const struct tri
 
 	//
 	// add new frame to speaking members incoming frame queue
-	// ( i.e. save this frame data, so we can distribute it in conference_exec later )
+	// ( i.e. save this frame data, so we can distribute it in conference_tick later )
 	//
 
 	if ( member->inDTMFFrames == NULL )
@@ -2615,7 +2615,7 @@ int queue_incoming_frame( struct tris_conf_member* member, struct tris_frame* fr
 
 		//
 		// add new frame to speaking members incoming frame queue
-		// ( i.e. save this frame data, so we can distribute it in conference_exec later )
+		// ( i.e. save this frame data, so we can distribute it in conference_tick later )
 		//
 
 		if ( member->inFrames == NULL ) {
@@ -2666,7 +2666,7 @@ tris_log (TRIS_CONF_DEBUG, "SMOOTH:Feeding frame into inSmoother, timestamp => %
 		while( ( sfr = tris_smoother_read( member->inSmoother ) ) ){
 
 			++i;
-tris_log( TRIS_CONF_DEBUG , "\treading new frame [%d] from smoother, inFramesCount[%d], \n\tsfr->frametype -> %d , sfr->subclass -> %d , sfr->datalen => %d sfr->samples => %d\n", i , member->inFramesCount , sfr->frametype, sfr->subclass, sfr->datalen, sfr->samples);
+tris_log( TRIS_CONF_DEBUG , "\treading new frame [%d] from smoother, inFramesCount[%d], \n\tsfr->frametype -> %d , sfr->subclass -> %d , sfr->datalen => %d sfr->samples => %d\n", i , member->inFramesCount , sfr->frametype, (int) sfr->subclass, sfr->datalen, sfr->samples);
 tris_log (TRIS_CONF_DEBUG, "SMOOTH:Reading frame from inSmoother, i=>%d, timestamp => %ld.%ld\n",i, sfr->delivery.tv_sec, sfr->delivery.tv_usec);
 			conf_frame* cfr = create_conf_frame( member, member->inFrames, sfr ) ;
 			if ( cfr == NULL )
@@ -2678,7 +2678,7 @@ tris_log (TRIS_CONF_DEBUG, "SMOOTH:Reading frame from inSmoother, i=>%d, timesta
 
 			//
 			// add new frame to speaking members incoming frame queue
-			// ( i.e. save this frame data, so we can distribute it in conference_exec later )
+			// ( i.e. save this frame data, so we can distribute it in conference_tick later )
 			//
 
 			if ( member->inFrames == NULL ) {
@@ -2786,7 +2786,7 @@ int __queue_outgoing_frame( struct tris_conf_member* member, const struct tris_f
 
 	//
 	// add new frame to speaking members incoming frame queue
-	// ( i.e. save this frame data, so we can distribute it in conference_exec later )
+	// ( i.e. save this frame data, so we can distribute it in conference_tick later )
 	//
 
 	if ( member->outFrames == NULL ) {
@@ -3484,7 +3484,7 @@ int tris_packer_feed(struct tris_packer *s, const struct tris_frame *f)
 		s->format = f->subclass;
 		s->samples=0;
 	} else if (s->format != f->subclass) {
-		tris_log(LOG_WARNING, "Packer was working on %d format frames, now trying to feed %d?\n", s->format, f->subclass);
+		tris_log(LOG_WARNING, "Packer was working on %d format frames, now trying to feed %lld?\n", s->format, (long long) f->subclass);
 		return -1;
 	}
 	if (s->len + f->datalen > PACKER_SIZE) {
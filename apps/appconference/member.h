@@ -140,7 +140,7 @@ struct tris_conf_member
 	int smooth_size_out;
 	int smooth_multiple;
 
-	// frames needed by conference_exec
+	// frames needed by conference_tick
 	unsigned int inFramesNeeded ;
 	unsigned int inVideoFramesNeeded ;
 
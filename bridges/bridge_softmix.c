@@ -24,9 +24,9 @@
  *
  * \ingroup bridges
  *
- * \todo This bridge operates in 8 kHz mode unless a define is uncommented.
- * This needs to be improved so the bridge moves between the dominant codec as needed depending
- * on channels present in the bridge and transcoding capabilities.
+ * The bridge mixes at the highest signed linear rate among its channels.
+ * Each channel reads and writes signed linear at its own rate, and is only
+ * resampled when that differs from the mixing rate.
  */
 
 #include "trismedia.h"
@@ -51,18 +51,59 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 247776 $")
 #include "trismedia/slinfactory.h"
 #include "trismedia/astobj2.h"
 #include "trismedia/timing.h"
+#include "trismedia/mix.h"
+#include "trismedia/translate.h"
+#include "trismedia/cli.h"
 
 /*! \brief Interval at which mixing will take place. Valid options are 10, 20, and 40. */
 #define SOFTMIX_INTERVAL 20
 
-/*! \brief Size of the buffer used for sample manipulation */
-#define SOFTMIX_DATALEN (160 * (SOFTMIX_INTERVAL / 10))
+/*! \brief Number of samples in a mixing interval at the given rate */
+#define SOFTMIX_SAMPLES(rate) ((rate) / 1000 * SOFTMIX_INTERVAL)
+
+/*! \brief Number of samples in a mixing interval at the highest rate we mix at */
+#define SOFTMIX_MAX_SAMPLES SOFTMIX_SAMPLES(16000)
+
+/*! \brief Number of different write formats listeners can share an encoder for */
+#define SOFTMIX_ENCODERS 8
+
+/*! \brief Encoder shared by all listeners writing the same format */
+struct softmix_encoder {
+	/*! Format the listeners write */
+	format_t format;
+	/*! Translation path from the mixing format, NULL when no translation is needed */
+	struct tris_trans_pvt *trans;
+	/*! Mixing interval the encoded frame belongs to */
+	unsigned int tick;
+	/*! The common mix in this format for the interval, may be NULL if the encoder held on to it */
+	struct tris_frame *frame;
+};
 
-/*! \brief Number of samples we are dealing with */
-#define SOFTMIX_SAMPLES (SOFTMIX_DATALEN / 2)
+/*! \brief Structure which contains per-bridge mixing information */
+struct softmix_bridge_data {
+	/*! Timing source that drives the mixing thread */
+	struct tris_timer *timer;
+	/*! Signed linear format mixing takes place in */
+	format_t format;
+	/*! Encoders for the common mix, one for each write format in use */
+	struct softmix_encoder encoders[SOFTMIX_ENCODERS];
+	/*! Number of mixing intervals */
+	unsigned int ticks;
+	/*! Number of mixes made for channels that provided audio */
+	unsigned int talker_mixes;
+	/*! Number of times the common mix was sent to a channel that did not provide audio */
+	unsigned int listener_mixes;
+	/*! Number of times the common mix was encoded */
+	unsigned int encodes;
+	/*! Number of encodes saved by sending the common mix to several listeners in the same format */
+	unsigned int encodes_saved;
+	/*! Number of times the mixing rate changed */
+	unsigned int rate_changes;
+	TRIS_LIST_ENTRY(softmix_bridge_data) list;
+};
 
-/*! \brief Define used to turn on 16 kHz audio support */
-/* #define SOFTMIX_16_SUPPORT */
+/*! \brief Bridges using softmix, for the statistics CLI command */
+static TRIS_LIST_HEAD_STATIC(softmix_bridges, softmix_bridge_data);
 
 /*! \brief Structure which contains per-channel mixing information */
 struct softmix_channel {
@@ -72,41 +113,102 @@ struct softmix_channel {
 	struct tris_slinfactory factory;
 	/*! Frame that contains mixed audio to be written out to the channel */
 	struct tris_frame frame;
+	/*! The mix, already translated for the channel, to write instead of frame */
+	struct tris_frame *encoded;
+	/*! Signed linear format the channel reads and writes */
+	format_t format;
+	/*! Signed linear format the factory produces and frame is in, the mixing format */
+	format_t mix_format;
+	/*! Resampler from the mixing format to the format of the channel */
+	struct tris_trans_pvt *trans;
 	/*! Bit used to indicate that the channel provided audio for this mixing interval */
 	int have_audio:1;
 	/*! Bit used to indicate that a frame is available to be written out to the channel */
 	int have_frame:1;
 	/*! Buffer containing final mixed audio from all sources */
-	short final_buf[SOFTMIX_DATALEN];
+	short final_buf[SOFTMIX_MAX_SAMPLES];
 	/*! Buffer containing only the audio from the channel */
-	short our_buf[SOFTMIX_DATALEN];
+	short our_buf[SOFTMIX_MAX_SAMPLES];
 };
 
 /*! \brief Function called when a bridge is created */
 static int softmix_bridge_create(struct tris_bridge *bridge)
 {
-	struct tris_timer *timer;
+	struct softmix_bridge_data *softmix_data;
 
-	if (!(timer = tris_timer_open())) {
+	if (!(softmix_data = tris_calloc(1, sizeof(*softmix_data)))) {
 		return -1;
 	}
 
-	bridge->bridge_pvt = timer;
+	if (!(softmix_data->timer = tris_timer_open())) {
+		tris_free(softmix_data);
+		return -1;
+	}
+	softmix_data->format = TRIS_FORMAT_SLINEAR;
+
+	TRIS_LIST_LOCK(&softmix_bridges);
+	TRIS_LIST_INSERT_TAIL(&softmix_bridges, softmix_data, list);
+	TRIS_LIST_UNLOCK(&softmix_bridges);
+
+	bridge->bridge_pvt = softmix_data;
 
 	return 0;
 }
 
+/*! \brief Drop the encoders of the common mix, for example because the mixing format changed */
+static void softmix_encoders_reset(struct softmix_bridge_data *softmix_data)
+{
+	int i;
+
+	for (i = 0; i < SOFTMIX_ENCODERS; i++) {
+		if (softmix_data->encoders[i].trans) {
+			tris_translator_free_path(softmix_data->encoders[i].trans);
+		}
+	}
+	memset(softmix_data->encoders, 0, sizeof(softmix_data->encoders));
+}
+
 /*! \brief Function called when a bridge is destroyed */
 static int softmix_bridge_destroy(struct tris_bridge *bridge)
 {
-	if (!bridge->bridge_pvt) {
+	struct softmix_bridge_data *softmix_data = bridge->bridge_pvt;
+
+	if (!softmix_data) {
 		return -1;
 	}
-	tris_timer_close((struct tris_timer *) bridge->bridge_pvt);
+
+	TRIS_LIST_LOCK(&softmix_bridges);
+	TRIS_LIST_REMOVE(&softmix_bridges, softmix_data, list);
+	TRIS_LIST_UNLOCK(&softmix_bridges);
+
+	softmix_encoders_reset(softmix_data);
+	tris_timer_close(softmix_data->timer);
+	tris_free(softmix_data);
 
 	return 0;
 }
 
+/*! \brief Set the format the channel is mixed in.  Call with the softmix channel locked, or before it is used. */
+static void softmix_channel_set_mix_format(struct softmix_channel *sc, format_t format)
+{
+	int rate = tris_format_rate(format);
+
+	if (sc->mix_format) {
+		tris_slinfactory_destroy(&sc->factory);
+	}
+	tris_slinfactory_init_rate(&sc->factory, rate);
+
+	if (sc->trans) {
+		tris_translator_free_path(sc->trans);
+		sc->trans = NULL;
+	}
+
+	sc->mix_format = format;
+	sc->frame.subclass = format;
+	sc->frame.samples = SOFTMIX_SAMPLES(rate);
+	sc->frame.datalen = sc->frame.samples * sizeof(short);
+}
+
 /*! \brief Function called when a channel is joined into the bridge */
 static int softmix_bridge_join(struct tris_bridge *bridge, struct tris_bridge_channel *bridge_channel)
 {
@@ -120,19 +222,23 @@ static int softmix_bridge_join(struct tris_bridge *bridge, struct tris_bridge_ch
 	/* Can't forget the lock */
 	tris_mutex_init(&sc->lock);
 
-	/* Setup smoother */
-	tris_slinfactory_init(&sc->factory);
+	/* Talk to the channel in signed linear at the rate of its codec, so nothing is lost or resampled for nothing */
+	if (tris_format_rate(bridge_channel->chan->rawreadformat) > 8000 || tris_format_rate(bridge_channel->chan->rawwriteformat) > 8000) {
+		sc->format = TRIS_FORMAT_SLINEAR16;
+	} else {
+		sc->format = TRIS_FORMAT_SLINEAR;
+	}
+	if (bridge_channel->chan->readformat != sc->format && tris_set_read_format(bridge_channel->chan, sc->format)) {
+		tris_log(LOG_WARNING, "Failed to set channel %s to read format %s\n", bridge_channel->chan->name, tris_getformatname(sc->format));
+	}
+	if (bridge_channel->chan->writeformat != sc->format && tris_set_write_format(bridge_channel->chan, sc->format)) {
+		tris_log(LOG_WARNING, "Failed to set channel %s to write format %s\n", bridge_channel->chan->name, tris_getformatname(sc->format));
+	}
 
-	/* Setup frame parameters */
+	/* Setup smoother and frame parameters, the mixing thread adjusts them to the mixing format */
 	sc->frame.frametype = TRIS_FRAME_VOICE;
-#ifdef SOFTMIX_16_SUPPORT
-	sc->frame.subclass = TRIS_FORMAT_SLINEAR16;
-#else
-	sc->frame.subclass = TRIS_FORMAT_SLINEAR;
-#endif
 	sc->frame.data.ptr = sc->final_buf;
-	sc->frame.datalen = SOFTMIX_DATALEN;
-	sc->frame.samples = SOFTMIX_SAMPLES;
+	softmix_channel_set_mix_format(sc, TRIS_FORMAT_SLINEAR);
 
 	/* Can't forget to record our pvt structure within the bridged channel structure */
 	bridge_channel->bridge_pvt = sc;
@@ -151,12 +257,44 @@ static int softmix_bridge_leave(struct tris_bridge *bridge, struct tris_bridge_c
 	/* Drop the factory */
 	tris_slinfactory_destroy(&sc->factory);
 
+	/* Drop a mix that was never written out */
+	if (sc->encoded) {
+		tris_frfree(sc->encoded);
+	}
+
+	if (sc->trans) {
+		tris_translator_free_path(sc->trans);
+	}
+
 	/* Eep! drop ourselves */
 	tris_free(sc);
 
 	return 0;
 }
 
+/*! \brief Write out the mix for a channel if one is ready.  Call with the softmix channel locked. */
+static void softmix_channel_write(struct tris_bridge_channel *bridge_channel, struct softmix_channel *sc)
+{
+	if (!sc->have_frame) {
+		return;
+	}
+
+	if (sc->encoded) {
+		struct tris_frame *cur;
+
+		/* The translator may have returned several frames, tris_write() only sends
+		   the ones its own translator made, so write each of them */
+		for (cur = sc->encoded; cur; cur = TRIS_LIST_NEXT(cur, frame_list)) {
+			tris_write(bridge_channel->chan, cur);
+		}
+		tris_frfree(sc->encoded);
+		sc->encoded = NULL;
+	} else {
+		tris_write(bridge_channel->chan, &sc->frame);
+	}
+	sc->have_frame = 0;
+}
+
 /*! \brief Function called when a channel writes a frame into the bridge */
 static enum tris_bridge_write_result softmix_bridge_write(struct tris_bridge *bridge, struct tris_bridge_channel *bridge_channel, struct tris_frame *frame)
 {
@@ -169,20 +307,13 @@ static enum tris_bridge_write_result softmix_bridge_write(struct tris_bridge *br
 
 	tris_mutex_lock(&sc->lock);
 
-	/* If a frame was provided add it to the smoother */
-#ifdef SOFTMIX_16_SUPPORT
-	if (frame->frametype == TRIS_FRAME_VOICE && frame->subclass == TRIS_FORMAT_SLINEAR16) {
-#else
-	if (frame->frametype == TRIS_FRAME_VOICE && frame->subclass == TRIS_FORMAT_SLINEAR) {
-#endif
+	/* If a frame was provided add it to the smoother, which resamples it if the mixing rate differs */
+	if (frame->frametype == TRIS_FRAME_VOICE && (frame->subclass == TRIS_FORMAT_SLINEAR || frame->subclass == TRIS_FORMAT_SLINEAR16)) {
 		tris_slinfactory_feed(&sc->factory, frame);
 	}
 
 	/* If a frame is ready to be written out, do so */
-	if (sc->have_frame) {
-		tris_write(bridge_channel->chan, &sc->frame);
-		sc->have_frame = 0;
-	}
+	softmix_channel_write(bridge_channel, sc);
 
 	/* Alllll done */
 	tris_mutex_unlock(&sc->lock);
@@ -197,28 +328,148 @@ static int softmix_bridge_poke(struct tris_bridge *bridge, struct tris_bridge_ch
 
 	tris_mutex_lock(&sc->lock);
 
-	if (sc->have_frame) {
-		tris_write(bridge_channel->chan, &sc->frame);
-		sc->have_frame = 0;
-	}
+	softmix_channel_write(bridge_channel, sc);
 
 	tris_mutex_unlock(&sc->lock);
 
 	return 0;
 }
 
+/*! \brief Duplicate a frame and any frames following it in its list */
+static struct tris_frame *softmix_frdup_list(struct tris_frame *frame)
+{
+	struct tris_frame *head = NULL, *prev = NULL, *dup;
+
+	for (; frame; frame = TRIS_LIST_NEXT(frame, frame_list)) {
+		if (!(dup = tris_frdup(frame))) {
+			break;
+		}
+		if (prev) {
+			TRIS_LIST_NEXT(prev, frame_list) = dup;
+		} else {
+			head = dup;
+		}
+		prev = dup;
+	}
+
+	return head;
+}
+
+/*!
+ * \brief Get the common mix of this interval in the given format
+ *
+ * The mix is only encoded for the first listener writing the format, the
+ * others get the same frame.
+ *
+ * \retval 0 frame points to the mix, or is NULL if the encoder kept the audio for later
+ * \retval -1 the mix could not be encoded, the channel should translate it itself
+ */
+static int softmix_encode(struct softmix_bridge_data *softmix_data, format_t format, struct tris_frame *mix, struct tris_frame **frame)
+{
+	struct softmix_encoder *encoder = NULL;
+	int i;
+
+	if (!format) {
+		return -1;
+	}
+
+	for (i = 0; i < SOFTMIX_ENCODERS; i++) {
+		if (softmix_data->encoders[i].format == format) {
+			encoder = &softmix_data->encoders[i];
+			break;
+		} else if (!softmix_data->encoders[i].format) {
+			/* First time this format is seen */
+			encoder = &softmix_data->encoders[i];
+			if (format != mix->subclass && !(encoder->trans = tris_translator_build_path(format, mix->subclass))) {
+				return -1;
+			}
+			encoder->format = format;
+			encoder->tick = softmix_data->ticks - 1;
+			break;
+		}
+	}
+
+	if (!encoder) {
+		return -1;
+	}
+
+	if (encoder->tick != softmix_data->ticks) {
+		encoder->tick = softmix_data->ticks;
+		encoder->frame = encoder->trans ? tris_translate(encoder->trans, mix, 0) : mix;
+		if (encoder->trans) {
+			softmix_data->encodes++;
+		}
+	} else if (encoder->trans) {
+		softmix_data->encodes_saved++;
+	}
+
+	*frame = encoder->frame;
+
+	return 0;
+}
+
+/*!
+ * \brief Resample the mix of a channel to the rate the channel writes at
+ * \retval 0 the resampled mix is ready to be written
+ * \retval -1 there is nothing to write this interval
+ */
+static int softmix_channel_resample(struct softmix_channel *sc)
+{
+	struct tris_frame *f;
+
+	if (!sc->trans && !(sc->trans = tris_translator_build_path(sc->format, sc->mix_format))) {
+		tris_debug(1, "Unable to resample from %s to %s\n", tris_getformatname(sc->mix_format), tris_getformatname(sc->format));
+		return -1;
+	}
+
+	if (!(f = tris_translate(sc->trans, &sc->frame, 0))) {
+		return -1;
+	}
+	sc->encoded = softmix_frdup_list(f);
+
+	return 0;
+}
+
 /*! \brief Function which acts as the mixing thread */
 static int softmix_bridge_thread(struct tris_bridge *bridge)
 {
-	struct tris_timer *timer = (struct tris_timer *) bridge->bridge_pvt;
+	struct softmix_bridge_data *softmix_data = bridge->bridge_pvt;
+	struct tris_timer *timer = softmix_data->timer;
 	int timingfd = tris_timer_fd(timer);
 
 	tris_timer_set_rate(timer, (1000 / SOFTMIX_INTERVAL));
 
 	while (!bridge->stop && !bridge->refresh && bridge->array_num) {
 		struct tris_bridge_channel *bridge_channel = NULL;
-		short buf[SOFTMIX_DATALEN] = {0, };
-		int timeout = -1;
+		int buf[SOFTMIX_MAX_SAMPLES] = {0, };
+		short listen_buf[SOFTMIX_MAX_SAMPLES];
+		struct tris_frame listen_frame = {
+			.frametype = TRIS_FRAME_VOICE,
+			.data.ptr = listen_buf,
+			.src = "softmix",
+		};
+		format_t format = TRIS_FORMAT_SLINEAR;
+		int timeout = -1, samples;
+
+		/* Mix at the highest rate any channel talks at */
+		TRIS_LIST_TRAVERSE(&bridge->channels, bridge_channel, entry) {
+			struct softmix_channel *sc = bridge_channel->bridge_pvt;
+
+			if (sc->format == TRIS_FORMAT_SLINEAR16) {
+				format = TRIS_FORMAT_SLINEAR16;
+				break;
+			}
+		}
+		if (format != softmix_data->format) {
+			tris_debug(1, "Bridge %p now mixing at %d Hz\n", bridge, tris_format_rate(format));
+			softmix_data->format = format;
+			softmix_data->rate_changes++;
+			softmix_encoders_reset(softmix_data);
+		}
+		samples = SOFTMIX_SAMPLES(tris_format_rate(format));
+		listen_frame.subclass = format;
+		listen_frame.samples = samples;
+		listen_frame.datalen = samples * sizeof(short);
 
 		/* Go through pulling audio from each factory that has it available */
 		TRIS_LIST_TRAVERSE(&bridge->channels, bridge_channel, entry) {
@@ -226,14 +477,14 @@ static int softmix_bridge_thread(struct tris_bridge *bridge)
 
 			tris_mutex_lock(&sc->lock);
 
-			/* Try to get audio from the factory if available */
-			if (tris_slinfactory_available(&sc->factory) >= SOFTMIX_SAMPLES && tris_slinfactory_read(&sc->factory, sc->our_buf, SOFTMIX_SAMPLES)) {
-				short *data1, *data2;
-				int i;
+			if (sc->mix_format != format) {
+				softmix_channel_set_mix_format(sc, format);
+			}
 
+			/* Try to get audio from the factory if available */
+			if (tris_slinfactory_available(&sc->factory) >= samples && tris_slinfactory_read(&sc->factory, sc->our_buf, samples)) {
 				/* Put into the local final buffer */
-				for (i = 0, data1 = buf, data2 = sc->our_buf; i < SOFTMIX_DATALEN; i++, data1++, data2++)
-					tris_slinear_saturated_add(data1, data2);
+				tris_mix_accumulate(buf, sc->our_buf, samples);
 				/* Yay we have our own audio */
 				sc->have_audio = 1;
 			} else {
@@ -243,24 +494,57 @@ static int softmix_bridge_thread(struct tris_bridge *bridge)
 			tris_mutex_unlock(&sc->lock);
 		}
 
+		/* Everybody who did not provide audio hears the same thing */
+		tris_mix_minus(listen_buf, buf, NULL, samples);
+		softmix_data->ticks++;
+
 		/* Next step go through removing the channel's own audio and creating a good frame... */
 		TRIS_LIST_TRAVERSE(&bridge->channels, bridge_channel, entry) {
 			struct softmix_channel *sc = bridge_channel->bridge_pvt;
-			int i = 0;
+			struct tris_frame *encoded;
+
+			tris_mutex_lock(&sc->lock);
 
-			/* Copy from local final buffer to our final buffer */
-			memcpy(sc->final_buf, buf, sizeof(sc->final_buf));
+			/* Drop a common mix from the last interval that was never written out */
+			if (sc->encoded) {
+				tris_frfree(sc->encoded);
+				sc->encoded = NULL;
+			}
 
-			/* If we provided audio then take it out */
 			if (sc->have_audio) {
-				for (i = 0; i < SOFTMIX_DATALEN; i++) {
-					tris_slinear_saturated_subtract(&sc->final_buf[i], &sc->our_buf[i]);
+				/* Everything in the local final buffer, less our own audio */
+				tris_mix_minus(sc->final_buf, buf, sc->our_buf, samples);
+				softmix_data->talker_mixes++;
+				if (sc->format != format && softmix_channel_resample(sc)) {
+					/* The resampler is waiting for more audio */
+					tris_mutex_unlock(&sc->lock);
+					continue;
+				}
+			} else if (!softmix_encode(softmix_data, bridge_channel->chan->rawwriteformat, &listen_frame, &encoded)) {
+				/* The common mix, encoded once for everybody writing this format */
+				softmix_data->listener_mixes++;
+				if (!encoded) {
+					/* The encoder is waiting for more audio, so are we */
+					tris_mutex_unlock(&sc->lock);
+					continue;
+				}
+				if (!(sc->encoded = softmix_frdup_list(encoded))) {
+					memcpy(sc->final_buf, listen_buf, samples * sizeof(short));
+				}
+			} else {
+				memcpy(sc->final_buf, listen_buf, samples * sizeof(short));
+				softmix_data->listener_mixes++;
+				if (sc->format != format && softmix_channel_resample(sc)) {
+					tris_mutex_unlock(&sc->lock);
+					continue;
 				}
 			}
 
 			/* The frame is now ready for use... */
 			sc->have_frame = 1;
 
+			tris_mutex_unlock(&sc->lock);
+
 			/* Poke bridged channel thread just in case */
 			pthread_kill(bridge_channel->thread, SIGURG);
 		}
@@ -282,11 +566,7 @@ static struct tris_bridge_technology softmix_bridge = {
 	.name = "softmix",
 	.capabilities = TRIS_BRIDGE_CAPABILITY_MULTIMIX | TRIS_BRIDGE_CAPABILITY_THREAD | TRIS_BRIDGE_CAPABILITY_MULTITHREADED,
 	.preference = TRIS_BRIDGE_PREFERENCE_LOW,
-#ifdef SOFTMIX_16_SUPPORT
-	.formats = TRIS_FORMAT_SLINEAR16,
-#else
-	.formats = TRIS_FORMAT_SLINEAR,
-#endif
+	.formats = TRIS_FORMAT_SLINEAR | TRIS_FORMAT_SLINEAR16,
 	.create = softmix_bridge_create,
 	.destroy = softmix_bridge_destroy,
 	.join = softmix_bridge_join,
@@ -296,13 +576,58 @@ static struct tris_bridge_technology softmix_bridge = {
 	.poke = softmix_bridge_poke,
 };
 
+static char *handle_cli_softmix_show_stats(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+	struct softmix_bridge_data *softmix_data;
+	int i = 0;
+
+	switch (cmd) {
+	case CLI_INIT:
+		e->command = "softmix show stats";
+		e->usage =
+			"Usage: softmix show stats\n"
+			"       Shows the mixing statistics of every softmix bridge, including\n"
+			"       the encodes saved by sending one encoded mix to all channels\n"
+			"       that did not talk and write the same format.\n";
+		return NULL;
+	case CLI_GENERATE:
+		return NULL;
+	}
+
+	if (a->argc != e->args) {
+		return CLI_SHOWUSAGE;
+	}
+
+#define FORMAT "%-6s %6s %8s %10s %12s %14s %10s %12s\n"
+#define FORMAT2 "%-6d %6d %8u %10u %12u %14u %10u %12u\n"
+	tris_cli(a->fd, FORMAT, "Bridge", "Rate", "Changes", "Intervals", "Talker mixes", "Listener mixes", "Encodes", "Encodes saved");
+	TRIS_LIST_LOCK(&softmix_bridges);
+	TRIS_LIST_TRAVERSE(&softmix_bridges, softmix_data, list) {
+		tris_cli(a->fd, FORMAT2, ++i, tris_format_rate(softmix_data->format), softmix_data->rate_changes,
+			softmix_data->ticks, softmix_data->talker_mixes, softmix_data->listener_mixes,
+			softmix_data->encodes, softmix_data->encodes_saved);
+	}
+	TRIS_LIST_UNLOCK(&softmix_bridges);
+	tris_cli(a->fd, "%d softmix bridges\n", i);
+#undef FORMAT
+#undef FORMAT2
+
+	return CLI_SUCCESS;
+}
+
+static struct tris_cli_entry cli_softmix[] = {
+	TRIS_CLI_DEFINE(handle_cli_softmix_show_stats, "Show softmix bridge mixing statistics"),
+};
+
 static int unload_module(void)
 {
+	tris_cli_unregister_multiple(cli_softmix, ARRAY_LEN(cli_softmix));
 	return tris_bridge_technology_unregister(&softmix_bridge);
 }
 
 static int load_module(void)
 {
+	tris_cli_register_multiple(cli_softmix, ARRAY_LEN(cli_softmix));
 	return tris_bridge_technology_register(&softmix_bridge);
 }
 
@@ -30,6 +30,7 @@
 
 #include "trismedia/autoconfig.h"
 #include "frame.h"
+#include "trismedia/mix.h"
 
 conf_frame* mix_frames( conf_frame* frames_in, int speaker_count, int listener_count )
 {
@@ -253,6 +254,23 @@ conf_frame* mix_multiple_speakers(
 	// mix the audio
 	//
 
+	// sum every spoken frame once, every send frame gets the same sum
+	int mix_sum[ TRIS_CONF_BLOCK_SAMPLES ] ;
+
+	memset( mix_sum, 0x0, sizeof( mix_sum ) ) ;
+
+	for ( cf_spoken = frames_in ; cf_spoken != NULL ; cf_spoken = cf_spoken->next )
+	{
+		if ( cf_spoken->fr == NULL )
+		{
+			tris_log( LOG_WARNING, "unable to mix conf_frame with null tris_frame\n" ) ;
+		}
+		else
+		{
+			tris_mix_accumulate( mix_sum, cf_spoken->fr->data.ptr, TRIS_CONF_BLOCK_SAMPLES ) ;//XXX NAS cf_spoken->fr->samples ) ;
+		}
+	}
+
 	// convenience pointer that skips over the friendly offset
 	char* cp_listenerData ;
 
@@ -269,33 +287,8 @@ conf_frame* mix_multiple_speakers(
 		// point past the friendly offset right to the data
 		cp_listenerData = cp_listenerBuffer + TRIS_FRIENDLY_OFFSET ;
 
-		// reset the spoken list pointer
-		cf_spoken = frames_in ;
-
-		// really mix the audio
-		for ( ; cf_spoken != NULL ; cf_spoken = cf_spoken->next )
-		{
-			//
-			// if the members are equal, and they
-			// are not null, do not mix them.
-			//
-			/*if (
-				( cf_send->member == cf_spoken->member )
-				&& ( cf_send->member != NULL )
-			)
-			{
-				// don't mix this frame
-			}
-			else */if ( cf_spoken->fr == NULL )
-			{
-				tris_log( LOG_WARNING, "unable to mix conf_frame with null tris_frame\n" ) ;
-			}
-			else
-			{
-				// mix the new frame in with the existing buffer
-				mix_slinear_frames( cp_listenerData, (char*)( cf_spoken->fr->data.ptr ), TRIS_CONF_BLOCK_SAMPLES);//XXX NAS cf_spoken->fr->samples ) ;
-			}
-		}
+		// everybody hears everybody, including themselves
+		tris_mix_minus( (short*)cp_listenerData, mix_sum, NULL, TRIS_CONF_BLOCK_SAMPLES ) ;
 
 		// copy a pointer to the frame data to the conf_frame
 		cf_send->mixed_buffer = cp_listenerData ;
@@ -601,30 +594,7 @@ void mix_slinear_frames( char *dst, const char *src, int samples )
 	if ( dst == NULL ) return ;
 	if ( src == NULL ) return ;
 
-	int i, val ;
-
-	for ( i = 0 ; i < samples ; ++i )
-	{
-		val = ( (short*)dst )[i] + ( (short*)src )[i] ;
-
-		if ( val > 0x7fff )
-		{
-			( (short*)dst )[i] = 0x7fff - 1 ;
-			continue ;
-		}
-		else if ( val < -0x7fff )
-		{
-			( (short*)dst )[i] = -0x7fff + 1 ;
-			continue ;
-		}
-		else
-		{
-			( (short*)dst )[i] = val ;
-	   		continue ;
-		}
-	}
-
-	return ;
+	tris_mix_add( (short*)dst, (const short*)src, samples ) ;
 }
 
 //
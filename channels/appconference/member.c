@@ -207,7 +207,7 @@ static int process_outgoing(struct tris_channel *chan, struct tris_conf_member*
 			{
 				// We have a sound frame now, but we need to make sure it's the same
 				// format as our channel write format
-				int wf = member->chan->writeformat & TRIS_FORMAT_AUDIO_MASK;
+				format_t wf = member->chan->writeformat & TRIS_FORMAT_AUDIO_MASK;
 				if ( f->frametype == TRIS_FRAME_VOICE && !(wf & f->subclass) )
 				{
 					// We need to change our channel's write format
@@ -905,7 +905,7 @@ struct tris_conf_member* create_member( struct tris_channel *chan, const char* d
 	member->to_slinear_S = tris_translator_build_path( TRIS_FORMAT_SLINEAR, member->read_format ) ;
 	member->from_slinear = tris_translator_build_path( member->write_format, TRIS_FORMAT_SLINEAR ) ;
 
-	tris_log( TRIS_CONF_DEBUG, "TRIS_FORMAT_SLINEAR => %d\n", TRIS_FORMAT_SLINEAR ) ;
+	tris_log( TRIS_CONF_DEBUG, "TRIS_FORMAT_SLINEAR => %lld\n", (long long) TRIS_FORMAT_SLINEAR ) ;
 
 	// index for converted_frames array
 	switch ( member->write_format )
@@ -1019,8 +1019,8 @@ struct tris_conf_member* create_member( struct tris_channel *chan, const char* d
 	// finish up
 	//
 
-	tris_log( TRIS_CONF_DEBUG, "created member, type => %c, priority => %d, readformat => %d\n",
-		member->type, member->priority, chan->readformat ) ;
+	tris_log( TRIS_CONF_DEBUG, "created member, type => %c, priority => %d, readformat => %lld\n",
+		member->type, member->priority, (long long) chan->readformat ) ;
 
 	return member ;
 }
@@ -2096,7 +2096,7 @@ int tris_packer_feed(struct tris_packer *s, const struct tris_frame *f)
 		s->format = f->subclass;
 		s->samples=0;
 	} else if (s->format != f->subclass) {
-		tris_log(LOG_WARNING, "Packer was working on %d format frames, now trying to feed %d?\n", s->format, f->subclass);
+		tris_log(LOG_WARNING, "Packer was working on %d format frames, now trying to feed %lld?\n", s->format, (long long) f->subclass);
 		return -1;
 	}
 	if (s->len + f->datalen > PACKER_SIZE) {
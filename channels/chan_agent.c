@@ -270,10 +270,10 @@ static TRIS_LIST_HEAD_STATIC(agents, agent_pvt);	/*!< Holds the list of agents (
 #define CHECK_FORMATS(ast, p) do { \
 	if (p->chan) {\
 		if (ast->nativeformats != p->chan->nativeformats) { \
-			tris_debug(1, "Native formats changing from %d to %d\n", ast->nativeformats, p->chan->nativeformats); \
+			tris_debug(1, "Native formats changing from %lld to %lld\n", (long long) ast->nativeformats, (long long) p->chan->nativeformats); \
 			/* Native formats changed, reset things */ \
 			ast->nativeformats = p->chan->nativeformats; \
-			tris_debug(1, "Resetting read to %d and write to %d\n", ast->readformat, ast->writeformat);\
+			tris_debug(1, "Resetting read to %lld and write to %lld\n", (long long) ast->readformat, (long long) ast->writeformat);\
 			tris_set_read_format(ast, ast->readformat); \
 			tris_set_write_format(ast, ast->writeformat); \
 		} \
@@ -300,7 +300,7 @@ static TRIS_LIST_HEAD_STATIC(agents, agent_pvt);	/*!< Holds the list of agents (
 } while(0)
 
 /*--- Forward declarations */
-static struct tris_channel *agent_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *agent_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int agent_devicestate(void *data);
 static void agent_logoff_maintenance(struct agent_pvt *p, char *loginchan, long logintime, const char *uniqueid, char *logcommand);
 static int agent_digit_begin(struct tris_channel *ast, char digit);
@@ -1449,7 +1449,7 @@ static int check_beep(struct agent_pvt *newlyavailable, int needlock)
 }
 
 /*! \brief Part of the Trismedia interface */
-static struct tris_channel *agent_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *agent_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	struct agent_pvt *p;
 	struct tris_channel *chan = NULL;
@@ -2153,12 +2153,12 @@ static int login_exec(struct tris_channel *chan, void *data)
 					if (!res) {
 						res = tris_set_read_format(chan, tris_best_codec(chan->nativeformats));
 						if (res)
-							tris_log(LOG_WARNING, "Unable to set read format to %d\n", tris_best_codec(chan->nativeformats));
+							tris_log(LOG_WARNING, "Unable to set read format to %lld\n", (long long) tris_best_codec(chan->nativeformats));
 					}
 					if (!res) {
 						res = tris_set_write_format(chan, tris_best_codec(chan->nativeformats));
 						if (res)
-							tris_log(LOG_WARNING, "Unable to set write format to %d\n", tris_best_codec(chan->nativeformats));
+							tris_log(LOG_WARNING, "Unable to set write format to %lld\n", (long long) tris_best_codec(chan->nativeformats));
 					}
 					/* Check once more just in case */
 					if (p->chan)
@@ -131,7 +131,7 @@ static int writedev = -1;
 
 static int autoanswer = 1;
 
-static struct tris_channel *alsa_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *alsa_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int alsa_digit(struct tris_channel *c, char digit, unsigned int duration);
 static int alsa_text(struct tris_channel *c, const char *text);
 static int alsa_hangup(struct tris_channel *c);
@@ -566,9 +566,9 @@ static struct tris_channel *alsa_new(struct chan_alsa_pvt *p, int state)
 	return tmp;
 }
 
-static struct tris_channel *alsa_request(const char *type, int fmt, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *alsa_request(const char *type, format_t fmt, void *data, int *cause, struct tris_channel* src)
 {
-	int oldformat = fmt;
+	format_t oldformat = fmt;
 	struct tris_channel *tmp = NULL;
 
 	if (!(fmt &= TRIS_FORMAT_SLINEAR)) {
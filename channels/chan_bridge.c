@@ -47,7 +47,7 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 180369 $")
 #include "trismedia/app.h"
 #include "trismedia/bridging.h"
 
-static struct tris_channel *bridge_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *bridge_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int bridge_call(struct tris_channel *ast, char *dest, int timeout);
 static int bridge_hangup(struct tris_channel *ast);
 static struct tris_frame *bridge_read(struct tris_channel *ast);
@@ -190,7 +190,7 @@ static int bridge_hangup(struct tris_channel *ast)
 }
 
 /*! \brief Called when we want to place a call somewhere, but not actually call it... yet */
-static struct tris_channel *bridge_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *bridge_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	struct bridge_pvt *p = NULL;
 
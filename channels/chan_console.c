@@ -183,7 +183,7 @@ static struct tris_jb_conf default_jbconf = {
 static struct tris_jb_conf global_jbconf;
 
 /*! Channel Technology Callbacks @{ */
-static struct tris_channel *console_request(const char *type, int format, 
+static struct tris_channel *console_request(const char *type, format_t format, 
 	void *data, int *cause, struct tris_channel* src);
 static int console_digit_begin(struct tris_channel *c, char digit);
 static int console_digit_end(struct tris_channel *c, char digit, unsigned int duration);
@@ -441,9 +441,9 @@ static struct tris_channel *console_new(struct console_pvt *pvt, const char *ext
 	return chan;
 }
 
-static struct tris_channel *console_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *console_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
-	int oldformat = format;
+	format_t oldformat = format;
 	struct tris_channel *chan = NULL;
 	struct console_pvt *pvt;
 
@@ -1425,7 +1425,7 @@ static struct dahdi_chan_conf dahdi_chan_conf_default(void)
 }
 
 
-static struct tris_channel *dahdi_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *dahdi_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int dahdi_digit_begin(struct tris_channel *ast, char digit);
 static int dahdi_digit_end(struct tris_channel *ast, char digit, unsigned int duration);
 static int dahdi_sendtext(struct tris_channel *c, const char *text);
@@ -11388,7 +11388,7 @@ static int pri_find_empty_chan(struct dahdi_pri *pri, int backwards)
 }
 #endif	/* defined(HAVE_PRI) */
 
-static struct tris_channel *dahdi_request(const char *type, int format, void *data, int *cause,struct tris_channel* src)
+static struct tris_channel *dahdi_request(const char *type, format_t format, void *data, int *cause,struct tris_channel* src)
 {
 	tris_group_t groupmatch = 0;
 	int channelmatch = -1;
@@ -12789,9 +12789,10 @@ static int pri_fixup_principle(struct dahdi_pri *pri, int principle, q931_call *
 				new->owner = old->owner;
 				old->owner = NULL;
 				if (new->owner) {
-					tris_string_field_build(new->owner, name,
-						"DAHDI/%d:%d-%d", pri->trunkgroup,
-						new->channel, 1);
+					char name[TRIS_CHANNEL_NAME];
+
+					snprintf(name, sizeof(name), "DAHDI/%d:%d-%d", pri->trunkgroup, new->channel, 1);
+					tris_change_name(new->owner, name);
 					new->owner->tech_pvt = new;
 					tris_channel_set_fd(new->owner, 0, new->subs[SUB_REAL].dfd);
 					new->subs[SUB_REAL].owner = old->subs[SUB_REAL].owner;
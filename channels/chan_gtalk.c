@@ -105,7 +105,7 @@ struct gtalk_pvt {
 	iksrule *ringrule;               /*!< Rule for matching RING request */
 	int initiator;                   /*!< If we're the initiator */
 	int alreadygone;
-	int capability;
+	format_t capability;
 	struct tris_codec_pref prefs;
 	struct gtalk_candidate *theircandidates;
 	struct gtalk_candidate *ourcandidates;
@@ -115,8 +115,8 @@ struct gtalk_pvt {
 	struct tris_channel *owner;       /*!< Master Channel */
 	struct tris_rtp *rtp;             /*!< RTP audio session */
 	struct tris_rtp *vrtp;            /*!< RTP video session */
-	int jointcapability;             /*!< Supported capability at both ends (codecs ) */
-	int peercapability;
+	format_t jointcapability;             /*!< Supported capability at both ends (codecs ) */
+	format_t peercapability;
 	struct gtalk_pvt *next;	/* Next entity */
 };
 
@@ -146,7 +146,7 @@ struct gtalk {
 	char context[TRIS_MAX_CONTEXT];
 	char parkinglot[TRIS_MAX_CONTEXT];	/*!<  Parkinglot */
 	char accountcode[TRIS_MAX_ACCOUNT_CODE];	/*!< Account code */
-	int capability;
+	format_t capability;
 	tris_group_t callgroup;	/*!< Call group */
 	tris_group_t pickupgroup;	/*!< Pickup group */
 	int callingpres;		/*!< Calling presentation */
@@ -161,12 +161,12 @@ struct gtalk_container {
 
 static const char desc[] = "Gtalk Channel";
 
-static int global_capability = TRIS_FORMAT_ULAW | TRIS_FORMAT_ALAW | TRIS_FORMAT_GSM | TRIS_FORMAT_H263;
+static format_t global_capability = TRIS_FORMAT_ULAW | TRIS_FORMAT_ALAW | TRIS_FORMAT_GSM | TRIS_FORMAT_H263;
 
 TRIS_MUTEX_DEFINE_STATIC(gtalklock); /*!< Protect the interface list (of gtalk_pvt's) */
 
 /* Forward declarations */
-static struct tris_channel *gtalk_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *gtalk_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int gtalk_digit(struct tris_channel *ast, char digit, unsigned int duration);
 static int gtalk_digit_begin(struct tris_channel *ast, char digit);
 static int gtalk_digit_end(struct tris_channel *ast, char digit, unsigned int duration);
@@ -186,9 +186,9 @@ static char *gtalk_do_reload(struct tris_cli_entry *e, int cmd, struct tris_cli_
 static char *gtalk_show_channels(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a);
 /*----- RTP interface functions */
 static int gtalk_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp,
-							   struct tris_rtp *vrtp, struct tris_rtp *trtp, int codecs, int nat_active);
+							   struct tris_rtp *vrtp, struct tris_rtp *trtp, format_t codecs, int nat_active);
 static enum tris_rtp_get_result gtalk_get_rtp_peer(struct tris_channel *chan, struct tris_rtp **rtp);
-static int gtalk_get_codec(struct tris_channel *chan);
+static format_t gtalk_get_codec(struct tris_channel *chan);
 
 /*! \brief PBX interface structure for channel registration */
 static const struct tris_channel_tech gtalk_tech = {
@@ -271,7 +271,7 @@ static struct gtalk *find_gtalk(char *name, char *connection)
 }
 
 
-static int add_codec_to_answer(const struct gtalk_pvt *p, int codec, iks *dcodecs)
+static int add_codec_to_answer(const struct gtalk_pvt *p, format_t codec, iks *dcodecs)
 {
 	int res = 0;
 	char *format = tris_getformatname(codec);
@@ -381,8 +381,8 @@ static int gtalk_invite(struct gtalk_pvt *p, char *to, char *from, char *sid, in
 	struct gtalk *client = p->parent;
 	iks *iq, *gtalk, *dcodecs, *payload_telephone, *transport;
 	int x;
-	int pref_codec = 0;
-	int alreadysent = 0;
+	format_t pref_codec = 0;
+	format_t alreadysent = 0;
 	int codecs_num = 0;
 	char *lowerto = NULL;
 
@@ -542,13 +542,13 @@ static enum tris_rtp_get_result gtalk_get_rtp_peer(struct tris_channel *chan, st
 	return res;
 }
 
-static int gtalk_get_codec(struct tris_channel *chan)
+static format_t gtalk_get_codec(struct tris_channel *chan)
 {
 	struct gtalk_pvt *p = chan->tech_pvt;
 	return p->peercapability;
 }
 
-static int gtalk_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, int codecs, int nat_active)
+static int gtalk_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, format_t codecs, int nat_active)
 {
 	struct gtalk_pvt *p;
 
@@ -989,8 +989,8 @@ static struct gtalk_pvt *gtalk_alloc(struct gtalk *client, const char *us, const
 static struct tris_channel *gtalk_new(struct gtalk *client, struct gtalk_pvt *i, int state, const char *title)
 {
 	struct tris_channel *tmp;
-	int fmt;
-	int what;
+	format_t fmt;
+	format_t what;
 	const char *n2;
 
 	if (title)
@@ -1634,7 +1634,7 @@ static int gtalk_hangup(struct tris_channel *ast)
 }
 
 /*! \brief Part of PBX interface */
-static struct tris_channel *gtalk_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *gtalk_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	struct gtalk_pvt *p = NULL;
 	struct gtalk *client = NULL;
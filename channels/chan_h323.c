@@ -174,8 +174,8 @@ struct oh323_pvt {
 	int newdigit;				/*!< Pending DTMF digit to send */
 	int newduration;			/*!< Pending DTMF digit duration to send */
 	int pref_codec;				/*!< Preferred codec */
-	int peercapability;			/*!< Capabilities learned from peer */
-	int jointcapability;			/*!< Common capabilities for local and remote side */
+	format_t peercapability;		/*!< Capabilities learned from peer */
+	format_t jointcapability;		/*!< Common capabilities for local and remote side */
 	struct tris_codec_pref peer_prefs;	/*!< Preferenced list of codecs which remote side supports */
 	int dtmf_pt[2];				/*!< Payload code used for RFC2833/CISCO messages */
 	int curDTMF;				/*!< DTMF tone being generated to Trismedia side */
@@ -231,7 +231,7 @@ static void delete_users(void);
 static void delete_aliases(void);
 static void prune_peers(void);
 
-static struct tris_channel *oh323_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *oh323_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int oh323_digit_begin(struct tris_channel *c, char digit);
 static int oh323_digit_end(struct tris_channel *c, char digit, unsigned int duration);
 static int oh323_call(struct tris_channel *c, char *dest, int timeout);
@@ -1000,7 +1000,7 @@ static struct tris_channel *__oh323_new(struct oh323_pvt *pvt, int state, const
 {
 	struct tris_channel *ch;
 	char *cid_num, *cid_name;
-	int fmt;
+	format_t fmt;
 
 	if (!tris_strlen_zero(pvt->options.cid_num))
 		cid_num = pvt->options.cid_num;
@@ -1719,9 +1719,9 @@ static int create_addr(struct oh323_pvt *pvt, char *opeer)
 		return 0;
 	}
 }
-static struct tris_channel *oh323_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *oh323_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
-	int oldformat;
+	format_t oldformat;
 	struct oh323_pvt *pvt;
 	struct tris_channel *tmpc = NULL;
 	char *dest = (char *)data;
@@ -2473,7 +2473,8 @@ static void set_peer_capabilities(unsigned call_reference, const char *token, in
 static void set_local_capabilities(unsigned call_reference, const char *token)
 {
 	struct oh323_pvt *pvt;
-	int capability, dtmfmode, pref_codec;
+	format_t capability;
+	int dtmfmode, pref_codec;
 	struct tris_codec_pref prefs;
 
 	if (h323debug)
@@ -3186,7 +3187,7 @@ static char *convertcap(int cap)
 	}
 }
 
-static int oh323_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, int codecs, int nat_active)
+static int oh323_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, format_t codecs, int nat_active)
 {
 	/* XXX Deal with Video */
 	struct oh323_pvt *pvt;
@@ -311,7 +311,7 @@ int (*iax2_regfunk)(const char *username, int onoff) = NULL;
 static	struct io_context *io;
 static	struct tris_sched_thread *sched;
 
-static int iax2_capability = IAX_CAPABILITY_FULLBANDWIDTH;
+static format_t iax2_capability = IAX_CAPABILITY_FULLBANDWIDTH;
 
 static int iaxdebug = 0;
 
@@ -422,7 +422,7 @@ struct iax2_user {
 	int amaflags;
 	int adsi;
 	unsigned int flags;
-	int capability;
+	format_t capability;
 	int maxauthreq; /*!< Maximum allowed outstanding AUTHREQs */
 	int curauthreq; /*!< Current number of outstanding AUTHREQs */
 	struct tris_codec_pref prefs;
@@ -469,7 +469,7 @@ struct iax2_peer {
 
 	int expire;					/*!< Schedule entry for expiry */
 	int expiry;					/*!< How soon to expire */
-	int capability;					/*!< Capability */
+	format_t capability;				/*!< Capability */
 
 	/* Qualification */
 	int callno;					/*!< Call number of POKE request */
@@ -608,7 +608,7 @@ struct chan_iax2_pvt {
 	/*! Last sent video format */
 	int svideoformat;
 	/*! What we are capable of sending */
-	int capability;
+	format_t capability;
 	/*! Last received timestamp */
 	unsigned int last;
 	/*! Last sent timestamp - never send the same timestamp twice in a single call */
@@ -1135,7 +1135,7 @@ static int send_command_final(struct chan_iax2_pvt *, char, int, unsigned int, c
 static int send_command_immediate(struct chan_iax2_pvt *, char, int, unsigned int, const unsigned char *, int, int);
 static int send_command_locked(unsigned short callno, char, int, unsigned int, const unsigned char *, int, int);
 static int send_command_transfer(struct chan_iax2_pvt *, char, int, unsigned int, const unsigned char *, int);
-static struct tris_channel *iax2_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *iax2_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static struct tris_frame *iax2_read(struct tris_channel *c);
 static struct iax2_peer *build_peer(const char *name, struct tris_variable *v, struct tris_variable *alt, int temponly);
 static struct iax2_user *build_user(const char *name, struct tris_variable *v, struct tris_variable *alt, int temponly);
@@ -3326,7 +3326,7 @@ static void __attempt_transmit(const void *data)
 						iax2_destroy(callno);
 					} else {
 						if (iaxs[callno]->owner)
-							tris_log(LOG_WARNING, "Max retries exceeded to host %s on %s (type = %d, subclass = %d, ts=%d, seqno=%d)\n", tris_inet_ntoa(iaxs[f->callno]->addr.sin_addr),iaxs[f->callno]->owner->name , f->af.frametype, f->af.subclass, f->ts, f->oseqno);
+							tris_log(LOG_WARNING, "Max retries exceeded to host %s on %s (type = %d, subclass = %lld, ts=%d, seqno=%d)\n", tris_inet_ntoa(iaxs[f->callno]->addr.sin_addr),iaxs[f->callno]->owner->name , f->af.frametype, (long long) f->af.subclass, f->ts, f->oseqno);
 						iaxs[callno]->error = ETIMEDOUT;
 						if (iaxs[callno]->owner) {
 							struct tris_frame fr = { TRIS_FRAME_CONTROL, TRIS_CONTROL_HANGUP, .data.uint32 = TRIS_CAUSE_DESTINATION_OUT_OF_ORDER };
@@ -3572,7 +3572,8 @@ static char *handle_cli_iax2_show_peer(struct tris_cli_entry *e, int cmd, struct
 	struct iax2_peer *peer;
 	char codec_buf[512];
 	struct tris_str *encmethods = tris_str_alloca(256);
-	int x = 0, codec = 0, load_realtime = 0;
+	int x = 0, load_realtime = 0;
+	format_t codec = 0;
 
 	switch (cmd) {
 	case CLI_INIT:
@@ -4316,7 +4317,7 @@ static void realtime_update_peer(const char *peername, struct sockaddr_in *sin,
 }
 
 struct create_addr_info {
-	int capability;
+	format_t capability;
 	unsigned int flags;
 	int maxtime;
 	int encmethods;
@@ -4380,7 +4381,7 @@ static int create_addr(const char *peername, struct tris_channel *c, struct sock
 	memcpy(&ourprefs, &peer->prefs, sizeof(ourprefs));
 	/* Move the calling channel's native codec to the top of the preference list */
 	if (c) {
-		tris_debug(1, "prepending %x to prefs\n", c->nativeformats);
+		tris_debug(1, "prepending %llx to prefs\n", (unsigned long long) c->nativeformats);
 		tris_codec_pref_prepend(&ourprefs, c->nativeformats, 1);
 	}
 	tris_codec_pref_convert(&ourprefs, cai->prefs, sizeof(cai->prefs), 1);
@@ -5223,7 +5224,7 @@ static enum tris_bridge_result iax2_bridge(struct tris_channel *c0, struct tris_
 				char buf1[255];
 				tris_getformatname_multiple(buf0, sizeof(buf0) -1, c0->nativeformats);
 				tris_getformatname_multiple(buf1, sizeof(buf1) -1, c1->nativeformats);
-			tris_verb(3, "Operating with different codecs %d[%s] %d[%s] , can't native bridge...\n", c0->nativeformats, buf0, c1->nativeformats, buf1);
+			tris_verb(3, "Operating with different codecs %lld[%s] %lld[%s] , can't native bridge...\n", (long long) c0->nativeformats, buf0, (long long) c1->nativeformats, buf1);
 			/* Remove from native mode */
 			lock_both(callno0, callno1);
 			if (iaxs[callno0])
@@ -9682,7 +9683,7 @@ static int socket_process(struct iax2_thread *thread)
 	}
 	if (ntohs(mh->callno) & IAX_FLAG_FULL) {
 		if (iaxdebug)
-			tris_debug(1, "Received packet %d, (%d, %d)\n", fh->oseqno, f.frametype, f.subclass);
+			tris_debug(1, "Received packet %d, (%d, %lld)\n", fh->oseqno, f.frametype, (long long) f.subclass);
 		/* Check if it's out of order (and not an ACK or INVAL) */
 		fr->oseqno = fh->oseqno;
 		fr->iseqno = fh->iseqno;
@@ -9722,8 +9723,8 @@ static int socket_process(struct iax2_thread *thread)
 			  (f.subclass != IAX_COMMAND_VNAK)) ||
 			  (f.frametype != TRIS_FRAME_IAX)) {
 			 	/* If it's not an ACK packet, it's out of order. */
-				tris_debug(1, "Packet arrived out of order (expecting %d, got %d) (frametype = %d, subclass = %d)\n", 
-					iaxs[fr->callno]->iseqno, fr->oseqno, f.frametype, f.subclass);
+				tris_debug(1, "Packet arrived out of order (expecting %d, got %d) (frametype = %d, subclass = %lld)\n", 
+					iaxs[fr->callno]->iseqno, fr->oseqno, f.frametype, (long long) f.subclass);
 				/* Check to see if we need to request retransmission,
 				 * and take sequence number wraparound into account */
 				if ((unsigned char) (iaxs[fr->callno]->iseqno - fr->oseqno) < 128) {
@@ -9901,7 +9902,7 @@ static int socket_process(struct iax2_thread *thread)
 		if (f.frametype == TRIS_FRAME_VOICE) {
 			if (f.subclass != iaxs[fr->callno]->voiceformat) {
 					iaxs[fr->callno]->voiceformat = f.subclass;
-					tris_debug(1, "Ooh, voice format changed to %d\n", f.subclass);
+					tris_debug(1, "Ooh, voice format changed to %lld\n", (long long) f.subclass);
 					if (iaxs[fr->callno]->owner) {
 						int orignative;
 retryowner:
@@ -9934,7 +9935,7 @@ retryowner:
 		}
 		if (f.frametype == TRIS_FRAME_VIDEO) {
 			if (f.subclass != iaxs[fr->callno]->videoformat) {
-				tris_debug(1, "Ooh, video format changed to %d\n", f.subclass & ~0x1);
+				tris_debug(1, "Ooh, video format changed to %lld\n", (long long) (f.subclass & ~0x1));
 				iaxs[fr->callno]->videoformat = f.subclass & ~0x1;
 			}
 		}
@@ -9949,7 +9950,7 @@ retryowner:
 			tris_sched_thread_del(sched, iaxs[fr->callno]->initid);
 			/* Handle the IAX pseudo frame itself */
 			if (iaxdebug)
-				tris_debug(1, "IAX subclass %d received\n", f.subclass);
+				tris_debug(1, "IAX subclass %lld received\n", (long long) f.subclass);
 
                         /* Update last ts unless the frame's timestamp originated with us. */
 			if (iaxs[fr->callno]->last < fr->ts &&
@@ -10146,9 +10147,9 @@ retryowner:
 								}
 								if (authdebug) {
 									if(tris_test_flag(iaxs[fr->callno], IAX_CODEC_NOCAP))
-										tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested 0x%x incompatible with our capability 0x%x.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->capability);
+										tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested 0x%x incompatible with our capability 0x%llx.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, (unsigned long long) iaxs[fr->callno]->capability);
 									else 
-										tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested/capability 0x%x/0x%x incompatible with our capability 0x%x.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->peercapability, iaxs[fr->callno]->capability);
+										tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested/capability 0x%x/0x%x incompatible with our capability 0x%llx.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->peercapability, (unsigned long long) iaxs[fr->callno]->capability);
 								}
 							} else {
 								/* Pick one... */
@@ -10183,14 +10184,14 @@ retryowner:
 									memset(&ied0, 0, sizeof(ied0));
 									iax_ie_append_str(&ied0, IAX_IE_CAUSE, "Unable to negotiate codec");
 									iax_ie_append_byte(&ied0, IAX_IE_CAUSECODE, TRIS_CAUSE_BEARERCAPABILITY_NOTAVAIL);
-									tris_log(LOG_ERROR, "No best format in 0x%x???\n", iaxs[fr->callno]->peercapability & iaxs[fr->callno]->capability);
+									tris_log(LOG_ERROR, "No best format in 0x%llx???\n", (unsigned long long) (iaxs[fr->callno]->peercapability & iaxs[fr->callno]->capability));
 									send_command_final(iaxs[fr->callno], TRIS_FRAME_IAX, IAX_COMMAND_REJECT, 0, ied0.buf, ied0.pos, -1);
 									if (!iaxs[fr->callno]) {
 										tris_mutex_unlock(&iaxsl[fr->callno]);
 										return 1;
 									}
 									if (authdebug)
-										tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested/capability 0x%x/0x%x incompatible with our capability 0x%x.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->peercapability, iaxs[fr->callno]->capability);
+										tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested/capability 0x%x/0x%x incompatible with our capability 0x%llx.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->peercapability, (unsigned long long) iaxs[fr->callno]->capability);
 									tris_set_flag(iaxs[fr->callno], IAX_ALREADYGONE);	
 									break;
 								}
@@ -10355,7 +10356,7 @@ retryowner:
 						return 1;
 					}
 					if (authdebug)
-						tris_log(LOG_NOTICE, "Rejected call to %s, format 0x%x incompatible with our capability 0x%x.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->capability);
+						tris_log(LOG_NOTICE, "Rejected call to %s, format 0x%x incompatible with our capability 0x%llx.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, (unsigned long long) iaxs[fr->callno]->capability);
 				} else {
 					tris_set_flag(&iaxs[fr->callno]->state, IAX_STATE_STARTED);
 					if (iaxs[fr->callno]->owner) {
@@ -10567,9 +10568,9 @@ retryowner2:
 						if (!format) {
 							if (authdebug) {
 								if(tris_test_flag(iaxs[fr->callno], IAX_CODEC_NOCAP)) 
-									tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested 0x%x incompatible with our capability 0x%x.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->capability);
+									tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested 0x%x incompatible with our capability 0x%llx.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, (unsigned long long) iaxs[fr->callno]->capability);
 								else
-									tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested/capability 0x%x/0x%x incompatible with our capability 0x%x.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->peercapability, iaxs[fr->callno]->capability);
+									tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested/capability 0x%x/0x%x incompatible with our capability 0x%llx.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->peercapability, (unsigned long long) iaxs[fr->callno]->capability);
 							}
 							memset(&ied0, 0, sizeof(ied0));
 							iax_ie_append_str(&ied0, IAX_IE_CAUSE, "Unable to negotiate codec");
@@ -10608,12 +10609,12 @@ retryowner2:
 								}
 							}
 							if (!format) {
-								tris_log(LOG_ERROR, "No best format in 0x%x???\n", iaxs[fr->callno]->peercapability & iaxs[fr->callno]->capability);
+								tris_log(LOG_ERROR, "No best format in 0x%llx???\n", (unsigned long long) (iaxs[fr->callno]->peercapability & iaxs[fr->callno]->capability));
 								if (authdebug) {
 									if(tris_test_flag(iaxs[fr->callno], IAX_CODEC_NOCAP))
-										tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested 0x%x incompatible with our capability 0x%x.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->capability);
+										tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested 0x%x incompatible with our capability 0x%llx.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, (unsigned long long) iaxs[fr->callno]->capability);
 									else
-										tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested/capability 0x%x/0x%x incompatible with our capability 0x%x.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->peercapability, iaxs[fr->callno]->capability);
+										tris_log(LOG_NOTICE, "Rejected connect attempt from %s, requested/capability 0x%x/0x%x incompatible with our capability 0x%llx.\n", tris_inet_ntoa(sin.sin_addr), iaxs[fr->callno]->peerformat, iaxs[fr->callno]->peercapability, (unsigned long long) iaxs[fr->callno]->capability);
 								}
 								memset(&ied0, 0, sizeof(ied0));
 								iax_ie_append_str(&ied0, IAX_IE_CAUSE, "Unable to negotiate codec");
@@ -10998,7 +10999,7 @@ immediatedial:
 				break;
 			}
 			default:
-				tris_debug(1, "Unknown IAX command %d on %d/%d\n", f.subclass, fr->callno, iaxs[fr->callno]->peercallno);
+				tris_debug(1, "Unknown IAX command %lld on %d/%d\n", (long long) f.subclass, fr->callno, iaxs[fr->callno]->peercallno);
 				memset(&ied0, 0, sizeof(ied0));
 				iax_ie_append_byte(&ied0, IAX_IE_IAX_UNKNOWN, f.subclass);
 				send_command(iaxs[fr->callno], TRIS_FRAME_IAX, IAX_COMMAND_UNSUPPORT, 0, ied0.buf, ied0.pos, -1);
@@ -11100,7 +11101,7 @@ immediatedial:
 		fr->outoforder = 0;
 	} else {
 		if (iaxdebug && iaxs[fr->callno])
-			tris_debug(1, "Received out of order packet... (type=%d, subclass %d, ts = %d, last = %d)\n", f.frametype, f.subclass, fr->ts, iaxs[fr->callno]->last);
+			tris_debug(1, "Received out of order packet... (type=%d, subclass %lld, ts = %d, last = %d)\n", f.frametype, (long long) f.subclass, fr->ts, iaxs[fr->callno]->last);
 		fr->outoforder = -1;
 	}
 	fr->cacheable = ((f.frametype == TRIS_FRAME_VOICE) || (f.frametype == TRIS_FRAME_VIDEO));
@@ -11558,11 +11559,11 @@ static void free_context(struct iax2_context *con)
 	}
 }
 
-static struct tris_channel *iax2_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *iax2_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	int callno;
 	int res;
-	int fmt, native;
+	format_t fmt, native;
 	struct sockaddr_in sin;
 	struct tris_channel *c;
 	struct parsed_dial_string pds;
@@ -12493,7 +12494,7 @@ static void set_config_destroy(void)
 static int set_config(const char *config_file, int reload)
 {
 	struct tris_config *cfg, *ucfg;
-	int capability=iax2_capability;
+	format_t capability=iax2_capability;
 	struct tris_variable *v;
 	char *cat;
 	const char *utype;
@@ -13366,7 +13367,7 @@ static int function_iaxpeer(struct tris_channel *chan, const char *cmd, char *da
 		tris_getformatname_multiple(buf, len -1, peer->capability);
 	} else  if (!strncasecmp(colname, "codec[", 6)) {
 		char *codecnum, *ptr;
-		int codec = 0;
+		format_t codec = 0;
 		
 		codecnum = strchr(colname, '[');
 		*codecnum = '\0';
@@ -104,7 +104,7 @@ struct jingle_pvt {
 	iksrule *ringrule;               /*!< Rule for matching RING request */
 	int initiator;                   /*!< If we're the initiator */
 	int alreadygone;
-	int capability;
+	format_t capability;
 	struct tris_codec_pref prefs;
 	struct jingle_candidate *theircandidates;
 	struct jingle_candidate *ourcandidates;
@@ -116,8 +116,8 @@ struct jingle_pvt {
 	struct tris_rtp *rtp;             /*!< RTP audio session */
 	char video_content_name[100];    /*!< name attribute of content tag */
 	struct tris_rtp *vrtp;            /*!< RTP video session */
-	int jointcapability;             /*!< Supported capability at both ends (codecs ) */
-	int peercapability;
+	format_t jointcapability;             /*!< Supported capability at both ends (codecs ) */
+	format_t peercapability;
 	struct jingle_pvt *next;	/* Next entity */
 };
 
@@ -147,7 +147,7 @@ struct jingle {
 	char user[100];
 	char context[100];
 	char accountcode[TRIS_MAX_ACCOUNT_CODE];	/*!< Account code */
-	int capability;
+	format_t capability;
 	tris_group_t callgroup;	/*!< Call group */
 	tris_group_t pickupgroup;	/*!< Pickup group */
 	int callingpres;		/*!< Calling presentation */
@@ -164,12 +164,12 @@ struct jingle_container {
 static const char desc[] = "Jingle Channel";
 static const char channel_type[] = "Jingle";
 
-static int global_capability = TRIS_FORMAT_ULAW | TRIS_FORMAT_ALAW | TRIS_FORMAT_GSM | TRIS_FORMAT_H263;
+static format_t global_capability = TRIS_FORMAT_ULAW | TRIS_FORMAT_ALAW | TRIS_FORMAT_GSM | TRIS_FORMAT_H263;
 
 TRIS_MUTEX_DEFINE_STATIC(jinglelock); /*!< Protect the interface list (of jingle_pvt's) */
 
 /* Forward declarations */
-static struct tris_channel *jingle_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *jingle_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int jingle_digit_begin(struct tris_channel *ast, char digit);
 static int jingle_digit_end(struct tris_channel *ast, char digit, unsigned int duration);
 static int jingle_call(struct tris_channel *ast, char *dest, int timeout);
@@ -186,9 +186,9 @@ static char *jingle_show_channels(struct tris_cli_entry *e, int cmd, struct tris
 static char *jingle_do_reload(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a);
 /*----- RTP interface functions */
 static int jingle_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp,
-							   struct tris_rtp *vrtp, struct tris_rtp *tpeer, int codecs, int nat_active);
+							   struct tris_rtp *vrtp, struct tris_rtp *tpeer, format_t codecs, int nat_active);
 static enum tris_rtp_get_result jingle_get_rtp_peer(struct tris_channel *chan, struct tris_rtp **rtp);
-static int jingle_get_codec(struct tris_channel *chan);
+static format_t jingle_get_codec(struct tris_channel *chan);
 
 /*! \brief PBX interface structure for channel registration */
 static const struct tris_channel_tech jingle_tech = {
@@ -267,7 +267,7 @@ static struct jingle *find_jingle(char *name, char *connection)
 }
 
 
-static void add_codec_to_answer(const struct jingle_pvt *p, int codec, iks *dcodecs)
+static void add_codec_to_answer(const struct jingle_pvt *p, format_t codec, iks *dcodecs)
 {
 	char *format = tris_getformatname(codec);
 
@@ -314,8 +314,8 @@ static int jingle_accept_call(struct jingle *client, struct jingle_pvt *p)
 	struct aji_client *c = client->connection;
 	iks *iq, *jingle, *dcodecs, *payload_red, *payload_audio, *payload_cn;
 	int x;
-	int pref_codec = 0;
-	int alreadysent = 0;
+	format_t pref_codec = 0;
+	format_t alreadysent = 0;
 
 	if (p->initiator)
 		return 1;
@@ -417,13 +417,13 @@ static enum tris_rtp_get_result jingle_get_rtp_peer(struct tris_channel *chan, s
 	return res;
 }
 
-static int jingle_get_codec(struct tris_channel *chan)
+static format_t jingle_get_codec(struct tris_channel *chan)
 {
 	struct jingle_pvt *p = chan->tech_pvt;
 	return p->peercapability;
 }
 
-static int jingle_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *tpeer, int codecs, int nat_active)
+static int jingle_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *tpeer, format_t codecs, int nat_active)
 {
 	struct jingle_pvt *p;
 
@@ -800,8 +800,8 @@ static struct jingle_pvt *jingle_alloc(struct jingle *client, const char *from,
 static struct tris_channel *jingle_new(struct jingle *client, struct jingle_pvt *i, int state, const char *title)
 {
 	struct tris_channel *tmp;
-	int fmt;
-	int what;
+	format_t fmt;
+	format_t what;
 	const char *str;
 
 	if (title)
@@ -1465,7 +1465,7 @@ static int jingle_hangup(struct tris_channel *ast)
 }
 
 /*! \brief Part of PBX interface */
-static struct tris_channel *jingle_request(const char *request_type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *jingle_request(const char *request_type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	struct jingle_pvt *p = NULL;
 	struct jingle *client = NULL;
@@ -62,7 +62,7 @@ static struct tris_jb_conf g_jb_conf = {
 	.target_extra = -1,
 };
 
-static struct tris_channel *local_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *local_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int local_digit_begin(struct tris_channel *ast, char digit);
 static int local_digit_end(struct tris_channel *ast, char digit, unsigned int duration);
 static int local_call(struct tris_channel *ast, char *dest, int timeout);
@@ -821,7 +821,7 @@ static struct tris_channel *local_new(struct local_pvt *p, int state)
 }
 
 /*! \brief Part of PBX interface */
-static struct tris_channel *local_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *local_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	struct local_pvt *p = NULL;
 	struct tris_channel *chan = NULL;
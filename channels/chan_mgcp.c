@@ -211,7 +211,7 @@ static pthread_t monitor_thread = TRIS_PTHREADT_NULL;
 
 static int restart_monitor(void);
 
-static int capability = TRIS_FORMAT_ULAW;
+static format_t capability = TRIS_FORMAT_ULAW;
 static int nonCodecCapability = TRIS_RTP_DTMF;
 
 static char ourhost[MAXHOSTNAMELEN];
@@ -344,7 +344,7 @@ struct mgcp_endpoint {
 	int iseq; /*!< Not used? */
 	int lastout; /*!< tracking this on the subchannels.  Is it needed here? */
 	int needdestroy; /*!< Not used? */
-	int capability;
+	format_t capability;
 	int nonCodecCapability;
 	int onhooktime;
 	int msgstate; /*!< voicemail message state */
@@ -419,7 +419,7 @@ static void dump_cmd_queues(struct mgcp_endpoint *p, struct mgcp_subchannel *sub
 static char *mgcp_reload(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a);
 static int reload_config(int reload);
 
-static struct tris_channel *mgcp_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *mgcp_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int mgcp_call(struct tris_channel *ast, char *dest, int timeout);
 static int mgcp_hangup(struct tris_channel *ast);
 static int mgcp_answer(struct tris_channel *ast);
@@ -1212,7 +1212,7 @@ static struct tris_frame *mgcp_rtp_read(struct mgcp_subchannel *sub)
 		/* We already hold the channel lock */
 		if (f->frametype == TRIS_FRAME_VOICE) {
 			if (f->subclass != sub->owner->nativeformats) {
-				tris_debug(1, "Oooh, format changed to %d\n", f->subclass);
+				tris_debug(1, "Oooh, format changed to %lld\n", (long long) f->subclass);
 				sub->owner->nativeformats = f->subclass;
 				tris_set_read_format(sub->owner, sub->owner->readformat);
 				tris_set_write_format(sub->owner, sub->owner->writeformat);
@@ -1253,8 +1253,8 @@ static int mgcp_write(struct tris_channel *ast, struct tris_frame *frame)
 		}
 	} else {
 		if (!(frame->subclass & ast->nativeformats)) {
-			tris_log(LOG_WARNING, "Asked to transmit frame type %d, while native formats is %d (read/write = %d/%d)\n",
-				frame->subclass, ast->nativeformats, ast->readformat, ast->writeformat);
+			tris_log(LOG_WARNING, "Asked to transmit frame type %lld, while native formats is %lld (read/write = %lld/%lld)\n",
+				(long long) frame->subclass, (long long) ast->nativeformats, (long long) ast->readformat, (long long) ast->writeformat);
 			return -1;
 		}
 	}
@@ -1471,7 +1471,7 @@ static struct tris_channel *mgcp_new(struct mgcp_subchannel *sub, int state)
 {
 	struct tris_channel *tmp;
 	struct mgcp_endpoint *i = sub->parent;
-	int fmt;
+	format_t fmt;
 
 	tmp = tris_channel_alloc(1, state, i->cid_num, i->cid_name, i->accountcode, i->exten, i->context, i->amaflags, "MGCP/%s@%s-%d", i->name, i->parent->name, sub->id);
 	if (tmp) {
@@ -1480,7 +1480,6 @@ static struct tris_channel *mgcp_new(struct mgcp_subchannel *sub, int state)
 		if (!tmp->nativeformats)
 			tmp->nativeformats = capability;
 		fmt = tris_best_codec(tmp->nativeformats);
-		tris_string_field_build(tmp, name, "MGCP/%s@%s-%d", i->name, i->parent->name, sub->id);
 		if (sub->rtp)
 			tris_channel_set_fd(tmp, 0, tris_rtp_fd(sub->rtp));
 		if (i->dtmfmode & (MGCP_DTMF_INBAND | MGCP_DTMF_HYBRID)) {
@@ -1843,7 +1842,8 @@ static int process_sdp(struct mgcp_subchannel *sub, struct mgcp_request *req)
 	char host[258];
 	int len;
 	int portno;
-	int peercapability, peerNonCodecCapability;
+	format_t peercapability;
+	int peerNonCodecCapability;
 	struct sockaddr_in sin;
 	char *codecs;
 	struct tris_hostent ahp; struct hostent *hp;
@@ -1909,8 +1909,8 @@ static int process_sdp(struct mgcp_subchannel *sub, struct mgcp_request *req)
 	tris_rtp_get_current_formats(sub->rtp, &peercapability, &peerNonCodecCapability);
 	p->capability = capability & peercapability;
 	if (mgcpdebug) {
-		tris_verbose("Capabilities: us - %d, them - %d, combined - %d\n",
-			capability, peercapability, p->capability);
+		tris_verbose("Capabilities: us - %lld, them - %lld, combined - %lld\n",
+			(long long) capability, (long long) peercapability, (long long) p->capability);
 		tris_verbose("Non-codec capabilities: us - %d, them - %d, combined - %d\n",
 			nonCodecCapability, peerNonCodecCapability, p->nonCodecCapability);
 	}
@@ -3495,9 +3495,9 @@ static int restart_monitor(void)
 	return 0;
 }
 
-static struct tris_channel *mgcp_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *mgcp_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
-	int oldformat;
+	format_t oldformat;
 	struct mgcp_subchannel *sub;
 	struct tris_channel *tmpc = NULL;
 	char tmp[256];
@@ -3506,7 +3506,7 @@ static struct tris_channel *mgcp_request(const char *type, int format, void *dat
 	oldformat = format;
 	format &= capability;
 	if (!format) {
-		tris_log(LOG_NOTICE, "Asked to get a channel of unsupported format '%d'\n", format);
+		tris_log(LOG_NOTICE, "Asked to get a channel of unsupported format '%lld'\n", (long long) format);
 		return NULL;
 	}
 	tris_copy_string(tmp, dest, sizeof(tmp));
@@ -3956,7 +3956,7 @@ static enum tris_rtp_get_result mgcp_get_rtp_peer(struct tris_channel *chan, str
 		return TRIS_RTP_TRY_PARTIAL;
 }
 
-static int mgcp_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, int codecs, int nat_active)
+static int mgcp_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, format_t codecs, int nat_active)
 {
 	/* XXX Is there such thing as video support with MGCP? XXX */
 	struct mgcp_subchannel *sub;
@@ -4082,7 +4082,7 @@ static int reload_config(int reload)
 	char *cat;
 	struct tris_hostent ahp;
 	struct hostent *hp;
-	int format;
+	format_t format;
 	struct tris_flags config_flags = { reload ? CONFIG_FLAG_FILEUNCHANGED : 0 };
 	
 	if (gethostname(ourhost, sizeof(ourhost)-1)) {
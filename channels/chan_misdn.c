@@ -3423,7 +3423,7 @@ static struct chan_list *init_chan_list(int orig)
 	return cl;
 }
 
-static struct tris_channel *misdn_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *misdn_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	struct tris_channel *tmp = NULL;
 	char group[BUFFERSIZE + 1] = "";
@@ -66,7 +66,7 @@ struct nbs_pvt {
 	struct tris_module_user *u;		/*! for holding a reference to this module */
 };
 
-static struct tris_channel *nbs_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *nbs_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int nbs_call(struct tris_channel *ast, char *dest, int timeout);
 static int nbs_hangup(struct tris_channel *ast);
 static struct tris_frame *nbs_xread(struct tris_channel *ast);
@@ -251,9 +251,9 @@ static struct tris_channel *nbs_new(struct nbs_pvt *i, int state)
 }
 
 
-static struct tris_channel *nbs_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *nbs_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
-	int oldformat;
+	format_t oldformat;
 	struct nbs_pvt *p;
 	struct tris_channel *tmp = NULL;
 	
@@ -326,7 +326,7 @@ static struct chan_oss_pvt oss_default = {
 
 static int setformat(struct chan_oss_pvt *o, int mode);
 
-static struct tris_channel *oss_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *oss_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int oss_digit_begin(struct tris_channel *c, char digit);
 static int oss_digit_end(struct tris_channel *c, char digit, unsigned int duration);
 static int oss_text(struct tris_channel *c, const char *text);
@@ -824,7 +824,7 @@ static struct tris_channel *oss_new(struct chan_oss_pvt *o, char *ext, char *ctx
 	return c;
 }
 
-static struct tris_channel *oss_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *oss_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	struct tris_channel *c;
 	struct chan_oss_pvt *o;
@@ -844,7 +844,7 @@ static struct tris_channel *oss_request(const char *type, int format, void *data
 		return NULL;
 	}
 	if ((format & TRIS_FORMAT_SLINEAR) == 0) {
-		tris_log(LOG_NOTICE, "Format 0x%x unsupported\n", format);
+		tris_log(LOG_NOTICE, "Format 0x%llx unsupported\n", (unsigned long long) format);
 		return NULL;
 	}
 	if (o->owner) {
@@ -150,7 +150,7 @@ static struct phone_pvt {
 static char cid_num[TRIS_MAX_EXTENSION];
 static char cid_name[TRIS_MAX_EXTENSION];
 
-static struct tris_channel *phone_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *phone_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int phone_digit_begin(struct tris_channel *ast, char digit);
 static int phone_digit_end(struct tris_channel *ast, char digit, unsigned int duration);
 static int phone_call(struct tris_channel *ast, char *dest, int timeout);
@@ -1211,9 +1211,9 @@ static struct phone_pvt *mkif(const char *iface, int mode, int txgain, int rxgai
 	return tmp;
 }
 
-static struct tris_channel *phone_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *phone_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
-	int oldformat;
+	format_t oldformat;
 	struct phone_pvt *p;
 	struct tris_channel *tmp = NULL;
 	char *name = data;
@@ -242,7 +242,7 @@ static unsigned int global_tos_audio;		/*!< IP type of service for audio RTP pac
 static unsigned int global_cos_audio;		/*!< 802.1p class of service for audio RTP packets */
 //static unsigned int global_cos_video;		/*!< 802.1p class of service for video RTP packets */
 //static unsigned int global_cos_text;		/*!< 802.1p class of service for text RTP packets */
-static int global_capability = TRIS_FORMAT_ILBC | TRIS_FORMAT_SPEEX | TRIS_FORMAT_H264;
+static format_t global_capability = TRIS_FORMAT_ILBC | TRIS_FORMAT_SPEEX | TRIS_FORMAT_H264;
 static int global_rtptimeout;		/*!< Time out call if no RTP */
 static int global_rtpholdtimeout;	/*!< Time out call if no RTP during hold */
 static int global_rtpkeepalive;		/*!< Send RTP keepalives */
@@ -750,10 +750,10 @@ struct rakwon_pvt {
 	struct rakwon_user_info m_user_info;
 	enum invitestates invitestate;
 	struct tris_codec_pref prefs;		/*!< codec prefs */
-	int capability;				/*!< Special capability (codec) */
-	int jointcapability;			/*!< Supported capability at both ends (codecs) */
-	int peercapability;			/*!< Supported peer capability */
-	int prefcodec;				/*!< Preferred codec (outbound only) */
+	format_t capability;			/*!< Special capability (codec) */
+	format_t jointcapability;		/*!< Supported capability at both ends (codecs) */
+	format_t peercapability;		/*!< Supported peer capability */
+	format_t prefcodec;			/*!< Preferred codec (outbound only) */
 	int noncodeccapability;			/*!< DTMF RFC2833 telephony-event */
 	int jointnoncodeccapability;            /*!< Joint Non codec capability */
 	int redircodecs;			/*!< Redirect codecs */
@@ -773,7 +773,7 @@ static int utf8_to_unicode(const unsigned char *utf8, int cc, unsigned short *un
 //static  int unicode_to_utf8 (const unsigned short *unicode16, int len, char* utf8);
 
 /*--- PBX Interface Functions ---*/
-static struct tris_channel *rakwon_request_call(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *rakwon_request_call(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 //static int rakwon_devicestate(void *data);
 static int rakwon_sendtext(struct tris_channel *ast, const char *text);
 static int rakwon_call(struct tris_channel *ast, char *dest, int timeout);
@@ -803,8 +803,8 @@ static struct tris_channel *rakwon_new(struct rakwon_pvt *i, int state, const ch
 
 static enum tris_rtp_get_result rakwon_get_vrtp_peer(struct tris_channel *chan, struct tris_rtp **rtp);
 static enum tris_rtp_get_result rakwon_get_trtp_peer(struct tris_channel *chan, struct tris_rtp **rtp);
-static int rakwon_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, int codecs, int nat_active);
-static int rakwon_get_codec(struct tris_channel *chan);
+static int rakwon_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, format_t codecs, int nat_active);
+static format_t rakwon_get_codec(struct tris_channel *chan);
 static int rakwon_senddigit_end(struct tris_channel *ast, char digit, unsigned int duration);
 static const char* rakwon_useragent(char * exten);
 
@@ -1682,11 +1682,11 @@ static void *dialog_unlink_all(struct rakwon_pvt *dialog, int lockowner, int loc
 static struct tris_channel *rakwon_new(struct rakwon_pvt *i, int state, const char *title)
 {
 	struct tris_channel *tmp;
-	int fmt;
-	int what;
-	int video;
-	int text;
-	int needvideo = 0;
+	format_t fmt;
+	format_t what;
+	format_t video;
+	format_t text;
+	format_t needvideo = 0;
 	char buf[RAKWONBUFSIZE];
 
 	{
@@ -1829,7 +1829,7 @@ static struct tris_channel *rakwon_new(struct rakwon_pvt *i, int state, const ch
  *	or	RAKWON/host!dnid
  * \endverbatim
 */
-static struct tris_channel *rakwon_request_call(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *rakwon_request_call(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	struct rakwon_pvt *p;
 	struct tris_channel *tmpc = NULL;
@@ -1840,7 +1840,7 @@ static struct tris_channel *rakwon_request_call(const char *type, int format, vo
  	char *md5secret = NULL;
  	char *authname = NULL;
 	char *trans = NULL;
-	int oldformat = TRIS_FORMAT_SPEEX | TRIS_FORMAT_H264;
+	format_t oldformat = TRIS_FORMAT_SPEEX | TRIS_FORMAT_H264;
 	char *caller_ext = NULL;
 	//struct rakwon_server * server;
 	char sql[MAX_SQL_STAT];
@@ -2582,8 +2582,8 @@ static struct tris_frame *rakwon_rtp_read(struct tris_channel *ast, struct rakwo
 				tris_getformatname(f->subclass), p->owner->name);
 			return &tris_null_frame;
 		}
-		tris_debug(1, "Oooh, format changed to %d %s\n",
-			f->subclass, tris_getformatname(f->subclass));
+		tris_debug(1, "Oooh, format changed to %lld %s\n",
+			(long long) f->subclass, tris_getformatname(f->subclass));
 		p->owner->nativeformats = (p->owner->nativeformats & (TRIS_FORMAT_VIDEO_MASK | TRIS_FORMAT_TEXT_MASK)) | f->subclass;
 		tris_set_read_format(p->owner, p->owner->readformat);
 		tris_set_write_format(p->owner, p->owner->writeformat);
@@ -2623,14 +2623,14 @@ static int rakwon_write(struct tris_channel *ast, struct tris_frame *frame)
 		if (p->m_b_speaker) {
 			if (!(frame->subclass & ast->nativeformats)) {
 				char s1[512], s2[512], s3[512];
-				tris_log(LOG_WARNING, "Asked to transmit frame type %d, while native formats is %s(%d) read/write = %s(%d)/%s(%d)\n",
-					frame->subclass, 
+				tris_log(LOG_WARNING, "Asked to transmit frame type %lld, while native formats is %s(%lld) read/write = %s(%lld)/%s(%lld)\n",
+					(long long) frame->subclass, 
 					tris_getformatname_multiple(s1, sizeof(s1) - 1, ast->nativeformats & TRIS_FORMAT_AUDIO_MASK),
-					ast->nativeformats & TRIS_FORMAT_AUDIO_MASK,
+					(long long) (ast->nativeformats & TRIS_FORMAT_AUDIO_MASK),
 					tris_getformatname_multiple(s2, sizeof(s2) - 1, ast->readformat),
-					ast->readformat,
+					(long long) ast->readformat,
 					tris_getformatname_multiple(s3, sizeof(s3) - 1, ast->writeformat),
-					ast->writeformat);
+					(long long) ast->writeformat);
 				return 0;
 			}
 			if (p) {
@@ -2787,13 +2787,13 @@ static enum tris_rtp_get_result rakwon_get_trtp_peer(struct tris_channel *chan,
 }
 
 /*! \brief Set the RTP peer for this call */
-static int rakwon_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, int codecs, int nat_active)
+static int rakwon_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, format_t codecs, int nat_active)
 {
 	return 0;
 }
 
 /*! \brief Return RAKWON UA's codec (part of the RTP interface) */
-static int rakwon_get_codec(struct tris_channel *chan)
+static format_t rakwon_get_codec(struct tris_channel *chan)
 {
 	struct rakwon_pvt *p = chan->tech_pvt;
 	return p->jointcapability ? p->jointcapability : p->capability;	
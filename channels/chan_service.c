@@ -163,6 +163,7 @@
 
 /*** MODULEINFO
         <depend>chan_local</depend>
+        <depend>res_sip_core</depend>
  ***/
 
 /*!  \page service_session_timers SERVICE Session Timers in Trismedia Chan_service
@@ -272,6 +273,8 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 250253 $")
 #include "trismedia/strings.h"
 #include "trismedia/audiohook.h"
 
+#include "trismedia/sip_core.h"
+
 /*** DOCUMENTATION
 	<application name="SERVICEDtmfMode" language="en_US">
 		<synopsis>
@@ -1118,10 +1121,13 @@ static int global_autoframing;          	/*!< Turn autoframing on or off. */
 static int global_qualifyfreq;			/*!< Qualify frequency */
 static int global_qualify_gap;              /*!< Time between our group of peer pokes */
 static int global_qualify_peers;          /*!< Number of peers to poke at a given time */
+static int global_serviceworkers;		/*!< Number of threads processing UDP packets, 0 for the monitor thread */
+static int global_udpbatch;		/*!< Max UDP packets per system call, 0 to not batch */
+static struct tris_udp_batch_stats servicesock_stats;	/*!< System calls and packets on the UDP socket */
 
 
 /*! \brief Codecs that we support by default: */
-static int global_capability = TRIS_FORMAT_ULAW | TRIS_FORMAT_ALAW | TRIS_FORMAT_GSM | TRIS_FORMAT_H263;
+static format_t global_capability = TRIS_FORMAT_ULAW | TRIS_FORMAT_ALAW | TRIS_FORMAT_GSM | TRIS_FORMAT_H263;
 
 static enum st_mode global_st_mode;           /*!< Mode of operation for Session-Timers           */
 static enum st_refresher global_st_refresher; /*!< Session-Timer refresher                        */
@@ -1168,6 +1174,10 @@ static struct sched_context *sched;     /*!< The scheduling context */
 static struct io_context *io;           /*!< The IO context */
 static int *servicesock_read_id;            /*!< ID of IO entry for servicesock FD */
 
+/*! \brief Our handle on the worker threads shared by the SIP drivers, none unless serviceworkers is set in service.conf */
+static struct sip_worker_pool *service_workers;
+TRIS_MUTEX_DEFINE_STATIC(service_workers_lock);
+
 #define DEC_CALL_LIMIT	0
 #define INC_CALL_LIMIT	1
 #define DEC_CALL_RINGING 2
@@ -1217,8 +1227,11 @@ struct service_request {
 	char debug;		/*!< print extra debugging if non zero */
 	char has_to_tag;	/*!< non-zero if packet has To: tag */
 	char ignore;		/*!< if non-zero This is a re-transmit, ignore it */
+	char worker;		/*!< non-zero if a worker thread dispatched this UDP packet, it is handled without netlock */
 	/* Array of offsets into the request string of each SERVICE header*/
 	ptrdiff_t header[SERVICE_MAX_HEADERS];
+	/* Lines of the well-known SERVICE headers, filled in by parse_request() and add_header() */
+	struct sip_header_index index;
 	/* Array of offsets into the request string of each SDP line*/
 	ptrdiff_t line[SERVICE_MAX_LINES];
 	struct tris_str *data;	
@@ -1547,6 +1560,7 @@ struct offered_media {
  * descriptors (dialoglist).
  */
 struct service_pvt {
+	struct sip_dialog_key key;		/*!< Where the shared dialog index finds the Call-ID, must be first */
 	struct service_pvt *next;			/*!< Next dialog in chain */
 	enum invitestates invitestate;		/*!< Track state of SERVICE_INVITEs */
 	int method;				/*!< SERVICE method that opened this dialog */
@@ -1616,13 +1630,13 @@ struct service_pvt {
 	unsigned int serviceoptions;		/*!< Supported SERVICE options on the other end */
 	unsigned int reqserviceoptions;		/*!< Required SERVICE options on the other end */
 	struct tris_codec_pref prefs;		/*!< codec prefs */
-	int capability;				/*!< Special capability (codec) */
-	int jointcapability;			/*!< Supported capability at both ends (codecs) */
-	int peercapability;			/*!< Supported peer capability */
-	int prefcodec;				/*!< Preferred codec (outbound only) */
+	format_t capability;			/*!< Special capability (codec) */
+	format_t jointcapability;		/*!< Supported capability at both ends (codecs) */
+	format_t peercapability;		/*!< Supported peer capability */
+	format_t prefcodec;			/*!< Preferred codec (outbound only) */
 	int noncodeccapability;			/*!< DTMF RFC2833 telephony-event */
 	int jointnoncodeccapability;            /*!< Joint Non codec capability */
-	int redircodecs;			/*!< Redirect codecs */
+	format_t redircodecs;			/*!< Redirect codecs */
 	int maxcallbitrate;			/*!< Maximum Call Bitrate for Video Calls */	
 	int t38_maxdatagram;			/*!< T.38 FaxMaxDatagram override */
 	struct service_proxy *outboundproxy;	/*!< Outbound proxy for this dialog. Use ref_proxy to set this instead of setting it directly*/
@@ -1877,7 +1891,7 @@ struct service_peer {
 	char the_mark;			/*!< moved out of ASTOBJ into struct proper; That which bears the_mark should be deleted! */
 
 	int expire;			/*!<  When to expire this peer registration */
-	int capability;			/*!<  Codec capability */
+	format_t capability;		/*!<  Codec capability */
 	int rtptimeout;			/*!<  RTP timeout */
 	int rtpholdtimeout;		/*!<  RTP Hold Timeout */
 	int rtpkeepalive;		/*!<  Send RTP packets for keepalive */
@@ -2123,23 +2137,18 @@ static int threadt_cmp_cb(void *obj, void *arg, int flags)
 }
 
 /*!
- * \note The only member of the dialog used here callid string
+ * \note Dialogs are found by Call-ID in the index shared by the SIP drivers,
+ * see sip_dialog_index_find().  This container is only walked, so it is
+ * hashed on the address of the dialog to keep unlinking cheap.
  */
 static int dialog_hash_cb(const void *obj, const int flags)
 {
-	const struct service_pvt *pvt = obj;
-
-	return tris_str_case_hash(pvt->callid);
+	return (int) (((uintptr_t) obj >> 4) & INT_MAX);
 }
 
-/*!
- * \note The only member of the dialog used here callid string
- */
 static int dialog_cmp_cb(void *obj, void *arg, int flags)
 {
-	struct service_pvt *pvt = obj, *pvt2 = arg;
-	
-	return !strcasecmp(pvt->callid, pvt2->callid) ? CMP_MATCH | CMP_STOP : 0;
+	return obj == arg ? CMP_MATCH | CMP_STOP : 0;
 }
 
 static int temp_pvt_init(void *);
@@ -2248,7 +2257,7 @@ enum t38_action_flag {
 	in coming releases. */
 
 /*--- PBX interface functions */
-static struct tris_channel *service_request_call(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *service_request_call(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int service_devicestate(void *data);
 static int service_sendtext(struct tris_channel *ast, const char *text);
 static int service_call(struct tris_channel *ast, char *dest, int timeout);
@@ -2272,6 +2281,8 @@ static int service_parse_host(char *line, int lineno, char **hostname, int *port
 
 /*--- Transmitting responses and requests */
 static int servicesock_read(int *id, int fd, short events, void *ignore);
+static void service_workers_start(void);
+static void service_workers_stop(void);
 static int __service_xmit(struct service_pvt *p, struct tris_str *data, int len);
 static int __service_reliable_xmit(struct service_pvt *p, int seqno, int resp, struct tris_str *data, int len, int fatal, int servicemethod);
 static int __transmit_response(struct service_pvt *p, const char *msg, const struct service_request *req, enum xmittype reliable);
@@ -2347,7 +2358,7 @@ static int process_sdp_a_audio(const char *a, struct service_pvt *p, struct tris
 static int process_sdp_a_video(const char *a, struct service_pvt *p, struct tris_rtp *newvideortp, int *last_rtpmap_codec);
 static int process_sdp_a_text(const char *a, struct service_pvt *p, struct tris_rtp *newtextrtp, char *red_fmtp, int *red_num_gen, int *red_data_pt, int *last_rtpmap_codec);
 static int process_sdp_a_image(const char *a, struct service_pvt *p);
-static void add_codec_to_sdp(const struct service_pvt *p, int codec,
+static void add_codec_to_sdp(const struct service_pvt *p, format_t codec,
 			     struct tris_str **m_buf, struct tris_str **a_buf,
 			     int debug, int *min_packet_size);
 static void add_noncodec_to_sdp(const struct service_pvt *p, int format,
@@ -2546,19 +2557,13 @@ static const char *get_header(const struct service_request *req, const char *nam
 static const char *referstatus2str(enum referstatus rstatus) attribute_pure;
 static int method_match(enum servicemethod id, const char *name);
 static void parse_copy(struct service_request *dst, const struct service_request *src);
-static char *get_in_brackets(char *tmp);
-static const char *find_alias(const char *name, const char *_default);
 static const char *__get_header(const struct service_request *req, const char *name, int *start);
-static int lws2sws(char *msgbuf, int len);
 static void extract_uri(struct service_pvt *p, struct service_request *req);
-static char *remove_uri_parameters(char *uri);
 static int get_refer_info(struct service_pvt *transferer, struct service_request *outgoing_req);
 static int get_also_info(struct service_pvt *p, struct service_request *oreq);
 static int parse_ok_contact(struct service_pvt *pvt, struct service_request *req);
 static int set_address_from_contact(struct service_pvt *pvt);
 static void check_via(struct service_pvt *p, struct service_request *req);
-static char *get_calleridname(const char *input, char *output, size_t outputsize);
-static int get_rpid_num(const char *input, char *output, int maxlen);
 static int get_rdnis(struct service_pvt *p, struct service_request *oreq);
 static int get_destination(struct service_pvt *p, struct service_request *oreq);
 static int get_msg_text(char *buf, int len, struct service_request *req, int addnewline);
@@ -2580,10 +2585,8 @@ static const struct sockaddr_in *service_real_dst(const struct service_pvt *p);
 static void build_via(struct service_pvt *p);
 static int create_addr_from_peer(struct service_pvt *r, struct service_peer *peer);
 static int create_addr(struct service_pvt *dialog, const char *opeer, struct sockaddr_in *sin, int newdialog);
-static char *generate_random_string(char *buf, size_t size);
 static void build_callid_pvt(struct service_pvt *pvt);
 static void build_callid_registry(struct service_registry *reg, struct in_addr ourip, const char *fromdomain);
-static void make_our_tag(char *tagbuf, size_t len);
 static int add_header(struct service_request *req, const char *var, const char *value);
 static int add_header_contentLength(struct service_request *req, int len);
 static int add_line(struct service_request *req, const char *line);
@@ -2623,11 +2626,11 @@ static int handle_response_register(struct service_pvt *p, int resp, char *rest,
 static void handle_response(struct service_pvt *p, int resp, char *rest, struct service_request *req, int seqno);
 
 /*----- RTP interface functions */
-static int service_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp,  struct tris_rtp *trtp, int codecs, int nat_active);
+static int service_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp,  struct tris_rtp *trtp, format_t codecs, int nat_active);
 static enum tris_rtp_get_result service_get_rtp_peer(struct tris_channel *chan, struct tris_rtp **rtp);
 static enum tris_rtp_get_result service_get_vrtp_peer(struct tris_channel *chan, struct tris_rtp **rtp);
 static enum tris_rtp_get_result service_get_trtp_peer(struct tris_channel *chan, struct tris_rtp **rtp);
-static int service_get_codec(struct tris_channel *chan);
+static format_t service_get_codec(struct tris_channel *chan);
 static struct tris_frame *service_rtp_read(struct tris_channel *ast, struct service_pvt *p, int *faxdetect);
 
 /*------ T38 Support --------- */
@@ -3171,6 +3174,7 @@ static void *dialog_unlink_all(struct service_pvt *dialog, int lockowner, int lo
 	dialog_ref(dialog, "Let's bump the count in the unlink so it doesn't accidentally become dead before we are done");
 
 	ao2_t_unlink(dialogs, dialog, "unlinking dialog via ao2_unlink");
+	sip_dialog_index_unlink(dialog);
 
 	/* Unlink us from the owner (channel) if we have one */
 	if (dialog->owner) {
@@ -3313,20 +3317,6 @@ static int proxy_update(struct service_proxy *proxy)
 	return TRUE;
 }
 
-/*! \brief converts ascii port to int representation. If no
- *  pt buffer is provided or the pt has errors when being converted
- *  to an int value, the port provided as the standard is used.
- */
-static int port_str2int(const char *pt, unsigned int standard)
-{
-	int port = standard;
-	if (tris_strlen_zero(pt) || (sscanf(pt, "%30d", &port) != 1) || (port < 1) || (port > 65535)) {
-		port = standard;
-	}
-
-	return port;
-}
-
 /*! \brief Allocate and initialize service proxy */
 static struct service_proxy *proxy_allocate(char *name, char *port, int force)
 {
@@ -3341,7 +3331,7 @@ static struct service_proxy *proxy_allocate(char *name, char *port, int force)
 		return NULL;
 	proxy->force = force;
 	tris_copy_string(proxy->name, name, sizeof(proxy->name));
-	proxy->ip.sin_port = htons(port_str2int(port, STANDARD_SERVICE_PORT));
+	proxy->ip.sin_port = htons(sip_port_str2int(port, STANDARD_SERVICE_PORT));
 	proxy_update(proxy);
 	return proxy;
 }
@@ -3573,7 +3563,7 @@ static int __service_xmit(struct service_pvt *p, struct tris_str *data, int len)
 		return XMIT_ERROR;
 
 	if (p->socket.type == SERVICE_TRANSPORT_UDP) {
-		res = sendto(p->socket.fd, data->str, len, 0, (const struct sockaddr *)dst, sizeof(struct sockaddr_in));
+		res = sip_udp_sendto(p->socket.fd, data->str, len, dst, &servicesock_stats);
 	} else if (p->socket.tcptls_session) {
 		res = service_tcptls_write(p->socket.tcptls_session, data->str, len);
 	} else {
@@ -4321,168 +4311,6 @@ static int service_queryoption(struct tris_channel *chan, int option, void *data
 	return res;
 }
 
-/*! \brief Locate closing quote in a string, skipping escaped quotes.
- * optionally with a limit on the search.
- * start must be past the first quote.
- */
-static const char *find_closing_quote(const char *start, const char *lim)
-{
-	char last_char = '\0';
-	const char *s;
-	for (s = start; *s && s != lim; last_char = *s++) {
-		if (*s == '"' && last_char != '\\')
-			break;
-	}
-	return s;
-}
-
-/*! \brief Pick out text in brackets from character string
-	\return pointer to terminated stripped string
-	\param tmp input string that will be modified
-	Examples:
-\verbatim
-	"foo" <bar>	valid input, returns bar
-	foo		returns the whole string
-	< "foo ... >	returns the string between brackets
-	< "foo...	bogus (missing closing bracket), returns the whole string
-			XXX maybe should still skip the opening bracket
-\endverbatim
- */
-static char *get_in_brackets(char *tmp)
-{
-	const char *parse = tmp;
-	char *first_bracket;
-
-	/*
-	 * Skip any quoted text until we find the part in brackets.
-	* On any error give up and return the full string.
-	*/
-	while ( (first_bracket = strchr(parse, '<')) ) {
-		char *first_quote = strchr(parse, '"');
-
-		if (!first_quote || first_quote > first_bracket)
-			break; /* no need to look at quoted part */
-		/* the bracket is within quotes, so ignore it */
-		parse = find_closing_quote(first_quote + 1, NULL);
-		if (!*parse) { /* not found, return full string ? */
-			/* XXX or be robust and return in-bracket part ? */
-			tris_log(LOG_WARNING, "No closing quote found in '%s'\n", tmp);
-			break;
-		}
-		parse++;
-	}
-	if (first_bracket) {
-		char *second_bracket = strchr(first_bracket + 1, '>');
-		if (second_bracket) {
-			*second_bracket = '\0';
-			tmp = first_bracket + 1;
-		} else {
-			tris_log(LOG_WARNING, "No closing bracket found in '%s'\n", tmp);
-		}
-	}
-	
-	return tmp;
-}
-
-/*! \brief * parses a URI in its components.
- *
- * \note 
- * - If scheme is specified, drop it from the top.
- * - If a component is not requested, do not split around it.
- * - Multiple scheme's can be specified ',' delimited. ex: "sip:,sips:"
- *
- * This means that if we don't have domain, we cannot split
- * name:pass and domain:port.
- * It is safe to call with ret_name, pass, domain, port
- * pointing all to the same place.
- * Init pointers to empty string so we never get NULL dereferencing.
- * Overwrites the string.
- * return 0 on success, other values on error.
- * \verbatim 
- * general form we are expecting is service[s]:username[:password][;parameter]@host[:port][;...] 
- * \endverbatim
- * 
- */
-static int parse_uri(char *uri, const char *scheme,
-	char **ret_name, char **pass, char **domain, char **port, char **options, char **transport)
-{
-	char *name = NULL;
-	int error = 0;
-
-	/* init field as required */
-	if (pass)
-		*pass = "";
-	if (port)
-		*port = "";
-	if (scheme) {
-		int l;
-		char *scheme2 = tris_strdupa(scheme);
-		char *cur = strsep(&scheme2, ",");
-		for (; !tris_strlen_zero(cur); cur = strsep(&scheme2, ",")) {
-			l = strlen(cur);
-			if (!strncasecmp(uri, cur, l)) {
-				uri += l;
-				break;
-			}
-		}
-		if (tris_strlen_zero(cur)) {
-			tris_debug(1, "No supported scheme found in '%s' using the scheme[s] %s\n", uri, scheme);
-			error = -1;
-		}
-	}
-	if (transport) {
-		char *t, *type = "";
-		*transport = "";
-		if ((t = strstr(uri, "transport="))) {
-			strsep(&t, "=");
-			if ((type = strsep(&t, ";"))) {
-				*transport = type;
-			}
-		}
-	}
-
-	if (!domain) {
-		/* if we don't want to split around domain, keep everything as a name,
-		 * so we need to do nothing here, except remember why.
-		 */
-	} else {
-		/* store the result in a temp. variable to avoid it being
-		 * overwritten if arguments point to the same place.
-		 */
-		char *c, *dom = "";
-
-		if ((c = strchr(uri, '@')) == NULL) {
-			/* domain-only URI, according to the SERVICE RFC. */
-			dom = uri;
-			name = "";
-		} else {
-			*c++ = '\0';
-			dom = c;
-			name = uri;
-		}
-
-		/* Remove options in domain and name */
-		dom = strsep(&dom, ";");
-		name = strsep(&name, ";");
-
-		if (port && (c = strchr(dom, ':'))) { /* Remove :port */
-			*c++ = '\0';
-			*port = c;
-		}
-		if (pass && (c = strchr(name, ':'))) {	/* user:password */
-			*c++ = '\0';
-			*pass = c;
-		}
-		*domain = dom;
-	}
-	if (ret_name)	/* same as for domain, store the result only at the end */
-		*ret_name = name;
-	if (options)
-		*options = uri ? uri : "";
-
-	return error;
-}
-
 /*! \brief Send message with Access-URL header, if this is an HTML URL only! */
 static int service_sendhtml(struct tris_channel *chan, int subclass, const char *data, int datalen)
 {
@@ -5216,9 +5044,9 @@ static int create_addr_from_peer(struct service_pvt *dialog, struct service_peer
 			c = strchr(tmpcall, '@');
 			if (c) {
 				*c = '\0';
-				ao2_t_unlink(dialogs, dialog, "About to change the callid -- remove the old name");
+				sip_dialog_index_unlink(dialog);
 				tris_string_field_build(dialog, callid, "%s@%s", tmpcall, peer->fromdomain);
-				ao2_t_link(dialogs, dialog, "New dialog callid -- inserted back into table");
+				sip_dialog_index_link(dialog);
 			}
 		}
 	}
@@ -5328,7 +5156,7 @@ static int create_addr(struct service_pvt *dialog, const char *opeer, struct soc
 		/* This address should be updated using dnsmgr */
 		memcpy(&dialog->sa.sin_addr, &sin->sin_addr, sizeof(dialog->sa.sin_addr));
 		if (!sin->sin_port) {
-			portno = port_str2int(port, (dialog->socket.type == SERVICE_TRANSPORT_TLS) ? STANDARD_TLS_PORT : STANDARD_SERVICE_PORT);
+			portno = sip_port_str2int(port, (dialog->socket.type == SERVICE_TRANSPORT_TLS) ? STANDARD_TLS_PORT : STANDARD_SERVICE_PORT);
 		} else {
 			portno = ntohs(sin->sin_port);
 		}
@@ -5355,7 +5183,7 @@ static int create_addr(struct service_pvt *dialog, const char *opeer, struct soc
 			}
 		}
 	 	if (!portno)
-			portno = port_str2int(port, (dialog->socket.type == SERVICE_TRANSPORT_TLS) ? STANDARD_TLS_PORT : STANDARD_SERVICE_PORT);
+			portno = sip_port_str2int(port, (dialog->socket.type == SERVICE_TRANSPORT_TLS) ? STANDARD_TLS_PORT : STANDARD_SERVICE_PORT);
 		hp = tris_gethostbyname(hostn, &ahp);
 		if (!hp) {
 			tris_log(LOG_WARNING, "No such host: %s\n", peername);
@@ -6223,7 +6051,7 @@ static int service_hangup(struct tris_channel *ast)
 /*! \brief Try setting codec suggested by the SERVICE_CODEC channel variable */
 static void try_suggested_service_codec(struct service_pvt *p)
 {
-	int fmt;
+	format_t fmt;
 	const char *codec;
 
 	codec = pbx_builtin_getvar_helper(p->owner, "SERVICE_CODEC");
@@ -6274,14 +6102,14 @@ static int service_write(struct tris_channel *ast, struct tris_frame *frame)
 	case TRIS_FRAME_VOICE:
 		if (!(frame->subclass & ast->nativeformats)) {
 			char s1[512], s2[512], s3[512];
-			tris_log(LOG_WARNING, "Asked to transmit frame type %d, while native formats is %s(%d) read/write = %s(%d)/%s(%d)\n",
-				frame->subclass, 
+			tris_log(LOG_WARNING, "Asked to transmit frame type %lld, while native formats is %s(%lld) read/write = %s(%lld)/%s(%lld)\n",
+				(long long) frame->subclass, 
 				tris_getformatname_multiple(s1, sizeof(s1) - 1, ast->nativeformats & TRIS_FORMAT_AUDIO_MASK),
-				ast->nativeformats & TRIS_FORMAT_AUDIO_MASK,
+				(long long) (ast->nativeformats & TRIS_FORMAT_AUDIO_MASK),
 				tris_getformatname_multiple(s2, sizeof(s2) - 1, ast->readformat),
-				ast->readformat,
+				(long long) ast->readformat,
 				tris_getformatname_multiple(s3, sizeof(s3) - 1, ast->writeformat),
-				ast->writeformat);
+				(long long) ast->writeformat);
 			return 0;
 		}
 		if (p) {
@@ -6760,12 +6588,12 @@ static struct tris_channel *service_new(struct service_pvt *i, int state, const
 {
 	struct tris_channel *tmp;
 	struct tris_variable *v = NULL;
-	int fmt;
-	int what;
-	int video;
-	int text;
-	int needvideo = 0;
-	int needtext = 0;
+	format_t fmt;
+	format_t what;
+	format_t video;
+	format_t text;
+	format_t needvideo = 0;
+	format_t needtext = 0;
 	char buf[SERVICEBUFSIZE];
 	char *decoded_exten;
 
@@ -6958,15 +6786,6 @@ static struct tris_channel *service_new(struct service_pvt *i, int state, const
 	return tmp;
 }
 
-/*! \brief Reads one line of SERVICE message body */
-static char *get_body_by_line(const char *line, const char *name, int nameLen, char delimiter)
-{
-	if (!strncasecmp(line, name, nameLen) && line[nameLen] == delimiter)
-		return tris_skip_blanks(line + nameLen + 1);
-
-	return "";
-}
-
 /*! \brief Lookup 'name' in the SDP starting
  * at the 'start' line. Returns the matching line, and 'start'
  * is updated with the next line number.
@@ -6976,7 +6795,7 @@ static const char *get_sdp_iterate(int *start, struct service_request *req, cons
 	int len = strlen(name);
 
 	while (*start < (req->sdp_start + req->sdp_count)) {
-		const char *r = get_body_by_line(REQ_OFFSET_TO_STR(req, line[(*start)++]), name, len, '=');
+		const char *r = sip_get_body_by_line(REQ_OFFSET_TO_STR(req, line[(*start)++]), name, len, '=');
 		if (r[0] != '\0')
 			return r;
 	}
@@ -7021,7 +6840,7 @@ static char *get_body(struct service_request *req, char *name, char delimiter)
 	char *r;
 
 	for (x = 0; x < req->lines; x++) {
-		r = get_body_by_line(REQ_OFFSET_TO_STR(req, line[x]), name, len, delimiter);
+		r = sip_get_body_by_line(REQ_OFFSET_TO_STR(req, line[x]), name, len, delimiter);
 		if (r[0] != '\0')
 			return r;
 	}
@@ -7029,48 +6848,23 @@ static char *get_body(struct service_request *req, char *name, char delimiter)
 	return "";
 }
 
-/*! \brief Find compressed SERVICE alias */
-static const char *find_alias(const char *name, const char *_default)
-{
-	/*! \brief Structure for conversion between compressed SERVICE and "normal" SERVICE */
-	static const struct cfalias {
-		char * const fullname;
-		char * const shortname;
-	} aliases[] = {
-		{ "Content-Type",	 "c" },
-		{ "Content-Encoding",	 "e" },
-		{ "From",		 "f" },
-		{ "Call-ID",		 "i" },
-		{ "Contact",		 "m" },
-		{ "Content-Length",	 "l" },
-		{ "Subject",		 "s" },
-		{ "To",			 "t" },
-		{ "Supported",		 "k" },
-		{ "Refer-To",		 "r" },
-		{ "Referred-By",	 "b" },
-		{ "Allow-Events",	 "u" },
-		{ "Event",		 "o" },
-		{ "Via",		 "v" },
-		{ "Accept-Contact",      "a" },
-		{ "Reject-Contact",      "j" },
-		{ "Request-Disposition", "d" },
-		{ "Session-Expires",     "x" },
-		{ "Identity",            "y" },
-		{ "Identity-Info",       "n" },
-	};
-	int x;
-
-	for (x = 0; x < ARRAY_LEN(aliases); x++) {
-		if (!strcasecmp(aliases[x].fullname, name))
-			return aliases[x].shortname;
-	}
-
-	return _default;
-}
-
 static const char *__get_header(const struct service_request *req, const char *name, int *start)
 {
-	int pass;
+	enum sip_header_id id;
+	int x, len;
+
+	if (!name)
+		return "";
+
+	/* The well-known headers were indexed when the message was parsed or built,
+	 * by full and compact name alike */
+	len = strlen(name);
+	if ((id = sip_header_id(name, len)) != SIP_HDR_UNKNOWN) {
+		if ((x = sip_header_index_find(&req->index, id, *start)) < 0)
+			return "";
+		*start = x + 1;
+		return sip_header_value(REQ_OFFSET_TO_STR(req, header[x]));
+	}
 
 	/*
 	 * Technically you can place arbitrary whitespace both before and after the ':' in
@@ -7081,23 +6875,18 @@ static const char *__get_header(const struct service_request *req, const char *n
 	 * Anyways, pedanticservicechecking controls whether we allow spaces before ':',
 	 * and we always allow spaces after that for compatibility.
 	 */
-	for (pass = 0; name && pass < 2;pass++) {
-		int x, len = strlen(name);
-		for (x = *start; x < req->headers; x++) {
-			char *header = REQ_OFFSET_TO_STR(req, header[x]);
-			if (!strncasecmp(header, name, len)) {
-				char *r = header + len;	/* skip name */
-				if (service_cfg.pedanticservicechecking)
-					r = tris_skip_blanks(r);
-
-				if (*r == ':') {
-					*start = x+1;
-					return tris_skip_blanks(r+1);
-				}
+	for (x = *start; x < req->headers; x++) {
+		char *header = REQ_OFFSET_TO_STR(req, header[x]);
+		if (!strncasecmp(header, name, len)) {
+			char *r = header + len;	/* skip name */
+			if (service_cfg.pedanticservicechecking)
+				r = tris_skip_blanks(r);
+
+			if (*r == ':') {
+				*start = x+1;
+				return tris_skip_blanks(r+1);
 			}
 		}
-		if (pass == 0) /* Try aliases */
-			name = find_alias(name, NULL);
 	}
 
 	/* Don't return NULL, so get_header is always a valid pointer */
@@ -7159,7 +6948,7 @@ static struct tris_frame *service_rtp_read(struct tris_channel *ast, struct serv
 	/* Don't forward RFC2833 if we're not supposed to */
 	if (f && (f->frametype == TRIS_FRAME_DTMF_BEGIN || f->frametype == TRIS_FRAME_DTMF_END) &&
 	    (tris_test_flag(&p->flags[0], SERVICE_DTMF) != SERVICE_DTMF_RFC2833)) {
-		tris_debug(1, "Ignoring DTMF (%c) RTP frame because dtmfmode is not RFC2833\n", f->subclass);
+		tris_debug(1, "Ignoring DTMF (%c) RTP frame because dtmfmode is not RFC2833\n", (int) f->subclass);
 		return &tris_null_frame;
 	}
 
@@ -7173,8 +6962,8 @@ static struct tris_frame *service_rtp_read(struct tris_channel *ast, struct serv
 				tris_getformatname(f->subclass), p->owner->name);
 			return &tris_null_frame;
 		}
-		tris_debug(1, "Oooh, format changed to %d %s\n",
-			f->subclass, tris_getformatname(f->subclass));
+		tris_debug(1, "Oooh, format changed to %lld %s\n",
+			(long long) f->subclass, tris_getformatname(f->subclass));
 		p->owner->nativeformats = (p->owner->nativeformats & (TRIS_FORMAT_VIDEO_MASK | TRIS_FORMAT_TEXT_MASK)) | f->subclass;
 		tris_set_read_format(p->owner, p->owner->readformat);
 		tris_set_write_format(p->owner, p->owner->writeformat);
@@ -7195,7 +6984,7 @@ static struct tris_frame *service_rtp_read(struct tris_channel *ast, struct serv
 					p->dsp = NULL;
 				}
 			} else {
-				tris_debug(1, "* Detected inband DTMF '%c'\n", f->subclass);
+				tris_debug(1, "* Detected inband DTMF '%c'\n", (int) f->subclass);
 			}
 		}
 	}
@@ -7203,14 +6992,31 @@ static struct tris_frame *service_rtp_read(struct tris_channel *ast, struct serv
 	return f;
 }
 
-/*! \brief Read SERVICE RTP from channel */
-static struct tris_frame *service_read(struct tris_channel *ast)
+/*! \brief Datagrams read ahead on the RTP or RTCP socket that ast->fdno refers to */
+static int service_rtp_read_pending(struct tris_channel *ast, struct service_pvt *p)
+{
+	switch (ast->fdno) {
+	case 0:
+		return tris_rtp_read_pending(p->rtp);
+	case 1:
+		return tris_rtcp_read_pending(p->rtp);
+	case 2:
+		return tris_rtp_read_pending(p->vrtp);
+	case 3:
+		return tris_rtcp_read_pending(p->vrtp);
+	case 4:
+		return tris_rtp_read_pending(p->trtp);
+	}
+	return 0;
+}
+
+/*! \brief Read one frame, holding back early media and acting on fax detection.
+	Assumes p->lock is already held. */
+static struct tris_frame *service_read_frame(struct tris_channel *ast, struct service_pvt *p)
 {
 	struct tris_frame *fr;
-	struct service_pvt *p = ast->tech_pvt;
 	int faxdetected = FALSE;
 
-	service_pvt_lock(p);
 	fr = service_rtp_read(ast, p, &faxdetected);
 	p->lastrtprx = time(NULL);
 
@@ -7240,25 +7046,35 @@ static struct tris_frame *service_read(struct tris_channel *ast)
 		fr = &tris_null_frame;
 	}
 
-	service_pvt_unlock(p);
-
 	return fr;
 }
 
-
-/*! \brief Generate 32 byte random string for callid's etc */
-static char *generate_random_string(char *buf, size_t size)
+/*! \brief Read SERVICE RTP from channel */
+static struct tris_frame *service_read(struct tris_channel *ast)
 {
-	long val[4];
-	int x;
+	struct tris_frame *fr, *next, *copy = NULL;
+	struct service_pvt *p = ast->tech_pvt;
+
+	service_pvt_lock(p);
+	fr = service_read_frame(ast, p);
 
-	for (x=0; x<4; x++)
-		val[x] = tris_random();
-	snprintf(buf, size, "%08lx%08lx%08lx%08lx", val[0], val[1], val[2], val[3]);
+	/* Datagrams read ahead of this one don't make the socket readable again, so
+	   queue them now. Reading them reuses the buffer fr points into, copy it first. */
+	if (fr && fr != &tris_null_frame && service_rtp_read_pending(ast, p) && (copy = tris_frdup(fr)))
+		fr = copy;
+	if (fr == &tris_null_frame || copy) {
+		while (service_rtp_read_pending(ast, p) && (next = service_read_frame(ast, p))) {
+			if (next != &tris_null_frame)
+				tris_queue_frame(ast, next);
+		}
+	}
 
-	return buf;
+	service_pvt_unlock(p);
+
+	return fr;
 }
 
+
 /*! \brief Build SERVICE Call-ID value for a non-REGISTER transaction */
 static void build_callid_pvt(struct service_pvt *pvt)
 {
@@ -7266,7 +7082,7 @@ static void build_callid_pvt(struct service_pvt *pvt)
 
 	const char *host = S_OR(pvt->fromdomain, tris_inet_ntoa(pvt->ourip.sin_addr));
 	
-	tris_string_field_build(pvt, callid, "%s@%s", generate_random_string(buf, sizeof(buf)), host);
+	tris_string_field_build(pvt, callid, "%s@%s", sip_generate_random_string(buf, sizeof(buf)), host);
 
 }
 
@@ -7277,13 +7093,7 @@ static void build_callid_registry(struct service_registry *reg, struct in_addr o
 
 	const char *host = S_OR(fromdomain, tris_inet_ntoa(ourip));
 
-	tris_string_field_build(reg, callid, "%s@%s", generate_random_string(buf, sizeof(buf)), host);
-}
-
-/*! \brief Make our SERVICE dialog tag */
-static void make_our_tag(char *tagbuf, size_t len)
-{
-	snprintf(tagbuf, len, "as%08lx", tris_random());
+	tris_string_field_build(reg, callid, "%s@%s", sip_generate_random_string(buf, sizeof(buf)), host);
 }
 
 /*! \brief Allocate Session-Timers struct w/in dialog */
@@ -7322,6 +7132,8 @@ static struct service_pvt *service_alloc(tris_string_field callid, struct sockad
 		ao2_t_ref(p, -1, "failed to string_field_init, drop p");
 		return NULL;
 	}
+	p->key.callid = &p->callid;
+	p->key.owner = &service_tech;
 
 	if (req) {
 		set_socket_transport(&p->socket, req->socket.type); /* Later in tris_service_ouraddrfor we need this to choose the right ip and port for the specific transport */
@@ -7364,7 +7176,7 @@ static struct service_pvt *service_alloc(tris_string_field callid, struct sockad
 	p->do_history = recordhistory;
 
 	p->branch = tris_random();	
-	make_our_tag(p->tag, sizeof(p->tag));
+	sip_make_our_tag(p->tag, sizeof(p->tag));
 	p->ocseq = INITIAL_CSEQ;
 
 	if (service_methods[intended_method].need_rtp) {
@@ -7390,6 +7202,7 @@ static struct service_pvt *service_alloc(tris_string_field callid, struct sockad
 			p->t38_maxdatagram = global_t38_maxdatagram;
 		}
 		tris_rtp_setqos(p->rtp, global_tos_audio, global_cos_audio, "SERVICE RTP");
+		tris_rtp_set_readahead(p->rtp);
 		tris_rtp_setdtmf(p->rtp, tris_test_flag(&p->flags[0], SERVICE_DTMF) == SERVICE_DTMF_RFC2833);
 		tris_rtp_setdtmfcompensate(p->rtp, tris_test_flag(&p->flags[1], SERVICE_PAGE2_RFC2833_COMPENSATE));
 		tris_rtp_set_rtptimeout(p->rtp, global_rtptimeout);
@@ -7397,6 +7210,7 @@ static struct service_pvt *service_alloc(tris_string_field callid, struct sockad
 		tris_rtp_set_rtpkeepalive(p->rtp, global_rtpkeepalive);
 		if (p->vrtp) {
 			tris_rtp_setqos(p->vrtp, global_tos_video, global_cos_video, "SERVICE VRTP");
+			tris_rtp_set_readahead(p->vrtp);
 			tris_rtp_setdtmf(p->vrtp, 0);
 			tris_rtp_setdtmfcompensate(p->vrtp, 0);
 			tris_rtp_set_rtptimeout(p->vrtp, global_rtptimeout);
@@ -7405,6 +7219,7 @@ static struct service_pvt *service_alloc(tris_string_field callid, struct sockad
 		}
 		if (p->trtp) {
 			tris_rtp_setqos(p->trtp, global_tos_text, global_cos_text, "SERVICE TRTP");
+			tris_rtp_set_readahead(p->trtp);
 			tris_rtp_setdtmf(p->trtp, 0);
 			tris_rtp_setdtmfcompensate(p->trtp, 0);
 		}
@@ -7451,6 +7266,7 @@ static struct service_pvt *service_alloc(tris_string_field callid, struct sockad
 	/* Add to active dialog list */
 
 	ao2_t_link(dialogs, p, "link pvt into dialogs table");
+	sip_dialog_index_link(p);
 	
 	p->expireid = tris_sched_add(sched, DEFAULT_CALL_EXPIRE_TIMEOUT, service_expire_timer, dialog_ref(p, "dialog ptr inc when SCHED_REPLACE add succeeded"));
 
@@ -7470,8 +7286,11 @@ struct find_call_cb_arg {
 /*!
  * code to determine whether this is the pvt that we are looking for.
  * Return FALSE if not found, true otherwise. p is unlocked.
+ *
+ * \note Only the dialogs hashed into the same bucket as the Call-ID are
+ * visited, so the from/to tag disambiguation is done per bucket.
  */
-static int find_call_cb(void *__pvt, void *__arg, int flags)
+static int find_call_cb(void *__pvt, void *__key, void *__arg, int flags)
 {
 	struct service_pvt *p = __pvt;
 	struct find_call_cb_arg *arg = __arg;
@@ -7564,31 +7383,21 @@ static struct service_pvt *find_call(struct service_request *req, struct sockadd
 //	}
 
 restartsearch:
-/*	if (!service_cfg.pedanticservicechecking) {
-		struct service_pvt tmp_dialog = {
-			.callid = callid,
-		};			
-		service_pvt_ptr = ao2_t_find(dialogs, &tmp_dialog, OBJ_POINTER, "ao2_find in dialogs");
-		if (service_pvt_ptr) {  // well, if we don't find it-- what IS in there? 
-			// Found the call 
-			service_pvt_lock(service_pvt_ptr);
-			return service_pvt_ptr;
-		}
-	} else { *//* in pedantic mode! -- do the fancy linear search */
-		ao2_lock(dialogs);
-		p = ao2_t_callback(dialogs, 0 /* single, data */, find_call_cb, &arg, "pedantic linear search for dialog");
-		if (p) {
-			if (service_pvt_trylock(p)) {
-				ao2_unlock(dialogs);
-				usleep(1);
-				p = dialog_unref(p, "pedantic linear search for dialog unref to restart search");
-				goto restartsearch;
-			}
+	/* The shared dialog index is hashed on the Call-ID, so only the dialogs
+	   sharing its bucket are compared; the tags are checked in find_call_cb() */
+	ao2_lock(dialogs);
+	p = sip_dialog_index_find(&service_tech, callid, find_call_cb, &arg);
+	if (p) {
+		if (service_pvt_trylock(p)) {
 			ao2_unlock(dialogs);
-			return p;
+			usleep(1);
+			p = dialog_unref(p, "hashed search for dialog unref to restart search");
+			goto restartsearch;
 		}
 		ao2_unlock(dialogs);
-//	}
+		return p;
+	}
+	ao2_unlock(dialogs);
  
 	/* See if the method is capable of creating a dialog */
 	if (service_methods[intended_method].can_create == CAN_CREATE_DIALOG) {
@@ -7767,7 +7576,7 @@ static int service_register(const char *value, int lineno)
 	TRIS_NONSTANDARD_RAW_ARGS(host3, host2.hostpart, ':');
 
 	if (host3.port) {
-		if (!(portnum = port_str2int(host3.port, 0))) {
+		if (!(portnum = sip_port_str2int(host3.port, 0))) {
 			tris_log(LOG_NOTICE, "'%s' is not a valid port number on line %d of service.conf. using default.\n", host3.port, lineno);
 		}
 	}
@@ -7900,140 +7709,27 @@ static int service_subscribe_mwi(const char *value, int lineno)
 	return 0;
 }
 
-/*! \brief  Parse multiline SERVICE headers into one header
-	This is enabled if pedanticservicechecking is enabled */
-static int lws2sws(char *msgbuf, int len) 
-{
-	int h = 0, t = 0; 
-	int lws = 0; 
-
-	for (; h < len;) { 
-		/* Eliminate all CRs */ 
-		if (msgbuf[h] == '\r') { 
-			h++; 
-			continue; 
-		} 
-		/* Check for end-of-line */ 
-		if (msgbuf[h] == '\n') { 
-			/* Check for end-of-message */ 
-			if (h + 1 == len) 
-				break; 
-			/* Check for a continuation line */ 
-			if (msgbuf[h + 1] == ' ' || msgbuf[h + 1] == '\t') { 
-				/* Merge continuation line */ 
-				h++; 
-				continue; 
-			} 
-			/* Propagate LF and start new line */ 
-			msgbuf[t++] = msgbuf[h++]; 
-			lws = 0;
-			continue; 
-		} 
-		if (msgbuf[h] == ' ' || msgbuf[h] == '\t') { 
-			if (lws) { 
-				h++; 
-				continue; 
-			} 
-			msgbuf[t++] = msgbuf[h++]; 
-			lws = 1; 
-			continue; 
-		} 
-		msgbuf[t++] = msgbuf[h++]; 
-		if (lws) 
-			lws = 0; 
-	} 
-	msgbuf[t] = '\0'; 
-	return t; 
-}
-
 /*! \brief Parse a SERVICE message 
 	\note this function is used both on incoming and outgoing packets
 */
 static int parse_request(struct service_request *req)
 {
-	char *c = req->data->str;
-	ptrdiff_t *dst = req->header;
-	int i = 0, lim = SERVICE_MAX_HEADERS - 1;
-	unsigned int skipping_headers = 0;
-	ptrdiff_t current_header_offset = 0;
-	char *previous_header = "";
+	int x;
 
-	req->header[0] = 0;
-	req->headers = -1;	/* mark that we are working on the header */
-	for (; *c; c++) {
-		if (*c == '\r') {		/* remove \r */
-			*c = '\0';
-		} else if (*c == '\n') { 	/* end of this line */
-			*c = '\0';
-			current_header_offset = (c + 1) - req->data->str;
-			previous_header = req->data->str + dst[i];
-			if (skipping_headers) {
-				/* check to see if this line is blank; if so, turn off
-				   the skipping flag, so the next line will be processed
-				   as a body line */
-				if (tris_strlen_zero(previous_header)) {
-					skipping_headers = 0;
-				}
-				dst[i] = current_header_offset; /* record start of next line */
-				continue;
-			}
-			if (servicedebug) {
-				tris_debug(4, "%7s %2d [%3d]: %s\n",
-					  req->headers < 0 ? "Header" : "Body",
-					  i, (int) strlen(previous_header), previous_header);
-			}
-			if (tris_strlen_zero(previous_header) && req->headers < 0) {
-				req->headers = i;	/* record number of header lines */
-				dst = req->line;	/* start working on the body */
-				i = 0;
-				lim = SERVICE_MAX_LINES - 1;
-			} else {	/* move to next line, check for overflows */
-				if (i++ == lim) {
-					/* if we're processing headers, then skip any remaining
-					   headers and move on to processing the body, otherwise
-					   we're done */
-					if (req->headers != -1) {
-						break;
-					} else {
-						req->headers = i;
-						dst = req->line;
-						i = 0;
-						lim = SERVICE_MAX_LINES - 1;
-						skipping_headers = 1;
-					}
-				}
-			}
-			dst[i] = current_header_offset; /* record start of next line */
-		}
+	if (sip_parse_lines(req->data->str, req->header, SERVICE_MAX_HEADERS, &req->headers,
+			req->line, SERVICE_MAX_LINES, &req->lines, &req->index, service_cfg.pedanticservicechecking)) {
+		tris_log(LOG_WARNING, "Too many lines in SERVICE message, ignoring the rest\n");
 	}
 
-	/* Check for last header or body line without CRLF. The RFC for SDP requires CRLF,
-	   but since some devices send without, we'll be generous in what we accept. However,
-	   if we've already reached the maximum number of lines for portion of the message
-	   we were parsing, we can't accept any more, so just ignore it.
-	*/
-	previous_header = req->data->str + dst[i];
-	if ((i < lim) && !tris_strlen_zero(previous_header)) {
-		if (servicedebug) {
-			tris_debug(4, "%7s %2d [%3d]: %s\n",
-				  req->headers < 0 ? "Header" : "Body",
-				  i, (int) strlen(previous_header), previous_header );
+	if (servicedebug) {
+		for (x = 0; x < req->headers; x++) {
+			tris_debug(4, "%7s %2d [%3d]: %s\n", "Header", x,
+				  (int) strlen(REQ_OFFSET_TO_STR(req, header[x])), REQ_OFFSET_TO_STR(req, header[x]));
+		}
+		for (x = 0; x < req->lines; x++) {
+			tris_debug(4, "%7s %2d [%3d]: %s\n", "Body", x,
+				  (int) strlen(REQ_OFFSET_TO_STR(req, line[x])), REQ_OFFSET_TO_STR(req, line[x]));
 		}
-		i++;
-	}
-
-	/* update count of header or body lines */
-	if (req->headers >= 0) {	/* we are in the body */
-		req->lines = i;
-	} else {			/* no body */
-		req->headers = i;
-		req->lines = 0;
-		/* req->data->used will be a NULL byte */
-		req->line[0] = tris_str_strlen(req->data);
-	}
-
-	if (*c) {
-		tris_log(LOG_WARNING, "Too many lines, skipping <%s>\n", c);
 	}
 
 	/* Split up the first line parts */
@@ -8238,13 +7934,12 @@ static int process_sdp(struct service_pvt *p, struct service_request *req, int t
 	struct sockaddr_in tsin;	/*!< text socket address */
 
 	/* Peer capability is the capability in the SDP, non codec is RFC2833 DTMF (101) */	
-	int peercapability = 0, peernoncodeccapability = 0;
-	int vpeercapability = 0, vpeernoncodeccapability = 0;
-	int tpeercapability = 0, tpeernoncodeccapability = 0;
+	format_t peercapability = 0, vpeercapability = 0, tpeercapability = 0;
+	int peernoncodeccapability = 0, vpeernoncodeccapability = 0, tpeernoncodeccapability = 0;
 
 	struct tris_rtp *newaudiortp, *newvideortp, *newtextrtp;
-	int newjointcapability;				/* Negotiated capability */
-	int newpeercapability;
+	format_t newjointcapability;			/* Negotiated capability */
+	format_t newpeercapability;
 	int newnoncodeccapability;
 
 	const char *codecs;
@@ -8917,13 +8612,13 @@ static int process_sdp_a_audio(const char *a, struct service_pvt *p, struct tris
 		if (framing && p->autoframing) {
 			struct tris_codec_pref *pref = tris_rtp_codec_getpref(p->rtp);
 			int codec_n;
-			int format = 0;
+			format_t format = 0;
 			for (codec_n = 0; codec_n < MAX_RTP_PT; codec_n++) {
 				format = tris_rtp_codec_getformat(codec_n);
 				if (!format)	/* non-codec or not found */
 					continue;
 				if (option_debug)
-					tris_log(LOG_DEBUG, "Setting framing for %d to %ld\n", format, framing);
+					tris_log(LOG_DEBUG, "Setting framing for %s to %ld\n", tris_getformatname(format), framing);
 				tris_codec_pref_setsize(pref, format, framing);
 			}
 			tris_rtp_codec_setpref(p->rtp, pref);
@@ -8976,6 +8671,10 @@ static int process_sdp_a_audio(const char *a, struct service_pvt *p, struct tris
 					}
 				}
 				break;
+			case TRIS_FORMAT_OPUS:
+				/* Any bandwidth and bitrate the far end picks can be decoded */
+				found = TRUE;
+				break;
 			}
 		}
 	}
@@ -9189,11 +8888,12 @@ static int add_header(struct service_request *req, const char *var, const char *
 	}
 
 	if (service_cfg.compactheaders) {
-		var = find_alias(var, var);
+		var = sip_header_compact_name(var, var);
 	}
 
 	tris_str_append(&req->data, 0, "%s: %s\r\n", var, value);
 	req->header[req->headers] = req->len;
+	sip_header_index_add(&req->index, req->headers, sip_header_id(var, strlen(var)));
 
 	req->len = tris_str_strlen(req->data);
 	req->headers++;
@@ -9688,8 +9388,8 @@ static int reqprep(struct service_request *req, struct service_pvt *p, int servi
 		/* We have no URI, use To: or From:  header as URI (depending on direction) */
 		tris_copy_string(stripped, get_header(orig, is_outbound ? "To" : "From"),
 				sizeof(stripped));
-		n = get_in_brackets(stripped);
-		c = remove_uri_parameters(n);
+		n = sip_get_in_brackets(stripped);
+		c = sip_remove_uri_parameters(n);
 	}	
 	init_req(req, servicemethod, c);
 
@@ -9834,7 +9534,7 @@ static int transmit_response_using_temp(tris_string_field callid, struct sockadd
 	}
 
 	p->branch = tris_random();
-	make_our_tag(p->tag, sizeof(p->tag));
+	sip_make_our_tag(p->tag, sizeof(p->tag));
 	p->ocseq = INITIAL_CSEQ;
 
 	if (useglobal_nat && sin) {
@@ -10029,7 +9729,7 @@ static int add_vidupdate(struct service_request *req)
 }
 
 /*! \brief Add codec offer to SDP offer/answer body in INVITE or 200 OK */
-static void add_codec_to_sdp(const struct service_pvt *p, int codec,
+static void add_codec_to_sdp(const struct service_pvt *p, format_t codec,
 			     struct tris_str **m_buf, struct tris_str **a_buf,
 			     int debug, int *min_packet_size)
 {
@@ -10038,7 +9738,7 @@ static void add_codec_to_sdp(const struct service_pvt *p, int codec,
 
 
 	if (debug)
-		tris_verbose("Adding codec 0x%x (%s) to SDP\n", codec, tris_getformatname(codec));
+		tris_verbose("Adding codec 0x%llx (%s) to SDP\n", (unsigned long long) codec, tris_getformatname(codec));
 	if ((rtp_code = tris_rtp_lookup_code(p->rtp, 1, codec)) == -1)
 		return;
 
@@ -10048,10 +9748,12 @@ static void add_codec_to_sdp(const struct service_pvt *p, int codec,
 	} else /* I dont see how you couldn't have p->rtp, but good to check for and error out if not there like earlier code */
 		return;
 	tris_str_append(m_buf, 0, " %d", rtp_code);
-	tris_str_append(a_buf, 0, "a=rtpmap:%d %s/%d\r\n", rtp_code,
+	tris_str_append(a_buf, 0, "a=rtpmap:%d %s/%d%s\r\n", rtp_code,
 		       tris_rtp_lookup_mime_subtype(1, codec,
 						   tris_test_flag(&p->flags[0], SERVICE_G726_NONSTANDARD) ? TRIS_RTP_OPT_G726_NONSTANDARD : 0),
-		       tris_rtp_lookup_sample_rate(1, codec));
+		       tris_rtp_lookup_sample_rate(1, codec),
+		       /* RFC 7587 always lists Opus as stereo, the fmtp says what is sent */
+		       codec == TRIS_FORMAT_OPUS ? "/2" : "");
 
 	switch (codec) {
 	case TRIS_FORMAT_G729A:
@@ -10074,6 +9776,10 @@ static void add_codec_to_sdp(const struct service_pvt *p, int codec,
 		/* Indicate that we only expect 48Kbps */
 		tris_str_append(a_buf, 0, "a=fmtp:%d bitrate=48000\r\n", rtp_code);
 		break;
+	case TRIS_FORMAT_OPUS:
+		/* We decode wideband and use in-band FEC to recover lost packets */
+		tris_str_append(a_buf, 0, "a=fmtp:%d maxplaybackrate=16000; sprop-maxcapturerate=16000; useinbandfec=1\r\n", rtp_code);
+		break;
 	}
 
 	if (fmt.cur_ms && (fmt.cur_ms < *min_packet_size))
@@ -10086,7 +9792,7 @@ static void add_codec_to_sdp(const struct service_pvt *p, int codec,
 
 /*! \brief Add video codec offer to SDP offer/answer body in INVITE or 200 OK */
 /* This is different to the audio one now so we can add more caps later */
-static void add_vcodec_to_sdp(const struct service_pvt *p, int codec,
+static void add_vcodec_to_sdp(const struct service_pvt *p, format_t codec,
 			     struct tris_str **m_buf, struct tris_str **a_buf,
 			     int debug, int *min_packet_size)
 {
@@ -10096,7 +9802,7 @@ static void add_vcodec_to_sdp(const struct service_pvt *p, int codec,
 		return;
 
 	if (debug)
-		tris_verbose("Adding video codec 0x%x (%s) to SDP\n", codec, tris_getformatname(codec));
+		tris_verbose("Adding video codec 0x%llx (%s) to SDP\n", (unsigned long long) codec, tris_getformatname(codec));
 
 	if ((rtp_code = tris_rtp_lookup_code(p->vrtp, 1, codec)) == -1)
 		return;
@@ -10109,7 +9815,7 @@ static void add_vcodec_to_sdp(const struct service_pvt *p, int codec,
 }
 
 /*! \brief Add text codec offer to SDP offer/answer body in INVITE or 200 OK */
-static void add_tcodec_to_sdp(const struct service_pvt *p, int codec,
+static void add_tcodec_to_sdp(const struct service_pvt *p, format_t codec,
 			     struct tris_str **m_buf, struct tris_str **a_buf,
 			     int debug, int *min_packet_size)
 {
@@ -10119,7 +9825,7 @@ static void add_tcodec_to_sdp(const struct service_pvt *p, int codec,
 		return;
 
 	if (debug)
-		tris_verbose("Adding text codec 0x%x (%s) to SDP\n", codec, tris_getformatname(codec));
+		tris_verbose("Adding text codec 0x%llx (%s) to SDP\n", (unsigned long long) codec, tris_getformatname(codec));
 
 	if ((rtp_code = tris_rtp_lookup_code(p->trtp, 1, codec)) == -1)
 		return;
@@ -10226,7 +9932,7 @@ static void get_our_media_address(struct service_pvt *p, int needvideo,
 static enum service_result add_sdp(struct service_request *resp, struct service_pvt *p, int oldsdp, int add_audio, int add_t38)
 {
 	int len = 0;
-	int alreadysent = 0;
+	format_t alreadysent = 0;
 
 	struct sockaddr_in sin;
 	struct sockaddr_in vsin;
@@ -10255,7 +9961,8 @@ static enum service_result add_sdp(struct service_request *resp, struct service_
 	struct tris_str *a_modem = tris_str_alloca(1024); /* Attributes for modem */
 
 	int x;
-	int capability = 0;
+	format_t capability = 0;
+	format_t sendable;
 	int needaudio = FALSE;
 	int needvideo = FALSE;
 	int needtext = FALSE;
@@ -10387,7 +10094,7 @@ static enum service_result add_sdp(struct service_request *resp, struct service_
 		   Note that p->prefcodec can include video codecs, so mask them out
 		*/
 		if (capability & p->prefcodec) {
-			int codec = p->prefcodec & TRIS_FORMAT_AUDIO_MASK;
+			format_t codec = p->prefcodec & TRIS_FORMAT_AUDIO_MASK;
 
 			add_codec_to_sdp(p, codec, &m_audio, &a_audio, debug, &min_audio_packet_size);
 			alreadysent |= codec;
@@ -10395,7 +10102,7 @@ static enum service_result add_sdp(struct service_request *resp, struct service_
 
 		/* Start by sending our preferred audio/video codecs */
 		for (x = 0; x < 32; x++) {
-			int codec;
+			format_t codec;
 
 			if (!(codec = tris_codec_pref_index(&p->prefs, x)))
 				break; 
@@ -10411,19 +10118,26 @@ static enum service_result add_sdp(struct service_request *resp, struct service_
 		}
 
 		/* Now send any other common audio and video codecs, and non-codec formats: */
-		for (x = 1; x <= (needtext ? TRIS_FORMAT_TEXT_MASK : (needvideo ? TRIS_FORMAT_VIDEO_MASK : TRIS_FORMAT_AUDIO_MASK)); x <<= 1) {
-			if (!(capability & x))	/* Codec not requested */
+		sendable = TRIS_FORMAT_AUDIO_MASK;
+		if (needvideo || needtext)
+			sendable |= TRIS_FORMAT_VIDEO_MASK;
+		if (needtext)
+			sendable |= TRIS_FORMAT_TEXT_MASK;
+		for (x = 0; x < 64; x++) {
+			format_t codec = 1ULL << x;
+
+			if (!(capability & sendable & codec))	/* Codec not requested */
 				continue;
 
-			if (alreadysent & x)	/* Already added to SDP */
+			if (alreadysent & codec)	/* Already added to SDP */
 				continue;
 
-			if (x & TRIS_FORMAT_AUDIO_MASK)
-				add_codec_to_sdp(p, x, &m_audio, &a_audio, debug, &min_audio_packet_size);
-			else if (x & TRIS_FORMAT_VIDEO_MASK)
-				add_vcodec_to_sdp(p, x, &m_video, &a_video, debug, &min_video_packet_size);
-			else if (x & TRIS_FORMAT_TEXT_MASK)
-				add_tcodec_to_sdp(p, x, &m_text, &a_text, debug, &min_text_packet_size);
+			if (codec & TRIS_FORMAT_AUDIO_MASK)
+				add_codec_to_sdp(p, codec, &m_audio, &a_audio, debug, &min_audio_packet_size);
+			else if (codec & TRIS_FORMAT_VIDEO_MASK)
+				add_vcodec_to_sdp(p, codec, &m_video, &a_video, debug, &min_video_packet_size);
+			else if (codec & TRIS_FORMAT_TEXT_MASK)
+				add_tcodec_to_sdp(p, codec, &m_text, &a_text, debug, &min_text_packet_size);
 		}
 
 		/* Now add DTMF RFC2833 telephony-event as a codec */
@@ -10737,19 +10451,6 @@ static int transmit_reinvite_with_sdp(struct service_pvt *p, int t38version, int
 	return send_request(p, &req, XMIT_CRITICAL, p->ocseq);
 }
 
-/* \brief Remove URI parameters at end of URI, not in username part though */
-static char *remove_uri_parameters(char *uri)
-{
-	char *atsign;
-	atsign = strchr(uri, '@');	/* First, locate the at sign */
-	if (!atsign)
-		atsign = uri;	/* Ok hostname only, let's stick with the rest */
-	atsign = strchr(atsign, ';');	/* Locate semi colon */
-	if (atsign)
-		*atsign = '\0';	/* Kill at the semi colon */
-	return uri;
-}
-
 /*! \brief Check Contact: URI of SERVICE message */
 static void extract_uri(struct service_pvt *p, struct service_request *req)
 {
@@ -10760,12 +10461,12 @@ static void extract_uri(struct service_pvt *p, struct service_request *req)
     c = strstr(stripped, "sip:");
     if (c != NULL) {
             c+=4;
-            c = get_in_brackets(c);
+            c = sip_get_in_brackets(c);
     }
     else
-		c = get_in_brackets(stripped);
+		c = sip_get_in_brackets(stripped);
 	/* Cut the URI at the at sign after the @, not in the username part */
-//	c = remove_uri_parameters(c);
+//	c = sip_remove_uri_parameters(c);
 	if (!tris_strlen_zero(c))
 		tris_string_field_set(p, uri, c);
 
@@ -11271,7 +10972,9 @@ static int __service_subscribe_mwi_do(struct service_subscription_mwi *mwi)
 	tris_service_ouraddrfor(&mwi->call->sa.sin_addr, &mwi->call->ourip, mwi->call);
 	build_contact(mwi->call);
 	build_via(mwi->call);
+	sip_dialog_index_unlink(mwi->call);
 	build_callid_pvt(mwi->call);
+	sip_dialog_index_link(mwi->call);
 	tris_set_flag(&mwi->call->flags[0], SERVICE_OUTGOING);
 	
 	/* Associate the call with us */
@@ -11376,21 +11079,21 @@ static int transmit_state_notify(struct service_pvt *p, int state, int full, int
 	}
 
 	tris_copy_string(from, get_header(&p->initreq, "From"), sizeof(from));
-	c = get_in_brackets(from);
+	c = sip_get_in_brackets(from);
 	if (strncasecmp(c, "sip:", 4) && strncasecmp(c, "sips:", 5)) {
 		tris_log(LOG_WARNING, "Huh?  Not a SERVICE header (%s)?\n", c);
 		return -1;
 	}
 	
-	mfrom = remove_uri_parameters(c);
+	mfrom = sip_remove_uri_parameters(c);
 
 	tris_copy_string(to, get_header(&p->initreq, "To"), sizeof(to));
-	c = get_in_brackets(to);
+	c = sip_get_in_brackets(to);
 	if (strncasecmp(c, "sip:", 4) && strncasecmp(c, "sips:", 5)) {
 		tris_log(LOG_WARNING, "Huh?  Not a SERVICE header (%s)?\n", c);
 		return -1;
 	}
-	mto = remove_uri_parameters(c);
+	mto = sip_remove_uri_parameters(c);
 
 	reqprep(&req, p, SERVICE_NOTIFY, 0, 1);
 
@@ -11647,9 +11350,9 @@ static int manager_servicenotify(struct mansession *s, const struct message *m)
 	/* Recalculate our side, and recalculate Call ID */
 	tris_service_ouraddrfor(&p->sa.sin_addr, &p->ourip, p);
 	build_via(p);
-	ao2_t_unlink(dialogs, p, "About to change the callid -- remove the old name");
+	sip_dialog_index_unlink(p);
 	build_callid_pvt(p);
-	ao2_t_link(dialogs, p, "Linking in new name");
+	sip_dialog_index_link(p);
 	dialog_ref(p, "bump the count of p, which transmit_service_request will decrement.");
 	service_scheddestroy(p, SERVICE_TRANS_TIMEOUT);
 
@@ -11828,7 +11531,7 @@ static int transmit_register(struct service_registry *r, int servicemethod, cons
 			return 0;
 		} else {
 			p = dialog_ref(r->call, "getting a copy of the r->call dialog in transmit_register");
-			make_our_tag(p->tag, sizeof(p->tag));	/* create a new local tag for every register attempt */
+			sip_make_our_tag(p->tag, sizeof(p->tag));	/* create a new local tag for every register attempt */
 			tris_string_field_set(p, theirtag, NULL);	/* forget their old tag, so we don't match tags when getting response */
 		}
 	} else {
@@ -12103,7 +11806,7 @@ static int transmit_refer(struct service_pvt *p, const char *dest)
 	}
 
 	tris_copy_string(from, of, sizeof(from));
-	of = get_in_brackets(from);
+	of = sip_get_in_brackets(from);
 	tris_string_field_set(p, from, of);
 	if (!strncasecmp(of, "sip:", 4)) {
 		of += 4;
@@ -12390,7 +12093,7 @@ static int parse_ok_contact(struct service_pvt *pvt, struct service_request *req
 
 	/* Look for brackets */
 	tris_copy_string(contact, get_header(req, "Contact"), sizeof(contact));
-	c = get_in_brackets(contact);
+	c = sip_get_in_brackets(contact);
 
 	/* Save full contact to call pvt for later bye or re-invite */
 	tris_string_field_set(pvt, fullcontact, c);
@@ -12423,15 +12126,15 @@ static int __set_address_from_contact(const char *fullcontact, struct sockaddr_i
 	 * We still need to be able to send to the remote agent through the proxy.
 	 */
 
-	if (parse_uri(contact, "sip:,sips:", &contact, NULL, &host, &pt, NULL, &transport)) {
+	if (sip_parse_uri(contact, "sip:,sips:", &contact, NULL, &host, &pt, NULL, &transport)) {
 		tris_log(LOG_WARNING, "Invalid contact uri %s (missing sip: or sips:), attempting to use anyway\n", fullcontact);
 	}
 
 	/* set port */
 	if (((get_transport_str2enum(transport) == SERVICE_TRANSPORT_TLS)) || !(strncasecmp(fullcontact, "services", 4))) {
-		port = port_str2int(pt, STANDARD_TLS_PORT);
+		port = sip_port_str2int(pt, STANDARD_TLS_PORT);
 	} else {
-		port = port_str2int(pt, STANDARD_SERVICE_PORT);
+		port = sip_port_str2int(pt, STANDARD_SERVICE_PORT);
 	}
 
 
@@ -12503,7 +12206,7 @@ static enum parse_register_result parse_register_contact(struct service_pvt *pvt
 	curi = contact;
 	if (strchr(contact, '<') == NULL)	/* No <, check for ; and strip it */
 		strsep(&curi, ";");	/* This is Header options, not URI options */
-	curi = get_in_brackets(contact);
+	curi = sip_get_in_brackets(contact);
 
 	/* if they did not specify Contact: or Expires:, they are querying
 	   what we currently have stored as their contact address, so return
@@ -12545,7 +12248,7 @@ static enum parse_register_result parse_register_contact(struct service_pvt *pvt
 	tris_string_field_build(pvt, our_contact, "<%s>", curi);
 
 	/* Make sure it's a SERVICE URL */
-	if (parse_uri(curi, "sip:,sips:", &curi, NULL, &host, &pt, NULL, &transport)) {
+	if (sip_parse_uri(curi, "sip:,sips:", &curi, NULL, &host, &pt, NULL, &transport)) {
 		tris_log(LOG_NOTICE, "Not a valid SERVICE contact (missing sip:) trying to use anyway\n");
 	}
 
@@ -12559,9 +12262,9 @@ static enum parse_register_result parse_register_contact(struct service_pvt *pvt
 		 * default port to match the specified transport.  This may or may not be the
 		 * same transport used by the pvt struct for the Register dialog. */
 		
-		port = port_str2int(pt, (transport_type == SERVICE_TRANSPORT_TLS) ? STANDARD_TLS_PORT : STANDARD_SERVICE_PORT);
+		port = sip_port_str2int(pt, (transport_type == SERVICE_TRANSPORT_TLS) ? STANDARD_TLS_PORT : STANDARD_SERVICE_PORT);
 	} else {
-		port = port_str2int(pt, STANDARD_SERVICE_PORT);
+		port = sip_port_str2int(pt, STANDARD_SERVICE_PORT);
 		transport_type = pvt->socket.type;
 	}
 
@@ -13160,29 +12863,6 @@ static void transmit_fake_auth_response(struct service_pvt *p, int servicemethod
 	}
 }
 
-/*!
- * Terminate the uri at the first ';' or space.
- * Technically we should ignore escaped space per RFC3261 (19.1.1 etc)
- * but don't do it for the time being. Remember the uri format is:
- * (User-parameters was added after RFC 3261)
- *\verbatim
- *
- *	sip:user:password;user-parameters@host:port;uri-parameters?headers
- *	sips:user:password;user-parameters@host:port;uri-parameters?headers
- *
- *\endverbatim
- * \todo As this function does not support user-parameters, it's considered broken
- *	and needs fixing.
- */
-static char *terminate_uri(char *uri)
-{
-	char *t = uri;
-	while (*t && *t > ' ' && *t != ';')
-		t++;
-	*t = '\0';
-	return uri;
-}
-
 /*! \brief Verify registration of user 
 	- Registration is done in several steps, first a REGISTER without auth
 	  to get a challenge (nonce) then a second one with auth
@@ -13197,14 +12877,14 @@ static enum check_auth_result register_verify(struct service_pvt *p, struct sock
 	char *name, *c;
 	char *domain;
 
-	terminate_uri(uri);	/* warning, overwrite the string */
+	sip_terminate_uri(uri);	/* warning, overwrite the string */
 
 	tris_copy_string(tmp, get_header(req, "To"), sizeof(tmp));
 	if (service_cfg.pedanticservicechecking)
 		tris_uri_decode(tmp);
 
-	c = get_in_brackets(tmp);
-	c = remove_uri_parameters(c);
+	c = sip_get_in_brackets(tmp);
+	c = sip_remove_uri_parameters(c);
 
 	if (!strncasecmp(c, "sip:", 4)) {
 		name = c + 4;
@@ -13458,7 +13138,7 @@ static int get_rdnis(struct service_pvt *p, struct service_request *oreq)
 	*/
 	params = strchr(tmp, ';');
 
-	exten = get_in_brackets(tmp);
+	exten = sip_get_in_brackets(tmp);
 	if (!strncasecmp(exten, "sip:", 4)) {
 		exten += 4;
 	} else if (!strncasecmp(exten, "sips:", 5)) {
@@ -13534,7 +13214,7 @@ static int get_destination(struct service_pvt *p, struct service_request *oreq)
 	if (service_cfg.pedanticservicechecking)
 		tris_uri_decode(tmp);
 
-	uri = get_in_brackets(tmp);
+	uri = sip_get_in_brackets(tmp);
 	
 	if (!strncasecmp(uri, "sip:", 4)) {
 		uri += 4;
@@ -13553,7 +13233,7 @@ static int get_destination(struct service_pvt *p, struct service_request *oreq)
 	if (!tris_strlen_zero(tmpf)) {
 		if (service_cfg.pedanticservicechecking)
 			tris_uri_decode(tmpf);
-		from = get_in_brackets(tmpf);
+		from = sip_get_in_brackets(tmpf);
 	} 
 	
 	if (!tris_strlen_zero(from)) {
@@ -13650,16 +13330,13 @@ static int get_destination(struct service_pvt *p, struct service_request *oreq)
 static struct service_pvt *get_service_pvt_byid_locked(const char *callid, const char *totag, const char *fromtag) 
 {
 	struct service_pvt *service_pvt_ptr;
-	struct service_pvt tmp_dialog = {
-		.callid = callid,
-	};
 
 	if (totag)
 		tris_debug(4, "Looking for callid %s (fromtag %s totag %s)\n", callid, fromtag ? fromtag : "<no fromtag>", totag ? totag : "<no totag>");
 
 	/* Search dialogs and find the match */
 	
-	service_pvt_ptr = ao2_t_find(dialogs, &tmp_dialog, OBJ_POINTER, "ao2_find of dialog in dialogs table");
+	service_pvt_ptr = sip_dialog_index_find(&service_tech, callid, NULL, NULL);
 	if (service_pvt_ptr) {
 		/* Go ahead and lock it (and its owner) before returning */
 		service_pvt_lock(service_pvt_ptr);
@@ -13762,7 +13439,7 @@ static int get_refer_info(struct service_pvt *transferer, struct service_request
 		return -2;	/* Syntax error */
 	}
 	h_refer_to = tris_strdupa(p_refer_to);
-	refer_to = get_in_brackets(h_refer_to);
+	refer_to = sip_get_in_brackets(h_refer_to);
 	if (service_cfg.pedanticservicechecking)
 		tris_uri_decode(refer_to);
 
@@ -13799,7 +13476,7 @@ static int get_refer_info(struct service_pvt *transferer, struct service_request
 			*(lessthan - 1) = '\0';	/* Space */
 		}
 
-		referred_by_uri = get_in_brackets(h_referred_by);
+		referred_by_uri = sip_get_in_brackets(h_referred_by);
 		if (!strncasecmp(referred_by_uri, "sip:", 4)) {
 			referred_by_uri += 4;		/* Skip sip: */
 		} else if (!strncasecmp(referred_by_uri, "sips:", 5)) {
@@ -13926,7 +13603,7 @@ static int get_also_info(struct service_pvt *p, struct service_request *oreq)
 	referdata = p->refer;
 
 	tris_copy_string(tmp, get_header(req, "Also"), sizeof(tmp));
-	c = get_in_brackets(tmp);
+	c = sip_get_in_brackets(tmp);
 
 	if (service_cfg.pedanticservicechecking)
 		tris_uri_decode(c);
@@ -14069,7 +13746,7 @@ static void check_via(struct service_pvt *p, struct service_request *req)
 		memset(&p->sa, 0, sizeof(p->sa));
 		p->sa.sin_family = AF_INET;
 		memcpy(&p->sa.sin_addr, hp->h_addr, sizeof(p->sa.sin_addr));
-		p->sa.sin_port = htons(port_str2int(pt, STANDARD_SERVICE_PORT));
+		p->sa.sin_port = htons(sip_port_str2int(pt, STANDARD_SERVICE_PORT));
 
 		if (service_debug_test_pvt(p)) {
 			const struct sockaddr_in *dst = service_real_dst(p);
@@ -14078,81 +13755,6 @@ static void check_via(struct service_pvt *p, struct service_request *req)
 	}
 }
 
-/*! \brief  Get caller id name from SERVICE headers */
-static char *get_calleridname(const char *input, char *output, size_t outputsize)
-{
-	const char *end = strchr(input, '<');	/* first_bracket */
-	const char *tmp = strchr(input, '"');	/* first quote */
-	int bytes = 0;
-	int maxbytes = outputsize - 1;
-
-	if (!end || end == input)	/* we require a part in brackets */
-		return NULL;
-
-	end--; /* move just before "<" */
-
-	if (tmp && tmp <= end) {
-		/* The quote (tmp) precedes the bracket (end+1).
-		 * Find the matching quote and return the content.
-		 */
-		end = strchr(tmp+1, '"');
-		if (!end)
-			return NULL;
-		bytes = (int) (end - tmp);
-		/* protect the output buffer */
-		if (bytes > maxbytes)
-			bytes = maxbytes;
-		tris_copy_string(output, tmp + 1, bytes);
-	} else {
-		/* No quoted string, or it is inside brackets. */
-		/* clear the empty characters in the begining*/
-		input = tris_skip_blanks(input);
-		/* clear the empty characters in the end */
-		while(*end && *end < 33 && end > input)
-			end--;
-		if (end >= input) {
-			bytes = (int) (end - input) + 2;
-			/* protect the output buffer */
-			if (bytes > maxbytes)
-				bytes = maxbytes;
-			tris_copy_string(output, input, bytes);
-		} else
-			return NULL;
-	}
-	return output;
-}
-
-/*! \brief  Get caller id number from Remote-Party-ID header field 
- *	Returns true if number should be restricted (privacy setting found)
- *	output is set to NULL if no number found
- */
-static int get_rpid_num(const char *input, char *output, int maxlen)
-{
-	char *start;
-	char *end;
-
-	start = strchr(input, ':');
-	if (!start) {
-		output[0] = '\0';
-		return 0;
-	}
-	start++;
-
-	/* we found "number" */
-	tris_copy_string(output, start, maxlen);
-	output[maxlen-1] = '\0';
-
-	end = strchr(output, '@');
-	if (end)
-		*end = '\0';
-	else
-		output[0] = '\0';
-	if (strstr(input, "privacy=full") || strstr(input, "privacy=uri"))
-		return TRIS_PRES_PROHIB_USER_NUMBER_NOT_SCREENED;
-
-	return 0;
-}
-
 
 /*! \brief helper function for check_{user|peer}_ok() */
 static void replace_cid(struct service_pvt *p, const char *rpid_num, const char *calleridname)
@@ -14339,8 +13941,8 @@ static enum check_auth_result check_user_full(struct service_pvt *p, struct serv
 					      struct sockaddr_in *sin, struct service_peer **authpeer)
 {
 	char from[256];
-	char *dummy;	/* dummy return value for parse_uri */
-	char *domain;	/* dummy return value for parse_uri */
+	char *dummy;	/* dummy return value for sip_parse_uri */
+	char *domain;	/* dummy return value for sip_parse_uri */
 	char *of;
 	char rpid_num[50];
 	const char *rpid;
@@ -14348,23 +13950,23 @@ static enum check_auth_result check_user_full(struct service_pvt *p, struct serv
 	char calleridname[50];
 	char *uri2 = tris_strdupa(uri);
 
-	terminate_uri(uri2);	/* trim extra stuff */
+	sip_terminate_uri(uri2);	/* trim extra stuff */
 
 	tris_copy_string(from, get_header(req, "From"), sizeof(from));
 	if (service_cfg.pedanticservicechecking)
 		tris_uri_decode(from);
 	/* XXX here tries to map the username for invite things */
 	memset(calleridname, 0, sizeof(calleridname));
-	get_calleridname(from, calleridname, sizeof(calleridname));
+	sip_get_calleridname(from, calleridname, sizeof(calleridname));
 	if (calleridname[0])
 		tris_string_field_set(p, cid_name, calleridname);
 
 	rpid = get_header(req, "Remote-Party-ID");
 	memset(rpid_num, 0, sizeof(rpid_num));
 	if (!tris_strlen_zero(rpid)) 
-		p->callingpres = get_rpid_num(rpid, rpid_num, sizeof(rpid_num));
+		p->callingpres = sip_get_rpid_num(rpid, rpid_num, sizeof(rpid_num));
 
-	of = get_in_brackets(from);
+	of = sip_get_in_brackets(from);
 	if (tris_strlen_zero(p->exten)) {
 		char *t = uri2;
 		if (!strncasecmp(t, "sip:", 4))
@@ -14382,7 +13984,7 @@ static enum check_auth_result check_user_full(struct service_pvt *p, struct serv
 	tris_string_field_set(p, from, of);
 
 	/* ignore all fields but name */
-	if (parse_uri(of, "sip:,sips:", &of, &dummy, &domain, &dummy, &dummy, NULL)) {
+	if (sip_parse_uri(of, "sip:,sips:", &of, &dummy, &domain, &dummy, &dummy, NULL)) {
 		tris_log(LOG_NOTICE, "From address missing 'sip:', using it anyway\n");
 	}
 
@@ -15403,7 +15005,8 @@ static char *service_prune_realtime(struct tris_cli_entry *e, int cmd, struct tr
 /*! \brief Print codec list from preference to CLI/manager */
 static void print_codec_to_cli(int fd, struct tris_codec_pref *pref)
 {
-	int x, codec;
+	int x;
+	format_t codec;
 
 	for(x = 0; x < 32 ; x++) {
 		codec = tris_codec_pref_index(pref, x);
@@ -15604,7 +15207,8 @@ static char *_service_show_peer(int type, int fd, struct mansession *s, const st
 	struct tris_codec_pref *pref;
 	struct tris_variable *v;
 	struct service_auth *auth;
-	int x = 0, codec = 0, load_realtime;
+	int x = 0, load_realtime;
+	format_t codec = 0;
 	int realtimepeers;
 
 	realtimepeers = tris_check_realtime("servicepeers");
@@ -16244,6 +15848,13 @@ static char *service_show_settings(struct tris_cli_entry *e, int cmd, struct tri
 	else
 		tris_cli(a->fd, "  SERVICE realtime:           Enabled\n" );
 	tris_cli(a->fd, "  Qualify Freq :          %d ms\n", global_qualifyfreq);
+	tris_cli(a->fd, "  SERVICE Worker Threads:     %d\n", global_serviceworkers);
+	tris_mutex_lock(&service_workers_lock);
+	sip_worker_pool_show(service_workers, a->fd);
+	tris_mutex_unlock(&service_workers_lock);
+	tris_cli(a->fd, "  UDP Batch Size:         %d\n", global_udpbatch);
+	tris_cli(a->fd, "  UDP Receive Calls:      %d (%d packets, %d dropped)\n", servicesock_stats.rxcalls, servicesock_stats.rxpackets, servicesock_stats.rxdropped);
+	tris_cli(a->fd, "  UDP Send Calls:         %d (%d packets, %d failed)\n", servicesock_stats.txcalls, servicesock_stats.txpackets, servicesock_stats.txerrors);
 	tris_cli(a->fd, "\nNetwork QoS Settings:\n");
 	tris_cli(a->fd, "---------------------------\n");
 	tris_cli(a->fd, "  IP ToS SERVICE:             %s\n", tris_tos2str(global_tos_service));
@@ -16697,10 +16308,10 @@ static char *service_show_channel(struct tris_cli_entry *e, int cmd, struct tris
 			tris_cli(a->fd, "  Curr. trans. direction:  %s\n", tris_test_flag(&cur->flags[0], SERVICE_OUTGOING) ? "Outgoing" : "Incoming");
 			tris_cli(a->fd, "  Call-ID:                %s\n", cur->callid);
 			tris_cli(a->fd, "  Owner channel ID:       %s\n", cur->owner ? cur->owner->name : "<none>");
-			tris_cli(a->fd, "  Our Codec Capability:   %d\n", cur->capability);
+			tris_cli(a->fd, "  Our Codec Capability:   %lld\n", (long long) cur->capability);
 			tris_cli(a->fd, "  Non-Codec Capability (DTMF):   %d\n", cur->noncodeccapability);
-			tris_cli(a->fd, "  Their Codec Capability:   %d\n", cur->peercapability);
-			tris_cli(a->fd, "  Joint Codec Capability:   %d\n", cur->jointcapability);
+			tris_cli(a->fd, "  Their Codec Capability:   %lld\n", (long long) cur->peercapability);
+			tris_cli(a->fd, "  Joint Codec Capability:   %lld\n", (long long) cur->jointcapability);
 			tris_cli(a->fd, "  Format:                 %s\n", tris_getformatname_multiple(formatbuf, sizeof(formatbuf), cur->owner ? cur->owner->nativeformats : 0) );
 			tris_cli(a->fd, "  T.38 support            %s\n", cli_yesno(cur->udptl != NULL));
 			tris_cli(a->fd, "  Video support           %s\n", cli_yesno(cur->vrtp != NULL));
@@ -16930,7 +16541,7 @@ static void handle_request_info(struct service_pvt *p, struct service_request *r
 			f.len = duration;
 			tris_queue_frame(p->owner, &f);
 			if (servicedebug)
-				tris_verbose("* DTMF-relay event received: %c\n", f.subclass);
+				tris_verbose("* DTMF-relay event received: %c\n", (int) f.subclass);
 		}
 		transmit_response(p, "200 OK", req);
 		return;
@@ -16973,7 +16584,7 @@ static void handle_request_info(struct service_pvt *p, struct service_request *r
 			f.len = duration;
 			tris_queue_frame(p->owner, &f);
 			if (servicedebug)
-				tris_verbose("* DTMF-relay event received: %c\n", f.subclass);
+				tris_verbose("* DTMF-relay event received: %c\n", (int) f.subclass);
 		}
 		transmit_response(p, "200 OK", req);
 		return;
@@ -17023,7 +16634,7 @@ static void handle_request_info(struct service_pvt *p, struct service_request *r
 			f.subclass = feat->exten[j];
 			tris_queue_frame(p->owner, &f);
 			if (servicedebug)
-				tris_verbose("* DTMF-relay event faked: %c\n", f.subclass);
+				tris_verbose("* DTMF-relay event faked: %c\n", (int) f.subclass);
 		}
 		tris_unlock_call_features();
 
@@ -17234,9 +16845,9 @@ static char *service_cli_notify(struct tris_cli_entry *e, int cmd, struct tris_c
 		/* Recalculate our side, and recalculate Call ID */
 		tris_service_ouraddrfor(&p->sa.sin_addr, &p->ourip, p);
 		build_via(p);
-		ao2_t_unlink(dialogs, p, "About to change the callid -- remove the old name");
+		sip_dialog_index_unlink(p);
 		build_callid_pvt(p);
-		ao2_t_link(dialogs, p, "Linking in new name");
+		sip_dialog_index_link(p);
 		tris_cli(a->fd, "Sending NOTIFY of type '%s' to '%s'\n", a->argv[2], a->argv[i]);
 		dialog_ref(p, "bump the count of p, which transmit_service_request will decrement.");
 		service_scheddestroy(p, SERVICE_TRANS_TIMEOUT);
@@ -17627,7 +17238,7 @@ static int function_servicepeer(struct tris_channel *chan, const char *cmd, char
 		}
 	} else  if (!strncasecmp(colname, "codec[", 6)) {
 		char *codecnum;
-		int codec = 0;
+		format_t codec = 0;
 		
 		codecnum = colname + 6;	/* move past the '[' */
 		codecnum = strsep(&codecnum, "]"); /* trim trailing ']' if any */
@@ -17734,7 +17345,7 @@ static void parse_moved_contact(struct service_pvt *p, struct service_request *r
 	if ((t = strchr(tmp, ',')))
 		*t = '\0';
 
-	s = get_in_brackets(tmp);
+	s = sip_get_in_brackets(tmp);
 	if ((trans = strcasestr(s, ";transport="))) do {
 		trans += 11;
 
@@ -17752,7 +17363,7 @@ static void parse_moved_contact(struct service_pvt *p, struct service_request *r
 			transport = SERVICE_TRANSPORT_UDP;
 		}
 	} while(0);
-	s = remove_uri_parameters(s);
+	s = sip_remove_uri_parameters(s);
 
 	if (p->socket.tcptls_session) {
 		ao2_ref(p->socket.tcptls_session, -1);
@@ -20458,7 +20069,7 @@ static int handle_request_invite(struct service_pvt *p, struct service_request *
 				tris_string_field_set(p, exten, "s");
 			/* Initialize our tag */
 
-			make_our_tag(p->tag, sizeof(p->tag));
+			sip_make_our_tag(p->tag, sizeof(p->tag));
 			/* First invitation - create the channel */
 			c = service_new(p, TRIS_STATE_DOWN, S_OR(p->peername, NULL));
 			*recount = 1;
@@ -21755,7 +21366,7 @@ static int handle_request_subscribe(struct service_pvt *p, struct service_reques
 
 	/* Initialize tag for new subscriptions */	
 	if (tris_strlen_zero(p->tag))
-		make_our_tag(p->tag, sizeof(p->tag));
+		sip_make_our_tag(p->tag, sizeof(p->tag));
 
 	if (!strcmp(event, "presence") || !strcmp(event, "dialog")) { /* Presence, RFC 3842 */
 		unsigned int pidf_xml;
@@ -22324,6 +21935,67 @@ static int queue_request(struct service_pvt *p, const struct service_request *re
 	return 0;
 }
 
+/*! \brief Hand a UDP packet over to handle_request_do() */
+static void service_process_udp_packet(struct tris_str *data, int len, struct sockaddr_in *sin, int worker)
+{
+	struct service_request req;
+
+	memset(&req, 0, sizeof(req));
+	req.data = data;
+	req.len = len;
+	req.socket.fd = servicesock;
+	set_socket_transport(&req.socket, SERVICE_TRANSPORT_UDP);
+	req.socket.tcptls_session	= NULL;
+	req.socket.port = bindaddr.sin_port;
+	req.worker = worker;
+
+	handle_request_do(&req, sin);
+	if (req.data) {
+		tris_free(req.data);
+		req.data = NULL;
+	}
+}
+
+/*! \brief Process a UDP packet queued to a SERVICE worker thread */
+static void service_worker_process_udp_packet(struct tris_str *data, int len, struct sockaddr_in *sin)
+{
+	service_process_udp_packet(data, len, sin, 1);
+}
+
+/*! \brief Stop using the shared worker threads, once they processed what we queued */
+static void service_workers_stop(void)
+{
+	struct sip_worker_pool *pool;
+
+	tris_mutex_lock(&service_workers_lock);
+	pool = service_workers;
+	service_workers = NULL;
+	tris_mutex_unlock(&service_workers_lock);
+
+	sip_worker_pool_destroy(pool);
+}
+
+/*! \brief Have our packets processed by the shared worker threads, at least as many as configured
+ * \note Must be called from the thread reading the UDP socket (or before it
+ * is started), since servicesock_read() does not lock service_workers.
+ */
+static void service_workers_start(void)
+{
+	struct sip_worker_pool *pool;
+
+	if (global_serviceworkers != sip_worker_pool_size(service_workers)) {
+		service_workers_stop();
+
+		if (global_serviceworkers > 0 && (pool = sip_worker_pool_create("SERVICE", global_serviceworkers, service_worker_process_udp_packet))) {
+			tris_mutex_lock(&service_workers_lock);
+			service_workers = pool;
+			tris_mutex_unlock(&service_workers_lock);
+		}
+	}
+
+	sip_worker_pool_set_batching(service_workers, global_udpbatch, &servicesock_stats);
+}
+
 /*! \brief Read data from SERVICE UDP socket
 \note servicesock_read locks the owner channel while we are processing the SERVICE message
 \return 1 on error, 0 on success
@@ -22331,46 +22003,58 @@ static int queue_request(struct service_pvt *p, const struct service_request *re
 */
 static int servicesock_read(int *id, int fd, short events, void *ignore)
 {
-	struct service_request req;
+	struct tris_str *data;
 	struct sockaddr_in sin = { 0, };
 	int res;
-	socklen_t len = sizeof(sin);
 	static char readbuf[65535];
+	static struct tris_udp_batch *rxbatch;
 
-	memset(&req, 0, sizeof(req));
-	res = recvfrom(fd, readbuf, sizeof(readbuf) - 1, 0, (struct sockaddr *)&sin, &len);
-	if (res < 0) {
+	/* Follow the configured batch size, without dropping packets that were read ahead.
+	   Slots hold SERVICE_MIN_PACKET bytes, longer packets read ahead share one overflow buffer. */
+	if (tris_udp_batch_size(rxbatch) != global_udpbatch && !tris_udp_batch_pending(rxbatch)) {
+		tris_udp_batch_free(rxbatch);
+		rxbatch = tris_udp_batch_alloc(global_udpbatch, SERVICE_MIN_PACKET);
+	}
+
+	/* Without workers the replies are sent from here, batch them up as well */
+	if (!service_workers)
+		sip_udp_send_begin(global_udpbatch, &servicesock_stats);
+
+	/* Packets read ahead don't make the socket readable again, process them all now */
+	do {
+		res = tris_udp_batch_recvfrom(rxbatch, fd, readbuf, sizeof(readbuf) - 1, &sin, &servicesock_stats);
+		if (res < 0) {
 #if !defined(__FreeBSD__)
-		if (errno == EAGAIN)
-			tris_log(LOG_NOTICE, "SERVICE: Received packet with bad UDP checksum\n");
-		else 
+			if (errno == EAGAIN)
+				tris_log(LOG_NOTICE, "SERVICE: Received packet with bad UDP checksum\n");
+			else 
 #endif
-		if (errno != ECONNREFUSED)
-			tris_log(LOG_WARNING, "Recv error: %s\n", strerror(errno));
-		return 1;
-	}
+			if (errno != ECONNREFUSED)
+				tris_log(LOG_WARNING, "Recv error: %s\n", strerror(errno));
+			break;
+		}
 
-	readbuf[res] = '\0';
+		readbuf[res] = '\0';
 
-	if (!(req.data = tris_str_create(SERVICE_MIN_PACKET))) {
-		return 1;
-	}
+		if (!(data = tris_str_create(SERVICE_MIN_PACKET))) {
+			break;
+		}
 
-	if (tris_str_set(&req.data, 0, "%s", readbuf) == TRIS_DYNSTR_BUILD_FAILED) {
-		return -1;
-	}
+		if (tris_str_set(&data, 0, "%s", readbuf) == TRIS_DYNSTR_BUILD_FAILED) {
+			tris_free(data);
+			break;
+		}
 
-	req.len = res;
-	req.socket.fd = servicesock;
-	set_socket_transport(&req.socket, SERVICE_TRANSPORT_UDP);
-	req.socket.tcptls_session	= NULL;
-	req.socket.port = bindaddr.sin_port;
+		if (service_workers) {
+			if (sip_worker_pool_queue(service_workers, data, res, &sin))
+				tris_free(data);
+			continue;
+		}
 
-	handle_request_do(&req, &sin);
-	if (req.data) {
-		tris_free(req.data);
-		req.data = NULL;
-	}
+		service_process_udp_packet(data, res, &sin, 0);
+	} while (tris_udp_batch_pending(rxbatch));
+
+	sip_udp_send_end();
 
 	return 1;
 }
@@ -22384,12 +22068,13 @@ static int handle_request_do(struct service_request *req, struct sockaddr_in *si
 	struct service_pvt *p;
 	int recount = 0;
 	int nounlock = 0;
+	int netlocked = 1;
 	int lockretry;
 
 	if (service_debug_test_addr(sin))	/* Set the debug flag early on packet level */
 		req->debug = 1;
 	if (service_cfg.pedanticservicechecking)
-		req->len = lws2sws(req->data->str, req->len);	/* Fix multiline headers */
+		req->len = sip_lws2sws(req->data->str, req->len);	/* Fix multiline headers */
 	if (req->debug) {
 		tris_verbose("\n<--- SERVICE read from %s:%s:%d --->\n%s\n<------------->\n", 
 			get_transport(req->socket.type), tris_inet_ntoa(sin->sin_addr), 
@@ -22464,6 +22149,14 @@ static int handle_request_do(struct service_request *req, struct sockaddr_in *si
 		return 1;
 	}
 
+	if (req->worker) {
+		/* Packets from the worker threads are serialized per dialog by the dialog
+		   (and owner) locks, don't hold up the other dialogs while doing so.
+		   reload_config() pauses the workers before it replaces the socket. */
+		tris_mutex_unlock(&netlock);
+		netlocked = 0;
+	}
+
 	/* if there are queued requests on this service_pvt, process them first, so that everything is
 	   handled in order
 	*/
@@ -22484,7 +22177,8 @@ static int handle_request_do(struct service_request *req, struct sockaddr_in *si
 		tris_channel_unlock(p->owner);
 	service_pvt_unlock(p);
 	ao2_t_ref(p, -1, "throw away dialog ptr from find_call at end of routine"); /* p is gone after the return */
-	tris_mutex_unlock(&netlock);
+	if (netlocked)
+		tris_mutex_unlock(&netlock);
 	return 1;
 }
 
@@ -22785,9 +22479,9 @@ static int service_send_mwi_to_peer(struct service_peer *peer, const struct tris
 		/* Recalculate our side, and recalculate Call ID */
 		tris_service_ouraddrfor(&p->sa.sin_addr, &p->ourip, p);
 		build_via(p);
-		ao2_t_unlink(dialogs, p, "About to change the callid -- remove the old name");
+		sip_dialog_index_unlink(p);
 		build_callid_pvt(p);
-		ao2_t_link(dialogs, p, "Linking in under new name");
+		sip_dialog_index_link(p);
 		/* Destroy this session after 32 secs */
 		service_scheddestroy(p, DEFAULT_TRANS_TIMEOUT);
 	}
@@ -22896,6 +22590,7 @@ static void *do_monitor(void *data)
 		if (reloading) {
 			tris_verb(1, "Reloading SERVICE\n");
 			service_do_reload(service_reloadreason);
+			service_workers_start();
 
 			/* Change the I/O fd of our UDP socket */
 			if (servicesock > -1) {
@@ -23398,9 +23093,9 @@ static int service_poke_peer(struct service_peer *peer, int force)
 	/* Recalculate our side, and recalculate Call ID */
 	tris_service_ouraddrfor(&p->sa.sin_addr, &p->ourip, p);
 	build_via(p);
-	ao2_t_unlink(dialogs, p, "About to change the callid -- remove the old name");
+	sip_dialog_index_unlink(p);
 	build_callid_pvt(p);
-	ao2_t_link(dialogs, p, "Linking in under new name");
+	sip_dialog_index_link(p);
 
 	TRIS_SCHED_DEL_UNREF(sched, peer->pokeexpire,
 			unref_peer(peer, "removing poke peer ref"));
@@ -23540,7 +23235,7 @@ static int service_devicestate(void *data)
  *	or	SIP/host!dnid
  * \endverbatim
 */
-static struct tris_channel *service_request_call(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *service_request_call(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	struct service_pvt *p;
 	struct tris_channel *tmpc = NULL;
@@ -23553,7 +23248,7 @@ static struct tris_channel *service_request_call(const char *type, int format, v
  	char *authname = NULL;
 	char *trans = NULL;
 	enum service_transport transport = 0;
-	int oldformat = format;
+	format_t oldformat = format;
 
 	/* mask request with some set of allowed formats.
 	 * XXX this needs to be fixed.
@@ -23664,9 +23359,9 @@ static struct tris_channel *service_request_call(const char *type, int format, v
 	/* Recalculate our side, and recalculate Call ID */
 	tris_service_ouraddrfor(&p->sa.sin_addr, &p->ourip, p);
 	build_via(p);
-	ao2_t_unlink(dialogs, p, "About to change the callid -- remove the old name");
+	sip_dialog_index_unlink(p);
 	build_callid_pvt(p);
-	ao2_t_link(dialogs, p, "Linking in under new name");
+	sip_dialog_index_link(p);
 	
 	/* We have an extension to call, don't use the full contact here */
 	/* This to enable dialing registered peers with extension dialling,
@@ -24377,7 +24072,7 @@ static struct service_peer *build_peer(const char *name, struct tris_variable *v
 				}
 			} else if (!strcasecmp(v->name, "port")) {
 				peer->portinuri = 1;
-				if (!(port = port_str2int(v->value, 0))) {
+				if (!(port = sip_port_str2int(v->value, 0))) {
 					if (realtime) {
 						/* If stored as integer, could be 0 for some DBs (notably MySQL) */
 						peer->portinuri = 0;
@@ -24735,6 +24430,7 @@ static int reload_config(enum channelreloadreason reason)
 	struct tris_flags config_flags = { reason == CHANNEL_MODULE_LOAD ? 0 : tris_test_flag(&global_flags[1], SERVICE_PAGE2_RTCACHEFRIENDS) ? 0 : CONFIG_FLAG_FILEUNCHANGED };
 	int auto_service_domains = FALSE;
 	struct sockaddr_in old_bindaddr = bindaddr;
+	int rebind;
 	int registry_count = 0, peer_count = 0;
 	time_t run_start, run_end;
 	
@@ -24950,6 +24646,8 @@ static int reload_config(enum channelreloadreason reason)
 	global_timer_b = 64 * DEFAULT_TIMER_T1;
 	global_t1min = DEFAULT_T1MIN;
 	global_qualifyfreq = DEFAULT_QUALIFYFREQ;
+	global_serviceworkers = 0;
+	global_udpbatch = 0;
 	global_t38_maxdatagram = -1;
 	global_shrinkcallerid = 1;
 
@@ -25352,6 +25050,20 @@ static int reload_config(enum channelreloadreason reason)
 				tris_log(LOG_WARNING, "Invalid qualifyfreq number '%s' at line %d of %s\n", v->value, v->lineno, config);
 				global_qualifyfreq = DEFAULT_QUALIFYFREQ;
 			}
+		} else if (!strcasecmp(v->name, "serviceworkers")) {
+			if (sscanf(v->value, "%30d", &global_serviceworkers) != 1 || global_serviceworkers < 0) {
+				tris_log(LOG_WARNING, "Invalid serviceworkers '%s' at line %d of %s\n", v->value, v->lineno, config);
+				global_serviceworkers = 0;
+			}
+		} else if (!strcasecmp(v->name, "udpbatch")) {
+			if (sscanf(v->value, "%30d", &global_udpbatch) != 1 || global_udpbatch < 0) {
+				tris_log(LOG_WARNING, "Invalid udpbatch '%s' at line %d of %s\n", v->value, v->lineno, config);
+				global_udpbatch = 0;
+			}
+			if (global_udpbatch < 2)
+				global_udpbatch = 0;
+			else if (global_udpbatch > TRIS_UDP_BATCH_MAX)
+				global_udpbatch = TRIS_UDP_BATCH_MAX;
 		} else if (!strcasecmp(v->name, "callevents")) {
 			service_cfg.callevents = tris_true(v->value);
 		} else if (!strcasecmp(v->name, "authfailureevents")) {
@@ -25537,8 +25249,13 @@ static int reload_config(enum channelreloadreason reason)
 		tris_config_destroy(cfg);
 		return 0;
 	}
+	/* The workers send on servicesock without netlock, have them finish
+	   what they are doing before the socket is replaced */
+	rebind = (servicesock > -1) && memcmp(&old_bindaddr, &bindaddr, sizeof(struct sockaddr_in));
+	if (rebind)
+		sip_worker_pool_pause(service_workers);
 	tris_mutex_lock(&netlock);
-	if ((servicesock > -1) && (memcmp(&old_bindaddr, &bindaddr, sizeof(struct sockaddr_in)))) {
+	if (rebind) {
 		close(servicesock);
 		servicesock = -1;
 	}
@@ -25546,6 +25263,9 @@ static int reload_config(enum channelreloadreason reason)
 		servicesock = socket(AF_INET, SOCK_DGRAM, 0);
 		if (servicesock < 0) {
 			tris_log(LOG_WARNING, "Unable to create SERVICE socket: %s\n", strerror(errno));
+			tris_mutex_unlock(&netlock);
+			if (rebind)
+				sip_worker_pool_resume(service_workers);
 			tris_config_destroy(cfg);
 			return -1;
 		} else {
@@ -25580,6 +25300,8 @@ static int reload_config(enum channelreloadreason reason)
 			tris_inet_ntoa(externip.sin_addr) , ntohs(externip.sin_port));
 	}
 	tris_mutex_unlock(&netlock);
+	if (rebind)
+		sip_worker_pool_resume(service_workers);
 
 	/* Start TCP server */
 	tris_tcptls_server_start(&service_tcp_desc);
@@ -25787,7 +25509,7 @@ static enum tris_rtp_get_result service_get_trtp_peer(struct tris_channel *chan,
 }
 
 /*! \brief Set the RTP peer for this call */
-static int service_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, int codecs, int nat_active)
+static int service_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, format_t codecs, int nat_active)
 {
 	struct service_pvt *p;
 	int changed = 0;
@@ -26051,7 +25773,7 @@ static int service_serviceredirect(struct service_pvt *p, const char *dest)
 }
 
 /*! \brief Return SERVICE UA's codec (part of the RTP interface) */
-static int service_get_codec(struct tris_channel *chan)
+static format_t service_get_codec(struct tris_channel *chan)
 {
 	struct service_pvt *p = chan->tech_pvt;
 	return p->jointcapability ? p->jointcapability : p->capability;	
@@ -26297,6 +26019,9 @@ static int load_module(void)
 	service_send_all_registers();
 	service_send_all_mwi_subscriptions();
 
+	/* Start the UDP worker threads before the monitor starts reading */
+	service_workers_start();
+
 	/* And start the monitor for the first time */
 	restart_monitor();
 
@@ -26390,6 +26115,9 @@ static int unload_module(void)
 	monitor_thread = TRIS_PTHREADT_STOP;
 	tris_mutex_unlock(&monlock);
 
+	/* Nothing is queued to the workers anymore, let them finish */
+	service_workers_stop();
+
 	/* Destroy all the dialogs and free their memory */
 	i = ao2_iterator_init(dialogs, 0);
 	while ((p = ao2_t_iterator_next(&i, "iterate thru dialogs"))) {
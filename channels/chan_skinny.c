@@ -84,7 +84,7 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 249895 $")
 static const char tdesc[] = "Skinny Client Control Protocol (Skinny)";
 static const char config[] = "skinny.conf";
 
-static int default_capability = TRIS_FORMAT_ULAW | TRIS_FORMAT_ALAW;
+static format_t default_capability = TRIS_FORMAT_ULAW | TRIS_FORMAT_ALAW;
 static struct tris_codec_pref default_prefs;
 
 enum skinny_codecs {
@@ -1173,9 +1173,9 @@ struct skinny_subchannel {
 	int instance;					\
 	int group;					\
 	int needdestroy;				\
-	int confcapability;				\
+	format_t confcapability;		\
 	struct tris_codec_pref confprefs;		\
-	int capability;					\
+	format_t capability;			\
 	struct tris_codec_pref prefs;			\
 	int nonCodecCapability;				\
 	int onhooktime;					\
@@ -1253,9 +1253,9 @@ struct skinny_addon {
 	int registered;						\
 	int lastlineinstance;					\
 	int lastcallreference;					\
-	int confcapability;					\
+	format_t confcapability;			\
 	struct tris_codec_pref confprefs;			\
-	int capability;						\
+	format_t capability;				\
 	int earlyrtp;						\
 	int transfer;						\
 	int callwaiting;					\
@@ -1317,7 +1317,7 @@ struct skinnysession {
 
 static TRIS_LIST_HEAD_STATIC(sessions, skinnysession);
 
-static struct tris_channel *skinny_request(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+static struct tris_channel *skinny_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 static int skinny_devicestate(void *data);
 static int skinny_call(struct tris_channel *ast, char *dest, int timeout);
 static int skinny_hangup(struct tris_channel *ast);
@@ -2606,7 +2606,7 @@ static enum tris_rtp_get_result skinny_get_rtp_peer(struct tris_channel *c, stru
 
 }
 
-static int skinny_set_rtp_peer(struct tris_channel *c, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, int codecs, int nat_active)
+static int skinny_set_rtp_peer(struct tris_channel *c, struct tris_rtp *rtp, struct tris_rtp *vrtp, struct tris_rtp *trtp, format_t codecs, int nat_active)
 {
 	struct skinny_subchannel *sub;
 	struct skinny_line *l;
@@ -2650,7 +2650,7 @@ static int skinny_set_rtp_peer(struct tris_channel *c, struct tris_rtp *rtp, str
 		fmt = tris_codec_pref_getsize(&l->prefs, tris_best_codec(l->capability));
 
 		if (skinnydebug)
-			tris_verb(1, "Setting payloadType to '%d' (%d ms)\n", fmt.bits, fmt.cur_ms);
+			tris_verb(1, "Setting payloadType to '%lld' (%d ms)\n", (long long) fmt.bits, fmt.cur_ms);
 
 		req->data.startmedia.conferenceId = htolel(sub->callid);
 		req->data.startmedia.passThruPartyId = htolel(sub->callid);
@@ -2927,7 +2927,8 @@ static char *device2str(int type)
 /*! \brief Print codec list from preference to CLI/manager */
 static void print_codec_to_cli(int fd, struct tris_codec_pref *pref)
 {
-	int x, codec;
+	int x;
+	format_t codec;
 
 	for(x = 0; x < 32 ; x++) {
 		codec = tris_codec_pref_index(pref, x);
@@ -3339,7 +3340,8 @@ static char *_skinny_show_line(int type, int fd, struct mansession *s, const str
 	struct skinny_device *d;
 	struct skinny_line *l;
 	struct tris_codec_pref *pref;
-	int x = 0, codec = 0;
+	int x = 0;
+	format_t codec = 0;
 	char codec_buf[512];
 	char group_buf[256];
 	char cbuf[256];
@@ -3941,7 +3943,7 @@ static struct tris_frame *skinny_rtp_read(struct skinny_subchannel *sub)
 		/* We already hold the channel lock */
 		if (f->frametype == TRIS_FRAME_VOICE) {
 			if (f->subclass != ast->nativeformats) {
-				tris_debug(1, "Oooh, format changed to %d\n", f->subclass);
+				tris_debug(1, "Oooh, format changed to %lld\n", (long long) f->subclass);
 				ast->nativeformats = f->subclass;
 				tris_set_read_format(ast, ast->readformat);
 				tris_set_write_format(ast, ast->writeformat);
@@ -3974,8 +3976,8 @@ static int skinny_write(struct tris_channel *ast, struct tris_frame *frame)
 		}
 	} else {
 		if (!(frame->subclass & ast->nativeformats)) {
-			tris_log(LOG_WARNING, "Asked to transmit frame type %d, while native formats is %d (read/write = %d/%d)\n",
-				frame->subclass, ast->nativeformats, ast->readformat, ast->writeformat);
+			tris_log(LOG_WARNING, "Asked to transmit frame type %lld, while native formats is %lld (read/write = %lld/%lld)\n",
+				(long long) frame->subclass, (long long) ast->nativeformats, (long long) ast->readformat, (long long) ast->writeformat);
 			return -1;
 		}
 	}
@@ -4271,7 +4273,7 @@ static struct tris_channel *skinny_new(struct skinny_line *l, int state)
 	struct skinny_subchannel *sub;
 	struct skinny_device *d = l->device;
 	struct tris_variable *v = NULL;
-	int fmt;
+	format_t fmt;
 
 	if (!l->device) {
 		tris_log(LOG_WARNING, "Device for line %s is not registered.\n", l->name);
@@ -4313,7 +4315,7 @@ static struct tris_channel *skinny_new(struct skinny_line *l, int state)
 			tmp->nativeformats = default_capability;
 		fmt = tris_best_codec(tmp->nativeformats);
 		if (skinnydebug)
-			tris_verb(1, "skinny_new: tmp->nativeformats=%d fmt=%d\n", tmp->nativeformats, fmt);
+			tris_verb(1, "skinny_new: tmp->nativeformats=%lld fmt=%lld\n", (long long) tmp->nativeformats, (long long) fmt);
 		if (sub->rtp) {
 			tris_channel_set_fd(tmp, 0, tris_rtp_fd(sub->rtp));
 		}
@@ -5211,7 +5213,7 @@ static int handle_capabilities_res_message(struct skinny_req *req, struct skinny
 	struct skinny_device *d = s->device;
 	struct skinny_line *l;
 	uint32_t count = 0;
-	int codecs = 0;
+	format_t codecs = 0;
 	int i;
 
 	count = letohl(req->data.caps.count);
@@ -5231,7 +5233,7 @@ static int handle_capabilities_res_message(struct skinny_req *req, struct skinny
 	}
 
 	d->capability = d->confcapability & codecs;
-	tris_verb(0, "Device capability set to '%d'\n", d->capability);
+	tris_verb(0, "Device capability set to '%lld'\n", (long long) d->capability);
 	TRIS_LIST_TRAVERSE(&d->lines, l, list) {
 		tris_mutex_lock(&l->lock);
 		l->capability = l->confcapability & d->capability;
@@ -5558,7 +5560,7 @@ static int handle_open_receive_channel_ack_message(struct skinny_req *req, struc
 	fmt = tris_codec_pref_getsize(&l->prefs, tris_best_codec(l->capability));
 
 	if (skinnydebug)
-		tris_verb(1, "Setting payloadType to '%d' (%d ms)\n", fmt.bits, fmt.cur_ms);
+		tris_verb(1, "Setting payloadType to '%lld' (%d ms)\n", (long long) fmt.bits, fmt.cur_ms);
 
 	req->data.startmedia.conferenceId = htolel(sub->callid);
 	req->data.startmedia.passThruPartyId = htolel(sub->callid);
@@ -6488,9 +6490,9 @@ static int skinny_devicestate(void *data)
 	return get_devicestate(l);
 }
 
-static struct tris_channel *skinny_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *skinny_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
-	int oldformat;
+	format_t oldformat;
 	
 	struct skinny_line *l;
 	struct tris_channel *tmpc = NULL;
@@ -6500,7 +6502,7 @@ static struct tris_channel *skinny_request(const char *type, int format, void *d
 	oldformat = format;
 	
 	if (!(format &= TRIS_FORMAT_AUDIO_MASK)) {
-		tris_log(LOG_NOTICE, "Asked to get a channel of unsupported format '%d'\n", format);
+		tris_log(LOG_NOTICE, "Asked to get a channel of unsupported format '%lld'\n", (long long) format);
 		return NULL;
 	}
 
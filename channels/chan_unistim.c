@@ -408,7 +408,7 @@ struct unistim_line {
 	/*! AMA flags (for billing) */
 	int amaflags;
 	/*! Codec supported */
-	int capability;
+	format_t capability;
 	/*! Parkinglot */
 	char parkinglot[TRIS_MAX_CONTEXT];
 	struct unistim_line *next;
@@ -677,7 +677,7 @@ static int reload(void);
 static int unload_module(void);
 static int reload_config(void);
 static void show_main_page(struct unistimsession *pte);
-static struct tris_channel *unistim_request(const char *type, int format, 
+static struct tris_channel *unistim_request(const char *type, format_t format, 
 	void *data, int *cause, struct tris_channel* src);
 static int unistim_call(struct tris_channel *ast, char *dest, int timeout);
 static int unistim_hangup(struct tris_channel *ast);
@@ -2082,13 +2082,13 @@ static void start_rtp(struct unistim_subchannel *sub)
 	sin.sin_port = htons(sub->parent->parent->rtp_port);
 	tris_rtp_set_peer(sub->rtp, &sin);
 	if (!(sub->owner->nativeformats & sub->owner->readformat)) {
-		int fmt;
+		format_t fmt;
 		fmt = tris_best_codec(sub->owner->nativeformats);
 		tris_log(LOG_WARNING,
-				"Our read/writeformat has been changed to something incompatible : %s (%d), using %s (%d) best codec from %d\n",
+				"Our read/writeformat has been changed to something incompatible : %s (%lld), using %s (%lld) best codec from %lld\n",
 				tris_getformatname(sub->owner->readformat),
-				sub->owner->readformat, tris_getformatname(fmt), fmt,
-				sub->owner->nativeformats);
+				(long long) sub->owner->readformat, tris_getformatname(fmt), (long long) fmt,
+				(long long) sub->owner->nativeformats);
 		sub->owner->readformat = fmt;
 		sub->owner->writeformat = fmt;
 	}
@@ -2099,10 +2099,10 @@ static void start_rtp(struct unistim_subchannel *sub)
 	else
 		memcpy(&public, &public_ip, sizeof(public));    /* override  */
 	if (unistimdebug) {
-		tris_verb(0, "RTP started : Our IP/port is : %s:%hd with codec %s (%d)\n",
+		tris_verb(0, "RTP started : Our IP/port is : %s:%hd with codec %s (%lld)\n",
 			 tris_inet_ntoa(us.sin_addr),
 			 htons(us.sin_port), tris_getformatname(sub->owner->readformat),
-			 sub->owner->readformat);
+			 (long long) sub->owner->readformat);
 		tris_verb(0, "Starting phone RTP stack. Our public IP is %s\n",
 					tris_inet_ntoa(public.sin_addr));
 	}
@@ -2211,8 +2211,8 @@ static void start_rtp(struct unistim_subchannel *sub)
 		else if (sub->owner->readformat == TRIS_FORMAT_G729A)
 			buffsend[42] = 2;       /* 1 = 10ms (10 bytes), 2 = 20ms (20 bytes) */
 		else
-			tris_log(LOG_WARNING, "Unsupported codec %s (%d) !\n",
-					tris_getformatname(sub->owner->readformat), sub->owner->readformat);
+			tris_log(LOG_WARNING, "Unsupported codec %s (%lld) !\n",
+					tris_getformatname(sub->owner->readformat), (long long) sub->owner->readformat);
 		/* Source port for transmit RTP and Destination port for receiving RTP */
 		buffsend[45] = (htons(sin.sin_port) & 0xff00) >> 8;
 		buffsend[46] = (htons(sin.sin_port) & 0x00ff);
@@ -3935,10 +3935,10 @@ static struct tris_frame *unistim_rtp_read(const struct tris_channel *ast,
 		if (f->frametype == TRIS_FRAME_VOICE) {
 			if (f->subclass != sub->owner->nativeformats) {
 				tris_debug(1,
-						"Oooh, format changed from %s (%d) to %s (%d)\n",
+						"Oooh, format changed from %s (%lld) to %s (%lld)\n",
 						tris_getformatname(sub->owner->nativeformats),
-						sub->owner->nativeformats, tris_getformatname(f->subclass),
-						f->subclass);
+						(long long) sub->owner->nativeformats, tris_getformatname(f->subclass),
+						(long long) f->subclass);
 
 				sub->owner->nativeformats = f->subclass;
 				tris_set_read_format(sub->owner, sub->owner->readformat);
@@ -3978,11 +3978,11 @@ static int unistim_write(struct tris_channel *ast, struct tris_frame *frame)
 	} else {
 		if (!(frame->subclass & ast->nativeformats)) {
 			tris_log(LOG_WARNING,
-					"Asked to transmit frame type %s (%d), while native formats is %s (%d) (read/write = %s (%d)/%d)\n",
-					tris_getformatname(frame->subclass), frame->subclass,
-					tris_getformatname(ast->nativeformats), ast->nativeformats,
-					tris_getformatname(ast->readformat), ast->readformat,
-					ast->writeformat);
+					"Asked to transmit frame type %s (%lld), while native formats is %s (%lld) (read/write = %s (%lld)/%lld)\n",
+					tris_getformatname(frame->subclass), (long long) frame->subclass,
+					tris_getformatname(ast->nativeformats), (long long) ast->nativeformats,
+					tris_getformatname(ast->readformat), (long long) ast->readformat,
+					(long long) ast->writeformat);
 			return -1;
 		}
 	}
@@ -4423,7 +4423,9 @@ static struct tris_channel *unistim_new(struct unistim_subchannel *sub, int stat
 {
 	struct tris_channel *tmp;
 	struct unistim_line *l;
-	int fmt;
+	format_t fmt;
+	/* USTM/<line>@<device>-<subtype>, with room for the longest of each */
+	char name[sizeof("USTM/@-") + sizeof(l->name) + DEVICE_NAME_LEN + 11];
 
 	if (!sub) {
 		tris_log(LOG_WARNING, "subchannel null in unistim_new\n");
@@ -4448,10 +4450,10 @@ static struct tris_channel *unistim_new(struct unistim_subchannel *sub, int stat
 		tmp->nativeformats = CAPABILITY;
 	fmt = tris_best_codec(tmp->nativeformats);
 	if (unistimdebug)
-		tris_verb(0, "Best codec = %d from nativeformats %d (line cap=%d global=%d)\n", fmt,
-			 tmp->nativeformats, l->capability, CAPABILITY);
-	tris_string_field_build(tmp, name, "USTM/%s@%s-%d", l->name, l->parent->name,
-						   sub->subtype);
+		tris_verb(0, "Best codec = %lld from nativeformats %lld (line cap=%lld global=%lld)\n", (long long) fmt,
+			 (long long) tmp->nativeformats, (long long) l->capability, (long long) CAPABILITY);
+	snprintf(name, sizeof(name), "USTM/%s@%s-%d", l->name, l->parent->name, sub->subtype);
+	tris_change_name(tmp, name);
 	if ((sub->rtp) && (sub->subtype == 0)) {
 		if (unistimdebug)
 			tris_verb(0, "New unistim channel with a previous rtp handle ?\n");
@@ -4616,10 +4618,10 @@ static int restart_monitor(void)
 
 /*--- unistim_request: PBX interface function ---*/
 /* UNISTIM calls initiated by the PBX arrive here */
-static struct tris_channel *unistim_request(const char *type, int format, void *data,
+static struct tris_channel *unistim_request(const char *type, format_t format, void *data,
 										   int *cause, struct tris_channel* src)
 {
-	int oldformat;
+	format_t oldformat;
 	struct unistim_subchannel *sub;
 	struct tris_channel *tmpc = NULL;
 	char tmp[256];
@@ -4628,8 +4630,8 @@ static struct tris_channel *unistim_request(const char *type, int format, void *
 	oldformat = format;
 	format &= CAPABILITY;
 	tris_log(LOG_NOTICE,
-			"Asked to get a channel of format %s while capability is %d result : %s (%d) \n",
-			tris_getformatname(oldformat), CAPABILITY, tris_getformatname(format), format);
+			"Asked to get a channel of format %s while capability is %lld result : %s (%lld) \n",
+			tris_getformatname(oldformat), (long long) CAPABILITY, tris_getformatname(format), (long long) format);
 	if (!format) {
 		tris_log(LOG_NOTICE,
 				"Asked to get a channel of unsupported format %s while capability is %s\n",
@@ -4702,9 +4704,9 @@ static char *unistim_info(struct tris_cli_entry *e, int cmd, struct tris_cli_arg
 		line = device->lines;
 		while (line) {
 			tris_cli(a->fd,
-					"->name=%s fullname=%s exten=%s callid=%s cap=%d device=%p line=%p\n",
+					"->name=%s fullname=%s exten=%s callid=%s cap=%lld device=%p line=%p\n",
 					line->name, line->fullname, line->exten, line->cid_num,
-					line->capability, line->parent, line);
+					(long long) line->capability, line->parent, line);
 			for (i = 0; i < MAX_SUBS; i++) {
 				sub = line->subs[i];
 				if (!sub)
@@ -5551,7 +5553,7 @@ static enum tris_rtp_get_result unistim_get_rtp_peer(struct tris_channel *chan,
 }
 
 static int unistim_set_rtp_peer(struct tris_channel *chan, struct tris_rtp *rtp, 
-	struct tris_rtp *vrtp, struct tris_rtp *trtp, int codecs, int nat_active)
+	struct tris_rtp *vrtp, struct tris_rtp *trtp, format_t codecs, int nat_active)
 {
 	struct unistim_subchannel *sub;
 
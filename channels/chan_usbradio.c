@@ -660,7 +660,7 @@ static char *usbradio_active;	 /* the active device */
 
 static int setformat(struct chan_usbradio_pvt *o, int mode);
 
-static struct tris_channel *usbradio_request(const char *type, int format, void *data
+static struct tris_channel *usbradio_request(const char *type, format_t format, void *data
 , int *cause, struct tris_channel* src);
 static int usbradio_digit_begin(struct tris_channel *c, char digit);
 static int usbradio_digit_end(struct tris_channel *c, char digit, unsigned int duration);
@@ -2223,7 +2223,7 @@ static struct tris_channel *usbradio_new(struct chan_usbradio_pvt *o, char *ext,
 }
 /*
 */
-static struct tris_channel *usbradio_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+static struct tris_channel *usbradio_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	struct tris_channel *c;
 	struct chan_usbradio_pvt *o = find_desc(data);
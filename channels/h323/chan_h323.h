@@ -64,7 +64,7 @@ typedef struct call_options {
 	int				progress_audio;
 	int				dtmfcodec[2];
 	int				dtmfmode;
-	int				capability;
+	int64_t				capability;
 	int				bridge;
 	int				nat;
 	int				tunnelOptions;
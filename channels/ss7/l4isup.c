@@ -201,7 +201,7 @@ static struct ss7_chan dummy_pvt;
 static void isup_send_grs(struct ss7_chan *pvt, int count, int do_timers);
 
 /* KimPH modified the prototype for porting */
-static struct tris_channel *ss7_requester(const char *type, int format,
+static struct tris_channel *ss7_requester(const char *type, format_t format,
                                          void *data, int *cause, struct tris_channel* src);
 
 static int ss7_send_digit_begin(struct tris_channel *chan, char digit);
@@ -819,7 +819,7 @@ static struct ss7_chan* cic_hunt(struct linkset* linkset)
 
 /* Request an SS7 channel. */
 /* KimPH modified the prototype. */
-static struct tris_channel *ss7_requester(const char *type, int format,
+static struct tris_channel *ss7_requester(const char *type, format_t format,
                                          void *data, int *cause, struct tris_channel* src) {
   char *arg = data;
   struct tris_channel *chan;
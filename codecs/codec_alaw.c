@@ -31,6 +31,7 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 150729 $")
 #include "trismedia/config.h"
 #include "trismedia/translate.h"
 #include "trismedia/alaw.h"
+#include "trismedia/g711.h"
 #include "trismedia/utils.h"
 
 #define BUFFER_SAMPLES   8096	/* size for the translation buffers */
@@ -48,9 +49,28 @@ static int alawtolin_framein(struct tris_trans_pvt *pvt, struct tris_frame *f)
 
 	pvt->samples += i;
 	pvt->datalen += i * 2;	/* 2 bytes/sample */
-	
-	while (i--)
-		*dst++ = TRIS_ALAW(*src++);
+
+	tris_alaw_decode(dst, src, i);
+
+	return 0;
+}
+
+/*! \brief decode the frame of each pvt */
+static int alawtolin_framein_batch(struct tris_trans_pvt **pvts, struct tris_frame **frames, int count)
+{
+	short **dst = alloca(count * sizeof(*dst));
+	const unsigned char **src = alloca(count * sizeof(*src));
+	int *samples = alloca(count * sizeof(*samples));
+	int i;
+
+	for (i = 0; i < count; i++) {
+		dst[i] = pvts[i]->outbuf.i16 + pvts[i]->samples;
+		src[i] = frames[i]->data.ptr;
+		samples[i] = frames[i]->samples;
+		pvts[i]->samples += samples[i];
+		pvts[i]->datalen += samples[i] * 2;	/* 2 bytes/sample */
+	}
+	tris_alaw_decode_batch(dst, src, samples, count);
 
 	return 0;
 }
@@ -65,8 +85,27 @@ static int lintoalaw_framein(struct tris_trans_pvt *pvt, struct tris_frame *f)
 	pvt->samples += i;
 	pvt->datalen += i;	/* 1 byte/sample */
 
-	while (i--) 
-		*dst++ = TRIS_LIN2A(*src++);
+	tris_alaw_encode((unsigned char *) dst, src, i);
+
+	return 0;
+}
+
+/*! \brief convert and store the input samples of each pvt */
+static int lintoalaw_framein_batch(struct tris_trans_pvt **pvts, struct tris_frame **frames, int count)
+{
+	unsigned char **dst = alloca(count * sizeof(*dst));
+	const short **src = alloca(count * sizeof(*src));
+	int *samples = alloca(count * sizeof(*samples));
+	int i;
+
+	for (i = 0; i < count; i++) {
+		dst[i] = (unsigned char *) pvts[i]->outbuf.c + pvts[i]->samples;
+		src[i] = frames[i]->data.ptr;
+		samples[i] = frames[i]->samples;
+		pvts[i]->samples += samples[i];
+		pvts[i]->datalen += samples[i];	/* 1 byte/sample */
+	}
+	tris_alaw_encode_batch(dst, src, samples, count);
 
 	return 0;
 }
@@ -76,6 +115,7 @@ static struct tris_translator alawtolin = {
 	.srcfmt = TRIS_FORMAT_ALAW,
 	.dstfmt = TRIS_FORMAT_SLINEAR,
 	.framein = alawtolin_framein,
+	.framein_batch = alawtolin_framein_batch,
 	.sample = alaw_sample,
 	.buffer_samples = BUFFER_SAMPLES,
 	.buf_size = BUFFER_SAMPLES * 2,
@@ -87,6 +127,7 @@ static struct tris_translator lintoalaw = {
 	.srcfmt = TRIS_FORMAT_SLINEAR,
 	.dstfmt = TRIS_FORMAT_ALAW,
 	.framein = lintoalaw_framein,
+	.framein_batch = lintoalaw_framein_batch,
 	.sample = slin8_sample,
 	.buffer_samples = BUFFER_SAMPLES,
 	.buf_size = BUFFER_SAMPLES,
@@ -166,6 +166,15 @@ static void gsm_destroy_stuff(struct tris_trans_pvt *pvt)
 		gsm_destroy(tmp->gsm);
 }
 
+/*! \brief start over with a fresh state, the gsm state is opaque with the system libgsm */
+static int gsm_reset(struct tris_trans_pvt *pvt)
+{
+	struct gsm_translator_pvt *tmp = pvt->pvt;
+
+	gsm_destroy_stuff(pvt);
+	return (tmp->gsm = gsm_create()) ? 0 : -1;
+}
+
 static struct tris_translator gsmtolin = {
 	.name = "gsmtolin", 
 	.srcfmt = TRIS_FORMAT_GSM,
@@ -173,6 +182,7 @@ static struct tris_translator gsmtolin = {
 	.newpvt = gsm_new,
 	.framein = gsmtolin_framein,
 	.destroy = gsm_destroy_stuff,
+	.reset = gsm_reset,
 	.sample = gsm_sample,
 	.buffer_samples = BUFFER_SAMPLES,
 	.buf_size = BUFFER_SAMPLES * 2,
@@ -188,6 +198,7 @@ static struct tris_translator lintogsm = {
 	.framein = lintogsm_framein,
 	.frameout = lintogsm_frameout,
 	.destroy = gsm_destroy_stuff,
+	.reset = gsm_reset,
 	.sample = slin8_sample,
 	.desc_size = sizeof (struct gsm_translator_pvt ),
 	.buf_size = (BUFFER_SAMPLES * GSM_FRAME_LEN + GSM_SAMPLES - 1)/GSM_SAMPLES,
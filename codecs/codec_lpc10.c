@@ -191,6 +191,24 @@ static void lpc10_destroy(struct tris_trans_pvt *arg)
 	tris_free(pvt->lpc10.enc);
 }
 
+static int lpc10_enc_reset(struct tris_trans_pvt *arg)
+{
+	struct lpc10_coder_pvt *pvt = arg->pvt;
+
+	init_lpc10_encoder_state(pvt->lpc10.enc);
+	pvt->longer = 0;
+	return 0;
+}
+
+static int lpc10_dec_reset(struct tris_trans_pvt *arg)
+{
+	struct lpc10_coder_pvt *pvt = arg->pvt;
+
+	init_lpc10_decoder_state(pvt->lpc10.dec);
+	pvt->longer = 0;
+	return 0;
+}
+
 static struct tris_translator lpc10tolin = {
 	.name = "lpc10tolin", 
 	.srcfmt = TRIS_FORMAT_LPC10,
@@ -198,6 +216,7 @@ static struct tris_translator lpc10tolin = {
 	.newpvt = lpc10_dec_new,
 	.framein = lpc10tolin_framein,
 	.destroy = lpc10_destroy,
+	.reset = lpc10_dec_reset,
 	.sample = lpc10_sample,
 	.desc_size = sizeof(struct lpc10_coder_pvt),
 	.buffer_samples = BUFFER_SAMPLES,
@@ -213,6 +232,7 @@ static struct tris_translator lintolpc10 = {
 	.framein = lintolpc10_framein,
 	.frameout = lintolpc10_frameout,
 	.destroy = lpc10_destroy,
+	.reset = lpc10_enc_reset,
 	.sample = slin8_sample,
 	.desc_size = sizeof(struct lpc10_coder_pvt),
 	.buffer_samples = BUFFER_SAMPLES,
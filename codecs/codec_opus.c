@@ -0,0 +1,439 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 2009, Digium, Inc.
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ *
+ * \brief Translate between signed linear and Opus (Open Codec)
+ *
+ * Opus frames are counted in 16kHz samples.  The 8kHz translators run
+ * the codec at 8kHz, so calls to narrowband phones are not resampled.
+ *
+ * The decoders recover the packet lost right before the one they are
+ * given from the in-band FEC data it carries, and conceal any others.
+ *
+ * \ingroup codecs
+ *
+ * \extref The Opus library - http://www.opus-codec.org
+ *
+ */
+
+/*** MODULEINFO
+	<depend>opus</depend>
+ ***/
+
+#include "trismedia.h"
+
+TRISMEDIA_FILE_VERSION(__FILE__, "$Revision$")
+
+#include <opus/opus.h>
+
+#include "trismedia/translate.h"
+#include "trismedia/module.h"
+#include "trismedia/config.h"
+#include "trismedia/utils.h"
+
+/* codec variables */
+static int bitrate = 20000;	/* 0 lets the encoder pick */
+static int complexity = 5;
+static int vbr = 1;
+static int fec = 1;		/* send and use in-band forward error correction */
+static int packet_loss = 10;	/* expected loss in percent, how much FEC to send */
+static int dtx = 0;		/* set to 1 to stop sending during silence */
+
+/* bumped on every config load, coders set up before that are not reused */
+static int config_generation = 0;
+
+#define	BUFFER_SAMPLES	8000
+#define	OPUS_SAMPLES	320	/* 20ms at 16kHz */
+
+/* Longest run of lost packets worth concealing, longer gaps are a new talkspurt */
+#define MAX_LOST	5
+
+/* Sample frame data */
+#include "trismedia/slin.h"
+#include "ex_opus.h"
+
+struct opus_coder_pvt {
+	void *opus;		/* OpusEncoder or OpusDecoder */
+	int sampling_rate;
+	int framesize;		/* samples in 20ms */
+	int have_seqno;		/* decoder, next_seqno is valid */
+	int next_seqno;		/* decoder, sequence number of the packet expected next */
+	int generation;		/* config_generation when this coder was set up */
+	int16_t buf[BUFFER_SAMPLES];	/* input, waiting to be compressed */
+};
+
+static int lintoopus_construct(struct tris_trans_pvt *pvt, int sampling_rate)
+{
+	struct opus_coder_pvt *tmp = pvt->pvt;
+	int error = 0;
+
+	if (!(tmp->opus = opus_encoder_create(sampling_rate, 1, OPUS_APPLICATION_VOIP, &error))) {
+		tris_log(LOG_WARNING, "Unable to create Opus encoder: %s\n", opus_strerror(error));
+		return -1;
+	}
+
+	opus_encoder_ctl(tmp->opus, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+	opus_encoder_ctl(tmp->opus, OPUS_SET_BITRATE(bitrate ? bitrate : OPUS_AUTO));
+	opus_encoder_ctl(tmp->opus, OPUS_SET_COMPLEXITY(complexity));
+	opus_encoder_ctl(tmp->opus, OPUS_SET_VBR(vbr));
+	opus_encoder_ctl(tmp->opus, OPUS_SET_INBAND_FEC(fec));
+	opus_encoder_ctl(tmp->opus, OPUS_SET_PACKET_LOSS_PERC(fec ? packet_loss : 0));
+	opus_encoder_ctl(tmp->opus, OPUS_SET_DTX(dtx));
+	tmp->sampling_rate = sampling_rate;
+	tmp->framesize = sampling_rate / 50;
+	tmp->generation = config_generation;
+
+	return 0;
+}
+
+static int lintoopus_new(struct tris_trans_pvt *pvt)
+{
+	return lintoopus_construct(pvt, 8000);
+}
+
+static int lin16toopus_new(struct tris_trans_pvt *pvt)
+{
+	return lintoopus_construct(pvt, 16000);
+}
+
+static int opustolin_construct(struct tris_trans_pvt *pvt, int sampling_rate)
+{
+	struct opus_coder_pvt *tmp = pvt->pvt;
+	int error = 0;
+
+	if (!(tmp->opus = opus_decoder_create(sampling_rate, 1, &error))) {
+		tris_log(LOG_WARNING, "Unable to create Opus decoder: %s\n", opus_strerror(error));
+		return -1;
+	}
+
+	tmp->sampling_rate = sampling_rate;
+	tmp->framesize = sampling_rate / 50;
+	tmp->have_seqno = 0;
+	tmp->generation = config_generation;
+
+	return 0;
+}
+
+static int opustolin_new(struct tris_trans_pvt *pvt)
+{
+	return opustolin_construct(pvt, 8000);
+}
+
+static int opustolin16_new(struct tris_trans_pvt *pvt)
+{
+	return opustolin_construct(pvt, 16000);
+}
+
+/*! \brief decode into the tail of outbuf, data NULL conceals a lost packet */
+static int opustolin_decode(struct tris_trans_pvt *pvt, unsigned char *data, int datalen, int samples, int decode_fec)
+{
+	struct opus_coder_pvt *tmp = pvt->pvt;
+	int res;
+
+	if (pvt->samples + samples > BUFFER_SAMPLES) {
+		tris_log(LOG_WARNING, "Out of buffer space\n");
+		return -1;
+	}
+	res = opus_decode(tmp->opus, data, datalen, pvt->outbuf.i16 + pvt->samples, samples, decode_fec);
+	if (res < 0) {
+		tris_log(LOG_WARNING, "Opus decoding failed: %s\n", opus_strerror(res));
+		return -1;
+	}
+	pvt->samples += res;
+	pvt->datalen += 2 * res; /* 2 bytes/sample */
+	return 0;
+}
+
+/*! \brief fill in for the packets lost right before f, the last one from the FEC data in f */
+static void opustolin_recover(struct tris_trans_pvt *pvt, struct tris_frame *f)
+{
+	struct opus_coder_pvt *tmp = pvt->pvt;
+	int lost = (int16_t) (f->seqno - tmp->next_seqno);
+	int samples;
+
+	if (lost <= 0 || lost > MAX_LOST)
+		return;
+
+	/* Assume the lost packets were as long as this one */
+	samples = opus_packet_get_nb_samples(f->data.ptr, f->datalen, tmp->sampling_rate);
+	if (samples <= 0)
+		return;
+
+	while (lost--) {
+		if (lost) {
+			if (opustolin_decode(pvt, NULL, 0, samples, 0))
+				return;
+		} else if (opustolin_decode(pvt, f->data.ptr, f->datalen, samples, 1)) {
+			return;
+		}
+	}
+}
+
+/*! \brief convert and store into outbuf */
+static int opustolin_framein(struct tris_trans_pvt *pvt, struct tris_frame *f)
+{
+	struct opus_coder_pvt *tmp = pvt->pvt;
+
+	if (f->datalen == 0) {  /* Native PLC interpolation */
+		if (opustolin_decode(pvt, NULL, 0, tmp->framesize, 0))
+			return -1;
+		/* the jitterbuffer stood in for this one, it is not lost */
+		tmp->next_seqno++;
+		return 0;
+	}
+
+	/* Only frames straight from RTP have a meaningful sequence number */
+	if (fec && tris_test_flag(f, TRIS_FRFLAG_HAS_TIMING_INFO)) {
+		if (tmp->have_seqno)
+			opustolin_recover(pvt, f);
+		tmp->have_seqno = 1;
+		tmp->next_seqno = f->seqno + 1;
+	}
+
+	return opustolin_decode(pvt, f->data.ptr, f->datalen, BUFFER_SAMPLES - pvt->samples, 0);
+}
+
+/*! \brief store input frame in work buffer */
+static int lintoopus_framein(struct tris_trans_pvt *pvt, struct tris_frame *f)
+{
+	struct opus_coder_pvt *tmp = pvt->pvt;
+
+	memcpy(tmp->buf + pvt->samples, f->data.ptr, f->datalen);
+	pvt->samples += f->samples;
+	return 0;
+}
+
+/*! \brief convert work buffer and produce output frame */
+static struct tris_frame *lintoopus_frameout(struct tris_trans_pvt *pvt)
+{
+	struct opus_coder_pvt *tmp = pvt->pvt;
+	int datalen;	/* output bytes */
+	int samples;	/* input samples */
+
+	/* We can't work on anything less than a frame in size */
+	if (pvt->samples < tmp->framesize)
+		return NULL;
+
+	/* Send all we have as one packet, Opus takes 20, 40 or 60ms */
+	samples = MIN(pvt->samples / tmp->framesize, 3) * tmp->framesize;
+	datalen = opus_encode(tmp->opus, tmp->buf, samples, pvt->outbuf.uc, pvt->t->buf_size);
+
+	/* Move the data at the end of the buffer to the front */
+	pvt->samples -= samples;
+	if (pvt->samples)
+		memmove(tmp->buf, tmp->buf + samples, pvt->samples * 2);
+
+	if (datalen < 0) {
+		tris_log(LOG_WARNING, "Opus encoding failed: %s\n", opus_strerror(datalen));
+		return NULL;
+	}
+	/* With DTX, packets of one or two bytes mean silence and need not be sent */
+	if (dtx && datalen <= 2)
+		return NULL;
+
+	/* Opus frames are counted at 16kHz */
+	return tris_trans_frameout(pvt, datalen, samples * (16000 / tmp->sampling_rate));
+}
+
+static void opustolin_destroy(struct tris_trans_pvt *arg)
+{
+	struct opus_coder_pvt *pvt = arg->pvt;
+
+	opus_decoder_destroy(pvt->opus);
+}
+
+static void lintoopus_destroy(struct tris_trans_pvt *arg)
+{
+	struct opus_coder_pvt *pvt = arg->pvt;
+
+	opus_encoder_destroy(pvt->opus);
+}
+
+static int opustolin_reset(struct tris_trans_pvt *arg)
+{
+	struct opus_coder_pvt *pvt = arg->pvt;
+
+	if (pvt->generation != config_generation)
+		return -1;
+
+	opus_decoder_ctl(pvt->opus, OPUS_RESET_STATE);
+	pvt->have_seqno = 0;
+
+	return 0;
+}
+
+static int lintoopus_reset(struct tris_trans_pvt *arg)
+{
+	struct opus_coder_pvt *pvt = arg->pvt;
+
+	if (pvt->generation != config_generation)
+		return -1;
+
+	/* keeps the settings, only the coding state is cleared */
+	opus_encoder_ctl(pvt->opus, OPUS_RESET_STATE);
+
+	return 0;
+}
+
+static struct tris_translator opustolin = {
+	.name = "opustolin",
+	.srcfmt = TRIS_FORMAT_OPUS,
+	.dstfmt = TRIS_FORMAT_SLINEAR,
+	.newpvt = opustolin_new,
+	.framein = opustolin_framein,
+	.destroy = opustolin_destroy,
+	.reset = opustolin_reset,
+	.sample = opus_sample,
+	.desc_size = sizeof(struct opus_coder_pvt),
+	.buffer_samples = BUFFER_SAMPLES,
+	.buf_size = BUFFER_SAMPLES * 2,
+	.native_plc = 1,
+};
+
+static struct tris_translator lintoopus = {
+	.name = "lintoopus",
+	.srcfmt = TRIS_FORMAT_SLINEAR,
+	.dstfmt = TRIS_FORMAT_OPUS,
+	.newpvt = lintoopus_new,
+	.framein = lintoopus_framein,
+	.frameout = lintoopus_frameout,
+	.destroy = lintoopus_destroy,
+	.reset = lintoopus_reset,
+	.sample = slin8_sample,
+	.desc_size = sizeof(struct opus_coder_pvt),
+	.buffer_samples = BUFFER_SAMPLES,
+	.buf_size = BUFFER_SAMPLES * 2,
+};
+
+static struct tris_translator opustolin16 = {
+	.name = "opustolin16",
+	.srcfmt = TRIS_FORMAT_OPUS,
+	.dstfmt = TRIS_FORMAT_SLINEAR16,
+	.newpvt = opustolin16_new,
+	.framein = opustolin_framein,
+	.destroy = opustolin_destroy,
+	.reset = opustolin_reset,
+	.sample = opus_sample,
+	.desc_size = sizeof(struct opus_coder_pvt),
+	.buffer_samples = BUFFER_SAMPLES,
+	.buf_size = BUFFER_SAMPLES * 2,
+	.native_plc = 1,
+};
+
+static struct tris_translator lin16toopus = {
+	.name = "lin16toopus",
+	.srcfmt = TRIS_FORMAT_SLINEAR16,
+	.dstfmt = TRIS_FORMAT_OPUS,
+	.newpvt = lin16toopus_new,
+	.framein = lintoopus_framein,
+	.frameout = lintoopus_frameout,
+	.destroy = lintoopus_destroy,
+	.reset = lintoopus_reset,
+	.sample = slin16_sample,
+	.desc_size = sizeof(struct opus_coder_pvt),
+	.buffer_samples = BUFFER_SAMPLES,
+	.buf_size = BUFFER_SAMPLES * 2,
+};
+
+static int parse_config(int reload)
+{
+	struct tris_flags config_flags = { reload ? CONFIG_FLAG_FILEUNCHANGED : 0 };
+	struct tris_config *cfg = tris_config_load("codecs.conf", config_flags);
+	struct tris_variable *var;
+	int res;
+
+	if (cfg == CONFIG_STATUS_FILEMISSING || cfg == CONFIG_STATUS_FILEUNCHANGED || cfg == CONFIG_STATUS_FILEINVALID)
+		return 0;
+
+	config_generation++;
+
+	for (var = tris_variable_browse(cfg, "opus"); var; var = var->next) {
+		if (!strcasecmp(var->name, "bitrate")) {
+			if (!strcasecmp(var->value, "auto")) {
+				tris_verb(3, "CODEC OPUS: Letting the encoder pick the bitrate\n");
+				bitrate = 0;
+			} else if (sscanf(var->value, "%30d", &res) == 1 && res >= 6000 && res <= 510000) {
+				tris_verb(3, "CODEC OPUS: Setting Bitrate to %d\n", res);
+				bitrate = res;
+			} else
+				tris_log(LOG_ERROR, "Error! Bitrate must be 6000-510000 or auto\n");
+		} else if (!strcasecmp(var->name, "complexity")) {
+			if (sscanf(var->value, "%30d", &res) == 1 && res >= 0 && res <= 10) {
+				tris_verb(3, "CODEC OPUS: Setting Complexity to %d\n", res);
+				complexity = res;
+			} else
+				tris_log(LOG_ERROR, "Error! Complexity must be 0-10\n");
+		} else if (!strcasecmp(var->name, "vbr")) {
+			vbr = tris_true(var->value) ? 1 : 0;
+			tris_verb(3, "CODEC OPUS: VBR Mode. [%s]\n", vbr ? "on" : "off");
+		} else if (!strcasecmp(var->name, "fec")) {
+			fec = tris_true(var->value) ? 1 : 0;
+			tris_verb(3, "CODEC OPUS: In-band FEC. [%s]\n", fec ? "on" : "off");
+		} else if (!strcasecmp(var->name, "packet_loss")) {
+			if (sscanf(var->value, "%30d", &res) == 1 && res >= 0 && res <= 100) {
+				tris_verb(3, "CODEC OPUS: Setting expected Packet Loss to %d%%\n", res);
+				packet_loss = res;
+			} else
+				tris_log(LOG_ERROR, "Error! Packet Loss must be 0-100\n");
+		} else if (!strcasecmp(var->name, "dtx")) {
+			dtx = tris_true(var->value) ? 1 : 0;
+			tris_verb(3, "CODEC OPUS: DTX Mode. [%s]\n", dtx ? "on" : "off");
+		}
+	}
+	tris_config_destroy(cfg);
+	return 0;
+}
+
+static int reload(void)
+{
+	if (parse_config(1))
+		return TRIS_MODULE_LOAD_DECLINE;
+	return TRIS_MODULE_LOAD_SUCCESS;
+}
+
+static int unload_module(void)
+{
+	int res = 0;
+
+	res |= tris_unregister_translator(&opustolin);
+	res |= tris_unregister_translator(&lintoopus);
+	res |= tris_unregister_translator(&opustolin16);
+	res |= tris_unregister_translator(&lin16toopus);
+
+	return res;
+}
+
+static int load_module(void)
+{
+	int res = 0;
+
+	if (parse_config(0))
+		return TRIS_MODULE_LOAD_DECLINE;
+
+	res |= tris_register_translator(&opustolin);
+	res |= tris_register_translator(&lintoopus);
+	res |= tris_register_translator(&opustolin16);
+	res |= tris_register_translator(&lin16toopus);
+
+	return res;
+}
+
+TRIS_MODULE_INFO(TRISMEDIA_GPL_KEY, TRIS_MODFLAG_DEFAULT, "Opus Coder/Decoder",
+		.load = load_module,
+		.unload = unload_module,
+		.reload = reload,
+	       );
@@ -63,6 +63,9 @@ static float vbr_quality = 4;
 static int abr = 0;
 static int dtx = 0;	/* set to 1 to enable silence detection */
 
+/* bumped on every config load, coders set up before that are not reused */
+static int config_generation = 0;
+
 static int preproc = 0;
 static int pp_vad = 0;
 static int pp_agc = 0;
@@ -89,6 +92,7 @@ struct speex_coder_pvt {
 	SpeexBits bits;
 	int framesize;
 	int silent_state;
+	int generation;	/* config_generation when this coder was set up */
 #ifdef _SPEEX_TYPES_H
 	SpeexPreprocessState *pp;
 	spx_int16_t buf[BUFFER_SAMPLES];
@@ -134,6 +138,7 @@ static int speex_encoder_construct(struct tris_trans_pvt *pvt, const SpeexMode *
 	if (dtx)
 		speex_encoder_ctl(tmp->speex, SPEEX_SET_DTX, &dtx); 
 	tmp->silent_state = 0;
+	tmp->generation = config_generation;
 
 	return 0;
 }
@@ -159,6 +164,7 @@ static int speex_decoder_construct(struct tris_trans_pvt *pvt, const SpeexMode *
 	speex_decoder_ctl(tmp->speex, SPEEX_GET_FRAME_SIZE, &tmp->framesize);
 	if (enhancement)
 		speex_decoder_ctl(tmp->speex, SPEEX_SET_ENH, &enhancement);
+	tmp->generation = config_generation;
 
 	return 0;
 }
@@ -328,6 +334,38 @@ static void lintospeex_destroy(struct tris_trans_pvt *arg)
 	speex_bits_destroy(&pvt->bits);
 }
 
+static int speextolin_reset(struct tris_trans_pvt *arg)
+{
+	struct speex_coder_pvt *pvt = arg->pvt;
+
+	if (pvt->generation != config_generation)
+		return -1;
+
+	speex_decoder_ctl(pvt->speex, SPEEX_RESET_STATE, NULL);
+	speex_bits_reset(&pvt->bits);
+
+	return 0;
+}
+
+static int lintospeex_reset(struct tris_trans_pvt *arg)
+{
+	struct speex_coder_pvt *pvt = arg->pvt;
+
+	if (pvt->generation != config_generation)
+		return -1;
+#ifdef _SPEEX_TYPES_H
+	/* the preprocessor can't be reset, set up a new one */
+	if (pvt->pp)
+		return -1;
+#endif
+
+	speex_encoder_ctl(pvt->speex, SPEEX_RESET_STATE, NULL);
+	speex_bits_reset(&pvt->bits);
+	pvt->silent_state = 0;
+
+	return 0;
+}
+
 static struct tris_translator speextolin = {
 	.name = "speextolin", 
 	.srcfmt = TRIS_FORMAT_SPEEX,
@@ -335,6 +373,7 @@ static struct tris_translator speextolin = {
 	.newpvt = speextolin_new,
 	.framein = speextolin_framein,
 	.destroy = speextolin_destroy,
+	.reset = speextolin_reset,
 	.sample = speex_sample,
 	.desc_size = sizeof(struct speex_coder_pvt),
 	.buffer_samples = BUFFER_SAMPLES,
@@ -350,6 +389,7 @@ static struct tris_translator lintospeex = {
 	.framein = lintospeex_framein,
 	.frameout = lintospeex_frameout,
 	.destroy = lintospeex_destroy,
+	.reset = lintospeex_reset,
 	.sample = slin8_sample,
 	.desc_size = sizeof(struct speex_coder_pvt),
 	.buffer_samples = BUFFER_SAMPLES,
@@ -363,6 +403,7 @@ static struct tris_translator speexwbtolin16 = {
 	.newpvt = speexwbtolin16_new,
 	.framein = speextolin_framein,
 	.destroy = speextolin_destroy,
+	.reset = speextolin_reset,
 	.sample = speex16_sample,
 	.desc_size = sizeof(struct speex_coder_pvt),
 	.buffer_samples = BUFFER_SAMPLES,
@@ -378,6 +419,7 @@ static struct tris_translator lin16tospeexwb = {
 	.framein = lintospeex_framein,
 	.frameout = lintospeex_frameout,
 	.destroy = lintospeex_destroy,
+	.reset = lintospeex_reset,
 	.sample = slin16_sample,
 	.desc_size = sizeof(struct speex_coder_pvt),
 	.buffer_samples = BUFFER_SAMPLES,
@@ -395,6 +437,8 @@ static int parse_config(int reload)
 	if (cfg == CONFIG_STATUS_FILEMISSING || cfg == CONFIG_STATUS_FILEUNCHANGED || cfg == CONFIG_STATUS_FILEINVALID)
 		return 0;
 
+	config_generation++;
+
 	for (var = tris_variable_browse(cfg, "speex"); var; var = var->next) {
 		if (!strcasecmp(var->name, "quality")) {
 			res = abs(atoi(var->value));
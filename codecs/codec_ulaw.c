@@ -31,6 +31,7 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 150729 $")
 #include "trismedia/config.h"
 #include "trismedia/translate.h"
 #include "trismedia/ulaw.h"
+#include "trismedia/g711.h"
 #include "trismedia/utils.h"
 
 #define BUFFER_SAMPLES   8096	/* size for the translation buffers */
@@ -50,8 +51,27 @@ static int ulawtolin_framein(struct tris_trans_pvt *pvt, struct tris_frame *f)
 	pvt->datalen += i * 2;	/* 2 bytes/sample */
 
 	/* convert and copy in outbuf */
-	while (i--)
-		*dst++ = TRIS_MULAW(*src++);
+	tris_ulaw_decode(dst, src, i);
+
+	return 0;
+}
+
+/*! \brief convert and store the samples of each frame in its pvt */
+static int ulawtolin_framein_batch(struct tris_trans_pvt **pvts, struct tris_frame **frames, int count)
+{
+	short **dst = alloca(count * sizeof(*dst));
+	const unsigned char **src = alloca(count * sizeof(*src));
+	int *samples = alloca(count * sizeof(*samples));
+	int i;
+
+	for (i = 0; i < count; i++) {
+		dst[i] = pvts[i]->outbuf.i16 + pvts[i]->samples;
+		src[i] = frames[i]->data.ptr;
+		samples[i] = frames[i]->samples;
+		pvts[i]->samples += samples[i];
+		pvts[i]->datalen += samples[i] * 2;	/* 2 bytes/sample */
+	}
+	tris_ulaw_decode_batch(dst, src, samples, count);
 
 	return 0;
 }
@@ -66,8 +86,27 @@ static int lintoulaw_framein(struct tris_trans_pvt *pvt, struct tris_frame *f)
 	pvt->samples += i;
 	pvt->datalen += i;	/* 1 byte/sample */
 
-	while (i--)
-		*dst++ = TRIS_LIN2MU(*src++);
+	tris_ulaw_encode((unsigned char *) dst, src, i);
+
+	return 0;
+}
+
+/*! \brief convert and store the samples of each frame in its pvt */
+static int lintoulaw_framein_batch(struct tris_trans_pvt **pvts, struct tris_frame **frames, int count)
+{
+	unsigned char **dst = alloca(count * sizeof(*dst));
+	const short **src = alloca(count * sizeof(*src));
+	int *samples = alloca(count * sizeof(*samples));
+	int i;
+
+	for (i = 0; i < count; i++) {
+		dst[i] = (unsigned char *) pvts[i]->outbuf.c + pvts[i]->samples;
+		src[i] = frames[i]->data.ptr;
+		samples[i] = frames[i]->samples;
+		pvts[i]->samples += samples[i];
+		pvts[i]->datalen += samples[i];	/* 1 byte/sample */
+	}
+	tris_ulaw_encode_batch(dst, src, samples, count);
 
 	return 0;
 }
@@ -81,6 +120,7 @@ static struct tris_translator ulawtolin = {
 	.srcfmt = TRIS_FORMAT_ULAW,
 	.dstfmt = TRIS_FORMAT_SLINEAR,
 	.framein = ulawtolin_framein,
+	.framein_batch = ulawtolin_framein_batch,
 	.sample = ulaw_sample,
 	.buffer_samples = BUFFER_SAMPLES,
 	.buf_size = BUFFER_SAMPLES * 2,
@@ -96,6 +136,7 @@ static struct tris_translator lintoulaw = {
 	.srcfmt = TRIS_FORMAT_SLINEAR,
 	.dstfmt = TRIS_FORMAT_ULAW,
 	.framein = lintoulaw_framein,
+	.framein_batch = lintoulaw_framein_batch,
 	.sample = slin8_sample,
 	.buf_size = BUFFER_SAMPLES,
 	.buffer_samples = BUFFER_SAMPLES,
@@ -0,0 +1,34 @@
+/*! \file
+ * \brief Random Data
+ *
+ * Copyright (C) 2008, Digium, Inc.
+ *
+ * Distributed under the terms of the GNU General Public License
+ *
+ */
+
+/* A TOC byte for one 20ms SILK wideband frame, then random data */
+static uint8_t ex_opus[] = {
+	0x48, 0xa5, 0x4d, 0xca, 0x18, 0x25, 0x30, 0xbb, 0x1d, 0x6d,
+	0x13, 0x2c, 0xde, 0xd6, 0x23, 0x7b, 0x2e, 0xd9, 0x1e, 0x3f,
+	0x72, 0x1f, 0xcb, 0x19, 0x71, 0x17, 0x44, 0x94, 0xd6, 0x49,
+	0x3c, 0x9d, 0x5c, 0x34, 0x60, 0xbe, 0x31, 0x20, 0x1e, 0x69,
+	0xfe, 0xda, 0xa0, 0xee, 0xe8, 0xb9, 0x99, 0x7f,
+};
+
+static struct tris_frame *opus_sample(void)
+{
+	static struct tris_frame f = {
+		.frametype = TRIS_FRAME_VOICE,
+		.subclass = TRIS_FORMAT_OPUS,
+		.datalen = sizeof(ex_opus),
+		/* 20 ms at 16kHz */
+		.samples = OPUS_SAMPLES,
+		.mallocd = 0,
+		.offset = 0,
+		.src = __PRETTY_FUNCTION__,
+		.data.ptr = ex_opus,
+	};
+
+	return &f;
+}
@@ -0,0 +1,25 @@
+/*
+ * defaults.h 
+ * Automatically generated from build options,
+ * only used in main/trismedia.c
+ */
+#define DEFAULT_CONFIG_FILE "/usr/local/etc/trismedia/trismedia.conf"
+
+#define DEFAULT_CONFIG_DIR "/usr/local/etc/trismedia"
+#define DEFAULT_MODULE_DIR "/usr/local/lib/trismedia/modules"
+#define DEFAULT_AGI_DIR    "/usr/local/var/trismedia/agi-bin"
+#define DEFAULT_LOG_DIR    "/var/log/trismedia"
+
+#define DEFAULT_RUN_DIR    "/var/run"
+#define DEFAULT_SOCKET     "/var/run/trismedia.ctl"
+#define DEFAULT_PID        "/var/run/trismedia.pid"
+
+#define DEFAULT_VAR_DIR    "/usr/local/var/trismedia"
+#define DEFAULT_DB         "/usr/local/var/trismedia/astdb"
+
+#define DEFAULT_DATA_DIR   "/usr/local/var/trismedia"
+#define DEFAULT_KEY_DIR    "/usr/local/var/trismedia/keys"
+
+#define DEFAULT_SPOOL_DIR  "/usr/local/spool/trismedia"
+#define DEFAULT_TMP_DIR    "/usr/local/spool/trismedia/tmp"
+
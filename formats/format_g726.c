@@ -142,8 +142,8 @@ static int g726_write(struct tris_filestream *s, struct tris_frame *f)
 		return -1;
 	}
 	if (f->subclass != TRIS_FORMAT_G726) {
-		tris_log(LOG_WARNING, "Asked to write non-G726 frame (%d)!\n", 
-						f->subclass);
+		tris_log(LOG_WARNING, "Asked to write non-G726 frame (%s)!\n", 
+						tris_getformatname(f->subclass));
 		return -1;
 	}
 	if (f->datalen % frame_size[fs->rate]) {
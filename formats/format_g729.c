@@ -67,7 +67,7 @@ static int g729_write(struct tris_filestream *fs, struct tris_frame *f)
 		return -1;
 	}
 	if (f->subclass != TRIS_FORMAT_G729A) {
-		tris_log(LOG_WARNING, "Asked to write non-G729 frame (%d)!\n", f->subclass);
+		tris_log(LOG_WARNING, "Asked to write non-G729 frame (%s)!\n", tris_getformatname(f->subclass));
 		return -1;
 	}
 	if (f->datalen % 10) {
@@ -75,7 +75,7 @@ static int gsm_write(struct tris_filestream *fs, struct tris_frame *f)
 		return -1;
 	}
 	if (f->subclass != TRIS_FORMAT_GSM) {
-		tris_log(LOG_WARNING, "Asked to write non-GSM frame (%d)!\n", f->subclass);
+		tris_log(LOG_WARNING, "Asked to write non-GSM frame (%s)!\n", tris_getformatname(f->subclass));
 		return -1;
 	}
 	if (!(f->datalen % 65)) {
@@ -117,7 +117,7 @@ static int h263_write(struct tris_filestream *fs, struct tris_frame *f)
 		mark=0x8000;
 	subclass &= ~0x1;
 	if (subclass != TRIS_FORMAT_H263) {
-		tris_log(LOG_WARNING, "Asked to write non-h263 frame (%d)!\n", f->subclass);
+		tris_log(LOG_WARNING, "Asked to write non-h263 frame (%s)!\n", tris_getformatname(f->subclass));
 		return -1;
 	}
 	ts = htonl(f->samples);
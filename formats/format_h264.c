@@ -106,7 +106,7 @@ static int h264_write(struct tris_filestream *s, struct tris_frame *f)
 	}
 	mark = (f->subclass & 0x1) ? 0x8000 : 0;
 	if ((f->subclass & ~0x1) != TRIS_FORMAT_H264) {
-		tris_log(LOG_WARNING, "Asked to write non-h264 frame (%d)!\n", f->subclass);
+		tris_log(LOG_WARNING, "Asked to write non-h264 frame (%s)!\n", tris_getformatname(f->subclass));
 		return -1;
 	}
 	ts = htonl(f->samples);
@@ -65,7 +65,7 @@ static int ilbc_write(struct tris_filestream *fs, struct tris_frame *f)
 		return -1;
 	}
 	if (f->subclass != TRIS_FORMAT_ILBC) {
-		tris_log(LOG_WARNING, "Asked to write non-iLBC frame (%d)!\n", f->subclass);
+		tris_log(LOG_WARNING, "Asked to write non-iLBC frame (%s)!\n", tris_getformatname(f->subclass));
 		return -1;
 	}
 	if (f->datalen % 50) {
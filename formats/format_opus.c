@@ -0,0 +1,206 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 2009, Digium, Inc.
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ *
+ * \brief Save to raw Opus packets, each after its length.
+ * \arg File name extension: opusraw
+ * \ingroup formats
+ *
+ * Opus packets vary in size, so every packet is stored after its length
+ * as a 16 bit big endian number.  How long a packet plays for is in its
+ * first byte, so seeking walks the packets.  This is not Ogg Opus.
+ */
+
+#include "trismedia.h"
+
+TRISMEDIA_FILE_VERSION(__FILE__, "$Revision$")
+
+#include "trismedia/mod_format.h"
+#include "trismedia/module.h"
+#include "trismedia/endian.h"
+
+#define BUF_SIZE	4000	/* 60 ms at the highest bitrate */
+
+struct opus_desc {
+	off_t samples;	/* where we are in the file, in 16kHz samples */
+};
+
+/*! \brief Samples in the packet at the current position, which is skipped.
+ * \retval -1 at the end of the file
+ */
+static int opus_skip(struct tris_filestream *fs)
+{
+	struct tris_frame f = { TRIS_FRAME_VOICE, };
+	unsigned char toc[2];
+	uint16_t len;
+
+	if (fread(&len, 1, sizeof(len), fs->f) != sizeof(len))
+		return -1;
+	len = ntohs(len);
+	f.subclass = TRIS_FORMAT_OPUS;
+	f.data.ptr = toc;
+	f.datalen = MIN(len, sizeof(toc));
+	if (!len || fread(toc, 1, f.datalen, fs->f) != f.datalen)
+		return -1;
+	if (fseeko(fs->f, len - f.datalen, SEEK_CUR))
+		return -1;
+	return tris_codec_get_samples(&f);
+}
+
+static struct tris_frame *opus_read(struct tris_filestream *s, int *whennext)
+{
+	struct opus_desc *desc = s->_private;
+	uint16_t len;
+	int res;
+
+	/* Send a frame from the file to the appropriate channel */
+	if (fread(&len, 1, sizeof(len), s->f) != sizeof(len))
+		return NULL;
+	len = ntohs(len);
+	if (!len || len > BUF_SIZE) {
+		tris_log(LOG_WARNING, "Invalid Opus packet length %d\n", len);
+		return NULL;
+	}
+	s->fr.frametype = TRIS_FRAME_VOICE;
+	s->fr.subclass = TRIS_FORMAT_OPUS;
+	s->fr.mallocd = 0;
+	TRIS_FRAME_SET_BUFFER(&s->fr, s->buf, TRIS_FRIENDLY_OFFSET, len);
+	if ((res = fread(s->fr.data.ptr, 1, s->fr.datalen, s->f)) != s->fr.datalen) {
+		if (res)
+			tris_log(LOG_WARNING, "Short read (%d of %d) (%s)!\n", res, len, strerror(errno));
+		return NULL;
+	}
+	*whennext = s->fr.samples = tris_codec_get_samples(&s->fr);
+	desc->samples += s->fr.samples;
+	return &s->fr;
+}
+
+static int opus_write(struct tris_filestream *fs, struct tris_frame *f)
+{
+	struct opus_desc *desc = fs->_private;
+	uint16_t len;
+	int res;
+
+	if (f->frametype != TRIS_FRAME_VOICE) {
+		tris_log(LOG_WARNING, "Asked to write non-voice frame!\n");
+		return -1;
+	}
+	if (f->subclass != TRIS_FORMAT_OPUS) {
+		tris_log(LOG_WARNING, "Asked to write non-Opus frame (%s)!\n", tris_getformatname(f->subclass));
+		return -1;
+	}
+	if (!f->datalen || f->datalen > BUF_SIZE) {
+		tris_log(LOG_WARNING, "Invalid Opus packet length %d\n", f->datalen);
+		return -1;
+	}
+	len = htons(f->datalen);
+	if ((res = fwrite(&len, 1, sizeof(len), fs->f)) != sizeof(len)) {
+		tris_log(LOG_WARNING, "Bad write (%d/2): %s\n", res, strerror(errno));
+		return -1;
+	}
+	if ((res = fwrite(f->data.ptr, 1, f->datalen, fs->f)) != f->datalen) {
+		tris_log(LOG_WARNING, "Bad write (%d/%d): %s\n", res, f->datalen, strerror(errno));
+		return -1;
+	}
+	desc->samples += f->samples;
+	return 0;
+}
+
+static int opus_seek(struct tris_filestream *fs, off_t sample_offset, int whence)
+{
+	struct opus_desc *desc = fs->_private;
+	off_t target, pos;
+	int samples;
+
+	if (whence == SEEK_SET) {
+		target = sample_offset;
+	} else if (whence == SEEK_CUR || whence == SEEK_FORCECUR) {
+		target = desc->samples + sample_offset;
+	} else if (whence == SEEK_END) {
+		/* Find out how long the file is first */
+		while ((samples = opus_skip(fs)) >= 0)
+			desc->samples += samples;
+		target = desc->samples - sample_offset;
+	} else {
+		return -1;
+	}
+
+	/* always protect against seeking past begining. */
+	if (target < 0)
+		target = 0;
+
+	/* Packets only say how long they are, so going back means starting over */
+	if (target < desc->samples) {
+		if (fseeko(fs->f, 0, SEEK_SET))
+			return -1;
+		desc->samples = 0;
+	}
+
+	/* Stop at the start of the packet that plays at target, or at the end */
+	for (;;) {
+		pos = ftello(fs->f);
+		if ((samples = opus_skip(fs)) < 0 || desc->samples + samples > target)
+			break;
+		desc->samples += samples;
+	}
+
+	return fseeko(fs->f, pos, SEEK_SET);
+}
+
+static int opus_trunc(struct tris_filestream *fs)
+{
+	/* Truncate file to current length */
+	return ftruncate(fileno(fs->f), ftello(fs->f));
+}
+
+static off_t opus_tell(struct tris_filestream *fs)
+{
+	struct opus_desc *desc = fs->_private;
+
+	return desc->samples;
+}
+
+static const struct tris_format opus_f = {
+	.name = "opus",
+	.exts = "opusraw",
+	.format = TRIS_FORMAT_OPUS,
+	.write = opus_write,
+	.seek = opus_seek,
+	.trunc = opus_trunc,
+	.tell = opus_tell,
+	.read = opus_read,
+	.buf_size = BUF_SIZE + TRIS_FRIENDLY_OFFSET,
+	.desc_size = sizeof(struct opus_desc),
+};
+
+static int load_module(void)
+{
+	if (tris_format_register(&opus_f))
+		return TRIS_MODULE_LOAD_FAILURE;
+	return TRIS_MODULE_LOAD_SUCCESS;
+}
+
+static int unload_module(void)
+{
+	return tris_format_unregister(opus_f.name);
+}
+
+TRIS_MODULE_INFO(TRISMEDIA_GPL_KEY, TRIS_MODFLAG_LOAD_ORDER, "Raw Opus packets",
+	.load = load_module,
+	.unload = unload_module,
+	.load_pri = 10,
+);
@@ -164,7 +164,7 @@ static int pcm_write(struct tris_filestream *fs, struct tris_frame *f)
 		return -1;
 	}
 	if (f->subclass != fs->fmt->format) {
-		tris_log(LOG_WARNING, "Asked to write incompatible format frame (%d)!\n", f->subclass);
+		tris_log(LOG_WARNING, "Asked to write incompatible format frame (%s)!\n", tris_getformatname(f->subclass));
 		return -1;
 	}
 
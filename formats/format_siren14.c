@@ -62,7 +62,7 @@ static int siren14write(struct tris_filestream *fs, struct tris_frame *f)
 		return -1;
 	}
 	if (f->subclass != TRIS_FORMAT_SIREN14) {
-		tris_log(LOG_WARNING, "Asked to write non-Siren14 frame (%d)!\n", f->subclass);
+		tris_log(LOG_WARNING, "Asked to write non-Siren14 frame (%s)!\n", tris_getformatname(f->subclass));
 		return -1;
 	}
 	if ((res = fwrite(f->data.ptr, 1, f->datalen, fs->f)) != f->datalen) {
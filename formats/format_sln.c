@@ -60,7 +60,7 @@ static int slinear_write(struct tris_filestream *fs, struct tris_frame *f)
 		return -1;
 	}
 	if (f->subclass != TRIS_FORMAT_SLINEAR) {
-		tris_log(LOG_WARNING, "Asked to write non-slinear frame (%d)!\n", f->subclass);
+		tris_log(LOG_WARNING, "Asked to write non-slinear frame (%s)!\n", tris_getformatname(f->subclass));
 		return -1;
 	}
 	if ((res = fwrite(f->data.ptr, 1, f->datalen, fs->f)) != f->datalen) {
@@ -62,7 +62,7 @@ static int vox_write(struct tris_filestream *s, struct tris_frame *f)
 		return -1;
 	}
 	if (f->subclass != TRIS_FORMAT_ADPCM) {
-		tris_log(LOG_WARNING, "Asked to write non-ADPCM frame (%d)!\n", f->subclass);
+		tris_log(LOG_WARNING, "Asked to write non-ADPCM frame (%s)!\n", tris_getformatname(f->subclass));
 		return -1;
 	}
 	if ((res = fwrite(f->data.ptr, 1, f->datalen, s->f)) != f->datalen) {
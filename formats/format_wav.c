@@ -398,7 +398,7 @@ static int wav_write(struct tris_filestream *fs, struct tris_frame *f)
 		return -1;
 	}
 	if (f->subclass != TRIS_FORMAT_SLINEAR) {
-		tris_log(LOG_WARNING, "Asked to write non-SLINEAR frame (%d)!\n", f->subclass);
+		tris_log(LOG_WARNING, "Asked to write non-SLINEAR frame (%s)!\n", tris_getformatname(f->subclass));
 		return -1;
 	}
 	if (!f->datalen)
@@ -433,7 +433,7 @@ static int wav_write(struct tris_filestream *s, struct tris_frame *f)
 		return -1;
 	}
 	if (f->subclass != TRIS_FORMAT_GSM) {
-		tris_log(LOG_WARNING, "Asked to write non-GSM frame (%d)!\n", f->subclass);
+		tris_log(LOG_WARNING, "Asked to write non-GSM frame (%s)!\n", tris_getformatname(f->subclass));
 		return -1;
 	}
 	/* XXX this might fail... if the input is a multiple of MSGSM_FRAME_SIZE
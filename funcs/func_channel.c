@@ -178,6 +178,16 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 243485 $")
 						<para>     <literal>minrtt</literal>            Round trip time (minimum)</para>
 						<para>     <literal>normdevrtt</literal>        Round trip time (normal deviation)</para>
 						<para>     <literal>stdevrtt</literal>          Round trip time (standard deviation)</para>
+						<para>     <literal>rx_syscalls</literal>       System calls that received RTP</para>
+						<para>     <literal>rx_datagrams</literal>      RTP datagrams received</para>
+						<para>     <literal>rx_dropped</literal>        RTP datagrams read ahead and dropped as too large</para>
+						<para>     <literal>tx_syscalls</literal>       System calls that sent RTP</para>
+						<para>     <literal>tx_datagrams</literal>      RTP datagrams sent</para>
+						<para>     <literal>tx_errors</literal>         RTP datagrams that could not be sent</para>
+						<para>     <literal>rtcp_rx_syscalls</literal>  System calls that received RTCP</para>
+						<para>     <literal>rtcp_rx_datagrams</literal> RTCP datagrams received</para>
+						<para>     <literal>rtcp_tx_syscalls</literal>  System calls that sent RTCP</para>
+						<para>     <literal>rtcp_tx_datagrams</literal> RTCP datagrams sent</para>
 						<para>     <literal>all</literal>               All statistics (in a form suited to logging,
 						but not for parsing)</para>
 					</enum>
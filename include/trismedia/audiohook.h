@@ -95,7 +95,7 @@ struct tris_audiohook {
 	struct tris_slinfactory write_factory;                  /*!< Factory where frames written to the channel will go through */
 	struct timeval read_time;                              /*!< Last time read factory was fed */
 	struct timeval write_time;                             /*!< Last time write factory was fed */
-	int format;                                            /*!< Format translation path is setup as */
+	format_t format;                                       /*!< Format translation path is setup as */
 	struct tris_trans_pvt *trans_pvt;                       /*!< Translation path for reading frames */
 	tris_audiohook_manipulate_callback manipulate_callback; /*!< Manipulation callback */
 	struct tris_audiohook_options options;                  /*!< Applicable options */
@@ -133,7 +133,7 @@ int tris_audiohook_write_frame(struct tris_audiohook *audiohook, enum tris_audio
  * \param format Format of frame remote side wants back
  * \return Returns frame on success, NULL on failure
  */
-struct tris_frame *tris_audiohook_read_frame(struct tris_audiohook *audiohook, size_t samples, enum tris_audiohook_direction direction, int format);
+struct tris_frame *tris_audiohook_read_frame(struct tris_audiohook *audiohook, size_t samples, enum tris_audiohook_direction direction, format_t format);
 
 /*! \brief Attach audiohook to channel
  * \param chan Channel
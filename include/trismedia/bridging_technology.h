@@ -71,7 +71,7 @@ struct tris_bridge_technology {
 	/*! Callback for poking a bridge thread */
 	int (*poke)(struct tris_bridge *bridge, struct tris_bridge_channel *bridge_channel);
 	/*! Formats that the bridge technology supports */
-	int formats;
+	format_t formats;
 	/*! Bit to indicate whether the bridge technology is currently suspended or not */
 	unsigned int suspended:1;
 	/*! Module this bridge technology belongs to. Is used for reference counting when creating/destroying a bridge. */
@@ -0,0 +1,19 @@
+/*
+ * buildopts.h 
+ * Automatically generated
+ */
+
+#define LOADABLE_MODULES 1
+#define TRIS_MODULE_RES_ADSI 1
+#define TRIS_MODULE_CHAN_LOCAL 1
+#define TRIS_MODULE_APP_VOICEMAIL 1
+#define TRIS_MODULE_RES_MONITOR 1
+#define TRIS_MODULE_RES_AGI 1
+#define TRIS_MODULE_RES_SMDI 1
+#define TRIS_MODULE_RES_SIP_CORE 1
+#define TRIS_MODULE_RES_AEL_SHARE 1
+#define TRIS_MODULE_DEBUG_THREADS 1
+#define TRIS_MODULE_G711_NEW_ALGORITHM 1
+#define TRIS_MODULE_CHAN_USBRADIO 1
+#define TRIS_BUILDOPT_SUM "eda0f88d8ac6011b303a7b4db735727c"
+#define TRIS_BUILDOPTS "LOADABLE_MODULES"
@@ -227,12 +227,12 @@ struct tris_channel_tech {
 	const char * const type;
 	const char * const description;
 
-	int capabilities;		/*!< Bitmap of formats this channel can handle */
+	format_t capabilities;		/*!< Bitmap of formats this channel can handle */
 
 	int properties;			/*!< Technology Properties */
 
 	/*! \brief Requester - to set up call data structures (pvt's) */
-	struct tris_channel *(* const requester)(const char *type, int format, void *data, int *cause, struct tris_channel* src);
+	struct tris_channel *(* const requester)(const char *type, format_t format, void *data, int *cause, struct tris_channel* src);
 
 	int (* const devicestate)(void *data);	/*!< Devicestate call back */
 
@@ -333,6 +333,7 @@ struct tris_channel_tech {
 };
 
 struct tris_epoll_data;
+struct tris_channel_index_entry;
 
 /*!
  * The high bit of the frame count is used as a debug marker, so
@@ -457,6 +458,9 @@ struct tris_channel {
 	tris_group_t pickupgroup;			/*!< Pickup group - which calls groups can be picked up? */
 	TRIS_LIST_HEAD_NOLOCK(, tris_frame) readq;
 	TRIS_LIST_ENTRY(tris_channel) chan_list;		/*!< For easy linking */
+	struct tris_channel_index_entry *name_entry;	/*!< Entry in the channel registry index by name */
+	struct tris_channel_index_entry *uniqueid_entry;	/*!< Entry in the channel registry index by uniqueid */
+	int walkers;					/*!< Registry walks that hold the channel and may be waiting for its lock */
 	struct tris_jb jb;				/*!< The jitterbuffer state */
 	struct timeval dtmf_tv;				/*!< The time that an in process digit began, or the last digit ended */
 	TRIS_LIST_HEAD_NOLOCK(datastores, tris_datastore) datastores; /*!< Data stores on the channel */
@@ -473,7 +477,7 @@ struct tris_channel {
 	int fdno;					/*!< Which fd had an event detected on */
 	int streamid;					/*!< For streaming playback, the schedule ID */
 	int vstreamid;					/*!< For streaming video playback, the schedule ID */
-	int oldwriteformat;				/*!< Original writer format */
+	format_t oldwriteformat;		/*!< Original writer format */
 	int timingfd;					/*!< Timing fd */
 	enum tris_channel_state _state;			/*!< State of line -- Don't write directly, use tris_setstate() */
 	int rings;					/*!< Number of rings so far */
@@ -488,11 +492,11 @@ struct tris_channel {
 	int hangupcause;				/*!< Why is the channel hanged up. See causes.h */
 	unsigned int flags;				/*!< channel flags of TRIS_FLAG_ type */
 	int alertpipe[2];
-	int nativeformats;				/*!< Kinds of data this channel can natively handle */
-	int readformat;					/*!< Requested read format */
-	int writeformat;				/*!< Requested write format */
-	int rawreadformat;				/*!< Raw read format */
-	int rawwriteformat;				/*!< Raw write format */
+	format_t nativeformats;				/*!< Kinds of data this channel can natively handle */
+	format_t readformat;			/*!< Requested read format */
+	format_t writeformat;				/*!< Requested write format */
+	format_t rawreadformat;				/*!< Raw read format */
+	format_t rawwriteformat;		/*!< Raw write format */
 	unsigned int emulate_dtmf_duration;		/*!< Number of ms left to emulate DTMF for */
 #ifdef HAVE_EPOLL
 	int epfd;
@@ -880,7 +884,7 @@ void  tris_channel_free(struct tris_channel *);
  * \retval NULL failure
  * \retval non-NULL channel on success
  */
-struct tris_channel *tris_request(const char *type, int format, void *data, int *status, struct tris_channel* src);
+struct tris_channel *tris_request(const char *type, format_t format, void *data, int *status, struct tris_channel* src);
 
 /*!
  * \brief Request a channel of a given type, with data as optional information used
@@ -897,7 +901,7 @@ struct tris_channel *tris_request(const char *type, int format, void *data, int
  * \return Returns an tris_channel on success or no answer, NULL on failure.  Check the value of chan->_state
  * to know if the call was answered or not.
  */
-struct tris_channel *tris_request_and_dial(const char *type, int format, void *data,
+struct tris_channel *tris_request_and_dial(const char *type, format_t format, void *data,
 	int timeout, int *reason, const char *cid_num, const char *cid_name);
 
 /*!
@@ -914,7 +918,7 @@ struct tris_channel *tris_request_and_dial(const char *type, int format, void *d
  * \return Returns an tris_channel on success or no answer, NULL on failure.  Check the value of chan->_state
  * to know if the call was answered or not.
  */
-struct tris_channel *__tris_request_and_dial(const char *type, int format, void *data, int timeout, int *reason,
+struct tris_channel *__tris_request_and_dial(const char *type, format_t format, void *data, int timeout, int *reason,
 		const char *cid_num, const char *cid_name, struct outgoing_helper *oh);
 /*!
 * \brief Forwards a call to a new channel specified by the original channel's call_forward str.  If possible, the new forwarded channel is created and returned while the original one is terminated.
@@ -926,7 +930,7 @@ struct tris_channel *__tris_request_and_dial(const char *type, int format, void
 * \param outstate reason why unsuccessful (if uncuccessful)
 * \return Returns the forwarded call's tris_channel on success or NULL on failure
 */
-struct tris_channel *tris_call_forward(struct tris_channel *caller, struct tris_channel *orig, int *timeout, int format, struct outgoing_helper *oh, int *outstate);
+struct tris_channel *tris_call_forward(struct tris_channel *caller, struct tris_channel *orig, int *timeout, format_t format, struct outgoing_helper *oh, int *outstate);
 
 /*!\brief Register a channel technology (a new channel driver)
  * Called by a channel module to register the kind of channels it supports.
@@ -1271,7 +1275,7 @@ int tris_prod(struct tris_channel *chan);
  * \param format format to change to
  * \return Returns 0 on success, -1 on failure
  */
-int tris_set_read_format(struct tris_channel *chan, int format);
+int tris_set_read_format(struct tris_channel *chan, format_t format);
 
 /*! \brief Sets write format on channel chan
  * Set write format for channel to whichever component of "format" is best.
@@ -1279,7 +1283,7 @@ int tris_set_read_format(struct tris_channel *chan, int format);
  * \param format new format for writing
  * \return Returns 0 on success, -1 on failure
  */
-int tris_set_write_format(struct tris_channel *chan, int format);
+int tris_set_write_format(struct tris_channel *chan, format_t format);
 
 /*!
  * \brief Sends text to a channel
@@ -1511,7 +1515,7 @@ int tris_channel_setoption(struct tris_channel *channel, int option, void *data,
 
 /*! Pick the best codec  */
 /* Choose the best codec...  Uhhh...   Yah. */
-int tris_best_codec(int fmts);
+format_t tris_best_codec(format_t fmts);
 
 
 /*! Checks the value of an option */
@@ -70,6 +70,11 @@ extern "C" {
  * \param userdata the data provider in the call to tris_event_subscribe()
  *
  * \return The event callbacks do not return anything.
+ *
+ * \note Events are dispatched by a pool of threads.  Events for the same
+ *       mailbox or device are passed to the subscribers in the order they
+ *       were queued, but a callback may be running for more than one
+ *       mailbox or device at a time.
  */
 typedef void (*tris_event_cb_t)(const struct tris_event *event, void *userdata);
 
@@ -350,7 +355,8 @@ void tris_event_destroy(struct tris_event *event);
  * This function queues an event to be dispatched to all of the appropriate
  * subscribers.  This function will not block while the event is being
  * dispatched because the event is queued up for a dispatching thread 
- * to handle.
+ * to handle.  Subscribers that require a mailbox or device other than
+ * the one in the event are not checked against it.
  */
 int tris_event_queue(struct tris_event *event);
 
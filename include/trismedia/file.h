@@ -33,6 +33,8 @@
 #include <sys/mman.h>
 #endif
 
+#include "trismedia/frame.h"
+
 #if defined(__cplusplus) || defined(c_plusplus)
 extern "C" {
 #endif
@@ -90,9 +92,9 @@ int tris_stopstream(struct tris_channel *c);
  * \param fmt the format you wish to check (the extension)
  * \param preflang (the preferred language you wisht to find the file in)
  * See if a given file exists in a given format.  If fmt is NULL,  any format is accepted.
- * \return -1 if file does not exist, non-zero positive otherwise.
+ * \return the formats the file exists in, 0 if it does not exist.
  */
-int tris_fileexists(const char *filename, const char *fmt, const char *preflang);
+format_t tris_fileexists(const char *filename, const char *fmt, const char *preflang);
 
 /*! 
  * \brief Renames a file 
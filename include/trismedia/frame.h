@@ -34,9 +34,16 @@ extern "C" {
 #include "trismedia/endian.h"
 #include "trismedia/linkedlists.h"
 
+/*! \brief A set of formats (TRIS_FORMAT_*), or a single one.
+ *
+ * Formats are bits in a 64 bit mask, so testing whether two sets of
+ * formats have anything in common stays a single AND.
+ */
+typedef int64_t format_t;
+
 struct tris_codec_pref {
-	char order[32];
-	char framing[32];
+	char order[64];
+	char framing[64];
 };
 
 /*! \page Def_Frame AST Multimedia and signalling frames
@@ -148,7 +155,7 @@ struct tris_frame {
 	/*! Kind of frame */
 	enum tris_frame_type frametype;				
 	/*! Subclass, frame dependent */
-	int subclass;				
+	format_t subclass;				
 	/*! Length of data */
 	int datalen;				
 	/*! Number of samples in this frame */
@@ -245,66 +252,69 @@ extern struct tris_frame tris_null_frame;
 
 /* Data formats for capabilities and frames alike */
 /*! G.723.1 compression */
-#define TRIS_FORMAT_G723_1	(1 << 0)
+#define TRIS_FORMAT_G723_1	(1ULL << 0)
 /*! GSM compression */
-#define TRIS_FORMAT_GSM		(1 << 1)
+#define TRIS_FORMAT_GSM		(1ULL << 1)
 /*! Raw mu-law data (G.711) */
-#define TRIS_FORMAT_ULAW		(1 << 2)
+#define TRIS_FORMAT_ULAW		(1ULL << 2)
 /*! Raw A-law data (G.711) */
-#define TRIS_FORMAT_ALAW		(1 << 3)
+#define TRIS_FORMAT_ALAW		(1ULL << 3)
 /*! ADPCM (G.726, 32kbps, AAL2 codeword packing) */
-#define TRIS_FORMAT_G726_AAL2	(1 << 4)
+#define TRIS_FORMAT_G726_AAL2	(1ULL << 4)
 /*! ADPCM (IMA) */
-#define TRIS_FORMAT_ADPCM	(1 << 5)
+#define TRIS_FORMAT_ADPCM	(1ULL << 5)
 /*! Raw 16-bit Signed Linear (8000 Hz) PCM */
-#define TRIS_FORMAT_SLINEAR	(1 << 6)
+#define TRIS_FORMAT_SLINEAR	(1ULL << 6)
 /*! LPC10, 180 samples/frame */
-#define TRIS_FORMAT_LPC10	(1 << 7)
+#define TRIS_FORMAT_LPC10	(1ULL << 7)
 /*! G.729A audio */
-#define TRIS_FORMAT_G729A	(1 << 8)
+#define TRIS_FORMAT_G729A	(1ULL << 8)
 /*! SpeeX Free Compression */
-#define TRIS_FORMAT_SPEEX	(1 << 9)
+#define TRIS_FORMAT_SPEEX	(1ULL << 9)
 /*! iLBC Free Compression */
-#define TRIS_FORMAT_ILBC		(1 << 10)
+#define TRIS_FORMAT_ILBC		(1ULL << 10)
 /*! ADPCM (G.726, 32kbps, RFC3551 codeword packing) */
-#define TRIS_FORMAT_G726		(1 << 11)
+#define TRIS_FORMAT_G726		(1ULL << 11)
 /*! G.722 */
-#define TRIS_FORMAT_G722		(1 << 12)
+#define TRIS_FORMAT_G722		(1ULL << 12)
 /*! G.722.1 (also known as Siren7, 32kbps assumed) */
-#define TRIS_FORMAT_SPEEX16	(1 << 13)
+#define TRIS_FORMAT_SPEEX16	(1ULL << 13)
 /*! G.722.1 Annex C (also known as Siren14, 48kbps assumed) */
-#define TRIS_FORMAT_SIREN14	(1 << 14)
+#define TRIS_FORMAT_SIREN14	(1ULL << 14)
 /*! Raw 16-bit Signed Linear (16000 Hz) PCM */
-#define TRIS_FORMAT_SLINEAR16	(1 << 15)
-/*! Maximum audio mask */
-#define TRIS_FORMAT_AUDIO_MASK   ((1 << 16)-1)
+#define TRIS_FORMAT_SLINEAR16	(1ULL << 15)
+/*! Maximum audio mask, bits 0-15 and 32-47 are audio */
+#define TRIS_FORMAT_AUDIO_MASK   0xFFFF0000FFFFULL
 /*! JPEG Images */
-#define TRIS_FORMAT_JPEG		(1 << 16)
+#define TRIS_FORMAT_JPEG		(1ULL << 16)
 /*! PNG Images */
-#define TRIS_FORMAT_PNG		(1 << 17)
+#define TRIS_FORMAT_PNG		(1ULL << 17)
 /*! H.261 Video */
-#define TRIS_FORMAT_H261		(1 << 18)
+#define TRIS_FORMAT_H261		(1ULL << 18)
 /*! H.263 Video */
-#define TRIS_FORMAT_H263		(1 << 19)
+#define TRIS_FORMAT_H263		(1ULL << 19)
 /*! H.263+ Video */
-#define TRIS_FORMAT_H263_PLUS	(1 << 20)
+#define TRIS_FORMAT_H263_PLUS	(1ULL << 20)
 /*! H.264 Video */
-#define TRIS_FORMAT_H264		(1 << 21)
+#define TRIS_FORMAT_H264		(1ULL << 21)
 /*! MPEG4 Video */
-#define TRIS_FORMAT_MP4_VIDEO	(1 << 22)
-#define TRIS_FORMAT_VIDEO_MASK   (((1 << 24)-1) & ~(TRIS_FORMAT_AUDIO_MASK))
+#define TRIS_FORMAT_MP4_VIDEO	(1ULL << 22)
+/*! Video mask, bits 16-23 and 48-55 are images and video */
+#define TRIS_FORMAT_VIDEO_MASK   0xFF000000FF0000ULL
 /*! T.140 RED Text format RFC 4103 */
-#define TRIS_FORMAT_T140RED      (1 << 25)
+#define TRIS_FORMAT_T140RED      (1ULL << 25)
 /*! T.140 Text format - ITU T.140, RFC 4103 */
-#define TRIS_FORMAT_T140		(1 << 26)
+#define TRIS_FORMAT_T140		(1ULL << 26)
 /*! Maximum text mask */
-#define TRIS_FORMAT_MAX_TEXT	(1 << 27)
-#define TRIS_FORMAT_TEXT_MASK   (((1 << 28)-1) & ~(TRIS_FORMAT_AUDIO_MASK) & ~(TRIS_FORMAT_VIDEO_MASK))
-#define TRIS_FORMAT_FILE	(1 << 28)
-#define TRIS_FORMAT_DESKTOP (1 << 29)
-#define TRIS_FORMAT_CHAT (1 << 30)
+#define TRIS_FORMAT_MAX_TEXT	(1ULL << 27)
+#define TRIS_FORMAT_TEXT_MASK   0xF000000ULL
+#define TRIS_FORMAT_FILE	(1ULL << 28)
+#define TRIS_FORMAT_DESKTOP (1ULL << 29)
+#define TRIS_FORMAT_CHAT (1ULL << 30)
 /*! SpeeX Wideband (16kHz) Free Compression */
-#define TRIS_FORMAT_SIREN7    (1 << 31)
+#define TRIS_FORMAT_SIREN7    (1ULL << 31)
+/*! Opus, decoded at 16kHz, always a 48kHz clock on the wire */
+#define TRIS_FORMAT_OPUS	(1ULL << 32)
 
 enum tris_control_frame_type {
 	TRIS_CONTROL_HANGUP = 1,		/*!< Other end has hungup */
@@ -467,7 +477,7 @@ struct tris_option_header {
 
 /*! \brief Definition of supported media formats (codecs) */
 struct tris_format_list {
-	int bits;	/*!< bitmask value */
+	format_t bits;	/*!< bitmask value */
 	char *name;	/*!< short name */
 	int samplespersecond; /*!< Number of samples per second (8000/16000) */
 	char *desc;	/*!< Description */
@@ -540,7 +550,7 @@ void tris_swapcopy_samples(void *dst, const void *src, int samples);
  * \param format id of format
  * \return A static string containing the name of the format or "unknown" if unknown.
  */
-char* tris_getformatname(int format);
+char* tris_getformatname(format_t format);
 
 /*! \brief Get the names of a set of formats
  * \param buf a buffer for the output string
@@ -550,21 +560,21 @@ char* tris_getformatname(int format);
  * ex: for format=TRIS_FORMAT_GSM|TRIS_FORMAT_SPEEX|TRIS_FORMAT_ILBC it will return "0x602 (GSM|SPEEX|ILBC)"
  * \return The return value is buf.
  */
-char* tris_getformatname_multiple(char *buf, size_t size, int format);
+char* tris_getformatname_multiple(char *buf, size_t size, format_t format);
 
 /*!
  * \brief Gets a format from a name.
  * \param name string of format
  * \return This returns the form of the format in binary on success, 0 on error.
  */
-int tris_getformatbyname(const char *name);
+format_t tris_getformatbyname(const char *name);
 
 /*! \brief Get a name from a format 
  * Gets a name from a format
  * \param codec codec number (1,2,4,8,16,etc.)
  * \return This returns a static string identifying the format on success, 0 on error.
  */
-char *tris_codec2str(int codec);
+char *tris_codec2str(format_t codec);
 
 /*! \name TRIS_Smoother 
 */
@@ -640,38 +650,38 @@ void tris_codec_pref_init(struct tris_codec_pref *pref);
  * \brief Codec located at a particular place in the preference index.
  * \arg \ref AudioCodecPref 
 */
-int tris_codec_pref_index(struct tris_codec_pref *pref, int index);
+format_t tris_codec_pref_index(struct tris_codec_pref *pref, int index);
 
 /*! \brief Remove audio a codec from a preference list */
-void tris_codec_pref_remove(struct tris_codec_pref *pref, int format);
+void tris_codec_pref_remove(struct tris_codec_pref *pref, format_t format);
 
 /*! \brief Append a audio codec to a preference list, removing it first if it was already there 
 */
-int tris_codec_pref_append(struct tris_codec_pref *pref, int format);
+int tris_codec_pref_append(struct tris_codec_pref *pref, format_t format);
 
 /*! \brief Prepend an audio codec to a preference list, removing it first if it was already there 
 */
-void tris_codec_pref_prepend(struct tris_codec_pref *pref, int format, int only_if_existing);
+void tris_codec_pref_prepend(struct tris_codec_pref *pref, format_t format, int only_if_existing);
 
 /*! \brief Select the best audio format according to preference list from supplied options. 
    If "find_best" is non-zero then if nothing is found, the "Best" format of 
    the format list is selected, otherwise 0 is returned. */
-int tris_codec_choose(struct tris_codec_pref *pref, int formats, int find_best);
+format_t tris_codec_choose(struct tris_codec_pref *pref, format_t formats, int find_best);
 
 /*! \brief Set packet size for codec
 */
-int tris_codec_pref_setsize(struct tris_codec_pref *pref, int format, int framems);
+int tris_codec_pref_setsize(struct tris_codec_pref *pref, format_t format, int framems);
 
 /*! \brief Get packet size for codec
 */
-struct tris_format_list tris_codec_pref_getsize(struct tris_codec_pref *pref, int format);
+struct tris_format_list tris_codec_pref_getsize(struct tris_codec_pref *pref, format_t format);
 
 /*! \brief Parse an "allow" or "deny" line in a channel or device configuration 
         and update the capabilities mask and pref if provided.
 	Video codecs are not added to codec preference lists, since we can not transcode
 	\return Returns number of errors encountered during parsing
  */
-int tris_parse_allow_disallow(struct tris_codec_pref *pref, int *mask, const char *list, int allowing);
+int tris_parse_allow_disallow(struct tris_codec_pref *pref, format_t *mask, const char *list, int allowing);
 
 /*! \brief Dump audio codec preference list into a string */
 int tris_codec_pref_string(struct tris_codec_pref *pref, char *buf, size_t size);
@@ -683,14 +693,14 @@ void tris_codec_pref_convert(struct tris_codec_pref *pref, char *buf, size_t siz
 int tris_codec_get_samples(struct tris_frame *f);
 
 /*! \brief Returns the number of bytes for the number of samples of the given format */
-int tris_codec_get_len(int format, int samples);
+int tris_codec_get_len(format_t format, int samples);
 
 /*! \brief Appends a frame to the end of a list of frames, truncating the maximum length of the list */
 struct tris_frame *tris_frame_enqueue(struct tris_frame *head, struct tris_frame *f, int maxlen, int dupe);
 
 
 /*! \brief Gets duration in ms of interpolation frame for a format */
-static inline int tris_codec_interp_len(int format) 
+static inline int tris_codec_interp_len(format_t format) 
 { 
 	return (format == TRIS_FORMAT_ILBC) ? 30 : 20;
 }
@@ -717,13 +727,14 @@ int tris_frame_slinear_sum(struct tris_frame *f1, struct tris_frame *f2);
 /*!
  * \brief Get the sample rate for a given format.
  */
-static force_inline int tris_format_rate(int format)
+static force_inline int tris_format_rate(format_t format)
 {
 	switch (format) {
 	case TRIS_FORMAT_G722:
 	case TRIS_FORMAT_SLINEAR16:
 	case TRIS_FORMAT_SIREN7:
 	case TRIS_FORMAT_SPEEX16:
+	case TRIS_FORMAT_OPUS:
 		return 16000;
 	case TRIS_FORMAT_SIREN14:
 		return 32000;
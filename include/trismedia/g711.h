@@ -0,0 +1,126 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 2009, Digium, Inc.
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ * \brief Block conversion between G.711 and signed linear
+ *
+ * Converts a whole buffer of u-law or a-law audio at a time, with the
+ * same results as TRIS_MULAW(), TRIS_LIN2MU(), TRIS_ALAW() and
+ * TRIS_LIN2A().  Like the mixing kernels in mix.h, the kernels are
+ * picked at startup for the CPU Trismedia runs on.
+ */
+
+#ifndef _TRISMEDIA_G711_H
+#define _TRISMEDIA_G711_H
+
+#if defined(__cplusplus) || defined(c_plusplus)
+extern "C" {
+#endif
+
+/*!
+ * \brief Convert u-law to signed linear
+ *
+ * \param dst Buffer with room for the signed linear samples
+ * \param src u-law audio
+ * \param samples Number of samples to convert
+ */
+void tris_ulaw_decode(short *dst, const unsigned char *src, int samples);
+
+/*!
+ * \brief Convert signed linear to u-law
+ *
+ * \param dst Buffer with room for samples bytes of u-law
+ * \param src Signed linear audio
+ * \param samples Number of samples to convert
+ */
+void tris_ulaw_encode(unsigned char *dst, const short *src, int samples);
+
+/*!
+ * \brief Convert a-law to signed linear
+ *
+ * \param dst Buffer with room for the signed linear samples
+ * \param src a-law audio
+ * \param samples Number of samples to convert
+ */
+void tris_alaw_decode(short *dst, const unsigned char *src, int samples);
+
+/*!
+ * \brief Convert signed linear to a-law
+ *
+ * \param dst Buffer with room for samples bytes of a-law
+ * \param src Signed linear audio
+ * \param samples Number of samples to convert
+ */
+void tris_alaw_encode(unsigned char *dst, const short *src, int samples);
+
+/*!
+ * \brief Convert several buffers of u-law to signed linear in one pass
+ *
+ * \param dst Buffer for each of the count conversions
+ * \param src u-law audio for each conversion
+ * \param samples Number of samples in each conversion
+ * \param count Number of conversions
+ */
+void tris_ulaw_decode_batch(short **dst, const unsigned char **src, const int *samples, int count);
+
+/*!
+ * \brief Convert several buffers of signed linear to u-law in one pass
+ *
+ * \param dst Buffer for each of the count conversions
+ * \param src Signed linear audio for each conversion
+ * \param samples Number of samples in each conversion
+ * \param count Number of conversions
+ */
+void tris_ulaw_encode_batch(unsigned char **dst, const short **src, const int *samples, int count);
+
+/*!
+ * \brief Convert several buffers of a-law to signed linear in one pass
+ *
+ * \param dst Buffer for each of the count conversions
+ * \param src a-law audio for each conversion
+ * \param samples Number of samples in each conversion
+ * \param count Number of conversions
+ */
+void tris_alaw_decode_batch(short **dst, const unsigned char **src, const int *samples, int count);
+
+/*!
+ * \brief Convert several buffers of signed linear to a-law in one pass
+ *
+ * \param dst Buffer for each of the count conversions
+ * \param src Signed linear audio for each conversion
+ * \param samples Number of samples in each conversion
+ * \param count Number of conversions
+ */
+void tris_alaw_encode_batch(unsigned char **dst, const short **src, const int *samples, int count);
+
+/*!
+ * \brief Name of the kernels in use, for example "avx2"
+ */
+const char *tris_g711_kernel(void);
+
+/*!
+ * \brief Pick the G.711 kernels for this CPU
+ *
+ * \note Called once at startup, after tris_ulaw_init() and tris_alaw_init().
+ * Until then the table driven kernels are used.
+ */
+void tris_g711_init(void);
+
+#if defined(__cplusplus) || defined(c_plusplus)
+}
+#endif
+
+#endif /* _TRISMEDIA_G711_H */
@@ -56,6 +56,10 @@ struct io_context;
  * \brief Creates a context 
  * Create a context for I/O operations
  * Basically mallocs an IO structure and sets up some default values.
+ * On Linux the context waits with epoll, so the cost of tris_io_wait() follows
+ * the number of active fds rather than registered ones, and falls back to
+ * poll() if no epoll instance can be created.  An fd can then only be added
+ * once per context.
  * \return an allocated io_context structure
  */
 struct io_context *io_context_create(void);
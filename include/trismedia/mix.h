@@ -0,0 +1,105 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 2009, Digium, Inc.
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ * \brief Signed linear audio mixing
+ *
+ * Saturated mixing of signed linear audio for conferences, bridges and
+ * audiohooks.  Samples saturate at -32767 and 32767, the same as
+ * tris_slinear_saturated_add() and friends.  The kernels are picked at
+ * startup for the CPU Trismedia runs on, so callers should use these
+ * instead of a loop over the per sample helpers.
+ *
+ * To mix N parties, accumulate every party into one wide buffer with
+ * tris_mix_accumulate(), then produce the audio each party hears with
+ * tris_mix_minus().  This is O(N) instead of O(N^2) and only saturates
+ * once per sample.
+ */
+
+#ifndef _TRISMEDIA_MIX_H
+#define _TRISMEDIA_MIX_H
+
+#if defined(__cplusplus) || defined(c_plusplus)
+extern "C" {
+#endif
+
+/*!
+ * \brief Add src to dst, saturating
+ *
+ * \param dst Buffer to mix into
+ * \param src Audio to mix in
+ * \param samples Number of samples in both buffers
+ */
+void tris_mix_add(short *dst, const short *src, int samples);
+
+/*!
+ * \brief Subtract src from dst, saturating
+ *
+ * \param dst Buffer to take src out of
+ * \param src Audio to take out
+ * \param samples Number of samples in both buffers
+ */
+void tris_mix_subtract(short *dst, const short *src, int samples);
+
+/*!
+ * \brief Add src to a wide mix buffer
+ *
+ * \param acc Mix buffer, zeroed before the first party is accumulated
+ * \param src Audio of one party
+ * \param samples Number of samples in both buffers
+ *
+ * \note acc does not saturate, it holds the sum of up to 65536 parties.
+ */
+void tris_mix_accumulate(int *acc, const short *src, int samples);
+
+/*!
+ * \brief Produce the audio of a wide mix buffer without one party in it
+ *
+ * \param dst Buffer for the result
+ * \param acc Mix buffer filled by tris_mix_accumulate()
+ * \param own Audio the party contributed to acc, or NULL for a party that
+ *        only listens
+ * \param samples Number of samples in the buffers
+ */
+void tris_mix_minus(short *dst, const int *acc, const short *own, int samples);
+
+/*!
+ * \brief Adjust the volume of audio, saturating
+ *
+ * \param buf Audio to adjust
+ * \param samples Number of samples in buf
+ * \param adjustment Positive values multiply every sample by adjustment,
+ *        negative values divide by -adjustment, as in tris_frame_adjust_volume()
+ */
+void tris_mix_gain(short *buf, int samples, int adjustment);
+
+/*!
+ * \brief Name of the kernels in use, for example "avx2"
+ */
+const char *tris_mix_kernel(void);
+
+/*!
+ * \brief Pick the mixing kernels for this CPU
+ *
+ * \note Called once at startup.  Until then the portable kernels are used.
+ */
+void tris_mix_init(void);
+
+#if defined(__cplusplus) || defined(c_plusplus)
+}
+#endif
+
+#endif /* _TRISMEDIA_MIX_H */
@@ -60,6 +60,79 @@ void *tris_netsock_data(const struct tris_netsock *ns);
 
 void tris_netsock_unref(struct tris_netsock *ns);
 
+/*! \name Batched datagram I/O
+ * On systems with recvmmsg() and sendmmsg(), several UDP datagrams can be read
+ * or sent with one system call. A receive batch reads ahead whatever is queued
+ * on the socket and hands the datagrams out one per tris_udp_batch_recvfrom()
+ * call. A send batch collects datagrams until it is flushed or full. Without
+ * a batch (NULL), or without those system calls, these fall back to plain
+ * recvfrom() and sendto().
+ */
+/*@{ */
+
+/*! \brief Datagrams read ahead from, or waiting to be sent on, one UDP socket */
+struct tris_udp_batch;
+
+/*! \brief System call and datagram counts of one UDP socket */
+struct tris_udp_batch_stats {
+	int rxcalls;		/*!< Receive system calls that returned data */
+	int rxpackets;		/*!< Datagrams received */
+	int rxdropped;		/*!< Datagrams read ahead and dropped, as they did not fit a slot */
+	int txcalls;		/*!< Send system calls */
+	int txpackets;		/*!< Datagrams sent */
+	int txerrors;		/*!< Datagrams that could not be sent */
+};
+
+/*! \brief Max amount of datagrams in one batch */
+#define TRIS_UDP_BATCH_MAX	64
+
+/*!
+ * \brief Allocate a batch
+ * \param size Max amount of datagrams per system call, 2 to TRIS_UDP_BATCH_MAX
+ * \param mtu Size of each datagram slot. Larger datagrams are sent right away;
+ *        read ahead, they spill into one buffer shared by the batch, so only the
+ *        last such datagram of a read is kept and the others are dropped and
+ *        counted in rxdropped.
+ * \return the batch, NULL if \a size is less than 2 or batching is not supported
+ */
+struct tris_udp_batch *tris_udp_batch_alloc(int size, size_t mtu);
+
+void tris_udp_batch_free(struct tris_udp_batch *batch);
+
+/*! \brief Max amount of datagrams per system call, 0 for a NULL batch */
+int tris_udp_batch_size(const struct tris_udp_batch *batch);
+
+/*!
+ * \brief recvfrom() that reads ahead up to a batch of datagrams at once
+ * \param batch Receive batch of the socket, NULL to read one datagram
+ * \param stats Counters to update, may be NULL
+ * \return the length of the datagram, -1 with errno set on error
+ */
+ssize_t tris_udp_batch_recvfrom(struct tris_udp_batch *batch, int fd, void *buf, size_t len,
+	struct sockaddr_in *sin, struct tris_udp_batch_stats *stats);
+
+/*! \brief Datagrams read ahead and not handed out yet */
+int tris_udp_batch_pending(const struct tris_udp_batch *batch);
+
+/*!
+ * \brief sendto() that queues the datagram on a send batch
+ * The batch is flushed when full, or first if it holds datagrams for another socket.
+ * \param batch Send batch, NULL to send right away
+ * \param stats Counters to update, may be NULL
+ * \return \a len, -1 with errno set on error. Errors sending queued datagrams are
+ *         logged and counted in txerrors.
+ */
+ssize_t tris_udp_batch_sendto(struct tris_udp_batch *batch, int fd, const void *buf, size_t len,
+	const struct sockaddr_in *sin, struct tris_udp_batch_stats *stats);
+
+/*!
+ * \brief Send the datagrams queued on a batch
+ * \return the number of queued datagrams that could not be sent
+ */
+int tris_udp_batch_flush(struct tris_udp_batch *batch, struct tris_udp_batch_stats *stats);
+
+/*@} */
+
 #if defined(__cplusplus) || defined(c_plusplus)
 }
 #endif
@@ -845,11 +845,11 @@ int tris_async_goto_by_name(const char *chan, const char *context, const char *e
 
 /*! Synchronously or asynchronously make an outbound call and send it to a
    particular extension */
-int tris_pbx_outgoing_exten(const char *type, int format, void *data, int timeout, const char *context, const char *exten, int priority, int *reason, int sync, const char *cid_num, const char *cid_name, struct tris_variable *vars, const char *account, struct tris_channel **locked_channel);
+int tris_pbx_outgoing_exten(const char *type, format_t format, void *data, int timeout, const char *context, const char *exten, int priority, int *reason, int sync, const char *cid_num, const char *cid_name, struct tris_variable *vars, const char *account, struct tris_channel **locked_channel);
 
 /*! Synchronously or asynchronously make an outbound call and send it to a
    particular application with given extension */
-int tris_pbx_outgoing_app(const char *type, int format, void *data, int timeout, const char *app, const char *appdata, int *reason, int sync, const char *cid_num, const char *cid_name, struct tris_variable *vars, const char *account, struct tris_channel **locked_channel);
+int tris_pbx_outgoing_app(const char *type, format_t format, void *data, int timeout, const char *app, const char *appdata, int *reason, int sync, const char *cid_num, const char *cid_name, struct tris_variable *vars, const char *account, struct tris_channel **locked_channel);
 
 /*!
  * \brief Evaluate a condition
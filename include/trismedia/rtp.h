@@ -87,7 +87,7 @@ struct rtp_red;
 /*! \brief The value of each payload format mapping: */
 struct rtpPayloadType {
 	int isAstFormat;		/*!< whether the following code is an TRIS_FORMAT */
-	int code;
+	format_t code;
 };
 
 /*! \brief This is the structure that binds a channel (SIP/Jingle/H.323) to the RTP subsystem 
@@ -100,8 +100,8 @@ struct tris_rtp_protocol {
 	/*! Get RTP struct, or NULL if unwilling to transfer */
 	enum tris_rtp_get_result (* const get_trtp_info)(struct tris_channel *chan, struct tris_rtp **rtp);
 	/*! Set RTP peer */
-	int (* const set_rtp_peer)(struct tris_channel *chan, struct tris_rtp *peer, struct tris_rtp *vpeer, struct tris_rtp *tpeer, int codecs, int nat_active);
-	int (* const get_codec)(struct tris_channel *chan);
+	int (* const set_rtp_peer)(struct tris_channel *chan, struct tris_rtp *peer, struct tris_rtp *vpeer, struct tris_rtp *tpeer, format_t codecs, int nat_active);
+	format_t (* const get_codec)(struct tris_channel *chan);
 	const char * const type;
 	TRIS_LIST_ENTRY(tris_rtp_protocol) list;
 };
@@ -289,13 +289,13 @@ int tris_rtp_set_rtpmap_type_rate(struct tris_rtp* rtp, int pt,
 
 /*! \brief  Mapping between RTP payload format codes and Trismedia codes: */
 struct rtpPayloadType tris_rtp_lookup_pt(struct tris_rtp* rtp, int pt);
-int tris_rtp_lookup_code(struct tris_rtp* rtp, int isAstFormat, int code);
+int tris_rtp_lookup_code(struct tris_rtp* rtp, int isAstFormat, format_t code);
 
 void tris_rtp_get_current_formats(struct tris_rtp* rtp,
-				 int* astFormats, int* nonAstFormats);
+				 format_t *astFormats, int *nonAstFormats);
 
 /*! \brief  Mapping an Trismedia code into a MIME subtype (string): */
-const char *tris_rtp_lookup_mime_subtype(int isAstFormat, int code,
+const char *tris_rtp_lookup_mime_subtype(int isAstFormat, format_t code,
 					enum tris_rtp_options options);
 
 /*! \brief Get the sample rate associated with known RTP payload types
@@ -305,10 +305,10 @@ const char *tris_rtp_lookup_mime_subtype(int isAstFormat, int code,
  *
  * \return the sample rate if the format was found, zero if it was not found
  */
-unsigned int tris_rtp_lookup_sample_rate(int isAstFormat, int code);
+unsigned int tris_rtp_lookup_sample_rate(int isAstFormat, format_t code);
 
 /*! \brief Build a string of MIME subtype names from a capability list */
-char *tris_rtp_lookup_mime_multiple(char *buf, size_t size, const int capability,
+char *tris_rtp_lookup_mime_multiple(char *buf, size_t size, const format_t capability,
 				   const int isAstFormat, enum tris_rtp_options options);
 
 void tris_rtp_setnat(struct tris_rtp *rtp, int nat);
@@ -324,6 +324,20 @@ void tris_rtp_setdtmfcompensate(struct tris_rtp *rtp, int compensate);
 /*! \brief Enable STUN capability */
 void tris_rtp_setstun(struct tris_rtp *rtp, int stun_enable);
 
+/*!
+ * \brief Read RTP and RTCP datagrams ahead in batches, if rtpbatch is set in rtp.conf
+ * Datagrams that were read ahead do not make the socket readable again, so after
+ * this the caller has to keep reading as long as tris_rtp_read_pending() or
+ * tris_rtcp_read_pending() say there is more.
+ */
+void tris_rtp_set_readahead(struct tris_rtp *rtp);
+
+/*! \brief Datagrams read ahead on the RTP socket and not processed yet */
+int tris_rtp_read_pending(struct tris_rtp *rtp);
+
+/*! \brief Datagrams read ahead on the RTCP socket and not processed yet */
+int tris_rtcp_read_pending(struct tris_rtp *rtp);
+
 /*! \brief Generic STUN request
  * send a generic stun request to the server specified.
  * \param s the socket used to send the request
@@ -410,7 +424,7 @@ void tris_rtp_codec_setpref(struct tris_rtp *rtp, struct tris_codec_pref *prefs)
 struct tris_codec_pref *tris_rtp_codec_getpref(struct tris_rtp *rtp);
 
 /*! \brief get format from predefined dynamic payload format */
-int tris_rtp_codec_getformat(int pt);
+format_t tris_rtp_codec_getformat(int pt);
 
 /*! \brief Set rtp timeout */
 void tris_rtp_set_rtptimeout(struct tris_rtp *rtp, int timeout);
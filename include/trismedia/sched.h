@@ -139,12 +139,33 @@ extern "C" {
 
 struct sched_context;
 
+/*! \brief How a schedule context keeps its entries in time order */
+enum sched_context_type {
+	/*! Binary heap, O(log n) add and delete */
+	SCHED_CONTEXT_HEAP,
+	/*!
+	 * Hierarchical timing wheel, O(1) add and delete at millisecond
+	 * resolution.  Suits contexts with many timers that are mostly
+	 * deleted before they run, such as retransmit and expiry timers.
+	 * tris_sched_wait() may return early when nothing is due in the
+	 * next 256 ms; tris_sched_runq() then simply runs nothing.
+	 */
+	SCHED_CONTEXT_WHEEL,
+};
+
 /*! \brief New schedule context
  * \note Create a scheduling context
  * \return Returns a malloc'd sched_context structure, NULL on failure
  */
 struct sched_context *sched_context_create(void);
 
+/*! \brief New schedule context of the given type
+ * \param type how to keep the entries in time order
+ * \return Returns a malloc'd sched_context structure, NULL on failure
+ * \note sched_context_create() makes a SCHED_CONTEXT_HEAP context
+ */
+struct sched_context *sched_context_create_type(enum sched_context_type type);
+
 /*! \brief destroys a schedule context
  * Destroys (free's) the given sched_context structure
  * \param c Context to free
@@ -0,0 +1,303 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 1999 - 2006, Digium, Inc.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*!\file
+ * \brief Code shared by the SIP based channel drivers
+ *
+ * The code lives in res_sip_core, which chan_sip, chan_switch, chan_service
+ * and chan_gateway depend on, so the message parsing helpers are only written
+ * (and only need to be optimized) once.  The drivers also share one set of
+ * UDP worker threads and one Call-ID index of their dialogs.  Each driver
+ * still has its own socket, monitor thread and scheduler.
+ */
+
+#ifndef _TRISMEDIA_SIP_CORE_H
+#define _TRISMEDIA_SIP_CORE_H
+
+#include <stddef.h>
+#include <netinet/in.h>
+
+#include "trismedia/strings.h"
+#include "trismedia/netsock.h"
+#include "trismedia/astobj2.h"
+
+/*! \name SIP message parsing helpers */
+/*@{ */
+
+/*! \brief Parse multiline SIP headers into one header */
+int sip_lws2sws(char *msgbuf, int len);
+
+/*! \brief Locate closing quote in a string, skipping escaped quotes. */
+const char *sip_find_closing_quote(const char *start, const char *lim);
+
+/*! \brief Pick out text in brackets from character string */
+char *sip_get_in_brackets(char *tmp);
+
+/*! \brief Parses a URI in its components */
+int sip_parse_uri(char *uri, const char *scheme,
+	char **ret_name, char **pass, char **domain, char **port, char **options, char **transport);
+
+/*! \brief Remove URI parameters at end of URI, not in username part though */
+char *sip_remove_uri_parameters(char *uri);
+
+/*! \brief Terminate the uri at the first ';' or space */
+char *sip_terminate_uri(char *uri);
+
+/*! \brief Get caller id name from SIP headers */
+char *sip_get_calleridname(const char *input, char *output, size_t outputsize);
+
+/*! \brief Get caller id number from Remote-Party-ID header field */
+int sip_get_rpid_num(const char *input, char *output, int maxlen);
+
+/*! \brief Reads one line of SIP message body */
+char *sip_get_body_by_line(const char *line, const char *name, int nameLen, char delimiter);
+
+/*! \brief Converts ascii port to int representation */
+int sip_port_str2int(const char *pt, unsigned int standard);
+
+/*! \brief Generate 32 byte random string for callid's etc */
+char *sip_generate_random_string(char *buf, size_t size);
+
+/*! \brief Make our SIP dialog tag */
+void sip_make_our_tag(char *tagbuf, size_t len);
+
+/*@} */
+
+/*! \name Message tokenizer and header index
+ * sip_parse_lines() splits a received message into header and body lines in
+ * a single pass, in place, and notes on the way where the well-known headers
+ * are. Looking one up afterwards is a table access instead of a case
+ * insensitive compare against every header line.
+ */
+/*@{ */
+
+/*! \brief The headers kept in a struct sip_header_index */
+enum sip_header_id {
+	SIP_HDR_UNKNOWN = 0,		/*!< Not indexed, must be searched for */
+	SIP_HDR_ACCEPT,
+	SIP_HDR_ACCEPT_CONTACT,
+	SIP_HDR_ALLOW,
+	SIP_HDR_ALLOW_EVENTS,
+	SIP_HDR_ALSO,
+	SIP_HDR_AUTHORIZATION,
+	SIP_HDR_CALL_ID,
+	SIP_HDR_CONTACT,
+	SIP_HDR_CONTENT_ENCODING,
+	SIP_HDR_CONTENT_LENGTH,
+	SIP_HDR_CONTENT_TYPE,
+	SIP_HDR_CSEQ,
+	SIP_HDR_DIVERSION,
+	SIP_HDR_ERROR_INFO,
+	SIP_HDR_EVENT,
+	SIP_HDR_EXPIRES,
+	SIP_HDR_FROM,
+	SIP_HDR_IDENTITY,
+	SIP_HDR_IDENTITY_INFO,
+	SIP_HDR_MAX_FORWARDS,
+	SIP_HDR_MIN_EXPIRES,
+	SIP_HDR_MIN_SE,
+	SIP_HDR_P_ASSERTED_IDENTITY,
+	SIP_HDR_PRIVACY,
+	SIP_HDR_PROXY_AUTHENTICATE,
+	SIP_HDR_PROXY_AUTHORIZATION,
+	SIP_HDR_RECORD_ROUTE,
+	SIP_HDR_REFER_TO,
+	SIP_HDR_REFERRED_BY,
+	SIP_HDR_REJECT_CONTACT,
+	SIP_HDR_REMOTE_PARTY_ID,
+	SIP_HDR_REPLACES,
+	SIP_HDR_REQUEST_DISPOSITION,
+	SIP_HDR_REQUIRE,
+	SIP_HDR_ROUTE,
+	SIP_HDR_SESSION_EXPIRES,
+	SIP_HDR_SUBJECT,
+	SIP_HDR_SUPPORTED,
+	SIP_HDR_TO,
+	SIP_HDR_USER_AGENT,
+	SIP_HDR_VIA,
+	SIP_HDR_WWW_AUTHENTICATE,
+	SIP_HDR_COUNT
+};
+
+/*! \brief Max amount of header lines a struct sip_header_index can track */
+#define SIP_HEADER_INDEX_MAX	64
+
+/*!
+ * \brief Where the well-known headers of a message are
+ * Line numbers are stored plus one, so a zeroed index is an empty one.
+ */
+struct sip_header_index {
+	unsigned char first[SIP_HDR_COUNT];		/*!< First line with this header */
+	unsigned char last[SIP_HDR_COUNT];		/*!< Last line with this header */
+	unsigned char next[SIP_HEADER_INDEX_MAX];	/*!< Next line with the same header as this one */
+};
+
+/*! \brief Look up a header by its full or compact name, case insensitive */
+enum sip_header_id sip_header_id(const char *name, size_t len);
+
+/*!
+ * \brief Identify the header on a header line
+ * \param line The header line, "Name: value"
+ * \param allow_blanks Accept blanks between the name and the ':'
+ */
+enum sip_header_id sip_header_line_id(const char *line, int allow_blanks);
+
+/*! \brief Return the compact form of a header name, or \a _default if it has none */
+const char *sip_header_compact_name(const char *name, const char *_default);
+
+/*! \brief Record that header line \a line is a \a id header */
+void sip_header_index_add(struct sip_header_index *index, int line, enum sip_header_id id);
+
+/*!
+ * \brief Find the first \a id header at or after line \a start
+ * \return the line number, -1 if there is none
+ */
+int sip_header_index_find(const struct sip_header_index *index, enum sip_header_id id, int start);
+
+/*! \brief Return the value of a header line, past the ':' and any blanks */
+const char *sip_header_value(const char *line);
+
+/*!
+ * \brief Split a SIP message into header and body lines, in one pass
+ * \param msg The message, line ends are replaced by NUL bytes
+ * \param header Gets the offset of each header line, the first line included
+ * \param maxheaders Size of \a header, further header lines are skipped
+ * \param headers Gets the number of header lines
+ * \param line Gets the offset of each body line
+ * \param maxlines Size of \a line
+ * \param lines Gets the number of body lines
+ * \param index Gets the location of the well-known headers
+ * \param allow_blanks Accept blanks between a header name and its ':'
+ * \retval 0 the whole message was parsed
+ * \retval -1 the body had more than \a maxlines lines, the rest was ignored
+ */
+int sip_parse_lines(char *msg, ptrdiff_t *header, int maxheaders, int *headers,
+	ptrdiff_t *line, int maxlines, int *lines, struct sip_header_index *index, int allow_blanks);
+
+/*@} */
+
+/*! \name UDP worker pool
+ * The drivers queue the UDP packets they receive on worker threads they all
+ * share.  Packets are spread over the threads on the hash of their Call-ID,
+ * so the packets of one dialog are always processed in order, by the same
+ * thread.  Each driver gets a sip_worker_pool handle, the amount of threads
+ * is the largest count asked for by a driver.
+ */
+/*@{ */
+
+struct sip_worker_pool;
+
+/*! \brief Process one received packet, the callee owns \a data */
+typedef void (sip_worker_process_fn)(struct tris_str *data, int len, struct sockaddr_in *sin);
+
+/*!
+ * \brief Have the packets of a driver processed by the shared worker threads
+ * \param name Name of the driver, used in log messages
+ * \param count Number of threads the driver wants, more are started if needed
+ * \param process Called on a worker thread for each queued packet
+ * \return the handle of the driver, NULL if no thread could be started
+ */
+struct sip_worker_pool *sip_worker_pool_create(const char *name, int count, sip_worker_process_fn *process);
+
+/*!
+ * \brief Wait until no worker is processing a packet of the driver or has replies left to send for it
+ * The workers don't start on another packet of the driver until
+ * sip_worker_pool_resume().  Packets are still queued meanwhile.  Used to
+ * change the socket they send on.
+ * \note Don't hold any lock the workers may need when calling this.
+ */
+void sip_worker_pool_pause(struct sip_worker_pool *pool);
+
+/*! \brief Let the workers go on with the packets of a paused driver */
+void sip_worker_pool_resume(struct sip_worker_pool *pool);
+
+/*!
+ * \brief Wait until the packets queued by the driver are processed, and free its handle
+ * The threads are stopped once no driver uses them anymore.
+ */
+void sip_worker_pool_destroy(struct sip_worker_pool *pool);
+
+/*!
+ * \brief Queue a packet on the worker owning its Call-ID
+ * \retval 0 the packet was queued, the pool now owns \a data
+ * \retval -1 the packet was dropped
+ */
+int sip_worker_pool_queue(struct sip_worker_pool *pool, struct tris_str *data, int len, struct sockaddr_in *sin);
+
+/*! \brief Number of threads the driver asked for */
+int sip_worker_pool_size(struct sip_worker_pool *pool);
+
+/*! \brief Print the queue statistics of each shared worker on a CLI fd */
+void sip_worker_pool_show(struct sip_worker_pool *pool, int fd);
+
+/*!
+ * \brief Have the workers batch the UDP packets they send for a driver, see sip_udp_send_begin()
+ * \param size Max amount of packets per system call, 0 to send them one by one
+ * \param stats Counters to update
+ */
+void sip_worker_pool_set_batching(struct sip_worker_pool *pool, int size, struct tris_udp_batch_stats *stats);
+
+/*@} */
+
+/*! \name Dialog index
+ * One Call-ID index holding the dialogs of all the drivers.  A driver links
+ * its dialogs here while they are in its own dialogs container, which is
+ * then only used to walk them.
+ */
+/*@{ */
+
+/*! \brief Where the index finds the Call-ID and the driver of a dialog
+ * \note Must be the first member of the dialog structure of each driver.
+ */
+struct sip_dialog_key {
+	const char * const *callid;	/*!< The Call-ID field of the dialog */
+	const void *owner;		/*!< Tells the drivers apart, the address of their channel tech */
+};
+
+/*!
+ * \brief Index a dialog under its current Call-ID
+ * \note Unlink it before changing its Call-ID, and link it again after.
+ */
+void sip_dialog_index_link(void *dialog);
+
+/*! \brief Remove a dialog from the index */
+void sip_dialog_index_unlink(void *dialog);
+
+/*!
+ * \brief Find a dialog of a driver by Call-ID
+ * \param owner Driver of the dialog, see struct sip_dialog_key
+ * \param callid Call-ID, compared without case
+ * \param cb If not NULL, also called on the dialogs with that Call-ID, returns CMP_MATCH for the right one
+ * \param data Passed to \a cb
+ * \return a reference to the dialog, NULL if none was found
+ */
+void *sip_dialog_index_find(const void *owner, const char *callid, ao2_callback_data_fn *cb, void *data);
+
+/*@} */
+
+/*! \name Batched UDP sends
+ * Between sip_udp_send_begin() and sip_udp_send_end(), the UDP packets a thread
+ * sends with sip_udp_sendto() are queued and sent with as few system calls as
+ * possible. The replies to a batch of received requests then go out together.
+ */
+/*@{ */
+
+/*! \brief Start queuing the UDP packets sent by this thread, nothing is queued if \a size is less than 2 */
+void sip_udp_send_begin(int size, struct tris_udp_batch_stats *stats);
+
+/*! \brief Send a UDP packet, or queue it if sip_udp_send_begin() was called by this thread */
+ssize_t sip_udp_sendto(int fd, const void *buf, size_t len, const struct sockaddr_in *sin, struct tris_udp_batch_stats *stats);
+
+/*! \brief Send what this thread queued, and stop queuing */
+void sip_udp_send_end(void);
+
+/*@} */
+
+#endif /* _TRISMEDIA_SIP_CORE_H */
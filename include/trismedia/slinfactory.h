@@ -24,6 +24,8 @@
 #ifndef _TRISMEDIA_SLINFACTORY_H
 #define _TRISMEDIA_SLINFACTORY_H
 
+#include "trismedia/frame.h"
+
 #if defined(__cplusplus) || defined(c_plusplus)
 extern "C" {
 #endif
@@ -37,8 +39,8 @@ struct tris_slinfactory {
 	short *offset;                           /*!< Offset into the hold where audio begins */
 	size_t holdlen;                          /*!< Number of samples currently in the hold */
 	unsigned int size;                       /*!< Number of samples currently in the factory */
-	unsigned int format;                     /*!< Current format the translation path is converting from */
-	unsigned int output_format;		 /*!< The output format desired */
+	format_t format;                         /*!< Current format the translation path is converting from */
+	format_t output_format;			 /*!< The output format desired */
 };
 
 /*!
@@ -46,6 +46,12 @@
  * destruction of the taskprocessor if the taskprocessor's reference count reaches zero.  Tasks waiting
  * to be processed in the taskprocessor queue when the taskprocessor reference count reaches zero
  * will be purged and released from the taskprocessor queue without being processed.
+ *
+ * A taskprocessor created with the TPS_POOLED option has no thread of its own.  Its tasks are
+ * run by a pool of worker threads shared by all pooled taskprocessors, one per processor.  Tasks
+ * pushed with tris_taskprocessor_push_keyed() are run in order for each key, while tasks for
+ * different keys may run at the same time on different workers.  Tasks pushed with
+ * tris_taskprocessor_push() all share one key.
  */
 struct tris_taskprocessor;
 
@@ -60,6 +66,8 @@ enum tris_tps_options {
 	TPS_REF_DEFAULT = 0,
 	/*! \brief return a reference to a taskprocessor ONLY if it already exists */
 	TPS_REF_IF_EXISTS = (1 << 0),
+	/*! \brief if the taskprocessor is created, run its tasks on the shared worker pool */
+	TPS_POOLED = (1 << 1),
 };
 
 /*! \brief Get a reference to a taskprocessor with the specified name and create the taskprocessor if necessary
@@ -68,7 +76,7 @@ enum tris_tps_options {
  * disabled by specifying the TPS_REF_IF_EXISTS tris_tps_options as the second argument to tris_taskprocessor_get().
  * \param name The name of the taskprocessor
  * \param create Use 0 by default or specify TPS_REF_IF_EXISTS to return NULL if the taskprocessor does 
- * not already exist
+ * not already exist, and TPS_POOLED to create a pooled taskprocessor
  * return A pointer to a reference counted taskprocessor under normal conditions, or NULL if the
  * TPS_REF_IF_EXISTS reference type is specified and the taskprocessor does not exist
  * \since 1.6.1
@@ -94,6 +102,16 @@ void *tris_taskprocessor_unreference(struct tris_taskprocessor *tps);
  */
 int tris_taskprocessor_push(struct tris_taskprocessor *tps, int (*task_exe)(void *datap), void *datap);
 
+/*! \brief Push a task into the specified taskprocessor, to be run in order with the other tasks for the key
+ * \param tps The taskprocessor structure
+ * \param key Tasks with the same key, ignoring case, are run one at a time in the order they were pushed.  On a
+ * pooled taskprocessor, tasks with different keys may run at the same time.
+ * \param task_exe The task handling function to push into the taskprocessor queue
+ * \param datap The data to be used by the task handling function
+ * \return zero on success, -1 on failure
+ */
+int tris_taskprocessor_push_keyed(struct tris_taskprocessor *tps, const char *key, int (*task_exe)(void *datap), void *datap);
+
 /*! \brief Return the name of the taskprocessor singleton
  * \since 1.6.1
  */
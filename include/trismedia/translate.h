@@ -24,8 +24,8 @@
 #ifndef _TRISMEDIA_TRANSLATE_H
 #define _TRISMEDIA_TRANSLATE_H
 
-#define MAX_AUDIO_FORMAT 15 /* Do not include video here */
-#define MAX_FORMAT 32	/* Do include video here */
+#define MAX_AUDIO_FORMAT 47 /* Do not include video here */
+#define MAX_FORMAT 64	/* Do include video here */
 
 #if defined(__cplusplus) || defined(c_plusplus)
 extern "C" {
@@ -70,9 +70,9 @@ struct tris_trans_pvt;	/* declared below */
  */
 struct tris_translator {
 	const char name[80];		/*!< Name of translator */
-	int srcfmt;			/*!< Source format (note: bit position,
+	format_t srcfmt;	/*!< Source format (note: bit position,
 					  converted to index during registration) */
-	int dstfmt;			/*!< Destination format (note: bit position,
+	format_t dstfmt;	/*!< Destination format (note: bit position,
 					  converted to index during registration) */
 
 	int (*newpvt)(struct tris_trans_pvt *); /*!< initialize private data 
@@ -86,10 +86,26 @@ struct tris_translator {
 					/*!< Output frame callback. Generate a frame 
 					    with outbuf content. */
 
+	int (*framein_batch)(struct tris_trans_pvt **pvts, struct tris_frame **frames, int count);
+					/*!< Optional. Store (and possibly convert)
+					     one input frame into each of count pvts
+					     of this translator, with the same result
+					     as framein on every pair.  Used by
+					     tris_translate_batch(). */
+
 	void (*destroy)(struct tris_trans_pvt *pvt);
 					/*!< cleanup private data, if needed 
 						(often unnecessary). */
 
+	int (*reset)(struct tris_trans_pvt *pvt);
+					/*!< Return private data to the state newpvt
+					     left it in, so the pvt can be reused.
+					     Returns -1 if it can not be reset.  Only
+					     needed by translators with a destroy
+					     callback, the others are reset by
+					     clearing the descriptor and calling
+					     newpvt again. */
+
 	struct tris_frame * (*sample)(void);	/*!< Generate an example frame */
 
 	/*! \brief size of outbuf, in samples. Leave it 0 if you want the framein
@@ -114,6 +130,14 @@ struct tris_translator {
 	int cost;			/*!< Cost in milliseconds for encoding/decoding 1 second of sound */
 	int active;			/*!< Whether this translator should be used or not */
 	TRIS_LIST_ENTRY(tris_translator) list;	/*!< link field */
+
+	/* Idle pvts kept for reuse, protected by the pool lock in translate.c */
+	struct tris_trans_pvt *pool;	/*!< idle pvts, linked through their next field */
+	int pool_open;			/*!< whether released pvts may be kept, set while registered */
+	unsigned int pool_idle;		/*!< number of pvts in pool */
+	unsigned int pool_inuse;	/*!< number of pvts handed out and not yet released */
+	unsigned int pool_hits;		/*!< pvts taken from pool */
+	unsigned int pool_misses;	/*!< pvts allocated because pool was empty */
 };
 
 /*! \brief
@@ -152,6 +176,7 @@ struct tris_trans_pvt {
 	struct timeval nextin;
 	struct timeval nextout;
 	unsigned int destroy:1;
+	unsigned int pooled:1;      /*!< handed out by tris_translator_build_path(), returns to the pool */
 };
 
 /*! \brief generic frameout function */
@@ -206,7 +231,7 @@ void tris_translator_deactivate(struct tris_translator *t);
  * \return Returns 0 on success, -1 if no path could be found.  
  * \note Modifies dests and srcs in place 
  */
-int tris_translator_best_choice(int *dsts, int *srcs);
+int tris_translator_best_choice(format_t *dsts, format_t *srcs);
 
 /*! 
  * \brief Builds a translator path
@@ -215,7 +240,7 @@ int tris_translator_best_choice(int *dsts, int *srcs);
  * \param source source format
  * \return tris_trans_pvt on success, NULL on failure
  * */
-struct tris_trans_pvt *tris_translator_build_path(int dest, int source);
+struct tris_trans_pvt *tris_translator_build_path(format_t dest, format_t source);
 
 /*!
  * \brief Frees a translator path
@@ -235,13 +260,26 @@ void tris_translator_free_path(struct tris_trans_pvt *tr);
  */
 struct tris_frame *tris_translate(struct tris_trans_pvt *tr, struct tris_frame *f, int consume);
 
+/*!
+ * \brief translates frames of many channels in one call
+ * Works like tris_translate() on every path and frame pair, but steps that
+ * use the same translator are handed to it together, for example to
+ * encode the audio of every member of a conference at once.
+ * \param paths translator paths, each one at most once
+ * \param in frames to translate, one per path.  They are not freed.
+ * \param out set to the translated frame of every path, or NULL
+ * \param count number of paths
+ * \return the number of translated frames
+ */
+int tris_translate_batch(struct tris_trans_pvt **paths, struct tris_frame **in, struct tris_frame **out, int count);
+
 /*!
  * \brief Returns the number of steps required to convert from 'src' to 'dest'.
  * \param dest destination format
  * \param src source format
  * \return the number of translation steps required, or -1 if no path is available
  */
-unsigned int tris_translate_path_steps(unsigned int dest, unsigned int src);
+unsigned int tris_translate_path_steps(format_t dest, format_t src);
 
 /*!
  * \brief Mask off unavailable formats from a format bitmask
@@ -255,7 +293,7 @@ unsigned int tris_translate_path_steps(unsigned int dest, unsigned int src);
  * \note Only a single audio format and a single video format can be
  * present in 'src', or the function will produce unexpected results.
  */
-unsigned int tris_translate_available_formats(unsigned int dest, unsigned int src);
+format_t tris_translate_available_formats(format_t dest, format_t src);
 
 /*!
  * \brief Hint that a frame from a translator has been freed
@@ -0,0 +1,7 @@
+/*
+ * version.h 
+ * Automatically generated
+ */
+#define TRISMEDIA_VERSION "2.2"
+#define TRISMEDIA_VERSION_NUM 20200
+
@@ -511,7 +511,7 @@ struct linear_state {
 	int fd;
 	int autoclose;
 	int allowoverride;
-	int origwfmt;
+	format_t origwfmt;
 };
 
 static void linear_release(struct tris_channel *chan, void *params)
@@ -519,7 +519,7 @@ static void linear_release(struct tris_channel *chan, void *params)
 	struct linear_state *ls = params;
 
 	if (ls->origwfmt && tris_set_write_format(chan, ls->origwfmt)) {
-		tris_log(LOG_WARNING, "Unable to restore channel '%s' to format '%d'\n", chan->name, ls->origwfmt);
+		tris_log(LOG_WARNING, "Unable to restore channel '%s' to format '%s'\n", chan->name, tris_getformatname(ls->origwfmt));
 	}
 
 	if (ls->autoclose) {
@@ -805,7 +805,7 @@ static int __tris_play_and_record(struct tris_channel *chan, const char *playfil
 	time_t start, end;
 	struct tris_dsp *sildet = NULL;   /* silence detector dsp */
 	int totalsilence = 0;
-	int rfmt = 0;
+	format_t rfmt = 0;
 	struct tris_silence_generator *silgen = NULL;
 	char prependfile[80];
 
@@ -956,19 +956,19 @@ static int __tris_play_and_record(struct tris_channel *chan, const char *playfil
 			} else if (f->frametype == TRIS_FRAME_DTMF) {
 				if (prepend) {
 				/* stop recording with any digit */
-					tris_verb(3, "User ended message by pressing %c\n", f->subclass);
+					tris_verb(3, "User ended message by pressing %c\n", (int) f->subclass);
 					res = 't';
 					outmsg = 2;
 					break;
 				}
 				if (strchr(acceptdtmf, f->subclass)) {
-					tris_verb(3, "User ended message by pressing %c\n", f->subclass);
+					tris_verb(3, "User ended message by pressing %c\n", (int) f->subclass);
 					res = f->subclass;
 					outmsg = 2;
 					break;
 				}
 				if (strchr(canceldtmf, f->subclass)) {
-					tris_verb(3, "User cancelled message by pressing %c\n", f->subclass);
+					tris_verb(3, "User cancelled message by pressing %c\n", (int) f->subclass);
 					res = f->subclass;
 					outmsg = 0;
 					break;
@@ -37,10 +37,11 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 238637 $")
 #include "trismedia/slinfactory.h"
 #include "trismedia/frame.h"
 #include "trismedia/translate.h"
+#include "trismedia/mix.h"
 
 struct tris_audiohook_translate {
 	struct tris_trans_pvt *trans_pvt;
-	int format;
+	format_t format;
 };
 
 struct tris_audiohook_list {
@@ -199,8 +200,8 @@ static struct tris_frame *audiohook_read_frame_single(struct tris_audiohook *aud
 
 static struct tris_frame *audiohook_read_frame_both(struct tris_audiohook *audiohook, size_t samples)
 {
-	int i = 0, usable_read, usable_write;
-	short buf1[samples], buf2[samples], *read_buf = NULL, *write_buf = NULL, *final_buf = NULL, *data1 = NULL, *data2 = NULL;
+	int usable_read, usable_write;
+	short buf1[samples], buf2[samples], *read_buf = NULL, *write_buf = NULL, *final_buf = NULL;
 	struct tris_frame frame = {
 		.frametype = TRIS_FRAME_VOICE,
 		.subclass = TRIS_FORMAT_SLINEAR,
@@ -237,14 +238,7 @@ static struct tris_frame *audiohook_read_frame_both(struct tris_audiohook *audio
 			read_buf = buf1;
 			/* Adjust read volume if need be */
 			if (audiohook->options.read_volume) {
-				int count = 0;
-				short adjust_value = abs(audiohook->options.read_volume);
-				for (count = 0; count < samples; count++) {
-					if (audiohook->options.read_volume > 0)
-						tris_slinear_saturated_multiply(&buf1[count], &adjust_value);
-					else if (audiohook->options.read_volume < 0)
-						tris_slinear_saturated_divide(&buf1[count], &adjust_value);
-				}
+				tris_mix_gain(buf1, samples, audiohook->options.read_volume);
 			}
 		}
 	} else if (option_debug)
@@ -256,14 +250,7 @@ static struct tris_frame *audiohook_read_frame_both(struct tris_audiohook *audio
 			write_buf = buf2;
 			/* Adjust write volume if need be */
 			if (audiohook->options.write_volume) {
-				int count = 0;
-				short adjust_value = abs(audiohook->options.write_volume);
-				for (count = 0; count < samples; count++) {
-					if (audiohook->options.write_volume > 0)
-						tris_slinear_saturated_multiply(&buf2[count], &adjust_value);
-					else if (audiohook->options.write_volume < 0)
-						tris_slinear_saturated_divide(&buf2[count], &adjust_value);
-				}
+				tris_mix_gain(buf2, samples, audiohook->options.write_volume);
 			}
 		}
 	} else if (option_debug)
@@ -273,8 +260,7 @@ static struct tris_frame *audiohook_read_frame_both(struct tris_audiohook *audio
 	if (!read_buf && !write_buf)
 		return NULL;
 	else if (read_buf && write_buf) {
-		for (i = 0, data1 = read_buf, data2 = write_buf; i < samples; i++, data1++, data2++)
-			tris_slinear_saturated_add(data1, data2);
+		tris_mix_add(read_buf, write_buf, samples);
 		final_buf = buf1;
 	} else if (read_buf)
 		final_buf = buf1;
@@ -295,7 +281,7 @@ static struct tris_frame *audiohook_read_frame_both(struct tris_audiohook *audio
  * \param format Format of frame remote side wants back
  * \return Returns frame on success, NULL on failure
  */
-struct tris_frame *tris_audiohook_read_frame(struct tris_audiohook *audiohook, size_t samples, enum tris_audiohook_direction direction, int format)
+struct tris_frame *tris_audiohook_read_frame(struct tris_audiohook *audiohook, size_t samples, enum tris_audiohook_direction direction, format_t format)
 {
 	struct tris_frame *read_frame = NULL, *final_frame = NULL;
 
@@ -625,8 +611,7 @@ static struct tris_frame *audio_audiohook_write_list(struct tris_channel *chan,
 
 	/* If this frame is being written out to the channel then we need to use whisper sources */
 	if (direction == TRIS_AUDIOHOOK_DIRECTION_WRITE && !TRIS_LIST_EMPTY(&audiohook_list->whisper_list)) {
-		int i = 0;
-		short read_buf[samples], combine_buf[samples], *data1 = NULL, *data2 = NULL;
+		short read_buf[samples], combine_buf[samples];
 		memset(&combine_buf, 0, sizeof(combine_buf));
 		TRIS_LIST_TRAVERSE_SAFE_BEGIN(&audiohook_list->whisper_list, audiohook, list) {
 			tris_audiohook_lock(audiohook);
@@ -638,15 +623,13 @@ static struct tris_frame *audio_audiohook_write_list(struct tris_channel *chan,
 			}
 			if (tris_slinfactory_available(&audiohook->write_factory) >= samples && tris_slinfactory_read(&audiohook->write_factory, read_buf, samples)) {
 				/* Take audio from this whisper source and combine it into our main buffer */
-				for (i = 0, data1 = combine_buf, data2 = read_buf; i < samples; i++, data1++, data2++)
-					tris_slinear_saturated_add(data1, data2);
+				tris_mix_add(combine_buf, read_buf, samples);
 			}
 			tris_audiohook_unlock(audiohook);
 		}
 		TRIS_LIST_TRAVERSE_SAFE_END;
 		/* We take all of the combined whisper sources and combine them into the audio being written out */
-		for (i = 0, data1 = middle_frame->data.ptr, data2 = combine_buf; i < samples; i++, data1++, data2++)
-			tris_slinear_saturated_add(data1, data2);
+		tris_mix_add(middle_frame->data.ptr, combine_buf, samples);
 		end_frame = middle_frame;
 	}
 
@@ -537,45 +537,45 @@ int tris_bridge_destroy(struct tris_bridge *bridge)
 
 static int bridge_make_compatible(struct tris_bridge *bridge, struct tris_bridge_channel *bridge_channel)
 {
-	int formats[2] = {bridge_channel->chan->readformat, bridge_channel->chan->writeformat};
+	format_t formats[2] = {bridge_channel->chan->readformat, bridge_channel->chan->writeformat};
 
 	/* Are the formats currently in use something ths bridge can handle? */
 	if (!(bridge->technology->formats & bridge_channel->chan->readformat)) {
-		int best_format = tris_best_codec(bridge->technology->formats);
+		format_t best_format = tris_best_codec(bridge->technology->formats);
 
 		/* Read format is a no go... */
 		if (option_debug) {
 			char codec_buf[512];
 			tris_getformatname_multiple(codec_buf, sizeof(codec_buf), bridge->technology->formats);
-			tris_debug(1, "Bridge technology %s wants to read any of formats %s(%d) but channel has %s(%d)\n", bridge->technology->name, codec_buf, bridge->technology->formats, tris_getformatname(formats[0]), formats[0]);
+			tris_debug(1, "Bridge technology %s wants to read any of formats %s(0x%llx) but channel has %s(0x%llx)\n", bridge->technology->name, codec_buf, (unsigned long long) bridge->technology->formats, tris_getformatname(formats[0]), (unsigned long long) formats[0]);
 		}
 		/* Switch read format to the best one chosen */
 		if (tris_set_read_format(bridge_channel->chan, best_format)) {
-			tris_log(LOG_WARNING, "Failed to set channel %s to read format %s(%d)\n", bridge_channel->chan->name, tris_getformatname(best_format), best_format);
+			tris_log(LOG_WARNING, "Failed to set channel %s to read format %s(0x%llx)\n", bridge_channel->chan->name, tris_getformatname(best_format), (unsigned long long) best_format);
 			return -1;
 		}
-		tris_debug(1, "Bridge %p put channel %s into read format %s(%d)\n", bridge, bridge_channel->chan->name, tris_getformatname(best_format), best_format);
+		tris_debug(1, "Bridge %p put channel %s into read format %s(0x%llx)\n", bridge, bridge_channel->chan->name, tris_getformatname(best_format), (unsigned long long) best_format);
 	} else {
-		tris_debug(1, "Bridge %p is happy that channel %s already has read format %s(%d)\n", bridge, bridge_channel->chan->name, tris_getformatname(formats[0]), formats[0]);
+		tris_debug(1, "Bridge %p is happy that channel %s already has read format %s\n", bridge, bridge_channel->chan->name, tris_getformatname(formats[0]));
 	}
 
 	if (!(bridge->technology->formats & formats[1])) {
-		int best_format = tris_best_codec(bridge->technology->formats);
+		format_t best_format = tris_best_codec(bridge->technology->formats);
 
 		/* Write format is a no go... */
 		if (option_debug) {
 			char codec_buf[512];
 			tris_getformatname_multiple(codec_buf, sizeof(codec_buf), bridge->technology->formats);
-			tris_debug(1, "Bridge technology %s wants to write any of formats %s(%d) but channel has %s(%d)\n", bridge->technology->name, codec_buf, bridge->technology->formats, tris_getformatname(formats[1]), formats[1]);
+			tris_debug(1, "Bridge technology %s wants to write any of formats %s(0x%llx) but channel has %s(0x%llx)\n", bridge->technology->name, codec_buf, (unsigned long long) bridge->technology->formats, tris_getformatname(formats[1]), (unsigned long long) formats[1]);
 		}
 		/* Switch write format to the best one chosen */
 		if (tris_set_write_format(bridge_channel->chan, best_format)) {
-			tris_log(LOG_WARNING, "Failed to set channel %s to write format %s(%d)\n", bridge_channel->chan->name, tris_getformatname(best_format), best_format);
+			tris_log(LOG_WARNING, "Failed to set channel %s to write format %s(0x%llx)\n", bridge_channel->chan->name, tris_getformatname(best_format), (unsigned long long) best_format);
 			return -1;
 		}
-		tris_debug(1, "Bridge %p put channel %s into write format %s(%d)\n", bridge, bridge_channel->chan->name, tris_getformatname(best_format), best_format);
+		tris_debug(1, "Bridge %p put channel %s into write format %s(0x%llx)\n", bridge, bridge_channel->chan->name, tris_getformatname(best_format), (unsigned long long) best_format);
 	} else {
-		tris_debug(1, "Bridge %p is happy that channel %s already has write format %s(%d)\n", bridge, bridge_channel->chan->name, tris_getformatname(formats[1]), formats[1]);
+		tris_debug(1, "Bridge %p is happy that channel %s already has write format %s\n", bridge, bridge_channel->chan->name, tris_getformatname(formats[1]));
 	}
 
 	return 0;
@@ -584,7 +584,7 @@ static int bridge_make_compatible(struct tris_bridge *bridge, struct tris_bridge
 /*! \brief Perform the smart bridge operation. Basically sees if a new bridge technology should be used instead of the current one. */
 static int smart_bridge_operation(struct tris_bridge *bridge, struct tris_bridge_channel *bridge_channel, int count)
 {
-	int new_capabilities = 0;
+	format_t new_capabilities = 0;
 	struct tris_bridge_technology *new_technology = NULL, *old_technology = bridge->technology;
 	struct tris_bridge temp_bridge = {
 		.technology = bridge->technology,
@@ -614,7 +614,7 @@ static int smart_bridge_operation(struct tris_bridge *bridge, struct tris_bridge
 
 	/* Attempt to find a new bridge technology to satisfy the capabilities */
 	if (!(new_technology = find_best_technology(new_capabilities))) {
-		tris_debug(1, "Smart bridge operation was unable to find new bridge technology with capabilities %d to satisfy bridge %p\n", new_capabilities, bridge);
+		tris_debug(1, "Smart bridge operation was unable to find new bridge technology with capabilities 0x%llx to satisfy bridge %p\n", (unsigned long long) new_capabilities, bridge);
 		return -1;
 	}
 
@@ -859,7 +859,7 @@ static void bridge_channel_dtmf_stream(struct tris_bridge *bridge, struct tris_b
 /*! \brief Join a channel to a bridge and handle anything the bridge may want us to do */
 static enum tris_bridge_channel_state bridge_channel_join(struct tris_bridge_channel *bridge_channel)
 {
-	int formats[2] = { bridge_channel->chan->readformat, bridge_channel->chan->writeformat };
+	format_t formats[2] = { bridge_channel->chan->readformat, bridge_channel->chan->writeformat };
 	enum tris_bridge_channel_state state;
 
 	/* Record the thread that will be the owner of us */
@@ -962,15 +962,15 @@ static enum tris_bridge_channel_state bridge_channel_join(struct tris_bridge_cha
 
 	/* Restore original formats of the channel as they came in */
 	if (bridge_channel->chan->readformat != formats[0]) {
-		tris_debug(1, "Bridge is returning %p to read format %s(%d)\n", bridge_channel, tris_getformatname(formats[0]), formats[0]);
+		tris_debug(1, "Bridge is returning %p to read format %s\n", bridge_channel, tris_getformatname(formats[0]));
 		if (tris_set_read_format(bridge_channel->chan, formats[0])) {
-			tris_debug(1, "Bridge failed to return channel %p to read format %s(%d)\n", bridge_channel, tris_getformatname(formats[0]), formats[0]);
+			tris_debug(1, "Bridge failed to return channel %p to read format %s\n", bridge_channel, tris_getformatname(formats[0]));
 		}
 	}
 	if (bridge_channel->chan->writeformat != formats[1]) {
-		tris_debug(1, "Bridge is returning %p to write format %s(%d)\n", bridge_channel, tris_getformatname(formats[1]), formats[1]);
+		tris_debug(1, "Bridge is returning %p to write format %s\n", bridge_channel, tris_getformatname(formats[1]));
 		if (tris_set_write_format(bridge_channel->chan, formats[1])) {
-			tris_debug(1, "Bridge failed to return channel %p to write format %s(%d)\n", bridge_channel, tris_getformatname(formats[1]), formats[1]);
+			tris_debug(1, "Bridge failed to return channel %p to write format %s\n", bridge_channel, tris_getformatname(formats[1]));
 		}
 	}
 
@@ -62,6 +62,7 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 246901 $")
 #include "trismedia/slinfactory.h"
 #include "trismedia/audiohook.h"
 #include "trismedia/timing.h"
+#include "trismedia/astobj2.h"
 
 #ifdef HAVE_EPOLL
 #include <sys/epoll.h>
@@ -128,6 +129,34 @@ static TRIS_LIST_HEAD_NOLOCK_STATIC(backends, chanlist);
 	both the channels list and the backends list.  */
 static TRIS_RWLIST_HEAD_STATIC(channels, tris_channel);
 
+/*! \brief An entry in one of the channel registry indexes
+ *
+ * Entries are only linked while their channel is on the channels list.  A
+ * channel is only taken off the list, and freed, with the list write locked,
+ * so the chan pointer of an entry found with the list read locked is valid
+ * until the list is unlocked. */
+struct tris_channel_index_entry {
+	struct tris_channel *chan;
+	const char *key;
+	char buf[0];
+};
+
+#define CHANNEL_INDEX_BUCKETS 563
+
+/*! \brief The channels by name, ignoring case */
+static struct ao2_container *channels_by_name;
+
+/*! \brief The channels by uniqueid */
+static struct ao2_container *channels_by_uniqueid;
+
+static void channel_registry_add(struct tris_channel *chan);
+
+/*! \brief Protects the walkers count of channels */
+TRIS_MUTEX_DEFINE_STATIC(channel_walkers_lock);
+
+/*! \brief Signalled when the walkers count of a channel drops to zero */
+static tris_cond_t channel_walkers_cond;
+
 /*! \brief map TRIS_CAUSE's to readable string representations 
  *
  * \ref causes.h
@@ -269,6 +298,7 @@ static char *complete_channeltypes(struct tris_cli_args *a)
 static char *handle_cli_core_show_channeltype(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
 {
 	struct chanlist *cl = NULL;
+	char buf[512];
 
 	switch (cmd) {
 	case CLI_INIT:
@@ -303,7 +333,7 @@ static char *handle_cli_core_show_channeltype(struct tris_cli_entry *e, int cmd,
 		"  Device State: %s\n"
 		"    Indication: %s\n"
 		"     Transfer : %s\n"
-		"  Capabilities: %d\n"
+		"  Capabilities: %s\n"
 		"   Digit Begin: %s\n"
 		"     Digit End: %s\n"
 		"    Send HTML : %s\n"
@@ -313,7 +343,7 @@ static char *handle_cli_core_show_channeltype(struct tris_cli_entry *e, int cmd,
 		(cl->tech->devicestate) ? "yes" : "no",
 		(cl->tech->indicate) ? "yes" : "no",
 		(cl->tech->transfer) ? "yes" : "no",
-		(cl->tech->capabilities) ? cl->tech->capabilities : -1,
+		tris_getformatname_multiple(buf, sizeof(buf), cl->tech->capabilities),
 		(cl->tech->send_digit_begin) ? "yes" : "no",
 		(cl->tech->send_digit_end) ? "yes" : "no",
 		(cl->tech->send_html) ? "yes" : "no",
@@ -708,12 +738,12 @@ char *tris_transfercapability2str(int transfercapability)
 }
 
 /*! \brief Pick the best audio codec */
-int tris_best_codec(int fmts)
+format_t tris_best_codec(format_t fmts)
 {
 	/* This just our opinion, expressed in code.  We are asked to choose
 	   the best codec to use, given no information */
 	int x;
-	static const int prefs[] =
+	static const format_t prefs[] =
 	{
 		/*! Okay, ulaw is used by all telephony equipment, so start with it */
 		TRIS_FORMAT_ULAW,
@@ -723,6 +753,8 @@ int tris_best_codec(int fmts)
 		TRIS_FORMAT_SIREN7,
 		/*! G.722 is better then all below, but not as common as the above... so give ulaw and alaw priority */
 		TRIS_FORMAT_G722,
+		/*! Opus is wideband at a fraction of G.722's bitrate, but costs more to transcode */
+		TRIS_FORMAT_OPUS,
 		/*! Okay, well, signed linear is easy to translate into other stuff */
 		TRIS_FORMAT_SLINEAR16,
 		TRIS_FORMAT_SLINEAR,
@@ -758,7 +790,7 @@ int tris_best_codec(int fmts)
 			return prefs[x];
 	}
 
-	tris_log(LOG_WARNING, "Don't know any of 0x%x formats\n", fmts);
+	tris_log(LOG_WARNING, "Don't know any of 0x%llx formats\n", (unsigned long long) fmts);
 
 	return 0;
 }
@@ -937,6 +969,7 @@ alertpipe_failed:
 
 	TRIS_RWLIST_WRLOCK(&channels);
 	TRIS_RWLIST_INSERT_HEAD(&channels, tmp, chan_list);
+	channel_registry_add(tmp);
 	TRIS_RWLIST_UNLOCK(&channels);
 
 	/*\!note
@@ -1165,6 +1198,121 @@ void tris_channel_undefer_dtmf(struct tris_channel *chan)
 		tris_clear_flag(chan, TRIS_FLAG_DEFER_DTMF);
 }
 
+static int channel_index_name_hash(const void *obj, const int flags)
+{
+	const struct tris_channel_index_entry *entry = obj;
+
+	return tris_str_case_hash(entry->key);
+}
+
+static int channel_index_name_cmp(void *obj, void *arg, int flags)
+{
+	struct tris_channel_index_entry *entry = obj, *match = arg;
+
+	return !strcasecmp(entry->key, match->key) ? CMP_MATCH | CMP_STOP : 0;
+}
+
+static int channel_index_uniqueid_hash(const void *obj, const int flags)
+{
+	const struct tris_channel_index_entry *entry = obj;
+
+	return tris_str_hash(entry->key);
+}
+
+static int channel_index_uniqueid_cmp(void *obj, void *arg, int flags)
+{
+	struct tris_channel_index_entry *entry = obj, *match = arg;
+
+	return !strcmp(entry->key, match->key) ? CMP_MATCH | CMP_STOP : 0;
+}
+
+/*! \brief Replace the entry of a channel in a registry index with one for key */
+static void channel_index_set(struct ao2_container *index, struct tris_channel_index_entry **entry,
+			      struct tris_channel *chan, const char *key)
+{
+	struct tris_channel_index_entry *old, *new = NULL;
+
+	if (!index) {
+		return;
+	}
+	if (key && (new = ao2_alloc(sizeof(*new) + strlen(key) + 1, NULL))) {
+		new->chan = chan;
+		strcpy(new->buf, key);
+		new->key = new->buf;
+	} else if (key) {
+		tris_log(LOG_WARNING, "Unable to index channel '%s'\n", key);
+	}
+
+	/* The index lock keeps renames of the same channel from racing */
+	ao2_lock(index);
+	if ((old = *entry)) {
+		ao2_unlink(index, old);
+	}
+	if ((*entry = new)) {
+		ao2_link(index, new);
+		ao2_ref(new, -1);
+	}
+	ao2_unlock(index);
+}
+
+/*! \brief Find a channel in a registry index.  Call with the channels list locked. */
+static struct tris_channel *channel_index_find(struct ao2_container *index, const char *key)
+{
+	struct tris_channel_index_entry *entry, tmp = {
+		.key = key,
+	};
+	struct tris_channel *c;
+
+	if (!index || !(entry = ao2_find(index, &tmp, OBJ_POINTER))) {
+		return NULL;
+	}
+	c = entry->chan;
+	ao2_ref(entry, -1);
+	return c;
+}
+
+/*! \brief Add a channel to the registry indexes.  Call with the channels list write locked. */
+static void channel_registry_add(struct tris_channel *chan)
+{
+	channel_index_set(channels_by_name, &chan->name_entry, chan, chan->name);
+	channel_index_set(channels_by_uniqueid, &chan->uniqueid_entry, chan, chan->uniqueid);
+}
+
+/*! \brief Take a channel off the registry indexes.  Call with the channels list write locked. */
+static void channel_registry_remove(struct tris_channel *chan)
+{
+	channel_index_set(channels_by_name, &chan->name_entry, chan, NULL);
+	channel_index_set(channels_by_uniqueid, &chan->uniqueid_entry, chan, NULL);
+}
+
+/*! \brief Set the name of a channel, and its key in the registry index by name */
+static void channel_set_name(struct tris_channel *chan, const char *name)
+{
+	tris_string_field_set(chan, name, name);
+	if (chan->name_entry) {
+		channel_index_set(channels_by_name, &chan->name_entry, chan, chan->name);
+	}
+}
+
+/*! \brief Whether a channel matches the channel_find_locked() arguments */
+static int channel_matches(struct tris_channel *c, const char *name, const int namelen,
+			   const char *context, const char *exten)
+{
+	if (name) { /* want match by name */
+		if ((!namelen && strcasecmp(c->name, name) && strcmp(c->uniqueid, name)) ||
+		    (namelen && strncasecmp(c->name, name, namelen)))
+			return 0;	/* name match failed */
+	} else if (exten) {
+		if (context && strcasecmp(c->context, context) &&
+		    strcasecmp(c->macrocontext, context))
+			return 0;	/* context match failed */
+		if (strcasecmp(c->exten, exten) &&
+		    strcasecmp(c->macroexten, exten))
+			return 0;	/* exten match failed */
+	}
+	return 1;
+}
+
 /*!
  * \brief Helper function to find channels.
  *
@@ -1177,17 +1325,16 @@ void tris_channel_undefer_dtmf(struct tris_channel *chan)
  * context != NULL && exten != NULL : get channel whose context or macrocontext
  *
  * It returns with the channel's lock held. If getting the individual lock fails,
- * unlock and retry quickly up to 10 times, then give up.
+ * unlock and retry quickly up to 200 times, then give up.
+ *
+ * A full name or uniqueid is looked up in the registry indexes, the other
+ * modes walk the channel list.
  *
- * \note XXX Note that this code has cost O(N) because of the need to verify
- * that the object is still on the global list.
+ * \note Walking from prev still has cost O(N) because of the need to verify
+ * that prev is still on the global list.
  *
- * \note XXX also note that accessing fields (e.g. c->name in tris_log())
- * can only be done with the lock held or someone could delete the
- * object while we work on it. This causes some ugliness in the code.
- * Note that removing the first tris_log() may be harmful, as it would
- * shorten the retry period and possibly cause failures.
- * We should definitely go for a better scheme that is deadlock-free.
+ * \note The caller may already hold another channel's lock, so the channel
+ * lock is only ever tried while the list is locked, never waited for.
  */
 static struct tris_channel *channel_find_locked(const struct tris_channel *prev,
 					       const char *name, const int namelen,
@@ -1203,7 +1350,11 @@ static struct tris_channel *channel_find_locked(const struct tris_channel *prev,
 		/* Reset prev on each retry.  See note below for the reason. */
 		prev = _prev;
 		TRIS_RWLIST_RDLOCK(&channels);
-		TRIS_RWLIST_TRAVERSE(&channels, c, chan_list) {
+		if (!prev && name && !namelen) {
+			if (!(c = channel_index_find(channels_by_name, name))) {
+				c = channel_index_find(channels_by_uniqueid, name);
+			}
+		} else TRIS_RWLIST_TRAVERSE(&channels, c, chan_list) {
 			if (prev) {	/* look for last item, first, before any evaluation */
 				if (c != prev)	/* not this one */
 					continue;
@@ -1222,23 +1373,11 @@ static struct tris_channel *channel_find_locked(const struct tris_channel *prev,
 				 */
 				prev = NULL;
 			}
-			if (name) { /* want match by name */
-				if ((!namelen && strcasecmp(c->name, name) && strcmp(c->uniqueid, name)) ||
-				    (namelen && strncasecmp(c->name, name, namelen)))
-					continue;	/* name match failed */
-			} else if (exten) {
-				if (context && strcasecmp(c->context, context) &&
-				    strcasecmp(c->macrocontext, context))
-					continue;	/* context match failed */
-				if (strcasecmp(c->exten, exten) &&
-				    strcasecmp(c->macroexten, exten))
-					continue;	/* exten match failed */
-			}
-			/* if we get here, c points to the desired record */
-			break;
+			/* this is slightly unsafe, as we _should_ hold the lock to access c->name */
+			if (channel_matches(c, name, namelen, context, exten))
+				break;	/* c points to the desired record */
 		}
 		/* exit if chan not found or mutex acquired successfully */
-		/* this is slightly unsafe, as we _should_ hold the lock to access c->name */
 		done = c == NULL || tris_channel_trylock(c) == 0;
 		if (!done) {
 			tris_debug(1, "Avoiding %s for channel '%p'\n", msg, c);
@@ -1310,14 +1449,50 @@ struct tris_channel *tris_walk_channel_by_exten_locked(const struct tris_channel
 	return channel_find_locked(chan, NULL, 0, context, exten);
 }
 
+/*!
+ * \brief Get the next channel of a walk over the registry, and hold it
+ *
+ * The channel is held until channel_walk_release(), so it is not freed once the
+ * channels list is unlocked, and its lock can be waited for without the list
+ * locked.
+ */
+static struct tris_channel *channel_walk_next(struct ao2_iterator *i)
+{
+	struct tris_channel_index_entry *entry;
+	struct tris_channel *c = NULL;
+
+	TRIS_RWLIST_RDLOCK(&channels);
+	if ((entry = ao2_iterator_next(i))) {
+		c = entry->chan;
+		tris_mutex_lock(&channel_walkers_lock);
+		c->walkers++;
+		tris_mutex_unlock(&channel_walkers_lock);
+		ao2_ref(entry, -1);
+	}
+	TRIS_RWLIST_UNLOCK(&channels);
+
+	return c;
+}
+
+/*! \brief Release a channel held by channel_walk_next() */
+static void channel_walk_release(struct tris_channel *c)
+{
+	tris_mutex_lock(&channel_walkers_lock);
+	if (!--c->walkers) {
+		tris_cond_broadcast(&channel_walkers_cond);
+	}
+	tris_mutex_unlock(&channel_walkers_lock);
+}
+
 /*! \brief Search for a channel based on the passed channel matching callback (first match) and return it, locked */
 void *tris_broad3channel_hangup_locked(const struct tris_channel *chan, const char *cid_num,
 							 const char *exten)
 {
-	struct tris_channel *c = NULL;
+	struct ao2_iterator i;
+	struct tris_channel *c;
 
-	TRIS_RWLIST_RDLOCK(&channels);
-	TRIS_RWLIST_TRAVERSE(&channels, c, chan_list) {
+	i = ao2_iterator_init(channels_by_uniqueid, 0);
+	while ((c = channel_walk_next(&i))) {
 		tris_channel_lock(c);
 		if(chan) {
 			if ((c != chan) && !strcasecmp(c->exten, chan->exten)
@@ -1336,68 +1511,70 @@ void *tris_broad3channel_hangup_locked(const struct tris_channel *chan, const ch
 			}
 		}
 		tris_channel_unlock(c);
+		channel_walk_release(c);
 	}
-	TRIS_RWLIST_UNLOCK(&channels);
+	ao2_iterator_destroy(&i);
 	return NULL;
 }
 
 int tris_broad3channel_search_locked(const char *exten, const char *cid)
 {
-	struct tris_channel *c = NULL;
+	struct ao2_iterator i;
+	struct tris_channel *c;
+	int found = 0;
 
-	TRIS_RWLIST_RDLOCK(&channels);
-	TRIS_RWLIST_TRAVERSE(&channels, c, chan_list) {
+	i = ao2_iterator_init(channels_by_uniqueid, 0);
+	while (!found && (c = channel_walk_next(&i))) {
 		tris_channel_lock(c);
 		if (!strcasecmp(c->exten, exten)&& !strcasecmp(c->cid.cid_num, cid)) {
-			tris_channel_unlock(c);
-			TRIS_RWLIST_UNLOCK(&channels);
-			return 1;
-
+			found = 1;
 		}
 		if (!strcasecmp(c->exten, exten)&& !strcasecmp(c->cid.cid_num, exten)) {
-			tris_channel_unlock(c);
-			TRIS_RWLIST_UNLOCK(&channels);
-			return 1;
-
+			found = 1;
 		}
 		tris_channel_unlock(c);
+		channel_walk_release(c);
 	}
-	TRIS_RWLIST_UNLOCK(&channels);
+	ao2_iterator_destroy(&i);
 	
-	return 0;
+	return found;
 
 }
 
 void tris_rakwonchannel_hangup(const struct tris_channel *chan)
 {
-	struct tris_channel *c = NULL;
+	struct ao2_iterator i;
+	struct tris_channel *c;
 
-	TRIS_RWLIST_RDLOCK(&channels);
-	TRIS_RWLIST_TRAVERSE(&channels, c, chan_list) {
+	i = ao2_iterator_init(channels_by_uniqueid, 0);
+	while ((c = channel_walk_next(&i))) {
 		tris_channel_lock(c);
 		if ((c != chan) && !strcasecmp(c->tech->type, chan->tech->type) && !strcasecmp(c->cid.cid_num, chan->cid.cid_num)) {
 				tris_softhangup(c, TRIS_SOFTHANGUP_EXPLICIT);
 				tris_log(LOG_WARNING, "tris_rakwonchannel_hangup() --- hangup channel duplicated: '%p' \n", (void*)c);
 		}
 		tris_channel_unlock(c);
+		channel_walk_release(c);
 	}
-	TRIS_RWLIST_UNLOCK(&channels);
+	ao2_iterator_destroy(&i);
 }
 
 /*! \brief Search for a channel based on the passed channel matching callback (first match) and return it, locked */
 struct tris_channel *tris_channel_search_locked(int (*is_match)(struct tris_channel *, void *), void *data)
 {
-	struct tris_channel *c = NULL;
+	struct ao2_iterator i;
+	struct tris_channel *c;
 
-	TRIS_RWLIST_RDLOCK(&channels);
-	TRIS_RWLIST_TRAVERSE(&channels, c, chan_list) {
+	i = ao2_iterator_init(channels_by_uniqueid, 0);
+	while ((c = channel_walk_next(&i))) {
 		tris_channel_lock(c);
+		channel_walk_release(c);
 		if (is_match(c, data)) {
 			break;
 		}
 		tris_channel_unlock(c);
 	}
-	TRIS_RWLIST_UNLOCK(&channels);
+	ao2_iterator_destroy(&i);
 
 	return c;
 }
@@ -1486,12 +1663,23 @@ void tris_channel_free(struct tris_channel *chan)
 		if (!TRIS_RWLIST_REMOVE(&channels, chan, chan_list)) {
 			tris_debug(1, "Unable to find channel in list to free. Assuming it has already been done.\n");
 		}
-		/* Lock and unlock the channel just to be sure nobody has it locked still
-		   due to a reference retrieved from the channel list. */
-		tris_channel_lock(chan);
-		tris_channel_unlock(chan);
+		tris_clear_flag(chan, TRIS_FLAG_IN_CHANNEL_LIST);
+		channel_registry_remove(chan);
+		TRIS_RWLIST_UNLOCK(&channels);
 	}
 
+	/* Off the registry, no new walk can hold the channel.  Wait for the
+	   walks that still do. */
+	tris_mutex_lock(&channel_walkers_lock);
+	while (chan->walkers)
+		tris_cond_wait(&channel_walkers_cond, &channel_walkers_lock);
+	tris_mutex_unlock(&channel_walkers_lock);
+
+	/* Lock and unlock the channel just to be sure nobody has it locked still
+	   due to a reference retrieved from the channel list. */
+	tris_channel_lock(chan);
+	tris_channel_unlock(chan);
+
 	/* Get rid of each of the data stores on the channel */
 	tris_channel_lock(chan);
 	while ((datastore = TRIS_LIST_REMOVE_HEAD(&chan->datastores, entry)))
@@ -1575,8 +1763,6 @@ void tris_channel_free(struct tris_channel *chan)
 
 	tris_string_field_free_memory(chan);
 	tris_free(chan);
-	if (inlist)
-		TRIS_RWLIST_UNLOCK(&channels);
 
 	/* Queue an unknown state, because, while we know that this particular
 	 * instance is dead, we don't know the state of all other possible
@@ -1806,6 +1992,7 @@ int tris_hangup(struct tris_channel *chan)
 		tris_log(LOG_ERROR, "Unable to find channel in list to free. Assuming it has already been done.\n");
 	}
 	tris_clear_flag(chan, TRIS_FLAG_IN_CHANNEL_LIST);
+	channel_registry_remove(chan);
 	TRIS_RWLIST_UNLOCK(&channels);
 
 	tris_channel_lock(chan);
@@ -2579,7 +2766,7 @@ int tris_waitfordigit_full(struct tris_channel *c, int ms, int audiofd, int cmdf
 					/* Unimportant */
 					break;
 				default:
-					tris_log(LOG_WARNING, "Unexpected control subclass '%d'\n", f->subclass);
+					tris_log(LOG_WARNING, "Unexpected control subclass '%d'\n", (int) f->subclass);
 					break;
 				}
 				break;
@@ -2931,7 +3118,7 @@ static struct tris_frame *__tris_read(struct tris_channel *chan, int dropaudio)
 			break;
 		case TRIS_FRAME_DTMF_END:
 			send_dtmf_event(chan, "Received", f->subclass, "No", "Yes");
-			tris_log(LOG_DTMF, "DTMF end '%c' received on %s, duration %ld ms\n", f->subclass, chan->name, f->len);
+			tris_log(LOG_DTMF, "DTMF end '%c' received on %s, duration %ld ms\n", (int) f->subclass, chan->name, f->len);
 			/* Queue it up if DTMF is deferred, or if DTMF emulation is forced. */
 			if (tris_test_flag(chan, TRIS_FLAG_DEFER_DTMF) || tris_test_flag(chan, TRIS_FLAG_EMULATE_DTMF)) {
 				queue_dtmf_readq(chan, f);
@@ -2957,7 +3144,7 @@ static struct tris_frame *__tris_read(struct tris_channel *chan, int dropaudio)
 							chan->emulate_dtmf_duration = TRIS_MIN_DTMF_DURATION;
 					} else
 						chan->emulate_dtmf_duration = TRIS_DEFAULT_EMULATE_DTMF_DURATION;
-					tris_log(LOG_DTMF, "DTMF begin emulation of '%c' with duration %u queued on %s\n", f->subclass, chan->emulate_dtmf_duration, chan->name);
+					tris_log(LOG_DTMF, "DTMF begin emulation of '%c' with duration %u queued on %s\n", (int) f->subclass, chan->emulate_dtmf_duration, chan->name);
 				}
 				if (chan->audiohooks) {
 					struct tris_frame *old_frame = f;
@@ -2971,23 +3158,23 @@ static struct tris_frame *__tris_read(struct tris_channel *chan, int dropaudio)
 			} else {
 				struct timeval now = tris_tvnow();
 				if (tris_test_flag(chan, TRIS_FLAG_IN_DTMF)) {
-					tris_log(LOG_DTMF, "DTMF end accepted with begin '%c' on %s\n", f->subclass, chan->name);
+					tris_log(LOG_DTMF, "DTMF end accepted with begin '%c' on %s\n", (int) f->subclass, chan->name);
 					tris_clear_flag(chan, TRIS_FLAG_IN_DTMF);
 					if (!f->len)
 						f->len = tris_tvdiff_ms(now, chan->dtmf_tv);
 				} else if (!f->len) {
-					tris_log(LOG_DTMF, "DTMF end accepted without begin '%c' on %s\n", f->subclass, chan->name);
+					tris_log(LOG_DTMF, "DTMF end accepted without begin '%c' on %s\n", (int) f->subclass, chan->name);
 					f->len = TRIS_MIN_DTMF_DURATION;
 				}
 				if (f->len < TRIS_MIN_DTMF_DURATION && !tris_test_flag(chan, TRIS_FLAG_END_DTMF_ONLY)) {
-					tris_log(LOG_DTMF, "DTMF end '%c' has duration %ld but want minimum %d, emulating on %s\n", f->subclass, f->len, TRIS_MIN_DTMF_DURATION, chan->name);
+					tris_log(LOG_DTMF, "DTMF end '%c' has duration %ld but want minimum %d, emulating on %s\n", (int) f->subclass, f->len, TRIS_MIN_DTMF_DURATION, chan->name);
 					tris_set_flag(chan, TRIS_FLAG_EMULATE_DTMF);
 					chan->emulate_dtmf_digit = f->subclass;
 					chan->emulate_dtmf_duration = TRIS_MIN_DTMF_DURATION - f->len;
 					tris_frfree(f);
 					f = &tris_null_frame;
 				} else {
-					tris_log(LOG_DTMF, "DTMF end passthrough '%c' on %s\n", f->subclass, chan->name);
+					tris_log(LOG_DTMF, "DTMF end passthrough '%c' on %s\n", (int) f->subclass, chan->name);
 					if (f->len < TRIS_MIN_DTMF_DURATION) {
 						f->len = TRIS_MIN_DTMF_DURATION;
 					}
@@ -3003,17 +3190,17 @@ static struct tris_frame *__tris_read(struct tris_channel *chan, int dropaudio)
 			break;
 		case TRIS_FRAME_DTMF_BEGIN:
 			send_dtmf_event(chan, "Received", f->subclass, "Yes", "No");
-			tris_log(LOG_DTMF, "DTMF begin '%c' received on %s\n", f->subclass, chan->name);
+			tris_log(LOG_DTMF, "DTMF begin '%c' received on %s\n", (int) f->subclass, chan->name);
 			if ( tris_test_flag(chan, TRIS_FLAG_DEFER_DTMF | TRIS_FLAG_END_DTMF_ONLY | TRIS_FLAG_EMULATE_DTMF) || 
 			    (!tris_tvzero(chan->dtmf_tv) && 
 			      tris_tvdiff_ms(tris_tvnow(), chan->dtmf_tv) < TRIS_MIN_DTMF_GAP) ) {
-				tris_log(LOG_DTMF, "DTMF begin ignored '%c' on %s\n", f->subclass, chan->name);
+				tris_log(LOG_DTMF, "DTMF begin ignored '%c' on %s\n", (int) f->subclass, chan->name);
 				tris_frfree(f);
 				f = &tris_null_frame;
 			} else {
 				tris_set_flag(chan, TRIS_FLAG_IN_DTMF);
 				chan->dtmf_tv = tris_tvnow();
-				tris_log(LOG_DTMF, "DTMF begin passthrough '%c' on %s\n", f->subclass, chan->name);
+				tris_log(LOG_DTMF, "DTMF begin passthrough '%c' on %s\n", (int) f->subclass, chan->name);
 			}
 			break;
 		case TRIS_FRAME_NULL:
@@ -3036,7 +3223,7 @@ static struct tris_frame *__tris_read(struct tris_channel *chan, int dropaudio)
 					chan->dtmf_tv = now;
 					tris_clear_flag(chan, TRIS_FLAG_EMULATE_DTMF);
 					chan->emulate_dtmf_digit = 0;
-					tris_log(LOG_DTMF, "DTMF end emulation of '%c' queued on %s\n", f->subclass, chan->name);
+					tris_log(LOG_DTMF, "DTMF end emulation of '%c' queued on %s\n", (int) f->subclass, chan->name);
 					if (chan->audiohooks) {
 						struct tris_frame *old_frame = f;
 						f = tris_audiohook_write_list(chan, chan->audiohooks, TRIS_AUDIOHOOK_DIRECTION_READ, f);
@@ -3080,7 +3267,7 @@ static struct tris_frame *__tris_read(struct tris_channel *chan, int dropaudio)
 						if (old_frame != f)
 							tris_frfree(old_frame);
 					}
-					tris_log(LOG_DTMF, "DTMF end emulation of '%c' queued on %s\n", f->subclass, chan->name);
+					tris_log(LOG_DTMF, "DTMF end emulation of '%c' queued on %s\n", (int) f->subclass, chan->name);
 				} else {
 					/* Drop voice frames while we're still in the middle of the digit */
 					tris_frfree(f);
@@ -3770,10 +3957,10 @@ done:
 	return res;
 }
 
-static int set_format(struct tris_channel *chan, int fmt, int *rawformat, int *format,
+static int set_format(struct tris_channel *chan, format_t fmt, format_t *rawformat, format_t *format,
 		      struct tris_trans_pvt **trans, const int direction)
 {
-	int native;
+	format_t native;
 	int res;
 	char from[200], to[200];
 	
@@ -3828,13 +4015,13 @@ static int set_format(struct tris_channel *chan, int fmt, int *rawformat, int *f
 	return 0;
 }
 
-int tris_set_read_format(struct tris_channel *chan, int fmt)
+int tris_set_read_format(struct tris_channel *chan, format_t fmt)
 {
 	return set_format(chan, fmt, &chan->rawreadformat, &chan->readformat,
 			  &chan->readtrans, 0);
 }
 
-int tris_set_write_format(struct tris_channel *chan, int fmt)
+int tris_set_write_format(struct tris_channel *chan, format_t fmt)
 {
 	return set_format(chan, fmt, &chan->rawwriteformat, &chan->writeformat,
 			  &chan->writetrans, 1);
@@ -3886,7 +4073,7 @@ static void handle_cause(int cause, int *outstate)
 	}
 }
 
-struct tris_channel *tris_call_forward(struct tris_channel *caller, struct tris_channel *orig, int *timeout, int format, struct outgoing_helper *oh, int *outstate)
+struct tris_channel *tris_call_forward(struct tris_channel *caller, struct tris_channel *orig, int *timeout, format_t format, struct outgoing_helper *oh, int *outstate)
 {
 	char tmpchan[256];
 	struct tris_channel *new = NULL;
@@ -3958,7 +4145,7 @@ struct tris_channel *tris_call_forward(struct tris_channel *caller, struct tris_
 	return new;
 }
 
-struct tris_channel *__tris_request_and_dial(const char *type, int format, void *data, int timeout, int *outstate,
+struct tris_channel *__tris_request_and_dial(const char *type, format_t format, void *data, int timeout, int *outstate,
 		const char *cid_num, const char *cid_name, struct outgoing_helper *oh)
 {
 	int dummy_outstate;
@@ -4067,7 +4254,7 @@ struct tris_channel *__tris_request_and_dial(const char *type, int format, void
 					break;
 
 				default:
-					tris_log(LOG_NOTICE, "Don't know what to do with control frame %d\n", f->subclass);
+					tris_log(LOG_NOTICE, "Don't know what to do with control frame %d\n", (int) f->subclass);
 				}
 				last_subclass = f->subclass;
 			}
@@ -4109,22 +4296,22 @@ struct tris_channel *__tris_request_and_dial(const char *type, int format, void
 	return chan;
 }
 
-struct tris_channel *tris_request_and_dial(const char *type, int format, void *data, int timeout, int *outstate,
+struct tris_channel *tris_request_and_dial(const char *type, format_t format, void *data, int timeout, int *outstate,
 		const char *cidnum, const char *cidname)
 {
 	return __tris_request_and_dial(type, format, data, timeout, outstate, cidnum, cidname, NULL);
 }
 
-struct tris_channel *tris_request(const char *type, int format, void *data, int *cause, struct tris_channel* src)
+struct tris_channel *tris_request(const char *type, format_t format, void *data, int *cause, struct tris_channel* src)
 {
 	struct chanlist *chan;
 	struct tris_channel *c;
-	int capabilities;
-	int fmt;
+	format_t capabilities;
+	format_t fmt;
 	int res;
 	int foo;
-	int videoformat = format & TRIS_FORMAT_VIDEO_MASK;
-	int textformat = format & TRIS_FORMAT_TEXT_MASK;
+	format_t videoformat = format & TRIS_FORMAT_VIDEO_MASK;
+	format_t textformat = format & TRIS_FORMAT_TEXT_MASK;
 
 	if (!cause)
 		cause = &foo;
@@ -4147,7 +4334,8 @@ struct tris_channel *tris_request(const char *type, int format, void *data, int
 			*/
 			res = tris_translator_best_choice(&fmt, &capabilities);
 			if (res < 0) {
-				tris_log(LOG_WARNING, "No translator path exists for channel type %s (native 0x%x) to 0x%x\n", type, chan->tech->capabilities, format);
+				tris_log(LOG_WARNING, "No translator path exists for channel type %s (native 0x%llx) to 0x%llx\n", type,
+					(unsigned long long) chan->tech->capabilities, (unsigned long long) format);
 				*cause = TRIS_CAUSE_BEARERCAPABILITY_NOTAVAIL;
 				TRIS_RWLIST_UNLOCK(&channels);
 				return NULL;
@@ -4290,8 +4478,8 @@ int tris_channel_sendurl(struct tris_channel *chan, const char *url)
 /*! \brief Set up translation from one channel to another */
 static int tris_channel_make_compatible_helper(struct tris_channel *from, struct tris_channel *to)
 {
-	int src;
-	int dst;
+	format_t src;
+	format_t dst;
 
 	if (from->readformat == to->writeformat && from->writeformat == to->readformat) {
 		/* Already compatible!  Moving on ... */
@@ -4307,7 +4495,7 @@ static int tris_channel_make_compatible_helper(struct tris_channel *from, struct
 		return 0;
 
 	if (tris_translator_best_choice(&dst, &src) < 0) {
-		tris_log(LOG_WARNING, "No path to translate from %s(%d) to %s(%d)\n", from->name, src, to->name, dst);
+		tris_log(LOG_WARNING, "No path to translate from %s(%s) to %s(%s)\n", from->name, tris_getformatname(src), to->name, tris_getformatname(dst));
 		return -1;
 	}
 
@@ -4319,11 +4507,11 @@ static int tris_channel_make_compatible_helper(struct tris_channel *from, struct
 	    (tris_translate_path_steps(dst, src) != 1))
 		dst = TRIS_FORMAT_SLINEAR;
 	if (tris_set_read_format(from, dst) < 0) {
-		tris_log(LOG_WARNING, "Unable to set read format on channel %s to %d\n", from->name, dst);
+		tris_log(LOG_WARNING, "Unable to set read format on channel %s to %s\n", from->name, tris_getformatname(dst));
 		return -1;
 	}
 	if (tris_set_write_format(to, dst) < 0) {
-		tris_log(LOG_WARNING, "Unable to set write format on channel %s to %d\n", to->name, dst);
+		tris_log(LOG_WARNING, "Unable to set write format on channel %s to %s\n", to->name, tris_getformatname(dst));
 		return -1;
 	}
 	return 0;
@@ -4428,7 +4616,7 @@ retrymasq:
 void tris_change_name(struct tris_channel *chan, char *newname)
 {
 	manager_event(EVENT_FLAG_CALL, "Rename", "Channel: %s\r\nNewname: %s\r\nUniqueid: %s\r\n", chan->name, newname, chan->uniqueid);
-	tris_string_field_set(chan, name, newname);
+	channel_set_name(chan, newname);
 }
 
 void tris_channel_inherit_variables(const struct tris_channel *parent, struct tris_channel *child)
@@ -4534,8 +4722,9 @@ int tris_do_masquerade(struct tris_channel *original)
 	struct tris_channel *clonechan = original->masq;
 	struct tris_channel *bridged;
 	struct tris_cdr *cdr;
-	int rformat = original->readformat;
-	int wformat = original->writeformat;
+	format_t rformat = original->readformat;
+	format_t wformat = original->writeformat;
+	format_t rawformat;
 	char newn[TRIS_CHANNEL_NAME];
 	char orig[TRIS_CHANNEL_NAME];
 	char masqn[TRIS_CHANNEL_NAME];
@@ -4575,10 +4764,10 @@ int tris_do_masquerade(struct tris_channel *original)
 	snprintf(masqn, sizeof(masqn), "%s<MASQ>", newn);
 		
 	/* Copy the name from the clone channel */
-	tris_string_field_set(original, name, newn);
+	channel_set_name(original, newn);
 
 	/* Mangle the name of the clone channel */
-	tris_string_field_set(clonechan, name, masqn);
+	channel_set_name(clonechan, masqn);
 	
 	/* Notify any managers of the change, first the masq then the other */
 	manager_event(EVENT_FLAG_CALL, "Rename", "Channel: %s\r\nNewname: %s\r\nUniqueid: %s\r\n", newn, masqn, clonechan->uniqueid);
@@ -4636,12 +4825,12 @@ int tris_do_masquerade(struct tris_channel *original)
 	}
 
 	/* Swap the raw formats */
-	x = original->rawreadformat;
+	rawformat = original->rawreadformat;
 	original->rawreadformat = clonechan->rawreadformat;
-	clonechan->rawreadformat = x;
-	x = original->rawwriteformat;
+	clonechan->rawreadformat = rawformat;
+	rawformat = original->rawwriteformat;
 	original->rawwriteformat = clonechan->rawwriteformat;
-	clonechan->rawwriteformat = x;
+	clonechan->rawwriteformat = rawformat;
 
 	clonechan->_softhangup = TRIS_SOFTHANGUP_DEV;
 
@@ -4670,7 +4859,7 @@ int tris_do_masquerade(struct tris_channel *original)
 
 	snprintf(zombn, sizeof(zombn), "%s<ZOMBIE>", orig);
 	/* Mangle the name of the clone channel */
-	tris_string_field_set(clonechan, name, zombn);
+	channel_set_name(clonechan, zombn);
 	manager_event(EVENT_FLAG_CALL, "Rename", "Channel: %s\r\nNewname: %s\r\nUniqueid: %s\r\n", masqn, zombn, clonechan->uniqueid);
 
 	/* Update the type. */
@@ -4741,7 +4930,7 @@ int tris_do_masquerade(struct tris_channel *original)
 	/* Copy the music class */
 	tris_string_field_set(original, musicclass, clonechan->musicclass);
 
-	tris_debug(1, "Putting channel %s in %d/%d formats\n", original->name, wformat, rformat);
+	tris_debug(1, "Putting channel %s in %s/%s formats\n", original->name, tris_getformatname(wformat), tris_getformatname(rformat));
 
 	/* Okay.  Last thing is to let the channel driver know about all this mess, so he
 	   can fix up everything as best as possible */
@@ -4922,8 +5111,8 @@ static enum tris_bridge_result tris_generic_bridge(struct tris_channel *c0, stru
 	struct tris_channel *cs[3];
 	struct tris_frame *f;
 	enum tris_bridge_result res = TRIS_BRIDGE_COMPLETE;
-	int o0nativeformats;
-	int o1nativeformats;
+	format_t o0nativeformats;
+	format_t o1nativeformats;
 	int watch_c0_dtmf;
 	int watch_c1_dtmf;
 	void *pvt0, *pvt1;
@@ -5043,7 +5232,7 @@ static enum tris_bridge_result tris_generic_bridge(struct tris_channel *c0, stru
 				*fo = f;
 				*rc = who;
 				bridge_exit = 1;
-				tris_debug(1, "Got a FRAME_CONTROL (%d) frame on channel %s\n", f->subclass, who->name);
+				tris_debug(1, "Got a FRAME_CONTROL (%d) frame on channel %s\n", (int) f->subclass, who->name);
 				break;
 			}
 			if (bridge_exit)
@@ -5204,8 +5393,8 @@ enum tris_bridge_result tris_channel_bridge(struct tris_channel *c0, struct tris
 	enum tris_bridge_result res = TRIS_BRIDGE_COMPLETE;
 	int nativefailed=0;
 	int firstpass;
-	int o0nativeformats;
-	int o1nativeformats;
+	format_t o0nativeformats;
+	format_t o1nativeformats;
 	long time_left_ms=0;
 	char caller_warning = 0;
 	char callee_warning = 0;
@@ -5491,7 +5680,7 @@ struct tonepair_state {
 	int v1_2;
 	int v2_2;
 	int v3_2;
-	int origwfmt;
+	format_t origwfmt;
 	int pos;
 	int duration;
 	int modulate;
@@ -5705,6 +5894,9 @@ void tris_moh_cleanup(struct tris_channel *chan)
 
 void tris_channels_init(void)
 {
+	channels_by_name = ao2_container_alloc(CHANNEL_INDEX_BUCKETS, channel_index_name_hash, channel_index_name_cmp);
+	channels_by_uniqueid = ao2_container_alloc(CHANNEL_INDEX_BUCKETS, channel_index_uniqueid_hash, channel_index_uniqueid_cmp);
+	tris_cond_init(&channel_walkers_cond, NULL);
 	tris_cli_register_multiple(cli_channel, ARRAY_LEN(cli_channel));
 }
 
@@ -5779,7 +5971,7 @@ static struct tris_generator silence_generator = {
 };
 
 struct tris_silence_generator {
-	int old_write_format;
+	format_t old_write_format;
 };
 
 struct tris_silence_generator *tris_channel_start_silence_generator(struct tris_channel *chan)
@@ -0,0 +1,22 @@
+/* config.h.  Generated automatically by configure.  */
+/* #undef SUNOS */
+/* #undef CYGWIN */
+
+#define HAVE_SYS_CDEFS_H 1
+#define HAVE_TERMCAP_H 1
+/* #undef HAVE_CURSES_H */
+/* #undef HAVE_NCURSES_H */
+/* #undef HAVE_TERM_H */
+/* #undef HAVE_VIS_H */
+/* #undef HAVE_ISSETUGID */
+
+/* #undef HAVE_STRLCAT */
+/* #undef HAVE_STRLCPY */
+/* #undef HAVE_FGETLN */
+/* #undef HAVE_STRVIS */
+/* #undef HAVE_STRUNVIS */
+
+#include "sys.h"
+#ifdef CYGWIN
+# include "cygdef.h"
+#endif
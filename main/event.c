@@ -38,6 +38,7 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 245626 $")
 #include "trismedia/utils.h"
 #include "trismedia/taskprocessor.h"
 #include "trismedia/astobj2.h"
+#include "trismedia/cli.h"
 
 struct tris_taskprocessor *event_dispatcher;
 
@@ -95,9 +96,13 @@ struct tris_event {
  * if one of these two things is done:
  *  - tris_event gets changed such that it never has to be realloc()d
  *  - astobj2 is updated so that you can realloc() an astobj2 object
+ *
+ * It also carries queued events to the dispatcher, with the time they were
+ * queued for the dispatch statistics.
  */
 struct tris_event_ref {
 	struct tris_event *event;
+	struct timeval queued;
 };
 
 struct tris_event_ie_val {
@@ -123,6 +128,8 @@ struct tris_event_sub {
 	uint32_t uniqueid;
 	TRIS_LIST_HEAD_NOLOCK(, tris_event_ie_val) ie_vals;
 	TRIS_RWDLLIST_ENTRY(tris_event_sub) entry;
+	/*! Entry in the tris_event_sub_index bucket, if the event type has one */
+	TRIS_DLLIST_ENTRY(tris_event_sub) index_entry;
 };
 
 static uint32_t sub_uniqueid;
@@ -131,6 +138,55 @@ static uint32_t sub_uniqueid;
  * The event subscribers are indexed by which event they are subscribed to */
 static TRIS_RWDLLIST_HEAD(tris_event_sub_list, tris_event_sub) tris_event_subs[TRIS_EVENT_TOTAL];
 
+#ifdef LOW_MEMORY
+#define NUM_SUB_BUCKETS 17
+#else
+#define NUM_SUB_BUCKETS 563
+#endif
+
+/*!
+ * \brief String information element that subscriptions to an event type are indexed by
+ *
+ * \details A subscription that requires a value for it, such as a phone's
+ * subscription to the MWI of its mailbox, is only checked against the events
+ * with the same value, instead of against every event of the type.
+ */
+static const enum tris_event_ie_type tris_event_sub_keys[TRIS_EVENT_TOTAL] = {
+	[TRIS_EVENT_MWI] = TRIS_EVENT_IE_MAILBOX,
+	[TRIS_EVENT_DEVICE_STATE] = TRIS_EVENT_IE_DEVICE,
+	[TRIS_EVENT_DEVICE_STATE_CHANGE] = TRIS_EVENT_IE_DEVICE,
+};
+
+TRIS_DLLIST_HEAD_NOLOCK(tris_event_sub_bucket, tris_event_sub);
+
+/*!
+ * \brief Subscriptions to an event type with a key, by the hash of their value for it
+ *
+ * \note Protected by the lock of the tris_event_subs list for the type, which
+ * still holds all of its subscriptions.
+ */
+struct tris_event_sub_index {
+	/*! Subscriptions that do not require a value for the key */
+	struct tris_event_sub_bucket unkeyed;
+	struct tris_event_sub_bucket keyed[NUM_SUB_BUCKETS];
+};
+
+/*! \brief Allocated in tris_event_init() for the types in tris_event_sub_keys */
+static struct tris_event_sub_index *tris_event_sub_index[TRIS_EVENT_TOTAL];
+
+/*! \brief Dispatch statistics, by event type */
+static struct {
+	/*! Events dispatched */
+	unsigned int events;
+	/*! Subscriber callbacks run */
+	unsigned int calls;
+	/*! Total time from queueing each event to its last callback returning */
+	uint64_t latency_us;
+	unsigned int max_latency_us;
+} tris_event_stats[TRIS_EVENT_TOTAL];
+
+TRIS_MUTEX_DEFINE_STATIC(tris_event_stats_lock);
+
 static int tris_event_cmp(void *obj, void *arg, int flags);
 static int tris_event_hash_mwi(const void *obj, const int flags);
 static int tris_event_hash_devstate(const void *obj, const int flags);
@@ -657,8 +713,28 @@ int tris_event_sub_append_ie_raw(struct tris_event_sub *sub,
 	return 0;
 }
 
+/*! \brief The tris_event_sub_index bucket of a subscription, NULL if its type has no index */
+static struct tris_event_sub_bucket *sub_bucket(const struct tris_event_sub *sub)
+{
+	struct tris_event_sub_index *index = tris_event_sub_index[sub->type];
+	struct tris_event_ie_val *ie_val;
+
+	if (!index)
+		return NULL;
+
+	TRIS_LIST_TRAVERSE(&sub->ie_vals, ie_val, entry) {
+		if (ie_val->ie_type == tris_event_sub_keys[sub->type] &&
+			ie_val->ie_pltype == TRIS_EVENT_IE_PLTYPE_STR)
+			return &index->keyed[ie_val->payload.hash % NUM_SUB_BUCKETS];
+	}
+
+	return &index->unkeyed;
+}
+
 int tris_event_sub_activate(struct tris_event_sub *sub)
 {
+	struct tris_event_sub_bucket *bucket;
+
 	if (tris_event_check_subscriber(TRIS_EVENT_SUB,
 		TRIS_EVENT_IE_EVENTTYPE, TRIS_EVENT_IE_PLTYPE_UINT, sub->type,
 		TRIS_EVENT_IE_END) != TRIS_EVENT_SUB_NONE) {
@@ -672,6 +748,8 @@ int tris_event_sub_activate(struct tris_event_sub *sub)
 
 	TRIS_RWDLLIST_WRLOCK(&tris_event_subs[sub->type]);
 	TRIS_RWDLLIST_INSERT_TAIL(&tris_event_subs[sub->type], sub, entry);
+	if ((bucket = sub_bucket(sub)))
+		TRIS_DLLIST_INSERT_TAIL(bucket, sub, index_entry);
 	TRIS_RWDLLIST_UNLOCK(&tris_event_subs[sub->type]);
 
 	return 0;
@@ -743,9 +821,12 @@ void tris_event_sub_destroy(struct tris_event_sub *sub)
 struct tris_event_sub *tris_event_unsubscribe(struct tris_event_sub *sub)
 {
 	struct tris_event *event;
+	struct tris_event_sub_bucket *bucket;
 
 	TRIS_RWDLLIST_WRLOCK(&tris_event_subs[sub->type]);
 	TRIS_DLLIST_REMOVE(&tris_event_subs[sub->type], sub, entry);
+	if ((bucket = sub_bucket(sub)))
+		TRIS_DLLIST_REMOVE(bucket, sub, index_entry);
 	TRIS_RWDLLIST_UNLOCK(&tris_event_subs[sub->type]);
 
 	if (tris_event_check_subscriber(TRIS_EVENT_UNSUB,
@@ -1114,27 +1195,52 @@ queue_event:
 	return tris_event_queue(event) ? -1 : res;
 }
 
+/*! \brief Run the callback of a subscription if the event matches it
+ * \retval 1 if the callback was run
+ */
+static int dispatch_sub(const struct tris_event *event, struct tris_event_sub *sub)
+{
+	struct tris_event_ie_val *ie_val;
+
+	TRIS_LIST_TRAVERSE(&sub->ie_vals, ie_val, entry) {
+		if (!match_ie_val(event, ie_val, NULL)) {
+			return 0;
+		}
+	}
+	sub->cb(event, sub->userdata);
+
+	return 1;
+}
+
 static int handle_event(void *data)
 {
 	struct tris_event_ref *event_ref = data;
 	struct tris_event_sub *sub;
+	struct tris_event_sub_index *index;
 	uint16_t host_event_type;
+	unsigned int calls = 0, latency;
+	const char *key;
 
 	host_event_type = ntohs(event_ref->event->type);
 
 	/* Subscribers to this specific event first */
 	TRIS_RWDLLIST_RDLOCK(&tris_event_subs[host_event_type]);
-	TRIS_RWDLLIST_TRAVERSE(&tris_event_subs[host_event_type], sub, entry) {
-		struct tris_event_ie_val *ie_val;
-		TRIS_LIST_TRAVERSE(&sub->ie_vals, ie_val, entry) {
-			if (!match_ie_val(event_ref->event, ie_val, NULL)) {
-				break;
+	if ((index = tris_event_sub_index[host_event_type])) {
+		/* Only subscribers to the key of this event, or to no key, can match */
+		if ((key = tris_event_get_ie_str(event_ref->event, tris_event_sub_keys[host_event_type]))) {
+			uint32_t hash = tris_event_get_ie_str_hash(event_ref->event, tris_event_sub_keys[host_event_type]);
+
+			TRIS_DLLIST_TRAVERSE(&index->keyed[hash % NUM_SUB_BUCKETS], sub, index_entry) {
+				calls += dispatch_sub(event_ref->event, sub);
 			}
 		}
-		if (ie_val) {
-			continue;
+		TRIS_DLLIST_TRAVERSE(&index->unkeyed, sub, index_entry) {
+			calls += dispatch_sub(event_ref->event, sub);
+		}
+	} else {
+		TRIS_RWDLLIST_TRAVERSE(&tris_event_subs[host_event_type], sub, entry) {
+			calls += dispatch_sub(event_ref->event, sub);
 		}
-		sub->cb(event_ref->event, sub->userdata);
 	}
 	TRIS_RWDLLIST_UNLOCK(&tris_event_subs[host_event_type]);
 
@@ -1142,9 +1248,20 @@ static int handle_event(void *data)
 	TRIS_RWDLLIST_RDLOCK(&tris_event_subs[TRIS_EVENT_ALL]);
 	TRIS_RWDLLIST_TRAVERSE(&tris_event_subs[TRIS_EVENT_ALL], sub, entry) {
 		sub->cb(event_ref->event, sub->userdata);
+		calls++;
 	}
 	TRIS_RWDLLIST_UNLOCK(&tris_event_subs[TRIS_EVENT_ALL]);
 
+	latency = tris_tvdiff_us(tris_tvnow(), event_ref->queued);
+	tris_mutex_lock(&tris_event_stats_lock);
+	tris_event_stats[host_event_type].events++;
+	tris_event_stats[host_event_type].calls += calls;
+	tris_event_stats[host_event_type].latency_us += latency;
+	if (latency > tris_event_stats[host_event_type].max_latency_us) {
+		tris_event_stats[host_event_type].max_latency_us = latency;
+	}
+	tris_mutex_unlock(&tris_event_stats_lock);
+
 	ao2_ref(event_ref, -1);
 
 	return 0;
@@ -1154,6 +1271,7 @@ int tris_event_queue(struct tris_event *event)
 {
 	struct tris_event_ref *event_ref;
 	uint16_t host_event_type;
+	const char *key;
 
 	host_event_type = ntohs(event->type);
 
@@ -1176,8 +1294,18 @@ int tris_event_queue(struct tris_event *event)
 	}
 
 	event_ref->event = event;
+	event_ref->queued = tris_tvnow();
+
+	/* Events for the same mailbox or device are dispatched in order, while
+	 * the rest of the worker pool dispatches the others.  Events without a
+	 * key all share one, so that for example subscription events stay in
+	 * order. */
+	if (!tris_event_sub_keys[host_event_type] ||
+		!(key = tris_event_get_ie_str(event, tris_event_sub_keys[host_event_type]))) {
+		key = "";
+	}
 
-	return tris_taskprocessor_push(event_dispatcher, handle_event, event_ref);
+	return tris_taskprocessor_push_keyed(event_dispatcher, key, handle_event, event_ref);
 }
 
 static int tris_event_hash_mwi(const void *obj, const int flags)
@@ -1286,6 +1414,65 @@ static int tris_event_cmp(void *obj, void *arg, int flags)
 	return res;
 }
 
+static char *handle_show_stats(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+#define FORMAT "%-20s %8s %8s %10s %10s %10s %10s\n"
+#define FORMAT2 "%-20s %8d %8d %10u %10u %10u %10u\n"
+	int i;
+
+	switch (cmd) {
+	case CLI_INIT:
+		e->command = "event show stats";
+		e->usage =
+			"Usage: event show stats\n"
+			"       Show the subscriptions to each event type, how many of them\n"
+			"       are indexed by the mailbox or device they are for, and the\n"
+			"       number of events dispatched with the time from queueing an\n"
+			"       event to its last subscriber callback returning.\n";
+		return NULL;
+	case CLI_GENERATE:
+		return NULL;
+	}
+
+	if (a->argc != e->args)
+		return CLI_SHOWUSAGE;
+
+	tris_cli(a->fd, FORMAT, "Type", "Subs", "Indexed", "Events", "Callbacks", "Avg (us)", "Max (us)");
+	for (i = 0; i < TRIS_EVENT_TOTAL; i++) {
+		struct tris_event_sub *sub;
+		int subs = 0, indexed = 0, j;
+		unsigned int events, calls, avg, max;
+
+		TRIS_RWDLLIST_RDLOCK(&tris_event_subs[i]);
+		TRIS_RWDLLIST_TRAVERSE(&tris_event_subs[i], sub, entry) {
+			subs++;
+		}
+		for (j = 0; tris_event_sub_index[i] && j < NUM_SUB_BUCKETS; j++) {
+			TRIS_DLLIST_TRAVERSE(&tris_event_sub_index[i]->keyed[j], sub, index_entry) {
+				indexed++;
+			}
+		}
+		TRIS_RWDLLIST_UNLOCK(&tris_event_subs[i]);
+
+		tris_mutex_lock(&tris_event_stats_lock);
+		events = tris_event_stats[i].events;
+		calls = tris_event_stats[i].calls;
+		avg = events ? tris_event_stats[i].latency_us / events : 0;
+		max = tris_event_stats[i].max_latency_us;
+		tris_mutex_unlock(&tris_event_stats_lock);
+
+		tris_cli(a->fd, FORMAT2, i == TRIS_EVENT_ALL ? "All" : event_names[i].name, subs, indexed, events, calls, avg, max);
+	}
+
+	return CLI_SUCCESS;
+#undef FORMAT
+#undef FORMAT2
+}
+
+static struct tris_cli_entry event_cli[] = {
+	TRIS_CLI_DEFINE(handle_show_stats, "Show event subscription and dispatch statistics"),
+};
+
 int tris_event_init(void)
 {
 	int i;
@@ -1294,6 +1481,16 @@ int tris_event_init(void)
 		TRIS_RWDLLIST_HEAD_INIT(&tris_event_subs[i]);
 	}
 
+	for (i = 0; i < TRIS_EVENT_TOTAL; i++) {
+		if (!tris_event_sub_keys[i]) {
+			continue;
+		}
+
+		if (!(tris_event_sub_index[i] = tris_calloc(1, sizeof(*tris_event_sub_index[i])))) {
+			return -1;
+		}
+	}
+
 	for (i = 0; i < TRIS_EVENT_TOTAL; i++) {
 		if (!tris_event_cache[i].hash_fn) {
 			/* This event type is not cached. */
@@ -1306,9 +1503,11 @@ int tris_event_init(void)
 		}
 	}
 
-	if (!(event_dispatcher = tris_taskprocessor_get("core_event_dispatcher", 0))) {
+	if (!(event_dispatcher = tris_taskprocessor_get("core_event_dispatcher", TPS_POOLED))) {
 		return -1;
 	}
 
+	tris_cli_register_multiple(event_cli, ARRAY_LEN(event_cli));
+
 	return 0;
 }
@@ -410,11 +410,11 @@ static void check_goto_on_transfer(struct tris_channel *chan)
 }
 
 static struct tris_channel *feature_request_and_dial(struct tris_channel *caller, struct tris_channel *transferee,
-		const char *type, int format, void *data, int timeout, int *outstate, const char *cid_num, const char *cid_name,
+		const char *type, format_t format, void *data, int timeout, int *outstate, const char *cid_num, const char *cid_name,
 		int igncallerstate, const char *language, int ringing, int notifycaller);
 
 static struct tris_channel *feature_dial_byrefer(struct tris_channel *caller, struct tris_channel *transferee, 
-		const char *type, int format, void *data, int timeout, int *outstate, const char *cid_num, const char *cid_name, 
+		const char *type, format_t format, void *data, int timeout, int *outstate, const char *cid_num, const char *cid_name, 
 		int igncallerstate, const char *language, int ringing, int notifycaller, const char *caller_context,
 		struct tris_bridge_config *config, const char *dst, int *holdstate);
 
@@ -2926,7 +2926,7 @@ int send_control_notify(struct tris_channel* caller, enum tris_control_frame_typ
  * \return always a channel
 */
 static struct tris_channel *feature_request_and_dial(struct tris_channel *caller, struct tris_channel *transferee, 
-		const char *type, int format, void *data, int timeout, int *outstate, const char *cid_num, const char *cid_name, 
+		const char *type, format_t format, void *data, int timeout, int *outstate, const char *cid_num, const char *cid_name, 
 		int igncallerstate, const char *language, int ringing, int notifycaller)
 {
 	int state = 0;
@@ -3158,7 +3158,7 @@ static struct tris_channel *feature_request_and_dial(struct tris_channel *caller
 						f->subclass == -1) {
 					tris_indicate(caller, f->subclass);
 				} else if (f->subclass != -1 && f->subclass != TRIS_CONTROL_PROGRESS) {
-					tris_log(LOG_NOTICE, "Don't know what to do about control frame: %d\n", f->subclass);
+					tris_log(LOG_NOTICE, "Don't know what to do about control frame: %d\n", (int) f->subclass);
 				}
 				/* else who cares */
 			} else if (f->frametype == TRIS_FRAME_VOICE || f->frametype == TRIS_FRAME_VIDEO) {
@@ -3384,7 +3384,7 @@ static int feature_connect_channels(struct tris_channel *transferee, struct tris
  * \return always a channel
 */
 static struct tris_channel *feature_dial_byrefer(struct tris_channel *caller, struct tris_channel *transferee, 
-		const char *type, int format, void *data, int timeout, int *outstate, const char *cid_num, const char *cid_name, 
+		const char *type, format_t format, void *data, int timeout, int *outstate, const char *cid_num, const char *cid_name, 
 		int igncallerstate, const char *language, int ringing, int notifycaller, const char *caller_context,
 		struct tris_bridge_config *config, const char* dst, int *holdstate)
 {
@@ -3690,7 +3690,7 @@ static struct tris_channel *feature_dial_byrefer(struct tris_channel *caller, st
 						f->subclass == -1) {
 					tris_indicate(caller, f->subclass);
 				} else if (f->subclass != -1 && f->subclass != TRIS_CONTROL_PROGRESS) {
-					tris_log(LOG_NOTICE, "Don't know what to do about control frame: %d\n", f->subclass);
+					tris_log(LOG_NOTICE, "Don't know what to do about control frame: %d\n", (int) f->subclass);
 				}
 				/* else who cares */
 			} else if (f->frametype == TRIS_FRAME_VOICE || f->frametype == TRIS_FRAME_VIDEO) {
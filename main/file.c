@@ -128,7 +128,7 @@ int tris_stopstream(struct tris_channel *tmp)
 		tris_closestream(tmp->stream);
 		tmp->stream = NULL;
 		if (tmp->oldwriteformat && tris_set_write_format(tmp, tmp->oldwriteformat))
-			tris_log(LOG_WARNING, "Unable to restore format back to %d\n", tmp->oldwriteformat);
+			tris_log(LOG_WARNING, "Unable to restore format back to %s\n", tris_getformatname(tmp->oldwriteformat));
 	}
 	/* Stop the video stream too */
 	if (tmp->vstream != NULL) {
@@ -404,11 +404,13 @@ enum file_action {
  * 	struct tris_channel * for OPEN
  * if fmt is NULL, OPEN will return the first matching entry,
  * whereas other functions will run on all matching entries.
+ * EXISTS returns the formats found, 0 if none, the others 0 or 1 on
+ * success and -1 on error.
  */
-static int tris_filehelper(const char *filename, const void *arg2, const char *fmt, const enum file_action action)
+static format_t tris_filehelper(const char *filename, const void *arg2, const char *fmt, const enum file_action action)
 {
 	struct tris_format *f;
-	int res = (action == ACTION_EXISTS) ? 0 : -1;
+	format_t res = (action == ACTION_EXISTS) ? 0 : -1;
 
 	TRIS_RWLIST_RDLOCK(&formats);
 	/* Check for a specific format */
@@ -528,11 +530,11 @@ static int is_absolute_path(const char *filename)
 	return filename[0] == '/';
 }
 
-static int fileexists_test(const char *filename, const char *fmt, const char *lang,
+static format_t fileexists_test(const char *filename, const char *fmt, const char *lang,
 			   char *buf, int buflen)
 {
 	if (buf == NULL) {
-		return -1;
+		return 0;
 	}
 
 	if (tris_language_is_prefix && !is_absolute_path(filename)) { /* new layout */
@@ -564,15 +566,17 @@ static int fileexists_test(const char *filename, const char *fmt, const char *la
  *
  * The last parameter(s) point to a buffer of sufficient size,
  * which on success is filled with the matching filename.
+ *
+ * \return the formats the file was found in, 0 if none
  */
-static int fileexists_core(const char *filename, const char *fmt, const char *preflang,
+static format_t fileexists_core(const char *filename, const char *fmt, const char *preflang,
 			   char *buf, int buflen)
 {
-	int res = -1;
+	format_t res;
 	char *lang = NULL;
 
 	if (buf == NULL) {
-		return -1;
+		return 0;
 	}
 
 	/* We try languages in the following order:
@@ -585,7 +589,7 @@ static int fileexists_core(const char *filename, const char *fmt, const char *pr
 	/* Try preferred language */
 	if (!tris_strlen_zero(preflang)) {
 		/* try the preflang exactly as it was requested */
-		if ((res = fileexists_test(filename, fmt, preflang, buf, buflen)) > 0) {
+		if ((res = fileexists_test(filename, fmt, preflang, buf, buflen))) {
 			return res;
 		} else {
 			/* try without a dialect */
@@ -594,7 +598,7 @@ static int fileexists_core(const char *filename, const char *fmt, const char *pr
 
 			strsep(&postfix, "_");
 			if (postfix) {
-				if ((res = fileexists_test(filename, fmt, lang, buf, buflen)) > 0) {
+				if ((res = fileexists_test(filename, fmt, lang, buf, buflen))) {
 					return res;
 				}
 			}
@@ -602,13 +606,13 @@ static int fileexists_core(const char *filename, const char *fmt, const char *pr
 	}
 
 	/* Try without any language */
-	if ((res = fileexists_test(filename, fmt, NULL, buf, buflen)) > 0) {
+	if ((res = fileexists_test(filename, fmt, NULL, buf, buflen))) {
 		return res;
 	}
 
 	/* Finally try the default language unless it was already tried before */
 	if ((tris_strlen_zero(preflang) || strcmp(preflang, DEFAULT_LANGUAGE)) && (tris_strlen_zero(lang) || strcmp(lang, DEFAULT_LANGUAGE))) {
-		if ((res = fileexists_test(filename, fmt, DEFAULT_LANGUAGE, buf, buflen)) > 0) {
+		if ((res = fileexists_test(filename, fmt, DEFAULT_LANGUAGE, buf, buflen))) {
 			return res;
 		}
 	}
@@ -628,7 +632,8 @@ struct tris_filestream *tris_openstream_full(struct tris_channel *chan, const ch
 	 * language and format, set up a suitable translator,
 	 * and open the stream.
 	 */
-	int fmts, res, buflen;
+	format_t fmts;
+	int res, buflen;
 	char *buf;
 
 	if (!asis) {
@@ -644,9 +649,8 @@ struct tris_filestream *tris_openstream_full(struct tris_channel *chan, const ch
 	if (buf == NULL)
 		return NULL;
 	fmts = fileexists_core(filename, NULL, preflang, buf, buflen);
-	if (fmts > 0)
-		fmts &= TRIS_FORMAT_AUDIO_MASK;
-	if (fmts < 1) {
+	fmts &= TRIS_FORMAT_AUDIO_MASK;
+	if (!fmts) {
 		tris_log(LOG_WARNING, "File %s does not exist in any format\n", filename);
 		return NULL;
 	}
@@ -664,7 +668,7 @@ struct tris_filestream *tris_openvstream(struct tris_channel *chan, const char *
 	/* As above, but for video. But here we don't have translators
 	 * so we must enforce a format.
 	 */
-	unsigned int format;
+	format_t format;
 	char *buf;
 	int buflen;
 
@@ -682,7 +686,7 @@ struct tris_filestream *tris_openvstream(struct tris_channel *chan, const char *
 		if (!(chan->nativeformats & format))
 			continue;
 		fmt = tris_getformatname(format);
-		if ( fileexists_core(filename, fmt, preflang, buf, buflen) < 1)	/* no valid format */
+		if (!fileexists_core(filename, fmt, preflang, buf, buflen))	/* no valid format */
 			continue;
 	 	fd = tris_filehelper(buf, chan, fmt, ACTION_OPEN);
 		if (fd >= 0)
@@ -911,7 +915,7 @@ int tris_closestream(struct tris_filestream *f)
 /*
  * Look the various language-specific places where a file could exist.
  */
-int tris_fileexists(const char *filename, const char *fmt, const char *preflang)
+format_t tris_fileexists(const char *filename, const char *fmt, const char *preflang)
 {
 	char *buf;
 	int buflen;
@@ -1289,7 +1293,7 @@ static int waitstream_core(struct tris_channel *c, const char *breakon,
 					/* Unimportant */
 					break;
 				default:
-					tris_log(LOG_WARNING, "Unexpected control subclass '%d'\n", fr->subclass);
+					tris_log(LOG_WARNING, "Unexpected control subclass '%d'\n", (int) fr->subclass);
 				}
 				break;
 			case TRIS_FRAME_VOICE:
@@ -39,6 +39,7 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 243247 $")
 #include "trismedia/translate.h"
 #include "trismedia/dsp.h"
 #include "trismedia/file.h"
+#include "trismedia/mix.h"
 
 #if !defined(LOW_MEMORY)
 static void frame_cache_cleanup(void *data);
@@ -80,7 +81,7 @@ enum frame_type {
 
 struct tris_smoother {
 	int size;
-	int format;
+	format_t format;
 	int flags;
 	float samplesperbyte;
 	unsigned int opt_needs_swap:1;
@@ -120,6 +121,7 @@ static const struct tris_format_list TRIS_FORMAT_LIST[] = {
 	{ TRIS_FORMAT_T140, "t140", 0, "Passthrough T.140 Realtime Text" },                                     /*!< Passthrough support for T.140 Realtime Text */
 	{ TRIS_FORMAT_SIREN7, "siren7", 16000, "ITU G.722.1 (Siren7, licensed from Polycom)", 80, 20, 80, 20, 20 },			/*!< Binary commercial distribution */
 	{ TRIS_FORMAT_SIREN14, "siren14", 32000, "ITU G.722.1 Annex C, (Siren14, licensed from Polycom)", 120, 20, 80, 20, 20 },	/*!< Binary commercial distribution */
+	{ TRIS_FORMAT_OPUS, "opus", 16000, "Opus", 60, 20, 60, 20, 20 },                                        /*!< codec_opus.c */
 };
 
 struct tris_frame tris_null_frame = { TRIS_FRAME_NULL, };
@@ -209,7 +211,8 @@ int __tris_smoother_feed(struct tris_smoother *s, struct tris_frame *f, int swap
 		s->format = f->subclass;
 		s->samplesperbyte = (float)f->samples / (float)f->datalen;
 	} else if (s->format != f->subclass) {
-		tris_log(LOG_WARNING, "Smoother was working on %d format frames, now trying to feed %d?\n", s->format, f->subclass);
+		tris_log(LOG_WARNING, "Smoother was working on %s format frames, now trying to feed %s?\n",
+			tris_getformatname(s->format), tris_getformatname(f->subclass));
 		return -1;
 	}
 	if (s->len + f->datalen > SMOOTHER_SIZE) {
@@ -572,7 +575,7 @@ const struct tris_format_list *tris_get_format_list(size_t *size)
 	return TRIS_FORMAT_LIST;
 }
 
-char* tris_getformatname(int format)
+char* tris_getformatname(format_t format)
 {
 	int x;
 	char *ret = "unknown";
@@ -585,7 +588,7 @@ char* tris_getformatname(int format)
 	return ret;
 }
 
-char *tris_getformatname_multiple(char *buf, size_t size, int format)
+char *tris_getformatname_multiple(char *buf, size_t size, format_t format)
 {
 	int x;
 	unsigned len;
@@ -593,7 +596,7 @@ char *tris_getformatname_multiple(char *buf, size_t size, int format)
 
 	if (!size)
 		return buf;
-	snprintf(end, size, "0x%x (", format);
+	snprintf(end, size, "0x%llx (", (unsigned long long) format);
 	len = strlen(end);
 	end += len;
 	size -= len;
@@ -635,9 +638,10 @@ static const char *tris_expand_codec_alias(const char *in)
 	return in;
 }
 
-int tris_getformatbyname(const char *name)
+format_t tris_getformatbyname(const char *name)
 {
-	int x, all, format = 0;
+	int x, all;
+	format_t format = 0;
 
 	all = strcasecmp(name, "all") ? 0 : 1;
 	for (x = 0; x < ARRAY_LEN(TRIS_FORMAT_LIST); x++) {
@@ -653,7 +657,7 @@ int tris_getformatbyname(const char *name)
 	return format;
 }
 
-char *tris_codec2str(int codec)
+char *tris_codec2str(format_t codec)
 {
 	int x;
 	char *ret = "unknown";
@@ -666,10 +670,25 @@ char *tris_codec2str(int codec)
 	return ret;
 }
 
-static char *show_codecs(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+/*! \brief list the known formats among the bits of mask */
+static void show_codec_bits(int fd, format_t mask, const char *type)
 {
-	int i, found=0;
+	int i;
 	char hex[25];
+	format_t bit;
+
+	for (i = 0; i < 64; i++) {
+		bit = 1ULL << i;
+		if (!(mask & bit) || !strcmp(tris_getformatname(bit), "unknown"))
+			continue;
+		snprintf(hex, sizeof(hex), "(0x%llx)", (unsigned long long) bit);
+		tris_cli(fd, "%20llu (1 << %2d) %18s  %-5s   %8s   (%s)\n", (unsigned long long) bit, i, hex, type, tris_getformatname(bit), tris_codec2str(bit));
+	}
+}
+
+static char *show_codecs(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+	int found=0;
 
 	switch (cmd) {
 	case CLI_INIT:
@@ -689,30 +708,21 @@ static char *show_codecs(struct tris_cli_entry *e, int cmd, struct tris_cli_args
 		tris_cli(a->fd, "Disclaimer: this command is for informational purposes only.\n"
 				"\tIt does not indicate anything about your configuration.\n");
 
-	tris_cli(a->fd, "%11s %9s %10s   TYPE   %8s   %s\n","INT","BINARY","HEX","NAME","DESC");
-	tris_cli(a->fd, "--------------------------------------------------------------------------------\n");
+	tris_cli(a->fd, "%20s %9s %18s  TYPE    %8s   %s\n","INT","BINARY","HEX","NAME","DESC");
+	tris_cli(a->fd, "------------------------------------------------------------------------------------------\n");
 	if ((a->argc == 3) || (!strcasecmp(a->argv[3],"audio"))) {
 		found = 1;
-		for (i=0;i<13;i++) {
-			snprintf(hex,25,"(0x%x)",1<<i);
-			tris_cli(a->fd, "%11u (1 << %2d) %10s  audio   %8s   (%s)\n",1 << i,i,hex,tris_getformatname(1<<i),tris_codec2str(1<<i));
-		}
+		show_codec_bits(a->fd, TRIS_FORMAT_AUDIO_MASK, "audio");
 	}
 
 	if ((a->argc == 3) || (!strcasecmp(a->argv[3],"image"))) {
 		found = 1;
-		for (i=16;i<18;i++) {
-			snprintf(hex,25,"(0x%x)",1<<i);
-			tris_cli(a->fd, "%11u (1 << %2d) %10s  image   %8s   (%s)\n",1 << i,i,hex,tris_getformatname(1<<i),tris_codec2str(1<<i));
-		}
+		show_codec_bits(a->fd, TRIS_FORMAT_JPEG | TRIS_FORMAT_PNG, "image");
 	}
 
 	if ((a->argc == 3) || (!strcasecmp(a->argv[3],"video"))) {
 		found = 1;
-		for (i=18;i<22;i++) {
-			snprintf(hex,25,"(0x%x)",1<<i);
-			tris_cli(a->fd, "%11u (1 << %2d) %10s  video   %8s   (%s)\n",1 << i,i,hex,tris_getformatname(1<<i),tris_codec2str(1<<i));
-		}
+		show_codec_bits(a->fd, TRIS_FORMAT_VIDEO_MASK & ~(TRIS_FORMAT_JPEG | TRIS_FORMAT_PNG), "video");
 	}
 
 	if (!found)
@@ -723,7 +733,8 @@ static char *show_codecs(struct tris_cli_entry *e, int cmd, struct tris_cli_args
 
 static char *show_codec_n(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
 {
-	int codec, i, found=0;
+	format_t codec;
+	int i, found=0;
 
 	switch (cmd) {
 	case CLI_INIT:
@@ -739,17 +750,17 @@ static char *show_codec_n(struct tris_cli_entry *e, int cmd, struct tris_cli_arg
 	if (a->argc != 4)
 		return CLI_SHOWUSAGE;
 
-	if (sscanf(a->argv[3], "%30d", &codec) != 1)
+	if (sscanf(a->argv[3], "%30" SCNi64, &codec) != 1)
 		return CLI_SHOWUSAGE;
 
-	for (i = 0; i < 32; i++)
-		if (codec & (1 << i)) {
+	for (i = 0; i < 64; i++)
+		if (codec & (1ULL << i)) {
 			found = 1;
-			tris_cli(a->fd, "%11u (1 << %2d)  %s\n",1 << i,i,tris_codec2str(1<<i));
+			tris_cli(a->fd, "%20llu (1 << %2d)  %s\n", 1ULL << i, i, tris_codec2str(1ULL << i));
 		}
 
 	if (!found)
-		tris_cli(a->fd, "Codec %d not found\n", codec);
+		tris_cli(a->fd, "Codec %" PRId64 " not found\n", codec);
 
 	return CLI_SUCCESS;
 }
@@ -881,7 +892,7 @@ void tris_frame_dump(const char *name, struct tris_frame *f, char *prefix)
 			strcpy(subclass, "Stop generators");
 			break;
 		default:
-			snprintf(subclass, sizeof(subclass), "Unknown control '%d'", f->subclass);
+			snprintf(subclass, sizeof(subclass), "Unknown control '%d'", (int) f->subclass);
 		}
 		break;
 	case TRIS_FRAME_NULL:
@@ -891,7 +902,7 @@ void tris_frame_dump(const char *name, struct tris_frame *f, char *prefix)
 	case TRIS_FRAME_IAX:
 		/* Should never happen */
 		strcpy(ftype, "IAX Specific");
-		snprintf(subclass, sizeof(subclass), "IAX Frametype %d", f->subclass);
+		snprintf(subclass, sizeof(subclass), "IAX Frametype %d", (int) f->subclass);
 		break;
 	case TRIS_FRAME_TEXT:
 		strcpy(ftype, "Text");
@@ -935,7 +946,7 @@ void tris_frame_dump(const char *name, struct tris_frame *f, char *prefix)
 			strcpy(subclass, "Link Reject");
 			break;
 		default:
-			snprintf(subclass, sizeof(subclass), "Unknown HTML frame '%d'\n", f->subclass);
+			snprintf(subclass, sizeof(subclass), "Unknown HTML frame '%d'\n", (int) f->subclass);
 			break;
 		}
 		break;
@@ -949,7 +960,7 @@ void tris_frame_dump(const char *name, struct tris_frame *f, char *prefix)
 			strcpy(subclass, "V.150");
 			break;
 		default:
-			snprintf(subclass, sizeof(subclass), "Unknown MODEM frame '%d'\n", f->subclass);
+			snprintf(subclass, sizeof(subclass), "Unknown MODEM frame '%d'\n", (int) f->subclass);
 			break;
 		}
 		break;
@@ -957,21 +968,21 @@ void tris_frame_dump(const char *name, struct tris_frame *f, char *prefix)
 		snprintf(ftype, sizeof(ftype), "Unknown Frametype '%d'", f->frametype);
 	}
 	if (!tris_strlen_zero(moreinfo))
-		tris_verbose("%s [ TYPE: %s (%d) SUBCLASS: %s (%d) '%s' ] [%s]\n",  
+		tris_verbose("%s [ TYPE: %s (%d) SUBCLASS: %s (%lld) '%s' ] [%s]\n",  
 			    term_color(cp, prefix, COLOR_BRMAGENTA, COLOR_BLACK, sizeof(cp)),
 			    term_color(cft, ftype, COLOR_BRRED, COLOR_BLACK, sizeof(cft)),
 			    f->frametype, 
 			    term_color(csub, subclass, COLOR_BRCYAN, COLOR_BLACK, sizeof(csub)),
-			    f->subclass, 
+			    (long long) f->subclass, 
 			    term_color(cmn, moreinfo, COLOR_BRGREEN, COLOR_BLACK, sizeof(cmn)),
 			    term_color(cn, name, COLOR_YELLOW, COLOR_BLACK, sizeof(cn)));
 	else
-		tris_verbose("%s [ TYPE: %s (%d) SUBCLASS: %s (%d) ] [%s]\n",  
+		tris_verbose("%s [ TYPE: %s (%d) SUBCLASS: %s (%lld) ] [%s]\n",  
 			    term_color(cp, prefix, COLOR_BRMAGENTA, COLOR_BLACK, sizeof(cp)),
 			    term_color(cft, ftype, COLOR_BRRED, COLOR_BLACK, sizeof(cft)),
 			    f->frametype, 
 			    term_color(csub, subclass, COLOR_BRCYAN, COLOR_BLACK, sizeof(csub)),
-			    f->subclass, 
+			    (long long) f->subclass, 
 			    term_color(cn, name, COLOR_YELLOW, COLOR_BLACK, sizeof(cn)));
 }
 
@@ -1000,11 +1011,11 @@ void tris_codec_pref_convert(struct tris_codec_pref *pref, char *buf, size_t siz
 	} else {
 		to = pref->order;
 		from = buf;
-		mem = 32;
+		mem = sizeof(pref->order);
 	}
 
 	memset(to, 0, mem);
-	for (x = 0; x < 32 ; x++) {
+	for (x = 0; x < sizeof(pref->order) && x < mem; x++) {
 		if (!from[x])
 			break;
 		to[x] = right ? (from[x] + differential) : (from[x] - differential);
@@ -1013,7 +1024,8 @@ void tris_codec_pref_convert(struct tris_codec_pref *pref, char *buf, size_t siz
 
 int tris_codec_pref_string(struct tris_codec_pref *pref, char *buf, size_t size) 
 {
-	int x, codec; 
+	int x;
+	format_t codec;
 	size_t total_len, slen;
 	char *formatname;
 	
@@ -1021,7 +1033,7 @@ int tris_codec_pref_string(struct tris_codec_pref *pref, char *buf, size_t size)
 	total_len = size;
 	buf[0] = '(';
 	total_len--;
-	for(x = 0; x < 32 ; x++) {
+	for(x = 0; x < sizeof(pref->order); x++) {
 		if (total_len <= 0)
 			break;
 		if (!(codec = tris_codec_pref_index(pref,x)))
@@ -1033,7 +1045,7 @@ int tris_codec_pref_string(struct tris_codec_pref *pref, char *buf, size_t size)
 			strncat(buf, formatname, total_len - 1); /* safe */
 			total_len -= slen;
 		}
-		if (total_len && x < 31 && tris_codec_pref_index(pref , x + 1)) {
+		if (total_len && x < sizeof(pref->order) - 1 && tris_codec_pref_index(pref , x + 1)) {
 			strncat(buf, "|", total_len - 1); /* safe */
 			total_len--;
 		}
@@ -1046,7 +1058,7 @@ int tris_codec_pref_string(struct tris_codec_pref *pref, char *buf, size_t size)
 	return size - total_len;
 }
 
-int tris_codec_pref_index(struct tris_codec_pref *pref, int idx)
+format_t tris_codec_pref_index(struct tris_codec_pref *pref, int idx)
 {
 	int slot = 0;
 
@@ -1058,7 +1070,7 @@ int tris_codec_pref_index(struct tris_codec_pref *pref, int idx)
 }
 
 /*! \brief Remove codec from pref list */
-void tris_codec_pref_remove(struct tris_codec_pref *pref, int format)
+void tris_codec_pref_remove(struct tris_codec_pref *pref, format_t format)
 {
 	struct tris_codec_pref oldorder;
 	int x, y = 0;
@@ -1085,7 +1097,7 @@ void tris_codec_pref_remove(struct tris_codec_pref *pref, int format)
 }
 
 /*! \brief Append codec to list */
-int tris_codec_pref_append(struct tris_codec_pref *pref, int format)
+int tris_codec_pref_append(struct tris_codec_pref *pref, format_t format)
 {
 	int x, newindex = 0;
 
@@ -1111,7 +1123,7 @@ int tris_codec_pref_append(struct tris_codec_pref *pref, int format)
 }
 
 /*! \brief Prepend codec to list */
-void tris_codec_pref_prepend(struct tris_codec_pref *pref, int format, int only_if_existing)
+void tris_codec_pref_prepend(struct tris_codec_pref *pref, format_t format, int only_if_existing)
 {
 	int x, newindex = 0;
 
@@ -1127,7 +1139,7 @@ void tris_codec_pref_prepend(struct tris_codec_pref *pref, int format, int only_
 		return;
 
 	/* Now find any existing occurrence, or the end */
-	for (x = 0; x < 32; x++) {
+	for (x = 0; x < sizeof(pref->order) - 1; x++) {
 		if (!pref->order[x] || pref->order[x] == newindex)
 			break;
 	}
@@ -1148,7 +1160,7 @@ void tris_codec_pref_prepend(struct tris_codec_pref *pref, int format, int only_
 }
 
 /*! \brief Set packet size for codec */
-int tris_codec_pref_setsize(struct tris_codec_pref *pref, int format, int framems)
+int tris_codec_pref_setsize(struct tris_codec_pref *pref, format_t format, int framems)
 {
 	int x, idx = -1;
 
@@ -1186,7 +1198,7 @@ int tris_codec_pref_setsize(struct tris_codec_pref *pref, int format, int framem
 }
 
 /*! \brief Get packet size for codec */
-struct tris_format_list tris_codec_pref_getsize(struct tris_codec_pref *pref, int format)
+struct tris_format_list tris_codec_pref_getsize(struct tris_codec_pref *pref, format_t format)
 {
 	int x, idx = -1, framems = 0;
 	struct tris_format_list fmt = { 0, };
@@ -1225,9 +1237,10 @@ struct tris_format_list tris_codec_pref_getsize(struct tris_codec_pref *pref, in
 }
 
 /*! \brief Pick a codec */
-int tris_codec_choose(struct tris_codec_pref *pref, int formats, int find_best)
+format_t tris_codec_choose(struct tris_codec_pref *pref, format_t formats, int find_best)
 {
-	int x, ret = 0, slot;
+	int x, slot;
+	format_t ret = 0;
 
 	for (x = 0; x < ARRAY_LEN(TRIS_FORMAT_LIST); x++) {
 		slot = pref->order[x];
@@ -1247,11 +1260,12 @@ int tris_codec_choose(struct tris_codec_pref *pref, int formats, int find_best)
    	return find_best ? tris_best_codec(formats) : 0;
 }
 
-int tris_parse_allow_disallow(struct tris_codec_pref *pref, int *mask, const char *list, int allowing) 
+int tris_parse_allow_disallow(struct tris_codec_pref *pref, format_t *mask, const char *list, int allowing) 
 {
 	int errors = 0;
 	char *parse = NULL, *this = NULL, *psize = NULL;
-	int format = 0, framems = 0;
+	format_t format = 0;
+	int framems = 0;
 
 	parse = tris_strdupa(list);
 	while ((this = strsep(&parse, ","))) {
@@ -1445,6 +1459,43 @@ static int speex_samples(unsigned char *data, int len)
 	return cnt;
 }
 
+/*! \brief Samples in an Opus packet at 16kHz, from its TOC byte (RFC 6716, section 3.1) */
+static int opus_samples(unsigned char *data, int len)
+{
+	/* Frame sizes at 48kHz: SILK only, hybrid, CELT only */
+	static const int silk[] = { 480, 960, 1920, 2880 };
+	static const int hybrid[] = { 480, 960 };
+	static const int celt[] = { 120, 240, 480, 960 };
+	int config, frames, size;
+
+	if (len < 1)
+		return 0;
+
+	config = data[0] >> 3;
+	if (config < 12)
+		size = silk[config & 0x3];
+	else if (config < 16)
+		size = hybrid[config & 0x1];
+	else
+		size = celt[config & 0x3];
+
+	switch (data[0] & 0x3) {
+	case 0:
+		frames = 1;
+		break;
+	case 1:
+	case 2:
+		frames = 2;
+		break;
+	default:
+		if (len < 2)
+			return 0;
+		frames = data[1] & 0x3f;
+	}
+
+	return frames * size / 3;
+}
+
 int tris_codec_get_samples(struct tris_frame *f)
 {
 	int samples = 0;
@@ -1495,13 +1546,16 @@ int tris_codec_get_samples(struct tris_frame *f)
 		/* 32,000 samples per second at 48kbps is 6,000 bytes per second */
 		samples = (int) f->datalen * ((float) 32000 / 6000);
 		break;
+	case TRIS_FORMAT_OPUS:
+		samples = opus_samples(f->data.ptr, f->datalen);
+		break;
 	default:
 		tris_log(LOG_WARNING, "Unable to calculate samples for format %s\n", tris_getformatname(f->subclass));
 	}
 	return samples;
 }
 
-int tris_codec_get_len(int format, int samples)
+int tris_codec_get_len(format_t format, int samples)
 {
 	int len = 0;
 
@@ -1550,32 +1604,16 @@ int tris_codec_get_len(int format, int samples)
 
 int tris_frame_adjust_volume(struct tris_frame *f, int adjustment)
 {
-	int count;
-	short *fdata = f->data.ptr;
-	short adjust_value = abs(adjustment);
-
 	if ((f->frametype != TRIS_FRAME_VOICE) || (f->subclass != TRIS_FORMAT_SLINEAR))
 		return -1;
 
-	if (!adjustment)
-		return 0;
-
-	for (count = 0; count < f->samples; count++) {
-		if (adjustment > 0) {
-			tris_slinear_saturated_multiply(&fdata[count], &adjust_value);
-		} else if (adjustment < 0) {
-			tris_slinear_saturated_divide(&fdata[count], &adjust_value);
-		}
-	}
+	tris_mix_gain(f->data.ptr, f->samples, adjustment);
 
 	return 0;
 }
 
 int tris_frame_slinear_sum(struct tris_frame *f1, struct tris_frame *f2)
 {
-	int count;
-	short *data1, *data2;
-
 	if ((f1->frametype != TRIS_FRAME_VOICE) || (f1->subclass != TRIS_FORMAT_SLINEAR))
 		return -1;
 
@@ -1585,10 +1623,7 @@ int tris_frame_slinear_sum(struct tris_frame *f1, struct tris_frame *f2)
 	if (f1->samples != f2->samples)
 		return -1;
 
-	for (count = 0, data1 = f1->data.ptr, data2 = f2->data.ptr;
-	     count < f1->samples;
-	     count++, data1++, data2++)
-		tris_slinear_saturated_add(data1, data2);
+	tris_mix_add(f1->data.ptr, f2->data.ptr, f1->samples);
 
 	return 0;
 }
@@ -123,8 +123,8 @@ struct tris_ftp {
 	unsigned int cycles;            /*!< Shifted count of sequence number cycles */
 	double rxjitter;                /*!< Interarrival jitter at the moment */
 	double rxtransit;               /*!< Relative transit time for previous packet */
-	int lasttxformat;
-	int lastrxformat;
+	format_t lasttxformat;
+	format_t lastrxformat;
 
 	int ftptimeout;			/*!< FTP timeout time (negative or zero means disabled, negative value means temporarily disabled) */
 	int ftpholdtimeout;		/*!< FTP timeout when on hold (negative or zero means disabled, negative value means temporarily disabled). */
@@ -204,7 +204,6 @@ static void timeval2ntp(struct timeval tv, unsigned int *msw, unsigned int *lsw)
 static int tris_ftcp_write_sr(const void *data);
 static int tris_ftcp_write_rr(const void *data);
 static unsigned int tris_ftcp_calc_interval(struct tris_ftp *ftp);
-static int tris_ftp_senddigit_continuation(struct tris_ftp *ftp);
 int tris_ftp_senddigit_end(struct tris_ftp *ftp, char digit);
 
 #define FLAG_3389_WARNING		(1 << 0)
@@ -728,7 +727,7 @@ int tris_ftcp_fd(struct tris_ftp *ftp)
 	return -1;
 }
 
-static int ftp_get_rate(int subclass)
+static int ftp_get_rate(format_t subclass)
 {
 	return (subclass == TRIS_FORMAT_G722) ? 8000 : tris_format_rate(subclass);
 }
@@ -869,31 +868,6 @@ static double stddev_compute(double stddev, double sample, double normdev, doubl
 #undef SQUARE
 }
 
-static struct tris_frame *send_dtmf(struct tris_ftp *ftp, enum tris_frame_type type)
-{
-	if (((tris_test_flag(ftp, FLAG_DTMF_COMPENSATE) && type == TRIS_FRAME_DTMF_END) ||
-	     (type == TRIS_FRAME_DTMF_BEGIN)) && tris_tvcmp(tris_tvnow(), ftp->dtmfmute) < 0) {
-		tris_debug(1, "Ignore potential DTMF echo from '%s'\n", tris_inet_ntoa(ftp->them.sin_addr));
-		ftp->resp = 0;
-		ftp->dtmfsamples = 0;
-		return &tris_null_frame;
-	}
-	tris_debug(1, "Sending dtmf: %d (%c), at %s\n", ftp->resp, ftp->resp, tris_inet_ntoa(ftp->them.sin_addr));
-	if (ftp->resp == 'X') {
-		ftp->f.frametype = TRIS_FRAME_CONTROL;
-		ftp->f.subclass = TRIS_CONTROL_FLASH;
-	} else {
-		ftp->f.frametype = type;
-		ftp->f.subclass = ftp->resp;
-	}
-	ftp->f.datalen = 0;
-	ftp->f.samples = 0;
-	ftp->f.mallocd = 0;
-	ftp->f.src = "FTP";
-	return &ftp->f;
-	
-}
-
 static inline int ftp_debug_test_addr(struct sockaddr_in *addr)
 {
 	if (ftpdebug == 0)
@@ -921,239 +895,6 @@ static inline int ftcp_debug_test_addr(struct sockaddr_in *addr)
 }
 
 
-static struct tris_frame *process_cisco_dtmf(struct tris_ftp *ftp, unsigned char *data, int len)
-{
-	unsigned int event;
-	char resp = 0;
-	struct tris_frame *f = NULL;
-	unsigned char seq;
-	unsigned int flags;
-	unsigned int power;
-
-	/* We should have at least 4 bytes in FTP data */
-	if (len < 4)
-		return f;
-
-	/*	The format of Cisco FTP DTMF packet looks like next:
-		+0				- sequence number of DTMF FTP packet (begins from 1,
-						  wrapped to 0)
-		+1				- set of flags
-		+1 (bit 0)		- flaps by different DTMF digits delimited by audio
-						  or repeated digit without audio???
-		+2 (+4,+6,...)	- power level? (rises from 0 to 32 at begin of tone
-						  then falls to 0 at its end)
-		+3 (+5,+7,...)	- detected DTMF digit (0..9,*,#,A-D,...)
-		Repeated DTMF information (bytes 4/5, 6/7) is history shifted right
-		by each new packet and thus provides some redudancy.
-		
-		Sample of Cisco FTP DTMF packet is (all data in hex):
-			19 07 00 02 12 02 20 02
-		showing end of DTMF digit '2'.
-
-		The packets
-			27 07 00 02 0A 02 20 02
-			28 06 20 02 00 02 0A 02
-		shows begin of new digit '2' with very short pause (20 ms) after
-		previous digit '2'. Bit +1.0 flips at begin of new digit.
-		
-		Cisco FTP DTMF packets comes as replacement of audio FTP packets
-		so its uses the same sequencing and timestamping rules as replaced
-		audio packets. Repeat interval of DTMF packets is 20 ms and not rely
-		on audio framing parameters. Marker bit isn't used within stream of
-		DTMFs nor audio stream coming immediately after DTMF stream. Timestamps
-		are not sequential at borders between DTMF and audio streams,
-	*/
-
-	seq = data[0];
-	flags = data[1];
-	power = data[2];
-	event = data[3] & 0x1f;
-
-	if (option_debug > 2 || ftpdebug)
-		tris_debug(0, "Cisco DTMF Digit: %02x (len=%d, seq=%d, flags=%02x, power=%d, history count=%d)\n", event, len, seq, flags, power, (len - 4) / 2);
-	if (event < 10) {
-		resp = '0' + event;
-	} else if (event < 11) {
-		resp = '*';
-	} else if (event < 12) {
-		resp = '#';
-	} else if (event < 16) {
-		resp = 'A' + (event - 12);
-	} else if (event < 17) {
-		resp = 'X';
-	}
-	if ((!ftp->resp && power) || (ftp->resp && (ftp->resp != resp))) {
-		ftp->resp = resp;
-		/* Why we should care on DTMF compensation at reception? */
-		if (!tris_test_flag(ftp, FLAG_DTMF_COMPENSATE)) {
-			f = send_dtmf(ftp, TRIS_FRAME_DTMF_BEGIN);
-			ftp->dtmfsamples = 0;
-		}
-	} else if ((ftp->resp == resp) && !power) {
-		f = send_dtmf(ftp, TRIS_FRAME_DTMF_END);
-		f->samples = ftp->dtmfsamples * (ftp_get_rate(f->subclass) / 1000);
-		ftp->resp = 0;
-	} else if (ftp->resp == resp)
-		ftp->dtmfsamples += 20 * (ftp_get_rate(f->subclass) / 1000);
-	ftp->dtmf_timeout = dtmftimeout;
-	return f;
-}
-
-/*! 
- * \brief Process FTP DTMF and events according to RFC 2833.
- * 
- * RFC 2833 is "FTP Payload for DTMF Digits, Telephony Tones and Telephony Signals".
- * 
- * \param ftp
- * \param data
- * \param len
- * \param seqno
- * \param timestamp
- * \returns
- */
-static struct tris_frame *process_rfc2833(struct tris_ftp *ftp, unsigned char *data, int len, unsigned int seqno, unsigned int timestamp)
-{
-	unsigned int event;
-	unsigned int event_end;
-	unsigned int samples;
-	char resp = 0;
-	struct tris_frame *f = NULL;
-
-	/* Figure out event, event end, and samples */
-	event = ntohl(*((unsigned int *)(data)));
-	event >>= 24;
-	event_end = ntohl(*((unsigned int *)(data)));
-	event_end <<= 8;
-	event_end >>= 24;
-	samples = ntohl(*((unsigned int *)(data)));
-	samples &= 0xFFFF;
-
-	/* Print out debug if turned on */
-	if (ftpdebug || option_debug > 2)
-		tris_debug(0, "- FTP 2833 Event: %08x (len = %d)\n", event, len);
-
-	/* Figure out what digit was pressed */
-	if (event < 10) {
-		resp = '0' + event;
-	} else if (event < 11) {
-		resp = '*';
-	} else if (event < 12) {
-		resp = '#';
-	} else if (event < 16) {
-		resp = 'A' + (event - 12);
-	} else if (event < 17) {	/* Event 16: Hook flash */
-		resp = 'X';	
-	} else {
-		/* Not a supported event */
-		tris_log(LOG_DEBUG, "Ignoring FTP 2833 Event: %08x. Not a DTMF Digit.\n", event);
-		return &tris_null_frame;
-	}
-
-	if (tris_test_flag(ftp, FLAG_DTMF_COMPENSATE)) {
-		if ((ftp->lastevent != timestamp) || (ftp->resp && ftp->resp != resp)) {
-			ftp->resp = resp;
-			ftp->dtmf_timeout = 0;
-			f = send_dtmf(ftp, TRIS_FRAME_DTMF_END);
-			f->len = 0;
-			ftp->lastevent = timestamp;
-		}
-	} else {
-		/*  The duration parameter measures the complete
-		    duration of the event (from the beginning) - RFC2833.
-		    Account for the fact that duration is only 16 bits long
-		    (about 8 seconds at 8000 Hz) and can wrap is digit
-		    is hold for too long. */
-		unsigned int new_duration = ftp->dtmf_duration;
-		unsigned int last_duration = new_duration & 0xFFFF;
-
-		if (last_duration > 64000 && samples < last_duration)
-			new_duration += 0xFFFF + 1;
-		new_duration = (new_duration & ~0xFFFF) | samples;
-
-		if (event_end & 0x80) {
-			/* End event */
-			if ((ftp->lastevent != seqno) && ftp->resp) {
-				ftp->dtmf_duration = new_duration;
-				f = send_dtmf(ftp, TRIS_FRAME_DTMF_END);
-				f->len = tris_tvdiff_ms(tris_samp2tv(ftp->dtmf_duration, ftp_get_rate(f->subclass)), tris_tv(0, 0));
-				ftp->resp = 0;
-				ftp->dtmf_duration = ftp->dtmf_timeout = 0;
-			}
-		} else {
-			/* Begin/continuation */
-
-			if (ftp->resp && ftp->resp != resp) {
-				/* Another digit already began. End it */
-				f = send_dtmf(ftp, TRIS_FRAME_DTMF_END);
-				f->len = tris_tvdiff_ms(tris_samp2tv(ftp->dtmf_duration, ftp_get_rate(f->subclass)), tris_tv(0, 0));
-				ftp->resp = 0;
-				ftp->dtmf_duration = ftp->dtmf_timeout = 0;
-			}
-
-
-			if (ftp->resp) {
-				/* Digit continues */
-				ftp->dtmf_duration = new_duration;
-			} else {
-				/* New digit began */
-				ftp->resp = resp;
-				f = send_dtmf(ftp, TRIS_FRAME_DTMF_BEGIN);
-				ftp->dtmf_duration = samples;
-			}
-
-			ftp->dtmf_timeout = timestamp + ftp->dtmf_duration + dtmftimeout;
-		}
-
-		ftp->lastevent = seqno;
-	}
-
-	ftp->dtmfsamples = samples;
-
-	return f;
-}
-
-/*!
- * \brief Process Comfort Noise FTP.
- * 
- * This is incomplete at the moment.
- * 
-*/
-static struct tris_frame *process_rfc3389(struct tris_ftp *ftp, unsigned char *data, int len)
-{
-	struct tris_frame *f = NULL;
-	/* Convert comfort noise into audio with various codecs.  Unfortunately this doesn't
-	   totally help us out becuase we don't have an engine to keep it going and we are not
-	   guaranteed to have it every 20ms or anything */
-	if (ftpdebug)
-		tris_debug(0, "- FTP 3389 Comfort noise event: Level %d (len = %d)\n", ftp->lastrxformat, len);
-
-	if (!(tris_test_flag(ftp, FLAG_3389_WARNING))) {
-		tris_log(LOG_NOTICE, "Comfort noise support incomplete in Trismedia (RFC 3389). Please turn off on client if possible. Client IP: %s\n",
-			tris_inet_ntoa(ftp->them.sin_addr));
-		tris_set_flag(ftp, FLAG_3389_WARNING);
-	}
-	
-	/* Must have at least one byte */
-	if (!len)
-		return NULL;
-	if (len < 24) {
-		ftp->f.data.ptr = ftp->rawdata + TRIS_FRIENDLY_OFFSET;
-		ftp->f.datalen = len - 1;
-		ftp->f.offset = TRIS_FRIENDLY_OFFSET;
-		memcpy(ftp->f.data.ptr, data + 1, len - 1);
-	} else {
-		ftp->f.data.ptr = NULL;
-		ftp->f.offset = 0;
-		ftp->f.datalen = 0;
-	}
-	ftp->f.frametype = TRIS_FRAME_CNG;
-	ftp->f.subclass = data[0] & 0x7f;
-	ftp->f.samples = 0;
-	ftp->f.delivery.tv_usec = ftp->f.delivery.tv_sec = 0;
-	f = &ftp->f;
-	return f;
-}
-
 static int ftpread(int *id, int fd, short events, void *cbdata)
 {
 	struct tris_ftp *ftp = cbdata;
@@ -1451,456 +1192,6 @@ struct tris_frame *tris_ftcp_read(struct tris_ftp *ftp)
 	return f;
 }
 
-static void calc_rxstamp(struct timeval *when, struct tris_ftp *ftp, unsigned int timestamp, int mark)
-{
-	struct timeval now;
-	struct timeval tmp;
-	double transit;
-	double current_time;
-	double d;
-	double dtv;
-	double prog;
-	double normdev_rxjitter_current;
-	int rate = ftp_get_rate(ftp->f.subclass);
-
-	if ((!ftp->rxcore.tv_sec && !ftp->rxcore.tv_usec) || mark) {
-		gettimeofday(&ftp->rxcore, NULL);
-		ftp->drxcore = (double) ftp->rxcore.tv_sec + (double) ftp->rxcore.tv_usec / 1000000;
-		/* map timestamp to a real time */
-		ftp->seedrxts = timestamp; /* Their FTP timestamp started with this */
-		tmp = tris_samp2tv(timestamp, rate);
-		ftp->rxcore = tris_tvsub(ftp->rxcore, tmp);
-		/* Round to 0.1ms for nice, pretty timestamps */
-		ftp->rxcore.tv_usec -= ftp->rxcore.tv_usec % 100;
-	}
-
-	gettimeofday(&now,NULL);
-	/* rxcore is the mapping between the FTP timestamp and _our_ real time from gettimeofday() */
-	tmp = tris_samp2tv(timestamp, rate);
-	*when = tris_tvadd(ftp->rxcore, tmp);
-
-	prog = (double)((timestamp-ftp->seedrxts)/(float)(rate));
-	dtv = (double)ftp->drxcore + (double)(prog);
-	current_time = (double)now.tv_sec + (double)now.tv_usec/1000000;
-	transit = current_time - dtv;
-	d = transit - ftp->rxtransit;
-	ftp->rxtransit = transit;
-	if (d<0)
-		d=-d;
-	ftp->rxjitter += (1./16.) * (d - ftp->rxjitter);
-
-	if (ftp->ftcp) {
-		if (ftp->rxjitter > ftp->ftcp->maxrxjitter)
-			ftp->ftcp->maxrxjitter = ftp->rxjitter;
-		if (ftp->ftcp->rxjitter_count == 1) 
-			ftp->ftcp->minrxjitter = ftp->rxjitter;
-		if (ftp->rxjitter < ftp->ftcp->minrxjitter)
-			ftp->ftcp->minrxjitter = ftp->rxjitter;
-			
-		normdev_rxjitter_current = normdev_compute(ftp->ftcp->normdev_rxjitter,ftp->rxjitter,ftp->ftcp->rxjitter_count);
-		ftp->ftcp->stdev_rxjitter = stddev_compute(ftp->ftcp->stdev_rxjitter,ftp->rxjitter,ftp->ftcp->normdev_rxjitter,normdev_rxjitter_current,ftp->ftcp->rxjitter_count);
-
-		ftp->ftcp->normdev_rxjitter = normdev_rxjitter_current;
-		ftp->ftcp->rxjitter_count++;
-	}
-}
-
-/*! \brief Perform a Packet2Packet FTP write */
-static int bridge_p2p_ftp_write(struct tris_ftp *ftp, struct tris_ftp *bridged, unsigned int *ftpheader, int len, int hdrlen)
-{
-	int res = 0, payload = 0, bridged_payload = 0, mark;
-	struct ftpPayloadType ftpPT;
-	int reconstruct = ntohl(ftpheader[0]);
-
-	/* Get fields from packet */
-	payload = (reconstruct & 0x7f0000) >> 16;
-	mark = (((reconstruct & 0x800000) >> 23) != 0);
-
-	/* Check what the payload value should be */
-	ftpPT = tris_ftp_lookup_pt(ftp, payload);
-
-	/* If the payload is DTMF, and we are listening for DTMF - then feed it into the core */
-	if (tris_test_flag(ftp, FLAG_P2P_NEED_DTMF) && !ftpPT.isAstFormat && ftpPT.code == TRIS_FTP_DTMF)
-		return -1;
-
-	/* Otherwise adjust bridged payload to match */
-	bridged_payload = tris_ftp_lookup_code(bridged, ftpPT.isAstFormat, ftpPT.code);
-
-	/* If the payload coming in is not one of the negotiated ones then send it to the core, this will cause formats to change and the bridge to break */
-	if (!bridged->current_FTP_PT[bridged_payload].code)
-		return -1;
-
-
-	/* If the mark bit has not been sent yet... do it now */
-	if (!tris_test_flag(ftp, FLAG_P2P_SENT_MARK)) {
-		mark = 1;
-		tris_set_flag(ftp, FLAG_P2P_SENT_MARK);
-	}
-
-	/* Reconstruct part of the packet */
-	reconstruct &= 0xFF80FFFF;
-	reconstruct |= (bridged_payload << 16);
-	reconstruct |= (mark << 23);
-	ftpheader[0] = htonl(reconstruct);
-
-	/* Send the packet back out */
-	res = sendto(bridged->s, (void *)ftpheader, len, 0, (struct sockaddr *)&bridged->them, sizeof(bridged->them));
-	if (res < 0) {
-		if (!bridged->nat || (bridged->nat && (tris_test_flag(bridged, FLAG_NAT_ACTIVE) == FLAG_NAT_ACTIVE))) {
-			tris_debug(1, "FTP Transmission error of packet to %s:%d: %s\n", tris_inet_ntoa(bridged->them.sin_addr), ntohs(bridged->them.sin_port), strerror(errno));
-		} else if (((tris_test_flag(bridged, FLAG_NAT_ACTIVE) == FLAG_NAT_INACTIVE) || ftpdebug) && !tris_test_flag(bridged, FLAG_NAT_INACTIVE_NOWARN)) {
-			if (option_debug || ftpdebug)
-				tris_debug(0, "FTP NAT: Can't write FTP to private address %s:%d, waiting for other end to send audio...\n", tris_inet_ntoa(bridged->them.sin_addr), ntohs(bridged->them.sin_port));
-			tris_set_flag(bridged, FLAG_NAT_INACTIVE_NOWARN);
-		}
-		return 0;
-	} else if (ftp_debug_test_addr(&bridged->them))
-			tris_verbose("Sent FTP P2P packet to %s:%u (type %-2.2d, len %-6.6u)\n", tris_inet_ntoa(bridged->them.sin_addr), ntohs(bridged->them.sin_port), bridged_payload, len - hdrlen);
-
-	return 0;
-}
-
-struct tris_frame *tris_ftp_read_orig(struct tris_ftp *ftp)
-{
-	int res;
-	struct sockaddr_in sock_in;
-	socklen_t len;
-	unsigned int seqno;
-	int version;
-	int payloadtype;
-	int hdrlen = 12;
-	int padding;
-	int mark;
-	int ext;
-	int cc;
-	unsigned int ssrc;
-	unsigned int timestamp;
-	unsigned int *ftpheader;
-	struct ftpPayloadType ftpPT;
-	struct tris_ftp *bridged = NULL;
-	int prev_seqno;
-	
-	/* If time is up, kill it */
-	if (ftp->sending_digit)
-		tris_ftp_senddigit_continuation(ftp);
-
-	len = sizeof(sock_in);
-	
-	/* Cache where the header will go */
-	res = recvfrom(ftp->s, ftp->rawdata + TRIS_FRIENDLY_OFFSET, sizeof(ftp->rawdata) - TRIS_FRIENDLY_OFFSET,
-					0, (struct sockaddr *)&sock_in, &len);
-
-	/* If strict FTP protection is enabled see if we need to learn this address or if the packet should be dropped */
-	if (ftp->strict_ftp_state == STRICT_FTP_LEARN) {
-		/* Copy over address that this packet was received on */
-		memcpy(&ftp->strict_ftp_address, &sock_in, sizeof(ftp->strict_ftp_address));
-		/* Now move over to actually protecting the FTP port */
-		ftp->strict_ftp_state = STRICT_FTP_CLOSED;
-		tris_debug(1, "Learned remote address is %s:%d for strict FTP purposes, now protecting the port.\n", tris_inet_ntoa(ftp->strict_ftp_address.sin_addr), ntohs(ftp->strict_ftp_address.sin_port));
-	} else if (ftp->strict_ftp_state == STRICT_FTP_CLOSED) {
-		/* If the address we previously learned doesn't match the address this packet came in on simply drop it */
-		if ((ftp->strict_ftp_address.sin_addr.s_addr != sock_in.sin_addr.s_addr) || (ftp->strict_ftp_address.sin_port != sock_in.sin_port)) {
-			tris_debug(1, "Received FTP packet from %s:%d, dropping due to strict FTP protection. Expected it to be from %s:%d\n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), tris_inet_ntoa(ftp->strict_ftp_address.sin_addr), ntohs(ftp->strict_ftp_address.sin_port));
-			return &tris_null_frame;
-		}
-	}
-
-	ftpheader = (unsigned int *)(ftp->rawdata + TRIS_FRIENDLY_OFFSET);
-	if (res < 0) {
-		tris_assert(errno != EBADF);
-		if (errno != EAGAIN) {
-			tris_log(LOG_WARNING, "FTP Read error: %s.  Hanging up.\n", strerror(errno));
-			return NULL;
-		}
-		return &tris_null_frame;
-	}
-	
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "FTP Read too short\n");
-		return &tris_null_frame;
-	}
-
-	/* Get fields */
-	seqno = ntohl(ftpheader[0]);
-
-	/* Check FTP version */
-	version = (seqno & 0xC0000000) >> 30;
-	if (!version) {
-		/* If the two high bits are 0, this might be a
-		 * STUN message, so process it. stun_handle_packet()
-		 * answers to requests, and it returns STUN_ACCEPT
-		 * if the request is valid.
-		 */
-		if ((stun_handle_packet(ftp->s, &sock_in, ftp->rawdata + TRIS_FRIENDLY_OFFSET, res, NULL, NULL) == STUN_ACCEPT) &&
-			(!ftp->them.sin_port && !ftp->them.sin_addr.s_addr)) {
-			memcpy(&ftp->them, &sock_in, sizeof(ftp->them));
-		}
-		return &tris_null_frame;
-	}
-
-#if 0	/* Allow to receive FTP stream with closed transmission path */
-	/* If we don't have the other side's address, then ignore this */
-	if (!ftp->them.sin_addr.s_addr || !ftp->them.sin_port)
-		return &tris_null_frame;
-#endif
-
-	/* Send to whoever send to us if NAT is turned on */
-	if (ftp->nat) {
-		if (((ftp->them.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (ftp->them.sin_port != sock_in.sin_port)) && 
-		    ((ftp->altthem.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (ftp->altthem.sin_port != sock_in.sin_port))) {
-			ftp->them = sock_in;
-			if (ftp->ftcp) {
-				int h = 0;
-				memcpy(&ftp->ftcp->them, &sock_in, sizeof(ftp->ftcp->them));
-				h = ntohs(ftp->them.sin_port);
-				ftp->ftcp->them.sin_port = htons(h + 1);
-			}
-			ftp->rxseqno = 0;
-			tris_set_flag(ftp, FLAG_NAT_ACTIVE);
-			if (option_debug || ftpdebug)
-				tris_debug(0, "FTP NAT: Got audio from other end. Now sending to address %s:%d\n", tris_inet_ntoa(ftp->them.sin_addr), ntohs(ftp->them.sin_port));
-		}
-	}
-
-	/* If we are bridged to another FTP stream, send direct */
-	if ((bridged = tris_ftp_get_bridged(ftp)) && !bridge_p2p_ftp_write(ftp, bridged, ftpheader, res, hdrlen))
-		return &tris_null_frame;
-
-	if (version != 2)
-		return &tris_null_frame;
-
-	payloadtype = (seqno & 0x7f0000) >> 16;
-	padding = seqno & (1 << 29);
-	mark = seqno & (1 << 23);
-	ext = seqno & (1 << 28);
-	cc = (seqno & 0xF000000) >> 24;
-	seqno &= 0xffff;
-	timestamp = ntohl(ftpheader[1]);
-	ssrc = ntohl(ftpheader[2]);
-	
-	if (!mark && ftp->rxssrc && ftp->rxssrc != ssrc) {
-		if (option_debug || ftpdebug)
-			tris_debug(0, "Forcing Marker bit, because SSRC has changed\n");
-		mark = 1;
-	}
-
-	ftp->rxssrc = ssrc;
-	
-	if (padding) {
-		/* Remove padding bytes */
-		res -= ftp->rawdata[TRIS_FRIENDLY_OFFSET + res - 1];
-	}
-	
-	if (cc) {
-		/* CSRC fields present */
-		hdrlen += cc*4;
-	}
-
-	if (ext) {
-		/* FTP Extension present */
-		hdrlen += (ntohl(ftpheader[hdrlen/4]) & 0xffff) << 2;
-		hdrlen += 4;
-		if (option_debug) {
-			int profile;
-			profile = (ntohl(ftpheader[3]) & 0xffff0000) >> 16;
-			if (profile == 0x505a)
-				tris_debug(1, "Found Zfone extension in FTP stream - zftp - not supported.\n");
-			else
-				tris_debug(1, "Found unknown FTP Extensions %x\n", profile);
-		}
-	}
-
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "FTP Read too short (%d, expecting %d)\n", res, hdrlen);
-		return &tris_null_frame;
-	}
-
-	ftp->rxcount++; /* Only count reasonably valid packets, this'll make the ftcp stats more accurate */
-
-	if (ftp->rxcount==1) {
-		/* This is the first FTP packet successfully received from source */
-		ftp->seedrxseqno = seqno;
-	}
-
-	/* Do not schedule RR if FTCP isn't run */
-	if (ftp->ftcp && ftp->ftcp->them.sin_addr.s_addr && ftp->ftcp->schedid < 1) {
-		/* Schedule transmission of Receiver Report */
-		ftp->ftcp->schedid = tris_sched_add(ftp->sched, tris_ftcp_calc_interval(ftp), tris_ftcp_write, ftp);
-	}
-	if ((int)ftp->lastrxseqno - (int)seqno  > 100) /* if so it would indicate that the sender cycled; allow for misordering */
-		ftp->cycles += FTP_SEQ_MOD;
-	
-	prev_seqno = ftp->lastrxseqno;
-
-	ftp->lastrxseqno = seqno;
-	
-	if (!ftp->themssrc)
-		ftp->themssrc = ntohl(ftpheader[2]); /* Record their SSRC to put in future RR */
-	
-	if (ftp_debug_test_addr(&sock_in))
-		tris_verbose("Got  FTP packet from    %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-			tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp,res - hdrlen);
-
-	ftpPT = tris_ftp_lookup_pt(ftp, payloadtype);
-	if (!ftpPT.isAstFormat) {
-		struct tris_frame *f = NULL;
-
-		/* This is special in-band data that's not one of our codecs */
-		if (ftpPT.code == TRIS_FTP_DTMF) {
-			/* It's special -- rfc2833 process it */
-			if (ftp_debug_test_addr(&sock_in)) {
-				unsigned char *data;
-				unsigned int event;
-				unsigned int event_end;
-				unsigned int duration;
-				data = ftp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen;
-				event = ntohl(*((unsigned int *)(data)));
-				event >>= 24;
-				event_end = ntohl(*((unsigned int *)(data)));
-				event_end <<= 8;
-				event_end >>= 24;
-				duration = ntohl(*((unsigned int *)(data)));
-				duration &= 0xFFFF;
-				tris_verbose("Got  FTP RFC2833 from   %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u, mark %d, event %08x, end %d, duration %-5.5d) \n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp, res - hdrlen, (mark?1:0), event, ((event_end & 0x80)?1:0), duration);
-			}
-			f = process_rfc2833(ftp, ftp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen, seqno, timestamp);
-		} else if (ftpPT.code == TRIS_FTP_CISCO_DTMF) {
-			/* It's really special -- process it the Cisco way */
-			if (ftp->lastevent <= seqno || (ftp->lastevent >= 65530 && seqno <= 6)) {
-				f = process_cisco_dtmf(ftp, ftp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-				ftp->lastevent = seqno;
-			}
-		} else if (ftpPT.code == TRIS_FTP_CN) {
-			/* Comfort Noise */
-			f = process_rfc3389(ftp, ftp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-		} else {
-			tris_log(LOG_NOTICE, "Unknown FTP codec %d received from '%s'\n", payloadtype, tris_inet_ntoa(ftp->them.sin_addr));
-		}
-		return f ? f : &tris_null_frame;
-	}
-	ftp->lastrxformat = ftp->f.subclass = ftpPT.code;
-	ftp->f.frametype = (ftp->f.subclass & TRIS_FORMAT_AUDIO_MASK) ? TRIS_FRAME_VOICE : (ftp->f.subclass & TRIS_FORMAT_VIDEO_MASK) ? TRIS_FRAME_VIDEO : TRIS_FRAME_TEXT;
-
-	ftp->rxseqno = seqno;
-
-	if (ftp->dtmf_timeout && ftp->dtmf_timeout < timestamp) {
-		ftp->dtmf_timeout = 0;
-
-		if (ftp->resp) {
-			struct tris_frame *f;
-			f = send_dtmf(ftp, TRIS_FRAME_DTMF_END);
-			f->len = tris_tvdiff_ms(tris_samp2tv(ftp->dtmf_duration, ftp_get_rate(f->subclass)), tris_tv(0, 0));
-			ftp->resp = 0;
-			ftp->dtmf_timeout = ftp->dtmf_duration = 0;
-			return f;
-		}
-	}
-
-	/* Record received timestamp as last received now */
-	ftp->lastrxts = timestamp;
-
-	ftp->f.mallocd = 0;
-	ftp->f.datalen = res - hdrlen;
-	ftp->f.data.ptr = ftp->rawdata + hdrlen + TRIS_FRIENDLY_OFFSET;
-	ftp->f.offset = hdrlen + TRIS_FRIENDLY_OFFSET;
-	ftp->f.seqno = seqno;
-
-	if (ftp->f.subclass == TRIS_FORMAT_T140 && (int)seqno - (prev_seqno+1) > 0 && (int)seqno - (prev_seqno+1) < 10) {
-		  unsigned char *data = ftp->f.data.ptr;
-		  
-		  memmove(ftp->f.data.ptr+3, ftp->f.data.ptr, ftp->f.datalen);
-		  ftp->f.datalen +=3;
-		  *data++ = 0xEF;
-		  *data++ = 0xBF;
-		  *data = 0xBD;
-	}
- 
-	if (ftp->f.subclass == TRIS_FORMAT_T140RED) {
-		unsigned char *data = ftp->f.data.ptr;
-		unsigned char *header_end;
-		int num_generations;
-		int header_length;
-		int length;
-		int diff =(int)seqno - (prev_seqno+1); /* if diff = 0, no drop*/
-		int x;
-
-		ftp->f.subclass = TRIS_FORMAT_T140;
-		header_end = memchr(data, ((*data) & 0x7f), ftp->f.datalen);
-		if (header_end == NULL) {
-			return &tris_null_frame;
-		}
-		header_end++;
-		
-		header_length = header_end - data;
-		num_generations = header_length / 4;
-		length = header_length;
-
-		if (!diff) {
-			for (x = 0; x < num_generations; x++)
-				length += data[x * 4 + 3];
-			
-			if (!(ftp->f.datalen - length))
-				return &tris_null_frame;
-			
-			ftp->f.data.ptr += length;
-			ftp->f.datalen -= length;
-		} else if (diff > num_generations && diff < 10) {
-			length -= 3;
-			ftp->f.data.ptr += length;
-			ftp->f.datalen -= length;
-			
-			data = ftp->f.data.ptr;
-			*data++ = 0xEF;
-			*data++ = 0xBF;
-			*data = 0xBD;
-		} else 	{
-			for ( x = 0; x < num_generations - diff; x++) 
-				length += data[x * 4 + 3];
-			
-			ftp->f.data.ptr += length;
-			ftp->f.datalen -= length;
-		}
-	}
-
-	if (ftp->f.subclass & TRIS_FORMAT_AUDIO_MASK) {
-		ftp->f.samples = tris_codec_get_samples(&ftp->f);
-		if (ftp->f.subclass == TRIS_FORMAT_SLINEAR) 
-			tris_frame_byteswap_be(&ftp->f);
-		calc_rxstamp(&ftp->f.delivery, ftp, timestamp, mark);
-		/* Add timing data to let tris_generic_bridge() put the frame into a jitterbuf */
-		tris_set_flag(&ftp->f, TRIS_FRFLAG_HAS_TIMING_INFO);
-		ftp->f.ts = timestamp / (ftp_get_rate(ftp->f.subclass) / 1000);
-		ftp->f.len = ftp->f.samples / ((tris_format_rate(ftp->f.subclass) / 1000));
-	} else if (ftp->f.subclass & TRIS_FORMAT_VIDEO_MASK) {
-		/* Video -- samples is # of samples vs. 90000 */
-		if (!ftp->lastividtimestamp)
-			ftp->lastividtimestamp = timestamp;
-		ftp->f.samples = timestamp - ftp->lastividtimestamp;
-		ftp->lastividtimestamp = timestamp;
-		ftp->f.delivery.tv_sec = 0;
-		ftp->f.delivery.tv_usec = 0;
-		/* Pass the FTP marker bit as bit 0 in the subclass field.
-		 * This is ok because subclass is actually a bitmask, and
-		 * the low bits represent audio formats, that are not
-		 * involved here since we deal with video.
-		 */
-		if (mark)
-			ftp->f.subclass |= 0x1;
-	} else {
-		/* TEXT -- samples is # of samples vs. 1000 */
-		if (!ftp->lastitexttimestamp)
-			ftp->lastitexttimestamp = timestamp;
-		ftp->f.samples = timestamp - ftp->lastitexttimestamp;
-		ftp->lastitexttimestamp = timestamp;
-		ftp->f.delivery.tv_sec = 0;
-		ftp->f.delivery.tv_usec = 0;
-	}
-	ftp->f.src = "FTP";
-	return &ftp->f;
-}
-
 struct tris_frame *tris_ftp_read(struct tris_ftp *ftp)
 {
 	int res;
@@ -1919,321 +1210,6 @@ struct tris_frame *tris_ftp_read(struct tris_ftp *ftp)
 	ftp->f.data.ptr = ftp->rawdata + TRIS_FRIENDLY_OFFSET;
 	ftp->f.offset = TRIS_FRIENDLY_OFFSET;
 	return &ftp->f;
-
-#if 0	
-	res = recvfrom(ftp->s, ftp->rawdata + TRIS_FRIENDLY_OFFSET, sizeof(ftp->rawdata) - TRIS_FRIENDLY_OFFSET,
-					0, (struct sockaddr *)&sock_in, &len);
-
-	/* If strict FTP protection is enabled see if we need to learn this address or if the packet should be dropped */
-	if (ftp->strict_ftp_state == STRICT_FTP_LEARN) {
-		/* Copy over address that this packet was received on */
-		memcpy(&ftp->strict_ftp_address, &sock_in, sizeof(ftp->strict_ftp_address));
-		/* Now move over to actually protecting the FTP port */
-		ftp->strict_ftp_state = STRICT_FTP_CLOSED;
-		tris_debug(1, "Learned remote address is %s:%d for strict FTP purposes, now protecting the port.\n", tris_inet_ntoa(ftp->strict_ftp_address.sin_addr), ntohs(ftp->strict_ftp_address.sin_port));
-	} else if (ftp->strict_ftp_state == STRICT_FTP_CLOSED) {
-		/* If the address we previously learned doesn't match the address this packet came in on simply drop it */
-		if ((ftp->strict_ftp_address.sin_addr.s_addr != sock_in.sin_addr.s_addr) || (ftp->strict_ftp_address.sin_port != sock_in.sin_port)) {
-			tris_debug(1, "Received FTP packet from %s:%d, dropping due to strict FTP protection. Expected it to be from %s:%d\n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), tris_inet_ntoa(ftp->strict_ftp_address.sin_addr), ntohs(ftp->strict_ftp_address.sin_port));
-			return &tris_null_frame;
-		}
-	}
-
-	ftpheader = (unsigned int *)(ftp->rawdata + TRIS_FRIENDLY_OFFSET);
-	if (res < 0) {
-		tris_assert(errno != EBADF);
-		if (errno != EAGAIN) {
-			tris_log(LOG_WARNING, "FTP Read error: %s.  Hanging up.\n", strerror(errno));
-			return NULL;
-		}
-		return &tris_null_frame;
-	}
-	
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "FTP Read too short\n");
-		return &tris_null_frame;
-	}
-
-	/* Get fields */
-	seqno = ntohl(ftpheader[0]);
-
-	/* Check FTP version */
-	version = (seqno & 0xC0000000) >> 30;
-	if (!version) {
-		/* If the two high bits are 0, this might be a
-		 * STUN message, so process it. stun_handle_packet()
-		 * answers to requests, and it returns STUN_ACCEPT
-		 * if the request is valid.
-		 */
-		if ((stun_handle_packet(ftp->s, &sock_in, ftp->rawdata + TRIS_FRIENDLY_OFFSET, res, NULL, NULL) == STUN_ACCEPT) &&
-			(!ftp->them.sin_port && !ftp->them.sin_addr.s_addr)) {
-			memcpy(&ftp->them, &sock_in, sizeof(ftp->them));
-		}
-		return &tris_null_frame;
-	}
-
-#if 0	/* Allow to receive FTP stream with closed transmission path */
-	/* If we don't have the other side's address, then ignore this */
-	if (!ftp->them.sin_addr.s_addr || !ftp->them.sin_port)
-		return &tris_null_frame;
-#endif
-
-	/* Send to whoever send to us if NAT is turned on */
-	if (ftp->nat) {
-		if (((ftp->them.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (ftp->them.sin_port != sock_in.sin_port)) && 
-		    ((ftp->altthem.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (ftp->altthem.sin_port != sock_in.sin_port))) {
-			ftp->them = sock_in;
-			if (ftp->ftcp) {
-				int h = 0;
-				memcpy(&ftp->ftcp->them, &sock_in, sizeof(ftp->ftcp->them));
-				h = ntohs(ftp->them.sin_port);
-				ftp->ftcp->them.sin_port = htons(h + 1);
-			}
-			ftp->rxseqno = 0;
-			tris_set_flag(ftp, FLAG_NAT_ACTIVE);
-			if (option_debug || ftpdebug)
-				tris_debug(0, "FTP NAT: Got audio from other end. Now sending to address %s:%d\n", tris_inet_ntoa(ftp->them.sin_addr), ntohs(ftp->them.sin_port));
-		}
-	}
-
-	/* If we are bridged to another FTP stream, send direct */
-	if ((bridged = tris_ftp_get_bridged(ftp)) && !bridge_p2p_ftp_write(ftp, bridged, ftpheader, res, hdrlen))
-		return &tris_null_frame;
-
-	if (version != 2)
-		return &tris_null_frame;
-
-	payloadtype = (seqno & 0x7f0000) >> 16;
-	padding = seqno & (1 << 29);
-	mark = seqno & (1 << 23);
-	ext = seqno & (1 << 28);
-	cc = (seqno & 0xF000000) >> 24;
-	seqno &= 0xffff;
-	timestamp = ntohl(ftpheader[1]);
-	ssrc = ntohl(ftpheader[2]);
-	
-	if (!mark && ftp->rxssrc && ftp->rxssrc != ssrc) {
-		if (option_debug || ftpdebug)
-			tris_debug(0, "Forcing Marker bit, because SSRC has changed\n");
-		mark = 1;
-	}
-
-	ftp->rxssrc = ssrc;
-	
-	if (padding) {
-		/* Remove padding bytes */
-		res -= ftp->rawdata[TRIS_FRIENDLY_OFFSET + res - 1];
-	}
-	
-	if (cc) {
-		/* CSRC fields present */
-		hdrlen += cc*4;
-	}
-
-	if (ext) {
-		/* FTP Extension present */
-		hdrlen += (ntohl(ftpheader[hdrlen/4]) & 0xffff) << 2;
-		hdrlen += 4;
-		if (option_debug) {
-			int profile;
-			profile = (ntohl(ftpheader[3]) & 0xffff0000) >> 16;
-			if (profile == 0x505a)
-				tris_debug(1, "Found Zfone extension in FTP stream - zftp - not supported.\n");
-			else
-				tris_debug(1, "Found unknown FTP Extensions %x\n", profile);
-		}
-	}
-
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "FTP Read too short (%d, expecting %d)\n", res, hdrlen);
-		return &tris_null_frame;
-	}
-
-	ftp->rxcount++; /* Only count reasonably valid packets, this'll make the ftcp stats more accurate */
-
-	if (ftp->rxcount==1) {
-		/* This is the first FTP packet successfully received from source */
-		ftp->seedrxseqno = seqno;
-	}
-
-	/* Do not schedule RR if FTCP isn't run */
-	if (ftp->ftcp && ftp->ftcp->them.sin_addr.s_addr && ftp->ftcp->schedid < 1) {
-		/* Schedule transmission of Receiver Report */
-		ftp->ftcp->schedid = tris_sched_add(ftp->sched, tris_ftcp_calc_interval(ftp), tris_ftcp_write, ftp);
-	}
-	if ((int)ftp->lastrxseqno - (int)seqno  > 100) /* if so it would indicate that the sender cycled; allow for misordering */
-		ftp->cycles += FTP_SEQ_MOD;
-	
-	prev_seqno = ftp->lastrxseqno;
-
-	ftp->lastrxseqno = seqno;
-	
-	if (!ftp->themssrc)
-		ftp->themssrc = ntohl(ftpheader[2]); /* Record their SSRC to put in future RR */
-	
-	if (ftp_debug_test_addr(&sock_in))
-		tris_verbose("Got  FTP packet from    %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-			tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp,res - hdrlen);
-
-	ftpPT = tris_ftp_lookup_pt(ftp, payloadtype);
-	if (!ftpPT.isAstFormat) {
-		struct tris_frame *f = NULL;
-
-		/* This is special in-band data that's not one of our codecs */
-		if (ftpPT.code == TRIS_FTP_DTMF) {
-			/* It's special -- rfc2833 process it */
-			if (ftp_debug_test_addr(&sock_in)) {
-				unsigned char *data;
-				unsigned int event;
-				unsigned int event_end;
-				unsigned int duration;
-				data = ftp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen;
-				event = ntohl(*((unsigned int *)(data)));
-				event >>= 24;
-				event_end = ntohl(*((unsigned int *)(data)));
-				event_end <<= 8;
-				event_end >>= 24;
-				duration = ntohl(*((unsigned int *)(data)));
-				duration &= 0xFFFF;
-				tris_verbose("Got  FTP RFC2833 from   %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u, mark %d, event %08x, end %d, duration %-5.5d) \n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp, res - hdrlen, (mark?1:0), event, ((event_end & 0x80)?1:0), duration);
-			}
-			f = process_rfc2833(ftp, ftp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen, seqno, timestamp);
-		} else if (ftpPT.code == TRIS_FTP_CISCO_DTMF) {
-			/* It's really special -- process it the Cisco way */
-			if (ftp->lastevent <= seqno || (ftp->lastevent >= 65530 && seqno <= 6)) {
-				f = process_cisco_dtmf(ftp, ftp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-				ftp->lastevent = seqno;
-			}
-		} else if (ftpPT.code == TRIS_FTP_CN) {
-			/* Comfort Noise */
-			f = process_rfc3389(ftp, ftp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-		} else {
-			tris_log(LOG_NOTICE, "Unknown FTP codec %d received from '%s'\n", payloadtype, tris_inet_ntoa(ftp->them.sin_addr));
-		}
-		return f ? f : &tris_null_frame;
-	}
-	ftp->lastrxformat = ftp->f.subclass = ftpPT.code;
-	ftp->f.frametype = (ftp->f.subclass & TRIS_FORMAT_AUDIO_MASK) ? TRIS_FRAME_VOICE : (ftp->f.subclass & TRIS_FORMAT_VIDEO_MASK) ? TRIS_FRAME_VIDEO : TRIS_FRAME_TEXT;
-
-	ftp->rxseqno = seqno;
-
-	if (ftp->dtmf_timeout && ftp->dtmf_timeout < timestamp) {
-		ftp->dtmf_timeout = 0;
-
-		if (ftp->resp) {
-			struct tris_frame *f;
-			f = send_dtmf(ftp, TRIS_FRAME_DTMF_END);
-			f->len = tris_tvdiff_ms(tris_samp2tv(ftp->dtmf_duration, ftp_get_rate(f->subclass)), tris_tv(0, 0));
-			ftp->resp = 0;
-			ftp->dtmf_timeout = ftp->dtmf_duration = 0;
-			return f;
-		}
-	}
-
-	/* Record received timestamp as last received now */
-	ftp->lastrxts = timestamp;
-
-	ftp->f.mallocd = 0;
-	ftp->f.datalen = res - hdrlen;
-	ftp->f.data.ptr = ftp->rawdata + hdrlen + TRIS_FRIENDLY_OFFSET;
-	ftp->f.offset = hdrlen + TRIS_FRIENDLY_OFFSET;
-	ftp->f.seqno = seqno;
-
-	if (ftp->f.subclass == TRIS_FORMAT_T140 && (int)seqno - (prev_seqno+1) > 0 && (int)seqno - (prev_seqno+1) < 10) {
-		  unsigned char *data = ftp->f.data.ptr;
-		  
-		  memmove(ftp->f.data.ptr+3, ftp->f.data.ptr, ftp->f.datalen);
-		  ftp->f.datalen +=3;
-		  *data++ = 0xEF;
-		  *data++ = 0xBF;
-		  *data = 0xBD;
-	}
- 
-	if (ftp->f.subclass == TRIS_FORMAT_T140RED) {
-		unsigned char *data = ftp->f.data.ptr;
-		unsigned char *header_end;
-		int num_generations;
-		int header_length;
-		int length;
-		int diff =(int)seqno - (prev_seqno+1); /* if diff = 0, no drop*/
-		int x;
-
-		ftp->f.subclass = TRIS_FORMAT_T140;
-		header_end = memchr(data, ((*data) & 0x7f), ftp->f.datalen);
-		if (header_end == NULL) {
-			return &tris_null_frame;
-		}
-		header_end++;
-		
-		header_length = header_end - data;
-		num_generations = header_length / 4;
-		length = header_length;
-
-		if (!diff) {
-			for (x = 0; x < num_generations; x++)
-				length += data[x * 4 + 3];
-			
-			if (!(ftp->f.datalen - length))
-				return &tris_null_frame;
-			
-			ftp->f.data.ptr += length;
-			ftp->f.datalen -= length;
-		} else if (diff > num_generations && diff < 10) {
-			length -= 3;
-			ftp->f.data.ptr += length;
-			ftp->f.datalen -= length;
-			
-			data = ftp->f.data.ptr;
-			*data++ = 0xEF;
-			*data++ = 0xBF;
-			*data = 0xBD;
-		} else 	{
-			for ( x = 0; x < num_generations - diff; x++) 
-				length += data[x * 4 + 3];
-			
-			ftp->f.data.ptr += length;
-			ftp->f.datalen -= length;
-		}
-	}
-
-	if (ftp->f.subclass & TRIS_FORMAT_AUDIO_MASK) {
-		ftp->f.samples = tris_codec_get_samples(&ftp->f);
-		if (ftp->f.subclass == TRIS_FORMAT_SLINEAR) 
-			tris_frame_byteswap_be(&ftp->f);
-		calc_rxstamp(&ftp->f.delivery, ftp, timestamp, mark);
-		/* Add timing data to let tris_generic_bridge() put the frame into a jitterbuf */
-		tris_set_flag(&ftp->f, TRIS_FRFLAG_HAS_TIMING_INFO);
-		ftp->f.ts = timestamp / (ftp_get_rate(ftp->f.subclass) / 1000);
-		ftp->f.len = ftp->f.samples / ((tris_format_rate(ftp->f.subclass) / 1000));
-	} else if (ftp->f.subclass & TRIS_FORMAT_VIDEO_MASK) {
-		/* Video -- samples is # of samples vs. 90000 */
-		if (!ftp->lastividtimestamp)
-			ftp->lastividtimestamp = timestamp;
-		ftp->f.samples = timestamp - ftp->lastividtimestamp;
-		ftp->lastividtimestamp = timestamp;
-		ftp->f.delivery.tv_sec = 0;
-		ftp->f.delivery.tv_usec = 0;
-		/* Pass the FTP marker bit as bit 0 in the subclass field.
-		 * This is ok because subclass is actually a bitmask, and
-		 * the low bits represent audio formats, that are not
-		 * involved here since we deal with video.
-		 */
-		if (mark)
-			ftp->f.subclass |= 0x1;
-	} else {
-		/* TEXT -- samples is # of samples vs. 1000 */
-		if (!ftp->lastitexttimestamp)
-			ftp->lastitexttimestamp = timestamp;
-		ftp->f.samples = timestamp - ftp->lastitexttimestamp;
-		ftp->lastitexttimestamp = timestamp;
-		ftp->f.delivery.tv_sec = 0;
-		ftp->f.delivery.tv_usec = 0;
-	}
-	ftp->f.src = "FTP";
-	return &ftp->f;
-#endif
 }
 
 /* The following array defines the MIME Media type (and subtype) for each
@@ -2498,7 +1474,7 @@ int tris_ftp_make_compatible(struct tris_channel *dest, struct tris_channel *src
 	struct tris_ftp_protocol *destpr = NULL, *srcpr = NULL;
 	enum tris_ftp_get_result audio_dest_res = TRIS_FTP_GET_FAILED, video_dest_res = TRIS_FTP_GET_FAILED, text_dest_res = TRIS_FTP_GET_FAILED;
 	enum tris_ftp_get_result audio_src_res = TRIS_FTP_GET_FAILED, video_src_res = TRIS_FTP_GET_FAILED, text_src_res = TRIS_FTP_GET_FAILED; 
-	int srccodec, destcodec;
+	format_t srccodec, destcodec;
 
 	/* Lock channels */
 	tris_channel_lock(dest);
@@ -2769,7 +1745,7 @@ unsigned int tris_ftp_lookup_sample_rate(int isAstFormat, int code)
 char *tris_ftp_lookup_mime_multiple(char *buf, size_t size, const int capability,
 				   const int isAstFormat, enum tris_ftp_options options)
 {
-	int format;
+	format_t format;
 	unsigned len;
 	char *end = buf;
 	char *start = buf;
@@ -3540,43 +2516,6 @@ int tris_ftp_senddigit_begin(struct tris_ftp *ftp, char digit)
 	return 0;
 }
 
-/*! \brief Send continuation frame for DTMF */
-static int tris_ftp_senddigit_continuation(struct tris_ftp *ftp)
-{
-	unsigned int *ftpheader;
-	int hdrlen = 12, res = 0;
-	char data[256];
-
-	if (!ftp->them.sin_addr.s_addr || !ftp->them.sin_port)
-		return 0;
-
-	/* Setup packet to send */
-	ftpheader = (unsigned int *)data;
-	ftpheader[0] = htonl((2 << 30) | (1 << 23) | (ftp->send_payload << 16) | (ftp->seqno));
-	ftpheader[1] = htonl(ftp->lastdigitts);
-	ftpheader[2] = htonl(ftp->ssrc);
-	ftpheader[3] = htonl((ftp->send_digit << 24) | (0xa << 16) | (ftp->send_duration));
-	ftpheader[0] = htonl((2 << 30) | (ftp->send_payload << 16) | (ftp->seqno));
-	
-	/* Transmit */
-	res = sendto(ftp->s, (void *) ftpheader, hdrlen + 4, 0, (struct sockaddr *) &ftp->them, sizeof(ftp->them));
-	if (res < 0)
-		tris_log(LOG_ERROR, "FTP Transmission error to %s:%d: %s\n",
-			tris_inet_ntoa(ftp->them.sin_addr),
-			ntohs(ftp->them.sin_port), strerror(errno));
-	if (ftp_debug_test_addr(&ftp->them))
-		tris_verbose("Sent FTP DTMF packet to %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-			    tris_inet_ntoa(ftp->them.sin_addr),
-			    ntohs(ftp->them.sin_port), ftp->send_payload, ftp->seqno, ftp->lastdigitts, res - hdrlen);
-
-	/* Increment sequence number */
-	ftp->seqno++;
-	/* Increment duration */
-	ftp->send_duration += 160;
-
-	return 0;
-}
-
 /*! \brief Send end packets for DTMF */
 int tris_ftp_senddigit_end(struct tris_ftp *ftp, char digit)
 {
@@ -4095,14 +3034,14 @@ void tris_ftp_codec_setpref(struct tris_ftp *ftp, struct tris_codec_pref *prefs)
 			}
 		} else {
 			if (!(ftp->smoother = tris_smoother_new(new_size))) {
-				tris_log(LOG_WARNING, "Unable to create smoother: format: %d ms: %d len: %d\n", ftp->lasttxformat, current_format_new.cur_ms, new_size);
+				tris_log(LOG_WARNING, "Unable to create smoother: format: %s ms: %d len: %d\n", tris_getformatname(ftp->lasttxformat), current_format_new.cur_ms, new_size);
 				return;
 			}
 			if (current_format_new.flags) {
 				tris_smoother_set_flags(ftp->smoother, current_format_new.flags);
 			}
 			if (option_debug) {
-				tris_log(LOG_DEBUG, "Created smoother: format: %d ms: %d len: %d\n", ftp->lasttxformat, current_format_new.cur_ms, new_size);
+				tris_log(LOG_DEBUG, "Created smoother: format: %s ms: %d len: %d\n", tris_getformatname(ftp->lasttxformat), current_format_new.cur_ms, new_size);
 			}
 		}
 	}
@@ -4128,9 +3067,9 @@ int tris_ftp_codec_getformat(int pt)
 int tris_ftp_write_orig(struct tris_ftp *ftp, struct tris_frame *_f)
 {
 	struct tris_frame *f;
-	int codec;
+	format_t codec;
 	int hdrlen = 12;
-	int subclass;
+	format_t subclass;
 	
 
 	/* If we have no peer, return immediately */	
@@ -4188,12 +3127,12 @@ int tris_ftp_write_orig(struct tris_ftp *ftp, struct tris_frame *_f)
 		default:
 			if (fmt.inc_ms) { /* if codec parameters is set / avoid division by zero */
 				if (!(ftp->smoother = tris_smoother_new((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms))) {
-					tris_log(LOG_WARNING, "Unable to create smoother: format: %d ms: %d len: %d\n", subclass, fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
+					tris_log(LOG_WARNING, "Unable to create smoother: format: %s ms: %d len: %d\n", tris_getformatname(subclass), fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
 					return -1;
 				}
 				if (fmt.flags)
 					tris_smoother_set_flags(ftp->smoother, fmt.flags);
-				tris_debug(1, "Created smoother: format: %d ms: %d len: %d\n", subclass, fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
+				tris_debug(1, "Created smoother: format: %s ms: %d len: %d\n", tris_getformatname(subclass), fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
 			}
 		}
 	}
@@ -4267,7 +3206,7 @@ static enum tris_bridge_result bridge_native_loop(struct tris_channel *c0, struc
 {
 	struct tris_frame *fr = NULL;
 	struct tris_channel *who = NULL, *other = NULL, *cs[3] = {NULL, };
-	int oldcodec0 = codec0, oldcodec1 = codec1;
+	format_t oldcodec0 = codec0, oldcodec1 = codec1;
 	struct sockaddr_in ac1 = {0,}, vac1 = {0,}, tac1 = {0,}, ac0 = {0,}, vac0 = {0,}, tac0 = {0,};
 	struct sockaddr_in t1 = {0,}, vt1 = {0,}, tt1 = {0,}, t0 = {0,}, vt0 = {0,}, tt0 = {0,};
 	
@@ -4339,18 +3278,18 @@ static enum tris_bridge_result bridge_native_loop(struct tris_channel *c0, struc
 		    (vp1 && inaddrcmp(&vt1, &vac1)) ||
 		    (tp1 && inaddrcmp(&tt1, &tac1)) ||
 		    (codec1 != oldcodec1)) {
-			tris_debug(2, "Oooh, '%s' changed end address to %s:%d (format %d)\n",
-				c1->name, tris_inet_ntoa(t1.sin_addr), ntohs(t1.sin_port), codec1);
-			tris_debug(2, "Oooh, '%s' changed end vaddress to %s:%d (format %d)\n",
-				c1->name, tris_inet_ntoa(vt1.sin_addr), ntohs(vt1.sin_port), codec1);
-			tris_debug(2, "Oooh, '%s' changed end taddress to %s:%d (format %d)\n",
-				c1->name, tris_inet_ntoa(tt1.sin_addr), ntohs(tt1.sin_port), codec1);
-			tris_debug(2, "Oooh, '%s' was %s:%d/(format %d)\n",
-				c1->name, tris_inet_ntoa(ac1.sin_addr), ntohs(ac1.sin_port), oldcodec1);
-			tris_debug(2, "Oooh, '%s' was %s:%d/(format %d)\n",
-				c1->name, tris_inet_ntoa(vac1.sin_addr), ntohs(vac1.sin_port), oldcodec1);
-			tris_debug(2, "Oooh, '%s' was %s:%d/(format %d)\n",
-				c1->name, tris_inet_ntoa(tac1.sin_addr), ntohs(tac1.sin_port), oldcodec1);
+			tris_debug(2, "Oooh, '%s' changed end address to %s:%d (format %s)\n",
+				c1->name, tris_inet_ntoa(t1.sin_addr), ntohs(t1.sin_port), tris_getformatname(codec1));
+			tris_debug(2, "Oooh, '%s' changed end vaddress to %s:%d (format %s)\n",
+				c1->name, tris_inet_ntoa(vt1.sin_addr), ntohs(vt1.sin_port), tris_getformatname(codec1));
+			tris_debug(2, "Oooh, '%s' changed end taddress to %s:%d (format %s)\n",
+				c1->name, tris_inet_ntoa(tt1.sin_addr), ntohs(tt1.sin_port), tris_getformatname(codec1));
+			tris_debug(2, "Oooh, '%s' was %s:%d/(format %s)\n",
+				c1->name, tris_inet_ntoa(ac1.sin_addr), ntohs(ac1.sin_port), tris_getformatname(oldcodec1));
+			tris_debug(2, "Oooh, '%s' was %s:%d/(format %s)\n",
+				c1->name, tris_inet_ntoa(vac1.sin_addr), ntohs(vac1.sin_port), tris_getformatname(oldcodec1));
+			tris_debug(2, "Oooh, '%s' was %s:%d/(format %s)\n",
+				c1->name, tris_inet_ntoa(tac1.sin_addr), ntohs(tac1.sin_port), tris_getformatname(oldcodec1));
 			if (pr0->set_ftp_peer(c0, t1.sin_addr.s_addr ? p1 : NULL, vt1.sin_addr.s_addr ? vp1 : NULL, tt1.sin_addr.s_addr ? tp1 : NULL, codec1, tris_test_flag(p1, FLAG_NAT_ACTIVE)))
 				tris_log(LOG_WARNING, "Channel '%s' failed to update to '%s'\n", c0->name, c1->name);
 			memcpy(&ac1, &t1, sizeof(ac1));
@@ -4362,10 +3301,10 @@ static enum tris_bridge_result bridge_native_loop(struct tris_channel *c0, struc
 		    (vp0 && inaddrcmp(&vt0, &vac0)) ||
 		    (tp0 && inaddrcmp(&tt0, &tac0)) ||
 		    (codec0 != oldcodec0)) {
-			tris_debug(2, "Oooh, '%s' changed end address to %s:%d (format %d)\n",
-				c0->name, tris_inet_ntoa(t0.sin_addr), ntohs(t0.sin_port), codec0);
-			tris_debug(2, "Oooh, '%s' was %s:%d/(format %d)\n",
-				c0->name, tris_inet_ntoa(ac0.sin_addr), ntohs(ac0.sin_port), oldcodec0);
+			tris_debug(2, "Oooh, '%s' changed end address to %s:%d (format %s)\n",
+				c0->name, tris_inet_ntoa(t0.sin_addr), ntohs(t0.sin_port), tris_getformatname(codec0));
+			tris_debug(2, "Oooh, '%s' was %s:%d/(format %s)\n",
+				c0->name, tris_inet_ntoa(ac0.sin_addr), ntohs(ac0.sin_port), tris_getformatname(oldcodec0));
 			if (pr1->set_ftp_peer(c1, t0.sin_addr.s_addr ? p0 : NULL, vt0.sin_addr.s_addr ? vp0 : NULL, tt0.sin_addr.s_addr ? tp0 : NULL, codec0, tris_test_flag(p0, FLAG_NAT_ACTIVE)))
 				tris_log(LOG_WARNING, "Channel '%s' failed to update to '%s'\n", c1->name, c0->name);
 			memcpy(&ac0, &t0, sizeof(ac0));
@@ -4439,7 +3378,7 @@ static enum tris_bridge_result bridge_native_loop(struct tris_channel *c0, struc
 			} else {
 				*fo = fr;
 				*rc = who;
-				tris_debug(1, "Got a FRAME_CONTROL (%d) frame on channel %s\n", fr->subclass, who->name);
+				tris_debug(1, "Got a FRAME_CONTROL (%d) frame on channel %s\n", (int) fr->subclass, who->name);
 				return TRIS_BRIDGE_COMPLETE;
 			}
 		} else {
@@ -4673,7 +3612,7 @@ static enum tris_bridge_result bridge_p2p_loop(struct tris_channel *c0, struct t
 			} else {
 				*fo = fr;
 				*rc = who;
-				tris_debug(3, "p2p-ftp-bridge: Got a FRAME_CONTROL (%d) frame on channel %s\n", fr->subclass, who->name);
+				tris_debug(3, "p2p-ftp-bridge: Got a FRAME_CONTROL (%d) frame on channel %s\n", (int) fr->subclass, who->name);
 				res = TRIS_BRIDGE_COMPLETE;
 				break;
 			}
@@ -4755,7 +3694,7 @@ enum tris_bridge_result tris_ftp_bridge(struct tris_channel *c0, struct tris_cha
 	enum tris_ftp_get_result audio_p0_res = TRIS_FTP_GET_FAILED, video_p0_res = TRIS_FTP_GET_FAILED, text_p0_res = TRIS_FTP_GET_FAILED;
 	enum tris_ftp_get_result audio_p1_res = TRIS_FTP_GET_FAILED, video_p1_res = TRIS_FTP_GET_FAILED, text_p1_res = TRIS_FTP_GET_FAILED;
 	enum tris_bridge_result res = TRIS_BRIDGE_FAILED;
-	int codec0 = 0, codec1 = 0;
+	format_t codec0 = 0, codec1 = 0;
 	void *pvt0 = NULL, *pvt1 = NULL;
 
 	/* Lock channels */
@@ -4862,7 +3801,7 @@ enum tris_bridge_result tris_ftp_bridge(struct tris_channel *c0, struct tris_cha
 	codec1 = pr1->get_codec ? pr1->get_codec(c1) : 0;
 	if (codec0 && codec1 && !(codec0 & codec1)) {
 		/* Hey, we can't do native bridging if both parties speak different codecs */
-		tris_debug(3, "Channel codec0 = %d is not codec1 = %d, cannot native bridge in FTP.\n", codec0, codec1);
+		tris_debug(3, "Channel codec0 = %s is not codec1 = %s, cannot native bridge in FTP.\n", tris_getformatname(codec0), tris_getformatname(codec1));
 		tris_channel_unlock(c0);
 		tris_channel_unlock(c1);
 		return TRIS_BRIDGE_FAILED_NOWARN;
@@ -0,0 +1,488 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 2009, Digium, Inc.
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ *
+ * \brief Block conversion between G.711 and signed linear
+ *
+ * The portable kernels use the lookup tables from ulaw.c and alaw.c.  On
+ * x86 the AVX2 kernels compute the same values arithmetically, a vector
+ * of samples at a time, and are built with the target attribute like the
+ * mixing kernels in mix.c.  SSE2 has no byte shuffle to look up a power
+ * of two per lane, and without one the vector code is no faster than the
+ * tables, so there are no SSE2 kernels.
+ *
+ * The batch kernels convert the buffers of several channels in one call.
+ * The AVX2 ones gather what is left over at the end of each buffer into
+ * vectors of their own, so only the last few samples of a whole batch go
+ * through the tables.
+ *
+ * The vector encoders follow the default table layout.  With
+ * G711_NEW_ALGORITHM the tables round differently, so the table driven
+ * encoders are used with every kernel set.
+ */
+
+#include "trismedia.h"
+
+TRISMEDIA_FILE_VERSION(__FILE__, "$Revision$")
+
+#include "trismedia/g711.h"
+#include "trismedia/ulaw.h"
+#include "trismedia/alaw.h"
+#include "trismedia/utils.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+	((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9) || defined(__clang__))
+#define G711_X86
+#include <immintrin.h>
+#endif
+
+#define ULAW_BIAS 0x84
+#define ULAW_CLIP 32635
+
+struct g711_kernels {
+	const char *name;
+	void (*ulaw_decode)(short *dst, const unsigned char *src, int samples);
+	void (*ulaw_encode)(unsigned char *dst, const short *src, int samples);
+	void (*alaw_decode)(short *dst, const unsigned char *src, int samples);
+	void (*alaw_encode)(unsigned char *dst, const short *src, int samples);
+	void (*ulaw_decode_batch)(short **dst, const unsigned char **src, const int *samples, int count);
+	void (*ulaw_encode_batch)(unsigned char **dst, const short **src, const int *samples, int count);
+	void (*alaw_decode_batch)(short **dst, const unsigned char **src, const int *samples, int count);
+	void (*alaw_encode_batch)(unsigned char **dst, const short **src, const int *samples, int count);
+};
+
+static void generic_ulaw_decode(short *dst, const unsigned char *src, int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		dst[i] = TRIS_MULAW(src[i]);
+}
+
+static void generic_ulaw_encode(unsigned char *dst, const short *src, int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		dst[i] = TRIS_LIN2MU(src[i]);
+}
+
+static void generic_alaw_decode(short *dst, const unsigned char *src, int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		dst[i] = TRIS_ALAW(src[i]);
+}
+
+static void generic_alaw_encode(unsigned char *dst, const short *src, int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		dst[i] = TRIS_LIN2A(src[i]);
+}
+
+static void generic_ulaw_decode_batch(short **dst, const unsigned char **src, const int *samples, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		generic_ulaw_decode(dst[i], src[i], samples[i]);
+}
+
+static void generic_ulaw_encode_batch(unsigned char **dst, const short **src, const int *samples, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		generic_ulaw_encode(dst[i], src[i], samples[i]);
+}
+
+static void generic_alaw_decode_batch(short **dst, const unsigned char **src, const int *samples, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		generic_alaw_decode(dst[i], src[i], samples[i]);
+}
+
+static void generic_alaw_encode_batch(unsigned char **dst, const short **src, const int *samples, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		generic_alaw_encode(dst[i], src[i], samples[i]);
+}
+
+static const struct g711_kernels generic_kernels = {
+	.name = "generic",
+	.ulaw_decode = generic_ulaw_decode,
+	.ulaw_encode = generic_ulaw_encode,
+	.alaw_decode = generic_alaw_decode,
+	.alaw_encode = generic_alaw_encode,
+	.ulaw_decode_batch = generic_ulaw_decode_batch,
+	.ulaw_encode_batch = generic_ulaw_encode_batch,
+	.alaw_decode_batch = generic_alaw_decode_batch,
+	.alaw_encode_batch = generic_alaw_encode_batch,
+};
+
+#ifdef G711_X86
+/*
+ * Both laws decode to ((mantissa << shift) + bias) << exponent, so a lane
+ * wise power of two is all that is needed beyond plain 16 bit arithmetic.
+ * The encoders find the exponent by counting the segment boundaries a
+ * magnitude is above, and shift right by the exponent with an unsigned
+ * multiply high.
+ *
+ * The default tables are indexed by the sample divided by 4 (u-law) or 8
+ * (a-law), and hold the code of the last sample of each group, so the
+ * encoders set those low bits before coding.
+ */
+
+#define AVX2 __attribute__((target("avx2")))
+
+/*! \brief 1 << e for every 16 bit lane, e in 0..7 */
+static force_inline AVX2 __m256i avx2_pow2(__m256i e)
+{
+	/* The high byte of every lane looks up 0x80, which shuffles in a zero */
+	const __m256i pow2 = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+		1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+
+	return _mm256_shuffle_epi8(pow2, _mm256_or_si256(e, _mm256_set1_epi16(0x8000)));
+}
+
+/*! \brief number of segment boundaries, 0xff to 0x3fff, below mag */
+static force_inline AVX2 __m256i avx2_segment(__m256i mag)
+{
+	__m256i seg = _mm256_cmpgt_epi16(mag, _mm256_set1_epi16(0xff));
+
+	seg = _mm256_add_epi16(seg, _mm256_cmpgt_epi16(mag, _mm256_set1_epi16(0x1ff)));
+	seg = _mm256_add_epi16(seg, _mm256_cmpgt_epi16(mag, _mm256_set1_epi16(0x3ff)));
+	seg = _mm256_add_epi16(seg, _mm256_cmpgt_epi16(mag, _mm256_set1_epi16(0x7ff)));
+	seg = _mm256_add_epi16(seg, _mm256_cmpgt_epi16(mag, _mm256_set1_epi16(0xfff)));
+	seg = _mm256_add_epi16(seg, _mm256_cmpgt_epi16(mag, _mm256_set1_epi16(0x1fff)));
+	seg = _mm256_add_epi16(seg, _mm256_cmpgt_epi16(mag, _mm256_set1_epi16(0x3fff)));
+
+	/* every boundary above added -1 */
+	return _mm256_sub_epi16(_mm256_setzero_si256(), seg);
+}
+
+/*! \brief decode 16 u-law samples */
+static force_inline AVX2 void avx2_ulaw_decode16(short *dst, const unsigned char *src)
+{
+	const __m256i bias = _mm256_set1_epi16(ULAW_BIAS);
+	const __m256i sign = _mm256_set1_epi16(0x80);
+	__m256i u = _mm256_xor_si256(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) src)), _mm256_set1_epi16(0xff));
+	__m256i e = _mm256_and_si256(_mm256_srli_epi16(u, 4), _mm256_set1_epi16(7));
+	__m256i m = _mm256_add_epi16(_mm256_slli_epi16(_mm256_and_si256(u, _mm256_set1_epi16(0x0f)), 3), bias);
+	__m256i mag = _mm256_sub_epi16(_mm256_mullo_epi16(m, avx2_pow2(e)), bias);
+	__m256i neg = _mm256_cmpeq_epi16(_mm256_and_si256(u, sign), sign);
+
+	_mm256_storeu_si256((__m256i *) dst, _mm256_sub_epi16(_mm256_xor_si256(mag, neg), neg));
+}
+
+/*! \brief decode 16 a-law samples */
+static force_inline AVX2 void avx2_alaw_decode16(short *dst, const unsigned char *src)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i sign = _mm256_set1_epi16(0x80);
+	__m256i a = _mm256_xor_si256(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) src)), _mm256_set1_epi16(0x55));
+	__m256i seg = _mm256_and_si256(_mm256_srli_epi16(a, 4), _mm256_set1_epi16(7));
+	__m256i has_seg = _mm256_cmpgt_epi16(seg, zero);
+	__m256i m = _mm256_add_epi16(_mm256_slli_epi16(_mm256_and_si256(a, _mm256_set1_epi16(0x0f)), 4), _mm256_set1_epi16(8));
+	__m256i mag, neg;
+
+	m = _mm256_add_epi16(m, _mm256_and_si256(has_seg, _mm256_set1_epi16(0x100)));
+	mag = _mm256_mullo_epi16(m, avx2_pow2(_mm256_add_epi16(seg, has_seg)));
+	neg = _mm256_cmpeq_epi16(_mm256_and_si256(a, sign), zero);
+
+	_mm256_storeu_si256((__m256i *) dst, _mm256_sub_epi16(_mm256_xor_si256(mag, neg), neg));
+}
+
+static AVX2 void avx2_ulaw_decode(short *dst, const unsigned char *src, int samples)
+{
+	int i;
+
+	for (i = 0; i + 16 <= samples; i += 16)
+		avx2_ulaw_decode16(dst + i, src + i);
+	generic_ulaw_decode(dst + i, src + i, samples - i);
+}
+
+static AVX2 void avx2_alaw_decode(short *dst, const unsigned char *src, int samples)
+{
+	int i;
+
+	for (i = 0; i + 16 <= samples; i += 16)
+		avx2_alaw_decode16(dst + i, src + i);
+	generic_alaw_decode(dst + i, src + i, samples - i);
+}
+
+static AVX2 void avx2_ulaw_decode_batch(short **dst, const unsigned char **src, const int *samples, int count)
+{
+	unsigned char in[16];
+	short out[16], *to[16];
+	int b, i, j, n = 0;
+
+	for (b = 0; b < count; b++) {
+		for (i = 0; i + 16 <= samples[b]; i += 16)
+			avx2_ulaw_decode16(dst[b] + i, src[b] + i);
+		/* gather the rest with the rest of the next buffers */
+		for (; i < samples[b]; i++) {
+			in[n] = src[b][i];
+			to[n++] = dst[b] + i;
+			if (n == 16) {
+				avx2_ulaw_decode16(out, in);
+				for (j = 0; j < 16; j++)
+					*to[j] = out[j];
+				n = 0;
+			}
+		}
+	}
+	generic_ulaw_decode(out, in, n);
+	for (j = 0; j < n; j++)
+		*to[j] = out[j];
+}
+
+static AVX2 void avx2_alaw_decode_batch(short **dst, const unsigned char **src, const int *samples, int count)
+{
+	unsigned char in[16];
+	short out[16], *to[16];
+	int b, i, j, n = 0;
+
+	for (b = 0; b < count; b++) {
+		for (i = 0; i + 16 <= samples[b]; i += 16)
+			avx2_alaw_decode16(dst[b] + i, src[b] + i);
+		/* gather the rest with the rest of the next buffers */
+		for (; i < samples[b]; i++) {
+			in[n] = src[b][i];
+			to[n++] = dst[b] + i;
+			if (n == 16) {
+				avx2_alaw_decode16(out, in);
+				for (j = 0; j < 16; j++)
+					*to[j] = out[j];
+				n = 0;
+			}
+		}
+	}
+	generic_alaw_decode(out, in, n);
+	for (j = 0; j < n; j++)
+		*to[j] = out[j];
+}
+
+#ifndef G711_NEW_ALGORITHM
+/*! \brief u-law code of 16 samples, one per 16 bit lane */
+static force_inline AVX2 __m256i avx2_ulaw_code(__m256i x)
+{
+	__m256i neg, mag, e, m, code;
+
+	x = _mm256_or_si256(x, _mm256_set1_epi16(3));
+	neg = _mm256_srai_epi16(x, 15);
+	mag = _mm256_abs_epi16(x);
+	mag = _mm256_add_epi16(_mm256_min_epi16(mag, _mm256_set1_epi16(ULAW_CLIP)), _mm256_set1_epi16(ULAW_BIAS));
+	e = avx2_segment(mag);
+	/* mag >> (e + 3) */
+	m = _mm256_mulhi_epu16(mag, _mm256_slli_epi16(avx2_pow2(_mm256_sub_epi16(_mm256_set1_epi16(7), e)), 6));
+
+	code = _mm256_or_si256(_mm256_slli_epi16(e, 4), _mm256_and_si256(m, _mm256_set1_epi16(0x0f)));
+	code = _mm256_or_si256(code, _mm256_and_si256(neg, _mm256_set1_epi16(0x80)));
+	return _mm256_xor_si256(code, _mm256_set1_epi16(0xff));
+}
+
+/*! \brief a-law code of 16 samples, one per 16 bit lane */
+static force_inline AVX2 __m256i avx2_alaw_code(__m256i x)
+{
+	__m256i neg, mag, seg, m, code;
+
+	x = _mm256_or_si256(x, _mm256_set1_epi16(7));
+	neg = _mm256_srai_epi16(x, 15);
+	mag = _mm256_abs_epi16(x);
+	seg = avx2_segment(mag);
+	/* mag >> (seg + 3), or mag >> 4 in the first segment */
+	m = _mm256_sub_epi16(seg, _mm256_cmpeq_epi16(seg, _mm256_setzero_si256()));
+	m = _mm256_mulhi_epu16(mag, _mm256_slli_epi16(avx2_pow2(_mm256_sub_epi16(_mm256_set1_epi16(7), m)), 6));
+
+	code = _mm256_or_si256(_mm256_slli_epi16(seg, 4), _mm256_and_si256(m, _mm256_set1_epi16(0x0f)));
+	return _mm256_xor_si256(code, _mm256_or_si256(_mm256_set1_epi16(0x55), _mm256_andnot_si256(neg, _mm256_set1_epi16(0x80))));
+}
+
+/*! \brief store the codes of two vectors of 16 samples as 32 bytes */
+static force_inline AVX2 void avx2_store32(unsigned char *dst, __m256i lo, __m256i hi)
+{
+	/* packus works within 128 bit lanes, put the quadwords back in order */
+	_mm256_storeu_si256((__m256i *) dst, _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8));
+}
+
+/*! \brief store the codes of one vector of 16 samples as 16 bytes */
+static force_inline AVX2 void avx2_store16(unsigned char *dst, __m256i code)
+{
+	_mm_storeu_si128((__m128i *) dst, _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi16(code, code), 0xd8)));
+}
+
+static AVX2 void avx2_ulaw_encode(unsigned char *dst, const short *src, int samples)
+{
+	int i;
+
+	for (i = 0; i + 32 <= samples; i += 32) {
+		avx2_store32(dst + i, avx2_ulaw_code(_mm256_loadu_si256((const __m256i *) (src + i))),
+			avx2_ulaw_code(_mm256_loadu_si256((const __m256i *) (src + i + 16))));
+	}
+	generic_ulaw_encode(dst + i, src + i, samples - i);
+}
+
+static AVX2 void avx2_alaw_encode(unsigned char *dst, const short *src, int samples)
+{
+	int i;
+
+	for (i = 0; i + 32 <= samples; i += 32) {
+		avx2_store32(dst + i, avx2_alaw_code(_mm256_loadu_si256((const __m256i *) (src + i))),
+			avx2_alaw_code(_mm256_loadu_si256((const __m256i *) (src + i + 16))));
+	}
+	generic_alaw_encode(dst + i, src + i, samples - i);
+}
+
+static AVX2 void avx2_ulaw_encode_batch(unsigned char **dst, const short **src, const int *samples, int count)
+{
+	short in[16];
+	unsigned char out[16], *to[16];
+	int b, i, j, n = 0;
+
+	for (b = 0; b < count; b++) {
+		for (i = 0; i + 32 <= samples[b]; i += 32) {
+			avx2_store32(dst[b] + i, avx2_ulaw_code(_mm256_loadu_si256((const __m256i *) (src[b] + i))),
+				avx2_ulaw_code(_mm256_loadu_si256((const __m256i *) (src[b] + i + 16))));
+		}
+		/* gather the rest with the rest of the next buffers */
+		for (; i < samples[b]; i++) {
+			in[n] = src[b][i];
+			to[n++] = dst[b] + i;
+			if (n == 16) {
+				avx2_store16(out, avx2_ulaw_code(_mm256_loadu_si256((const __m256i *) in)));
+				for (j = 0; j < 16; j++)
+					*to[j] = out[j];
+				n = 0;
+			}
+		}
+	}
+	generic_ulaw_encode(out, in, n);
+	for (j = 0; j < n; j++)
+		*to[j] = out[j];
+}
+
+static AVX2 void avx2_alaw_encode_batch(unsigned char **dst, const short **src, const int *samples, int count)
+{
+	short in[16];
+	unsigned char out[16], *to[16];
+	int b, i, j, n = 0;
+
+	for (b = 0; b < count; b++) {
+		for (i = 0; i + 32 <= samples[b]; i += 32) {
+			avx2_store32(dst[b] + i, avx2_alaw_code(_mm256_loadu_si256((const __m256i *) (src[b] + i))),
+				avx2_alaw_code(_mm256_loadu_si256((const __m256i *) (src[b] + i + 16))));
+		}
+		/* gather the rest with the rest of the next buffers */
+		for (; i < samples[b]; i++) {
+			in[n] = src[b][i];
+			to[n++] = dst[b] + i;
+			if (n == 16) {
+				avx2_store16(out, avx2_alaw_code(_mm256_loadu_si256((const __m256i *) in)));
+				for (j = 0; j < 16; j++)
+					*to[j] = out[j];
+				n = 0;
+			}
+		}
+	}
+	generic_alaw_encode(out, in, n);
+	for (j = 0; j < n; j++)
+		*to[j] = out[j];
+}
+#else
+#define avx2_ulaw_encode generic_ulaw_encode
+#define avx2_alaw_encode generic_alaw_encode
+#define avx2_ulaw_encode_batch generic_ulaw_encode_batch
+#define avx2_alaw_encode_batch generic_alaw_encode_batch
+#endif /* G711_NEW_ALGORITHM */
+
+static const struct g711_kernels avx2_kernels = {
+	.name = "avx2",
+	.ulaw_decode = avx2_ulaw_decode,
+	.ulaw_encode = avx2_ulaw_encode,
+	.alaw_decode = avx2_alaw_decode,
+	.alaw_encode = avx2_alaw_encode,
+	.ulaw_decode_batch = avx2_ulaw_decode_batch,
+	.ulaw_encode_batch = avx2_ulaw_encode_batch,
+	.alaw_decode_batch = avx2_alaw_decode_batch,
+	.alaw_encode_batch = avx2_alaw_encode_batch,
+};
+#endif /* G711_X86 */
+
+static const struct g711_kernels *kernels = &generic_kernels;
+
+void tris_ulaw_decode(short *dst, const unsigned char *src, int samples)
+{
+	kernels->ulaw_decode(dst, src, samples);
+}
+
+void tris_ulaw_encode(unsigned char *dst, const short *src, int samples)
+{
+	kernels->ulaw_encode(dst, src, samples);
+}
+
+void tris_alaw_decode(short *dst, const unsigned char *src, int samples)
+{
+	kernels->alaw_decode(dst, src, samples);
+}
+
+void tris_alaw_encode(unsigned char *dst, const short *src, int samples)
+{
+	kernels->alaw_encode(dst, src, samples);
+}
+
+void tris_ulaw_decode_batch(short **dst, const unsigned char **src, const int *samples, int count)
+{
+	kernels->ulaw_decode_batch(dst, src, samples, count);
+}
+
+void tris_ulaw_encode_batch(unsigned char **dst, const short **src, const int *samples, int count)
+{
+	kernels->ulaw_encode_batch(dst, src, samples, count);
+}
+
+void tris_alaw_decode_batch(short **dst, const unsigned char **src, const int *samples, int count)
+{
+	kernels->alaw_decode_batch(dst, src, samples, count);
+}
+
+void tris_alaw_encode_batch(unsigned char **dst, const short **src, const int *samples, int count)
+{
+	kernels->alaw_encode_batch(dst, src, samples, count);
+}
+
+const char *tris_g711_kernel(void)
+{
+	return kernels->name;
+}
+
+void tris_g711_init(void)
+{
+#ifdef G711_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		kernels = &avx2_kernels;
+#endif
+	tris_verb(2, "Using %s G.711 kernels\n", kernels->name);
+}
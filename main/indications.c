@@ -102,7 +102,7 @@ struct playtones_state {
 	int npos;
 	int oldnpos;
 	int pos;
-	int origwfmt;
+	format_t origwfmt;
 	struct tris_frame f;
 	unsigned char offset[TRIS_FRIENDLY_OFFSET];
 	short data[4000];
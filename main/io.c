@@ -29,6 +29,10 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 182947 $")
 
 #include <termios.h>
 #include <sys/ioctl.h>
+#if defined(linux)
+#include <sys/epoll.h>
+#define IO_EPOLL
+#endif
 
 #include "trismedia/io.h"
 #include "trismedia/utils.h"
@@ -46,6 +50,7 @@ struct io_rec {
 	tris_io_cb callback;		/*!< What is to be called */
 	void *data; 			/*!< Data to be passed */
 	int *id; 			/*!< ID number */
+	unsigned int gen;		/*!< Generation registered with epoll, tells a reused slot from the old entry */
 };
 
 /* These two arrays are keyed with
@@ -57,6 +62,9 @@ struct io_rec {
 
 #define GROW_SHRINK_SIZE 512
 
+/*! \brief Most events taken from the kernel per epoll_wait() call */
+#define IO_EPOLL_EVENTS 256
+
 /*! \brief Global IO variables are now in a struct in order to be
    made threadsafe */
 struct io_context {
@@ -66,6 +74,8 @@ struct io_context {
 	unsigned int maxfdcnt;        /*!< Maximum available fd */
 	int current_ioc;              /*!< Currently used io callback */
 	int needshrink;               /*!< Whether something has been deleted */
+	int epfd;                     /*!< epoll instance, or -1 to poll() the fds array */
+	unsigned int gen;             /*!< Generation of the last entry added */
 };
 
 /*! \brief Create an I/O context */
@@ -80,12 +90,25 @@ struct io_context *io_context_create(void)
 	tmp->fdcnt = 0;
 	tmp->maxfdcnt = GROW_SHRINK_SIZE/2;
 	tmp->current_ioc = -1;
+	tmp->gen = 0;
+#ifdef IO_EPOLL
+	/* The fds array is still kept up to date, for tris_io_dump() and in
+	   case this falls back to poll() */
+	if ((tmp->epfd = epoll_create(GROW_SHRINK_SIZE)) < 0)
+		tris_log(LOG_WARNING, "Unable to create epoll instance, using poll(): %s\n", strerror(errno));
+#else
+	tmp->epfd = -1;
+#endif
 	
 	if (!(tmp->fds = tris_calloc(1, (GROW_SHRINK_SIZE / 2) * sizeof(*tmp->fds)))) {
+		if (tmp->epfd > -1)
+			close(tmp->epfd);
 		tris_free(tmp);
 		tmp = NULL;
 	} else {
 		if (!(tmp->ior = tris_calloc(1, (GROW_SHRINK_SIZE / 2) * sizeof(*tmp->ior)))) {
+			if (tmp->epfd > -1)
+				close(tmp->epfd);
 			tris_free(tmp->fds);
 			tris_free(tmp);
 			tmp = NULL;
@@ -102,6 +125,8 @@ void io_context_destroy(struct io_context *ioc)
 		tris_free(ioc->fds);
 	if (ioc->ior)
 		tris_free(ioc->ior);
+	if (ioc->epfd > -1)
+		close(ioc->epfd);
 
 	tris_free(ioc);
 }
@@ -144,6 +169,63 @@ static int io_grow(struct io_context *ioc)
 	return 0;
 }
 
+#ifdef IO_EPOLL
+/*! \brief
+ * Whether an entry other than skip watches fd.  This happens when an fd was
+ * closed and its number reused before the old entry was removed; the
+ * kernel dropped the old registration on close, and the one left belongs
+ * to the new entry.
+ */
+static int io_fd_shared(struct io_context *ioc, int fd, int skip)
+{
+	int x;
+
+	for (x = 0; x < ioc->fdcnt; x++) {
+		if (x != skip && ioc->ior[x].id && ioc->fds[x].fd == fd)
+			return 1;
+	}
+
+	return 0;
+}
+
+/*! \brief
+ * Add, change or delete the epoll registration of entry x.
+ * The slot and generation of the entry are registered, entries don't move
+ * with epoll (see io_shrink()).  A registration can outlive its entry, when
+ * the DEL is skipped or fails, so nothing freed by tris_io_remove() is
+ * registered.
+ * \return 0 on success or -1 on failure
+ */
+static int io_epoll_ctl(struct io_context *ioc, int op, int x)
+{
+	struct epoll_event ev = {
+		.events = (unsigned short) ioc->fds[x].events,
+		.data.u64 = ((uint64_t) ioc->ior[x].gen << 32) | (unsigned int) x,
+	};
+
+	if (ioc->epfd < 0 || ioc->fds[x].fd < 0)
+		return 0;
+
+	if (op == EPOLL_CTL_DEL) {
+		/* Fails if the fd is already closed, which is fine */
+		if (!io_fd_shared(ioc, ioc->fds[x].fd, x))
+			epoll_ctl(ioc->epfd, op, ioc->fds[x].fd, &ev);
+		return 0;
+	}
+
+	/* A changed fd may have been closed and reopened under the same number,
+	   which dropped it from the epoll instance */
+	if (epoll_ctl(ioc->epfd, op, ioc->fds[x].fd, &ev) &&
+		(op != EPOLL_CTL_MOD || errno != ENOENT || epoll_ctl(ioc->epfd, EPOLL_CTL_ADD, ioc->fds[x].fd, &ev))) {
+		tris_log(LOG_WARNING, "Unable to %s fd %d in epoll instance: %s\n",
+			op == EPOLL_CTL_ADD ? "add" : "change", ioc->fds[x].fd, strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+#endif
+
 /*! \brief
  * Add a new I/O entry for this file descriptor
  * with the given event mask, to call callback with
@@ -153,10 +235,18 @@ static int io_grow(struct io_context *ioc)
 int *tris_io_add(struct io_context *ioc, int fd, tris_io_cb callback, short events, void *data)
 {
 	int *ret;
+	unsigned int x = ioc->fdcnt;
 
 	DEBUG(tris_debug(1, "tris_io_add()\n"));
 
-	if (ioc->fdcnt >= ioc->maxfdcnt) {
+#ifdef IO_EPOLL
+	/* Entries don't move with epoll, reuse a slot that was removed */
+	if (ioc->epfd > -1) {
+		for (x = 0; x < ioc->fdcnt && ioc->ior[x].id; x++);
+	}
+#endif
+
+	if (x == ioc->fdcnt && ioc->fdcnt >= ioc->maxfdcnt) {
 		/* 
 		 * We don't have enough space for this entry.  We need to
 		 * reallocate maxfdcnt poll fd's and io_rec's, or back out now.
@@ -170,30 +260,53 @@ int *tris_io_add(struct io_context *ioc, int fd, tris_io_cb callback, short even
 	 * and we can make an entry for it in the pollfd and io_r
 	 * structures.
 	 */
-	ioc->fds[ioc->fdcnt].fd = fd;
-	ioc->fds[ioc->fdcnt].events = events;
-	ioc->fds[ioc->fdcnt].revents = 0;
-	ioc->ior[ioc->fdcnt].callback = callback;
-	ioc->ior[ioc->fdcnt].data = data;
-
-	if (!(ioc->ior[ioc->fdcnt].id = tris_malloc(sizeof(*ioc->ior[ioc->fdcnt].id)))) {
+	ioc->fds[x].fd = fd;
+	ioc->fds[x].events = events;
+	ioc->fds[x].revents = 0;
+	ioc->ior[x].callback = callback;
+	ioc->ior[x].data = data;
+	ioc->ior[x].gen = ++ioc->gen;
+
+	if (!(ioc->ior[x].id = tris_malloc(sizeof(*ioc->ior[x].id)))) {
 		/* Bonk if we couldn't allocate an int */
+		ioc->fds[x].fd = -1;
 		return NULL;
 	}
 
-	*(ioc->ior[ioc->fdcnt].id) = ioc->fdcnt;
-	ret = ioc->ior[ioc->fdcnt].id;
-	ioc->fdcnt++;
+	*(ioc->ior[x].id) = x;
+	ret = ioc->ior[x].id;
+#ifdef IO_EPOLL
+	if (io_epoll_ctl(ioc, EPOLL_CTL_ADD, x)) {
+		tris_free(ioc->ior[x].id);
+		ioc->ior[x].id = NULL;
+		ioc->fds[x].fd = -1;
+		return NULL;
+	}
+#endif
+	if (x == ioc->fdcnt)
+		ioc->fdcnt++;
 
 	return ret;
 }
 
 int *tris_io_change(struct io_context *ioc, int *id, int fd, tris_io_cb callback, short events, void *data)
 {
+#ifdef IO_EPOLL
+	int rereg;
+#endif
+
 	/* If this id exceeds our file descriptor count it doesn't exist here */
 	if (*id > ioc->fdcnt)
 		return NULL;
 
+#ifdef IO_EPOLL
+	/* Whenever an fd is passed it is registered again, even with the same
+	   number, as it may be a new socket in place of a closed one */
+	rereg = fd > -1 || (events && events != ioc->fds[*id].events);
+	if (fd > -1 && fd != ioc->fds[*id].fd)
+		io_epoll_ctl(ioc, EPOLL_CTL_DEL, *id);
+#endif
+
 	if (fd > -1)
 		ioc->fds[*id].fd = fd;
 	if (callback)
@@ -203,6 +316,11 @@ int *tris_io_change(struct io_context *ioc, int *id, int fd, tris_io_cb callback
 	if (data)
 		ioc->ior[*id].data = data;
 
+#ifdef IO_EPOLL
+	if (rereg && io_epoll_ctl(ioc, EPOLL_CTL_MOD, *id))
+		return NULL;
+#endif
+
 	return id;
 }
 
@@ -210,6 +328,17 @@ static int io_shrink(struct io_context *ioc)
 {
 	int getfrom, putto = 0;
 
+#ifdef IO_EPOLL
+	/* The kernel reports entries by slot, so they stay where they are.  Only
+	   trim the unused slots at the end, tris_io_add() reuses the others. */
+	if (ioc->epfd > -1) {
+		while (ioc->fdcnt && !ioc->ior[ioc->fdcnt - 1].id)
+			ioc->fdcnt--;
+		ioc->needshrink = 0;
+		return 0;
+	}
+#endif
+
 	/* 
 	 * Bring the fields from the very last entry to cover over
 	 * the entry we are removing, then decrease the size of the 
@@ -244,9 +373,13 @@ int tris_io_remove(struct io_context *ioc, int *_id)
 
 	for (x = 0; x < ioc->fdcnt; x++) {
 		if (ioc->ior[x].id == _id) {
+#ifdef IO_EPOLL
+			io_epoll_ctl(ioc, EPOLL_CTL_DEL, x);
+#endif
 			/* Free the int immediately and set to NULL so we know it's unused now */
 			tris_free(ioc->ior[x].id);
 			ioc->ior[x].id = NULL;
+			ioc->fds[x].fd = -1;
 			ioc->fds[x].events = 0;
 			ioc->fds[x].revents = 0;
 			ioc->needshrink = 1;
@@ -261,6 +394,44 @@ int tris_io_remove(struct io_context *ioc, int *_id)
 	return -1;
 }
 
+#ifdef IO_EPOLL
+/*! \brief
+ * Wait on the epoll instance and call the callbacks of the entries
+ * the kernel reported, instead of scanning all of them
+ */
+static int io_epoll_wait(struct io_context *ioc, int howlong)
+{
+	struct epoll_event events[IO_EPOLL_EVENTS];
+	unsigned int x;
+	int res, i;
+
+	if ((res = epoll_wait(ioc->epfd, events, ARRAY_LEN(events), howlong)) <= 0) {
+		return res;
+	}
+
+	for (i = 0; i < res; i++) {
+		x = (unsigned int) events[i].data.u64;
+		/* Removed, maybe by an earlier callback, and maybe reused since.  The
+		   registration outlived the entry, see io_epoll_ctl(). */
+		if (x >= ioc->fdcnt || !ioc->ior[x].id || ioc->ior[x].gen != (unsigned int) (events[i].data.u64 >> 32))
+			continue;
+		ioc->current_ioc = *ioc->ior[x].id;
+		if (ioc->ior[x].callback) {
+			if (!ioc->ior[x].callback(ioc->ior[x].id, ioc->fds[x].fd, events[i].events, ioc->ior[x].data)) {
+				/* Time to delete them since they returned a 0 */
+				tris_io_remove(ioc, ioc->ior[x].id);
+			}
+		}
+		ioc->current_ioc = -1;
+	}
+
+	if (ioc->needshrink)
+		io_shrink(ioc);
+
+	return res;
+}
+#endif
+
 /*! \brief
  * Make the poll call, and call
  * the callbacks for anything that needs
@@ -272,6 +443,11 @@ int tris_io_wait(struct io_context *ioc, int howlong)
 
 	DEBUG(tris_debug(1, "tris_io_wait()\n"));
 
+#ifdef IO_EPOLL
+	if (ioc->epfd > -1)
+		return io_epoll_wait(ioc, howlong);
+#endif
+
 	if ((res = tris_poll(ioc->fds, ioc->fdcnt, howlong)) <= 0) {
 		return res;
 	}
@@ -308,11 +484,14 @@ void tris_io_dump(struct io_context *ioc)
 	 */
 	int x;
 
-	tris_debug(1, "Trismedia IO Dump: %d entries, %d max entries\n", ioc->fdcnt, ioc->maxfdcnt);
+	tris_debug(1, "Trismedia IO Dump: %d entries, %d max entries, %s backend\n",
+		ioc->fdcnt, ioc->maxfdcnt, ioc->epfd > -1 ? "epoll" : "poll");
 	tris_debug(1, "================================================\n");
 	tris_debug(1, "| ID    FD     Callback    Data        Events  |\n");
 	tris_debug(1, "+------+------+-----------+-----------+--------+\n");
 	for (x = 0; x < ioc->fdcnt; x++) {
+		if (!ioc->ior[x].id)
+			continue;
 		tris_debug(1, "| %.4d | %.4d | %p | %p | %.6x |\n", 
 				*ioc->ior[x].id,
 				ioc->fds[x].fd,
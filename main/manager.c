@@ -92,33 +92,40 @@ enum error_type {
 
 
 /*!
- * Linked list of events.
- * Global events are appended to the list by append_event().
- * The usecount is the number of stored pointers to the element,
- * excluding the list pointers. So an element that is only in
- * the list has a usecount of 0, not 1.
+ * Ring of the latest events.
+ * Global events are stored in the ring by append_event(), each with the
+ * next sequence number, in the slot for the sequence number modulo the
+ * size of the ring.  Events are astobj2 objects: the ring holds a reference
+ * to each event until its slot is reused, and sessions hold one while they
+ * send it, so nothing needs to be purged.
  *
- * Clients have a pointer to the last event processed, and for each
- * of these clients we track the usecount of the elements.
- * If we have a pointer to an entry in the list, it is safe to navigate
- * it forward because elements will not be deleted, but only appended.
- * The worst that can happen is seeing the pointer still NULL.
+ * Clients have the sequence number of the next event to send.  A client
+ * that falls behind by more than the ring holds skips the events that were
+ * overwritten, and gets an EventsDropped event with how many there were
+ * instead, so slow clients cannot make the queue grow without bounds.  The
+ * size of the ring is the eventbuffer option in manager.conf.
  *
- * When the usecount of an element drops to 0, and the element is the
- * first in the list, we can remove it. Removal is done within the
- * main thread, which is woken up for the purpose.
- *
- * For simplicity of implementation, we make sure the list is never empty.
+ * Events that no session has asked for are not stored at all.
  */
 struct eventqent {
-	int usecount;		/*!< # of clients who still need the event */
 	int category;
 	unsigned int seq;	/*!< sequence number */
-	TRIS_LIST_ENTRY(eventqent) eq_next;
 	char eventdata[1];	/*!< really variable size, allocated by append_event() */
 };
 
-static TRIS_LIST_HEAD_STATIC(all_events, eventqent);
+#define DEFAULT_EVENT_BUFFER	4096
+
+static struct {
+	struct eventqent **events;	/*!< size slots, by sequence number */
+	unsigned int size;		/*!< a power of two */
+	unsigned int count;		/*!< number of slots with an event */
+	unsigned int head;		/*!< sequence number of the next event */
+} event_ring;
+
+/*! \brief Protects event_ring and the event_cursor of the sessions */
+TRIS_MUTEX_DEFINE_STATIC(event_ring_lock);
+
+#define EVENTS_DROPPED_FMT	"Event: EventsDropped\r\nPrivilege: system,all\r\nCount: %u\r\n\r\n"
 
 static int displayconnects = 1;
 static int allowmultiplelogin = 1;
@@ -204,7 +211,7 @@ struct mansession_session {
 				/* we use the extra byte to add a '\0' and simplify parsing */
 	int inlen;		/*!< number of buffered bytes */
 	int send_events;	/*!<  XXX what ? */
-	struct eventqent *last_ev;	/*!< last event processed. */
+	unsigned int event_cursor;	/*!< sequence number of the next event to send */
 	int writetimeout;	/*!< Timeout for tris_carefulwrite() */
 	int pending_event;         /*!< Pending events indicator in case when waiting_thread is NULL */
 	TRIS_LIST_HEAD_NOLOCK(mansession_datastores, tris_datastore) datastores; /*!< Data stores on the session */
@@ -222,8 +229,6 @@ struct mansession {
 	int fd;
 };
 
-#define NEW_EVENT(m)	(TRIS_LIST_NEXT(m->session->last_ev, eq_next))
-
 static TRIS_LIST_HEAD_STATIC(sessions, mansession_session);
 
 /*! \brief user descriptor, as read from the config file.
@@ -290,14 +295,14 @@ static time_t __deb(time_t start, const char *msg)
 static void LOCK_EVENTS(void)
 {
 	time_t start = __deb(0, "about to lock events");
-	TRIS_LIST_LOCK(&all_events);
+	tris_mutex_lock(&event_ring_lock);
 	__deb(start, "done lock events");
 }
 
 static void UNLOCK_EVENTS(void)
 {
 	__deb(0, "about to unlock events");
-	TRIS_LIST_UNLOCK(&all_events);
+	tris_mutex_unlock(&event_ring_lock);
 }
 
 static void LOCK_SESS(void)
@@ -325,39 +330,89 @@ int check_webmanager_enabled()
 }
 
 /*!
- * Grab a reference to the last event, update usecount as needed.
- * Can handle a NULL pointer.
+ * Sequence number of the next event, where new sessions start.
  */
-static struct eventqent *grab_last(void)
+static unsigned int event_ring_head(void)
 {
-	struct eventqent *ret;
+	unsigned int head;
 
-	TRIS_LIST_LOCK(&all_events);
-	ret = TRIS_LIST_LAST(&all_events);
-	/* the list is never empty now, but may become so when
-	 * we optimize it in the future, so be prepared.
-	 */
-	if (ret)
-		tris_atomic_fetchadd_int(&ret->usecount, 1);
-	TRIS_LIST_UNLOCK(&all_events);
-	return ret;
+	tris_mutex_lock(&event_ring_lock);
+	head = event_ring.head;
+	tris_mutex_unlock(&event_ring_lock);
+	return head;
+}
+
+/*!
+ * Change the number of events kept, rounded up to a power of two,
+ * keeping the latest ones.
+ */
+static int event_ring_resize(unsigned int size)
+{
+	struct eventqent **events;
+	unsigned int seq, i;
+
+	for (i = 1; i < size; i <<= 1);
+	size = i;
+
+	tris_mutex_lock(&event_ring_lock);
+	if (size == event_ring.size) {
+		tris_mutex_unlock(&event_ring_lock);
+		return 0;
+	}
+	if (!(events = tris_calloc(size, sizeof(*events)))) {
+		tris_mutex_unlock(&event_ring_lock);
+		return -1;
+	}
+	event_ring.count = MIN(event_ring.count, size);
+	for (seq = event_ring.head - event_ring.count; seq != event_ring.head; seq++) {
+		events[seq & (size - 1)] = event_ring.events[seq & (event_ring.size - 1)];
+		event_ring.events[seq & (event_ring.size - 1)] = NULL;
+	}
+	for (i = 0; i < event_ring.size; i++) {
+		if (event_ring.events[i])
+			ao2_ref(event_ring.events[i], -1);
+	}
+	tris_free(event_ring.events);
+	event_ring.events = events;
+	event_ring.size = size;
+	tris_mutex_unlock(&event_ring_lock);
+
+	return 0;
 }
 
 /*!
- * Purge unused events. Remove elements from the head
- * as long as their usecount is 0 and there is a next element.
+ * Get a reference to the next event for the session, NULL if there is none.
+ * The number of events the session missed for being too far behind is
+ * added to dropped.
  */
-static void purge_events(void)
+static struct eventqent *next_event(struct mansession_session *session, unsigned int *dropped)
 {
-	struct eventqent *ev;
+	struct eventqent *eqe = NULL;
 
-	TRIS_LIST_LOCK(&all_events);
-	while ( (ev = TRIS_LIST_FIRST(&all_events)) &&
-	    ev->usecount == 0 && TRIS_LIST_NEXT(ev, eq_next)) {
-		TRIS_LIST_REMOVE_HEAD(&all_events, eq_next);
-		tris_free(ev);
+	tris_mutex_lock(&event_ring_lock);
+	if (session->event_cursor != event_ring.head) {
+		if (event_ring.head - session->event_cursor > event_ring.count) {
+			*dropped += event_ring.head - event_ring.count - session->event_cursor;
+			session->event_cursor = event_ring.head - event_ring.count;
+		}
+		if (session->event_cursor != event_ring.head) {
+			eqe = event_ring.events[session->event_cursor++ & (event_ring.size - 1)];
+			ao2_ref(eqe, +1);
+		}
 	}
-	TRIS_LIST_UNLOCK(&all_events);
+	tris_mutex_unlock(&event_ring_lock);
+
+	return eqe;
+}
+
+/*!
+ * Whether the session wants events of the category.
+ */
+static int session_wants_event(struct mansession_session *session, int category)
+{
+	return session->authenticated &&
+		(session->readperm & category) == category &&
+		(session->send_events & category) == category;
 }
 
 /*!
@@ -759,6 +814,7 @@ static char *handle_showmanconn(struct tris_cli_entry *e, int cmd, struct tris_c
 static char *handle_showmaneventq(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
 {
 	struct eventqent *s;
+	unsigned int seq;
 	switch (cmd) {
 	case CLI_INIT:
 		e->command = "manager show eventq";
@@ -770,13 +826,15 @@ static char *handle_showmaneventq(struct tris_cli_entry *e, int cmd, struct tris
 	case CLI_GENERATE:
 		return NULL;
 	}
-	TRIS_LIST_LOCK(&all_events);
-	TRIS_LIST_TRAVERSE(&all_events, s, eq_next) {
-		tris_cli(a->fd, "Usecount: %d\n", s->usecount);
+	tris_mutex_lock(&event_ring_lock);
+	tris_cli(a->fd, "%u of %u events kept, next sequence number %u\n", event_ring.count, event_ring.size, event_ring.head);
+	for (seq = event_ring.head - event_ring.count; seq != event_ring.head; seq++) {
+		s = event_ring.events[seq & (event_ring.size - 1)];
+		tris_cli(a->fd, "Sequence: %u\n", s->seq);
 		tris_cli(a->fd, "Category: %d\n", s->category);
 		tris_cli(a->fd, "Event:\n%s", s->eventdata);
 	}
-	TRIS_LIST_UNLOCK(&all_events);
+	tris_mutex_unlock(&event_ring_lock);
 
 	return CLI_SUCCESS;
 }
@@ -813,28 +871,10 @@ static struct tris_cli_entry cli_manager[] = {
 };
 
 /*
- * Decrement the usecount for the event; if it goes to zero,
- * (why check for e->next ?) wakeup the
- * main thread, which is in charge of freeing the record.
- * Returns the next record.
- */
-static struct eventqent *unref_event(struct eventqent *e)
-{
-	tris_atomic_fetchadd_int(&e->usecount, -1);
-	return TRIS_LIST_NEXT(e, eq_next);
-}
-
-static void ref_event(struct eventqent *e)
-{
-	tris_atomic_fetchadd_int(&e->usecount, 1);
-}
-
-/*
- * destroy a session, leaving the usecount
+ * destroy a session
  */
 static void free_session(struct mansession_session *session)
 {
-	struct eventqent *eqe = session->last_ev;
 	struct tris_datastore *datastore;
 
 	/* Get rid of each of the data stores on the session */
@@ -847,7 +887,6 @@ static void free_session(struct mansession_session *session)
 		fclose(session->f);
 	tris_mutex_destroy(&session->__lock);
 	tris_free(session);
-	unref_event(eqe);
 }
 
 static void destroy_session(struct mansession_session *session)
@@ -1639,7 +1678,7 @@ static int action_waitevent(struct mansession *s, const struct message *m)
 
 	for (x = 0; x < timeout || timeout < 0; x++) {
 		tris_mutex_lock(&s->session->__lock);
-		if (NEW_EVENT(s))
+		if (s->session->event_cursor != event_ring_head())
 			needexit = 1;
 		/* We can have multiple HTTP session point to the same mansession entry.
 		 * The way we deal with it is not very nice: newcomers kick out the previous
@@ -1663,14 +1702,18 @@ static int action_waitevent(struct mansession *s, const struct message *m)
 	tris_mutex_lock(&s->session->__lock);
 	if (s->session->waiting_thread == pthread_self()) {
 		struct eventqent *eqe;
+		unsigned int dropped = 0;
 		astman_send_response(s, m, "Success", "Waiting for Event completed.");
-		while ( (eqe = NEW_EVENT(s)) ) {
-			ref_event(eqe);
+		while ( (eqe = next_event(s->session, &dropped)) ) {
+			if (dropped) {
+				astman_append(s, EVENTS_DROPPED_FMT, dropped);
+				dropped = 0;
+			}
 			if (((s->session->readperm & eqe->category) == eqe->category) &&
 			    ((s->session->send_events & eqe->category) == eqe->category)) {
 				astman_append(s, "%s", eqe->eventdata);
 			}
-			s->session->last_ev = unref_event(s->session->last_ev);
+			ao2_ref(eqe, -1);
 		}
 		astman_append(s,
 			"Event: WaitEventComplete\r\n"
@@ -2315,7 +2358,7 @@ struct ftris_originate_helper {
 	/*! data can contain a channel name, extension number, username, password, etc. */
 	char data[512];
 	int timeout;
-	int format;				/*!< Codecs used for a call */
+	format_t format;			/*!< Codecs used for a call */
 	char app[TRIS_MAX_APP];
 	char appdata[TRIS_MAX_EXTENSION];
 	char cid_name[TRIS_MAX_EXTENSION];
@@ -2414,7 +2457,7 @@ static int action_originate(struct mansession *s, const struct message *m)
 	int reason = 0;
 	char tmp[256];
 	char tmp2[256];
-	int format = TRIS_FORMAT_SLINEAR;
+	format_t format = TRIS_FORMAT_SLINEAR;
 	pthread_t th;
 	struct in_addr ourip;
 	struct sockaddr_in bindaddr;
@@ -2767,16 +2810,25 @@ static int process_events(struct mansession *s)
 	tris_mutex_lock(&s->session->__lock);
 	if (s->session->f != NULL) {
 		struct eventqent *eqe;
+		unsigned int dropped = 0;
+
+		while ( (eqe = next_event(s->session, &dropped)) ) {
+			if (dropped) {
+				/* Too slow, tell the client what it missed instead */
+				if (!ret && s->session->authenticated && s->session->send_events) {
+					char buf[sizeof(EVENTS_DROPPED_FMT) + 10];
 
-		while ( (eqe = NEW_EVENT(s)) ) {
-			ref_event(eqe);
-			if (!ret && s->session->authenticated &&
-			    (s->session->readperm & eqe->category) == eqe->category &&
-			    (s->session->send_events & eqe->category) == eqe->category) {
+					snprintf(buf, sizeof(buf), EVENTS_DROPPED_FMT, dropped);
+					if (send_string(s, buf) < 0)
+						ret = -1;
+				}
+				dropped = 0;
+			}
+			if (!ret && session_wants_event(s->session, eqe->category)) {
 				if (send_string(s, eqe->eventdata) < 0)
 					ret = -1;	// don't send more 
 			}
-			s->session->last_ev = unref_event(s->session->last_ev);
+			ao2_ref(eqe, -1);
 		}
 	}
 	tris_mutex_unlock(&s->session->__lock);
@@ -3306,7 +3358,7 @@ static void *session_do(void *data)
 	tris_mutex_init(&session->__lock);
 	session->send_events = -1;
 	/* Hook to the tail of the event queue */
-	session->last_ev = grab_last();
+	session->event_cursor = event_ring_head();
 
 	/* these fields duplicate those in the 'ser' structure */
 	session->fd = ser->fd;
@@ -3383,29 +3435,23 @@ static void purge_sessions(int n_max)
 }
 
 /*
- * events are appended to a queue from where they
- * can be dispatched to clients.
+ * events are stored in the ring from where they
+ * can be dispatched to clients, replacing the oldest one.
+ * Called with event_ring_lock held.
  */
-static int append_event(const char *str, int category)
+static struct eventqent *append_event(struct eventqent *tmp)
 {
-	struct eventqent *tmp = tris_malloc(sizeof(*tmp) + strlen(str));
-	static int seq;	/* sequence number */
-
-	if (!tmp)
-		return -1;
+	struct eventqent **slot;
+	struct eventqent *old;
 
-	/* need to init all fields, because tris_malloc() does not */
-	tmp->usecount = 0;
-	tmp->category = category;
-	tmp->seq = tris_atomic_fetchadd_int(&seq, 1);
-	TRIS_LIST_NEXT(tmp, eq_next) = NULL;
-	strcpy(tmp->eventdata, str);
+	tmp->seq = event_ring.head++;
+	slot = &event_ring.events[tmp->seq & (event_ring.size - 1)];
+	old = *slot;
+	*slot = tmp;
+	if (event_ring.count < event_ring.size)
+		event_ring.count++;
 
-	TRIS_LIST_LOCK(&all_events);
-	TRIS_LIST_INSERT_TAIL(&all_events, tmp, eq_next);
-	TRIS_LIST_UNLOCK(&all_events);
-
-	return 0;
+	return old;
 }
 
 /* XXX see if can be moved inside the function */
@@ -3423,9 +3469,22 @@ int __manager_event(int category, const char *event,
 	va_list ap;
 	struct timeval now;
 	struct tris_str *buf;
+	struct eventqent *eqe = NULL, *old = NULL;
+	int wanted = 0;
 
-	/* Abort if there are neither any manager sessions nor hooks */
-	if (!num_sessions && TRIS_RWLIST_EMPTY(&manager_hooks))
+	if (num_sessions) {
+		TRIS_LIST_LOCK(&sessions);
+		TRIS_LIST_TRAVERSE(&sessions, session, list) {
+			if (session_wants_event(session, category)) {
+				wanted = 1;
+				break;
+			}
+		}
+		TRIS_LIST_UNLOCK(&sessions);
+	}
+
+	/* Abort if there are neither any manager sessions that want it nor hooks */
+	if (!wanted && TRIS_RWLIST_EMPTY(&manager_hooks))
 		return 0;
 
 	if (!(buf = tris_str_thread_get(&manager_event_buf, MANAGER_EVENT_BUF_INITSIZE)))
@@ -3457,12 +3516,26 @@ int __manager_event(int category, const char *event,
 
 	tris_str_append(&buf, 0, "\r\n");
 
-	append_event(tris_str_buffer(buf), category);
+	if (wanted && event_ring.size && (eqe = ao2_alloc(sizeof(*eqe) + tris_str_strlen(buf), NULL))) {
+		eqe->category = category;
+		strcpy(eqe->eventdata, tris_str_buffer(buf));
 
-	if (num_sessions) {
-		/* Wake up any sleeping sessions */
 		TRIS_LIST_LOCK(&sessions);
+		tris_mutex_lock(&event_ring_lock);
+		old = append_event(eqe);
+		/* Sessions that do not want it and had nothing left to send need
+		 * not look at it, nor count it as dropped later.
+		 */
+		TRIS_LIST_TRAVERSE(&sessions, session, list) {
+			if (session->event_cursor == eqe->seq && !session_wants_event(session, category))
+				session->event_cursor++;
+		}
+		tris_mutex_unlock(&event_ring_lock);
+
+		/* Wake up any sleeping sessions that want it */
 		TRIS_LIST_TRAVERSE(&sessions, session, list) {
+			if (!session_wants_event(session, category))
+				continue;
 			tris_mutex_lock(&session->__lock);
 			if (session->waiting_thread != TRIS_PTHREADT_NULL)
 				pthread_kill(session->waiting_thread, SIGURG);
@@ -3476,6 +3549,9 @@ int __manager_event(int category, const char *event,
 			tris_mutex_unlock(&session->__lock);
 		}
 		TRIS_LIST_UNLOCK(&sessions);
+
+		if (old)
+			ao2_ref(old, -1);
 	}
 
 	if (!TRIS_RWLIST_EMPTY(&manager_hooks)) {
@@ -3961,7 +4037,7 @@ static struct tris_str *generic_http_callback(enum output_format format,
 		 * won't happen twice in a row.
 		 */
 		while ((session->managerid = tris_random() ^ (unsigned long) session) == 0);
-		session->last_ev = grab_last();
+		session->event_cursor = event_ring_head();
 		TRIS_LIST_HEAD_INIT_NOLOCK(&session->datastores);
 		TRIS_LIST_LOCK(&sessions);
 		TRIS_LIST_INSERT_HEAD(&sessions, session, list);
@@ -4149,7 +4225,6 @@ static int webregged = 0;
 static void purge_old_stuff(void *data)
 {
 	purge_sessions(1);
-	purge_events();
 }
 
 struct tris_tls_config ami_tls_cfg;
@@ -4180,6 +4255,7 @@ static int __init_manager(int reload)
 	const char *val;
 	char *cat = NULL;
 	int newhttptimeout = 60;
+	int neweventbuffer = DEFAULT_EVENT_BUFFER;
 	int have_sslbindaddr = 0;
 	struct hostent *hp;
 	struct tris_hostent ahp;
@@ -4229,8 +4305,7 @@ static int __init_manager(int reload)
 		tris_cli_register_multiple(cli_manager, ARRAY_LEN(cli_manager));
 		tris_extension_state_add(NULL, NULL, manager_state_cb, NULL);
 		registered = 1;
-		/* Append placeholder event so master_eventq never runs dry */
-		append_event("Event: Placeholder\r\n\r\n", 0);
+		event_ring_resize(DEFAULT_EVENT_BUFFER);
 	}
 	if ((cfg = tris_config_load2("manager.conf", "manager", config_flags)) == CONFIG_STATUS_FILEUNCHANGED)
 		return 0;
@@ -4297,6 +4372,11 @@ static int __init_manager(int reload)
 			manager_debug = tris_true(val);
 		} else if (!strcasecmp(var->name, "httptimeout")) {
 			newhttptimeout = atoi(val);
+		} else if (!strcasecmp(var->name, "eventbuffer")) {
+			if (sscanf(val, "%30d", &neweventbuffer) != 1 || neweventbuffer < 1) {
+				tris_log(LOG_WARNING, "Invalid eventbuffer '%s', using %d\n", val, DEFAULT_EVENT_BUFFER);
+				neweventbuffer = DEFAULT_EVENT_BUFFER;
+			}
 		} else {
 			tris_log(LOG_NOTICE, "Invalid keyword <%s> = <%s> in manager.conf [general]\n",
 				var->name, val);
@@ -4483,6 +4563,8 @@ static int __init_manager(int reload)
 	if (newhttptimeout > 0)
 		httptimeout = newhttptimeout;
 
+	event_ring_resize(neweventbuffer);
+
 	manager_event(EVENT_FLAG_SYSTEM, "Reload", "Module: Manager\r\nStatus: %s\r\nMessage: Manager reload Requested\r\n", manager_enabled ? "Enabled" : "Disabled");
 
 	tris_tcptls_server_start(&ami_desc);
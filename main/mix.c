@@ -0,0 +1,406 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 2009, Digium, Inc.
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ *
+ * \brief Signed linear audio mixing
+ *
+ * Every operation has a portable kernel, and on x86 also SSE2 and AVX2
+ * kernels built with the target attribute, so no special compiler flags
+ * are needed.  tris_mix_init() picks the widest kernels the CPU supports.
+ */
+
+#include "trismedia.h"
+
+TRISMEDIA_FILE_VERSION(__FILE__, "$Revision$")
+
+#include "trismedia/mix.h"
+#include "trismedia/utils.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+	((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9) || defined(__clang__))
+#define MIX_X86
+#include <immintrin.h>
+#endif
+
+#define MIX_MAX 32767
+#define MIX_MIN -32767
+
+struct mix_kernels {
+	const char *name;
+	void (*add)(short *dst, const short *src, int samples);
+	void (*subtract)(short *dst, const short *src, int samples);
+	void (*accumulate)(int *acc, const short *src, int samples);
+	void (*minus)(short *dst, const int *acc, const short *own, int samples);
+	void (*multiply)(short *buf, int samples, short factor);
+	void (*divide)(short *buf, int samples, short divisor);
+};
+
+static force_inline short mix_saturate(int res)
+{
+	if (res > MIX_MAX)
+		return MIX_MAX;
+	else if (res < MIX_MIN)
+		return MIX_MIN;
+	return res;
+}
+
+static void generic_add(short *dst, const short *src, int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		dst[i] = mix_saturate(dst[i] + src[i]);
+}
+
+static void generic_subtract(short *dst, const short *src, int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		dst[i] = mix_saturate(dst[i] - src[i]);
+}
+
+static void generic_accumulate(int *acc, const short *src, int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		acc[i] += src[i];
+}
+
+static void generic_minus(short *dst, const int *acc, const short *own, int samples)
+{
+	int i;
+
+	if (own) {
+		for (i = 0; i < samples; i++)
+			dst[i] = mix_saturate(acc[i] - own[i]);
+	} else {
+		for (i = 0; i < samples; i++)
+			dst[i] = mix_saturate(acc[i]);
+	}
+}
+
+static void generic_multiply(short *buf, int samples, short factor)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		buf[i] = mix_saturate(buf[i] * factor);
+}
+
+static void generic_divide(short *buf, int samples, short divisor)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		buf[i] /= divisor;
+}
+
+static const struct mix_kernels generic_kernels = {
+	.name = "generic",
+	.add = generic_add,
+	.subtract = generic_subtract,
+	.accumulate = generic_accumulate,
+	.minus = generic_minus,
+	.multiply = generic_multiply,
+	.divide = generic_divide,
+};
+
+#ifdef MIX_X86
+/*
+ * The saturating instructions clamp at -32768, so results are clamped once
+ * more to -32767 to match the portable kernels.
+ *
+ * Division goes through double precision, which is exact for every 16 bit
+ * dividend and divisor, so truncating the quotient gives the same result as
+ * integer division.
+ */
+
+#define SSE2 __attribute__((target("sse2")))
+
+static SSE2 void sse2_add(short *dst, const short *src, int samples)
+{
+	const __m128i min = _mm_set1_epi16(MIX_MIN);
+	int i;
+
+	for (i = 0; i + 8 <= samples; i += 8) {
+		__m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+		__m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_max_epi16(_mm_adds_epi16(d, s), min));
+	}
+	generic_add(dst + i, src + i, samples - i);
+}
+
+static SSE2 void sse2_subtract(short *dst, const short *src, int samples)
+{
+	const __m128i min = _mm_set1_epi16(MIX_MIN);
+	int i;
+
+	for (i = 0; i + 8 <= samples; i += 8) {
+		__m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+		__m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_max_epi16(_mm_subs_epi16(d, s), min));
+	}
+	generic_subtract(dst + i, src + i, samples - i);
+}
+
+static SSE2 void sse2_accumulate(int *acc, const short *src, int samples)
+{
+	int i;
+
+	for (i = 0; i + 8 <= samples; i += 8) {
+		__m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+		/* Sign extend by placing each sample in the top half and shifting down */
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+		__m128i a0 = _mm_loadu_si128((const __m128i *) (acc + i));
+		__m128i a1 = _mm_loadu_si128((const __m128i *) (acc + i + 4));
+
+		_mm_storeu_si128((__m128i *) (acc + i), _mm_add_epi32(a0, lo));
+		_mm_storeu_si128((__m128i *) (acc + i + 4), _mm_add_epi32(a1, hi));
+	}
+	generic_accumulate(acc + i, src + i, samples - i);
+}
+
+static SSE2 void sse2_minus(short *dst, const int *acc, const short *own, int samples)
+{
+	const __m128i min = _mm_set1_epi16(MIX_MIN);
+	int i;
+
+	for (i = 0; i + 8 <= samples; i += 8) {
+		__m128i a0 = _mm_loadu_si128((const __m128i *) (acc + i));
+		__m128i a1 = _mm_loadu_si128((const __m128i *) (acc + i + 4));
+
+		if (own) {
+			__m128i o = _mm_loadu_si128((const __m128i *) (own + i));
+
+			a0 = _mm_sub_epi32(a0, _mm_srai_epi32(_mm_unpacklo_epi16(o, o), 16));
+			a1 = _mm_sub_epi32(a1, _mm_srai_epi32(_mm_unpackhi_epi16(o, o), 16));
+		}
+		_mm_storeu_si128((__m128i *) (dst + i), _mm_max_epi16(_mm_packs_epi32(a0, a1), min));
+	}
+	generic_minus(dst + i, acc + i, own ? own + i : NULL, samples - i);
+}
+
+static SSE2 void sse2_multiply(short *buf, int samples, short factor)
+{
+	const __m128i min = _mm_set1_epi16(MIX_MIN);
+	const __m128i f = _mm_set1_epi16(factor);
+	int i;
+
+	for (i = 0; i + 8 <= samples; i += 8) {
+		__m128i b = _mm_loadu_si128((const __m128i *) (buf + i));
+		__m128i lo = _mm_mullo_epi16(b, f);
+		__m128i hi = _mm_mulhi_epi16(b, f);
+		__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+		__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+		_mm_storeu_si128((__m128i *) (buf + i), _mm_max_epi16(_mm_packs_epi32(p0, p1), min));
+	}
+	generic_multiply(buf + i, samples - i, factor);
+}
+
+static SSE2 void sse2_divide(short *buf, int samples, short divisor)
+{
+	const __m128d d = _mm_set1_pd(divisor);
+	int i;
+
+	for (i = 0; i + 8 <= samples; i += 8) {
+		__m128i b = _mm_loadu_si128((const __m128i *) (buf + i));
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(b, b), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(b, b), 16);
+		__m128i q0 = _mm_unpacklo_epi64(
+			_mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(lo), d)),
+			_mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(lo, 8)), d)));
+		__m128i q1 = _mm_unpacklo_epi64(
+			_mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(hi), d)),
+			_mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(hi, 8)), d)));
+
+		_mm_storeu_si128((__m128i *) (buf + i), _mm_packs_epi32(q0, q1));
+	}
+	generic_divide(buf + i, samples - i, divisor);
+}
+
+static const struct mix_kernels sse2_kernels = {
+	.name = "sse2",
+	.add = sse2_add,
+	.subtract = sse2_subtract,
+	.accumulate = sse2_accumulate,
+	.minus = sse2_minus,
+	.multiply = sse2_multiply,
+	.divide = sse2_divide,
+};
+
+#define AVX2 __attribute__((target("avx2")))
+
+static AVX2 void avx2_add(short *dst, const short *src, int samples)
+{
+	const __m256i min = _mm256_set1_epi16(MIX_MIN);
+	int i;
+
+	for (i = 0; i + 16 <= samples; i += 16) {
+		__m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+		__m256i s = _mm256_loadu_si256((const __m256i *) (src + i));
+
+		_mm256_storeu_si256((__m256i *) (dst + i), _mm256_max_epi16(_mm256_adds_epi16(d, s), min));
+	}
+	generic_add(dst + i, src + i, samples - i);
+}
+
+static AVX2 void avx2_subtract(short *dst, const short *src, int samples)
+{
+	const __m256i min = _mm256_set1_epi16(MIX_MIN);
+	int i;
+
+	for (i = 0; i + 16 <= samples; i += 16) {
+		__m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+		__m256i s = _mm256_loadu_si256((const __m256i *) (src + i));
+
+		_mm256_storeu_si256((__m256i *) (dst + i), _mm256_max_epi16(_mm256_subs_epi16(d, s), min));
+	}
+	generic_subtract(dst + i, src + i, samples - i);
+}
+
+static AVX2 void avx2_accumulate(int *acc, const short *src, int samples)
+{
+	int i;
+
+	for (i = 0; i + 8 <= samples; i += 8) {
+		__m256i s = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) (src + i)));
+		__m256i a = _mm256_loadu_si256((const __m256i *) (acc + i));
+
+		_mm256_storeu_si256((__m256i *) (acc + i), _mm256_add_epi32(a, s));
+	}
+	generic_accumulate(acc + i, src + i, samples - i);
+}
+
+static AVX2 void avx2_minus(short *dst, const int *acc, const short *own, int samples)
+{
+	const __m256i min = _mm256_set1_epi16(MIX_MIN);
+	int i;
+
+	for (i = 0; i + 16 <= samples; i += 16) {
+		__m256i a0 = _mm256_loadu_si256((const __m256i *) (acc + i));
+		__m256i a1 = _mm256_loadu_si256((const __m256i *) (acc + i + 8));
+		__m256i res;
+
+		if (own) {
+			a0 = _mm256_sub_epi32(a0, _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) (own + i))));
+			a1 = _mm256_sub_epi32(a1, _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) (own + i + 8))));
+		}
+		/* Packing works within each 128 bit lane, put the quarters back in order */
+		res = _mm256_permute4x64_epi64(_mm256_packs_epi32(a0, a1), 0xd8);
+		_mm256_storeu_si256((__m256i *) (dst + i), _mm256_max_epi16(res, min));
+	}
+	generic_minus(dst + i, acc + i, own ? own + i : NULL, samples - i);
+}
+
+static AVX2 void avx2_multiply(short *buf, int samples, short factor)
+{
+	const __m256i min = _mm256_set1_epi16(MIX_MIN);
+	const __m256i f = _mm256_set1_epi16(factor);
+	int i;
+
+	for (i = 0; i + 16 <= samples; i += 16) {
+		__m256i b = _mm256_loadu_si256((const __m256i *) (buf + i));
+		__m256i lo = _mm256_mullo_epi16(b, f);
+		__m256i hi = _mm256_mulhi_epi16(b, f);
+		/* Unpacking and packing both work within lanes, so the order is kept */
+		__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+		__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+
+		_mm256_storeu_si256((__m256i *) (buf + i), _mm256_max_epi16(_mm256_packs_epi32(p0, p1), min));
+	}
+	generic_multiply(buf + i, samples - i, factor);
+}
+
+static AVX2 void avx2_divide(short *buf, int samples, short divisor)
+{
+	const __m256d d = _mm256_set1_pd(divisor);
+	int i;
+
+	for (i = 0; i + 8 <= samples; i += 8) {
+		__m128i b = _mm_loadu_si128((const __m128i *) (buf + i));
+		__m256i w = _mm256_cvtepi16_epi32(b);
+		__m128i q0 = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(w)), d));
+		__m128i q1 = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(w, 1)), d));
+
+		_mm_storeu_si128((__m128i *) (buf + i), _mm_packs_epi32(q0, q1));
+	}
+	generic_divide(buf + i, samples - i, divisor);
+}
+
+static const struct mix_kernels avx2_kernels = {
+	.name = "avx2",
+	.add = avx2_add,
+	.subtract = avx2_subtract,
+	.accumulate = avx2_accumulate,
+	.minus = avx2_minus,
+	.multiply = avx2_multiply,
+	.divide = avx2_divide,
+};
+#endif /* MIX_X86 */
+
+static const struct mix_kernels *kernels = &generic_kernels;
+
+void tris_mix_add(short *dst, const short *src, int samples)
+{
+	kernels->add(dst, src, samples);
+}
+
+void tris_mix_subtract(short *dst, const short *src, int samples)
+{
+	kernels->subtract(dst, src, samples);
+}
+
+void tris_mix_accumulate(int *acc, const short *src, int samples)
+{
+	kernels->accumulate(acc, src, samples);
+}
+
+void tris_mix_minus(short *dst, const int *acc, const short *own, int samples)
+{
+	kernels->minus(dst, acc, own, samples);
+}
+
+void tris_mix_gain(short *buf, int samples, int adjustment)
+{
+	if (adjustment > 0)
+		kernels->multiply(buf, samples, adjustment);
+	else if (adjustment < 0)
+		kernels->divide(buf, samples, -adjustment);
+}
+
+const char *tris_mix_kernel(void)
+{
+	return kernels->name;
+}
+
+void tris_mix_init(void)
+{
+#ifdef MIX_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		kernels = &avx2_kernels;
+	else if (__builtin_cpu_supports("sse2"))
+		kernels = &sse2_kernels;
+#endif
+	tris_verb(2, "Using %s audio mixing kernels\n", kernels->name);
+}
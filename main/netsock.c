@@ -295,3 +295,238 @@ int tris_eid_cmp(const struct tris_eid *eid1, const struct tris_eid *eid2)
 {
 	return memcmp(eid1, eid2, sizeof(*eid1));
 }
+
+struct tris_udp_batch {
+	int size;			/*!< Max amount of datagrams per system call */
+	size_t mtu;			/*!< Size of each datagram slot in buf */
+	int count;			/*!< Datagrams read ahead, or queued to be sent */
+	int next;			/*!< Next read ahead datagram to hand out */
+	int fd;				/*!< Socket the queued datagrams are for */
+	int overflowed;			/*!< Last read ahead datagram that spilled into overflow, 0 if none */
+#if defined(MSG_WAITFORONE)
+	struct mmsghdr *msgs;
+	struct iovec *iov;		/*!< Two per datagram, its slot and the overflow buffer */
+#endif
+	struct sockaddr_in *addr;
+	unsigned char *buf;
+	unsigned char *overflow;	/*!< Shared by the read ahead datagrams, for what does not fit a slot */
+	size_t overflowlen;
+};
+
+/*! \brief Set when the kernel turned out not to have recvmmsg()/sendmmsg() */
+static int udp_batch_unsupported;
+
+struct tris_udp_batch *tris_udp_batch_alloc(int size, size_t mtu)
+{
+#if defined(MSG_WAITFORONE)
+	struct tris_udp_batch *batch;
+	int i;
+
+	if (size < 2 || udp_batch_unsupported)
+		return NULL;
+	if (size > TRIS_UDP_BATCH_MAX)
+		size = TRIS_UDP_BATCH_MAX;
+
+	if (!(batch = tris_calloc(1, sizeof(*batch) + size * (sizeof(*batch->msgs) + 2 * sizeof(*batch->iov) + sizeof(*batch->addr) + mtu))))
+		return NULL;
+
+	batch->size = size;
+	batch->mtu = mtu;
+	batch->msgs = (struct mmsghdr *) (batch + 1);
+	batch->iov = (struct iovec *) (batch->msgs + size);
+	batch->addr = (struct sockaddr_in *) (batch->iov + 2 * size);
+	batch->buf = (unsigned char *) (batch->addr + size);
+
+	for (i = 0; i < size; i++) {
+		batch->iov[2 * i].iov_base = batch->buf + i * mtu;
+		batch->iov[2 * i].iov_len = mtu;
+		batch->msgs[i].msg_hdr.msg_name = &batch->addr[i];
+		batch->msgs[i].msg_hdr.msg_namelen = sizeof(batch->addr[i]);
+		batch->msgs[i].msg_hdr.msg_iov = &batch->iov[2 * i];
+		batch->msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	return batch;
+#else
+	return NULL;
+#endif
+}
+
+void tris_udp_batch_free(struct tris_udp_batch *batch)
+{
+	if (batch) {
+		if (batch->overflow)
+			tris_free(batch->overflow);
+		tris_free(batch);
+	}
+}
+
+int tris_udp_batch_size(const struct tris_udp_batch *batch)
+{
+	return batch ? batch->size : 0;
+}
+
+int tris_udp_batch_pending(const struct tris_udp_batch *batch)
+{
+	return batch ? batch->count - batch->next : 0;
+}
+
+ssize_t tris_udp_batch_recvfrom(struct tris_udp_batch *batch, int fd, void *buf, size_t len,
+	struct sockaddr_in *sin, struct tris_udp_batch_stats *stats)
+{
+	socklen_t sinlen = sizeof(*sin);
+	ssize_t res;
+#if defined(MSG_WAITFORONE)
+	int i, count;
+
+	/* Hand out what was read ahead first.  A datagram larger than a slot went
+	   on in the overflow buffer, which only the last such datagram still has. */
+	while (batch && batch->next < batch->count) {
+		i = batch->next++;
+		if ((batch->msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ||
+			(batch->msgs[i].msg_len > batch->mtu && i != batch->overflowed)) {
+			tris_log(LOG_NOTICE, "Dropping datagram from %s:%d, %d bytes read ahead with another one larger than %d bytes\n",
+				tris_inet_ntoa(batch->addr[i].sin_addr), ntohs(batch->addr[i].sin_port), (int) batch->msgs[i].msg_len, (int) batch->mtu);
+			if (stats)
+				tris_atomic_fetchadd_int(&stats->rxdropped, 1);
+			continue;
+		}
+		res = MIN(batch->msgs[i].msg_len, len);
+		memcpy(buf, batch->buf + i * batch->mtu, MIN(res, batch->mtu));
+		if (res > batch->mtu)
+			memcpy((unsigned char *) buf + batch->mtu, batch->overflow, res - batch->mtu);
+		memcpy(sin, &batch->addr[i], sizeof(*sin));
+		return res;
+	}
+
+	if (batch && !udp_batch_unsupported) {
+		/* Room for a datagram as large as the caller takes, behind any slot */
+		if (batch->overflowlen < len - MIN(len, batch->mtu)) {
+			if (batch->overflow)
+				tris_free(batch->overflow);
+			batch->overflowlen = (batch->overflow = tris_malloc(len - batch->mtu)) ? len - batch->mtu : 0;
+		}
+
+		/* The first datagram goes straight to the caller's buffer */
+		batch->iov[0].iov_base = buf;
+		batch->iov[0].iov_len = len;
+		for (i = 0; i < batch->size; i++) {
+			batch->msgs[i].msg_hdr.msg_namelen = sizeof(batch->addr[i]);
+			batch->msgs[i].msg_hdr.msg_flags = 0;
+			if (i) {
+				batch->iov[2 * i + 1].iov_base = batch->overflow;
+				batch->iov[2 * i + 1].iov_len = batch->overflowlen;
+				batch->msgs[i].msg_hdr.msg_iovlen = batch->overflowlen ? 2 : 1;
+			}
+		}
+		batch->count = batch->next = 0;
+
+		if ((count = recvmmsg(fd, batch->msgs, batch->size, MSG_DONTWAIT, NULL)) > 0) {
+			if (stats) {
+				tris_atomic_fetchadd_int(&stats->rxcalls, 1);
+				tris_atomic_fetchadd_int(&stats->rxpackets, count);
+			}
+			for (batch->overflowed = count - 1; batch->overflowed > 0; batch->overflowed--) {
+				if (batch->msgs[batch->overflowed].msg_len > batch->mtu)
+					break;
+			}
+			batch->count = count;
+			batch->next = 1;
+			memcpy(sin, &batch->addr[0], sizeof(*sin));
+			return batch->msgs[0].msg_len;
+		}
+		if (errno != ENOSYS)
+			return -1;
+		udp_batch_unsupported = 1;
+	}
+#endif
+
+	res = recvfrom(fd, buf, len, 0, (struct sockaddr *) sin, &sinlen);
+	if (res >= 0 && stats) {
+		tris_atomic_fetchadd_int(&stats->rxcalls, 1);
+		tris_atomic_fetchadd_int(&stats->rxpackets, 1);
+	}
+
+	return res;
+}
+
+ssize_t tris_udp_batch_sendto(struct tris_udp_batch *batch, int fd, const void *buf, size_t len,
+	const struct sockaddr_in *sin, struct tris_udp_batch_stats *stats)
+{
+	ssize_t res;
+
+#if defined(MSG_WAITFORONE)
+	if (batch && batch->count && (batch->fd != fd || len > batch->mtu))
+		tris_udp_batch_flush(batch, stats);
+
+	if (batch && !udp_batch_unsupported && len <= batch->mtu) {
+		int i;
+
+		i = batch->count++;
+		batch->fd = fd;
+		memcpy(batch->buf + i * batch->mtu, buf, len);
+		batch->iov[2 * i].iov_base = batch->buf + i * batch->mtu;
+		batch->iov[2 * i].iov_len = len;
+		memcpy(&batch->addr[i], sin, sizeof(*sin));
+		batch->msgs[i].msg_hdr.msg_namelen = sizeof(*sin);
+		batch->msgs[i].msg_hdr.msg_iovlen = 1;
+
+		if (batch->count == batch->size)
+			tris_udp_batch_flush(batch, stats);
+
+		return len;
+	}
+#endif
+
+	res = sendto(fd, buf, len, 0, (const struct sockaddr *) sin, sizeof(*sin));
+	if (stats) {
+		tris_atomic_fetchadd_int(&stats->txcalls, 1);
+		tris_atomic_fetchadd_int(res >= 0 ? &stats->txpackets : &stats->txerrors, 1);
+	}
+
+	return res;
+}
+
+int tris_udp_batch_flush(struct tris_udp_batch *batch, struct tris_udp_batch_stats *stats)
+{
+	int failed = 0;
+#if defined(MSG_WAITFORONE)
+	int sent = 0, res;
+
+	if (!batch)
+		return 0;
+
+	while (sent < batch->count) {
+		if (udp_batch_unsupported) {
+			/* Only happens once, if sendmmsg() is missing while recvmmsg() is not */
+			if (tris_udp_batch_sendto(NULL, batch->fd, batch->iov[2 * sent].iov_base, batch->iov[2 * sent].iov_len, &batch->addr[sent], stats) < 0)
+				failed++;
+			sent++;
+			continue;
+		}
+		res = sendmmsg(batch->fd, batch->msgs + sent, batch->count - sent, 0);
+		if (stats)
+			tris_atomic_fetchadd_int(&stats->txcalls, 1);
+		if (res < 0) {
+			if (errno == ENOSYS) {
+				udp_batch_unsupported = 1;
+				continue;
+			}
+			/* Skip the datagram that failed and send the rest */
+			tris_log(LOG_WARNING, "UDP transmission error to %s:%d: %s\n",
+				tris_inet_ntoa(batch->addr[sent].sin_addr), ntohs(batch->addr[sent].sin_port), strerror(errno));
+			if (stats)
+				tris_atomic_fetchadd_int(&stats->txerrors, 1);
+			failed++;
+			sent++;
+			continue;
+		}
+		if (stats)
+			tris_atomic_fetchadd_int(&stats->txpackets, res);
+		sent += res;
+	}
+	batch->count = batch->next = 0;
+#endif
+
+	return failed;
+}
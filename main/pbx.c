@@ -7965,7 +7965,7 @@ static int tris_pbx_outgoing_cdr_failed(void)
 	return 0;  /* success */
 }
 
-int tris_pbx_outgoing_exten(const char *type, int format, void *data, int timeout, const char *context,
+int tris_pbx_outgoing_exten(const char *type, format_t format, void *data, int timeout, const char *context,
 		const char *exten, int priority, int *reason, int synchronous, const char *cid_num, const char *cid_name,
 		struct tris_variable *vars, const char *account, struct tris_channel **channel)
 {
@@ -8133,7 +8133,7 @@ static void *tris_pbx_run_app(void *data)
 	return NULL;
 }
 
-int tris_pbx_outgoing_app(const char *type, int format, void *data, int timeout, const char *app, const char *appdata, int *reason, int synchronous, const char *cid_num, const char *cid_name, struct tris_variable *vars, const char *account, struct tris_channel **locked_channel)
+int tris_pbx_outgoing_app(const char *type, format_t format, void *data, int timeout, const char *app, const char *appdata, int *reason, int synchronous, const char *cid_num, const char *cid_name, struct tris_variable *vars, const char *account, struct tris_channel **locked_channel)
 {
 	struct tris_channel *chan;
 	struct app_tmp *tmp;
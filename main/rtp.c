@@ -64,6 +64,9 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 241721 $")
 
 #define RTP_MTU		1200
 
+#define RTP_RAWDATA_SIZE	(8192 * 10)	/*!< Receive buffer of a RTP session */
+#define RTP_BATCH_MTU		4096		/*!< Largest datagram that is read ahead or queued in a batch */
+
 #define DEFAULT_DTMF_TIMEOUT (150 * (8000 / 1000))	/*!< samples */
 
 static int dtmftimeout = DEFAULT_DTMF_TIMEOUT;
@@ -81,6 +84,7 @@ static struct sockaddr_in rtcpdebugaddr;	/*!< Debug RTCP packets to/from this ho
 static int nochecksums;
 #endif
 static int strictrtp;
+static int rtpbatch;			/*!< Datagrams per recvmmsg()/sendmmsg() call, 0 to not batch (set in rtp.conf) */
 
 enum strict_rtp_state {
 	STRICT_RTP_OPEN = 0, /*! No RTP packets should be dropped, all sources accepted */
@@ -123,8 +127,8 @@ struct tris_rtp {
 	unsigned int cycles;            /*!< Shifted count of sequence number cycles */
 	double rxjitter;                /*!< Interarrival jitter at the moment */
 	double rxtransit;               /*!< Relative transit time for previous packet */
-	int lasttxformat;
-	int lastrxformat;
+	format_t lasttxformat;
+	format_t lastrxformat;
 
 	int rtptimeout;			/*!< RTP timeout time (negative or zero means disabled, negative value means temporarily disabled) */
 	int rtpholdtimeout;		/*!< RTP timeout when on hold (negative or zero means disabled, negative value means temporarily disabled). */
@@ -165,7 +169,7 @@ struct tris_rtp {
 #endif
 	struct rtpPayloadType current_RTP_PT[MAX_RTP_PT];
 	int rtp_lookup_code_cache_isAstFormat; /*!< a cache for the result of rtp_lookup_code(): */
-	int rtp_lookup_code_cache_code;
+	format_t rtp_lookup_code_cache_code;
 	int rtp_lookup_code_cache_result;
 	struct tris_rtcp *rtcp;
 	struct tris_codec_pref pref;
@@ -177,6 +181,11 @@ struct tris_rtp {
 	int set_marker_bit:1;           /*!< Whether to set the marker bit or not */
 	unsigned int constantssrc:1;
 	struct rtp_red *red;
+
+	struct tris_udp_batch *rxbatch;	/*!< Datagrams read ahead of the one being processed */
+	struct tris_udp_batch *txbatch;	/*!< Datagrams waiting to be sent with one system call */
+	int txbatching;			/*!< Queue outgoing packets on txbatch instead of sending them */
+	struct tris_udp_batch_stats iostats;	/*!< System calls and datagrams on the RTP socket */
 };
 
 static struct tris_frame *red_t140_to_red(struct rtp_red *red);
@@ -282,6 +291,9 @@ struct tris_rtcp {
 	double stdevrtt;
 	unsigned int rtt_count;
 	int sendfur;
+
+	struct tris_udp_batch *rxbatch;	/*!< Datagrams read ahead of the one being processed */
+	struct tris_udp_batch_stats iostats;	/*!< System calls and datagrams on the RTCP socket */
 };
 
 /*!
@@ -727,9 +739,13 @@ int tris_rtcp_fd(struct tris_rtp *rtp)
 	return -1;
 }
 
-static int rtp_get_rate(int subclass)
+static int rtp_get_rate(format_t subclass)
 {
-	return (subclass == TRIS_FORMAT_G722) ? 8000 : tris_format_rate(subclass);
+	if (subclass == TRIS_FORMAT_G722)
+		return 8000;
+	if (subclass == TRIS_FORMAT_OPUS)
+		return 48000;
+	return tris_format_rate(subclass);
 }
 
 unsigned int tris_rtcp_calc_interval(struct tris_rtp *rtp)
@@ -823,6 +839,24 @@ void tris_rtp_setstun(struct tris_rtp *rtp, int stun_enable)
 	tris_set2_flag(rtp, stun_enable ? 1 : 0, FLAG_HAS_STUN);
 }
 
+void tris_rtp_set_readahead(struct tris_rtp *rtp)
+{
+	if (!rtp->rxbatch)
+		rtp->rxbatch = tris_udp_batch_alloc(rtpbatch, RTP_BATCH_MTU);
+	if (rtp->rtcp && !rtp->rtcp->rxbatch)
+		rtp->rtcp->rxbatch = tris_udp_batch_alloc(rtpbatch, RTP_BATCH_MTU);
+}
+
+int tris_rtp_read_pending(struct tris_rtp *rtp)
+{
+	return rtp ? tris_udp_batch_pending(rtp->rxbatch) : 0;
+}
+
+int tris_rtcp_read_pending(struct tris_rtp *rtp)
+{
+	return rtp && rtp->rtcp ? tris_udp_batch_pending(rtp->rtcp->rxbatch) : 0;
+}
+
 static void rtp_bridge_lock(struct tris_rtp *rtp)
 {
 #ifdef P2P_INTENSE
@@ -1124,7 +1158,7 @@ static struct tris_frame *process_rfc3389(struct tris_rtp *rtp, unsigned char *d
 	   totally help us out becuase we don't have an engine to keep it going and we are not
 	   guaranteed to have it every 20ms or anything */
 	if (rtpdebug)
-		tris_debug(0, "- RTP 3389 Comfort noise event: Level %d (len = %d)\n", rtp->lastrxformat, len);
+		tris_debug(0, "- RTP 3389 Comfort noise event: Level %d (len = %d)\n", (int) rtp->lastrxformat, len);
 
 	if (!(tris_test_flag(rtp, FLAG_3389_WARNING))) {
 		tris_log(LOG_NOTICE, "Comfort noise support incomplete in Trismedia (RFC 3389). Please turn off on client if possible. Client IP: %s\n",
@@ -1157,17 +1191,20 @@ static int rtpread(int *id, int fd, short events, void *cbdata)
 {
 	struct tris_rtp *rtp = cbdata;
 	struct tris_frame *f;
-	f = tris_rtp_read(rtp);
-	if (f) {
-		if (rtp->callback)
-			rtp->callback(rtp, f, rtp->data);
-	}
+
+	/* Datagrams read ahead do not wake us up again, so handle them all now */
+	do {
+		f = tris_rtp_read(rtp);
+		if (f) {
+			if (rtp->callback)
+				rtp->callback(rtp, f, rtp->data);
+		}
+	} while (f && tris_udp_batch_pending(rtp->rxbatch));
 	return 1;
 }
 
 struct tris_frame *tris_rtcp_read(struct tris_rtp *rtp)
 {
-	socklen_t len;
 	int position, i, packetwords;
 	int res;
 	struct sockaddr_in sock_in;
@@ -1195,10 +1232,8 @@ struct tris_frame *tris_rtcp_read(struct tris_rtp *rtp)
 	if (!rtp || !rtp->rtcp)
 		return &tris_null_frame;
 
-	len = sizeof(sock_in);
-	
-	res = recvfrom(rtp->rtcp->s, rtcpdata + TRIS_FRIENDLY_OFFSET, sizeof(rtcpdata) - sizeof(unsigned int) * TRIS_FRIENDLY_OFFSET,
-					0, (struct sockaddr *)&sock_in, &len);
+	res = tris_udp_batch_recvfrom(rtp->rtcp->rxbatch, rtp->rtcp->s, rtcpdata + TRIS_FRIENDLY_OFFSET,
+					sizeof(rtcpdata) - sizeof(unsigned int) * TRIS_FRIENDLY_OFFSET, &sock_in, &rtp->rtcp->iostats);
 	rtcpheader = (unsigned int *)(rtcpdata + TRIS_FRIENDLY_OFFSET);
 	
 	if (res < 0) {
@@ -1559,11 +1594,29 @@ static int bridge_p2p_rtp_write(struct tris_rtp *rtp, struct tris_rtp *bridged,
 	return 0;
 }
 
-struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
+/*! \name Variants of the RTP receive path
+ * rtp_read_packet() is specialized with these for each kind of stream carried over RTP.
+ */
+/*@{ */
+#define RTP_READ_MEDIA		(1 << 0)	/*!< Follow NAT, bridge P2P, track the SSRC and time out DTMF */
+#define RTP_READ_SSRC_MARK	(1 << 1)	/*!< Set the marker bit when the SSRC changes */
+#define RTP_READ_RAW		(1 << 2)	/*!< Pass the packet on with its header, payload type and marker (0x08) as subclass */
+#define RTP_READ_PROMOTER	(1 << 3)	/*!< The inner header of a mixed rakwon stream is followed by the promoter */
+/*@} */
+
+/*!
+ * \brief Receive one RTP packet and turn it into a frame
+ * \param fd Descriptor to read() the packet from, -1 to receive it on the RTP socket
+ * \param flags RTP_READ_* flags
+ * \param frametype Frame type of RTP_READ_RAW frames
+ * \param skip Bytes at the start of the payload to leave out of the frame
+ * \note The callers pass constants, so once inlined each of them only carries the checks it needs.
+ */
+static force_inline struct tris_frame *rtp_read_packet(struct tris_rtp *rtp, int fd, const int flags,
+	const enum tris_frame_type frametype, const int skip)
 {
 	int res;
 	struct sockaddr_in sock_in;
-	socklen_t len;
 	unsigned int seqno;
 	int version;
 	int payloadtype;
@@ -1579,17 +1632,28 @@ struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
 	struct tris_rtp *bridged = NULL;
 	int prev_seqno;
 
-	if (!rtp)
-		return &tris_null_frame;
 	/* If time is up, kill it */
 	if (rtp->sending_digit)
 		tris_rtp_senddigit_continuation(rtp);
 
-	len = sizeof(sock_in);
-	
 	/* Cache where the header will go */
-	res = recvfrom(rtp->s, rtp->rawdata + TRIS_FRIENDLY_OFFSET, sizeof(rtp->rawdata) - TRIS_FRIENDLY_OFFSET,
-					0, (struct sockaddr *)&sock_in, &len);
+	if (fd < 0) {
+		res = tris_udp_batch_recvfrom(rtp->rxbatch, rtp->s, rtp->rawdata + TRIS_FRIENDLY_OFFSET, RTP_RAWDATA_SIZE,
+						&sock_in, &rtp->iostats);
+	} else {
+		/* A pipe has no source address, the packet counts as coming from the peer */
+		res = read(fd, rtp->rawdata + TRIS_FRIENDLY_OFFSET, RTP_RAWDATA_SIZE);
+		sock_in = rtp->them;
+	}
+
+	if (res < 0) {
+		tris_assert(errno != EBADF);
+		if (errno != EAGAIN) {
+			tris_log(LOG_WARNING, "RTP Read error: %s.  Hanging up.\n", strerror(errno));
+			return NULL;
+		}
+		return &tris_null_frame;
+	}
 
 	/* If strict RTP protection is enabled see if we need to learn this address or if the packet should be dropped */
 	if (rtp->strict_rtp_state == STRICT_RTP_LEARN) {
@@ -1607,14 +1671,6 @@ struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
 	}
 
 	rtpheader = (unsigned int *)(rtp->rawdata + TRIS_FRIENDLY_OFFSET);
-	if (res < 0) {
-		tris_assert(errno != EBADF);
-		if (errno != EAGAIN) {
-			tris_log(LOG_WARNING, "RTP Read error: %s.  Hanging up.\n", strerror(errno));
-			return NULL;
-		}
-		return &tris_null_frame;
-	}
 	
 	if (res < hdrlen) {
 		tris_log(LOG_WARNING, "RTP Read too short\n");
@@ -1646,7 +1702,7 @@ struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
 #endif
 
 	/* Send to whoever send to us if NAT is turned on */
-	if (rtp->nat) {
+	if ((flags & RTP_READ_MEDIA) && rtp->nat) {
 		if (((rtp->them.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
 		    (rtp->them.sin_port != sock_in.sin_port)) && 
 		    ((rtp->altthem.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
@@ -1666,7 +1722,7 @@ struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
 	}
 
 	/* If we are bridged to another RTP stream, send direct */
-	if ((bridged = tris_rtp_get_bridged(rtp)) && !bridge_p2p_rtp_write(rtp, bridged, rtpheader, res, hdrlen))
+	if ((flags & RTP_READ_MEDIA) && (bridged = tris_rtp_get_bridged(rtp)) && !bridge_p2p_rtp_write(rtp, bridged, rtpheader, res, hdrlen))
 		return &tris_null_frame;
 
 	if (version != 2)
@@ -1681,13 +1737,14 @@ struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
 	timestamp = ntohl(rtpheader[1]);
 	ssrc = ntohl(rtpheader[2]);
 	
-	if (!mark && rtp->rxssrc && rtp->rxssrc != ssrc) {
+	if ((flags & RTP_READ_SSRC_MARK) && !mark && rtp->rxssrc && rtp->rxssrc != ssrc) {
 		if (option_debug || rtpdebug)
 			tris_debug(0, "Forcing Marker bit, because SSRC has changed\n");
 		mark = 1;
 	}
 
-	rtp->rxssrc = ssrc;
+	if (flags & RTP_READ_MEDIA)
+		rtp->rxssrc = ssrc;
 	
 	if (padding) {
 		/* Remove padding bytes */
@@ -1713,8 +1770,8 @@ struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
 		}
 	}
 
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short (%d, expecting %d)\n", res, hdrlen);
+	if (res < hdrlen + skip) {
+		tris_log(LOG_WARNING, "RTP Read too short (%d, expecting %d)\n", res, hdrlen + skip);
 		return &tris_null_frame;
 	}
 
@@ -1782,11 +1839,14 @@ struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
 		return f ? f : &tris_null_frame;
 	}
 	rtp->lastrxformat = rtp->f.subclass = rtpPT.code;
-	rtp->f.frametype = (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) ? TRIS_FRAME_VOICE : (rtp->f.subclass & TRIS_FORMAT_VIDEO_MASK) ? TRIS_FRAME_VIDEO : TRIS_FRAME_TEXT;
+	if (flags & RTP_READ_RAW)
+		rtp->f.frametype = frametype;
+	else
+		rtp->f.frametype = (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) ? TRIS_FRAME_VOICE : (rtp->f.subclass & TRIS_FORMAT_VIDEO_MASK) ? TRIS_FRAME_VIDEO : TRIS_FRAME_TEXT;
 
 	rtp->rxseqno = seqno;
 
-	if (rtp->dtmf_timeout && rtp->dtmf_timeout < timestamp) {
+	if ((flags & RTP_READ_MEDIA) && rtp->dtmf_timeout && rtp->dtmf_timeout < timestamp) {
 		rtp->dtmf_timeout = 0;
 
 		if (rtp->resp) {
@@ -1802,10 +1862,18 @@ struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
 	/* Record received timestamp as last received now */
 	rtp->lastrxts = timestamp;
 
+	if (flags & RTP_READ_PROMOTER)
+		rtp->f.promoter = rtp->rawdata[TRIS_FRIENDLY_OFFSET + hdrlen + 12];
 	rtp->f.mallocd = 0;
-	rtp->f.datalen = res - hdrlen;
-	rtp->f.data.ptr = rtp->rawdata + hdrlen + TRIS_FRIENDLY_OFFSET;
-	rtp->f.offset = hdrlen + TRIS_FRIENDLY_OFFSET;
+	if (flags & RTP_READ_RAW) {
+		rtp->f.datalen = res;
+		rtp->f.data.ptr = rtp->rawdata + TRIS_FRIENDLY_OFFSET;
+		rtp->f.offset = hdrlen + TRIS_FRIENDLY_OFFSET;
+	} else {
+		rtp->f.datalen = res - hdrlen - skip;
+		rtp->f.data.ptr = rtp->rawdata + hdrlen + TRIS_FRIENDLY_OFFSET + skip;
+		rtp->f.offset = hdrlen + TRIS_FRIENDLY_OFFSET + skip;
+	}
 	rtp->f.seqno = seqno;
 
 	if (rtp->f.subclass == TRIS_FORMAT_T140 && (int)seqno - (prev_seqno+1) > 0 && (int)seqno - (prev_seqno+1) < 10) {
@@ -1867,6 +1935,8 @@ struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
 
 	if (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) {
 		rtp->f.samples = tris_codec_get_samples(&rtp->f);
+		if ((flags & RTP_READ_PROMOTER) && rtp->f.samples == -1)
+			return &tris_null_frame;
 		if (rtp->f.subclass == TRIS_FORMAT_SLINEAR) 
 			tris_frame_byteswap_be(&rtp->f);
 		calc_rxstamp(&rtp->f.delivery, rtp, timestamp, mark);
@@ -1899,3559 +1969,1841 @@ struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
 		rtp->f.delivery.tv_usec = 0;
 	}
 	rtp->f.src = "RTP";
+	if (flags & RTP_READ_RAW) {
+		rtp->f.subclass = payloadtype;
+		if (mark)
+			rtp->f.subclass |= 0x08;
+		rtp->f.ts = timestamp;
+	}
 	return &rtp->f;
 }
 
+struct tris_frame *tris_rtp_read(struct tris_rtp *rtp)
+{
+	if (!rtp)
+		return &tris_null_frame;
+	return rtp_read_packet(rtp, -1, RTP_READ_MEDIA | RTP_READ_SSRC_MARK, 0, 0);
+}
+
 struct tris_frame *tris_file_read(struct tris_rtp *rtp)
 {
-	int res;
-	struct sockaddr_in sock_in;
-	socklen_t len;
-	unsigned int seqno;
-	int version;
-	int payloadtype;
-	int hdrlen = 12;
-	int padding;
-	int mark;
-	int ext;
-	int cc;
-	unsigned int ssrc;
-	unsigned int timestamp;
-	unsigned int *rtpheader;
-	struct rtpPayloadType rtpPT;
-	struct tris_rtp *bridged = NULL;
-	int prev_seqno;
-	
-	/* If time is up, kill it */
-	if (rtp->sending_digit)
-		tris_rtp_senddigit_continuation(rtp);
+	return rtp_read_packet(rtp, -1, RTP_READ_MEDIA | RTP_READ_RAW, TRIS_FRAME_FILE, 0);
+}
 
-	len = sizeof(sock_in);
-	
-	/* Cache where the header will go */
-	res = recvfrom(rtp->s, rtp->rawdata + TRIS_FRIENDLY_OFFSET, sizeof(rtp->rawdata) - TRIS_FRIENDLY_OFFSET,
-					0, (struct sockaddr *)&sock_in, &len);
+struct tris_frame *tris_desktop_read(struct tris_rtp *rtp)
+{
+	return rtp_read_packet(rtp, -1, RTP_READ_MEDIA | RTP_READ_RAW, TRIS_FRAME_DESKTOP, 0);
+}
 
-	/* If strict RTP protection is enabled see if we need to learn this address or if the packet should be dropped */
-	if (rtp->strict_rtp_state == STRICT_RTP_LEARN) {
-		/* Copy over address that this packet was received on */
-		memcpy(&rtp->strict_rtp_address, &sock_in, sizeof(rtp->strict_rtp_address));
-		/* Now move over to actually protecting the RTP port */
-		rtp->strict_rtp_state = STRICT_RTP_CLOSED;
-		tris_debug(1, "Learned remote address is %s:%d for strict RTP purposes, now protecting the port.\n", tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-	} else if (rtp->strict_rtp_state == STRICT_RTP_CLOSED) {
-		/* If the address we previously learned doesn't match the address this packet came in on simply drop it */
-		if ((rtp->strict_rtp_address.sin_addr.s_addr != sock_in.sin_addr.s_addr) || (rtp->strict_rtp_address.sin_port != sock_in.sin_port)) {
-			tris_debug(1, "Received RTP packet from %s:%d, dropping due to strict RTP protection. Expected it to be from %s:%d\n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-			return &tris_null_frame;
-		}
-	}
+struct tris_frame *tris_chat_read(struct tris_rtp *rtp)
+{
+	return rtp_read_packet(rtp, -1, RTP_READ_MEDIA | RTP_READ_RAW, TRIS_FRAME_CHAT, 0);
+}
 
-	rtpheader = (unsigned int *)(rtp->rawdata + TRIS_FRIENDLY_OFFSET);
-	if (res < 0) {
-		tris_assert(errno != EBADF);
-		if (errno != EAGAIN) {
-			tris_log(LOG_WARNING, "RTP Read error: %s.  Hanging up.\n", strerror(errno));
-			return NULL;
-		}
-		return &tris_null_frame;
-	}
-	
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short\n");
-		return &tris_null_frame;
-	}
+/* The following array defines the MIME Media type (and subtype) for each
+   of our codecs, or RTP-specific data type. */
+static const struct mimeType {
+	struct rtpPayloadType payloadType;
+	char *type;
+	char *subtype;
+	unsigned int sample_rate;
+} mimeTypes[] = {
+	{{1, TRIS_FORMAT_G723_1}, "audio", "G723", 8000},
+	{{1, TRIS_FORMAT_GSM}, "audio", "GSM", 8000},
+	{{1, TRIS_FORMAT_ULAW}, "audio", "PCMU", 8000},
+	{{1, TRIS_FORMAT_ULAW}, "audio", "G711U", 8000},
+	{{1, TRIS_FORMAT_ALAW}, "audio", "PCMA", 8000},
+	{{1, TRIS_FORMAT_ALAW}, "audio", "G711A", 8000},
+	{{1, TRIS_FORMAT_G726}, "audio", "G726-32", 8000},
+	{{1, TRIS_FORMAT_ADPCM}, "audio", "DVI4", 8000},
+	{{1, TRIS_FORMAT_SLINEAR}, "audio", "L16", 8000},
+	{{1, TRIS_FORMAT_LPC10}, "audio", "LPC", 8000},
+	{{1, TRIS_FORMAT_G729A}, "audio", "G729", 8000},
+	{{1, TRIS_FORMAT_G729A}, "audio", "G729A", 8000},
+	{{1, TRIS_FORMAT_G729A}, "audio", "G.729", 8000},
+	{{1, TRIS_FORMAT_SPEEX}, "audio", "speex", 8000},
+	{{1, TRIS_FORMAT_SPEEX16}, "audio", "speex", 16000},
+	{{1, TRIS_FORMAT_ILBC}, "audio", "iLBC", 8000},
+	/* this is the sample rate listed in the RTP profile for the G.722
+	   codec, *NOT* the actual sample rate of the media stream
+	*/
+	{{1, TRIS_FORMAT_G722}, "audio", "G722", 8000},
+	{{1, TRIS_FORMAT_G726_AAL2}, "audio", "AAL2-G726-32", 8000},
+	{{0, TRIS_RTP_DTMF}, "audio", "telephone-event", 8000},
+	{{0, TRIS_RTP_CISCO_DTMF}, "audio", "cisco-telephone-event", 8000},
+	{{0, TRIS_RTP_CN}, "audio", "CN", 8000},
+	{{1, TRIS_FORMAT_JPEG}, "video", "JPEG", 90000},
+	{{1, TRIS_FORMAT_PNG}, "video", "PNG", 90000},
+	{{1, TRIS_FORMAT_H261}, "video", "H261", 90000},
+	{{1, TRIS_FORMAT_H263}, "video", "H263", 90000},
+	{{1, TRIS_FORMAT_H263_PLUS}, "video", "h263-1998", 90000},
+	{{1, TRIS_FORMAT_H264}, "video", "H264", 90000},
+	{{1, TRIS_FORMAT_MP4_VIDEO}, "video", "MP4V-ES", 90000},
+	{{1, TRIS_FORMAT_T140RED}, "text", "RED", 1000},
+	{{1, TRIS_FORMAT_T140}, "text", "T140", 1000},
+	{{1, TRIS_FORMAT_SIREN7}, "audio", "G7221", 16000},
+	{{1, TRIS_FORMAT_SIREN14}, "audio", "G7221", 32000},
+	/* RFC 7587: the clock is 48kHz whatever the audio bandwidth */
+	{{1, TRIS_FORMAT_OPUS}, "audio", "opus", 48000},
+};
 
-	/* Get fields */
-	seqno = ntohl(rtpheader[0]);
+/*! 
+ * \brief Mapping between Trismedia codecs and rtp payload types
+ *
+ * Static (i.e., well-known) RTP payload types for our "TRIS_FORMAT..."s:
+ * also, our own choices for dynamic payload types.  This is our master
+ * table for transmission 
+ * 
+ * See http://www.iana.org/assignments/rtp-parameters for a list of
+ * assigned values
+ */
+static const struct rtpPayloadType static_RTP_PT[MAX_RTP_PT] = {
+	[0] = {1, TRIS_FORMAT_ULAW},
+#ifdef USE_DEPRECATED_G726
+	[2] = {1, TRIS_FORMAT_G726}, /* Technically this is G.721, but if Cisco can do it, so can we... */
+#endif
+	[3] = {1, TRIS_FORMAT_GSM},
+	[4] = {1, TRIS_FORMAT_G723_1},
+	[5] = {1, TRIS_FORMAT_ADPCM}, /* 8 kHz */
+	[6] = {1, TRIS_FORMAT_ADPCM}, /* 16 kHz */
+	[7] = {1, TRIS_FORMAT_LPC10},
+	[8] = {1, TRIS_FORMAT_ALAW},
+	[9] = {1, TRIS_FORMAT_G722},
+	[10] = {1, TRIS_FORMAT_SLINEAR}, /* 2 channels */
+	[11] = {1, TRIS_FORMAT_SLINEAR}, /* 1 channel */
+	[13] = {0, TRIS_RTP_CN},
+	[16] = {1, TRIS_FORMAT_ADPCM}, /* 11.025 kHz */
+	[17] = {1, TRIS_FORMAT_ADPCM}, /* 22.050 kHz */
+	[18] = {1, TRIS_FORMAT_G729A},
+	[19] = {0, TRIS_RTP_CN},		/* Also used for CN */
+	[26] = {1, TRIS_FORMAT_JPEG},
+	[31] = {1, TRIS_FORMAT_H261},
+	[34] = {1, TRIS_FORMAT_H263},
+	[97] = {1, TRIS_FORMAT_SPEEX},
+	[98] = {1, TRIS_FORMAT_ILBC},
+	[101] = {0, TRIS_RTP_DTMF},
+	[102] = {1, TRIS_FORMAT_SIREN7},
+	[103] = {1, TRIS_FORMAT_H263_PLUS},
+	[104] = {1, TRIS_FORMAT_MP4_VIDEO},
+	[105] = {1, TRIS_FORMAT_T140RED},	/* Real time text chat (with redundancy encoding) */
+	[106] = {1, TRIS_FORMAT_T140},	/* Real time text chat */
+	[107] = {1, TRIS_FORMAT_OPUS},
+	[110] = {1, TRIS_FORMAT_SPEEX},
+	[111] = {1, TRIS_FORMAT_G726},
+	[112] = {1, TRIS_FORMAT_G726_AAL2},
+	[115] = {1, TRIS_FORMAT_H263_PLUS},
+	[117] = {1, TRIS_FORMAT_SPEEX16},
+//	[115] = {1, TRIS_FORMAT_SIREN14},
+	[121] = {0, TRIS_RTP_CISCO_DTMF}, /* Must be type 121 */
+	[126] = {1, TRIS_FORMAT_H264},
+};
 
-	/* Check RTP version */
-	version = (seqno & 0xC0000000) >> 30;
-	if (!version) {
-		/* If the two high bits are 0, this might be a
-		 * STUN message, so process it. stun_handle_packet()
-		 * answers to requests, and it returns STUN_ACCEPT
-		 * if the request is valid.
-		 */
-		if ((stun_handle_packet(rtp->s, &sock_in, rtp->rawdata + TRIS_FRIENDLY_OFFSET, res, NULL, NULL) == STUN_ACCEPT) &&
-			(!rtp->them.sin_port && !rtp->them.sin_addr.s_addr)) {
-			memcpy(&rtp->them, &sock_in, sizeof(rtp->them));
-		}
-		return &tris_null_frame;
+void tris_rtp_pt_clear(struct tris_rtp* rtp) 
+{
+	int i;
+
+	if (!rtp)
+		return;
+
+	rtp_bridge_lock(rtp);
+
+	for (i = 0; i < MAX_RTP_PT; ++i) {
+		rtp->current_RTP_PT[i].isAstFormat = 0;
+		rtp->current_RTP_PT[i].code = 0;
 	}
 
-#if 0	/* Allow to receive RTP stream with closed transmission path */
-	/* If we don't have the other side's address, then ignore this */
-	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
-		return &tris_null_frame;
-#endif
+	rtp->rtp_lookup_code_cache_isAstFormat = 0;
+	rtp->rtp_lookup_code_cache_code = 0;
+	rtp->rtp_lookup_code_cache_result = 0;
 
-	/* Send to whoever send to us if NAT is turned on */
-	if (rtp->nat) {
-		if (((rtp->them.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (rtp->them.sin_port != sock_in.sin_port)) && 
-		    ((rtp->altthem.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (rtp->altthem.sin_port != sock_in.sin_port))) {
-			rtp->them = sock_in;
-			if (rtp->rtcp) {
-				int h = 0;
-				memcpy(&rtp->rtcp->them, &sock_in, sizeof(rtp->rtcp->them));
-				h = ntohs(rtp->them.sin_port);
-				rtp->rtcp->them.sin_port = htons(h + 1);
-			}
-			rtp->rxseqno = 0;
-			tris_set_flag(rtp, FLAG_NAT_ACTIVE);
-			if (option_debug || rtpdebug)
-				tris_debug(0, "RTP NAT: Got audio from other end. Now sending to address %s:%d\n", tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port));
-		}
-	}
+	rtp_bridge_unlock(rtp);
+}
 
-	/* If we are bridged to another RTP stream, send direct */
-	if ((bridged = tris_rtp_get_bridged(rtp)) && !bridge_p2p_rtp_write(rtp, bridged, rtpheader, res, hdrlen))
-		return &tris_null_frame;
+void tris_rtp_pt_default(struct tris_rtp* rtp) 
+{
+	int i;
 
-	if (version != 2)
-		return &tris_null_frame;
+	rtp_bridge_lock(rtp);
 
-	payloadtype = (seqno & 0x7f0000) >> 16;
-	padding = seqno & (1 << 29);
-	mark = seqno & (1 << 23);
-	ext = seqno & (1 << 28);
-	cc = (seqno & 0xF000000) >> 24;
-	seqno &= 0xffff;
-	timestamp = ntohl(rtpheader[1]);
-	ssrc = ntohl(rtpheader[2]);
-	
-	rtp->rxssrc = ssrc;
-	
-	if (padding) {
-		/* Remove padding bytes */
-		res -= rtp->rawdata[TRIS_FRIENDLY_OFFSET + res - 1];
-	}
-	
-	if (cc) {
-		/* CSRC fields present */
-		hdrlen += cc*4;
+	/* Initialize to default payload types */
+	for (i = 0; i < MAX_RTP_PT; ++i) {
+		rtp->current_RTP_PT[i].isAstFormat = static_RTP_PT[i].isAstFormat;
+		rtp->current_RTP_PT[i].code = static_RTP_PT[i].code;
 	}
 
-	if (ext) {
-		/* RTP Extension present */
-		hdrlen += (ntohl(rtpheader[hdrlen/4]) & 0xffff) << 2;
-		hdrlen += 4;
-		if (option_debug) {
-			int profile;
-			profile = (ntohl(rtpheader[3]) & 0xffff0000) >> 16;
-			if (profile == 0x505a)
-				tris_debug(1, "Found Zfone extension in RTP stream - zrtp - not supported.\n");
-			else
-				tris_debug(1, "Found unknown RTP Extensions %x\n", profile);
-		}
-	}
+	rtp->rtp_lookup_code_cache_isAstFormat = 0;
+	rtp->rtp_lookup_code_cache_code = 0;
+	rtp->rtp_lookup_code_cache_result = 0;
 
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short (%d, expecting %d)\n", res, hdrlen);
-		return &tris_null_frame;
-	}
+	rtp_bridge_unlock(rtp);
+}
 
-	rtp->rxcount++; /* Only count reasonably valid packets, this'll make the rtcp stats more accurate */
+void tris_rtp_pt_copy(struct tris_rtp *dest, struct tris_rtp *src)
+{
+	unsigned int i;
 
-	if (rtp->rxcount==1) {
-		/* This is the first RTP packet successfully received from source */
-		rtp->seedrxseqno = seqno;
-	}
+	rtp_bridge_lock(dest);
+	rtp_bridge_lock(src);
 
-	/* Do not schedule RR if RTCP isn't run */
-	if (rtp->rtcp && rtp->rtcp->them.sin_addr.s_addr && rtp->rtcp->schedid < 1) {
-		/* Schedule transmission of Receiver Report */
-		rtp->rtcp->schedid = tris_sched_add(rtp->sched, tris_rtcp_calc_interval(rtp), tris_rtcp_write, rtp);
+	for (i = 0; i < MAX_RTP_PT; ++i) {
+		dest->current_RTP_PT[i].isAstFormat = 
+			src->current_RTP_PT[i].isAstFormat;
+		dest->current_RTP_PT[i].code = 
+			src->current_RTP_PT[i].code; 
 	}
-	if ((int)rtp->lastrxseqno - (int)seqno  > 100) /* if so it would indicate that the sender cycled; allow for misordering */
-		rtp->cycles += RTP_SEQ_MOD;
-	
-	prev_seqno = rtp->lastrxseqno;
+	dest->rtp_lookup_code_cache_isAstFormat = 0;
+	dest->rtp_lookup_code_cache_code = 0;
+	dest->rtp_lookup_code_cache_result = 0;
 
-	rtp->lastrxseqno = seqno;
-	
-	if (!rtp->themssrc)
-		rtp->themssrc = ntohl(rtpheader[2]); /* Record their SSRC to put in future RR */
-	
-	if (rtp_debug_test_addr(&sock_in))
-		tris_verbose("Got  RTP packet from    %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-			tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp,res - hdrlen);
+	rtp_bridge_unlock(src);
+	rtp_bridge_unlock(dest);
+}
 
-	rtpPT = tris_rtp_lookup_pt(rtp, payloadtype);
-	if (!rtpPT.isAstFormat) {
-		struct tris_frame *f = NULL;
+/*! \brief Get channel driver interface structure */
+static struct tris_rtp_protocol *get_proto(struct tris_channel *chan)
+{
+	struct tris_rtp_protocol *cur = NULL;
 
-		/* This is special in-band data that's not one of our codecs */
-		if (rtpPT.code == TRIS_RTP_DTMF) {
-			/* It's special -- rfc2833 process it */
-			if (rtp_debug_test_addr(&sock_in)) {
-				unsigned char *data;
-				unsigned int event;
-				unsigned int event_end;
-				unsigned int duration;
-				data = rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen;
-				event = ntohl(*((unsigned int *)(data)));
-				event >>= 24;
-				event_end = ntohl(*((unsigned int *)(data)));
-				event_end <<= 8;
-				event_end >>= 24;
-				duration = ntohl(*((unsigned int *)(data)));
-				duration &= 0xFFFF;
-				tris_verbose("Got  RTP RFC2833 from   %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u, mark %d, event %08x, end %d, duration %-5.5d) \n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp, res - hdrlen, (mark?1:0), event, ((event_end & 0x80)?1:0), duration);
-			}
-			f = process_rfc2833(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen, seqno, timestamp);
-		} else if (rtpPT.code == TRIS_RTP_CISCO_DTMF) {
-			/* It's really special -- process it the Cisco way */
-			if (rtp->lastevent <= seqno || (rtp->lastevent >= 65530 && seqno <= 6)) {
-				f = process_cisco_dtmf(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-				rtp->lastevent = seqno;
-			}
-		} else if (rtpPT.code == TRIS_RTP_CN) {
-			/* Comfort Noise */
-			f = process_rfc3389(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-		} else {
-			tris_log(LOG_NOTICE, "Unknown RTP codec %d received from '%s'\n", payloadtype, tris_inet_ntoa(rtp->them.sin_addr));
-		}
-		return f ? f : &tris_null_frame;
+	TRIS_RWLIST_RDLOCK(&protos);
+	TRIS_RWLIST_TRAVERSE(&protos, cur, list) {
+		if (cur->type == chan->tech->type)
+			break;
 	}
-	rtp->lastrxformat = rtp->f.subclass = rtpPT.code;
-	rtp->f.frametype = TRIS_FRAME_FILE;
+	TRIS_RWLIST_UNLOCK(&protos);
 
-	rtp->rxseqno = seqno;
+	return cur;
+}
 
-	if (rtp->dtmf_timeout && rtp->dtmf_timeout < timestamp) {
-		rtp->dtmf_timeout = 0;
+int tris_rtp_early_bridge(struct tris_channel *c0, struct tris_channel *c1)
+{
+	struct tris_rtp *destp = NULL, *srcp = NULL;		/* Audio RTP Channels */
+	struct tris_rtp *vdestp = NULL, *vsrcp = NULL;		/* Video RTP channels */
+	struct tris_rtp *tdestp = NULL, *tsrcp = NULL;		/* Text RTP channels */
+	struct tris_rtp_protocol *destpr = NULL, *srcpr = NULL;
+	enum tris_rtp_get_result audio_dest_res = TRIS_RTP_GET_FAILED, video_dest_res = TRIS_RTP_GET_FAILED, text_dest_res = TRIS_RTP_GET_FAILED;
+	enum tris_rtp_get_result audio_src_res = TRIS_RTP_GET_FAILED, video_src_res = TRIS_RTP_GET_FAILED, text_src_res = TRIS_RTP_GET_FAILED;
+	format_t srccodec, destcodec;
+	int nat_active = 0;
 
-		if (rtp->resp) {
-			struct tris_frame *f;
-			f = send_dtmf(rtp, TRIS_FRAME_DTMF_END);
-			f->len = tris_tvdiff_ms(tris_samp2tv(rtp->dtmf_duration, rtp_get_rate(f->subclass)), tris_tv(0, 0));
-			rtp->resp = 0;
-			rtp->dtmf_timeout = rtp->dtmf_duration = 0;
-			return f;
+	/* Lock channels */
+	tris_channel_lock(c0);
+	if (c1) {
+		while (tris_channel_trylock(c1)) {
+			tris_channel_unlock(c0);
+			usleep(1);
+			tris_channel_lock(c0);
 		}
 	}
 
-	/* Record received timestamp as last received now */
-	rtp->lastrxts = timestamp;
-
-	rtp->f.mallocd = 0;
-	rtp->f.datalen = res;
-	rtp->f.data.ptr = rtp->rawdata + TRIS_FRIENDLY_OFFSET;
-	rtp->f.offset = hdrlen + TRIS_FRIENDLY_OFFSET;
-	rtp->f.seqno = seqno;
-
-	if (rtp->f.subclass == TRIS_FORMAT_T140 && (int)seqno - (prev_seqno+1) > 0 && (int)seqno - (prev_seqno+1) < 10) {
-		  unsigned char *data = rtp->f.data.ptr;
-		  
-		  memmove(rtp->f.data.ptr+3, rtp->f.data.ptr, rtp->f.datalen);
-		  rtp->f.datalen +=3;
-		  *data++ = 0xEF;
-		  *data++ = 0xBF;
-		  *data = 0xBD;
+	/* Find channel driver interfaces */
+	destpr = get_proto(c0);
+	if (c1)
+		srcpr = get_proto(c1);
+	if (!destpr) {
+		tris_debug(1, "Channel '%s' has no RTP, not doing anything\n", c0->name);
+		tris_channel_unlock(c0);
+		if (c1)
+			tris_channel_unlock(c1);
+		return -1;
+	}
+	if (!srcpr) {
+		tris_debug(1, "Channel '%s' has no RTP, not doing anything\n", c1 ? c1->name : "<unspecified>");
+		tris_channel_unlock(c0);
+		if (c1)
+			tris_channel_unlock(c1);
+		return -1;
 	}
- 
-	if (rtp->f.subclass == TRIS_FORMAT_T140RED) {
-		unsigned char *data = rtp->f.data.ptr;
-		unsigned char *header_end;
-		int num_generations;
-		int header_length;
-		int length;
-		int diff =(int)seqno - (prev_seqno+1); /* if diff = 0, no drop*/
-		int x;
-
-		rtp->f.subclass = TRIS_FORMAT_T140;
-		header_end = memchr(data, ((*data) & 0x7f), rtp->f.datalen);
-		if (header_end == NULL) {
-			return &tris_null_frame;
-		}
-		header_end++;
-		
-		header_length = header_end - data;
-		num_generations = header_length / 4;
-		length = header_length;
 
-		if (!diff) {
-			for (x = 0; x < num_generations; x++)
-				length += data[x * 4 + 3];
-			
-			if (!(rtp->f.datalen - length))
-				return &tris_null_frame;
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-		} else if (diff > num_generations && diff < 10) {
-			length -= 3;
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-			
-			data = rtp->f.data.ptr;
-			*data++ = 0xEF;
-			*data++ = 0xBF;
-			*data = 0xBD;
-		} else 	{
-			for ( x = 0; x < num_generations - diff; x++) 
-				length += data[x * 4 + 3];
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-		}
+	/* Get audio, video  and text interface (if native bridge is possible) */
+	audio_dest_res = destpr->get_rtp_info(c0, &destp);
+	video_dest_res = destpr->get_vrtp_info ? destpr->get_vrtp_info(c0, &vdestp) : TRIS_RTP_GET_FAILED;
+	text_dest_res = destpr->get_trtp_info ? destpr->get_trtp_info(c0, &tdestp) : TRIS_RTP_GET_FAILED;
+	if (srcpr) {
+		audio_src_res = srcpr->get_rtp_info(c1, &srcp);
+		video_src_res = srcpr->get_vrtp_info ? srcpr->get_vrtp_info(c1, &vsrcp) : TRIS_RTP_GET_FAILED;
+		text_src_res = srcpr->get_trtp_info ? srcpr->get_trtp_info(c1, &tsrcp) : TRIS_RTP_GET_FAILED;
 	}
 
-	if (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) {
-		rtp->f.samples = tris_codec_get_samples(&rtp->f);
-		if (rtp->f.subclass == TRIS_FORMAT_SLINEAR) 
-			tris_frame_byteswap_be(&rtp->f);
-		calc_rxstamp(&rtp->f.delivery, rtp, timestamp, mark);
-		/* Add timing data to let tris_generic_bridge() put the frame into a jitterbuf */
-		tris_set_flag(&rtp->f, TRIS_FRFLAG_HAS_TIMING_INFO);
-		rtp->f.ts = timestamp / (rtp_get_rate(rtp->f.subclass) / 1000);
-		rtp->f.len = rtp->f.samples / ((tris_format_rate(rtp->f.subclass) / 1000));
-	} else if (rtp->f.subclass & TRIS_FORMAT_VIDEO_MASK) {
-		/* Video -- samples is # of samples vs. 90000 */
-		if (!rtp->lastividtimestamp)
-			rtp->lastividtimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastividtimestamp;
-		rtp->lastividtimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
-		/* Pass the RTP marker bit as bit 0 in the subclass field.
-		 * This is ok because subclass is actually a bitmask, and
-		 * the low bits represent audio formats, that are not
-		 * involved here since we deal with video.
-		 */
-		if (mark)
-			rtp->f.subclass |= 0x1;
-	} else {
-		/* TEXT -- samples is # of samples vs. 1000 */
-		if (!rtp->lastitexttimestamp)
-			rtp->lastitexttimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastitexttimestamp;
-		rtp->lastitexttimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
-	}
-	rtp->f.src = "RTP";
-	rtp->f.subclass = payloadtype;
-	if (mark)
-		rtp->f.subclass |= 0x08;
-	rtp->f.ts = timestamp;
-	return &rtp->f;
-}
-
-struct tris_frame *tris_desktop_read(struct tris_rtp *rtp)
-{
-	int res;
-	struct sockaddr_in sock_in;
-	socklen_t len;
-	unsigned int seqno;
-	int version;
-	int payloadtype;
-	int hdrlen = 12;
-	int padding;
-	int mark;
-	int ext;
-	int cc;
-	unsigned int ssrc;
-	unsigned int timestamp;
-	unsigned int *rtpheader;
-	struct rtpPayloadType rtpPT;
-	struct tris_rtp *bridged = NULL;
-	int prev_seqno;
-	
-	/* If time is up, kill it */
-	if (rtp->sending_digit)
-		tris_rtp_senddigit_continuation(rtp);
-
-	len = sizeof(sock_in);
-	
-	/* Cache where the header will go */
-	res = recvfrom(rtp->s, rtp->rawdata + TRIS_FRIENDLY_OFFSET, sizeof(rtp->rawdata) - TRIS_FRIENDLY_OFFSET,
-					0, (struct sockaddr *)&sock_in, &len);
-
-	/* If strict RTP protection is enabled see if we need to learn this address or if the packet should be dropped */
-	if (rtp->strict_rtp_state == STRICT_RTP_LEARN) {
-		/* Copy over address that this packet was received on */
-		memcpy(&rtp->strict_rtp_address, &sock_in, sizeof(rtp->strict_rtp_address));
-		/* Now move over to actually protecting the RTP port */
-		rtp->strict_rtp_state = STRICT_RTP_CLOSED;
-		tris_debug(1, "Learned remote address is %s:%d for strict RTP purposes, now protecting the port.\n", tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-	} else if (rtp->strict_rtp_state == STRICT_RTP_CLOSED) {
-		/* If the address we previously learned doesn't match the address this packet came in on simply drop it */
-		if ((rtp->strict_rtp_address.sin_addr.s_addr != sock_in.sin_addr.s_addr) || (rtp->strict_rtp_address.sin_port != sock_in.sin_port)) {
-			tris_debug(1, "Received RTP packet from %s:%d, dropping due to strict RTP protection. Expected it to be from %s:%d\n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-			return &tris_null_frame;
-		}
-	}
-
-	rtpheader = (unsigned int *)(rtp->rawdata + TRIS_FRIENDLY_OFFSET);
-	if (res < 0) {
-		tris_assert(errno != EBADF);
-		if (errno != EAGAIN) {
-			tris_log(LOG_WARNING, "RTP Read error: %s.  Hanging up.\n", strerror(errno));
-			return NULL;
-		}
-		return &tris_null_frame;
-	}
-	
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short\n");
-		return &tris_null_frame;
-	}
-
-	/* Get fields */
-	seqno = ntohl(rtpheader[0]);
-
-	/* Check RTP version */
-	version = (seqno & 0xC0000000) >> 30;
-	if (!version) {
-		/* If the two high bits are 0, this might be a
-		 * STUN message, so process it. stun_handle_packet()
-		 * answers to requests, and it returns STUN_ACCEPT
-		 * if the request is valid.
-		 */
-		if ((stun_handle_packet(rtp->s, &sock_in, rtp->rawdata + TRIS_FRIENDLY_OFFSET, res, NULL, NULL) == STUN_ACCEPT) &&
-			(!rtp->them.sin_port && !rtp->them.sin_addr.s_addr)) {
-			memcpy(&rtp->them, &sock_in, sizeof(rtp->them));
-		}
-		return &tris_null_frame;
-	}
-
-#if 0	/* Allow to receive RTP stream with closed transmission path */
-	/* If we don't have the other side's address, then ignore this */
-	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
-		return &tris_null_frame;
-#endif
-
-	/* Send to whoever send to us if NAT is turned on */
-	if (rtp->nat) {
-		if (((rtp->them.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (rtp->them.sin_port != sock_in.sin_port)) && 
-		    ((rtp->altthem.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (rtp->altthem.sin_port != sock_in.sin_port))) {
-			rtp->them = sock_in;
-			if (rtp->rtcp) {
-				int h = 0;
-				memcpy(&rtp->rtcp->them, &sock_in, sizeof(rtp->rtcp->them));
-				h = ntohs(rtp->them.sin_port);
-				rtp->rtcp->them.sin_port = htons(h + 1);
-			}
-			rtp->rxseqno = 0;
-			tris_set_flag(rtp, FLAG_NAT_ACTIVE);
-			if (option_debug || rtpdebug)
-				tris_debug(0, "RTP NAT: Got audio from other end. Now sending to address %s:%d\n", tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port));
-		}
-	}
-
-	/* If we are bridged to another RTP stream, send direct */
-	if ((bridged = tris_rtp_get_bridged(rtp)) && !bridge_p2p_rtp_write(rtp, bridged, rtpheader, res, hdrlen))
-		return &tris_null_frame;
-
-	if (version != 2)
-		return &tris_null_frame;
-
-	payloadtype = (seqno & 0x7f0000) >> 16;
-	padding = seqno & (1 << 29);
-	mark = seqno & (1 << 23);
-	ext = seqno & (1 << 28);
-	cc = (seqno & 0xF000000) >> 24;
-	seqno &= 0xffff;
-	timestamp = ntohl(rtpheader[1]);
-	ssrc = ntohl(rtpheader[2]);
-	
-	rtp->rxssrc = ssrc;
-	
-	if (padding) {
-		/* Remove padding bytes */
-		res -= rtp->rawdata[TRIS_FRIENDLY_OFFSET + res - 1];
-	}
-	
-	if (cc) {
-		/* CSRC fields present */
-		hdrlen += cc*4;
-	}
-
-	if (ext) {
-		/* RTP Extension present */
-		hdrlen += (ntohl(rtpheader[hdrlen/4]) & 0xffff) << 2;
-		hdrlen += 4;
-		if (option_debug) {
-			int profile;
-			profile = (ntohl(rtpheader[3]) & 0xffff0000) >> 16;
-			if (profile == 0x505a)
-				tris_debug(1, "Found Zfone extension in RTP stream - zrtp - not supported.\n");
-			else
-				tris_debug(1, "Found unknown RTP Extensions %x\n", profile);
-		}
-	}
-
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short (%d, expecting %d)\n", res, hdrlen);
-		return &tris_null_frame;
-	}
-
-	rtp->rxcount++; /* Only count reasonably valid packets, this'll make the rtcp stats more accurate */
-
-	if (rtp->rxcount==1) {
-		/* This is the first RTP packet successfully received from source */
-		rtp->seedrxseqno = seqno;
-	}
-
-	/* Do not schedule RR if RTCP isn't run */
-	if (rtp->rtcp && rtp->rtcp->them.sin_addr.s_addr && rtp->rtcp->schedid < 1) {
-		/* Schedule transmission of Receiver Report */
-		rtp->rtcp->schedid = tris_sched_add(rtp->sched, tris_rtcp_calc_interval(rtp), tris_rtcp_write, rtp);
-	}
-	if ((int)rtp->lastrxseqno - (int)seqno  > 100) /* if so it would indicate that the sender cycled; allow for misordering */
-		rtp->cycles += RTP_SEQ_MOD;
-	
-	prev_seqno = rtp->lastrxseqno;
-
-	rtp->lastrxseqno = seqno;
-	
-	if (!rtp->themssrc)
-		rtp->themssrc = ntohl(rtpheader[2]); /* Record their SSRC to put in future RR */
-	
-	if (rtp_debug_test_addr(&sock_in))
-		tris_verbose("Got  RTP packet from    %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-			tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp,res - hdrlen);
-
-	rtpPT = tris_rtp_lookup_pt(rtp, payloadtype);
-	if (!rtpPT.isAstFormat) {
-		struct tris_frame *f = NULL;
-
-		/* This is special in-band data that's not one of our codecs */
-		if (rtpPT.code == TRIS_RTP_DTMF) {
-			/* It's special -- rfc2833 process it */
-			if (rtp_debug_test_addr(&sock_in)) {
-				unsigned char *data;
-				unsigned int event;
-				unsigned int event_end;
-				unsigned int duration;
-				data = rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen;
-				event = ntohl(*((unsigned int *)(data)));
-				event >>= 24;
-				event_end = ntohl(*((unsigned int *)(data)));
-				event_end <<= 8;
-				event_end >>= 24;
-				duration = ntohl(*((unsigned int *)(data)));
-				duration &= 0xFFFF;
-				tris_verbose("Got  RTP RFC2833 from   %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u, mark %d, event %08x, end %d, duration %-5.5d) \n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp, res - hdrlen, (mark?1:0), event, ((event_end & 0x80)?1:0), duration);
-			}
-			f = process_rfc2833(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen, seqno, timestamp);
-		} else if (rtpPT.code == TRIS_RTP_CISCO_DTMF) {
-			/* It's really special -- process it the Cisco way */
-			if (rtp->lastevent <= seqno || (rtp->lastevent >= 65530 && seqno <= 6)) {
-				f = process_cisco_dtmf(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-				rtp->lastevent = seqno;
-			}
-		} else if (rtpPT.code == TRIS_RTP_CN) {
-			/* Comfort Noise */
-			f = process_rfc3389(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-		} else {
-			tris_log(LOG_NOTICE, "Unknown RTP codec %d received from '%s'\n", payloadtype, tris_inet_ntoa(rtp->them.sin_addr));
-		}
-		return f ? f : &tris_null_frame;
-	}
-	rtp->lastrxformat = rtp->f.subclass = rtpPT.code;
-	rtp->f.frametype = TRIS_FRAME_DESKTOP;
-
-	rtp->rxseqno = seqno;
-
-	if (rtp->dtmf_timeout && rtp->dtmf_timeout < timestamp) {
-		rtp->dtmf_timeout = 0;
-
-		if (rtp->resp) {
-			struct tris_frame *f;
-			f = send_dtmf(rtp, TRIS_FRAME_DTMF_END);
-			f->len = tris_tvdiff_ms(tris_samp2tv(rtp->dtmf_duration, rtp_get_rate(f->subclass)), tris_tv(0, 0));
-			rtp->resp = 0;
-			rtp->dtmf_timeout = rtp->dtmf_duration = 0;
-			return f;
-		}
-	}
-
-	/* Record received timestamp as last received now */
-	rtp->lastrxts = timestamp;
-
-	rtp->f.mallocd = 0;
-	rtp->f.datalen = res;
-	rtp->f.data.ptr = rtp->rawdata + TRIS_FRIENDLY_OFFSET;
-	rtp->f.offset = hdrlen + TRIS_FRIENDLY_OFFSET;
-	rtp->f.seqno = seqno;
-
-	if (rtp->f.subclass == TRIS_FORMAT_T140 && (int)seqno - (prev_seqno+1) > 0 && (int)seqno - (prev_seqno+1) < 10) {
-		  unsigned char *data = rtp->f.data.ptr;
-		  
-		  memmove(rtp->f.data.ptr+3, rtp->f.data.ptr, rtp->f.datalen);
-		  rtp->f.datalen +=3;
-		  *data++ = 0xEF;
-		  *data++ = 0xBF;
-		  *data = 0xBD;
-	}
- 
-	if (rtp->f.subclass == TRIS_FORMAT_T140RED) {
-		unsigned char *data = rtp->f.data.ptr;
-		unsigned char *header_end;
-		int num_generations;
-		int header_length;
-		int length;
-		int diff =(int)seqno - (prev_seqno+1); /* if diff = 0, no drop*/
-		int x;
-
-		rtp->f.subclass = TRIS_FORMAT_T140;
-		header_end = memchr(data, ((*data) & 0x7f), rtp->f.datalen);
-		if (header_end == NULL) {
-			return &tris_null_frame;
-		}
-		header_end++;
-		
-		header_length = header_end - data;
-		num_generations = header_length / 4;
-		length = header_length;
-
-		if (!diff) {
-			for (x = 0; x < num_generations; x++)
-				length += data[x * 4 + 3];
-			
-			if (!(rtp->f.datalen - length))
-				return &tris_null_frame;
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-		} else if (diff > num_generations && diff < 10) {
-			length -= 3;
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-			
-			data = rtp->f.data.ptr;
-			*data++ = 0xEF;
-			*data++ = 0xBF;
-			*data = 0xBD;
-		} else 	{
-			for ( x = 0; x < num_generations - diff; x++) 
-				length += data[x * 4 + 3];
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-		}
-	}
-
-	if (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) {
-		rtp->f.samples = tris_codec_get_samples(&rtp->f);
-		if (rtp->f.subclass == TRIS_FORMAT_SLINEAR) 
-			tris_frame_byteswap_be(&rtp->f);
-		calc_rxstamp(&rtp->f.delivery, rtp, timestamp, mark);
-		/* Add timing data to let tris_generic_bridge() put the frame into a jitterbuf */
-		tris_set_flag(&rtp->f, TRIS_FRFLAG_HAS_TIMING_INFO);
-		rtp->f.ts = timestamp / (rtp_get_rate(rtp->f.subclass) / 1000);
-		rtp->f.len = rtp->f.samples / ((tris_format_rate(rtp->f.subclass) / 1000));
-	} else if (rtp->f.subclass & TRIS_FORMAT_VIDEO_MASK) {
-		/* Video -- samples is # of samples vs. 90000 */
-		if (!rtp->lastividtimestamp)
-			rtp->lastividtimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastividtimestamp;
-		rtp->lastividtimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
-		/* Pass the RTP marker bit as bit 0 in the subclass field.
-		 * This is ok because subclass is actually a bitmask, and
-		 * the low bits represent audio formats, that are not
-		 * involved here since we deal with video.
-		 */
-		if (mark)
-			rtp->f.subclass |= 0x1;
-	} else {
-		/* TEXT -- samples is # of samples vs. 1000 */
-		if (!rtp->lastitexttimestamp)
-			rtp->lastitexttimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastitexttimestamp;
-		rtp->lastitexttimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
-	}
-	rtp->f.src = "RTP";
-	rtp->f.subclass = payloadtype;
-	if (mark)
-		rtp->f.subclass |= 0x08;
-	rtp->f.ts = timestamp;
-	return &rtp->f;
-}
-
-struct tris_frame *tris_chat_read(struct tris_rtp *rtp)
-{
-	int res;
-	struct sockaddr_in sock_in;
-	socklen_t len;
-	unsigned int seqno;
-	int version;
-	int payloadtype;
-	int hdrlen = 12;
-	int padding;
-	int mark;
-	int ext;
-	int cc;
-	unsigned int ssrc;
-	unsigned int timestamp;
-	unsigned int *rtpheader;
-	struct rtpPayloadType rtpPT;
-	struct tris_rtp *bridged = NULL;
-	int prev_seqno;
-	
-	/* If time is up, kill it */
-	if (rtp->sending_digit)
-		tris_rtp_senddigit_continuation(rtp);
-
-	len = sizeof(sock_in);
-	
-	/* Cache where the header will go */
-	res = recvfrom(rtp->s, rtp->rawdata + TRIS_FRIENDLY_OFFSET, sizeof(rtp->rawdata) - TRIS_FRIENDLY_OFFSET,
-					0, (struct sockaddr *)&sock_in, &len);
-
-	/* If strict RTP protection is enabled see if we need to learn this address or if the packet should be dropped */
-	if (rtp->strict_rtp_state == STRICT_RTP_LEARN) {
-		/* Copy over address that this packet was received on */
-		memcpy(&rtp->strict_rtp_address, &sock_in, sizeof(rtp->strict_rtp_address));
-		/* Now move over to actually protecting the RTP port */
-		rtp->strict_rtp_state = STRICT_RTP_CLOSED;
-		tris_debug(1, "Learned remote address is %s:%d for strict RTP purposes, now protecting the port.\n", tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-	} else if (rtp->strict_rtp_state == STRICT_RTP_CLOSED) {
-		/* If the address we previously learned doesn't match the address this packet came in on simply drop it */
-		if ((rtp->strict_rtp_address.sin_addr.s_addr != sock_in.sin_addr.s_addr) || (rtp->strict_rtp_address.sin_port != sock_in.sin_port)) {
-			tris_debug(1, "Received RTP packet from %s:%d, dropping due to strict RTP protection. Expected it to be from %s:%d\n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-			return &tris_null_frame;
-		}
-	}
-
-	rtpheader = (unsigned int *)(rtp->rawdata + TRIS_FRIENDLY_OFFSET);
-	if (res < 0) {
-		tris_assert(errno != EBADF);
-		if (errno != EAGAIN) {
-			tris_log(LOG_WARNING, "RTP Read error: %s.  Hanging up.\n", strerror(errno));
-			return NULL;
-		}
-		return &tris_null_frame;
-	}
-	
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short\n");
-		return &tris_null_frame;
-	}
-
-	/* Get fields */
-	seqno = ntohl(rtpheader[0]);
-
-	/* Check RTP version */
-	version = (seqno & 0xC0000000) >> 30;
-	if (!version) {
-		/* If the two high bits are 0, this might be a
-		 * STUN message, so process it. stun_handle_packet()
-		 * answers to requests, and it returns STUN_ACCEPT
-		 * if the request is valid.
-		 */
-		if ((stun_handle_packet(rtp->s, &sock_in, rtp->rawdata + TRIS_FRIENDLY_OFFSET, res, NULL, NULL) == STUN_ACCEPT) &&
-			(!rtp->them.sin_port && !rtp->them.sin_addr.s_addr)) {
-			memcpy(&rtp->them, &sock_in, sizeof(rtp->them));
-		}
-		return &tris_null_frame;
-	}
-
-#if 0	/* Allow to receive RTP stream with closed transmission path */
-	/* If we don't have the other side's address, then ignore this */
-	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
-		return &tris_null_frame;
-#endif
-
-	/* Send to whoever send to us if NAT is turned on */
-	if (rtp->nat) {
-		if (((rtp->them.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (rtp->them.sin_port != sock_in.sin_port)) && 
-		    ((rtp->altthem.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (rtp->altthem.sin_port != sock_in.sin_port))) {
-			rtp->them = sock_in;
-			if (rtp->rtcp) {
-				int h = 0;
-				memcpy(&rtp->rtcp->them, &sock_in, sizeof(rtp->rtcp->them));
-				h = ntohs(rtp->them.sin_port);
-				rtp->rtcp->them.sin_port = htons(h + 1);
-			}
-			rtp->rxseqno = 0;
-			tris_set_flag(rtp, FLAG_NAT_ACTIVE);
-			if (option_debug || rtpdebug)
-				tris_debug(0, "RTP NAT: Got audio from other end. Now sending to address %s:%d\n", tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port));
-		}
-	}
-
-	/* If we are bridged to another RTP stream, send direct */
-	if ((bridged = tris_rtp_get_bridged(rtp)) && !bridge_p2p_rtp_write(rtp, bridged, rtpheader, res, hdrlen))
-		return &tris_null_frame;
-
-	if (version != 2)
-		return &tris_null_frame;
-
-	payloadtype = (seqno & 0x7f0000) >> 16;
-	padding = seqno & (1 << 29);
-	mark = seqno & (1 << 23);
-	ext = seqno & (1 << 28);
-	cc = (seqno & 0xF000000) >> 24;
-	seqno &= 0xffff;
-	timestamp = ntohl(rtpheader[1]);
-	ssrc = ntohl(rtpheader[2]);
-	
-	rtp->rxssrc = ssrc;
-	
-	if (padding) {
-		/* Remove padding bytes */
-		res -= rtp->rawdata[TRIS_FRIENDLY_OFFSET + res - 1];
-	}
-	
-	if (cc) {
-		/* CSRC fields present */
-		hdrlen += cc*4;
-	}
-
-	if (ext) {
-		/* RTP Extension present */
-		hdrlen += (ntohl(rtpheader[hdrlen/4]) & 0xffff) << 2;
-		hdrlen += 4;
-		if (option_debug) {
-			int profile;
-			profile = (ntohl(rtpheader[3]) & 0xffff0000) >> 16;
-			if (profile == 0x505a)
-				tris_debug(1, "Found Zfone extension in RTP stream - zrtp - not supported.\n");
-			else
-				tris_debug(1, "Found unknown RTP Extensions %x\n", profile);
-		}
-	}
-
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short (%d, expecting %d)\n", res, hdrlen);
-		return &tris_null_frame;
-	}
-
-	rtp->rxcount++; /* Only count reasonably valid packets, this'll make the rtcp stats more accurate */
-
-	if (rtp->rxcount==1) {
-		/* This is the first RTP packet successfully received from source */
-		rtp->seedrxseqno = seqno;
-	}
-
-	/* Do not schedule RR if RTCP isn't run */
-	if (rtp->rtcp && rtp->rtcp->them.sin_addr.s_addr && rtp->rtcp->schedid < 1) {
-		/* Schedule transmission of Receiver Report */
-		rtp->rtcp->schedid = tris_sched_add(rtp->sched, tris_rtcp_calc_interval(rtp), tris_rtcp_write, rtp);
-	}
-	if ((int)rtp->lastrxseqno - (int)seqno  > 100) /* if so it would indicate that the sender cycled; allow for misordering */
-		rtp->cycles += RTP_SEQ_MOD;
-	
-	prev_seqno = rtp->lastrxseqno;
-
-	rtp->lastrxseqno = seqno;
-	
-	if (!rtp->themssrc)
-		rtp->themssrc = ntohl(rtpheader[2]); /* Record their SSRC to put in future RR */
-	
-	if (rtp_debug_test_addr(&sock_in))
-		tris_verbose("Got  RTP packet from    %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-			tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp,res - hdrlen);
-
-	rtpPT = tris_rtp_lookup_pt(rtp, payloadtype);
-	if (!rtpPT.isAstFormat) {
-		struct tris_frame *f = NULL;
-
-		/* This is special in-band data that's not one of our codecs */
-		if (rtpPT.code == TRIS_RTP_DTMF) {
-			/* It's special -- rfc2833 process it */
-			if (rtp_debug_test_addr(&sock_in)) {
-				unsigned char *data;
-				unsigned int event;
-				unsigned int event_end;
-				unsigned int duration;
-				data = rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen;
-				event = ntohl(*((unsigned int *)(data)));
-				event >>= 24;
-				event_end = ntohl(*((unsigned int *)(data)));
-				event_end <<= 8;
-				event_end >>= 24;
-				duration = ntohl(*((unsigned int *)(data)));
-				duration &= 0xFFFF;
-				tris_verbose("Got  RTP RFC2833 from   %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u, mark %d, event %08x, end %d, duration %-5.5d) \n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp, res - hdrlen, (mark?1:0), event, ((event_end & 0x80)?1:0), duration);
-			}
-			f = process_rfc2833(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen, seqno, timestamp);
-		} else if (rtpPT.code == TRIS_RTP_CISCO_DTMF) {
-			/* It's really special -- process it the Cisco way */
-			if (rtp->lastevent <= seqno || (rtp->lastevent >= 65530 && seqno <= 6)) {
-				f = process_cisco_dtmf(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-				rtp->lastevent = seqno;
-			}
-		} else if (rtpPT.code == TRIS_RTP_CN) {
-			/* Comfort Noise */
-			f = process_rfc3389(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-		} else {
-			tris_log(LOG_NOTICE, "Unknown RTP codec %d received from '%s'\n", payloadtype, tris_inet_ntoa(rtp->them.sin_addr));
-		}
-		return f ? f : &tris_null_frame;
-	}
-	rtp->lastrxformat = rtp->f.subclass = rtpPT.code;
-	rtp->f.frametype = TRIS_FRAME_CHAT;
-
-	rtp->rxseqno = seqno;
-
-	if (rtp->dtmf_timeout && rtp->dtmf_timeout < timestamp) {
-		rtp->dtmf_timeout = 0;
-
-		if (rtp->resp) {
-			struct tris_frame *f;
-			f = send_dtmf(rtp, TRIS_FRAME_DTMF_END);
-			f->len = tris_tvdiff_ms(tris_samp2tv(rtp->dtmf_duration, rtp_get_rate(f->subclass)), tris_tv(0, 0));
-			rtp->resp = 0;
-			rtp->dtmf_timeout = rtp->dtmf_duration = 0;
-			return f;
-		}
-	}
-
-	/* Record received timestamp as last received now */
-	rtp->lastrxts = timestamp;
-
-	rtp->f.mallocd = 0;
-	rtp->f.datalen = res;
-	rtp->f.data.ptr = rtp->rawdata + TRIS_FRIENDLY_OFFSET;
-	rtp->f.offset = hdrlen + TRIS_FRIENDLY_OFFSET;
-	rtp->f.seqno = seqno;
-
-	if (rtp->f.subclass == TRIS_FORMAT_T140 && (int)seqno - (prev_seqno+1) > 0 && (int)seqno - (prev_seqno+1) < 10) {
-		  unsigned char *data = rtp->f.data.ptr;
-		  
-		  memmove(rtp->f.data.ptr+3, rtp->f.data.ptr, rtp->f.datalen);
-		  rtp->f.datalen +=3;
-		  *data++ = 0xEF;
-		  *data++ = 0xBF;
-		  *data = 0xBD;
-	}
- 
-	if (rtp->f.subclass == TRIS_FORMAT_T140RED) {
-		unsigned char *data = rtp->f.data.ptr;
-		unsigned char *header_end;
-		int num_generations;
-		int header_length;
-		int length;
-		int diff =(int)seqno - (prev_seqno+1); /* if diff = 0, no drop*/
-		int x;
-
-		rtp->f.subclass = TRIS_FORMAT_T140;
-		header_end = memchr(data, ((*data) & 0x7f), rtp->f.datalen);
-		if (header_end == NULL) {
-			return &tris_null_frame;
-		}
-		header_end++;
-		
-		header_length = header_end - data;
-		num_generations = header_length / 4;
-		length = header_length;
-
-		if (!diff) {
-			for (x = 0; x < num_generations; x++)
-				length += data[x * 4 + 3];
-			
-			if (!(rtp->f.datalen - length))
-				return &tris_null_frame;
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-		} else if (diff > num_generations && diff < 10) {
-			length -= 3;
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-			
-			data = rtp->f.data.ptr;
-			*data++ = 0xEF;
-			*data++ = 0xBF;
-			*data = 0xBD;
-		} else 	{
-			for ( x = 0; x < num_generations - diff; x++) 
-				length += data[x * 4 + 3];
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-		}
-	}
-
-	if (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) {
-		rtp->f.samples = tris_codec_get_samples(&rtp->f);
-		if (rtp->f.subclass == TRIS_FORMAT_SLINEAR) 
-			tris_frame_byteswap_be(&rtp->f);
-		calc_rxstamp(&rtp->f.delivery, rtp, timestamp, mark);
-		/* Add timing data to let tris_generic_bridge() put the frame into a jitterbuf */
-		tris_set_flag(&rtp->f, TRIS_FRFLAG_HAS_TIMING_INFO);
-		rtp->f.ts = timestamp / (rtp_get_rate(rtp->f.subclass) / 1000);
-		rtp->f.len = rtp->f.samples / ((tris_format_rate(rtp->f.subclass) / 1000));
-	} else if (rtp->f.subclass & TRIS_FORMAT_VIDEO_MASK) {
-		/* Video -- samples is # of samples vs. 90000 */
-		if (!rtp->lastividtimestamp)
-			rtp->lastividtimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastividtimestamp;
-		rtp->lastividtimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
-		/* Pass the RTP marker bit as bit 0 in the subclass field.
-		 * This is ok because subclass is actually a bitmask, and
-		 * the low bits represent audio formats, that are not
-		 * involved here since we deal with video.
-		 */
-		if (mark)
-			rtp->f.subclass |= 0x1;
-	} else {
-		/* TEXT -- samples is # of samples vs. 1000 */
-		if (!rtp->lastitexttimestamp)
-			rtp->lastitexttimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastitexttimestamp;
-		rtp->lastitexttimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
-	}
-	rtp->f.src = "RTP";
-	rtp->f.subclass = payloadtype;
-	if (mark)
-		rtp->f.subclass |= 0x08;
-	rtp->f.ts = timestamp;
-	return &rtp->f;
-}
-
-/* The following array defines the MIME Media type (and subtype) for each
-   of our codecs, or RTP-specific data type. */
-static const struct mimeType {
-	struct rtpPayloadType payloadType;
-	char *type;
-	char *subtype;
-	unsigned int sample_rate;
-} mimeTypes[] = {
-	{{1, TRIS_FORMAT_G723_1}, "audio", "G723", 8000},
-	{{1, TRIS_FORMAT_GSM}, "audio", "GSM", 8000},
-	{{1, TRIS_FORMAT_ULAW}, "audio", "PCMU", 8000},
-	{{1, TRIS_FORMAT_ULAW}, "audio", "G711U", 8000},
-	{{1, TRIS_FORMAT_ALAW}, "audio", "PCMA", 8000},
-	{{1, TRIS_FORMAT_ALAW}, "audio", "G711A", 8000},
-	{{1, TRIS_FORMAT_G726}, "audio", "G726-32", 8000},
-	{{1, TRIS_FORMAT_ADPCM}, "audio", "DVI4", 8000},
-	{{1, TRIS_FORMAT_SLINEAR}, "audio", "L16", 8000},
-	{{1, TRIS_FORMAT_LPC10}, "audio", "LPC", 8000},
-	{{1, TRIS_FORMAT_G729A}, "audio", "G729", 8000},
-	{{1, TRIS_FORMAT_G729A}, "audio", "G729A", 8000},
-	{{1, TRIS_FORMAT_G729A}, "audio", "G.729", 8000},
-	{{1, TRIS_FORMAT_SPEEX}, "audio", "speex", 8000},
-	{{1, TRIS_FORMAT_SPEEX16}, "audio", "speex", 16000},
-	{{1, TRIS_FORMAT_ILBC}, "audio", "iLBC", 8000},
-	/* this is the sample rate listed in the RTP profile for the G.722
-	   codec, *NOT* the actual sample rate of the media stream
-	*/
-	{{1, TRIS_FORMAT_G722}, "audio", "G722", 8000},
-	{{1, TRIS_FORMAT_G726_AAL2}, "audio", "AAL2-G726-32", 8000},
-	{{0, TRIS_RTP_DTMF}, "audio", "telephone-event", 8000},
-	{{0, TRIS_RTP_CISCO_DTMF}, "audio", "cisco-telephone-event", 8000},
-	{{0, TRIS_RTP_CN}, "audio", "CN", 8000},
-	{{1, TRIS_FORMAT_JPEG}, "video", "JPEG", 90000},
-	{{1, TRIS_FORMAT_PNG}, "video", "PNG", 90000},
-	{{1, TRIS_FORMAT_H261}, "video", "H261", 90000},
-	{{1, TRIS_FORMAT_H263}, "video", "H263", 90000},
-	{{1, TRIS_FORMAT_H263_PLUS}, "video", "h263-1998", 90000},
-	{{1, TRIS_FORMAT_H264}, "video", "H264", 90000},
-	{{1, TRIS_FORMAT_MP4_VIDEO}, "video", "MP4V-ES", 90000},
-	{{1, TRIS_FORMAT_T140RED}, "text", "RED", 1000},
-	{{1, TRIS_FORMAT_T140}, "text", "T140", 1000},
-	{{1, TRIS_FORMAT_SIREN7}, "audio", "G7221", 16000},
-	{{1, TRIS_FORMAT_SIREN14}, "audio", "G7221", 32000},
-};
-
-/*! 
- * \brief Mapping between Trismedia codecs and rtp payload types
- *
- * Static (i.e., well-known) RTP payload types for our "TRIS_FORMAT..."s:
- * also, our own choices for dynamic payload types.  This is our master
- * table for transmission 
- * 
- * See http://www.iana.org/assignments/rtp-parameters for a list of
- * assigned values
- */
-static const struct rtpPayloadType static_RTP_PT[MAX_RTP_PT] = {
-	[0] = {1, TRIS_FORMAT_ULAW},
-#ifdef USE_DEPRECATED_G726
-	[2] = {1, TRIS_FORMAT_G726}, /* Technically this is G.721, but if Cisco can do it, so can we... */
-#endif
-	[3] = {1, TRIS_FORMAT_GSM},
-	[4] = {1, TRIS_FORMAT_G723_1},
-	[5] = {1, TRIS_FORMAT_ADPCM}, /* 8 kHz */
-	[6] = {1, TRIS_FORMAT_ADPCM}, /* 16 kHz */
-	[7] = {1, TRIS_FORMAT_LPC10},
-	[8] = {1, TRIS_FORMAT_ALAW},
-	[9] = {1, TRIS_FORMAT_G722},
-	[10] = {1, TRIS_FORMAT_SLINEAR}, /* 2 channels */
-	[11] = {1, TRIS_FORMAT_SLINEAR}, /* 1 channel */
-	[13] = {0, TRIS_RTP_CN},
-	[16] = {1, TRIS_FORMAT_ADPCM}, /* 11.025 kHz */
-	[17] = {1, TRIS_FORMAT_ADPCM}, /* 22.050 kHz */
-	[18] = {1, TRIS_FORMAT_G729A},
-	[19] = {0, TRIS_RTP_CN},		/* Also used for CN */
-	[26] = {1, TRIS_FORMAT_JPEG},
-	[31] = {1, TRIS_FORMAT_H261},
-	[34] = {1, TRIS_FORMAT_H263},
-	[97] = {1, TRIS_FORMAT_SPEEX},
-	[98] = {1, TRIS_FORMAT_ILBC},
-	[101] = {0, TRIS_RTP_DTMF},
-	[102] = {1, TRIS_FORMAT_SIREN7},
-	[103] = {1, TRIS_FORMAT_H263_PLUS},
-	[104] = {1, TRIS_FORMAT_MP4_VIDEO},
-	[105] = {1, TRIS_FORMAT_T140RED},	/* Real time text chat (with redundancy encoding) */
-	[106] = {1, TRIS_FORMAT_T140},	/* Real time text chat */
-	[110] = {1, TRIS_FORMAT_SPEEX},
-	[111] = {1, TRIS_FORMAT_G726},
-	[112] = {1, TRIS_FORMAT_G726_AAL2},
-	[115] = {1, TRIS_FORMAT_H263_PLUS},
-	[117] = {1, TRIS_FORMAT_SPEEX16},
-//	[115] = {1, TRIS_FORMAT_SIREN14},
-	[121] = {0, TRIS_RTP_CISCO_DTMF}, /* Must be type 121 */
-	[126] = {1, TRIS_FORMAT_H264},
-};
-
-void tris_rtp_pt_clear(struct tris_rtp* rtp) 
-{
-	int i;
-
-	if (!rtp)
-		return;
-
-	rtp_bridge_lock(rtp);
-
-	for (i = 0; i < MAX_RTP_PT; ++i) {
-		rtp->current_RTP_PT[i].isAstFormat = 0;
-		rtp->current_RTP_PT[i].code = 0;
-	}
-
-	rtp->rtp_lookup_code_cache_isAstFormat = 0;
-	rtp->rtp_lookup_code_cache_code = 0;
-	rtp->rtp_lookup_code_cache_result = 0;
-
-	rtp_bridge_unlock(rtp);
-}
-
-void tris_rtp_pt_default(struct tris_rtp* rtp) 
-{
-	int i;
-
-	rtp_bridge_lock(rtp);
-
-	/* Initialize to default payload types */
-	for (i = 0; i < MAX_RTP_PT; ++i) {
-		rtp->current_RTP_PT[i].isAstFormat = static_RTP_PT[i].isAstFormat;
-		rtp->current_RTP_PT[i].code = static_RTP_PT[i].code;
-	}
-
-	rtp->rtp_lookup_code_cache_isAstFormat = 0;
-	rtp->rtp_lookup_code_cache_code = 0;
-	rtp->rtp_lookup_code_cache_result = 0;
-
-	rtp_bridge_unlock(rtp);
-}
-
-void tris_rtp_pt_copy(struct tris_rtp *dest, struct tris_rtp *src)
-{
-	unsigned int i;
-
-	rtp_bridge_lock(dest);
-	rtp_bridge_lock(src);
-
-	for (i = 0; i < MAX_RTP_PT; ++i) {
-		dest->current_RTP_PT[i].isAstFormat = 
-			src->current_RTP_PT[i].isAstFormat;
-		dest->current_RTP_PT[i].code = 
-			src->current_RTP_PT[i].code; 
-	}
-	dest->rtp_lookup_code_cache_isAstFormat = 0;
-	dest->rtp_lookup_code_cache_code = 0;
-	dest->rtp_lookup_code_cache_result = 0;
-
-	rtp_bridge_unlock(src);
-	rtp_bridge_unlock(dest);
-}
-
-/*! \brief Get channel driver interface structure */
-static struct tris_rtp_protocol *get_proto(struct tris_channel *chan)
-{
-	struct tris_rtp_protocol *cur = NULL;
-
-	TRIS_RWLIST_RDLOCK(&protos);
-	TRIS_RWLIST_TRAVERSE(&protos, cur, list) {
-		if (cur->type == chan->tech->type)
-			break;
-	}
-	TRIS_RWLIST_UNLOCK(&protos);
-
-	return cur;
-}
-
-int tris_rtp_early_bridge(struct tris_channel *c0, struct tris_channel *c1)
-{
-	struct tris_rtp *destp = NULL, *srcp = NULL;		/* Audio RTP Channels */
-	struct tris_rtp *vdestp = NULL, *vsrcp = NULL;		/* Video RTP channels */
-	struct tris_rtp *tdestp = NULL, *tsrcp = NULL;		/* Text RTP channels */
-	struct tris_rtp_protocol *destpr = NULL, *srcpr = NULL;
-	enum tris_rtp_get_result audio_dest_res = TRIS_RTP_GET_FAILED, video_dest_res = TRIS_RTP_GET_FAILED, text_dest_res = TRIS_RTP_GET_FAILED;
-	enum tris_rtp_get_result audio_src_res = TRIS_RTP_GET_FAILED, video_src_res = TRIS_RTP_GET_FAILED, text_src_res = TRIS_RTP_GET_FAILED;
-	int srccodec, destcodec, nat_active = 0;
-
-	/* Lock channels */
-	tris_channel_lock(c0);
-	if (c1) {
-		while (tris_channel_trylock(c1)) {
-			tris_channel_unlock(c0);
-			usleep(1);
-			tris_channel_lock(c0);
-		}
-	}
-
-	/* Find channel driver interfaces */
-	destpr = get_proto(c0);
-	if (c1)
-		srcpr = get_proto(c1);
-	if (!destpr) {
-		tris_debug(1, "Channel '%s' has no RTP, not doing anything\n", c0->name);
-		tris_channel_unlock(c0);
-		if (c1)
-			tris_channel_unlock(c1);
-		return -1;
-	}
-	if (!srcpr) {
-		tris_debug(1, "Channel '%s' has no RTP, not doing anything\n", c1 ? c1->name : "<unspecified>");
-		tris_channel_unlock(c0);
-		if (c1)
-			tris_channel_unlock(c1);
-		return -1;
-	}
-
-	/* Get audio, video  and text interface (if native bridge is possible) */
-	audio_dest_res = destpr->get_rtp_info(c0, &destp);
-	video_dest_res = destpr->get_vrtp_info ? destpr->get_vrtp_info(c0, &vdestp) : TRIS_RTP_GET_FAILED;
-	text_dest_res = destpr->get_trtp_info ? destpr->get_trtp_info(c0, &tdestp) : TRIS_RTP_GET_FAILED;
-	if (srcpr) {
-		audio_src_res = srcpr->get_rtp_info(c1, &srcp);
-		video_src_res = srcpr->get_vrtp_info ? srcpr->get_vrtp_info(c1, &vsrcp) : TRIS_RTP_GET_FAILED;
-		text_src_res = srcpr->get_trtp_info ? srcpr->get_trtp_info(c1, &tsrcp) : TRIS_RTP_GET_FAILED;
-	}
-
-	/* Check if bridge is still possible (In SIP directmedia=no stops this, like NAT) */
-	if (audio_dest_res != TRIS_RTP_TRY_NATIVE || (video_dest_res != TRIS_RTP_GET_FAILED && video_dest_res != TRIS_RTP_TRY_NATIVE)) {
-		/* Somebody doesn't want to play... */
-		tris_channel_unlock(c0);
-		if (c1)
-			tris_channel_unlock(c1);
-		return -1;
-	}
-	if (audio_src_res == TRIS_RTP_TRY_NATIVE && (video_src_res == TRIS_RTP_GET_FAILED || video_src_res == TRIS_RTP_TRY_NATIVE) && srcpr->get_codec)
-		srccodec = srcpr->get_codec(c1);
-	else
-		srccodec = 0;
-	if (audio_dest_res == TRIS_RTP_TRY_NATIVE && (video_dest_res == TRIS_RTP_GET_FAILED || video_dest_res == TRIS_RTP_TRY_NATIVE) && destpr->get_codec)
-		destcodec = destpr->get_codec(c0);
-	else
-		destcodec = 0;
-	/* Ensure we have at least one matching codec */
-	if (srcp && !(srccodec & destcodec)) {
-		tris_channel_unlock(c0);
-		tris_channel_unlock(c1);
-		return 0;
-	}
-	/* Consider empty media as non-existent */
-	if (audio_src_res == TRIS_RTP_TRY_NATIVE && !srcp->them.sin_addr.s_addr)
-		srcp = NULL;
-	if (srcp && (srcp->nat || tris_test_flag(srcp, FLAG_NAT_ACTIVE)))
-		nat_active = 1;
-	/* Bridge media early */
-	if (destpr->set_rtp_peer(c0, srcp, vsrcp, tsrcp, srccodec, nat_active))
-		tris_log(LOG_WARNING, "Channel '%s' failed to setup early bridge to '%s'\n", c0->name, c1 ? c1->name : "<unspecified>");
-	tris_channel_unlock(c0);
-	if (c1)
-		tris_channel_unlock(c1);
-	tris_debug(1, "Setting early bridge SDP of '%s' with that of '%s'\n", c0->name, c1 ? c1->name : "<unspecified>");
-	return 0;
-}
-
-int tris_rtp_make_compatible(struct tris_channel *dest, struct tris_channel *src, int media)
-{
-	struct tris_rtp *destp = NULL, *srcp = NULL;		/* Audio RTP Channels */
-	struct tris_rtp *vdestp = NULL, *vsrcp = NULL;		/* Video RTP channels */
-	struct tris_rtp *tdestp = NULL, *tsrcp = NULL;		/* Text RTP channels */
-	struct tris_rtp_protocol *destpr = NULL, *srcpr = NULL;
-	enum tris_rtp_get_result audio_dest_res = TRIS_RTP_GET_FAILED, video_dest_res = TRIS_RTP_GET_FAILED, text_dest_res = TRIS_RTP_GET_FAILED;
-	enum tris_rtp_get_result audio_src_res = TRIS_RTP_GET_FAILED, video_src_res = TRIS_RTP_GET_FAILED, text_src_res = TRIS_RTP_GET_FAILED; 
-	int srccodec, destcodec;
-
-	/* Lock channels */
-	tris_channel_lock(dest);
-	while (tris_channel_trylock(src)) {
-		tris_channel_unlock(dest);
-		usleep(1);
-		tris_channel_lock(dest);
-	}
-
-	/* Find channel driver interfaces */
-	if (!(destpr = get_proto(dest))) {
-		tris_debug(1, "Channel '%s' has no RTP, not doing anything\n", dest->name);
-		tris_channel_unlock(dest);
-		tris_channel_unlock(src);
-		return 0;
-	}
-	if (!(srcpr = get_proto(src))) {
-		tris_debug(1, "Channel '%s' has no RTP, not doing anything\n", src->name);
-		tris_channel_unlock(dest);
-		tris_channel_unlock(src);
-		return 0;
-	}
-
-	/* Get audio and video interface (if native bridge is possible) */
-	audio_dest_res = destpr->get_rtp_info(dest, &destp);
-	video_dest_res = destpr->get_vrtp_info ? destpr->get_vrtp_info(dest, &vdestp) : TRIS_RTP_GET_FAILED;
-	text_dest_res = destpr->get_trtp_info ? destpr->get_trtp_info(dest, &tdestp) : TRIS_RTP_GET_FAILED;
-	audio_src_res = srcpr->get_rtp_info(src, &srcp);
-	video_src_res = srcpr->get_vrtp_info ? srcpr->get_vrtp_info(src, &vsrcp) : TRIS_RTP_GET_FAILED;
-	text_src_res = srcpr->get_trtp_info ? srcpr->get_trtp_info(src, &tsrcp) : TRIS_RTP_GET_FAILED;
-
-	/* Ensure we have at least one matching codec */
-	if (srcpr->get_codec)
-		srccodec = srcpr->get_codec(src);
-	else
-		srccodec = 0;
-	if (destpr->get_codec)
-		destcodec = destpr->get_codec(dest);
-	else
-		destcodec = 0;
-
-	/* Check if bridge is still possible (In SIP directmedia=no stops this, like NAT) */
-	if (audio_dest_res != TRIS_RTP_TRY_NATIVE || (video_dest_res != TRIS_RTP_GET_FAILED && video_dest_res != TRIS_RTP_TRY_NATIVE) || audio_src_res != TRIS_RTP_TRY_NATIVE || (video_src_res != TRIS_RTP_GET_FAILED && video_src_res != TRIS_RTP_TRY_NATIVE) || !(srccodec & destcodec)) {
-		/* Somebody doesn't want to play... */
-		tris_channel_unlock(dest);
-		tris_channel_unlock(src);
-		return 0;
-	}
-	tris_rtp_pt_copy(destp, srcp);
-	if (vdestp && vsrcp)
-		tris_rtp_pt_copy(vdestp, vsrcp);
-	if (tdestp && tsrcp)
-		tris_rtp_pt_copy(tdestp, tsrcp);
-	if (media) {
-		/* Bridge early */
-		if (destpr->set_rtp_peer(dest, srcp, vsrcp, tsrcp, srccodec, tris_test_flag(srcp, FLAG_NAT_ACTIVE)))
-			tris_log(LOG_WARNING, "Channel '%s' failed to setup early bridge to '%s'\n", dest->name, src->name);
-	}
-	tris_channel_unlock(dest);
-	tris_channel_unlock(src);
-	tris_debug(1, "Seeded SDP of '%s' with that of '%s'\n", dest->name, src->name);
-	return 1;
-}
-
-/*! \brief  Make a note of a RTP payload type that was seen in a SDP "m=" line.
- * By default, use the well-known value for this type (although it may 
- * still be set to a different value by a subsequent "a=rtpmap:" line)
- */
-void tris_rtp_set_m_type(struct tris_rtp* rtp, int pt) 
-{
-	if (pt < 0 || pt >= MAX_RTP_PT || static_RTP_PT[pt].code == 0) 
-		return; /* bogus payload type */
-
-	rtp_bridge_lock(rtp);
-	rtp->current_RTP_PT[pt] = static_RTP_PT[pt];
-	rtp_bridge_unlock(rtp);
-} 
-
-/*! \brief remove setting from payload type list if the rtpmap header indicates
-	an unknown media type */
-void tris_rtp_unset_m_type(struct tris_rtp* rtp, int pt) 
-{
-	if (pt < 0 || pt >= MAX_RTP_PT)
-		return; /* bogus payload type */
-
-	rtp_bridge_lock(rtp);
-	rtp->current_RTP_PT[pt].isAstFormat = 0;
-	rtp->current_RTP_PT[pt].code = 0;
-	rtp_bridge_unlock(rtp);
-}
-
-/*! \brief Make a note of a RTP payload type (with MIME type) that was seen in
- * an SDP "a=rtpmap:" line.
- * \return 0 if the MIME type was found and set, -1 if it wasn't found
- */
-int tris_rtp_set_rtpmap_type_rate(struct tris_rtp *rtp, int pt,
-				 char *mimeType, char *mimeSubtype,
-				 enum tris_rtp_options options,
-				 unsigned int sample_rate)
-{
-	unsigned int i;
-	int found = 0;
-
-	if (pt < 0 || pt >= MAX_RTP_PT)
-		return -1; /* bogus payload type */
-
-	rtp_bridge_lock(rtp);
-
-	for (i = 0; i < ARRAY_LEN(mimeTypes); ++i) {
-		const struct mimeType *t = &mimeTypes[i];
-
-		if (strcasecmp(mimeSubtype, t->subtype)) {
-			continue;
-		}
-
-		if (strcasecmp(mimeType, t->type)) {
-			continue;
-		}
-
-		/* if both sample rates have been supplied, and they don't match,
-		   then this not a match; if one has not been supplied, then the
-		   rates are not compared */
-		if (sample_rate && t->sample_rate &&
-		    (sample_rate != t->sample_rate)) {
-			continue;
-		}
-
-		found = 1;
-		rtp->current_RTP_PT[pt] = t->payloadType;
-
-		if ((t->payloadType.code == TRIS_FORMAT_G726) &&
-		    t->payloadType.isAstFormat &&
-		    (options & TRIS_RTP_OPT_G726_NONSTANDARD)) {
-			rtp->current_RTP_PT[pt].code = TRIS_FORMAT_G726_AAL2;
-		}
-
-		break;
-	}
-
-	rtp_bridge_unlock(rtp);
-
-	return (found ? 0 : -2);
-}
-
-int tris_rtp_set_rtpmap_type(struct tris_rtp *rtp, int pt,
-			    char *mimeType, char *mimeSubtype,
-			    enum tris_rtp_options options)
-{
-	return tris_rtp_set_rtpmap_type_rate(rtp, pt, mimeType, mimeSubtype, options, 0);
-}
-
-/*! \brief Return the union of all of the codecs that were set by rtp_set...() calls 
- * They're returned as two distinct sets: TRIS_FORMATs, and TRIS_RTPs */
-void tris_rtp_get_current_formats(struct tris_rtp* rtp,
-				 int* astFormats, int* nonAstFormats)
-{
-	int pt;
-	
-	rtp_bridge_lock(rtp);
-	
-	*astFormats = *nonAstFormats = 0;
-	for (pt = 0; pt < MAX_RTP_PT; ++pt) {
-		if (rtp->current_RTP_PT[pt].isAstFormat) {
-			*astFormats |= rtp->current_RTP_PT[pt].code;
-		} else {
-			*nonAstFormats |= rtp->current_RTP_PT[pt].code;
-		}
-	}
-
-	rtp_bridge_unlock(rtp);
-}
-
-struct rtpPayloadType tris_rtp_lookup_pt(struct tris_rtp* rtp, int pt) 
-{
-	struct rtpPayloadType result;
-
-	result.isAstFormat = result.code = 0;
-
-	if (pt < 0 || pt >= MAX_RTP_PT) 
-		return result; /* bogus payload type */
-
-	/* Start with negotiated codecs */
-	rtp_bridge_lock(rtp);
-	result = rtp->current_RTP_PT[pt];
-	rtp_bridge_unlock(rtp);
-
-	/* If it doesn't exist, check our static RTP type list, just in case */
-	if (!result.code) 
-		result = static_RTP_PT[pt];
-
-	return result;
-}
-
-/*! \brief Looks up an RTP code out of our *static* outbound list */
-int tris_rtp_lookup_code(struct tris_rtp* rtp, const int isAstFormat, const int code)
-{
-	int pt = 0;
-
-	rtp_bridge_lock(rtp);
-
-	if (isAstFormat == rtp->rtp_lookup_code_cache_isAstFormat &&
-		code == rtp->rtp_lookup_code_cache_code) {
-		/* Use our cached mapping, to avoid the overhead of the loop below */
-		pt = rtp->rtp_lookup_code_cache_result;
-		rtp_bridge_unlock(rtp);
-		return pt;
-	}
-
-	/* Check the dynamic list first */
-	for (pt = 0; pt < MAX_RTP_PT; ++pt) {
-		if (rtp->current_RTP_PT[pt].code == code && rtp->current_RTP_PT[pt].isAstFormat == isAstFormat) {
-			rtp->rtp_lookup_code_cache_isAstFormat = isAstFormat;
-			rtp->rtp_lookup_code_cache_code = code;
-			rtp->rtp_lookup_code_cache_result = pt;
-			rtp_bridge_unlock(rtp);
-			return pt;
-		}
-	}
-
-	/* Then the static list */
-	for (pt = 0; pt < MAX_RTP_PT; ++pt) {
-		if (static_RTP_PT[pt].code == code && static_RTP_PT[pt].isAstFormat == isAstFormat) {
-			rtp->rtp_lookup_code_cache_isAstFormat = isAstFormat;
-  			rtp->rtp_lookup_code_cache_code = code;
-			rtp->rtp_lookup_code_cache_result = pt;
-			rtp_bridge_unlock(rtp);
-			return pt;
-		}
-	}
-
-	rtp_bridge_unlock(rtp);
-
-	return -1;
-}
-
-const char *tris_rtp_lookup_mime_subtype(const int isAstFormat, const int code,
-				  enum tris_rtp_options options)
-{
-	unsigned int i;
-
-	for (i = 0; i < ARRAY_LEN(mimeTypes); ++i) {
-		if ((mimeTypes[i].payloadType.code == code) && (mimeTypes[i].payloadType.isAstFormat == isAstFormat)) {
-			if (isAstFormat &&
-			    (code == TRIS_FORMAT_G726_AAL2) &&
-			    (options & TRIS_RTP_OPT_G726_NONSTANDARD))
-				return "G726-32";
-			else
-				return mimeTypes[i].subtype;
-		}
-	}
-
-	return "";
-}
-
-unsigned int tris_rtp_lookup_sample_rate(int isAstFormat, int code)
-{
-	unsigned int i;
-
-	for (i = 0; i < ARRAY_LEN(mimeTypes); ++i) {
-		if ((mimeTypes[i].payloadType.code == code) && (mimeTypes[i].payloadType.isAstFormat == isAstFormat)) {
-			return mimeTypes[i].sample_rate;
-		}
-	}
-
-	return 0;
-}
-
-char *tris_rtp_lookup_mime_multiple(char *buf, size_t size, const int capability,
-				   const int isAstFormat, enum tris_rtp_options options)
-{
-	int format;
-	unsigned len;
-	char *end = buf;
-	char *start = buf;
-
-	if (!buf || !size)
-		return NULL;
-
-	snprintf(end, size, "0x%x (", capability);
-
-	len = strlen(end);
-	end += len;
-	size -= len;
-	start = end;
-
-	for (format = 1; format < TRIS_RTP_MAX; format <<= 1) {
-		if (capability & format) {
-			const char *name = tris_rtp_lookup_mime_subtype(isAstFormat, format, options);
-
-			snprintf(end, size, "%s|", name);
-			len = strlen(end);
-			end += len;
-			size -= len;
-		}
-	}
-
-	if (start == end)
-		tris_copy_string(start, "nothing)", size); 
-	else if (size > 1)
-		*(end -1) = ')';
-	
-	return buf;
-}
-
-/*! \brief Open RTP or RTCP socket for a session.
- * Print a message on failure. 
- */
-static int rtp_socket(const char *type)
-{
-	int s = socket(AF_INET, SOCK_DGRAM, 0);
-	if (s < 0) {
-		if (type == NULL)
-			type = "RTP/RTCP";
-		tris_log(LOG_WARNING, "Unable to allocate %s socket: %s\n", type, strerror(errno));
-	} else {
-		long flags = fcntl(s, F_GETFL);
-		fcntl(s, F_SETFL, flags | O_NONBLOCK);
-#ifdef SO_NO_CHECK
-		if (nochecksums)
-			setsockopt(s, SOL_SOCKET, SO_NO_CHECK, &nochecksums, sizeof(nochecksums));
-#endif
-	}
-	return s;
-}
-
-/*!
- * \brief Initialize a new RTCP session.
- * 
- * \returns The newly initialized RTCP session.
- */
-static struct tris_rtcp *tris_rtcp_new(void)
-{
-	struct tris_rtcp *rtcp;
-
-	if (!(rtcp = tris_calloc(1, sizeof(*rtcp))))
-		return NULL;
-	rtcp->s = rtp_socket("RTCP");
-	rtcp->us.sin_family = AF_INET;
-	rtcp->them.sin_family = AF_INET;
-	rtcp->schedid = -1;
-
-	if (rtcp->s < 0) {
-		tris_free(rtcp);
-		return NULL;
-	}
-
-	return rtcp;
-}
-
-/*!
- * \brief Initialize a new RTP structure.
- *
- */
-void tris_rtp_new_init(struct tris_rtp *rtp)
-{
-#ifdef P2P_INTENSE
-	tris_mutex_init(&rtp->bridge_lock);
-#endif
-
-	rtp->them.sin_family = AF_INET;
-	rtp->us.sin_family = AF_INET;
-	rtp->ssrc = tris_random();
-	rtp->seqno = tris_random() & 0xffff;
-	tris_set_flag(rtp, FLAG_HAS_DTMF);
-	rtp->strict_rtp_state = (strictrtp ? STRICT_RTP_LEARN : STRICT_RTP_OPEN);
-}
-
-struct tris_rtp *tris_rtp_new_with_bindaddr(struct sched_context *sched, struct io_context *io, int rtcpenable, int callbackmode, struct in_addr addr)
-{
-	struct tris_rtp *rtp;
-	int x;
-	int startplace;
-	
-	if (!(rtp = tris_calloc(1, sizeof(*rtp))))
-		return NULL;
-
-	tris_rtp_new_init(rtp);
-
-	rtp->s = rtp_socket("RTP");
-	if (rtp->s < 0)
-		goto fail;
-	if (sched && rtcpenable) {
-		rtp->sched = sched;
-		rtp->rtcp = tris_rtcp_new();
-	}
-	
-	/*
-	 * Try to bind the RTP port, x, and possibly the RTCP port, x+1 as well.
-	 * Start from a random (even, by RTP spec) port number, and
-	 * iterate until success or no ports are available.
-	 * Note that the requirement of RTP port being even, or RTCP being the
-	 * next one, cannot be enforced in presence of a NAT box because the
-	 * mapping is not under our control.
-	 */
-	x = (rtpend == rtpstart) ? rtpstart : (tris_random() % (rtpend - rtpstart)) + rtpstart;
-	x = x & ~1;		/* make it an even number */
-	startplace = x;		/* remember the starting point */
-	/* this is constant across the loop */
-	rtp->us.sin_addr = addr;
-	if (rtp->rtcp)
-		rtp->rtcp->us.sin_addr = addr;
-	for (;;) {
-		rtp->us.sin_port = htons(x);
-		if (!bind(rtp->s, (struct sockaddr *)&rtp->us, sizeof(rtp->us))) {
-			/* bind succeeded, if no rtcp then we are done */
-			if (!rtp->rtcp)
-				break;
-			/* have rtcp, try to bind it */
-			rtp->rtcp->us.sin_port = htons(x + 1);
-			if (!bind(rtp->rtcp->s, (struct sockaddr *)&rtp->rtcp->us, sizeof(rtp->rtcp->us)))
-				break;	/* success again, we are really done */
-			/*
-			 * RTCP bind failed, so close and recreate the
-			 * already bound RTP socket for the next round.
-			 */
-			close(rtp->s);
-			rtp->s = rtp_socket("RTP");
-			if (rtp->s < 0)
-				goto fail;
-		}
-		/*
-		 * If we get here, there was an error in one of the bind()
-		 * calls, so make sure it is nothing unexpected.
-		 */
-		if (errno != EADDRINUSE) {
-			/* We got an error that wasn't expected, abort! */
-			tris_log(LOG_ERROR, "Unexpected bind error: %s\n", strerror(errno));
-			goto fail;
-		}
-		/*
-		 * One of the ports is in use. For the next iteration,
-		 * increment by two and handle wraparound.
-		 * If we reach the starting point, then declare failure.
-		 */
-		x += 2;
-		if (x > rtpend)
-			x = (rtpstart + 1) & ~1;
-		if (x == startplace) {
-			tris_log(LOG_ERROR, "No RTP ports remaining. Can't setup media stream for this call.\n");
-			goto fail;
-		}
-	}
-	rtp->sched = sched;
-	rtp->io = io;
-	if (callbackmode) {
-		rtp->ioid = tris_io_add(rtp->io, rtp->s, rtpread, TRIS_IO_IN, rtp);
-		tris_set_flag(rtp, FLAG_CALLBACK_MODE);
-	}
-	tris_rtp_pt_default(rtp);
-	rtp->rawdata = tris_calloc(1, 8192*10+TRIS_FRIENDLY_OFFSET);
-	return rtp;
-
-fail:
-	if (rtp->s >= 0)
-		close(rtp->s);
-	if (rtp->rtcp) {
-		close(rtp->rtcp->s);
-		tris_free(rtp->rtcp);
-	}
-	tris_free(rtp);
-	return NULL;
-}
-
-struct tris_rtp *tris_rtp_new(struct sched_context *sched, struct io_context *io, int rtcpenable, int callbackmode)
-{
-	struct in_addr ia;
-
-	memset(&ia, 0, sizeof(ia));
-	return tris_rtp_new_with_bindaddr(sched, io, rtcpenable, callbackmode, ia);
-}
-
-int tris_rtp_setqos(struct tris_rtp *rtp, int type_of_service, int class_of_service, char *desc)
-{
-	return tris_netsock_set_qos(rtp->s, type_of_service, class_of_service, desc);
-}
-
-void tris_rtp_set_constantssrc(struct tris_rtp *rtp)
-{
-	rtp->constantssrc = 1;
-}
-
-void tris_rtp_new_source(struct tris_rtp *rtp)
-{
-	if (rtp) {
-		rtp->set_marker_bit = 1;
-		if (!rtp->constantssrc) {
-			rtp->ssrc = tris_random();
-		}
-	}
-}
-
-void tris_rtp_change_source(struct tris_rtp *rtp)
-{
-	if (rtp) {
-		unsigned int ssrc = tris_random();
-
-		rtp->set_marker_bit = 1;
-		tris_debug(3, "Changing ssrc from %u to %u due to a source change\n", rtp->ssrc, ssrc);
-		rtp->ssrc = ssrc;
-	}
-}
-
-void tris_rtp_set_peer(struct tris_rtp *rtp, struct sockaddr_in *them)
-{
-	rtp->them.sin_port = them->sin_port;
-	rtp->them.sin_addr = them->sin_addr;
-	if (rtp->rtcp) {
-		int h = ntohs(them->sin_port);
-		rtp->rtcp->them.sin_port = htons(h + 1);
-		rtp->rtcp->them.sin_addr = them->sin_addr;
-	}
-	rtp->rxseqno = 0;
-	/* If strict RTP protection is enabled switch back to the learn state so we don't drop packets from above */
-	if (strictrtp)
-		rtp->strict_rtp_state = STRICT_RTP_LEARN;
-}
-
-void tris_rtp_set_us(struct tris_rtp *rtp, struct sockaddr_in *us)
-{
-	rtp->us.sin_port = us->sin_port;
-	rtp->us.sin_addr = us->sin_addr;
-	if (rtp->rtcp) {
-		int h = ntohs(us->sin_port);
-		rtp->rtcp->us.sin_port = htons(h + 1);
-		rtp->rtcp->us.sin_addr = us->sin_addr;
-	}
-
-	close(rtp->s);
-	rtp->s = rtp_socket("RTP");
-	if (rtp->s < 0)
-		return;
-
-	if (!bind(rtp->s, (struct sockaddr *)&rtp->us, sizeof(rtp->us))) {
-		/* bind succeeded, if no rtcp then we are done */
-		if (rtp->rtcp) {
-			close(rtp->rtcp->s);
-			rtp->rtcp->s = rtp_socket("RTCP");
-			if (rtp->rtcp->s < 0)
-				return;
-			/* have rtcp, try to bind it */
-			if (!bind(rtp->rtcp->s, (struct sockaddr *)&rtp->rtcp->us, sizeof(rtp->rtcp->us)))
-				return;
-			else
-				return;
-			/*
-			 * RTCP bind failed, so close and recreate the
-			 * already bound RTP socket for the next round.
-			 */
-		}
-	} else {
-		return;
-	}
-}
-
-void tris_rtp_set_alt_peer(struct tris_rtp *rtp, struct sockaddr_in *alt)
-{
-	rtp->altthem.sin_port = alt->sin_port;
-	rtp->altthem.sin_addr = alt->sin_addr;
-	if (rtp->rtcp) {
-		rtp->rtcp->altthem.sin_port = htons(ntohs(alt->sin_port) + 1);
-		rtp->rtcp->altthem.sin_addr = alt->sin_addr;
+	/* Check if bridge is still possible (In SIP directmedia=no stops this, like NAT) */
+	if (audio_dest_res != TRIS_RTP_TRY_NATIVE || (video_dest_res != TRIS_RTP_GET_FAILED && video_dest_res != TRIS_RTP_TRY_NATIVE)) {
+		/* Somebody doesn't want to play... */
+		tris_channel_unlock(c0);
+		if (c1)
+			tris_channel_unlock(c1);
+		return -1;
 	}
-}
-
-int tris_rtp_get_peer(struct tris_rtp *rtp, struct sockaddr_in *them)
-{
-	if ((them->sin_family != AF_INET) ||
-		(them->sin_port != rtp->them.sin_port) ||
-		(them->sin_addr.s_addr != rtp->them.sin_addr.s_addr)) {
-		them->sin_family = AF_INET;
-		them->sin_port = rtp->them.sin_port;
-		them->sin_addr = rtp->them.sin_addr;
-		return 1;
+	if (audio_src_res == TRIS_RTP_TRY_NATIVE && (video_src_res == TRIS_RTP_GET_FAILED || video_src_res == TRIS_RTP_TRY_NATIVE) && srcpr->get_codec)
+		srccodec = srcpr->get_codec(c1);
+	else
+		srccodec = 0;
+	if (audio_dest_res == TRIS_RTP_TRY_NATIVE && (video_dest_res == TRIS_RTP_GET_FAILED || video_dest_res == TRIS_RTP_TRY_NATIVE) && destpr->get_codec)
+		destcodec = destpr->get_codec(c0);
+	else
+		destcodec = 0;
+	/* Ensure we have at least one matching codec */
+	if (srcp && !(srccodec & destcodec)) {
+		tris_channel_unlock(c0);
+		tris_channel_unlock(c1);
+		return 0;
 	}
+	/* Consider empty media as non-existent */
+	if (audio_src_res == TRIS_RTP_TRY_NATIVE && !srcp->them.sin_addr.s_addr)
+		srcp = NULL;
+	if (srcp && (srcp->nat || tris_test_flag(srcp, FLAG_NAT_ACTIVE)))
+		nat_active = 1;
+	/* Bridge media early */
+	if (destpr->set_rtp_peer(c0, srcp, vsrcp, tsrcp, srccodec, nat_active))
+		tris_log(LOG_WARNING, "Channel '%s' failed to setup early bridge to '%s'\n", c0->name, c1 ? c1->name : "<unspecified>");
+	tris_channel_unlock(c0);
+	if (c1)
+		tris_channel_unlock(c1);
+	tris_debug(1, "Setting early bridge SDP of '%s' with that of '%s'\n", c0->name, c1 ? c1->name : "<unspecified>");
 	return 0;
 }
 
-void tris_rtp_get_us(struct tris_rtp *rtp, struct sockaddr_in *us)
-{
-	*us = rtp->us;
-}
-
-struct tris_rtp *tris_rtp_get_bridged(struct tris_rtp *rtp)
-{
-	struct tris_rtp *bridged = NULL;
-
-	rtp_bridge_lock(rtp);
-	bridged = rtp->bridged;
-	rtp_bridge_unlock(rtp);
-
-	return bridged;
-}
-
-void tris_rtp_stop(struct tris_rtp *rtp)
-{
-	if (rtp->rtcp) {
-		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
-	}
-	if (rtp->red) {
-		TRIS_SCHED_DEL(rtp->sched, rtp->red->schedid);
-		free(rtp->red);
-		rtp->red = NULL;
-	}
-
-	memset(&rtp->them.sin_addr, 0, sizeof(rtp->them.sin_addr));
-	memset(&rtp->them.sin_port, 0, sizeof(rtp->them.sin_port));
-	if (rtp->rtcp) {
-		memset(&rtp->rtcp->them.sin_addr, 0, sizeof(rtp->rtcp->them.sin_addr));
-		memset(&rtp->rtcp->them.sin_port, 0, sizeof(rtp->rtcp->them.sin_port));
-	}
-	
-	tris_clear_flag(rtp, FLAG_P2P_SENT_MARK);
-}
-
-void tris_rtp_reset(struct tris_rtp *rtp)
-{
-	memset(&rtp->rxcore, 0, sizeof(rtp->rxcore));
-	memset(&rtp->txcore, 0, sizeof(rtp->txcore));
-	memset(&rtp->dtmfmute, 0, sizeof(rtp->dtmfmute));
-	rtp->lastts = 0;
-	rtp->lastdigitts = 0;
-	rtp->lastrxts = 0;
-	rtp->lastividtimestamp = 0;
-	rtp->lastovidtimestamp = 0;
-	rtp->lastitexttimestamp = 0;
-	rtp->lastotexttimestamp = 0;
-	rtp->lasteventseqn = 0;
-	rtp->lastevent = 0;
-	rtp->lasttxformat = 0;
-	rtp->lastrxformat = 0;
-	rtp->dtmf_timeout = 0;
-	rtp->dtmfsamples = 0;
-	rtp->seqno = 0;
-	rtp->rxseqno = 0;
-}
-
-/*! Get QoS values from RTP and RTCP data (used in "sip show channelstats") */
-unsigned int tris_rtp_get_qosvalue(struct tris_rtp *rtp, enum tris_rtp_qos_vars value)
+int tris_rtp_make_compatible(struct tris_channel *dest, struct tris_channel *src, int media)
 {
-	if (rtp == NULL) {
-		if (option_debug > 1)
-			tris_log(LOG_DEBUG, "NO RTP Structure? Kidding me? \n");
-		return 0;
-	}
-	if (option_debug > 1 && rtp->rtcp == NULL) {
-		tris_log(LOG_DEBUG, "NO RTCP structure. Maybe in RTP p2p bridging mode? \n");
-	}
+	struct tris_rtp *destp = NULL, *srcp = NULL;		/* Audio RTP Channels */
+	struct tris_rtp *vdestp = NULL, *vsrcp = NULL;		/* Video RTP channels */
+	struct tris_rtp *tdestp = NULL, *tsrcp = NULL;		/* Text RTP channels */
+	struct tris_rtp_protocol *destpr = NULL, *srcpr = NULL;
+	enum tris_rtp_get_result audio_dest_res = TRIS_RTP_GET_FAILED, video_dest_res = TRIS_RTP_GET_FAILED, text_dest_res = TRIS_RTP_GET_FAILED;
+	enum tris_rtp_get_result audio_src_res = TRIS_RTP_GET_FAILED, video_src_res = TRIS_RTP_GET_FAILED, text_src_res = TRIS_RTP_GET_FAILED; 
+	format_t srccodec, destcodec;
 
-	switch (value) {
-	case TRIS_RTP_TXCOUNT:
-		return (unsigned int) rtp->txcount;
-	case TRIS_RTP_RXCOUNT:
-		return (unsigned int) rtp->rxcount;
-	case TRIS_RTP_TXJITTER:
-		return (unsigned int) (rtp->rxjitter * 1000.0);
-	case TRIS_RTP_RXJITTER:
-		return (unsigned int) (rtp->rtcp ? (rtp->rtcp->reported_jitter / (unsigned int) 65536.0) : 0);
-	case TRIS_RTP_RXPLOSS:
-		return rtp->rtcp ? (rtp->rtcp->expected_prior - rtp->rtcp->received_prior) : 0;
-	case TRIS_RTP_TXPLOSS:
-		return rtp->rtcp ? rtp->rtcp->reported_lost : 0;
-	case TRIS_RTP_RTT:
-		return (unsigned int) (rtp->rtcp ? (rtp->rtcp->rtt * 100) : 0);
+	/* Lock channels */
+	tris_channel_lock(dest);
+	while (tris_channel_trylock(src)) {
+		tris_channel_unlock(dest);
+		usleep(1);
+		tris_channel_lock(dest);
 	}
-	return 0;	/* To make the compiler happy */
-}
-
-static double __tris_rtp_get_qos(struct tris_rtp *rtp, const char *qos, int *found)
-{
-	*found = 1;
-
-	if (!strcasecmp(qos, "remote_maxjitter"))
-		return rtp->rtcp->reported_maxjitter * 1000.0;
-	if (!strcasecmp(qos, "remote_minjitter"))
-		return rtp->rtcp->reported_minjitter * 1000.0;
-	if (!strcasecmp(qos, "remote_normdevjitter"))
-		return rtp->rtcp->reported_normdev_jitter * 1000.0;
-	if (!strcasecmp(qos, "remote_stdevjitter"))
-		return sqrt(rtp->rtcp->reported_stdev_jitter) * 1000.0;
 
-	if (!strcasecmp(qos, "local_maxjitter"))
-		return rtp->rtcp->maxrxjitter * 1000.0;
-	if (!strcasecmp(qos, "local_minjitter"))
-		return rtp->rtcp->minrxjitter * 1000.0;
-	if (!strcasecmp(qos, "local_normdevjitter"))
-		return rtp->rtcp->normdev_rxjitter * 1000.0;
-	if (!strcasecmp(qos, "local_stdevjitter"))
-		return sqrt(rtp->rtcp->stdev_rxjitter) * 1000.0;
+	/* Find channel driver interfaces */
+	if (!(destpr = get_proto(dest))) {
+		tris_debug(1, "Channel '%s' has no RTP, not doing anything\n", dest->name);
+		tris_channel_unlock(dest);
+		tris_channel_unlock(src);
+		return 0;
+	}
+	if (!(srcpr = get_proto(src))) {
+		tris_debug(1, "Channel '%s' has no RTP, not doing anything\n", src->name);
+		tris_channel_unlock(dest);
+		tris_channel_unlock(src);
+		return 0;
+	}
 
-	if (!strcasecmp(qos, "maxrtt"))
-		return rtp->rtcp->maxrtt * 1000.0;
-	if (!strcasecmp(qos, "minrtt"))
-		return rtp->rtcp->minrtt * 1000.0;
-	if (!strcasecmp(qos, "normdevrtt"))
-		return rtp->rtcp->normdevrtt * 1000.0;
-	if (!strcasecmp(qos, "stdevrtt"))
-		return sqrt(rtp->rtcp->stdevrtt) * 1000.0;
+	/* Get audio and video interface (if native bridge is possible) */
+	audio_dest_res = destpr->get_rtp_info(dest, &destp);
+	video_dest_res = destpr->get_vrtp_info ? destpr->get_vrtp_info(dest, &vdestp) : TRIS_RTP_GET_FAILED;
+	text_dest_res = destpr->get_trtp_info ? destpr->get_trtp_info(dest, &tdestp) : TRIS_RTP_GET_FAILED;
+	audio_src_res = srcpr->get_rtp_info(src, &srcp);
+	video_src_res = srcpr->get_vrtp_info ? srcpr->get_vrtp_info(src, &vsrcp) : TRIS_RTP_GET_FAILED;
+	text_src_res = srcpr->get_trtp_info ? srcpr->get_trtp_info(src, &tsrcp) : TRIS_RTP_GET_FAILED;
 
-	*found = 0;
+	/* Ensure we have at least one matching codec */
+	if (srcpr->get_codec)
+		srccodec = srcpr->get_codec(src);
+	else
+		srccodec = 0;
+	if (destpr->get_codec)
+		destcodec = destpr->get_codec(dest);
+	else
+		destcodec = 0;
 
-	return 0.0;
+	/* Check if bridge is still possible (In SIP directmedia=no stops this, like NAT) */
+	if (audio_dest_res != TRIS_RTP_TRY_NATIVE || (video_dest_res != TRIS_RTP_GET_FAILED && video_dest_res != TRIS_RTP_TRY_NATIVE) || audio_src_res != TRIS_RTP_TRY_NATIVE || (video_src_res != TRIS_RTP_GET_FAILED && video_src_res != TRIS_RTP_TRY_NATIVE) || !(srccodec & destcodec)) {
+		/* Somebody doesn't want to play... */
+		tris_channel_unlock(dest);
+		tris_channel_unlock(src);
+		return 0;
+	}
+	tris_rtp_pt_copy(destp, srcp);
+	if (vdestp && vsrcp)
+		tris_rtp_pt_copy(vdestp, vsrcp);
+	if (tdestp && tsrcp)
+		tris_rtp_pt_copy(tdestp, tsrcp);
+	if (media) {
+		/* Bridge early */
+		if (destpr->set_rtp_peer(dest, srcp, vsrcp, tsrcp, srccodec, tris_test_flag(srcp, FLAG_NAT_ACTIVE)))
+			tris_log(LOG_WARNING, "Channel '%s' failed to setup early bridge to '%s'\n", dest->name, src->name);
+	}
+	tris_channel_unlock(dest);
+	tris_channel_unlock(src);
+	tris_debug(1, "Seeded SDP of '%s' with that of '%s'\n", dest->name, src->name);
+	return 1;
 }
 
-int tris_rtp_get_qos(struct tris_rtp *rtp, const char *qos, char *buf, unsigned int buflen)
+/*! \brief  Make a note of a RTP payload type that was seen in a SDP "m=" line.
+ * By default, use the well-known value for this type (although it may 
+ * still be set to a different value by a subsequent "a=rtpmap:" line)
+ */
+void tris_rtp_set_m_type(struct tris_rtp* rtp, int pt) 
 {
-	double value;
-	int found;
-
-	value = __tris_rtp_get_qos(rtp, qos, &found);
+	if (pt < 0 || pt >= MAX_RTP_PT || static_RTP_PT[pt].code == 0) 
+		return; /* bogus payload type */
 
-	if (!found)
-		return -1;
+	rtp_bridge_lock(rtp);
+	rtp->current_RTP_PT[pt] = static_RTP_PT[pt];
+	rtp_bridge_unlock(rtp);
+} 
 
-	snprintf(buf, buflen, "%.0lf", value);
+/*! \brief remove setting from payload type list if the rtpmap header indicates
+	an unknown media type */
+void tris_rtp_unset_m_type(struct tris_rtp* rtp, int pt) 
+{
+	if (pt < 0 || pt >= MAX_RTP_PT)
+		return; /* bogus payload type */
 
-	return 0;
+	rtp_bridge_lock(rtp);
+	rtp->current_RTP_PT[pt].isAstFormat = 0;
+	rtp->current_RTP_PT[pt].code = 0;
+	rtp_bridge_unlock(rtp);
 }
 
-void tris_rtp_set_vars(struct tris_channel *chan, struct tris_rtp *rtp) {
-	char *audioqos;
-	char *audioqos_jitter;
-	char *audioqos_loss;
-	char *audioqos_rtt;
-	struct tris_channel *bridge;
+/*! \brief Make a note of a RTP payload type (with MIME type) that was seen in
+ * an SDP "a=rtpmap:" line.
+ * \return 0 if the MIME type was found and set, -1 if it wasn't found
+ */
+int tris_rtp_set_rtpmap_type_rate(struct tris_rtp *rtp, int pt,
+				 char *mimeType, char *mimeSubtype,
+				 enum tris_rtp_options options,
+				 unsigned int sample_rate)
+{
+	unsigned int i;
+	int found = 0;
 
-	if (!rtp || !chan)
-		return;
+	if (pt < 0 || pt >= MAX_RTP_PT)
+		return -1; /* bogus payload type */
 
-	bridge = tris_bridged_channel(chan);
+	rtp_bridge_lock(rtp);
 
-	audioqos        = tris_rtp_get_quality(rtp, NULL, RTPQOS_SUMMARY);
-	audioqos_jitter = tris_rtp_get_quality(rtp, NULL, RTPQOS_JITTER);
-	audioqos_loss   = tris_rtp_get_quality(rtp, NULL, RTPQOS_LOSS);
-	audioqos_rtt    = tris_rtp_get_quality(rtp, NULL, RTPQOS_RTT);
+	for (i = 0; i < ARRAY_LEN(mimeTypes); ++i) {
+		const struct mimeType *t = &mimeTypes[i];
 
-	pbx_builtin_setvar_helper(chan, "RTPAUDIOQOS", audioqos);
-	pbx_builtin_setvar_helper(chan, "RTPAUDIOQOSJITTER", audioqos_jitter);
-	pbx_builtin_setvar_helper(chan, "RTPAUDIOQOSLOSS", audioqos_loss);
-	pbx_builtin_setvar_helper(chan, "RTPAUDIOQOSRTT", audioqos_rtt);
+		if (strcasecmp(mimeSubtype, t->subtype)) {
+			continue;
+		}
 
-	if (!bridge)
-		return;
+		if (strcasecmp(mimeType, t->type)) {
+			continue;
+		}
 
-	pbx_builtin_setvar_helper(bridge, "RTPAUDIOQOSBRIDGED", audioqos);
-	pbx_builtin_setvar_helper(bridge, "RTPAUDIOQOSJITTERBRIDGED", audioqos_jitter);
-	pbx_builtin_setvar_helper(bridge, "RTPAUDIOQOSLOSSBRIDGED", audioqos_loss);
-	pbx_builtin_setvar_helper(bridge, "RTPAUDIOQOSRTTBRIDGED", audioqos_rtt);
-}
+		/* if both sample rates have been supplied, and they don't match,
+		   then this not a match; if one has not been supplied, then the
+		   rates are not compared */
+		if (sample_rate && t->sample_rate &&
+		    (sample_rate != t->sample_rate)) {
+			continue;
+		}
 
-static char *__tris_rtp_get_quality_jitter(struct tris_rtp *rtp)
-{
-	/*
-	*ssrc          our ssrc
-	*themssrc      their ssrc
-	*lp            lost packets
-	*rxjitter      our calculated jitter(rx)
-	*rxcount       no. received packets
-	*txjitter      reported jitter of the other end
-	*txcount       transmitted packets
-	*rlp           remote lost packets
-	*rtt           round trip time
-	*/
-#define RTCP_JITTER_FORMAT1 \
-	"minrxjitter=%f;" \
-	"maxrxjitter=%f;" \
-	"avgrxjitter=%f;" \
-	"stdevrxjitter=%f;" \
-	"reported_minjitter=%f;" \
-	"reported_maxjitter=%f;" \
-	"reported_avgjitter=%f;" \
-	"reported_stdevjitter=%f;"
+		found = 1;
+		rtp->current_RTP_PT[pt] = t->payloadType;
 
-#define RTCP_JITTER_FORMAT2 \
-	"rxjitter=%f;"
+		if ((t->payloadType.code == TRIS_FORMAT_G726) &&
+		    t->payloadType.isAstFormat &&
+		    (options & TRIS_RTP_OPT_G726_NONSTANDARD)) {
+			rtp->current_RTP_PT[pt].code = TRIS_FORMAT_G726_AAL2;
+		}
 
-	if (rtp->rtcp && rtp->rtcp->rtcp_info) {
-		snprintf(rtp->rtcp->quality_jitter, sizeof(rtp->rtcp->quality_jitter), RTCP_JITTER_FORMAT1,
-			rtp->rtcp->minrxjitter,
-			rtp->rtcp->maxrxjitter,
-			rtp->rtcp->normdev_rxjitter,
-			sqrt(rtp->rtcp->stdev_rxjitter),
-			rtp->rtcp->reported_minjitter,
-			rtp->rtcp->reported_maxjitter,
-			rtp->rtcp->reported_normdev_jitter,
-			sqrt(rtp->rtcp->reported_stdev_jitter)
-		);
-	} else {
-		snprintf(rtp->rtcp->quality_jitter, sizeof(rtp->rtcp->quality_jitter), RTCP_JITTER_FORMAT2,
-			rtp->rxjitter
-		);
+		break;
 	}
 
-	return rtp->rtcp->quality_jitter;
+	rtp_bridge_unlock(rtp);
 
-#undef RTCP_JITTER_FORMAT1
-#undef RTCP_JITTER_FORMAT2
+	return (found ? 0 : -2);
 }
 
-static char *__tris_rtp_get_quality_loss(struct tris_rtp *rtp)
+int tris_rtp_set_rtpmap_type(struct tris_rtp *rtp, int pt,
+			    char *mimeType, char *mimeSubtype,
+			    enum tris_rtp_options options)
 {
-	unsigned int lost;
-	unsigned int extended;
-	unsigned int expected;
-	int fraction;
-
-#define RTCP_LOSS_FORMAT1 \
-	"minrxlost=%f;" \
-	"maxrxlost=%f;" \
-	"avgrxlostr=%f;" \
-	"stdevrxlost=%f;" \
-	"reported_minlost=%f;" \
-	"reported_maxlost=%f;" \
-	"reported_avglost=%f;" \
-	"reported_stdevlost=%f;"
+	return tris_rtp_set_rtpmap_type_rate(rtp, pt, mimeType, mimeSubtype, options, 0);
+}
 
-#define RTCP_LOSS_FORMAT2 \
-	"lost=%d;" \
-	"expected=%d;"
+/*! \brief Return the union of all of the codecs that were set by rtp_set...() calls 
+ * They're returned as two distinct sets: TRIS_FORMATs, and TRIS_RTPs */
+void tris_rtp_get_current_formats(struct tris_rtp* rtp,
+				 format_t *astFormats, int *nonAstFormats)
+{
+	int pt;
 	
-	if (rtp->rtcp && rtp->rtcp->rtcp_info && rtp->rtcp->maxrxlost > 0) {
-		snprintf(rtp->rtcp->quality_loss, sizeof(rtp->rtcp->quality_loss), RTCP_LOSS_FORMAT1,
-			rtp->rtcp->minrxlost,
-			rtp->rtcp->maxrxlost,
-			rtp->rtcp->normdev_rxlost,
-			sqrt(rtp->rtcp->stdev_rxlost),
-			rtp->rtcp->reported_minlost,
-			rtp->rtcp->reported_maxlost,
-			rtp->rtcp->reported_normdev_lost,
-			sqrt(rtp->rtcp->reported_stdev_lost)
-		);
-	} else {
-		extended = rtp->cycles + rtp->lastrxseqno;
-		expected = extended - rtp->seedrxseqno + 1;
-		if (rtp->rxcount > expected) 
-			expected += rtp->rxcount - expected;
-		lost = expected - rtp->rxcount;
-
-		if (!expected || lost <= 0)
-			fraction = 0;
-		else
-			fraction = (lost << 8) / expected;
-
-		snprintf(rtp->rtcp->quality_loss, sizeof(rtp->rtcp->quality_loss), RTCP_LOSS_FORMAT2,
-			lost,
-			expected
-		);
+	rtp_bridge_lock(rtp);
+	
+	*astFormats = *nonAstFormats = 0;
+	for (pt = 0; pt < MAX_RTP_PT; ++pt) {
+		if (rtp->current_RTP_PT[pt].isAstFormat) {
+			*astFormats |= rtp->current_RTP_PT[pt].code;
+		} else {
+			*nonAstFormats |= rtp->current_RTP_PT[pt].code;
+		}
 	}
 
-	return rtp->rtcp->quality_loss;
-
-#undef RTCP_LOSS_FORMAT1
-#undef RTCP_LOSS_FORMAT2
+	rtp_bridge_unlock(rtp);
 }
 
-static char *__tris_rtp_get_quality_rtt(struct tris_rtp *rtp)
+struct rtpPayloadType tris_rtp_lookup_pt(struct tris_rtp* rtp, int pt) 
 {
-	if (rtp->rtcp && rtp->rtcp->rtcp_info) {
-		snprintf(rtp->rtcp->quality_rtt, sizeof(rtp->rtcp->quality_rtt), "minrtt=%f;maxrtt=%f;avgrtt=%f;stdevrtt=%f;",
-			rtp->rtcp->minrtt,
-			rtp->rtcp->maxrtt,
-			rtp->rtcp->normdevrtt,
-			sqrt(rtp->rtcp->stdevrtt)
-		);
-	} else {
-		snprintf(rtp->rtcp->quality_rtt, sizeof(rtp->rtcp->quality_rtt), "Not available");
-	}
+	struct rtpPayloadType result;
 
-	return rtp->rtcp->quality_rtt;
-}
+	result.isAstFormat = result.code = 0;
 
-static char *__tris_rtp_get_quality(struct tris_rtp *rtp)
-{
-	/*
-	*ssrc          our ssrc
-	*themssrc      their ssrc
-	*lp            lost packets
-	*rxjitter      our calculated jitter(rx)
-	*rxcount       no. received packets
-	*txjitter      reported jitter of the other end
-	*txcount       transmitted packets
-	*rlp           remote lost packets
-	*rtt           round trip time
-	*/	
+	if (pt < 0 || pt >= MAX_RTP_PT) 
+		return result; /* bogus payload type */
 
-	if (rtp->rtcp && rtp->rtcp->rtcp_info) {
-		snprintf(rtp->rtcp->quality, sizeof(rtp->rtcp->quality),
-			"ssrc=%u;themssrc=%u;lp=%u;rxjitter=%f;rxcount=%u;txjitter=%f;txcount=%u;rlp=%u;rtt=%f",
-			rtp->ssrc,
-			rtp->themssrc,
-			rtp->rtcp->expected_prior - rtp->rtcp->received_prior,
-			rtp->rxjitter,
-			rtp->rxcount,
-			(double)rtp->rtcp->reported_jitter / 65536.0,
-			rtp->txcount,
-			rtp->rtcp->reported_lost,
-			rtp->rtcp->rtt
-		);
-	} else {
-		snprintf(rtp->rtcp->quality, sizeof(rtp->rtcp->quality), "ssrc=%u;themssrc=%u;rxjitter=%f;rxcount=%u;txcount=%u;",
-			rtp->ssrc,
-			rtp->themssrc,
-			rtp->rxjitter,
-			rtp->rxcount,
-			rtp->txcount
-		);
-	}
+	/* Start with negotiated codecs */
+	rtp_bridge_lock(rtp);
+	result = rtp->current_RTP_PT[pt];
+	rtp_bridge_unlock(rtp);
 
-	return rtp->rtcp->quality;
+	/* If it doesn't exist, check our static RTP type list, just in case */
+	if (!result.code) 
+		result = static_RTP_PT[pt];
+
+	return result;
 }
 
-char *tris_rtp_get_quality(struct tris_rtp *rtp, struct tris_rtp_quality *qual, enum tris_rtp_quality_type qtype) 
+/*! \brief Looks up an RTP code out of our *static* outbound list */
+int tris_rtp_lookup_code(struct tris_rtp* rtp, const int isAstFormat, const format_t code)
 {
-	if (qual && rtp) {
-		qual->local_ssrc   = rtp->ssrc;
-		qual->local_jitter = rtp->rxjitter;
-		qual->local_count  = rtp->rxcount;
-		qual->remote_ssrc  = rtp->themssrc;
-		qual->remote_count = rtp->txcount;
+	int pt = 0;
 
-		if (rtp->rtcp) {
-			qual->local_lostpackets  = rtp->rtcp->expected_prior - rtp->rtcp->received_prior;
-			qual->remote_lostpackets = rtp->rtcp->reported_lost;
-			qual->remote_jitter      = rtp->rtcp->reported_jitter / 65536.0;
-			qual->rtt                = rtp->rtcp->rtt;
+	rtp_bridge_lock(rtp);
+
+	if (isAstFormat == rtp->rtp_lookup_code_cache_isAstFormat &&
+		code == rtp->rtp_lookup_code_cache_code) {
+		/* Use our cached mapping, to avoid the overhead of the loop below */
+		pt = rtp->rtp_lookup_code_cache_result;
+		rtp_bridge_unlock(rtp);
+		return pt;
+	}
+
+	/* Check the dynamic list first */
+	for (pt = 0; pt < MAX_RTP_PT; ++pt) {
+		if (rtp->current_RTP_PT[pt].code == code && rtp->current_RTP_PT[pt].isAstFormat == isAstFormat) {
+			rtp->rtp_lookup_code_cache_isAstFormat = isAstFormat;
+			rtp->rtp_lookup_code_cache_code = code;
+			rtp->rtp_lookup_code_cache_result = pt;
+			rtp_bridge_unlock(rtp);
+			return pt;
 		}
 	}
 
-	switch (qtype) {
-	case RTPQOS_SUMMARY:
-		return __tris_rtp_get_quality(rtp);
-	case RTPQOS_JITTER:
-		return __tris_rtp_get_quality_jitter(rtp);
-	case RTPQOS_LOSS:
-		return __tris_rtp_get_quality_loss(rtp);
-	case RTPQOS_RTT:
-		return __tris_rtp_get_quality_rtt(rtp);
+	/* Then the static list */
+	for (pt = 0; pt < MAX_RTP_PT; ++pt) {
+		if (static_RTP_PT[pt].code == code && static_RTP_PT[pt].isAstFormat == isAstFormat) {
+			rtp->rtp_lookup_code_cache_isAstFormat = isAstFormat;
+  			rtp->rtp_lookup_code_cache_code = code;
+			rtp->rtp_lookup_code_cache_result = pt;
+			rtp_bridge_unlock(rtp);
+			return pt;
+		}
 	}
 
-	return NULL;
+	rtp_bridge_unlock(rtp);
+
+	return -1;
 }
 
-void tris_rtp_destroy(struct tris_rtp *rtp)
+const char *tris_rtp_lookup_mime_subtype(const int isAstFormat, const format_t code,
+				  enum tris_rtp_options options)
 {
-	if (rtcp_debug_test_addr(&rtp->them) || rtcpstats) {
-		/*Print some info on the call here */
-		tris_verbose("  RTP-stats\n");
-		tris_verbose("* Our Receiver:\n");
-		tris_verbose("  SSRC:		 %u\n", rtp->themssrc);
-		tris_verbose("  Received packets: %u\n", rtp->rxcount);
-		tris_verbose("  Lost packets:	 %u\n", rtp->rtcp ? (rtp->rtcp->expected_prior - rtp->rtcp->received_prior) : 0);
-		tris_verbose("  Jitter:		 %.4f\n", rtp->rxjitter);
-		tris_verbose("  Transit:		 %.4f\n", rtp->rxtransit);
-		tris_verbose("  RR-count:	 %u\n", rtp->rtcp ? rtp->rtcp->rr_count : 0);
-		tris_verbose("* Our Sender:\n");
-		tris_verbose("  SSRC:		 %u\n", rtp->ssrc);
-		tris_verbose("  Sent packets:	 %u\n", rtp->txcount);
-		tris_verbose("  Lost packets:	 %u\n", rtp->rtcp ? rtp->rtcp->reported_lost : 0);
-		tris_verbose("  Jitter:		 %u\n", rtp->rtcp ? (rtp->rtcp->reported_jitter / (unsigned int)65536.0) : 0);
-		tris_verbose("  SR-count:	 %u\n", rtp->rtcp ? rtp->rtcp->sr_count : 0);
-		tris_verbose("  RTT:		 %f\n", rtp->rtcp ? rtp->rtcp->rtt : 0);
-	}
+	unsigned int i;
 
-	/*if (rtp->rtcp) {
-		manager_event(EVENT_FLAG_REPORTING, "RTPReceiverStat", "SSRC: %u\r\n"
-					    "ReceivedPackets: %u\r\n"
-					    "LostPackets: %u\r\n"
-					    "Jitter: %.4f\r\n"
-					    "Transit: %.4f\r\n"
-					    "RRCount: %u\r\n",
-					    rtp->themssrc,
-					    rtp->rxcount,
-					    rtp->rtcp ? (rtp->rtcp->expected_prior - rtp->rtcp->received_prior) : 0,
-					    rtp->rxjitter,
-					    rtp->rxtransit,
-					    rtp->rtcp ? rtp->rtcp->rr_count : 0);
-		manager_event(EVENT_FLAG_REPORTING, "RTPSenderStat", "SSRC: %u\r\n"
-					    "SentPackets: %u\r\n"
-					    "LostPackets: %u\r\n"
-					    "Jitter: %u\r\n"
-					    "SRCount: %u\r\n"
-					    "RTT: %f\r\n",
-					    rtp->ssrc,
-					    rtp->txcount,
-					    rtp->rtcp ? rtp->rtcp->reported_lost : 0,
-					    rtp->rtcp ? rtp->rtcp->reported_jitter : 0,
-					    rtp->rtcp ? rtp->rtcp->sr_count : 0,
-					    rtp->rtcp ? rtp->rtcp->rtt : 0);
-	}*/
-	if (rtp->smoother)
-		tris_smoother_free(rtp->smoother);
-	if (rtp->ioid)
-		tris_io_remove(rtp->io, rtp->ioid);
-	if (rtp->s > -1)
-		close(rtp->s);
-	if (rtp->rtcp) {
-		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
-		close(rtp->rtcp->s);
-		tris_free(rtp->rtcp);
-		rtp->rtcp=NULL;
-	}
-	if (rtp->rawdata) {
-		tris_free(rtp->rawdata);
-		rtp->rawdata = 0;
+	for (i = 0; i < ARRAY_LEN(mimeTypes); ++i) {
+		if ((mimeTypes[i].payloadType.code == code) && (mimeTypes[i].payloadType.isAstFormat == isAstFormat)) {
+			if (isAstFormat &&
+			    (code == TRIS_FORMAT_G726_AAL2) &&
+			    (options & TRIS_RTP_OPT_G726_NONSTANDARD))
+				return "G726-32";
+			else
+				return mimeTypes[i].subtype;
+		}
 	}
-#ifdef P2P_INTENSE
-	tris_mutex_destroy(&rtp->bridge_lock);
-#endif
-	tris_free(rtp);
+
+	return "";
 }
 
-static unsigned int calc_txstamp(struct tris_rtp *rtp, struct timeval *delivery)
+unsigned int tris_rtp_lookup_sample_rate(int isAstFormat, format_t code)
 {
-	struct timeval t;
-	long ms;
-	if (tris_tvzero(rtp->txcore)) {
-		rtp->txcore = tris_tvnow();
-		/* Round to 20ms for nice, pretty timestamps */
-		rtp->txcore.tv_usec -= rtp->txcore.tv_usec % 20000;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_LEN(mimeTypes); ++i) {
+		if ((mimeTypes[i].payloadType.code == code) && (mimeTypes[i].payloadType.isAstFormat == isAstFormat)) {
+			return mimeTypes[i].sample_rate;
+		}
 	}
-	/* Use previous txcore if available */
-	t = (delivery && !tris_tvzero(*delivery)) ? *delivery : tris_tvnow();
-	ms = tris_tvdiff_ms(t, rtp->txcore);
-	if (ms < 0)
-		ms = 0;
-	/* Use what we just got for next time */
-	rtp->txcore = t;
-	return (unsigned int) ms;
+
+	return 0;
 }
 
-/*! \brief Send begin frames for DTMF */
-int tris_rtp_senddigit_begin(struct tris_rtp *rtp, char digit)
+char *tris_rtp_lookup_mime_multiple(char *buf, size_t size, const format_t capability,
+				   const int isAstFormat, enum tris_rtp_options options)
 {
-	unsigned int *rtpheader;
-	int hdrlen = 12, res = 0, i = 0, payload = 0;
-	char data[256];
+	format_t format, bits;
+	unsigned len;
+	char *end = buf;
+	char *start = buf;
 
-	if ((digit <= '9') && (digit >= '0'))
-		digit -= '0';
-	else if (digit == '*')
-		digit = 10;
-	else if (digit == '#')
-		digit = 11;
-	else if ((digit >= 'A') && (digit <= 'D'))
-		digit = digit - 'A' + 12;
-	else if ((digit >= 'a') && (digit <= 'd'))
-		digit = digit - 'a' + 12;
-	else {
-		tris_log(LOG_WARNING, "Don't know how to represent '%c'\n", digit);
-		return 0;
-	}
+	if (!buf || !size)
+		return NULL;
 
-	/* If we have no peer, return immediately */	
-	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
-		return 0;
+	snprintf(end, size, "0x%llx (", (unsigned long long) capability);
+
+	len = strlen(end);
+	end += len;
+	size -= len;
+	start = end;
 
-	payload = tris_rtp_lookup_code(rtp, 0, TRIS_RTP_DTMF);
+	for (bits = capability; bits; bits &= bits - 1) {
+		const char *name;
 
-	rtp->dtmfmute = tris_tvadd(tris_tvnow(), tris_tv(0, 500000));
-	rtp->send_duration = 160;
-	rtp->lastdigitts = rtp->lastts + rtp->send_duration;
-	
-	/* Get a pointer to the header */
-	rtpheader = (unsigned int *)data;
-	rtpheader[0] = htonl((2 << 30) | (1 << 23) | (payload << 16) | (rtp->seqno));
-	rtpheader[1] = htonl(rtp->lastdigitts);
-	rtpheader[2] = htonl(rtp->ssrc); 
+		format = bits & -bits;
+		if (!isAstFormat && format >= TRIS_RTP_MAX)
+			break;
+		name = tris_rtp_lookup_mime_subtype(isAstFormat, format, options);
 
-	for (i = 0; i < 2; i++) {
-		rtpheader[3] = htonl((digit << 24) | (0xa << 16) | (rtp->send_duration));
-		res = sendto(rtp->s, (void *) rtpheader, hdrlen + 4, 0, (struct sockaddr *) &rtp->them, sizeof(rtp->them));
-		if (res < 0) 
-			tris_log(LOG_ERROR, "RTP Transmission error to %s:%u: %s\n",
-				tris_inet_ntoa(rtp->them.sin_addr),
-				ntohs(rtp->them.sin_port), strerror(errno));
-		if (rtp_debug_test_addr(&rtp->them))
-			tris_verbose("Sent RTP DTMF packet to %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-				    tris_inet_ntoa(rtp->them.sin_addr),
-				    ntohs(rtp->them.sin_port), payload, rtp->seqno, rtp->lastdigitts, res - hdrlen);
-		/* Increment sequence number */
-		rtp->seqno++;
-		/* Increment duration */
-		rtp->send_duration += 160;
-		/* Clear marker bit and set seqno */
-		rtpheader[0] = htonl((2 << 30) | (payload << 16) | (rtp->seqno));
+		snprintf(end, size, "%s|", name);
+		len = strlen(end);
+		end += len;
+		size -= len;
 	}
 
-	/* Since we received a begin, we can safely store the digit and disable any compensation */
-	rtp->sending_digit = 1;
-	rtp->send_digit = digit;
-	rtp->send_payload = payload;
+	if (start == end)
+		tris_copy_string(start, "nothing)", size); 
+	else if (size > 1)
+		*(end -1) = ')';
+	
+	return buf;
+}
 
-	return 0;
+/*! \brief Open RTP or RTCP socket for a session.
+ * Print a message on failure. 
+ */
+static int rtp_socket(const char *type)
+{
+	int s = socket(AF_INET, SOCK_DGRAM, 0);
+	if (s < 0) {
+		if (type == NULL)
+			type = "RTP/RTCP";
+		tris_log(LOG_WARNING, "Unable to allocate %s socket: %s\n", type, strerror(errno));
+	} else {
+		long flags = fcntl(s, F_GETFL);
+		fcntl(s, F_SETFL, flags | O_NONBLOCK);
+#ifdef SO_NO_CHECK
+		if (nochecksums)
+			setsockopt(s, SOL_SOCKET, SO_NO_CHECK, &nochecksums, sizeof(nochecksums));
+#endif
+	}
+	return s;
 }
 
-/*! \brief Send continuation frame for DTMF */
-static int tris_rtp_senddigit_continuation(struct tris_rtp *rtp)
+/*!
+ * \brief Initialize a new RTCP session.
+ * 
+ * \returns The newly initialized RTCP session.
+ */
+static struct tris_rtcp *tris_rtcp_new(void)
 {
-	unsigned int *rtpheader;
-	int hdrlen = 12, res = 0;
-	char data[256];
+	struct tris_rtcp *rtcp;
 
-	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
-		return 0;
+	if (!(rtcp = tris_calloc(1, sizeof(*rtcp))))
+		return NULL;
+	rtcp->s = rtp_socket("RTCP");
+	rtcp->us.sin_family = AF_INET;
+	rtcp->them.sin_family = AF_INET;
+	rtcp->schedid = -1;
 
-	/* Setup packet to send */
-	rtpheader = (unsigned int *)data;
-	rtpheader[0] = htonl((2 << 30) | (1 << 23) | (rtp->send_payload << 16) | (rtp->seqno));
-	rtpheader[1] = htonl(rtp->lastdigitts);
-	rtpheader[2] = htonl(rtp->ssrc);
-	rtpheader[3] = htonl((rtp->send_digit << 24) | (0xa << 16) | (rtp->send_duration));
-	rtpheader[0] = htonl((2 << 30) | (rtp->send_payload << 16) | (rtp->seqno));
-	
-	/* Transmit */
-	res = sendto(rtp->s, (void *) rtpheader, hdrlen + 4, 0, (struct sockaddr *) &rtp->them, sizeof(rtp->them));
-	if (res < 0)
-		tris_log(LOG_ERROR, "RTP Transmission error to %s:%d: %s\n",
-			tris_inet_ntoa(rtp->them.sin_addr),
-			ntohs(rtp->them.sin_port), strerror(errno));
-	if (rtp_debug_test_addr(&rtp->them))
-		tris_verbose("Sent RTP DTMF packet to %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-			    tris_inet_ntoa(rtp->them.sin_addr),
-			    ntohs(rtp->them.sin_port), rtp->send_payload, rtp->seqno, rtp->lastdigitts, res - hdrlen);
+	if (rtcp->s < 0) {
+		tris_free(rtcp);
+		return NULL;
+	}
 
-	/* Increment sequence number */
-	rtp->seqno++;
-	/* Increment duration */
-	rtp->send_duration += 160;
+	return rtcp;
+}
 
-	return 0;
+/*!
+ * \brief Initialize a new RTP structure.
+ *
+ */
+void tris_rtp_new_init(struct tris_rtp *rtp)
+{
+#ifdef P2P_INTENSE
+	tris_mutex_init(&rtp->bridge_lock);
+#endif
+
+	rtp->them.sin_family = AF_INET;
+	rtp->us.sin_family = AF_INET;
+	rtp->ssrc = tris_random();
+	rtp->seqno = tris_random() & 0xffff;
+	tris_set_flag(rtp, FLAG_HAS_DTMF);
+	rtp->strict_rtp_state = (strictrtp ? STRICT_RTP_LEARN : STRICT_RTP_OPEN);
 }
 
-/*! \brief Send end packets for DTMF */
-int tris_rtp_senddigit_end(struct tris_rtp *rtp, char digit)
+struct tris_rtp *tris_rtp_new_with_bindaddr(struct sched_context *sched, struct io_context *io, int rtcpenable, int callbackmode, struct in_addr addr)
 {
-	unsigned int *rtpheader;
-	int hdrlen = 12, res = 0, i = 0;
-	char data[256];
-	
-	/* If no address, then bail out */
-	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
-		return 0;
+	struct tris_rtp *rtp;
+	int x;
+	int startplace;
 	
-	if ((digit <= '9') && (digit >= '0'))
-		digit -= '0';
-	else if (digit == '*')
-		digit = 10;
-	else if (digit == '#')
-		digit = 11;
-	else if ((digit >= 'A') && (digit <= 'D'))
-		digit = digit - 'A' + 12;
-	else if ((digit >= 'a') && (digit <= 'd'))
-		digit = digit - 'a' + 12;
-	else {
-		tris_log(LOG_WARNING, "Don't know how to represent '%c'\n", digit);
-		return 0;
-	}
-
-	rtp->dtmfmute = tris_tvadd(tris_tvnow(), tris_tv(0, 500000));
+	if (!(rtp = tris_calloc(1, sizeof(*rtp))))
+		return NULL;
 
-	rtpheader = (unsigned int *)data;
-	rtpheader[1] = htonl(rtp->lastdigitts);
-	rtpheader[2] = htonl(rtp->ssrc);
-	rtpheader[3] = htonl((digit << 24) | (0xa << 16) | (rtp->send_duration));
-	/* Set end bit */
-	rtpheader[3] |= htonl((1 << 23));
+	tris_rtp_new_init(rtp);
 
-	/* Send 3 termination packets */
-	for (i = 0; i < 3; i++) {
-		rtpheader[0] = htonl((2 << 30) | (rtp->send_payload << 16) | (rtp->seqno));
-		res = sendto(rtp->s, (void *) rtpheader, hdrlen + 4, 0, (struct sockaddr *) &rtp->them, sizeof(rtp->them));
-		rtp->seqno++;
-		if (res < 0)
-			tris_log(LOG_ERROR, "RTP Transmission error to %s:%d: %s\n",
-				tris_inet_ntoa(rtp->them.sin_addr),
-				ntohs(rtp->them.sin_port), strerror(errno));
-		if (rtp_debug_test_addr(&rtp->them))
-			tris_verbose("Sent RTP DTMF packet to %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-				    tris_inet_ntoa(rtp->them.sin_addr),
-				    ntohs(rtp->them.sin_port), rtp->send_payload, rtp->seqno, rtp->lastdigitts, res - hdrlen);
+	rtp->s = rtp_socket("RTP");
+	if (rtp->s < 0)
+		goto fail;
+	if (sched && rtcpenable) {
+		rtp->sched = sched;
+		rtp->rtcp = tris_rtcp_new();
 	}
-	rtp->lastts += rtp->send_duration;
-	rtp->sending_digit = 0;
-	rtp->send_digit = 0;
+	
+	/*
+	 * Try to bind the RTP port, x, and possibly the RTCP port, x+1 as well.
+	 * Start from a random (even, by RTP spec) port number, and
+	 * iterate until success or no ports are available.
+	 * Note that the requirement of RTP port being even, or RTCP being the
+	 * next one, cannot be enforced in presence of a NAT box because the
+	 * mapping is not under our control.
+	 */
+	x = (rtpend == rtpstart) ? rtpstart : (tris_random() % (rtpend - rtpstart)) + rtpstart;
+	x = x & ~1;		/* make it an even number */
+	startplace = x;		/* remember the starting point */
+	/* this is constant across the loop */
+	rtp->us.sin_addr = addr;
+	if (rtp->rtcp)
+		rtp->rtcp->us.sin_addr = addr;
+	for (;;) {
+		rtp->us.sin_port = htons(x);
+		if (!bind(rtp->s, (struct sockaddr *)&rtp->us, sizeof(rtp->us))) {
+			/* bind succeeded, if no rtcp then we are done */
+			if (!rtp->rtcp)
+				break;
+			/* have rtcp, try to bind it */
+			rtp->rtcp->us.sin_port = htons(x + 1);
+			if (!bind(rtp->rtcp->s, (struct sockaddr *)&rtp->rtcp->us, sizeof(rtp->rtcp->us)))
+				break;	/* success again, we are really done */
+			/*
+			 * RTCP bind failed, so close and recreate the
+			 * already bound RTP socket for the next round.
+			 */
+			close(rtp->s);
+			rtp->s = rtp_socket("RTP");
+			if (rtp->s < 0)
+				goto fail;
+		}
+		/*
+		 * If we get here, there was an error in one of the bind()
+		 * calls, so make sure it is nothing unexpected.
+		 */
+		if (errno != EADDRINUSE) {
+			/* We got an error that wasn't expected, abort! */
+			tris_log(LOG_ERROR, "Unexpected bind error: %s\n", strerror(errno));
+			goto fail;
+		}
+		/*
+		 * One of the ports is in use. For the next iteration,
+		 * increment by two and handle wraparound.
+		 * If we reach the starting point, then declare failure.
+		 */
+		x += 2;
+		if (x > rtpend)
+			x = (rtpstart + 1) & ~1;
+		if (x == startplace) {
+			tris_log(LOG_ERROR, "No RTP ports remaining. Can't setup media stream for this call.\n");
+			goto fail;
+		}
+	}
+	rtp->sched = sched;
+	rtp->io = io;
+	if (callbackmode) {
+		rtp->ioid = tris_io_add(rtp->io, rtp->s, rtpread, TRIS_IO_IN, rtp);
+		tris_set_flag(rtp, FLAG_CALLBACK_MODE);
+	}
+	tris_rtp_pt_default(rtp);
+	rtp->rawdata = tris_calloc(1, RTP_RAWDATA_SIZE + TRIS_FRIENDLY_OFFSET);
+	rtp->txbatch = tris_udp_batch_alloc(rtpbatch, RTP_BATCH_MTU);
+	if (callbackmode)
+		rtp->rxbatch = tris_udp_batch_alloc(rtpbatch, RTP_BATCH_MTU);
+	return rtp;
 
-	return res;
+fail:
+	if (rtp->s >= 0)
+		close(rtp->s);
+	if (rtp->rtcp) {
+		close(rtp->rtcp->s);
+		tris_free(rtp->rtcp);
+	}
+	tris_free(rtp);
+	return NULL;
 }
 
-/*! \brief Public function: Send an H.261 fast update request, some devices need this rather than SIP XML */
-int tris_rtcp_send_h261fur(void *data)
+struct tris_rtp *tris_rtp_new(struct sched_context *sched, struct io_context *io, int rtcpenable, int callbackmode)
 {
-	struct tris_rtp *rtp = data;
-	int res;
+	struct in_addr ia;
 
-	rtp->rtcp->sendfur = 1;
-	res = tris_rtcp_write(data);
-	
-	return res;
+	memset(&ia, 0, sizeof(ia));
+	return tris_rtp_new_with_bindaddr(sched, io, rtcpenable, callbackmode, ia);
 }
 
-/*! \brief Send RTCP sender's report */
-static int tris_rtcp_write_sr(const void *data)
+int tris_rtp_setqos(struct tris_rtp *rtp, int type_of_service, int class_of_service, char *desc)
 {
-	struct tris_rtp *rtp = (struct tris_rtp *)data;
-	int res;
-	int len = 0;
-	struct timeval now;
-	unsigned int now_lsw;
-	unsigned int now_msw;
-	unsigned int *rtcpheader;
-	unsigned int lost;
-	unsigned int extended;
-	unsigned int expected;
-	unsigned int expected_interval;
-	unsigned int received_interval;
-	int lost_interval;
-	int fraction;
-	struct timeval dlsr;
-	char bdata[512];
-
-	/* Commented condition is always not NULL if rtp->rtcp is not NULL */
-	if (!rtp || !rtp->rtcp/* || (&rtp->rtcp->them.sin_addr == 0)*/)
-		return 0;
-	
-	if (!rtp->rtcp->them.sin_addr.s_addr) {  /* This'll stop rtcp for this rtp session */
-		tris_verbose("RTCP SR transmission error, rtcp halted\n");
-		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
-		return 0;
-	}
-
-	gettimeofday(&now, NULL);
-	timeval2ntp(now, &now_msw, &now_lsw); /* fill thses ones in from utils.c*/
-	rtcpheader = (unsigned int *)bdata;
-	rtcpheader[1] = htonl(rtp->ssrc);               /* Our SSRC */
-	rtcpheader[2] = htonl(now_msw);                 /* now, MSW. gettimeofday() + SEC_BETWEEN_1900_AND_1970*/
-	rtcpheader[3] = htonl(now_lsw);                 /* now, LSW */
-	rtcpheader[4] = htonl(rtp->lastts);             /* FIXME shouldn't be that, it should be now */
-	rtcpheader[5] = htonl(rtp->txcount);            /* No. packets sent */
-	rtcpheader[6] = htonl(rtp->txoctetcount);       /* No. bytes sent */
-	len += 28;
-	
-	extended = rtp->cycles + rtp->lastrxseqno;
-	expected = extended - rtp->seedrxseqno + 1;
-	if (rtp->rxcount > expected) 
-		expected += rtp->rxcount - expected;
-	lost = expected - rtp->rxcount;
-	expected_interval = expected - rtp->rtcp->expected_prior;
-	rtp->rtcp->expected_prior = expected;
-	received_interval = rtp->rxcount - rtp->rtcp->received_prior;
-	rtp->rtcp->received_prior = rtp->rxcount;
-	lost_interval = expected_interval - received_interval;
-	if (expected_interval == 0 || lost_interval <= 0)
-		fraction = 0;
-	else
-		fraction = (lost_interval << 8) / expected_interval;
-	timersub(&now, &rtp->rtcp->rxlsr, &dlsr);
-	rtcpheader[7] = htonl(rtp->themssrc);
-	rtcpheader[8] = htonl(((fraction & 0xff) << 24) | (lost & 0xffffff));
-	rtcpheader[9] = htonl((rtp->cycles) | ((rtp->lastrxseqno & 0xffff)));
-	rtcpheader[10] = htonl((unsigned int)(rtp->rxjitter * 65536.));
-	rtcpheader[11] = htonl(rtp->rtcp->themrxlsr);
-	rtcpheader[12] = htonl((((dlsr.tv_sec * 1000) + (dlsr.tv_usec / 1000)) * 65536) / 1000);
-	len += 24;
-	
-	rtcpheader[0] = htonl((2 << 30) | (1 << 24) | (RTCP_PT_SR << 16) | ((len/4)-1));
+	return tris_netsock_set_qos(rtp->s, type_of_service, class_of_service, desc);
+}
 
-	if (rtp->rtcp->sendfur) {
-		rtcpheader[13] = htonl((2 << 30) | (0 << 24) | (RTCP_PT_FUR << 16) | 1);
-		rtcpheader[14] = htonl(rtp->ssrc);               /* Our SSRC */
-		len += 8;
-		rtp->rtcp->sendfur = 0;
-	}
-	
-	/* Insert SDES here. Probably should make SDES text equal to mimetypes[code].type (not subtype 'cos */ 
-	/* it can change mid call, and SDES can't) */
-	rtcpheader[len/4]     = htonl((2 << 30) | (1 << 24) | (RTCP_PT_SDES << 16) | 2);
-	rtcpheader[(len/4)+1] = htonl(rtp->ssrc);               /* Our SSRC */
-	rtcpheader[(len/4)+2] = htonl(0x01 << 24);                    /* Empty for the moment */
-	len += 12;
-	
-	res = sendto(rtp->rtcp->s, (unsigned int *)rtcpheader, len, 0, (struct sockaddr *)&rtp->rtcp->them, sizeof(rtp->rtcp->them));
-	if (res < 0) {
-		tris_log(LOG_ERROR, "RTCP SR transmission error to %s:%d, rtcp halted %s\n",tris_inet_ntoa(rtp->rtcp->them.sin_addr), ntohs(rtp->rtcp->them.sin_port), strerror(errno));
-		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
-		return 0;
-	}
-	
-	/* FIXME Don't need to get a new one */
-	gettimeofday(&rtp->rtcp->txlsr, NULL);
-	rtp->rtcp->sr_count++;
+void tris_rtp_set_constantssrc(struct tris_rtp *rtp)
+{
+	rtp->constantssrc = 1;
+}
 
-	rtp->rtcp->lastsrtxcount = rtp->txcount;	
-	
-	if (rtcp_debug_test_addr(&rtp->rtcp->them)) {
-		tris_verbose("* Sent RTCP SR to %s:%d\n", tris_inet_ntoa(rtp->rtcp->them.sin_addr), ntohs(rtp->rtcp->them.sin_port));
-		tris_verbose("  Our SSRC: %u\n", rtp->ssrc);
-		tris_verbose("  Sent(NTP): %u.%010u\n", (unsigned int)now.tv_sec, (unsigned int)now.tv_usec*4096);
-		tris_verbose("  Sent(RTP): %u\n", rtp->lastts);
-		tris_verbose("  Sent packets: %u\n", rtp->txcount);
-		tris_verbose("  Sent octets: %u\n", rtp->txoctetcount);
-		tris_verbose("  Report block:\n");
-		tris_verbose("  Fraction lost: %u\n", fraction);
-		tris_verbose("  Cumulative loss: %u\n", lost);
-		tris_verbose("  IA jitter: %.4f\n", rtp->rxjitter);
-		tris_verbose("  Their last SR: %u\n", rtp->rtcp->themrxlsr);
-		tris_verbose("  DLSR: %4.4f (sec)\n\n", (double)(ntohl(rtcpheader[12])/65536.0));
+void tris_rtp_new_source(struct tris_rtp *rtp)
+{
+	if (rtp) {
+		rtp->set_marker_bit = 1;
+		if (!rtp->constantssrc) {
+			rtp->ssrc = tris_random();
+		}
 	}
-	/*manager_event(EVENT_FLAG_REPORTING, "RTCPSent", "To: %s:%d\r\n"
-					    "OurSSRC: %u\r\n"
-					    "SentNTP: %u.%010u\r\n"
-					    "SentRTP: %u\r\n"
-					    "SentPackets: %u\r\n"
-					    "SentOctets: %u\r\n"
-					    "ReportBlock:\r\n"
-					    "FractionLost: %u\r\n"
-					    "CumulativeLoss: %u\r\n"
-					    "IAJitter: %.4f\r\n"
-					    "TheirLastSR: %u\r\n"
-					    "DLSR: %4.4f (sec)\r\n",
-					    tris_inet_ntoa(rtp->rtcp->them.sin_addr), ntohs(rtp->rtcp->them.sin_port),
-					    rtp->ssrc,
-					    (unsigned int)now.tv_sec, (unsigned int)now.tv_usec*4096,
-					    rtp->lastts,
-					    rtp->txcount,
-					    rtp->txoctetcount,
-					    fraction,
-					    lost,
-					    rtp->rxjitter,
-					    rtp->rtcp->themrxlsr,
-					    (double)(ntohl(rtcpheader[12])/65536.0));
-	*/
-	return res;
 }
 
-/*! \brief Send RTCP recipient's report */
-static int tris_rtcp_write_rr(const void *data)
+void tris_rtp_change_source(struct tris_rtp *rtp)
 {
-	struct tris_rtp *rtp = (struct tris_rtp *)data;
-	int res;
-	int len = 32;
-	unsigned int lost;
-	unsigned int extended;
-	unsigned int expected;
-	unsigned int expected_interval;
-	unsigned int received_interval;
-	int lost_interval;
-	struct timeval now;
-	unsigned int *rtcpheader;
-	char bdata[1024];
-	struct timeval dlsr;
-	int fraction;
+	if (rtp) {
+		unsigned int ssrc = tris_random();
 
-	double rxlost_current;
-	
-	if (!rtp || !rtp->rtcp || (&rtp->rtcp->them.sin_addr == 0))
-		return 0;
-	  
-	if (!rtp->rtcp->them.sin_addr.s_addr) {
-		tris_log(LOG_ERROR, "RTCP RR transmission error, rtcp halted\n");
-		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
-		return 0;
+		rtp->set_marker_bit = 1;
+		tris_debug(3, "Changing ssrc from %u to %u due to a source change\n", rtp->ssrc, ssrc);
+		rtp->ssrc = ssrc;
 	}
+}
 
-	extended = rtp->cycles + rtp->lastrxseqno;
-	expected = extended - rtp->seedrxseqno + 1;
-	lost = expected - rtp->rxcount;
-	expected_interval = expected - rtp->rtcp->expected_prior;
-	rtp->rtcp->expected_prior = expected;
-	received_interval = rtp->rxcount - rtp->rtcp->received_prior;
-	rtp->rtcp->received_prior = rtp->rxcount;
-	lost_interval = expected_interval - received_interval;
-
-	if (lost_interval <= 0)
-		rtp->rtcp->rxlost = 0;
-	else rtp->rtcp->rxlost = rtp->rtcp->rxlost;
-	if (rtp->rtcp->rxlost_count == 0)
-		rtp->rtcp->minrxlost = rtp->rtcp->rxlost;
-	if (lost_interval < rtp->rtcp->minrxlost) 
-		rtp->rtcp->minrxlost = rtp->rtcp->rxlost;
-	if (lost_interval > rtp->rtcp->maxrxlost) 
-		rtp->rtcp->maxrxlost = rtp->rtcp->rxlost;
-
-	rxlost_current = normdev_compute(rtp->rtcp->normdev_rxlost, rtp->rtcp->rxlost, rtp->rtcp->rxlost_count);
-	rtp->rtcp->stdev_rxlost = stddev_compute(rtp->rtcp->stdev_rxlost, rtp->rtcp->rxlost, rtp->rtcp->normdev_rxlost, rxlost_current, rtp->rtcp->rxlost_count);
-	rtp->rtcp->normdev_rxlost = rxlost_current;
-	rtp->rtcp->rxlost_count++;
-
-	if (expected_interval == 0 || lost_interval <= 0)
-		fraction = 0;
-	else
-		fraction = (lost_interval << 8) / expected_interval;
-	gettimeofday(&now, NULL);
-	timersub(&now, &rtp->rtcp->rxlsr, &dlsr);
-	rtcpheader = (unsigned int *)bdata;
-	rtcpheader[0] = htonl((2 << 30) | (1 << 24) | (RTCP_PT_RR << 16) | ((len/4)-1));
-	rtcpheader[1] = htonl(rtp->ssrc);
-	rtcpheader[2] = htonl(rtp->themssrc);
-	rtcpheader[3] = htonl(((fraction & 0xff) << 24) | (lost & 0xffffff));
-	rtcpheader[4] = htonl((rtp->cycles) | ((rtp->lastrxseqno & 0xffff)));
-	rtcpheader[5] = htonl((unsigned int)(rtp->rxjitter * 65536.));
-	rtcpheader[6] = htonl(rtp->rtcp->themrxlsr);
-	rtcpheader[7] = htonl((((dlsr.tv_sec * 1000) + (dlsr.tv_usec / 1000)) * 65536) / 1000);
-
-	if (rtp->rtcp->sendfur) {
-		rtcpheader[8] = htonl((2 << 30) | (0 << 24) | (RTCP_PT_FUR << 16) | 1); /* Header from page 36 in RFC 3550 */
-		rtcpheader[9] = htonl(rtp->ssrc);               /* Our SSRC */
-		len += 8;
-		rtp->rtcp->sendfur = 0;
+void tris_rtp_set_peer(struct tris_rtp *rtp, struct sockaddr_in *them)
+{
+	rtp->them.sin_port = them->sin_port;
+	rtp->them.sin_addr = them->sin_addr;
+	if (rtp->rtcp) {
+		int h = ntohs(them->sin_port);
+		rtp->rtcp->them.sin_port = htons(h + 1);
+		rtp->rtcp->them.sin_addr = them->sin_addr;
 	}
-
-	/*! \note Insert SDES here. Probably should make SDES text equal to mimetypes[code].type (not subtype 'cos 
-	it can change mid call, and SDES can't) */
-	rtcpheader[len/4]     = htonl((2 << 30) | (1 << 24) | (RTCP_PT_SDES << 16) | 2);
-	rtcpheader[(len/4)+1] = htonl(rtp->ssrc);               /* Our SSRC */
-	rtcpheader[(len/4)+2] = htonl(0x01 << 24);              /* Empty for the moment */
-	len += 12;
-	
-	res = sendto(rtp->rtcp->s, (unsigned int *)rtcpheader, len, 0, (struct sockaddr *)&rtp->rtcp->them, sizeof(rtp->rtcp->them));
-
-	if (res < 0) {
-		tris_log(LOG_ERROR, "RTCP RR transmission error, rtcp halted: %s\n",strerror(errno));
-		/* Remove the scheduler */
-		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
-		return 0;
+	rtp->rxseqno = 0;
+	/* If strict RTP protection is enabled switch back to the learn state so we don't drop packets from above */
+	if (strictrtp)
+		rtp->strict_rtp_state = STRICT_RTP_LEARN;
+}
+
+void tris_rtp_set_us(struct tris_rtp *rtp, struct sockaddr_in *us)
+{
+	rtp->us.sin_port = us->sin_port;
+	rtp->us.sin_addr = us->sin_addr;
+	if (rtp->rtcp) {
+		int h = ntohs(us->sin_port);
+		rtp->rtcp->us.sin_port = htons(h + 1);
+		rtp->rtcp->us.sin_addr = us->sin_addr;
 	}
 
-	rtp->rtcp->rr_count++;
+	close(rtp->s);
+	rtp->s = rtp_socket("RTP");
+	if (rtp->s < 0)
+		return;
 
-	if (rtcp_debug_test_addr(&rtp->rtcp->them)) {
-		tris_verbose("\n* Sending RTCP RR to %s:%d\n"
-			"  Our SSRC: %u\nTheir SSRC: %u\niFraction lost: %d\nCumulative loss: %u\n" 
-			"  IA jitter: %.4f\n" 
-			"  Their last SR: %u\n" 
-			"  DLSR: %4.4f (sec)\n\n",
-			tris_inet_ntoa(rtp->rtcp->them.sin_addr),
-			ntohs(rtp->rtcp->them.sin_port),
-			rtp->ssrc, rtp->themssrc, fraction, lost,
-			rtp->rxjitter,
-			rtp->rtcp->themrxlsr,
-			(double)(ntohl(rtcpheader[7])/65536.0));
+	if (!bind(rtp->s, (struct sockaddr *)&rtp->us, sizeof(rtp->us))) {
+		/* bind succeeded, if no rtcp then we are done */
+		if (rtp->rtcp) {
+			close(rtp->rtcp->s);
+			rtp->rtcp->s = rtp_socket("RTCP");
+			if (rtp->rtcp->s < 0)
+				return;
+			/* have rtcp, try to bind it */
+			if (!bind(rtp->rtcp->s, (struct sockaddr *)&rtp->rtcp->us, sizeof(rtp->rtcp->us)))
+				return;
+			else
+				return;
+			/*
+			 * RTCP bind failed, so close and recreate the
+			 * already bound RTP socket for the next round.
+			 */
+		}
+	} else {
+		return;
 	}
+}
 
-	return res;
+void tris_rtp_set_alt_peer(struct tris_rtp *rtp, struct sockaddr_in *alt)
+{
+	rtp->altthem.sin_port = alt->sin_port;
+	rtp->altthem.sin_addr = alt->sin_addr;
+	if (rtp->rtcp) {
+		rtp->rtcp->altthem.sin_port = htons(ntohs(alt->sin_port) + 1);
+		rtp->rtcp->altthem.sin_addr = alt->sin_addr;
+	}
 }
 
-/*! \brief Write and RTCP packet to the far end
- * \note Decide if we are going to send an SR (with Reception Block) or RR 
- * RR is sent if we have not sent any rtp packets in the previous interval */
-static int tris_rtcp_write(const void *data)
+int tris_rtp_get_peer(struct tris_rtp *rtp, struct sockaddr_in *them)
 {
-	struct tris_rtp *rtp = (struct tris_rtp *)data;
-	int res;
-	
-	if (!rtp || !rtp->rtcp)
-		return 0;
+	if ((them->sin_family != AF_INET) ||
+		(them->sin_port != rtp->them.sin_port) ||
+		(them->sin_addr.s_addr != rtp->them.sin_addr.s_addr)) {
+		them->sin_family = AF_INET;
+		them->sin_port = rtp->them.sin_port;
+		them->sin_addr = rtp->them.sin_addr;
+		return 1;
+	}
+	return 0;
+}
 
-	if (rtp->txcount > rtp->rtcp->lastsrtxcount)
-		res = tris_rtcp_write_sr(data);
-	else
-		res = tris_rtcp_write_rr(data);
-	
-	return res;
+void tris_rtp_get_us(struct tris_rtp *rtp, struct sockaddr_in *us)
+{
+	*us = rtp->us;
 }
 
-/*! \brief generate comfort noice (CNG) */
-int tris_rtp_sendcng(struct tris_rtp *rtp, int level)
+struct tris_rtp *tris_rtp_get_bridged(struct tris_rtp *rtp)
 {
-	unsigned int *rtpheader;
-	int hdrlen = 12;
-	int res;
-	int payload;
-	char data[256];
-	level = 127 - (level & 0x7f);
-	payload = tris_rtp_lookup_code(rtp, 0, TRIS_RTP_CN);
+	struct tris_rtp *bridged = NULL;
 
-	/* If we have no peer, return immediately */	
-	if (!rtp->them.sin_addr.s_addr)
-		return 0;
+	rtp_bridge_lock(rtp);
+	bridged = rtp->bridged;
+	rtp_bridge_unlock(rtp);
 
-	rtp->dtmfmute = tris_tvadd(tris_tvnow(), tris_tv(0, 500000));
+	return bridged;
+}
 
-	/* Get a pointer to the header */
-	rtpheader = (unsigned int *)data;
-	rtpheader[0] = htonl((2 << 30) | (1 << 23) | (payload << 16) | (rtp->seqno++));
-	rtpheader[1] = htonl(rtp->lastts);
-	rtpheader[2] = htonl(rtp->ssrc); 
-	data[12] = level;
-	if (rtp->them.sin_port && rtp->them.sin_addr.s_addr) {
-		res = sendto(rtp->s, (void *)rtpheader, hdrlen + 1, 0, (struct sockaddr *)&rtp->them, sizeof(rtp->them));
-		if (res <0) 
-			tris_log(LOG_ERROR, "RTP Comfort Noise Transmission error to %s:%d: %s\n", tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), strerror(errno));
-		if (rtp_debug_test_addr(&rtp->them))
-			tris_verbose("Sent Comfort Noise RTP packet to %s:%u (type %d, seq %u, ts %u, len %d)\n"
-					, tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), payload, rtp->seqno, rtp->lastts,res - hdrlen);		   
-		   
+void tris_rtp_stop(struct tris_rtp *rtp)
+{
+	if (rtp->rtcp) {
+		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
 	}
-	return 0;
+	if (rtp->red) {
+		TRIS_SCHED_DEL(rtp->sched, rtp->red->schedid);
+		free(rtp->red);
+		rtp->red = NULL;
+	}
+
+	memset(&rtp->them.sin_addr, 0, sizeof(rtp->them.sin_addr));
+	memset(&rtp->them.sin_port, 0, sizeof(rtp->them.sin_port));
+	if (rtp->rtcp) {
+		memset(&rtp->rtcp->them.sin_addr, 0, sizeof(rtp->rtcp->them.sin_addr));
+		memset(&rtp->rtcp->them.sin_port, 0, sizeof(rtp->rtcp->them.sin_port));
+	}
+	
+	tris_clear_flag(rtp, FLAG_P2P_SENT_MARK);
 }
 
-/*! \brief Write RTP packet with audio or video media frames into UDP packet */
-static int tris_rtp_raw_write(struct tris_rtp *rtp, struct tris_frame *f, int codec)
+void tris_rtp_reset(struct tris_rtp *rtp)
 {
-	unsigned char *rtpheader;
-	int hdrlen = 12;
-	int res;
-	unsigned int ms;
-	int pred;
-	int mark = 0;
-	int rate = rtp_get_rate(f->subclass) / 1000;
+	memset(&rtp->rxcore, 0, sizeof(rtp->rxcore));
+	memset(&rtp->txcore, 0, sizeof(rtp->txcore));
+	memset(&rtp->dtmfmute, 0, sizeof(rtp->dtmfmute));
+	rtp->lastts = 0;
+	rtp->lastdigitts = 0;
+	rtp->lastrxts = 0;
+	rtp->lastividtimestamp = 0;
+	rtp->lastovidtimestamp = 0;
+	rtp->lastitexttimestamp = 0;
+	rtp->lastotexttimestamp = 0;
+	rtp->lasteventseqn = 0;
+	rtp->lastevent = 0;
+	rtp->lasttxformat = 0;
+	rtp->lastrxformat = 0;
+	rtp->dtmf_timeout = 0;
+	rtp->dtmfsamples = 0;
+	rtp->seqno = 0;
+	rtp->rxseqno = 0;
+}
 
-	if (f->subclass == TRIS_FORMAT_G722) {
-		f->samples /= 2;
+/*! Get QoS values from RTP and RTCP data (used in "sip show channelstats") */
+unsigned int tris_rtp_get_qosvalue(struct tris_rtp *rtp, enum tris_rtp_qos_vars value)
+{
+	if (rtp == NULL) {
+		if (option_debug > 1)
+			tris_log(LOG_DEBUG, "NO RTP Structure? Kidding me? \n");
+		return 0;
+	}
+	if (option_debug > 1 && rtp->rtcp == NULL) {
+		tris_log(LOG_DEBUG, "NO RTCP structure. Maybe in RTP p2p bridging mode? \n");
 	}
 
-	if (rtp->sending_digit) {
-		return 0;
+	switch (value) {
+	case TRIS_RTP_TXCOUNT:
+		return (unsigned int) rtp->txcount;
+	case TRIS_RTP_RXCOUNT:
+		return (unsigned int) rtp->rxcount;
+	case TRIS_RTP_TXJITTER:
+		return (unsigned int) (rtp->rxjitter * 1000.0);
+	case TRIS_RTP_RXJITTER:
+		return (unsigned int) (rtp->rtcp ? (rtp->rtcp->reported_jitter / (unsigned int) 65536.0) : 0);
+	case TRIS_RTP_RXPLOSS:
+		return rtp->rtcp ? (rtp->rtcp->expected_prior - rtp->rtcp->received_prior) : 0;
+	case TRIS_RTP_TXPLOSS:
+		return rtp->rtcp ? rtp->rtcp->reported_lost : 0;
+	case TRIS_RTP_RTT:
+		return (unsigned int) (rtp->rtcp ? (rtp->rtcp->rtt * 100) : 0);
 	}
+	return 0;	/* To make the compiler happy */
+}
 
-	ms = calc_txstamp(rtp, &f->delivery);
-	/* Default prediction */
-	if (f->frametype == TRIS_FRAME_VOICE) {
-		pred = rtp->lastts + f->samples;
+static double __tris_rtp_get_qos(struct tris_rtp *rtp, const char *qos, int *found)
+{
+	*found = 1;
 
-		/* Re-calculate last TS */
-		rtp->lastts = rtp->lastts + ms * rate;
-		if (tris_tvzero(f->delivery)) {
-			/* If this isn't an absolute delivery time, Check if it is close to our prediction, 
-			   and if so, go with our prediction */
-			if (abs(rtp->lastts - pred) < MAX_TIMESTAMP_SKEW)
-				rtp->lastts = pred;
-			else {
-				tris_debug(3, "Difference is %d, ms is %d\n", abs(rtp->lastts - pred), ms);
-				mark = 1;
-			}
-		}
-	} else if (f->frametype == TRIS_FRAME_VIDEO) {
-		mark = f->subclass & 0x1;
-		pred = rtp->lastovidtimestamp + f->samples;
-		/* Re-calculate last TS */
-		rtp->lastts = rtp->lastts + ms * 90;
-		/* If it's close to our prediction, go for it */
-		if (tris_tvzero(f->delivery)) {
-			if (abs(rtp->lastts - pred) < 7200) {
-				rtp->lastts = pred;
-				rtp->lastovidtimestamp += f->samples;
-			} else {
-				tris_debug(3, "Difference is %d, ms is %d (%d), pred/ts/samples %d/%d/%d\n", abs(rtp->lastts - pred), ms, ms * 90, rtp->lastts, pred, f->samples);
-				rtp->lastovidtimestamp = rtp->lastts;
-			}
-		}
-	} else {
-		pred = rtp->lastotexttimestamp + f->samples;
-		/* Re-calculate last TS */
-		rtp->lastts = rtp->lastts + ms;
-		/* If it's close to our prediction, go for it */
-		if (tris_tvzero(f->delivery)) {
-			if (abs(rtp->lastts - pred) < 7200) {
-				rtp->lastts = pred;
-				rtp->lastotexttimestamp += f->samples;
-			} else {
-				tris_debug(3, "Difference is %d, ms is %d, pred/ts/samples %d/%d/%d\n", abs(rtp->lastts - pred), ms, rtp->lastts, pred, f->samples);
-				rtp->lastotexttimestamp = rtp->lastts;
-			}
-		}
-		if (f->frametype == TRIS_FRAME_FILE) {
-			rtp->lastts = f->ts;
-			if (f->subclass & 0x08) {
-				mark = 1;
-			}
-			codec = codec & 0xf7;
-			rtp->ssrc = rtp->themssrc;
-			rtp->seqno = f->seqno;
-		}
-	}
+	if (!strcasecmp(qos, "remote_maxjitter"))
+		return rtp->rtcp->reported_maxjitter * 1000.0;
+	if (!strcasecmp(qos, "remote_minjitter"))
+		return rtp->rtcp->reported_minjitter * 1000.0;
+	if (!strcasecmp(qos, "remote_normdevjitter"))
+		return rtp->rtcp->reported_normdev_jitter * 1000.0;
+	if (!strcasecmp(qos, "remote_stdevjitter"))
+		return sqrt(rtp->rtcp->reported_stdev_jitter) * 1000.0;
 
-	/* If we have been explicitly told to set the marker bit do so */
-	if (rtp->set_marker_bit) {
-		mark = 1;
-		rtp->set_marker_bit = 0;
-	}
+	if (!strcasecmp(qos, "local_maxjitter"))
+		return rtp->rtcp->maxrxjitter * 1000.0;
+	if (!strcasecmp(qos, "local_minjitter"))
+		return rtp->rtcp->minrxjitter * 1000.0;
+	if (!strcasecmp(qos, "local_normdevjitter"))
+		return rtp->rtcp->normdev_rxjitter * 1000.0;
+	if (!strcasecmp(qos, "local_stdevjitter"))
+		return sqrt(rtp->rtcp->stdev_rxjitter) * 1000.0;
 
-	/* If the timestamp for non-digit packets has moved beyond the timestamp
-	   for digits, update the digit timestamp.
-	*/
-	if (rtp->lastts > rtp->lastdigitts)
-		rtp->lastdigitts = rtp->lastts;
+	if (!strcasecmp(qos, "maxrtt"))
+		return rtp->rtcp->maxrtt * 1000.0;
+	if (!strcasecmp(qos, "minrtt"))
+		return rtp->rtcp->minrtt * 1000.0;
+	if (!strcasecmp(qos, "normdevrtt"))
+		return rtp->rtcp->normdevrtt * 1000.0;
+	if (!strcasecmp(qos, "stdevrtt"))
+		return sqrt(rtp->rtcp->stdevrtt) * 1000.0;
 
-	if (tris_test_flag(f, TRIS_FRFLAG_HAS_TIMING_INFO))
-		rtp->lastts = f->ts * rate;
+	if (!strcasecmp(qos, "rx_syscalls"))
+		return rtp->iostats.rxcalls;
+	if (!strcasecmp(qos, "rx_datagrams"))
+		return rtp->iostats.rxpackets;
+	if (!strcasecmp(qos, "rx_dropped"))
+		return rtp->iostats.rxdropped;
+	if (!strcasecmp(qos, "tx_syscalls"))
+		return rtp->iostats.txcalls;
+	if (!strcasecmp(qos, "tx_datagrams"))
+		return rtp->iostats.txpackets;
+	if (!strcasecmp(qos, "tx_errors"))
+		return rtp->iostats.txerrors;
+
+	if (!strcasecmp(qos, "rtcp_rx_syscalls"))
+		return rtp->rtcp->iostats.rxcalls;
+	if (!strcasecmp(qos, "rtcp_rx_datagrams"))
+		return rtp->rtcp->iostats.rxpackets;
+	if (!strcasecmp(qos, "rtcp_tx_syscalls"))
+		return rtp->rtcp->iostats.txcalls;
+	if (!strcasecmp(qos, "rtcp_tx_datagrams"))
+		return rtp->rtcp->iostats.txpackets;
 
-	/* Get a pointer to the header */
-	rtpheader = (unsigned char *)(f->data.ptr - hdrlen);
+	*found = 0;
 
-	put_unaligned_uint32(rtpheader, htonl((2 << 30) | (codec << 16) | (rtp->seqno) | (mark << 23)));
-	put_unaligned_uint32(rtpheader + 4, htonl(rtp->lastts));
-	put_unaligned_uint32(rtpheader + 8, htonl(rtp->ssrc)); 
+	return 0.0;
+}
 
-	if (rtp->them.sin_port && rtp->them.sin_addr.s_addr) {
-		res = sendto(rtp->s, (void *)rtpheader, f->datalen + hdrlen, 0, (struct sockaddr *)&rtp->them, sizeof(rtp->them));
-		if (res < 0) {
-			if (!rtp->nat || (rtp->nat && (tris_test_flag(rtp, FLAG_NAT_ACTIVE) == FLAG_NAT_ACTIVE))) {
-				tris_debug(1, "RTP Transmission error of packet %d to %s:%d: %s\n", rtp->seqno, tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), strerror(errno));
-			} else if (((tris_test_flag(rtp, FLAG_NAT_ACTIVE) == FLAG_NAT_INACTIVE) || rtpdebug) && !tris_test_flag(rtp, FLAG_NAT_INACTIVE_NOWARN)) {
-				/* Only give this error message once if we are not RTP debugging */
-				if (option_debug || rtpdebug)
-					tris_debug(0, "RTP NAT: Can't write RTP to private address %s:%d, waiting for other end to send audio...\n", tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port));
-				tris_set_flag(rtp, FLAG_NAT_INACTIVE_NOWARN);
-			}
-		} else {
-			rtp->txcount++;
-			rtp->txoctetcount +=(res - hdrlen);
-			
-			/* Do not schedule RR if RTCP isn't run */
-			if (rtp->rtcp && rtp->rtcp->them.sin_addr.s_addr && rtp->rtcp->schedid < 1) {
-				rtp->rtcp->schedid = tris_sched_add(rtp->sched, tris_rtcp_calc_interval(rtp), tris_rtcp_write, rtp);
-			}
-		}
-				
-		if (rtp_debug_test_addr(&rtp->them))
-			tris_verbose("Sent RTP packet to      %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-					tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), codec, rtp->seqno, rtp->lastts,res - hdrlen);
-	}
+int tris_rtp_get_qos(struct tris_rtp *rtp, const char *qos, char *buf, unsigned int buflen)
+{
+	double value;
+	int found;
 
-	rtp->seqno++;
+	value = __tris_rtp_get_qos(rtp, qos, &found);
+
+	if (!found)
+		return -1;
+
+	snprintf(buf, buflen, "%.0lf", value);
 
 	return 0;
 }
 
-struct tris_frame *rakwon_audio_mixing_read(struct tris_rtp *rtp)
+void tris_rtp_set_vars(struct tris_channel *chan, struct tris_rtp *rtp) {
+	char *audioqos;
+	char *audioqos_jitter;
+	char *audioqos_loss;
+	char *audioqos_rtt;
+	struct tris_channel *bridge;
+
+	if (!rtp || !chan)
+		return;
+
+	bridge = tris_bridged_channel(chan);
+
+	audioqos        = tris_rtp_get_quality(rtp, NULL, RTPQOS_SUMMARY);
+	audioqos_jitter = tris_rtp_get_quality(rtp, NULL, RTPQOS_JITTER);
+	audioqos_loss   = tris_rtp_get_quality(rtp, NULL, RTPQOS_LOSS);
+	audioqos_rtt    = tris_rtp_get_quality(rtp, NULL, RTPQOS_RTT);
+
+	pbx_builtin_setvar_helper(chan, "RTPAUDIOQOS", audioqos);
+	pbx_builtin_setvar_helper(chan, "RTPAUDIOQOSJITTER", audioqos_jitter);
+	pbx_builtin_setvar_helper(chan, "RTPAUDIOQOSLOSS", audioqos_loss);
+	pbx_builtin_setvar_helper(chan, "RTPAUDIOQOSRTT", audioqos_rtt);
+
+	if (!bridge)
+		return;
+
+	pbx_builtin_setvar_helper(bridge, "RTPAUDIOQOSBRIDGED", audioqos);
+	pbx_builtin_setvar_helper(bridge, "RTPAUDIOQOSJITTERBRIDGED", audioqos_jitter);
+	pbx_builtin_setvar_helper(bridge, "RTPAUDIOQOSLOSSBRIDGED", audioqos_loss);
+	pbx_builtin_setvar_helper(bridge, "RTPAUDIOQOSRTTBRIDGED", audioqos_rtt);
+}
+
+static char *__tris_rtp_get_quality_jitter(struct tris_rtp *rtp)
 {
-	int res;
-	struct sockaddr_in sock_in;
-	socklen_t len;
-	unsigned int seqno;
-	int version;
-	int payloadtype;
-	int hdrlen = 12;
-	int padding;
-	int mark;
-	int ext;
-	int cc;
-	unsigned int ssrc;
-	unsigned int timestamp;
-	unsigned int *rtpheader;
-	struct rtpPayloadType rtpPT;
-	int prev_seqno;
-	
-	/* If time is up, kill it */
-	if (rtp->sending_digit)
-		tris_rtp_senddigit_continuation(rtp);
+	/*
+	*ssrc          our ssrc
+	*themssrc      their ssrc
+	*lp            lost packets
+	*rxjitter      our calculated jitter(rx)
+	*rxcount       no. received packets
+	*txjitter      reported jitter of the other end
+	*txcount       transmitted packets
+	*rlp           remote lost packets
+	*rtt           round trip time
+	*/
+#define RTCP_JITTER_FORMAT1 \
+	"minrxjitter=%f;" \
+	"maxrxjitter=%f;" \
+	"avgrxjitter=%f;" \
+	"stdevrxjitter=%f;" \
+	"reported_minjitter=%f;" \
+	"reported_maxjitter=%f;" \
+	"reported_avgjitter=%f;" \
+	"reported_stdevjitter=%f;"
 
-	len = sizeof(sock_in);
-	
-	/* Cache where the header will go */
-	res = recvfrom(rtp->s, rtp->rawdata + TRIS_FRIENDLY_OFFSET, sizeof(rtp->rawdata) - TRIS_FRIENDLY_OFFSET,
-					0, (struct sockaddr *)&sock_in, &len);
+#define RTCP_JITTER_FORMAT2 \
+	"rxjitter=%f;"
 
-	/* If strict RTP protection is enabled see if we need to learn this address or if the packet should be dropped */
-	if (rtp->strict_rtp_state == STRICT_RTP_LEARN) {
-		/* Copy over address that this packet was received on */
-		memcpy(&rtp->strict_rtp_address, &sock_in, sizeof(rtp->strict_rtp_address));
-		/* Now move over to actually protecting the RTP port */
-		rtp->strict_rtp_state = STRICT_RTP_CLOSED;
-		tris_debug(1, "Learned remote address is %s:%d for strict RTP purposes, now protecting the port.\n", tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-	} else if (rtp->strict_rtp_state == STRICT_RTP_CLOSED) {
-		/* If the address we previously learned doesn't match the address this packet came in on simply drop it */
-		if ((rtp->strict_rtp_address.sin_addr.s_addr != sock_in.sin_addr.s_addr) || (rtp->strict_rtp_address.sin_port != sock_in.sin_port)) {
-			tris_debug(1, "Received RTP packet from %s:%d, dropping due to strict RTP protection. Expected it to be from %s:%d\n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-			return &tris_null_frame;
-		}
+	if (rtp->rtcp && rtp->rtcp->rtcp_info) {
+		snprintf(rtp->rtcp->quality_jitter, sizeof(rtp->rtcp->quality_jitter), RTCP_JITTER_FORMAT1,
+			rtp->rtcp->minrxjitter,
+			rtp->rtcp->maxrxjitter,
+			rtp->rtcp->normdev_rxjitter,
+			sqrt(rtp->rtcp->stdev_rxjitter),
+			rtp->rtcp->reported_minjitter,
+			rtp->rtcp->reported_maxjitter,
+			rtp->rtcp->reported_normdev_jitter,
+			sqrt(rtp->rtcp->reported_stdev_jitter)
+		);
+	} else {
+		snprintf(rtp->rtcp->quality_jitter, sizeof(rtp->rtcp->quality_jitter), RTCP_JITTER_FORMAT2,
+			rtp->rxjitter
+		);
 	}
 
-	rtpheader = (unsigned int *)(rtp->rawdata + TRIS_FRIENDLY_OFFSET);
-	if (res < 0) {
-		tris_assert(errno != EBADF);
-		if (errno != EAGAIN) {
-			tris_log(LOG_WARNING, "RTP Read error: %s.  Hanging up.\n", strerror(errno));
-			return NULL;
-		}
-		return &tris_null_frame;
-	}
-	
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short\n");
-		return &tris_null_frame;
-	}
+	return rtp->rtcp->quality_jitter;
 
-	/* Get fields */
-	seqno = ntohl(rtpheader[0]);
+#undef RTCP_JITTER_FORMAT1
+#undef RTCP_JITTER_FORMAT2
+}
 
-	/* Check RTP version */
-	version = (seqno & 0xC0000000) >> 30;
-	if (!version) {
-		/* If the two high bits are 0, this might be a
-		 * STUN message, so process it. stun_handle_packet()
-		 * answers to requests, and it returns STUN_ACCEPT
-		 * if the request is valid.
-		 */
-		if ((stun_handle_packet(rtp->s, &sock_in, rtp->rawdata + TRIS_FRIENDLY_OFFSET, res, NULL, NULL) == STUN_ACCEPT) &&
-			(!rtp->them.sin_port && !rtp->them.sin_addr.s_addr)) {
-			memcpy(&rtp->them, &sock_in, sizeof(rtp->them));
-		}
-		return &tris_null_frame;
+static char *__tris_rtp_get_quality_loss(struct tris_rtp *rtp)
+{
+	unsigned int lost;
+	unsigned int extended;
+	unsigned int expected;
+	int fraction;
+
+#define RTCP_LOSS_FORMAT1 \
+	"minrxlost=%f;" \
+	"maxrxlost=%f;" \
+	"avgrxlostr=%f;" \
+	"stdevrxlost=%f;" \
+	"reported_minlost=%f;" \
+	"reported_maxlost=%f;" \
+	"reported_avglost=%f;" \
+	"reported_stdevlost=%f;"
+
+#define RTCP_LOSS_FORMAT2 \
+	"lost=%d;" \
+	"expected=%d;"
+	
+	if (rtp->rtcp && rtp->rtcp->rtcp_info && rtp->rtcp->maxrxlost > 0) {
+		snprintf(rtp->rtcp->quality_loss, sizeof(rtp->rtcp->quality_loss), RTCP_LOSS_FORMAT1,
+			rtp->rtcp->minrxlost,
+			rtp->rtcp->maxrxlost,
+			rtp->rtcp->normdev_rxlost,
+			sqrt(rtp->rtcp->stdev_rxlost),
+			rtp->rtcp->reported_minlost,
+			rtp->rtcp->reported_maxlost,
+			rtp->rtcp->reported_normdev_lost,
+			sqrt(rtp->rtcp->reported_stdev_lost)
+		);
+	} else {
+		extended = rtp->cycles + rtp->lastrxseqno;
+		expected = extended - rtp->seedrxseqno + 1;
+		if (rtp->rxcount > expected) 
+			expected += rtp->rxcount - expected;
+		lost = expected - rtp->rxcount;
+
+		if (!expected || lost <= 0)
+			fraction = 0;
+		else
+			fraction = (lost << 8) / expected;
+
+		snprintf(rtp->rtcp->quality_loss, sizeof(rtp->rtcp->quality_loss), RTCP_LOSS_FORMAT2,
+			lost,
+			expected
+		);
 	}
 
-#if 0	/* Allow to receive RTP stream with closed transmission path */
-	/* If we don't have the other side's address, then ignore this */
-	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
-		return &tris_null_frame;
-#endif
+	return rtp->rtcp->quality_loss;
 
-	if (version != 2)
-		return &tris_null_frame;
+#undef RTCP_LOSS_FORMAT1
+#undef RTCP_LOSS_FORMAT2
+}
 
-	payloadtype = (seqno & 0x7f0000) >> 16;
-	padding = seqno & (1 << 29);
-	mark = seqno & (1 << 23);
-	ext = seqno & (1 << 28);
-	cc = (seqno & 0xF000000) >> 24;
-	seqno &= 0xffff;
-	timestamp = ntohl(rtpheader[1]);
-	ssrc = ntohl(rtpheader[2]);
-	
-	if (padding) {
-		/* Remove padding bytes */
-		res -= rtp->rawdata[TRIS_FRIENDLY_OFFSET + res - 1];
+static char *__tris_rtp_get_quality_rtt(struct tris_rtp *rtp)
+{
+	if (rtp->rtcp && rtp->rtcp->rtcp_info) {
+		snprintf(rtp->rtcp->quality_rtt, sizeof(rtp->rtcp->quality_rtt), "minrtt=%f;maxrtt=%f;avgrtt=%f;stdevrtt=%f;",
+			rtp->rtcp->minrtt,
+			rtp->rtcp->maxrtt,
+			rtp->rtcp->normdevrtt,
+			sqrt(rtp->rtcp->stdevrtt)
+		);
+	} else {
+		snprintf(rtp->rtcp->quality_rtt, sizeof(rtp->rtcp->quality_rtt), "Not available");
 	}
-	
-	if (cc) {
-		/* CSRC fields present */
-		hdrlen += cc*4;
+
+	return rtp->rtcp->quality_rtt;
+}
+
+static char *__tris_rtp_get_quality(struct tris_rtp *rtp)
+{
+	/*
+	*ssrc          our ssrc
+	*themssrc      their ssrc
+	*lp            lost packets
+	*rxjitter      our calculated jitter(rx)
+	*rxcount       no. received packets
+	*txjitter      reported jitter of the other end
+	*txcount       transmitted packets
+	*rlp           remote lost packets
+	*rtt           round trip time
+	*/	
+
+	if (rtp->rtcp && rtp->rtcp->rtcp_info) {
+		snprintf(rtp->rtcp->quality, sizeof(rtp->rtcp->quality),
+			"ssrc=%u;themssrc=%u;lp=%u;rxjitter=%f;rxcount=%u;txjitter=%f;txcount=%u;rlp=%u;rtt=%f",
+			rtp->ssrc,
+			rtp->themssrc,
+			rtp->rtcp->expected_prior - rtp->rtcp->received_prior,
+			rtp->rxjitter,
+			rtp->rxcount,
+			(double)rtp->rtcp->reported_jitter / 65536.0,
+			rtp->txcount,
+			rtp->rtcp->reported_lost,
+			rtp->rtcp->rtt
+		);
+	} else {
+		snprintf(rtp->rtcp->quality, sizeof(rtp->rtcp->quality), "ssrc=%u;themssrc=%u;rxjitter=%f;rxcount=%u;txcount=%u;",
+			rtp->ssrc,
+			rtp->themssrc,
+			rtp->rxjitter,
+			rtp->rxcount,
+			rtp->txcount
+		);
 	}
 
-	if (ext) {
-		/* RTP Extension present */
-		hdrlen += (ntohl(rtpheader[hdrlen/4]) & 0xffff) << 2;
-		hdrlen += 4;
-		if (option_debug) {
-			int profile;
-			profile = (ntohl(rtpheader[3]) & 0xffff0000) >> 16;
-			if (profile == 0x505a)
-				tris_debug(1, "Found Zfone extension in RTP stream - zrtp - not supported.\n");
-			else
-				tris_debug(1, "Found unknown RTP Extensions %x\n", profile);
+	return rtp->rtcp->quality;
+}
+
+char *tris_rtp_get_quality(struct tris_rtp *rtp, struct tris_rtp_quality *qual, enum tris_rtp_quality_type qtype) 
+{
+	if (qual && rtp) {
+		qual->local_ssrc   = rtp->ssrc;
+		qual->local_jitter = rtp->rxjitter;
+		qual->local_count  = rtp->rxcount;
+		qual->remote_ssrc  = rtp->themssrc;
+		qual->remote_count = rtp->txcount;
+
+		if (rtp->rtcp) {
+			qual->local_lostpackets  = rtp->rtcp->expected_prior - rtp->rtcp->received_prior;
+			qual->remote_lostpackets = rtp->rtcp->reported_lost;
+			qual->remote_jitter      = rtp->rtcp->reported_jitter / 65536.0;
+			qual->rtt                = rtp->rtcp->rtt;
 		}
 	}
 
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short (%d, expecting %d)\n", res, hdrlen);
-		return &tris_null_frame;
+	switch (qtype) {
+	case RTPQOS_SUMMARY:
+		return __tris_rtp_get_quality(rtp);
+	case RTPQOS_JITTER:
+		return __tris_rtp_get_quality_jitter(rtp);
+	case RTPQOS_LOSS:
+		return __tris_rtp_get_quality_loss(rtp);
+	case RTPQOS_RTT:
+		return __tris_rtp_get_quality_rtt(rtp);
 	}
 
-	rtp->rxcount++; /* Only count reasonably valid packets, this'll make the rtcp stats more accurate */
+	return NULL;
+}
 
-	if (rtp->rxcount==1) {
-		/* This is the first RTP packet successfully received from source */
-		rtp->seedrxseqno = seqno;
+void tris_rtp_destroy(struct tris_rtp *rtp)
+{
+	if (rtcp_debug_test_addr(&rtp->them) || rtcpstats) {
+		/*Print some info on the call here */
+		tris_verbose("  RTP-stats\n");
+		tris_verbose("* Our Receiver:\n");
+		tris_verbose("  SSRC:		 %u\n", rtp->themssrc);
+		tris_verbose("  Received packets: %u\n", rtp->rxcount);
+		tris_verbose("  Lost packets:	 %u\n", rtp->rtcp ? (rtp->rtcp->expected_prior - rtp->rtcp->received_prior) : 0);
+		tris_verbose("  Jitter:		 %.4f\n", rtp->rxjitter);
+		tris_verbose("  Transit:		 %.4f\n", rtp->rxtransit);
+		tris_verbose("  RR-count:	 %u\n", rtp->rtcp ? rtp->rtcp->rr_count : 0);
+		tris_verbose("* Our Sender:\n");
+		tris_verbose("  SSRC:		 %u\n", rtp->ssrc);
+		tris_verbose("  Sent packets:	 %u\n", rtp->txcount);
+		tris_verbose("  Lost packets:	 %u\n", rtp->rtcp ? rtp->rtcp->reported_lost : 0);
+		tris_verbose("  Jitter:		 %u\n", rtp->rtcp ? (rtp->rtcp->reported_jitter / (unsigned int)65536.0) : 0);
+		tris_verbose("  SR-count:	 %u\n", rtp->rtcp ? rtp->rtcp->sr_count : 0);
+		tris_verbose("  RTT:		 %f\n", rtp->rtcp ? rtp->rtcp->rtt : 0);
 	}
 
-	/* Do not schedule RR if RTCP isn't run */
-	if (rtp->rtcp && rtp->rtcp->them.sin_addr.s_addr && rtp->rtcp->schedid < 1) {
-		/* Schedule transmission of Receiver Report */
-		rtp->rtcp->schedid = tris_sched_add(rtp->sched, tris_rtcp_calc_interval(rtp), tris_rtcp_write, rtp);
+	/*if (rtp->rtcp) {
+		manager_event(EVENT_FLAG_REPORTING, "RTPReceiverStat", "SSRC: %u\r\n"
+					    "ReceivedPackets: %u\r\n"
+					    "LostPackets: %u\r\n"
+					    "Jitter: %.4f\r\n"
+					    "Transit: %.4f\r\n"
+					    "RRCount: %u\r\n",
+					    rtp->themssrc,
+					    rtp->rxcount,
+					    rtp->rtcp ? (rtp->rtcp->expected_prior - rtp->rtcp->received_prior) : 0,
+					    rtp->rxjitter,
+					    rtp->rxtransit,
+					    rtp->rtcp ? rtp->rtcp->rr_count : 0);
+		manager_event(EVENT_FLAG_REPORTING, "RTPSenderStat", "SSRC: %u\r\n"
+					    "SentPackets: %u\r\n"
+					    "LostPackets: %u\r\n"
+					    "Jitter: %u\r\n"
+					    "SRCount: %u\r\n"
+					    "RTT: %f\r\n",
+					    rtp->ssrc,
+					    rtp->txcount,
+					    rtp->rtcp ? rtp->rtcp->reported_lost : 0,
+					    rtp->rtcp ? rtp->rtcp->reported_jitter : 0,
+					    rtp->rtcp ? rtp->rtcp->sr_count : 0,
+					    rtp->rtcp ? rtp->rtcp->rtt : 0);
+	}*/
+	if (rtp->smoother)
+		tris_smoother_free(rtp->smoother);
+	if (rtp->ioid)
+		tris_io_remove(rtp->io, rtp->ioid);
+	if (rtp->s > -1)
+		close(rtp->s);
+	if (rtp->rtcp) {
+		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
+		close(rtp->rtcp->s);
+		tris_udp_batch_free(rtp->rtcp->rxbatch);
+		tris_free(rtp->rtcp);
+		rtp->rtcp=NULL;
 	}
-	if ((int)rtp->lastrxseqno - (int)seqno  > 100) /* if so it would indicate that the sender cycled; allow for misordering */
-		rtp->cycles += RTP_SEQ_MOD;
-	
-	prev_seqno = rtp->lastrxseqno;
-
-	rtp->lastrxseqno = seqno;
-	
-	if (!rtp->themssrc)
-		rtp->themssrc = ntohl(rtpheader[2]); /* Record their SSRC to put in future RR */
-	
-	if (rtp_debug_test_addr(&sock_in))
-		tris_verbose("Got  RTP packet from    %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-			tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp,res - hdrlen);
-
-	rtpPT = tris_rtp_lookup_pt(rtp, payloadtype);
-	if (!rtpPT.isAstFormat) {
-		struct tris_frame *f = NULL;
+	if (rtp->rawdata) {
+		tris_free(rtp->rawdata);
+		rtp->rawdata = 0;
+	}
+	tris_udp_batch_free(rtp->rxbatch);
+	tris_udp_batch_free(rtp->txbatch);
+#ifdef P2P_INTENSE
+	tris_mutex_destroy(&rtp->bridge_lock);
+#endif
+	tris_free(rtp);
+}
 
-		/* This is special in-band data that's not one of our codecs */
-		if (rtpPT.code == TRIS_RTP_DTMF) {
-			/* It's special -- rfc2833 process it */
-			if (rtp_debug_test_addr(&sock_in)) {
-				unsigned char *data;
-				unsigned int event;
-				unsigned int event_end;
-				unsigned int duration;
-				data = rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen;
-				event = ntohl(*((unsigned int *)(data)));
-				event >>= 24;
-				event_end = ntohl(*((unsigned int *)(data)));
-				event_end <<= 8;
-				event_end >>= 24;
-				duration = ntohl(*((unsigned int *)(data)));
-				duration &= 0xFFFF;
-				tris_verbose("Got  RTP RFC2833 from   %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u, mark %d, event %08x, end %d, duration %-5.5d) \n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp, res - hdrlen, (mark?1:0), event, ((event_end & 0x80)?1:0), duration);
-			}
-			f = process_rfc2833(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen, seqno, timestamp);
-		} else if (rtpPT.code == TRIS_RTP_CISCO_DTMF) {
-			/* It's really special -- process it the Cisco way */
-			if (rtp->lastevent <= seqno || (rtp->lastevent >= 65530 && seqno <= 6)) {
-				f = process_cisco_dtmf(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-				rtp->lastevent = seqno;
-			}
-		} else if (rtpPT.code == TRIS_RTP_CN) {
-			/* Comfort Noise */
-			f = process_rfc3389(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-		} else {
-			tris_log(LOG_NOTICE, "Unknown RTP codec %d received from '%s'\n", payloadtype, tris_inet_ntoa(rtp->them.sin_addr));
-		}
-		return f ? f : &tris_null_frame;
+static unsigned int calc_txstamp(struct tris_rtp *rtp, struct timeval *delivery)
+{
+	struct timeval t;
+	long ms;
+	if (tris_tvzero(rtp->txcore)) {
+		rtp->txcore = tris_tvnow();
+		/* Round to 20ms for nice, pretty timestamps */
+		rtp->txcore.tv_usec -= rtp->txcore.tv_usec % 20000;
 	}
-	rtp->lastrxformat = rtp->f.subclass = rtpPT.code;
-	rtp->f.frametype = (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) ? TRIS_FRAME_VOICE : (rtp->f.subclass & TRIS_FORMAT_VIDEO_MASK) ? TRIS_FRAME_VIDEO : TRIS_FRAME_TEXT;
+	/* Use previous txcore if available */
+	t = (delivery && !tris_tvzero(*delivery)) ? *delivery : tris_tvnow();
+	ms = tris_tvdiff_ms(t, rtp->txcore);
+	if (ms < 0)
+		ms = 0;
+	/* Use what we just got for next time */
+	rtp->txcore = t;
+	return (unsigned int) ms;
+}
 
-	rtp->rxseqno = seqno;
+/*! \brief Send begin frames for DTMF */
+int tris_rtp_senddigit_begin(struct tris_rtp *rtp, char digit)
+{
+	unsigned int *rtpheader;
+	int hdrlen = 12, res = 0, i = 0, payload = 0;
+	char data[256];
 
-	/* Record received timestamp as last received now */
-	rtp->lastrxts = timestamp;
+	if ((digit <= '9') && (digit >= '0'))
+		digit -= '0';
+	else if (digit == '*')
+		digit = 10;
+	else if (digit == '#')
+		digit = 11;
+	else if ((digit >= 'A') && (digit <= 'D'))
+		digit = digit - 'A' + 12;
+	else if ((digit >= 'a') && (digit <= 'd'))
+		digit = digit - 'a' + 12;
+	else {
+		tris_log(LOG_WARNING, "Don't know how to represent '%c'\n", digit);
+		return 0;
+	}
 
-	rtp->f.promoter = *(rtp->rawdata + hdrlen + TRIS_FRIENDLY_OFFSET+12);
-	rtp->f.mallocd = 0;
-	rtp->f.datalen = res - hdrlen - 13;
-	rtp->f.data.ptr = rtp->rawdata + hdrlen + TRIS_FRIENDLY_OFFSET + 13;
-	rtp->f.offset = hdrlen + TRIS_FRIENDLY_OFFSET + 13;
-	rtp->f.seqno = seqno;
+	/* If we have no peer, return immediately */	
+	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
+		return 0;
 
-	if (rtp->f.subclass == TRIS_FORMAT_T140 && (int)seqno - (prev_seqno+1) > 0 && (int)seqno - (prev_seqno+1) < 10) {
-		  unsigned char *data = rtp->f.data.ptr;
-		  
-		  memmove(rtp->f.data.ptr+3, rtp->f.data.ptr, rtp->f.datalen);
-		  rtp->f.datalen +=3;
-		  *data++ = 0xEF;
-		  *data++ = 0xBF;
-		  *data = 0xBD;
-	}
- 
-	if (rtp->f.subclass == TRIS_FORMAT_T140RED) {
-		unsigned char *data = rtp->f.data.ptr;
-		unsigned char *header_end;
-		int num_generations;
-		int header_length;
-		int length;
-		int diff =(int)seqno - (prev_seqno+1); /* if diff = 0, no drop*/
-		int x;
+	payload = tris_rtp_lookup_code(rtp, 0, TRIS_RTP_DTMF);
 
-		rtp->f.subclass = TRIS_FORMAT_T140;
-		header_end = memchr(data, ((*data) & 0x7f), rtp->f.datalen);
-		if (header_end == NULL) {
-			return &tris_null_frame;
-		}
-		header_end++;
-		
-		header_length = header_end - data;
-		num_generations = header_length / 4;
-		length = header_length;
+	rtp->dtmfmute = tris_tvadd(tris_tvnow(), tris_tv(0, 500000));
+	rtp->send_duration = 160;
+	rtp->lastdigitts = rtp->lastts + rtp->send_duration;
+	
+	/* Get a pointer to the header */
+	rtpheader = (unsigned int *)data;
+	rtpheader[0] = htonl((2 << 30) | (1 << 23) | (payload << 16) | (rtp->seqno));
+	rtpheader[1] = htonl(rtp->lastdigitts);
+	rtpheader[2] = htonl(rtp->ssrc); 
 
-		if (!diff) {
-			for (x = 0; x < num_generations; x++)
-				length += data[x * 4 + 3];
-			
-			if (!(rtp->f.datalen - length))
-				return &tris_null_frame;
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-		} else if (diff > num_generations && diff < 10) {
-			length -= 3;
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-			
-			data = rtp->f.data.ptr;
-			*data++ = 0xEF;
-			*data++ = 0xBF;
-			*data = 0xBD;
-		} else 	{
-			for ( x = 0; x < num_generations - diff; x++) 
-				length += data[x * 4 + 3];
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-		}
+	for (i = 0; i < 2; i++) {
+		rtpheader[3] = htonl((digit << 24) | (0xa << 16) | (rtp->send_duration));
+		res = tris_udp_batch_sendto(rtp->txbatching ? rtp->txbatch : NULL, rtp->s, rtpheader, hdrlen + 4, &rtp->them, &rtp->iostats);
+		if (res < 0) 
+			tris_log(LOG_ERROR, "RTP Transmission error to %s:%u: %s\n",
+				tris_inet_ntoa(rtp->them.sin_addr),
+				ntohs(rtp->them.sin_port), strerror(errno));
+		if (rtp_debug_test_addr(&rtp->them))
+			tris_verbose("Sent RTP DTMF packet to %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
+				    tris_inet_ntoa(rtp->them.sin_addr),
+				    ntohs(rtp->them.sin_port), payload, rtp->seqno, rtp->lastdigitts, res - hdrlen);
+		/* Increment sequence number */
+		rtp->seqno++;
+		/* Increment duration */
+		rtp->send_duration += 160;
+		/* Clear marker bit and set seqno */
+		rtpheader[0] = htonl((2 << 30) | (payload << 16) | (rtp->seqno));
 	}
 
-	if (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) {
-		rtp->f.samples = tris_codec_get_samples(&rtp->f);
-		if (rtp->f.samples == -1)
-			return &tris_null_frame;
-		if (rtp->f.subclass == TRIS_FORMAT_SLINEAR) 
-			tris_frame_byteswap_be(&rtp->f);
-		calc_rxstamp(&rtp->f.delivery, rtp, timestamp, mark);
-		/* Add timing data to let tris_generic_bridge() put the frame into a jitterbuf */
-		tris_set_flag(&rtp->f, TRIS_FRFLAG_HAS_TIMING_INFO);
-		rtp->f.ts = timestamp / (rtp_get_rate(rtp->f.subclass) / 1000);
-		rtp->f.len = rtp->f.samples / ((tris_format_rate(rtp->f.subclass) / 1000));
-	} else if (rtp->f.subclass & TRIS_FORMAT_VIDEO_MASK) {
-		/* Video -- samples is # of samples vs. 90000 */
-		if (!rtp->lastividtimestamp)
-			rtp->lastividtimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastividtimestamp;
-		rtp->lastividtimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
-		/* Pass the RTP marker bit as bit 0 in the subclass field.
-		 * This is ok because subclass is actually a bitmask, and
-		 * the low bits represent audio formats, that are not
-		 * involved here since we deal with video.
-		 */
-		if (mark)
-			rtp->f.subclass |= 0x1;
-	} else {
-		/* TEXT -- samples is # of samples vs. 1000 */
-		if (!rtp->lastitexttimestamp)
-			rtp->lastitexttimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastitexttimestamp;
-		rtp->lastitexttimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
-	}
-	rtp->f.src = "RTP";
-	return &rtp->f;
+	/* Since we received a begin, we can safely store the digit and disable any compensation */
+	rtp->sending_digit = 1;
+	rtp->send_digit = digit;
+	rtp->send_payload = payload;
+
+	return 0;
 }
 
-struct tris_frame *rakwon_mixed_audio_read(struct tris_rtp* rtp, int fd)
+/*! \brief Send continuation frame for DTMF */
+static int tris_rtp_senddigit_continuation(struct tris_rtp *rtp)
 {
-	int res;
-	struct sockaddr_in sock_in;
-	socklen_t len;
-	unsigned int seqno;
-	int version;
-	int payloadtype;
-	int hdrlen = 12;
-	int padding;
-	int mark;
-	int ext;
-	int cc;
-	unsigned int ssrc;
-	unsigned int timestamp;
 	unsigned int *rtpheader;
-	struct rtpPayloadType rtpPT;
-	struct tris_rtp *bridged = NULL;
-	int prev_seqno;
-	
-	/* If time is up, kill it */
-	if (rtp->sending_digit)
-		tris_rtp_senddigit_continuation(rtp);
+	int hdrlen = 12, res = 0;
+	char data[256];
+
+	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
+		return 0;
 
-	len = sizeof(sock_in);
+	/* Setup packet to send */
+	rtpheader = (unsigned int *)data;
+	rtpheader[0] = htonl((2 << 30) | (1 << 23) | (rtp->send_payload << 16) | (rtp->seqno));
+	rtpheader[1] = htonl(rtp->lastdigitts);
+	rtpheader[2] = htonl(rtp->ssrc);
+	rtpheader[3] = htonl((rtp->send_digit << 24) | (0xa << 16) | (rtp->send_duration));
+	rtpheader[0] = htonl((2 << 30) | (rtp->send_payload << 16) | (rtp->seqno));
 	
-	/* Cache where the header will go */
-	res = read(fd, rtp->rawdata + TRIS_FRIENDLY_OFFSET, sizeof(rtp->rawdata) - TRIS_FRIENDLY_OFFSET);
+	/* Transmit */
+	res = tris_udp_batch_sendto(NULL, rtp->s, rtpheader, hdrlen + 4, &rtp->them, &rtp->iostats);
+	if (res < 0)
+		tris_log(LOG_ERROR, "RTP Transmission error to %s:%d: %s\n",
+			tris_inet_ntoa(rtp->them.sin_addr),
+			ntohs(rtp->them.sin_port), strerror(errno));
+	if (rtp_debug_test_addr(&rtp->them))
+		tris_verbose("Sent RTP DTMF packet to %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
+			    tris_inet_ntoa(rtp->them.sin_addr),
+			    ntohs(rtp->them.sin_port), rtp->send_payload, rtp->seqno, rtp->lastdigitts, res - hdrlen);
 
-	/* If strict RTP protection is enabled see if we need to learn this address or if the packet should be dropped */
-	if (rtp->strict_rtp_state == STRICT_RTP_LEARN) {
-		/* Copy over address that this packet was received on */
-		memcpy(&rtp->strict_rtp_address, &sock_in, sizeof(rtp->strict_rtp_address));
-		/* Now move over to actually protecting the RTP port */
-		rtp->strict_rtp_state = STRICT_RTP_CLOSED;
-		tris_debug(1, "Learned remote address is %s:%d for strict RTP purposes, now protecting the port.\n", tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-	} else if (rtp->strict_rtp_state == STRICT_RTP_CLOSED) {
-		/* If the address we previously learned doesn't match the address this packet came in on simply drop it */
-		if ((rtp->strict_rtp_address.sin_addr.s_addr != sock_in.sin_addr.s_addr) || (rtp->strict_rtp_address.sin_port != sock_in.sin_port)) {
-			tris_debug(1, "Received RTP packet from %s:%d, dropping due to strict RTP protection. Expected it to be from %s:%d\n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-			return &tris_null_frame;
-		}
-	}
+	/* Increment sequence number */
+	rtp->seqno++;
+	/* Increment duration */
+	rtp->send_duration += 160;
 
-	rtpheader = (unsigned int *)(rtp->rawdata + TRIS_FRIENDLY_OFFSET);
-	if (res < 0) {
-		tris_assert(errno != EBADF);
-		if (errno != EAGAIN) {
-			tris_log(LOG_WARNING, "RTP Read error: %s.  Hanging up.\n", strerror(errno));
-			return NULL;
-		}
-		return &tris_null_frame;
-	}
+	return 0;
+}
+
+/*! \brief Send end packets for DTMF */
+int tris_rtp_senddigit_end(struct tris_rtp *rtp, char digit)
+{
+	unsigned int *rtpheader;
+	int hdrlen = 12, res = 0, i = 0;
+	char data[256];
 	
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short\n");
-		return &tris_null_frame;
+	/* If no address, then bail out */
+	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
+		return 0;
+	
+	if ((digit <= '9') && (digit >= '0'))
+		digit -= '0';
+	else if (digit == '*')
+		digit = 10;
+	else if (digit == '#')
+		digit = 11;
+	else if ((digit >= 'A') && (digit <= 'D'))
+		digit = digit - 'A' + 12;
+	else if ((digit >= 'a') && (digit <= 'd'))
+		digit = digit - 'a' + 12;
+	else {
+		tris_log(LOG_WARNING, "Don't know how to represent '%c'\n", digit);
+		return 0;
 	}
 
-	/* Get fields */
-	seqno = ntohl(rtpheader[0]);
+	rtp->dtmfmute = tris_tvadd(tris_tvnow(), tris_tv(0, 500000));
 
-	/* Check RTP version */
-	version = (seqno & 0xC0000000) >> 30;
-	if (!version) {
-		/* If the two high bits are 0, this might be a
-		 * STUN message, so process it. stun_handle_packet()
-		 * answers to requests, and it returns STUN_ACCEPT
-		 * if the request is valid.
-		 */
-		if ((stun_handle_packet(rtp->s, &sock_in, rtp->rawdata + TRIS_FRIENDLY_OFFSET, res, NULL, NULL) == STUN_ACCEPT) &&
-			(!rtp->them.sin_port && !rtp->them.sin_addr.s_addr)) {
-			memcpy(&rtp->them, &sock_in, sizeof(rtp->them));
-		}
-		return &tris_null_frame;
+	rtpheader = (unsigned int *)data;
+	rtpheader[1] = htonl(rtp->lastdigitts);
+	rtpheader[2] = htonl(rtp->ssrc);
+	rtpheader[3] = htonl((digit << 24) | (0xa << 16) | (rtp->send_duration));
+	/* Set end bit */
+	rtpheader[3] |= htonl((1 << 23));
+
+	/* Send 3 termination packets */
+	rtp->txbatching = 1;
+	for (i = 0; i < 3; i++) {
+		rtpheader[0] = htonl((2 << 30) | (rtp->send_payload << 16) | (rtp->seqno));
+		res = tris_udp_batch_sendto(rtp->txbatching ? rtp->txbatch : NULL, rtp->s, rtpheader, hdrlen + 4, &rtp->them, &rtp->iostats);
+		rtp->seqno++;
+		if (res < 0)
+			tris_log(LOG_ERROR, "RTP Transmission error to %s:%d: %s\n",
+				tris_inet_ntoa(rtp->them.sin_addr),
+				ntohs(rtp->them.sin_port), strerror(errno));
+		if (rtp_debug_test_addr(&rtp->them))
+			tris_verbose("Sent RTP DTMF packet to %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
+				    tris_inet_ntoa(rtp->them.sin_addr),
+				    ntohs(rtp->them.sin_port), rtp->send_payload, rtp->seqno, rtp->lastdigitts, res - hdrlen);
 	}
+	rtp->txbatching = 0;
+	tris_udp_batch_flush(rtp->txbatch, &rtp->iostats);
+	rtp->lastts += rtp->send_duration;
+	rtp->sending_digit = 0;
+	rtp->send_digit = 0;
 
-#if 0	/* Allow to receive RTP stream with closed transmission path */
-	/* If we don't have the other side's address, then ignore this */
-	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
-		return &tris_null_frame;
-#endif
+	return res;
+}
 
-	/* Send to whoever send to us if NAT is turned on */
-	if (rtp->nat) {
-		if (((rtp->them.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (rtp->them.sin_port != sock_in.sin_port)) && 
-		    ((rtp->altthem.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-		    (rtp->altthem.sin_port != sock_in.sin_port))) {
-			rtp->them = sock_in;
-			if (rtp->rtcp) {
-				int h = 0;
-				memcpy(&rtp->rtcp->them, &sock_in, sizeof(rtp->rtcp->them));
-				h = ntohs(rtp->them.sin_port);
-				rtp->rtcp->them.sin_port = htons(h + 1);
-			}
-			rtp->rxseqno = 0;
-			tris_set_flag(rtp, FLAG_NAT_ACTIVE);
-			if (option_debug || rtpdebug)
-				tris_debug(0, "RTP NAT: Got audio from other end. Now sending to address %s:%d\n", tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port));
-		}
-	}
+/*! \brief Public function: Send an H.261 fast update request, some devices need this rather than SIP XML */
+int tris_rtcp_send_h261fur(void *data)
+{
+	struct tris_rtp *rtp = data;
+	int res;
 
-	/* If we are bridged to another RTP stream, send direct */
-	if ((bridged = tris_rtp_get_bridged(rtp)) && !bridge_p2p_rtp_write(rtp, bridged, rtpheader, res, hdrlen))
-		return &tris_null_frame;
+	rtp->rtcp->sendfur = 1;
+	res = tris_rtcp_write(data);
+	
+	return res;
+}
 
-	if (version != 2)
-		return &tris_null_frame;
+/*! \brief Send RTCP sender's report */
+static int tris_rtcp_write_sr(const void *data)
+{
+	struct tris_rtp *rtp = (struct tris_rtp *)data;
+	int res;
+	int len = 0;
+	struct timeval now;
+	unsigned int now_lsw;
+	unsigned int now_msw;
+	unsigned int *rtcpheader;
+	unsigned int lost;
+	unsigned int extended;
+	unsigned int expected;
+	unsigned int expected_interval;
+	unsigned int received_interval;
+	int lost_interval;
+	int fraction;
+	struct timeval dlsr;
+	char bdata[512];
 
-	payloadtype = (seqno & 0x7f0000) >> 16;
-	padding = seqno & (1 << 29);
-	mark = seqno & (1 << 23);
-	ext = seqno & (1 << 28);
-	cc = (seqno & 0xF000000) >> 24;
-	seqno &= 0xffff;
-	timestamp = ntohl(rtpheader[1]);
-	ssrc = ntohl(rtpheader[2]);
+	/* Commented condition is always not NULL if rtp->rtcp is not NULL */
+	if (!rtp || !rtp->rtcp/* || (&rtp->rtcp->them.sin_addr == 0)*/)
+		return 0;
 	
-	if (!mark && rtp->rxssrc && rtp->rxssrc != ssrc) {
-		if (option_debug || rtpdebug)
-			tris_debug(0, "Forcing Marker bit, because SSRC has changed\n");
-		mark = 1;
+	if (!rtp->rtcp->them.sin_addr.s_addr) {  /* This'll stop rtcp for this rtp session */
+		tris_verbose("RTCP SR transmission error, rtcp halted\n");
+		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
+		return 0;
 	}
 
-	rtp->rxssrc = ssrc;
+	gettimeofday(&now, NULL);
+	timeval2ntp(now, &now_msw, &now_lsw); /* fill thses ones in from utils.c*/
+	rtcpheader = (unsigned int *)bdata;
+	rtcpheader[1] = htonl(rtp->ssrc);               /* Our SSRC */
+	rtcpheader[2] = htonl(now_msw);                 /* now, MSW. gettimeofday() + SEC_BETWEEN_1900_AND_1970*/
+	rtcpheader[3] = htonl(now_lsw);                 /* now, LSW */
+	rtcpheader[4] = htonl(rtp->lastts);             /* FIXME shouldn't be that, it should be now */
+	rtcpheader[5] = htonl(rtp->txcount);            /* No. packets sent */
+	rtcpheader[6] = htonl(rtp->txoctetcount);       /* No. bytes sent */
+	len += 28;
+	
+	extended = rtp->cycles + rtp->lastrxseqno;
+	expected = extended - rtp->seedrxseqno + 1;
+	if (rtp->rxcount > expected) 
+		expected += rtp->rxcount - expected;
+	lost = expected - rtp->rxcount;
+	expected_interval = expected - rtp->rtcp->expected_prior;
+	rtp->rtcp->expected_prior = expected;
+	received_interval = rtp->rxcount - rtp->rtcp->received_prior;
+	rtp->rtcp->received_prior = rtp->rxcount;
+	lost_interval = expected_interval - received_interval;
+	if (expected_interval == 0 || lost_interval <= 0)
+		fraction = 0;
+	else
+		fraction = (lost_interval << 8) / expected_interval;
+	timersub(&now, &rtp->rtcp->rxlsr, &dlsr);
+	rtcpheader[7] = htonl(rtp->themssrc);
+	rtcpheader[8] = htonl(((fraction & 0xff) << 24) | (lost & 0xffffff));
+	rtcpheader[9] = htonl((rtp->cycles) | ((rtp->lastrxseqno & 0xffff)));
+	rtcpheader[10] = htonl((unsigned int)(rtp->rxjitter * 65536.));
+	rtcpheader[11] = htonl(rtp->rtcp->themrxlsr);
+	rtcpheader[12] = htonl((((dlsr.tv_sec * 1000) + (dlsr.tv_usec / 1000)) * 65536) / 1000);
+	len += 24;
+	
+	rtcpheader[0] = htonl((2 << 30) | (1 << 24) | (RTCP_PT_SR << 16) | ((len/4)-1));
+
+	if (rtp->rtcp->sendfur) {
+		rtcpheader[13] = htonl((2 << 30) | (0 << 24) | (RTCP_PT_FUR << 16) | 1);
+		rtcpheader[14] = htonl(rtp->ssrc);               /* Our SSRC */
+		len += 8;
+		rtp->rtcp->sendfur = 0;
+	}
 	
-	if (padding) {
-		/* Remove padding bytes */
-		res -= rtp->rawdata[TRIS_FRIENDLY_OFFSET + res - 1];
+	/* Insert SDES here. Probably should make SDES text equal to mimetypes[code].type (not subtype 'cos */ 
+	/* it can change mid call, and SDES can't) */
+	rtcpheader[len/4]     = htonl((2 << 30) | (1 << 24) | (RTCP_PT_SDES << 16) | 2);
+	rtcpheader[(len/4)+1] = htonl(rtp->ssrc);               /* Our SSRC */
+	rtcpheader[(len/4)+2] = htonl(0x01 << 24);                    /* Empty for the moment */
+	len += 12;
+	
+	res = tris_udp_batch_sendto(NULL, rtp->rtcp->s, rtcpheader, len, &rtp->rtcp->them, &rtp->rtcp->iostats);
+	if (res < 0) {
+		tris_log(LOG_ERROR, "RTCP SR transmission error to %s:%d, rtcp halted %s\n",tris_inet_ntoa(rtp->rtcp->them.sin_addr), ntohs(rtp->rtcp->them.sin_port), strerror(errno));
+		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
+		return 0;
 	}
 	
-	if (cc) {
-		/* CSRC fields present */
-		hdrlen += cc*4;
+	/* FIXME Don't need to get a new one */
+	gettimeofday(&rtp->rtcp->txlsr, NULL);
+	rtp->rtcp->sr_count++;
+
+	rtp->rtcp->lastsrtxcount = rtp->txcount;	
+	
+	if (rtcp_debug_test_addr(&rtp->rtcp->them)) {
+		tris_verbose("* Sent RTCP SR to %s:%d\n", tris_inet_ntoa(rtp->rtcp->them.sin_addr), ntohs(rtp->rtcp->them.sin_port));
+		tris_verbose("  Our SSRC: %u\n", rtp->ssrc);
+		tris_verbose("  Sent(NTP): %u.%010u\n", (unsigned int)now.tv_sec, (unsigned int)now.tv_usec*4096);
+		tris_verbose("  Sent(RTP): %u\n", rtp->lastts);
+		tris_verbose("  Sent packets: %u\n", rtp->txcount);
+		tris_verbose("  Sent octets: %u\n", rtp->txoctetcount);
+		tris_verbose("  Report block:\n");
+		tris_verbose("  Fraction lost: %u\n", fraction);
+		tris_verbose("  Cumulative loss: %u\n", lost);
+		tris_verbose("  IA jitter: %.4f\n", rtp->rxjitter);
+		tris_verbose("  Their last SR: %u\n", rtp->rtcp->themrxlsr);
+		tris_verbose("  DLSR: %4.4f (sec)\n\n", (double)(ntohl(rtcpheader[12])/65536.0));
 	}
+	/*manager_event(EVENT_FLAG_REPORTING, "RTCPSent", "To: %s:%d\r\n"
+					    "OurSSRC: %u\r\n"
+					    "SentNTP: %u.%010u\r\n"
+					    "SentRTP: %u\r\n"
+					    "SentPackets: %u\r\n"
+					    "SentOctets: %u\r\n"
+					    "ReportBlock:\r\n"
+					    "FractionLost: %u\r\n"
+					    "CumulativeLoss: %u\r\n"
+					    "IAJitter: %.4f\r\n"
+					    "TheirLastSR: %u\r\n"
+					    "DLSR: %4.4f (sec)\r\n",
+					    tris_inet_ntoa(rtp->rtcp->them.sin_addr), ntohs(rtp->rtcp->them.sin_port),
+					    rtp->ssrc,
+					    (unsigned int)now.tv_sec, (unsigned int)now.tv_usec*4096,
+					    rtp->lastts,
+					    rtp->txcount,
+					    rtp->txoctetcount,
+					    fraction,
+					    lost,
+					    rtp->rxjitter,
+					    rtp->rtcp->themrxlsr,
+					    (double)(ntohl(rtcpheader[12])/65536.0));
+	*/
+	return res;
+}
 
-	if (ext) {
-		/* RTP Extension present */
-		hdrlen += (ntohl(rtpheader[hdrlen/4]) & 0xffff) << 2;
-		hdrlen += 4;
-		if (option_debug) {
-			int profile;
-			profile = (ntohl(rtpheader[3]) & 0xffff0000) >> 16;
-			if (profile == 0x505a)
-				tris_debug(1, "Found Zfone extension in RTP stream - zrtp - not supported.\n");
-			else
-				tris_debug(1, "Found unknown RTP Extensions %x\n", profile);
-		}
+/*! \brief Send RTCP recipient's report */
+static int tris_rtcp_write_rr(const void *data)
+{
+	struct tris_rtp *rtp = (struct tris_rtp *)data;
+	int res;
+	int len = 32;
+	unsigned int lost;
+	unsigned int extended;
+	unsigned int expected;
+	unsigned int expected_interval;
+	unsigned int received_interval;
+	int lost_interval;
+	struct timeval now;
+	unsigned int *rtcpheader;
+	char bdata[1024];
+	struct timeval dlsr;
+	int fraction;
+
+	double rxlost_current;
+	
+	if (!rtp || !rtp->rtcp || (&rtp->rtcp->them.sin_addr == 0))
+		return 0;
+	  
+	if (!rtp->rtcp->them.sin_addr.s_addr) {
+		tris_log(LOG_ERROR, "RTCP RR transmission error, rtcp halted\n");
+		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
+		return 0;
 	}
 
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short (%d, expecting %d)\n", res, hdrlen);
-		return &tris_null_frame;
-	}
+	extended = rtp->cycles + rtp->lastrxseqno;
+	expected = extended - rtp->seedrxseqno + 1;
+	lost = expected - rtp->rxcount;
+	expected_interval = expected - rtp->rtcp->expected_prior;
+	rtp->rtcp->expected_prior = expected;
+	received_interval = rtp->rxcount - rtp->rtcp->received_prior;
+	rtp->rtcp->received_prior = rtp->rxcount;
+	lost_interval = expected_interval - received_interval;
 
-	rtp->rxcount++; /* Only count reasonably valid packets, this'll make the rtcp stats more accurate */
+	if (lost_interval <= 0)
+		rtp->rtcp->rxlost = 0;
+	else rtp->rtcp->rxlost = rtp->rtcp->rxlost;
+	if (rtp->rtcp->rxlost_count == 0)
+		rtp->rtcp->minrxlost = rtp->rtcp->rxlost;
+	if (lost_interval < rtp->rtcp->minrxlost) 
+		rtp->rtcp->minrxlost = rtp->rtcp->rxlost;
+	if (lost_interval > rtp->rtcp->maxrxlost) 
+		rtp->rtcp->maxrxlost = rtp->rtcp->rxlost;
 
-	if (rtp->rxcount==1) {
-		/* This is the first RTP packet successfully received from source */
-		rtp->seedrxseqno = seqno;
-	}
+	rxlost_current = normdev_compute(rtp->rtcp->normdev_rxlost, rtp->rtcp->rxlost, rtp->rtcp->rxlost_count);
+	rtp->rtcp->stdev_rxlost = stddev_compute(rtp->rtcp->stdev_rxlost, rtp->rtcp->rxlost, rtp->rtcp->normdev_rxlost, rxlost_current, rtp->rtcp->rxlost_count);
+	rtp->rtcp->normdev_rxlost = rxlost_current;
+	rtp->rtcp->rxlost_count++;
 
-	/* Do not schedule RR if RTCP isn't run */
-	if (rtp->rtcp && rtp->rtcp->them.sin_addr.s_addr && rtp->rtcp->schedid < 1) {
-		/* Schedule transmission of Receiver Report */
-		rtp->rtcp->schedid = tris_sched_add(rtp->sched, tris_rtcp_calc_interval(rtp), tris_rtcp_write, rtp);
+	if (expected_interval == 0 || lost_interval <= 0)
+		fraction = 0;
+	else
+		fraction = (lost_interval << 8) / expected_interval;
+	gettimeofday(&now, NULL);
+	timersub(&now, &rtp->rtcp->rxlsr, &dlsr);
+	rtcpheader = (unsigned int *)bdata;
+	rtcpheader[0] = htonl((2 << 30) | (1 << 24) | (RTCP_PT_RR << 16) | ((len/4)-1));
+	rtcpheader[1] = htonl(rtp->ssrc);
+	rtcpheader[2] = htonl(rtp->themssrc);
+	rtcpheader[3] = htonl(((fraction & 0xff) << 24) | (lost & 0xffffff));
+	rtcpheader[4] = htonl((rtp->cycles) | ((rtp->lastrxseqno & 0xffff)));
+	rtcpheader[5] = htonl((unsigned int)(rtp->rxjitter * 65536.));
+	rtcpheader[6] = htonl(rtp->rtcp->themrxlsr);
+	rtcpheader[7] = htonl((((dlsr.tv_sec * 1000) + (dlsr.tv_usec / 1000)) * 65536) / 1000);
+
+	if (rtp->rtcp->sendfur) {
+		rtcpheader[8] = htonl((2 << 30) | (0 << 24) | (RTCP_PT_FUR << 16) | 1); /* Header from page 36 in RFC 3550 */
+		rtcpheader[9] = htonl(rtp->ssrc);               /* Our SSRC */
+		len += 8;
+		rtp->rtcp->sendfur = 0;
 	}
-	if ((int)rtp->lastrxseqno - (int)seqno  > 100) /* if so it would indicate that the sender cycled; allow for misordering */
-		rtp->cycles += RTP_SEQ_MOD;
-	
-	prev_seqno = rtp->lastrxseqno;
 
-	rtp->lastrxseqno = seqno;
-	
-	if (!rtp->themssrc)
-		rtp->themssrc = ntohl(rtpheader[2]); /* Record their SSRC to put in future RR */
+	/*! \note Insert SDES here. Probably should make SDES text equal to mimetypes[code].type (not subtype 'cos 
+	it can change mid call, and SDES can't) */
+	rtcpheader[len/4]     = htonl((2 << 30) | (1 << 24) | (RTCP_PT_SDES << 16) | 2);
+	rtcpheader[(len/4)+1] = htonl(rtp->ssrc);               /* Our SSRC */
+	rtcpheader[(len/4)+2] = htonl(0x01 << 24);              /* Empty for the moment */
+	len += 12;
 	
-	if (rtp_debug_test_addr(&sock_in))
-		tris_verbose("Got  RTP packet from    %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-			tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp,res - hdrlen);
-
-	rtpPT = tris_rtp_lookup_pt(rtp, payloadtype);
-	if (!rtpPT.isAstFormat) {
-		struct tris_frame *f = NULL;
+	res = tris_udp_batch_sendto(NULL, rtp->rtcp->s, rtcpheader, len, &rtp->rtcp->them, &rtp->rtcp->iostats);
 
-		/* This is special in-band data that's not one of our codecs */
-		if (rtpPT.code == TRIS_RTP_DTMF) {
-			/* It's special -- rfc2833 process it */
-			if (rtp_debug_test_addr(&sock_in)) {
-				unsigned char *data;
-				unsigned int event;
-				unsigned int event_end;
-				unsigned int duration;
-				data = rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen;
-				event = ntohl(*((unsigned int *)(data)));
-				event >>= 24;
-				event_end = ntohl(*((unsigned int *)(data)));
-				event_end <<= 8;
-				event_end >>= 24;
-				duration = ntohl(*((unsigned int *)(data)));
-				duration &= 0xFFFF;
-				tris_verbose("Got  RTP RFC2833 from   %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u, mark %d, event %08x, end %d, duration %-5.5d) \n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp, res - hdrlen, (mark?1:0), event, ((event_end & 0x80)?1:0), duration);
-			}
-			f = process_rfc2833(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen, seqno, timestamp);
-		} else if (rtpPT.code == TRIS_RTP_CISCO_DTMF) {
-			/* It's really special -- process it the Cisco way */
-			if (rtp->lastevent <= seqno || (rtp->lastevent >= 65530 && seqno <= 6)) {
-				f = process_cisco_dtmf(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-				rtp->lastevent = seqno;
-			}
-		} else if (rtpPT.code == TRIS_RTP_CN) {
-			/* Comfort Noise */
-			f = process_rfc3389(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-		} else {
-			tris_log(LOG_NOTICE, "Unknown RTP codec %d received from '%s'\n", payloadtype, tris_inet_ntoa(rtp->them.sin_addr));
-		}
-		return f ? f : &tris_null_frame;
+	if (res < 0) {
+		tris_log(LOG_ERROR, "RTCP RR transmission error, rtcp halted: %s\n",strerror(errno));
+		/* Remove the scheduler */
+		TRIS_SCHED_DEL(rtp->sched, rtp->rtcp->schedid);
+		return 0;
 	}
-	rtp->lastrxformat = rtp->f.subclass = rtpPT.code;
-	rtp->f.frametype = (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) ? TRIS_FRAME_VOICE : (rtp->f.subclass & TRIS_FORMAT_VIDEO_MASK) ? TRIS_FRAME_VIDEO : TRIS_FRAME_TEXT;
 
-	rtp->rxseqno = seqno;
-
-	if (rtp->dtmf_timeout && rtp->dtmf_timeout < timestamp) {
-		rtp->dtmf_timeout = 0;
+	rtp->rtcp->rr_count++;
 
-		if (rtp->resp) {
-			struct tris_frame *f;
-			f = send_dtmf(rtp, TRIS_FRAME_DTMF_END);
-			f->len = tris_tvdiff_ms(tris_samp2tv(rtp->dtmf_duration, rtp_get_rate(f->subclass)), tris_tv(0, 0));
-			rtp->resp = 0;
-			rtp->dtmf_timeout = rtp->dtmf_duration = 0;
-			return f;
-		}
+	if (rtcp_debug_test_addr(&rtp->rtcp->them)) {
+		tris_verbose("\n* Sending RTCP RR to %s:%d\n"
+			"  Our SSRC: %u\nTheir SSRC: %u\niFraction lost: %d\nCumulative loss: %u\n" 
+			"  IA jitter: %.4f\n" 
+			"  Their last SR: %u\n" 
+			"  DLSR: %4.4f (sec)\n\n",
+			tris_inet_ntoa(rtp->rtcp->them.sin_addr),
+			ntohs(rtp->rtcp->them.sin_port),
+			rtp->ssrc, rtp->themssrc, fraction, lost,
+			rtp->rxjitter,
+			rtp->rtcp->themrxlsr,
+			(double)(ntohl(rtcpheader[7])/65536.0));
 	}
 
-	/* Record received timestamp as last received now */
-	rtp->lastrxts = timestamp;
-
-	rtp->f.mallocd = 0;
-	rtp->f.datalen = res - hdrlen;
-	rtp->f.data.ptr = rtp->rawdata + hdrlen + TRIS_FRIENDLY_OFFSET;
-	rtp->f.offset = hdrlen + TRIS_FRIENDLY_OFFSET;
-	rtp->f.seqno = seqno;
-
-	if (rtp->f.subclass == TRIS_FORMAT_T140 && (int)seqno - (prev_seqno+1) > 0 && (int)seqno - (prev_seqno+1) < 10) {
-		  unsigned char *data = rtp->f.data.ptr;
-		  
-		  memmove(rtp->f.data.ptr+3, rtp->f.data.ptr, rtp->f.datalen);
-		  rtp->f.datalen +=3;
-		  *data++ = 0xEF;
-		  *data++ = 0xBF;
-		  *data = 0xBD;
-	}
- 
-	if (rtp->f.subclass == TRIS_FORMAT_T140RED) {
-		unsigned char *data = rtp->f.data.ptr;
-		unsigned char *header_end;
-		int num_generations;
-		int header_length;
-		int length;
-		int diff =(int)seqno - (prev_seqno+1); /* if diff = 0, no drop*/
-		int x;
+	return res;
+}
 
-		rtp->f.subclass = TRIS_FORMAT_T140;
-		header_end = memchr(data, ((*data) & 0x7f), rtp->f.datalen);
-		if (header_end == NULL) {
-			return &tris_null_frame;
-		}
-		header_end++;
-		
-		header_length = header_end - data;
-		num_generations = header_length / 4;
-		length = header_length;
+/*! \brief Write and RTCP packet to the far end
+ * \note Decide if we are going to send an SR (with Reception Block) or RR 
+ * RR is sent if we have not sent any rtp packets in the previous interval */
+static int tris_rtcp_write(const void *data)
+{
+	struct tris_rtp *rtp = (struct tris_rtp *)data;
+	int res;
+	
+	if (!rtp || !rtp->rtcp)
+		return 0;
 
-		if (!diff) {
-			for (x = 0; x < num_generations; x++)
-				length += data[x * 4 + 3];
-			
-			if (!(rtp->f.datalen - length))
-				return &tris_null_frame;
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-		} else if (diff > num_generations && diff < 10) {
-			length -= 3;
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-			
-			data = rtp->f.data.ptr;
-			*data++ = 0xEF;
-			*data++ = 0xBF;
-			*data = 0xBD;
-		} else 	{
-			for ( x = 0; x < num_generations - diff; x++) 
-				length += data[x * 4 + 3];
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-		}
-	}
+	if (rtp->txcount > rtp->rtcp->lastsrtxcount)
+		res = tris_rtcp_write_sr(data);
+	else
+		res = tris_rtcp_write_rr(data);
+	
+	return res;
+}
 
-	if (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) {
-		rtp->f.samples = tris_codec_get_samples(&rtp->f);
-		if (rtp->f.subclass == TRIS_FORMAT_SLINEAR) 
-			tris_frame_byteswap_be(&rtp->f);
-		calc_rxstamp(&rtp->f.delivery, rtp, timestamp, mark);
-		/* Add timing data to let tris_generic_bridge() put the frame into a jitterbuf */
-		tris_set_flag(&rtp->f, TRIS_FRFLAG_HAS_TIMING_INFO);
-		rtp->f.ts = timestamp / (rtp_get_rate(rtp->f.subclass) / 1000);
-		rtp->f.len = rtp->f.samples / ((tris_format_rate(rtp->f.subclass) / 1000));
-	} else if (rtp->f.subclass & TRIS_FORMAT_VIDEO_MASK) {
-		/* Video -- samples is # of samples vs. 90000 */
-		if (!rtp->lastividtimestamp)
-			rtp->lastividtimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastividtimestamp;
-		rtp->lastividtimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
-		/* Pass the RTP marker bit as bit 0 in the subclass field.
-		 * This is ok because subclass is actually a bitmask, and
-		 * the low bits represent audio formats, that are not
-		 * involved here since we deal with video.
-		 */
-		if (mark)
-			rtp->f.subclass |= 0x1;
-	} else {
-		/* TEXT -- samples is # of samples vs. 1000 */
-		if (!rtp->lastitexttimestamp)
-			rtp->lastitexttimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastitexttimestamp;
-		rtp->lastitexttimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
+/*! \brief generate comfort noice (CNG) */
+int tris_rtp_sendcng(struct tris_rtp *rtp, int level)
+{
+	unsigned int *rtpheader;
+	int hdrlen = 12;
+	int res;
+	int payload;
+	char data[256];
+	level = 127 - (level & 0x7f);
+	payload = tris_rtp_lookup_code(rtp, 0, TRIS_RTP_CN);
+
+	/* If we have no peer, return immediately */	
+	if (!rtp->them.sin_addr.s_addr)
+		return 0;
+
+	rtp->dtmfmute = tris_tvadd(tris_tvnow(), tris_tv(0, 500000));
+
+	/* Get a pointer to the header */
+	rtpheader = (unsigned int *)data;
+	rtpheader[0] = htonl((2 << 30) | (1 << 23) | (payload << 16) | (rtp->seqno++));
+	rtpheader[1] = htonl(rtp->lastts);
+	rtpheader[2] = htonl(rtp->ssrc); 
+	data[12] = level;
+	if (rtp->them.sin_port && rtp->them.sin_addr.s_addr) {
+		res = sendto(rtp->s, (void *)rtpheader, hdrlen + 1, 0, (struct sockaddr *)&rtp->them, sizeof(rtp->them));
+		if (res <0) 
+			tris_log(LOG_ERROR, "RTP Comfort Noise Transmission error to %s:%d: %s\n", tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), strerror(errno));
+		if (rtp_debug_test_addr(&rtp->them))
+			tris_verbose("Sent Comfort Noise RTP packet to %s:%u (type %d, seq %u, ts %u, len %d)\n"
+					, tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), payload, rtp->seqno, rtp->lastts,res - hdrlen);		   
+		   
 	}
-	rtp->f.src = "RTP";
-	return &rtp->f;
+	return 0;
 }
 
 /*! \brief Write RTP packet with audio or video media frames into UDP packet */
-int rakwon_mixed_audio_raw_write(struct tris_rtp* rtp, int fd, struct tris_frame *f, int codec)
+static int tris_rtp_raw_write(struct tris_rtp *rtp, struct tris_frame *f, int codec)
 {
 	unsigned char *rtpheader;
 	int hdrlen = 12;
@@ -5463,6 +3815,8 @@ int rakwon_mixed_audio_raw_write(struct tris_rtp* rtp, int fd, struct tris_frame
 
 	if (f->subclass == TRIS_FORMAT_G722) {
 		f->samples /= 2;
+	} else if (f->subclass == TRIS_FORMAT_OPUS) {
+		f->samples *= 3;
 	}
 
 	if (rtp->sending_digit) {
@@ -5483,531 +3837,338 @@ int rakwon_mixed_audio_raw_write(struct tris_rtp* rtp, int fd, struct tris_frame
 				rtp->lastts = pred;
 			else {
 				tris_debug(3, "Difference is %d, ms is %d\n", abs(rtp->lastts - pred), ms);
-				mark = 1;
-			}
-		}
-	} else if (f->frametype == TRIS_FRAME_VIDEO) {
-		mark = f->subclass & 0x1;
-		pred = rtp->lastovidtimestamp + f->samples;
-		/* Re-calculate last TS */
-		rtp->lastts = rtp->lastts + ms * 90;
-		/* If it's close to our prediction, go for it */
-		if (tris_tvzero(f->delivery)) {
-			if (abs(rtp->lastts - pred) < 7200) {
-				rtp->lastts = pred;
-				rtp->lastovidtimestamp += f->samples;
-			} else {
-				tris_debug(3, "Difference is %d, ms is %d (%d), pred/ts/samples %d/%d/%d\n", abs(rtp->lastts - pred), ms, ms * 90, rtp->lastts, pred, f->samples);
-				rtp->lastovidtimestamp = rtp->lastts;
-			}
-		}
-	} else {
-		pred = rtp->lastotexttimestamp + f->samples;
-		/* Re-calculate last TS */
-		rtp->lastts = rtp->lastts + ms;
-		/* If it's close to our prediction, go for it */
-		if (tris_tvzero(f->delivery)) {
-			if (abs(rtp->lastts - pred) < 7200) {
-				rtp->lastts = pred;
-				rtp->lastotexttimestamp += f->samples;
-			} else {
-				tris_debug(3, "Difference is %d, ms is %d, pred/ts/samples %d/%d/%d\n", abs(rtp->lastts - pred), ms, rtp->lastts, pred, f->samples);
-				rtp->lastotexttimestamp = rtp->lastts;
-			}
-		}
-	}
-
-	/* If we have been explicitly told to set the marker bit do so */
-	if (rtp->set_marker_bit) {
-		mark = 1;
-		rtp->set_marker_bit = 0;
-	}
-
-	/* If the timestamp for non-digit packets has moved beyond the timestamp
-	   for digits, update the digit timestamp.
-	*/
-	if (rtp->lastts > rtp->lastdigitts)
-		rtp->lastdigitts = rtp->lastts;
-
-	if (tris_test_flag(f, TRIS_FRFLAG_HAS_TIMING_INFO))
-		rtp->lastts = f->ts * rate;
-
-	/* Get a pointer to the header */
-	rtpheader = (unsigned char *)(f->data.ptr - hdrlen);
-
-	put_unaligned_uint32(rtpheader, htonl((2 << 30) | (codec << 16) | (rtp->seqno) | (mark << 23)));
-	put_unaligned_uint32(rtpheader + 4, htonl(rtp->lastts));
-	put_unaligned_uint32(rtpheader + 8, htonl(rtp->ssrc)); 
-
-	if (rtp->them.sin_port && rtp->them.sin_addr.s_addr) {
-		res = write(fd, (void *)rtpheader, f->datalen + hdrlen);
-		if (res < 0) {
-			if (!rtp->nat || (rtp->nat && (tris_test_flag(rtp, FLAG_NAT_ACTIVE) == FLAG_NAT_ACTIVE))) {
-				tris_debug(1, "RTP Transmission error of packet %d to %s:%d: %s\n", rtp->seqno, tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), strerror(errno));
-			} else if (((tris_test_flag(rtp, FLAG_NAT_ACTIVE) == FLAG_NAT_INACTIVE) || rtpdebug) && !tris_test_flag(rtp, FLAG_NAT_INACTIVE_NOWARN)) {
-				/* Only give this error message once if we are not RTP debugging */
-				if (option_debug || rtpdebug)
-					tris_debug(0, "RTP NAT: Can't write RTP to private address %s:%d, waiting for other end to send audio...\n", tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port));
-				tris_set_flag(rtp, FLAG_NAT_INACTIVE_NOWARN);
-			}
-		} else {
-			rtp->txcount++;
-			rtp->txoctetcount +=(res - hdrlen);
-			
-			/* Do not schedule RR if RTCP isn't run */
-			if (rtp->rtcp && rtp->rtcp->them.sin_addr.s_addr && rtp->rtcp->schedid < 1) {
-				rtp->rtcp->schedid = tris_sched_add(rtp->sched, tris_rtcp_calc_interval(rtp), tris_rtcp_write, rtp);
-			}
-		}
-				
-		if (rtp_debug_test_addr(&rtp->them))
-			tris_verbose("Sent RTP packet to      %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-					tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), codec, rtp->seqno, rtp->lastts,res - hdrlen);
-	}
-
-	rtp->seqno++;
-
-	return 0;
-}
-
-int rakwon_mixed_audio_write(struct tris_rtp *rtp, int fd, struct tris_frame *_f)
-{
-	struct tris_frame *f;
-	int codec;
-	int hdrlen = 12;
-	int subclass;
-	
-
-	/* If we have no peer, return immediately */	
-	if (!rtp->them.sin_addr.s_addr)
-		return 0;
-
-	/* If there is no data length, return immediately */
-	if (!_f->datalen && !rtp->red)
-		return 0;
-	
-	/* Make sure we have enough space for RTP header */
-	if ((_f->frametype != TRIS_FRAME_VOICE) && (_f->frametype != TRIS_FRAME_VIDEO) && (_f->frametype != TRIS_FRAME_TEXT)) {
-		tris_log(LOG_WARNING, "RTP can only send voice, video and text\n");
-		return -1;
-	}
-
-	if (rtp->red) {
-		/* return 0; */
-		/* no primary data or generations to send */
-		if ((_f = red_t140_to_red(rtp->red)) == NULL) 
-			return 0;
-	}
-
-	/* The bottom bit of a video subclass contains the marker bit */
-	subclass = _f->subclass;
-	if (_f->frametype == TRIS_FRAME_VIDEO)
-		subclass &= ~0x1;
-
-	codec = tris_rtp_lookup_code(rtp, 1, subclass);
-	if (codec < 0) {
-		tris_log(LOG_WARNING, "Don't know how to send format %s packets with RTP\n", tris_getformatname(_f->subclass));
-		return -1;
-	}
-
-	if (rtp->lasttxformat != subclass) {
-		/* New format, reset the smoother */
-		tris_debug(1, "Ooh, format changed from %s to %s\n", tris_getformatname(rtp->lasttxformat), tris_getformatname(subclass));
-		rtp->lasttxformat = subclass;
-		if (rtp->smoother)
-			tris_smoother_free(rtp->smoother);
-		rtp->smoother = NULL;
-	}
-
-#if 0
-	if (!rtp->smoother) {
-		struct tris_format_list fmt = tris_codec_pref_getsize(&rtp->pref, subclass);
-
-		switch (subclass) {
-		case TRIS_FORMAT_SPEEX:
-		case TRIS_FORMAT_G723_1:
-		case TRIS_FORMAT_SIREN7:
-		case TRIS_FORMAT_SIREN14:
-			/* these are all frame-based codecs and cannot be safely run through
-			   a smoother */
-			break;
-		default:
-			if (fmt.inc_ms) { /* if codec parameters is set / avoid division by zero */
-				if (!(rtp->smoother = tris_smoother_new((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms))) {
-					tris_log(LOG_WARNING, "Unable to create smoother: format: %d ms: %d len: %d\n", subclass, fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
-					return -1;
-				}
-				if (fmt.flags)
-					tris_smoother_set_flags(rtp->smoother, fmt.flags);
-				tris_debug(1, "Created smoother: format: %d ms: %d len: %d\n", subclass, fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
-			}
-		}
-	}
-	if (rtp->smoother) {
-		if (tris_smoother_test_flag(rtp->smoother, TRIS_SMOOTHER_FLAG_BE)) {
-			tris_smoother_feed_be(rtp->smoother, _f);
-		} else {
-			tris_smoother_feed(rtp->smoother, _f);
-		}
-
-		while ((f = tris_smoother_read(rtp->smoother)) && (f->data.ptr)) {
-			tris_rtp_raw_write(rtp, f, codec);
-		}
-	} else {
-#endif
-		/* Don't buffer outgoing frames; send them one-per-packet: */
-		if (_f->offset < hdrlen) 
-			f = tris_frdup(_f);	/*! \bug XXX this might never be free'd. Why do we do this? */
-		else
-			f = _f;
-		if (f->data.ptr)
-			rakwon_mixed_audio_raw_write(rtp, fd, f, codec);
-		if (f != _f)
-			tris_frfree(f);
-//	}
-		
-	return 0;
-}
-	
-struct tris_frame *rakwon_video_read(struct tris_rtp *rtp)
-{
-	int res;
-	struct sockaddr_in sock_in;
-	socklen_t len;
-	unsigned int seqno;
-	int version;
-	int payloadtype;
-	int hdrlen = 12;
-	int padding;
-	int mark;
-	int ext;
-	int cc;
-	unsigned int ssrc;
-	unsigned int timestamp;
-	unsigned int *rtpheader;
-	struct rtpPayloadType rtpPT;
-	struct tris_rtp *bridged = NULL;
-	int prev_seqno;
-	
-	/* If time is up, kill it */
-	if (rtp->sending_digit)
-		tris_rtp_senddigit_continuation(rtp);
-
-	len = sizeof(sock_in);
-	
-	/* Cache where the header will go */
-	res = recvfrom(rtp->s, rtp->rawdata + TRIS_FRIENDLY_OFFSET, sizeof(rtp->rawdata) - TRIS_FRIENDLY_OFFSET,
-					0, (struct sockaddr *)&sock_in, &len);
-
-	/* If strict RTP protection is enabled see if we need to learn this address or if the packet should be dropped */
-	if (rtp->strict_rtp_state == STRICT_RTP_LEARN) {
-		/* Copy over address that this packet was received on */
-		memcpy(&rtp->strict_rtp_address, &sock_in, sizeof(rtp->strict_rtp_address));
-		/* Now move over to actually protecting the RTP port */
-		rtp->strict_rtp_state = STRICT_RTP_CLOSED;
-		tris_debug(1, "Learned remote address is %s:%d for strict RTP purposes, now protecting the port.\n", tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-	} else if (rtp->strict_rtp_state == STRICT_RTP_CLOSED) {
-		/* If the address we previously learned doesn't match the address this packet came in on simply drop it */
-		if ((rtp->strict_rtp_address.sin_addr.s_addr != sock_in.sin_addr.s_addr) || (rtp->strict_rtp_address.sin_port != sock_in.sin_port)) {
-			tris_debug(1, "Received RTP packet from %s:%d, dropping due to strict RTP protection. Expected it to be from %s:%d\n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), tris_inet_ntoa(rtp->strict_rtp_address.sin_addr), ntohs(rtp->strict_rtp_address.sin_port));
-			return &tris_null_frame;
+				mark = 1;
+			}
 		}
-	}
-
-	rtpheader = (unsigned int *)(rtp->rawdata + TRIS_FRIENDLY_OFFSET);
-	if (res < 0) {
-		tris_assert(errno != EBADF);
-		if (errno != EAGAIN) {
-			tris_log(LOG_WARNING, "RTP Read error: %s.	Hanging up.\n", strerror(errno));
-			return NULL;
+	} else if (f->frametype == TRIS_FRAME_VIDEO) {
+		mark = f->subclass & 0x1;
+		pred = rtp->lastovidtimestamp + f->samples;
+		/* Re-calculate last TS */
+		rtp->lastts = rtp->lastts + ms * 90;
+		/* If it's close to our prediction, go for it */
+		if (tris_tvzero(f->delivery)) {
+			if (abs(rtp->lastts - pred) < 7200) {
+				rtp->lastts = pred;
+				rtp->lastovidtimestamp += f->samples;
+			} else {
+				tris_debug(3, "Difference is %d, ms is %d (%d), pred/ts/samples %d/%d/%d\n", abs(rtp->lastts - pred), ms, ms * 90, rtp->lastts, pred, f->samples);
+				rtp->lastovidtimestamp = rtp->lastts;
+			}
+		}
+	} else {
+		pred = rtp->lastotexttimestamp + f->samples;
+		/* Re-calculate last TS */
+		rtp->lastts = rtp->lastts + ms;
+		/* If it's close to our prediction, go for it */
+		if (tris_tvzero(f->delivery)) {
+			if (abs(rtp->lastts - pred) < 7200) {
+				rtp->lastts = pred;
+				rtp->lastotexttimestamp += f->samples;
+			} else {
+				tris_debug(3, "Difference is %d, ms is %d, pred/ts/samples %d/%d/%d\n", abs(rtp->lastts - pred), ms, rtp->lastts, pred, f->samples);
+				rtp->lastotexttimestamp = rtp->lastts;
+			}
+		}
+		if (f->frametype == TRIS_FRAME_FILE) {
+			rtp->lastts = f->ts;
+			if (f->subclass & 0x08) {
+				mark = 1;
+			}
+			codec = codec & 0xf7;
+			rtp->ssrc = rtp->themssrc;
+			rtp->seqno = f->seqno;
 		}
-		return &tris_null_frame;
 	}
-	
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short\n");
-		return &tris_null_frame;
+
+	/* If we have been explicitly told to set the marker bit do so */
+	if (rtp->set_marker_bit) {
+		mark = 1;
+		rtp->set_marker_bit = 0;
 	}
 
-	/* Get fields */
-	seqno = ntohl(rtpheader[0]);
+	/* If the timestamp for non-digit packets has moved beyond the timestamp
+	   for digits, update the digit timestamp.
+	*/
+	if (rtp->lastts > rtp->lastdigitts)
+		rtp->lastdigitts = rtp->lastts;
 
-	/* Check RTP version */
-	version = (seqno & 0xC0000000) >> 30;
-	if (!version) {
-		/* If the two high bits are 0, this might be a
-		 * STUN message, so process it. stun_handle_packet()
-		 * answers to requests, and it returns STUN_ACCEPT
-		 * if the request is valid.
-		 */
-		if ((stun_handle_packet(rtp->s, &sock_in, rtp->rawdata + TRIS_FRIENDLY_OFFSET, res, NULL, NULL) == STUN_ACCEPT) &&
-			(!rtp->them.sin_port && !rtp->them.sin_addr.s_addr)) {
-			memcpy(&rtp->them, &sock_in, sizeof(rtp->them));
-		}
-		return &tris_null_frame;
-	}
+	if (tris_test_flag(f, TRIS_FRFLAG_HAS_TIMING_INFO))
+		rtp->lastts = f->ts * rate;
 
-#if 0	/* Allow to receive RTP stream with closed transmission path */
-	/* If we don't have the other side's address, then ignore this */
-	if (!rtp->them.sin_addr.s_addr || !rtp->them.sin_port)
-		return &tris_null_frame;
-#endif
+	/* Get a pointer to the header */
+	rtpheader = (unsigned char *)(f->data.ptr - hdrlen);
 
-	/* Send to whoever send to us if NAT is turned on */
-	if (rtp->nat) {
-		if (((rtp->them.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-			(rtp->them.sin_port != sock_in.sin_port)) && 
-			((rtp->altthem.sin_addr.s_addr != sock_in.sin_addr.s_addr) ||
-			(rtp->altthem.sin_port != sock_in.sin_port))) {
-			rtp->them = sock_in;
-			if (rtp->rtcp) {
-				int h = 0;
-				memcpy(&rtp->rtcp->them, &sock_in, sizeof(rtp->rtcp->them));
-				h = ntohs(rtp->them.sin_port);
-				rtp->rtcp->them.sin_port = htons(h + 1);
+	put_unaligned_uint32(rtpheader, htonl((2 << 30) | (codec << 16) | (rtp->seqno) | (mark << 23)));
+	put_unaligned_uint32(rtpheader + 4, htonl(rtp->lastts));
+	put_unaligned_uint32(rtpheader + 8, htonl(rtp->ssrc)); 
+
+	if (rtp->them.sin_port && rtp->them.sin_addr.s_addr) {
+		res = tris_udp_batch_sendto(rtp->txbatching ? rtp->txbatch : NULL, rtp->s, rtpheader, f->datalen + hdrlen, &rtp->them, &rtp->iostats);
+		if (res < 0) {
+			if (!rtp->nat || (rtp->nat && (tris_test_flag(rtp, FLAG_NAT_ACTIVE) == FLAG_NAT_ACTIVE))) {
+				tris_debug(1, "RTP Transmission error of packet %d to %s:%d: %s\n", rtp->seqno, tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), strerror(errno));
+			} else if (((tris_test_flag(rtp, FLAG_NAT_ACTIVE) == FLAG_NAT_INACTIVE) || rtpdebug) && !tris_test_flag(rtp, FLAG_NAT_INACTIVE_NOWARN)) {
+				/* Only give this error message once if we are not RTP debugging */
+				if (option_debug || rtpdebug)
+					tris_debug(0, "RTP NAT: Can't write RTP to private address %s:%d, waiting for other end to send audio...\n", tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port));
+				tris_set_flag(rtp, FLAG_NAT_INACTIVE_NOWARN);
+			}
+		} else {
+			rtp->txcount++;
+			rtp->txoctetcount +=(res - hdrlen);
+			
+			/* Do not schedule RR if RTCP isn't run */
+			if (rtp->rtcp && rtp->rtcp->them.sin_addr.s_addr && rtp->rtcp->schedid < 1) {
+				rtp->rtcp->schedid = tris_sched_add(rtp->sched, tris_rtcp_calc_interval(rtp), tris_rtcp_write, rtp);
 			}
-			rtp->rxseqno = 0;
-			tris_set_flag(rtp, FLAG_NAT_ACTIVE);
-			if (option_debug || rtpdebug)
-				tris_debug(0, "RTP NAT: Got audio from other end. Now sending to address %s:%d\n", tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port));
 		}
+				
+		if (rtp_debug_test_addr(&rtp->them))
+			tris_verbose("Sent RTP packet to      %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
+					tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), codec, rtp->seqno, rtp->lastts,res - hdrlen);
 	}
 
-	/* If we are bridged to another RTP stream, send direct */
-	if ((bridged = tris_rtp_get_bridged(rtp)) && !bridge_p2p_rtp_write(rtp, bridged, rtpheader, res, hdrlen))
-		return &tris_null_frame;
+	rtp->seqno++;
 
-	if (version != 2)
-		return &tris_null_frame;
+	return 0;
+}
 
-	payloadtype = (seqno & 0x7f0000) >> 16;
-	padding = seqno & (1 << 29);
-	mark = seqno & (1 << 23);
-	ext = seqno & (1 << 28);
-	cc = (seqno & 0xF000000) >> 24;
-	seqno &= 0xffff;
-	timestamp = ntohl(rtpheader[1]);
-	ssrc = ntohl(rtpheader[2]);
-	
-	if (!mark && rtp->rxssrc && rtp->rxssrc != ssrc) {
-		if (option_debug || rtpdebug)
-			tris_debug(0, "Forcing Marker bit, because SSRC has changed\n");
-		mark = 1;
-	}
+struct tris_frame *rakwon_audio_mixing_read(struct tris_rtp *rtp)
+{
+	/* The mixed audio is tunnelled: an inner RTP header and the promoter precede it */
+	return rtp_read_packet(rtp, -1, RTP_READ_PROMOTER, 0, 13);
+}
 
-	rtp->rxssrc = ssrc;
-	
-	if (padding) {
-		/* Remove padding bytes */
-		res -= rtp->rawdata[TRIS_FRIENDLY_OFFSET + res - 1];
-	}
-	
-	if (cc) {
-		/* CSRC fields present */
-		hdrlen += cc*4;
-	}
+struct tris_frame *rakwon_mixed_audio_read(struct tris_rtp* rtp, int fd)
+{
+	return rtp_read_packet(rtp, fd, RTP_READ_MEDIA | RTP_READ_SSRC_MARK, 0, 0);
+}
 
-	if (ext) {
-		/* RTP Extension present */
-		hdrlen += (ntohl(rtpheader[hdrlen/4]) & 0xffff) << 2;
-		hdrlen += 4;
-		if (option_debug) {
-			int profile;
-			profile = (ntohl(rtpheader[3]) & 0xffff0000) >> 16;
-			if (profile == 0x505a)
-				tris_debug(1, "Found Zfone extension in RTP stream - zrtp - not supported.\n");
-			else
-				tris_debug(1, "Found unknown RTP Extensions %x\n", profile);
-		}
+/*! \brief Write RTP packet with audio or video media frames into UDP packet */
+int rakwon_mixed_audio_raw_write(struct tris_rtp* rtp, int fd, struct tris_frame *f, int codec)
+{
+	unsigned char *rtpheader;
+	int hdrlen = 12;
+	int res;
+	unsigned int ms;
+	int pred;
+	int mark = 0;
+	int rate = rtp_get_rate(f->subclass) / 1000;
+
+	if (f->subclass == TRIS_FORMAT_G722) {
+		f->samples /= 2;
+	} else if (f->subclass == TRIS_FORMAT_OPUS) {
+		f->samples *= 3;
 	}
 
-	if (res < hdrlen) {
-		tris_log(LOG_WARNING, "RTP Read too short (%d, expecting %d)\n", res, hdrlen);
-		return &tris_null_frame;
+	if (rtp->sending_digit) {
+		return 0;
 	}
 
-	rtp->rxcount++; /* Only count reasonably valid packets, this'll make the rtcp stats more accurate */
+	ms = calc_txstamp(rtp, &f->delivery);
+	/* Default prediction */
+	if (f->frametype == TRIS_FRAME_VOICE) {
+		pred = rtp->lastts + f->samples;
 
-	if (rtp->rxcount==1) {
-		/* This is the first RTP packet successfully received from source */
-		rtp->seedrxseqno = seqno;
+		/* Re-calculate last TS */
+		rtp->lastts = rtp->lastts + ms * rate;
+		if (tris_tvzero(f->delivery)) {
+			/* If this isn't an absolute delivery time, Check if it is close to our prediction, 
+			   and if so, go with our prediction */
+			if (abs(rtp->lastts - pred) < MAX_TIMESTAMP_SKEW)
+				rtp->lastts = pred;
+			else {
+				tris_debug(3, "Difference is %d, ms is %d\n", abs(rtp->lastts - pred), ms);
+				mark = 1;
+			}
+		}
+	} else if (f->frametype == TRIS_FRAME_VIDEO) {
+		mark = f->subclass & 0x1;
+		pred = rtp->lastovidtimestamp + f->samples;
+		/* Re-calculate last TS */
+		rtp->lastts = rtp->lastts + ms * 90;
+		/* If it's close to our prediction, go for it */
+		if (tris_tvzero(f->delivery)) {
+			if (abs(rtp->lastts - pred) < 7200) {
+				rtp->lastts = pred;
+				rtp->lastovidtimestamp += f->samples;
+			} else {
+				tris_debug(3, "Difference is %d, ms is %d (%d), pred/ts/samples %d/%d/%d\n", abs(rtp->lastts - pred), ms, ms * 90, rtp->lastts, pred, f->samples);
+				rtp->lastovidtimestamp = rtp->lastts;
+			}
+		}
+	} else {
+		pred = rtp->lastotexttimestamp + f->samples;
+		/* Re-calculate last TS */
+		rtp->lastts = rtp->lastts + ms;
+		/* If it's close to our prediction, go for it */
+		if (tris_tvzero(f->delivery)) {
+			if (abs(rtp->lastts - pred) < 7200) {
+				rtp->lastts = pred;
+				rtp->lastotexttimestamp += f->samples;
+			} else {
+				tris_debug(3, "Difference is %d, ms is %d, pred/ts/samples %d/%d/%d\n", abs(rtp->lastts - pred), ms, rtp->lastts, pred, f->samples);
+				rtp->lastotexttimestamp = rtp->lastts;
+			}
+		}
 	}
 
-	/* Do not schedule RR if RTCP isn't run */
-	if (rtp->rtcp && rtp->rtcp->them.sin_addr.s_addr && rtp->rtcp->schedid < 1) {
-		/* Schedule transmission of Receiver Report */
-		rtp->rtcp->schedid = tris_sched_add(rtp->sched, tris_rtcp_calc_interval(rtp), tris_rtcp_write, rtp);
+	/* If we have been explicitly told to set the marker bit do so */
+	if (rtp->set_marker_bit) {
+		mark = 1;
+		rtp->set_marker_bit = 0;
 	}
-	if ((int)rtp->lastrxseqno - (int)seqno	> 100) /* if so it would indicate that the sender cycled; allow for misordering */
-		rtp->cycles += RTP_SEQ_MOD;
-	
-	prev_seqno = rtp->lastrxseqno;
 
-	rtp->lastrxseqno = seqno;
-	
-	if (!rtp->themssrc)
-		rtp->themssrc = ntohl(rtpheader[2]); /* Record their SSRC to put in future RR */
-	
-	if (rtp_debug_test_addr(&sock_in))
-		tris_verbose("Got  RTP packet from	  %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
-			tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp,res - hdrlen);
+	/* If the timestamp for non-digit packets has moved beyond the timestamp
+	   for digits, update the digit timestamp.
+	*/
+	if (rtp->lastts > rtp->lastdigitts)
+		rtp->lastdigitts = rtp->lastts;
+
+	if (tris_test_flag(f, TRIS_FRFLAG_HAS_TIMING_INFO))
+		rtp->lastts = f->ts * rate;
+
+	/* Get a pointer to the header */
+	rtpheader = (unsigned char *)(f->data.ptr - hdrlen);
 
-	rtpPT = tris_rtp_lookup_pt(rtp, payloadtype);
-	if (!rtpPT.isAstFormat) {
-		struct tris_frame *f = NULL;
+	put_unaligned_uint32(rtpheader, htonl((2 << 30) | (codec << 16) | (rtp->seqno) | (mark << 23)));
+	put_unaligned_uint32(rtpheader + 4, htonl(rtp->lastts));
+	put_unaligned_uint32(rtpheader + 8, htonl(rtp->ssrc)); 
 
-		/* This is special in-band data that's not one of our codecs */
-		if (rtpPT.code == TRIS_RTP_DTMF) {
-			/* It's special -- rfc2833 process it */
-			if (rtp_debug_test_addr(&sock_in)) {
-				unsigned char *data;
-				unsigned int event;
-				unsigned int event_end;
-				unsigned int duration;
-				data = rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen;
-				event = ntohl(*((unsigned int *)(data)));
-				event >>= 24;
-				event_end = ntohl(*((unsigned int *)(data)));
-				event_end <<= 8;
-				event_end >>= 24;
-				duration = ntohl(*((unsigned int *)(data)));
-				duration &= 0xFFFF;
-				tris_verbose("Got  RTP RFC2833 from   %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u, mark %d, event %08x, end %d, duration %-5.5d) \n", tris_inet_ntoa(sock_in.sin_addr), ntohs(sock_in.sin_port), payloadtype, seqno, timestamp, res - hdrlen, (mark?1:0), event, ((event_end & 0x80)?1:0), duration);
-			}
-			f = process_rfc2833(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen, seqno, timestamp);
-		} else if (rtpPT.code == TRIS_RTP_CISCO_DTMF) {
-			/* It's really special -- process it the Cisco way */
-			if (rtp->lastevent <= seqno || (rtp->lastevent >= 65530 && seqno <= 6)) {
-				f = process_cisco_dtmf(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
-				rtp->lastevent = seqno;
+	if (rtp->them.sin_port && rtp->them.sin_addr.s_addr) {
+		res = write(fd, (void *)rtpheader, f->datalen + hdrlen);
+		if (res < 0) {
+			if (!rtp->nat || (rtp->nat && (tris_test_flag(rtp, FLAG_NAT_ACTIVE) == FLAG_NAT_ACTIVE))) {
+				tris_debug(1, "RTP Transmission error of packet %d to %s:%d: %s\n", rtp->seqno, tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), strerror(errno));
+			} else if (((tris_test_flag(rtp, FLAG_NAT_ACTIVE) == FLAG_NAT_INACTIVE) || rtpdebug) && !tris_test_flag(rtp, FLAG_NAT_INACTIVE_NOWARN)) {
+				/* Only give this error message once if we are not RTP debugging */
+				if (option_debug || rtpdebug)
+					tris_debug(0, "RTP NAT: Can't write RTP to private address %s:%d, waiting for other end to send audio...\n", tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port));
+				tris_set_flag(rtp, FLAG_NAT_INACTIVE_NOWARN);
 			}
-		} else if (rtpPT.code == TRIS_RTP_CN) {
-			/* Comfort Noise */
-			f = process_rfc3389(rtp, rtp->rawdata + TRIS_FRIENDLY_OFFSET + hdrlen, res - hdrlen);
 		} else {
-			tris_log(LOG_NOTICE, "Unknown RTP codec %d received from '%s'\n", payloadtype, tris_inet_ntoa(rtp->them.sin_addr));
+			rtp->txcount++;
+			rtp->txoctetcount +=(res - hdrlen);
+			
+			/* Do not schedule RR if RTCP isn't run */
+			if (rtp->rtcp && rtp->rtcp->them.sin_addr.s_addr && rtp->rtcp->schedid < 1) {
+				rtp->rtcp->schedid = tris_sched_add(rtp->sched, tris_rtcp_calc_interval(rtp), tris_rtcp_write, rtp);
+			}
 		}
-		return f ? f : &tris_null_frame;
+				
+		if (rtp_debug_test_addr(&rtp->them))
+			tris_verbose("Sent RTP packet to      %s:%u (type %-2.2d, seq %-6.6u, ts %-6.6u, len %-6.6u)\n",
+					tris_inet_ntoa(rtp->them.sin_addr), ntohs(rtp->them.sin_port), codec, rtp->seqno, rtp->lastts,res - hdrlen);
 	}
-	rtp->lastrxformat = rtp->f.subclass = rtpPT.code;
-	rtp->f.frametype = (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) ? TRIS_FRAME_VOICE : (rtp->f.subclass & TRIS_FORMAT_VIDEO_MASK) ? TRIS_FRAME_VIDEO : TRIS_FRAME_TEXT;
 
-	rtp->rxseqno = seqno;
+	rtp->seqno++;
 
-	if (rtp->dtmf_timeout && rtp->dtmf_timeout < timestamp) {
-		rtp->dtmf_timeout = 0;
+	return 0;
+}
 
-		if (rtp->resp) {
-			struct tris_frame *f;
-			f = send_dtmf(rtp, TRIS_FRAME_DTMF_END);
-			f->len = tris_tvdiff_ms(tris_samp2tv(rtp->dtmf_duration, rtp_get_rate(f->subclass)), tris_tv(0, 0));
-			rtp->resp = 0;
-			rtp->dtmf_timeout = rtp->dtmf_duration = 0;
-			return f;
-		}
+int rakwon_mixed_audio_write(struct tris_rtp *rtp, int fd, struct tris_frame *_f)
+{
+	struct tris_frame *f;
+	format_t codec;
+	int hdrlen = 12;
+	format_t subclass;
+	
+
+	/* If we have no peer, return immediately */	
+	if (!rtp->them.sin_addr.s_addr)
+		return 0;
+
+	/* If there is no data length, return immediately */
+	if (!_f->datalen && !rtp->red)
+		return 0;
+	
+	/* Make sure we have enough space for RTP header */
+	if ((_f->frametype != TRIS_FRAME_VOICE) && (_f->frametype != TRIS_FRAME_VIDEO) && (_f->frametype != TRIS_FRAME_TEXT)) {
+		tris_log(LOG_WARNING, "RTP can only send voice, video and text\n");
+		return -1;
 	}
 
-	/* Record received timestamp as last received now */
-	rtp->lastrxts = timestamp;
+	if (rtp->red) {
+		/* return 0; */
+		/* no primary data or generations to send */
+		if ((_f = red_t140_to_red(rtp->red)) == NULL) 
+			return 0;
+	}
 
-	rtp->f.mallocd = 0;
-	rtp->f.datalen = res - hdrlen - 12;
-	rtp->f.data.ptr = rtp->rawdata + hdrlen + TRIS_FRIENDLY_OFFSET + 12;
-	rtp->f.offset = hdrlen + TRIS_FRIENDLY_OFFSET + 12;
-	rtp->f.seqno = seqno;
+	/* The bottom bit of a video subclass contains the marker bit */
+	subclass = _f->subclass;
+	if (_f->frametype == TRIS_FRAME_VIDEO)
+		subclass &= ~0x1;
 
-	if (rtp->f.subclass == TRIS_FORMAT_T140 && (int)seqno - (prev_seqno+1) > 0 && (int)seqno - (prev_seqno+1) < 10) {
-		  unsigned char *data = rtp->f.data.ptr;
-		  
-		  memmove(rtp->f.data.ptr+3, rtp->f.data.ptr, rtp->f.datalen);
-		  rtp->f.datalen +=3;
-		  *data++ = 0xEF;
-		  *data++ = 0xBF;
-		  *data = 0xBD;
+	codec = tris_rtp_lookup_code(rtp, 1, subclass);
+	if (codec < 0) {
+		tris_log(LOG_WARNING, "Don't know how to send format %s packets with RTP\n", tris_getformatname(_f->subclass));
+		return -1;
 	}
- 
-	if (rtp->f.subclass == TRIS_FORMAT_T140RED) {
-		unsigned char *data = rtp->f.data.ptr;
-		unsigned char *header_end;
-		int num_generations;
-		int header_length;
-		int length;
-		int diff =(int)seqno - (prev_seqno+1); /* if diff = 0, no drop*/
-		int x;
 
-		rtp->f.subclass = TRIS_FORMAT_T140;
-		header_end = memchr(data, ((*data) & 0x7f), rtp->f.datalen);
-		if (header_end == NULL) {
-			return &tris_null_frame;
-		}
-		header_end++;
-		
-		header_length = header_end - data;
-		num_generations = header_length / 4;
-		length = header_length;
+	if (rtp->lasttxformat != subclass) {
+		/* New format, reset the smoother */
+		tris_debug(1, "Ooh, format changed from %s to %s\n", tris_getformatname(rtp->lasttxformat), tris_getformatname(subclass));
+		rtp->lasttxformat = subclass;
+		if (rtp->smoother)
+			tris_smoother_free(rtp->smoother);
+		rtp->smoother = NULL;
+	}
 
-		if (!diff) {
-			for (x = 0; x < num_generations; x++)
-				length += data[x * 4 + 3];
-			
-			if (!(rtp->f.datalen - length))
-				return &tris_null_frame;
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-		} else if (diff > num_generations && diff < 10) {
-			length -= 3;
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
-			
-			data = rtp->f.data.ptr;
-			*data++ = 0xEF;
-			*data++ = 0xBF;
-			*data = 0xBD;
-		} else	{
-			for ( x = 0; x < num_generations - diff; x++) 
-				length += data[x * 4 + 3];
-			
-			rtp->f.data.ptr += length;
-			rtp->f.datalen -= length;
+#if 0
+	if (!rtp->smoother) {
+		struct tris_format_list fmt = tris_codec_pref_getsize(&rtp->pref, subclass);
+
+		switch (subclass) {
+		case TRIS_FORMAT_SPEEX:
+		case TRIS_FORMAT_G723_1:
+		case TRIS_FORMAT_SIREN7:
+		case TRIS_FORMAT_SIREN14:
+			/* these are all frame-based codecs and cannot be safely run through
+			   a smoother */
+			break;
+		default:
+			if (fmt.inc_ms) { /* if codec parameters is set / avoid division by zero */
+				if (!(rtp->smoother = tris_smoother_new((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms))) {
+					tris_log(LOG_WARNING, "Unable to create smoother: format: %s ms: %d len: %d\n", tris_getformatname(subclass), fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
+					return -1;
+				}
+				if (fmt.flags)
+					tris_smoother_set_flags(rtp->smoother, fmt.flags);
+				tris_debug(1, "Created smoother: format: %s ms: %d len: %d\n", tris_getformatname(subclass), fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
+			}
 		}
 	}
+	if (rtp->smoother) {
+		if (tris_smoother_test_flag(rtp->smoother, TRIS_SMOOTHER_FLAG_BE)) {
+			tris_smoother_feed_be(rtp->smoother, _f);
+		} else {
+			tris_smoother_feed(rtp->smoother, _f);
+		}
 
-	if (rtp->f.subclass & TRIS_FORMAT_AUDIO_MASK) {
-		rtp->f.samples = tris_codec_get_samples(&rtp->f);
-		if (rtp->f.subclass == TRIS_FORMAT_SLINEAR) 
-			tris_frame_byteswap_be(&rtp->f);
-		calc_rxstamp(&rtp->f.delivery, rtp, timestamp, mark);
-		/* Add timing data to let tris_generic_bridge() put the frame into a jitterbuf */
-		tris_set_flag(&rtp->f, TRIS_FRFLAG_HAS_TIMING_INFO);
-		rtp->f.ts = timestamp / (rtp_get_rate(rtp->f.subclass) / 1000);
-		rtp->f.len = rtp->f.samples / ((tris_format_rate(rtp->f.subclass) / 1000));
-	} else if (rtp->f.subclass & TRIS_FORMAT_VIDEO_MASK) {
-		/* Video -- samples is # of samples vs. 90000 */
-		if (!rtp->lastividtimestamp)
-			rtp->lastividtimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastividtimestamp;
-		rtp->lastividtimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
-		/* Pass the RTP marker bit as bit 0 in the subclass field.
-		 * This is ok because subclass is actually a bitmask, and
-		 * the low bits represent audio formats, that are not
-		 * involved here since we deal with video.
-		 */
-		if (mark)
-			rtp->f.subclass |= 0x1;
+		while ((f = tris_smoother_read(rtp->smoother)) && (f->data.ptr)) {
+			tris_rtp_raw_write(rtp, f, codec);
+		}
 	} else {
-		/* TEXT -- samples is # of samples vs. 1000 */
-		if (!rtp->lastitexttimestamp)
-			rtp->lastitexttimestamp = timestamp;
-		rtp->f.samples = timestamp - rtp->lastitexttimestamp;
-		rtp->lastitexttimestamp = timestamp;
-		rtp->f.delivery.tv_sec = 0;
-		rtp->f.delivery.tv_usec = 0;
-	}
-	rtp->f.src = "RTP";
-	return &rtp->f;
+#endif
+		/* Don't buffer outgoing frames; send them one-per-packet: */
+		if (_f->offset < hdrlen) 
+			f = tris_frdup(_f);	/*! \bug XXX this might never be free'd. Why do we do this? */
+		else
+			f = _f;
+		if (f->data.ptr)
+			rakwon_mixed_audio_raw_write(rtp, fd, f, codec);
+		if (f != _f)
+			tris_frfree(f);
+//	}
+		
+	return 0;
+}
+	
+struct tris_frame *rakwon_video_read(struct tris_rtp *rtp)
+{
+	/* The video is tunnelled behind an inner RTP header */
+	return rtp_read_packet(rtp, -1, RTP_READ_MEDIA | RTP_READ_SSRC_MARK, 0, 12);
 }
 
 /*! \brief Write RTP packet with audio or video media frames into UDP packet */
@@ -6023,6 +4184,8 @@ static int rakwon_rtp_raw_write(struct tris_rtp *rtp, struct tris_frame *f, int
 
 	if (f->subclass == TRIS_FORMAT_G722) {
 		f->samples /= 2;
+	} else if (f->subclass == TRIS_FORMAT_OPUS) {
+		f->samples *= 3;
 	}
 
 	if (rtp->sending_digit) {
@@ -6161,9 +4324,9 @@ static int rakwon_rtp_raw_write(struct tris_rtp *rtp, struct tris_frame *f, int
 int rakwon_rtp_write(struct tris_rtp *rtp, struct tris_frame *_f, int video)
 {
 	struct tris_frame *f;
-	int codec;
+	format_t codec;
 	int hdrlen = 12;
-	int subclass;
+	format_t subclass;
 	
 
 	/* If we have no peer, return immediately */	
@@ -6216,18 +4379,19 @@ int rakwon_rtp_write(struct tris_rtp *rtp, struct tris_frame *_f, int video)
 		case TRIS_FORMAT_G723_1:
 		case TRIS_FORMAT_SIREN7:
 		case TRIS_FORMAT_SIREN14:
+		case TRIS_FORMAT_OPUS:
 			/* these are all frame-based codecs and cannot be safely run through
 			   a smoother */
 			break;
 		default:
 			if (fmt.inc_ms) { /* if codec parameters is set / avoid division by zero */
 				if (!(rtp->smoother = tris_smoother_new((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms))) {
-					tris_log(LOG_WARNING, "Unable to create smoother: format: %d ms: %d len: %d\n", subclass, fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
+					tris_log(LOG_WARNING, "Unable to create smoother: format: %s ms: %d len: %d\n", tris_getformatname(subclass), fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
 					return -1;
 				}
 				if (fmt.flags)
 					tris_smoother_set_flags(rtp->smoother, fmt.flags);
-				tris_debug(1, "Created smoother: format: %d ms: %d len: %d\n", subclass, fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
+				tris_debug(1, "Created smoother: format: %s ms: %d len: %d\n", tris_getformatname(subclass), fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
 			}
 		}
 	}
@@ -6288,14 +4452,14 @@ void tris_rtp_codec_setpref(struct tris_rtp *rtp, struct tris_codec_pref *prefs)
 			}
 		} else {
 			if (!(rtp->smoother = tris_smoother_new(new_size))) {
-				tris_log(LOG_WARNING, "Unable to create smoother: format: %d ms: %d len: %d\n", rtp->lasttxformat, current_format_new.cur_ms, new_size);
+				tris_log(LOG_WARNING, "Unable to create smoother: format: %s ms: %d len: %d\n", tris_getformatname(rtp->lasttxformat), current_format_new.cur_ms, new_size);
 				return;
 			}
 			if (current_format_new.flags) {
 				tris_smoother_set_flags(rtp->smoother, current_format_new.flags);
 			}
 			if (option_debug) {
-				tris_log(LOG_DEBUG, "Created smoother: format: %d ms: %d len: %d\n", rtp->lasttxformat, current_format_new.cur_ms, new_size);
+				tris_log(LOG_DEBUG, "Created smoother: format: %s ms: %d len: %d\n", tris_getformatname(rtp->lasttxformat), current_format_new.cur_ms, new_size);
 			}
 		}
 	}
@@ -6307,7 +4471,7 @@ struct tris_codec_pref *tris_rtp_codec_getpref(struct tris_rtp *rtp)
 	return &rtp->pref;
 }
 
-int tris_rtp_codec_getformat(int pt)
+format_t tris_rtp_codec_getformat(int pt)
 {
 	if (pt < 0 || pt >= MAX_RTP_PT)
 		return 0; /* bogus payload type */
@@ -6321,9 +4485,9 @@ int tris_rtp_codec_getformat(int pt)
 int tris_rtp_write(struct tris_rtp *rtp, struct tris_frame *_f)
 {
 	struct tris_frame *f;
-	int codec;
+	format_t codec;
 	int hdrlen = 12;
-	int subclass;
+	format_t subclass;
 	
 
 	/* If we have no peer, return immediately */	
@@ -6389,18 +4553,19 @@ int tris_rtp_write(struct tris_rtp *rtp, struct tris_frame *_f)
 		case TRIS_FORMAT_G723_1:
 		case TRIS_FORMAT_SIREN7:
 		case TRIS_FORMAT_SIREN14:
+		case TRIS_FORMAT_OPUS:
 			/* these are all frame-based codecs and cannot be safely run through
 			   a smoother */
 			break;
 		default:
 			if (fmt.inc_ms) { /* if codec parameters is set / avoid division by zero */
 				if (!(rtp->smoother = tris_smoother_new((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms))) {
-					tris_log(LOG_WARNING, "Unable to create smoother: format: %d ms: %d len: %d\n", subclass, fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
+					tris_log(LOG_WARNING, "Unable to create smoother: format: %s ms: %d len: %d\n", tris_getformatname(subclass), fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
 					return -1;
 				}
 				if (fmt.flags)
 					tris_smoother_set_flags(rtp->smoother, fmt.flags);
-				tris_debug(1, "Created smoother: format: %d ms: %d len: %d\n", subclass, fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
+				tris_debug(1, "Created smoother: format: %s ms: %d len: %d\n", tris_getformatname(subclass), fmt.cur_ms, ((fmt.cur_ms * fmt.fr_len) / fmt.inc_ms));
 			}
 		}
 	}
@@ -6411,9 +4576,13 @@ int tris_rtp_write(struct tris_rtp *rtp, struct tris_frame *_f)
 			tris_smoother_feed(rtp->smoother, _f);
 		}
 
+		/* A frame can be smoothed into several packets, send them together */
+		rtp->txbatching = 1;
 		while ((f = tris_smoother_read(rtp->smoother)) && (f->data.ptr)) {
 			tris_rtp_raw_write(rtp, f, codec);
 		}
+		rtp->txbatching = 0;
+		tris_udp_batch_flush(rtp->txbatch, &rtp->iostats);
 	} else {
 		/* Don't buffer outgoing frames; send them one-per-packet: */
 		if (_f->offset < hdrlen) 
@@ -6457,11 +4626,11 @@ int tris_rtp_proto_register(struct tris_rtp_protocol *proto)
 }
 
 /*! \brief Bridge loop for true native bridge (reinvite) */
-static enum tris_bridge_result bridge_native_loop(struct tris_channel *c0, struct tris_channel *c1, struct tris_rtp *p0, struct tris_rtp *p1, struct tris_rtp *vp0, struct tris_rtp *vp1, struct tris_rtp *tp0, struct tris_rtp *tp1, struct tris_rtp_protocol *pr0, struct tris_rtp_protocol *pr1, int codec0, int codec1, int timeoutms, int flags, struct tris_frame **fo, struct tris_channel **rc, void *pvt0, void *pvt1)
+static enum tris_bridge_result bridge_native_loop(struct tris_channel *c0, struct tris_channel *c1, struct tris_rtp *p0, struct tris_rtp *p1, struct tris_rtp *vp0, struct tris_rtp *vp1, struct tris_rtp *tp0, struct tris_rtp *tp1, struct tris_rtp_protocol *pr0, struct tris_rtp_protocol *pr1, format_t codec0, format_t codec1, int timeoutms, int flags, struct tris_frame **fo, struct tris_channel **rc, void *pvt0, void *pvt1)
 {
 	struct tris_frame *fr = NULL;
 	struct tris_channel *who = NULL, *other = NULL, *cs[3] = {NULL, };
-	int oldcodec0 = codec0, oldcodec1 = codec1;
+	format_t oldcodec0 = codec0, oldcodec1 = codec1;
 	struct sockaddr_in ac1 = {0,}, vac1 = {0,}, tac1 = {0,}, ac0 = {0,}, vac0 = {0,}, tac0 = {0,};
 	struct sockaddr_in t1 = {0,}, vt1 = {0,}, tt1 = {0,}, t0 = {0,}, vt0 = {0,}, tt0 = {0,};
 	
@@ -6533,18 +4702,18 @@ static enum tris_bridge_result bridge_native_loop(struct tris_channel *c0, struc
 		    (vp1 && inaddrcmp(&vt1, &vac1)) ||
 		    (tp1 && inaddrcmp(&tt1, &tac1)) ||
 		    (codec1 != oldcodec1)) {
-			tris_debug(2, "Oooh, '%s' changed end address to %s:%d (format %d)\n",
-				c1->name, tris_inet_ntoa(t1.sin_addr), ntohs(t1.sin_port), codec1);
-			tris_debug(2, "Oooh, '%s' changed end vaddress to %s:%d (format %d)\n",
-				c1->name, tris_inet_ntoa(vt1.sin_addr), ntohs(vt1.sin_port), codec1);
-			tris_debug(2, "Oooh, '%s' changed end taddress to %s:%d (format %d)\n",
-				c1->name, tris_inet_ntoa(tt1.sin_addr), ntohs(tt1.sin_port), codec1);
-			tris_debug(2, "Oooh, '%s' was %s:%d/(format %d)\n",
-				c1->name, tris_inet_ntoa(ac1.sin_addr), ntohs(ac1.sin_port), oldcodec1);
-			tris_debug(2, "Oooh, '%s' was %s:%d/(format %d)\n",
-				c1->name, tris_inet_ntoa(vac1.sin_addr), ntohs(vac1.sin_port), oldcodec1);
-			tris_debug(2, "Oooh, '%s' was %s:%d/(format %d)\n",
-				c1->name, tris_inet_ntoa(tac1.sin_addr), ntohs(tac1.sin_port), oldcodec1);
+			tris_debug(2, "Oooh, '%s' changed end address to %s:%d (format %s)\n",
+				c1->name, tris_inet_ntoa(t1.sin_addr), ntohs(t1.sin_port), tris_getformatname(codec1));
+			tris_debug(2, "Oooh, '%s' changed end vaddress to %s:%d (format %s)\n",
+				c1->name, tris_inet_ntoa(vt1.sin_addr), ntohs(vt1.sin_port), tris_getformatname(codec1));
+			tris_debug(2, "Oooh, '%s' changed end taddress to %s:%d (format %s)\n",
+				c1->name, tris_inet_ntoa(tt1.sin_addr), ntohs(tt1.sin_port), tris_getformatname(codec1));
+			tris_debug(2, "Oooh, '%s' was %s:%d/(format %s)\n",
+				c1->name, tris_inet_ntoa(ac1.sin_addr), ntohs(ac1.sin_port), tris_getformatname(oldcodec1));
+			tris_debug(2, "Oooh, '%s' was %s:%d/(format %s)\n",
+				c1->name, tris_inet_ntoa(vac1.sin_addr), ntohs(vac1.sin_port), tris_getformatname(oldcodec1));
+			tris_debug(2, "Oooh, '%s' was %s:%d/(format %s)\n",
+				c1->name, tris_inet_ntoa(tac1.sin_addr), ntohs(tac1.sin_port), tris_getformatname(oldcodec1));
 			if (pr0->set_rtp_peer(c0, t1.sin_addr.s_addr ? p1 : NULL, vt1.sin_addr.s_addr ? vp1 : NULL, tt1.sin_addr.s_addr ? tp1 : NULL, codec1, tris_test_flag(p1, FLAG_NAT_ACTIVE)))
 				tris_log(LOG_WARNING, "Channel '%s' failed to update to '%s'\n", c0->name, c1->name);
 			memcpy(&ac1, &t1, sizeof(ac1));
@@ -6556,10 +4725,10 @@ static enum tris_bridge_result bridge_native_loop(struct tris_channel *c0, struc
 		    (vp0 && inaddrcmp(&vt0, &vac0)) ||
 		    (tp0 && inaddrcmp(&tt0, &tac0)) ||
 		    (codec0 != oldcodec0)) {
-			tris_debug(2, "Oooh, '%s' changed end address to %s:%d (format %d)\n",
-				c0->name, tris_inet_ntoa(t0.sin_addr), ntohs(t0.sin_port), codec0);
-			tris_debug(2, "Oooh, '%s' was %s:%d/(format %d)\n",
-				c0->name, tris_inet_ntoa(ac0.sin_addr), ntohs(ac0.sin_port), oldcodec0);
+			tris_debug(2, "Oooh, '%s' changed end address to %s:%d (format %s)\n",
+				c0->name, tris_inet_ntoa(t0.sin_addr), ntohs(t0.sin_port), tris_getformatname(codec0));
+			tris_debug(2, "Oooh, '%s' was %s:%d/(format %s)\n",
+				c0->name, tris_inet_ntoa(ac0.sin_addr), ntohs(ac0.sin_port), tris_getformatname(oldcodec0));
 			if (pr1->set_rtp_peer(c1, t0.sin_addr.s_addr ? p0 : NULL, vt0.sin_addr.s_addr ? vp0 : NULL, tt0.sin_addr.s_addr ? tp0 : NULL, codec0, tris_test_flag(p0, FLAG_NAT_ACTIVE)))
 				tris_log(LOG_WARNING, "Channel '%s' failed to update to '%s'\n", c1->name, c0->name);
 			memcpy(&ac0, &t0, sizeof(ac0));
@@ -6633,7 +4802,7 @@ static enum tris_bridge_result bridge_native_loop(struct tris_channel *c0, struc
 			} else {
 				*fo = fr;
 				*rc = who;
-				tris_debug(1, "Got a FRAME_CONTROL (%d) frame on channel %s\n", fr->subclass, who->name);
+				tris_debug(1, "Got a FRAME_CONTROL (%d) frame on channel %s\n", (int) fr->subclass, who->name);
 				return TRIS_BRIDGE_COMPLETE;
 			}
 		} else {
@@ -6870,7 +5039,7 @@ static enum tris_bridge_result bridge_p2p_loop(struct tris_channel *c0, struct t
 			} else {
 				*fo = fr;
 				*rc = who;
-				tris_debug(3, "p2p-rtp-bridge: Got a FRAME_CONTROL (%d) frame on channel %s\n", fr->subclass, who->name);
+				tris_debug(3, "p2p-rtp-bridge: Got a FRAME_CONTROL (%d) frame on channel %s\n", (int) fr->subclass, who->name);
 				res = TRIS_BRIDGE_COMPLETE;
 				break;
 			}
@@ -6958,7 +5127,7 @@ enum tris_bridge_result tris_rtp_bridge(struct tris_channel *c0, struct tris_cha
 	enum tris_rtp_get_result audio_p0_res = TRIS_RTP_GET_FAILED, video_p0_res = TRIS_RTP_GET_FAILED, text_p0_res = TRIS_RTP_GET_FAILED;
 	enum tris_rtp_get_result audio_p1_res = TRIS_RTP_GET_FAILED, video_p1_res = TRIS_RTP_GET_FAILED, text_p1_res = TRIS_RTP_GET_FAILED;
 	enum tris_bridge_result res = TRIS_BRIDGE_FAILED;
-	int codec0 = 0, codec1 = 0;
+	format_t codec0 = 0, codec1 = 0;
 	void *pvt0 = NULL, *pvt1 = NULL;
 
 	/* Lock channels */
@@ -7065,7 +5234,7 @@ enum tris_bridge_result tris_rtp_bridge(struct tris_channel *c0, struct tris_cha
 	codec1 = pr1->get_codec ? pr1->get_codec(c1) : 0;
 	if (codec0 && codec1 && !(codec0 & codec1)) {
 		/* Hey, we can't do native bridging if both parties speak different codecs */
-		tris_debug(3, "Channel codec0 = %d is not codec1 = %d, cannot native bridge in RTP.\n", codec0, codec1);
+		tris_debug(3, "Channel codec0 = %s is not codec1 = %s, cannot native bridge in RTP.\n", tris_getformatname(codec0), tris_getformatname(codec1));
 		tris_channel_unlock(c0);
 		tris_channel_unlock(c1);
 		return TRIS_BRIDGE_FAILED_NOWARN;
@@ -7305,6 +5474,7 @@ static int __tris_rtp_reload(int reload)
 	rtpend = 31000;
 	dtmftimeout = DEFAULT_DTMF_TIMEOUT;
 	strictrtp = STRICT_RTP_OPEN;
+	rtpbatch = 0;
 	if (cfg) {
 		if ((s = tris_variable_retrieve(cfg, "general", "rtpstart"))) {
 			rtpstart = atoi(s);
@@ -7351,6 +5521,13 @@ static int __tris_rtp_reload(int reload)
 		if ((s = tris_variable_retrieve(cfg, "general", "strictrtp"))) {
 			strictrtp = tris_true(s);
 		}
+		if ((s = tris_variable_retrieve(cfg, "general", "rtpbatch"))) {
+			rtpbatch = atoi(s);
+			if (rtpbatch < 0)
+				rtpbatch = 0;
+			if (rtpbatch > TRIS_UDP_BATCH_MAX)
+				rtpbatch = TRIS_UDP_BATCH_MAX;
+		}
 		tris_config_destroy(cfg);
 	}
 	if (rtpstart >= rtpend) {
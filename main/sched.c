@@ -56,6 +56,31 @@ struct sched {
 	const void *data;             /*!< Data */
 	tris_sched_cb callback;        /*!< Callback */
 	ssize_t __heap_index;
+	struct sched *wheel_next;     /*!< Next entry in the same timing wheel slot */
+	struct sched **wheel_pprev;   /*!< What points to this entry in its timing wheel slot */
+	unsigned int wheel_tick;      /*!< Millisecond tick of when on the timing wheel */
+};
+
+/*! \brief Timing wheel layout
+ * \note The root has a slot per millisecond for the next 256 ms, and each
+ * level above it has 64 slots that each last as long as the whole level
+ * below, which covers 2^32 ms.  Entries move down a level every time the
+ * level below has gone round once.
+ */
+#define WHEEL_ROOT_BITS		8
+#define WHEEL_ROOT_SIZE		(1 << WHEEL_ROOT_BITS)
+#define WHEEL_ROOT_MASK		(WHEEL_ROOT_SIZE - 1)
+#define WHEEL_LEVEL_BITS	6
+#define WHEEL_LEVEL_SIZE	(1 << WHEEL_LEVEL_BITS)
+#define WHEEL_LEVEL_MASK	(WHEEL_LEVEL_SIZE - 1)
+#define WHEEL_LEVELS		4
+
+struct sched_wheel {
+	struct timeval start;                   /*!< Time of tick 0 */
+	unsigned int tick;                      /*!< Next tick to run, in milliseconds since start */
+	struct sched *due;                      /*!< Entries of the last tick run that are still to be called */
+	struct sched *root[WHEEL_ROOT_SIZE];
+	struct sched *level[WHEEL_LEVELS][WHEEL_LEVEL_SIZE];
 };
 
 struct sched_context {
@@ -65,6 +90,7 @@ struct sched_context {
 	unsigned int highwater;					/*!< highest count so far */
 	struct tris_hashtab *schedq_ht;             /*!< hash table for fast searching */
 	struct tris_heap *sched_heap;
+	struct sched_wheel *wheel;              /*!< timing wheel, used instead of sched_heap if set */
 
 #ifdef SCHED_MAX_CACHE
 	TRIS_LIST_HEAD_NOLOCK(, sched) schedc;   /*!< Cache of unused schedule structures and how many */
@@ -236,7 +262,146 @@ static int sched_time_cmp(void *a, void *b)
 	return tris_tvcmp(((struct sched *) b)->when, ((struct sched *) a)->when);
 }
 
-struct sched_context *sched_context_create(void)
+/* timing wheel routines for sched */
+
+static void slot_insert(struct sched **slot, struct sched *s)
+{
+	if ((s->wheel_next = *slot))
+		s->wheel_next->wheel_pprev = &s->wheel_next;
+	s->wheel_pprev = slot;
+	*slot = s;
+}
+
+static void slot_remove(struct sched *s)
+{
+	if ((*s->wheel_pprev = s->wheel_next))
+		s->wheel_next->wheel_pprev = s->wheel_pprev;
+	s->wheel_next = NULL;
+	s->wheel_pprev = NULL;
+}
+
+static unsigned int wheel_tick(struct sched_wheel *wheel, struct timeval t)
+{
+	return tris_tvdiff_us(t, wheel->start) / 1000;
+}
+
+/*! \brief Put an entry in the slot for its tick, relative to the next tick to run */
+static void wheel_insert(struct sched_wheel *wheel, struct sched *s)
+{
+	unsigned int expires = s->wheel_tick, idx = expires - wheel->tick;
+	int level;
+
+	if ((int) idx < 0) {
+		/* Already due, run it with the next tick */
+		slot_insert(&wheel->root[wheel->tick & WHEEL_ROOT_MASK], s);
+	} else if (idx < WHEEL_ROOT_SIZE) {
+		slot_insert(&wheel->root[expires & WHEEL_ROOT_MASK], s);
+	} else {
+		for (level = 0; level < WHEEL_LEVELS - 1; level++) {
+			if (!(idx >> (WHEEL_ROOT_BITS + (level + 1) * WHEEL_LEVEL_BITS)))
+				break;
+		}
+		slot_insert(&wheel->level[level][(expires >> (WHEEL_ROOT_BITS + level * WHEEL_LEVEL_BITS)) & WHEEL_LEVEL_MASK], s);
+	}
+}
+
+/*! \brief Move the entries of the current slot of a level to the levels below
+ * \return the index of the slot, 0 when the level above is due as well
+ */
+static int wheel_cascade(struct sched_wheel *wheel, int level)
+{
+	int index = (wheel->tick >> (WHEEL_ROOT_BITS + level * WHEEL_LEVEL_BITS)) & WHEEL_LEVEL_MASK;
+	struct sched *s = wheel->level[level][index], *next;
+
+	wheel->level[level][index] = NULL;
+	for (; s; s = next) {
+		next = s->wheel_next;
+		wheel_insert(wheel, s);
+	}
+
+	return index;
+}
+
+/*! \brief Make the entries of the next tick due, once none are left due */
+static void wheel_advance(struct sched_wheel *wheel)
+{
+	int index = wheel->tick & WHEEL_ROOT_MASK, level;
+
+	if (!index) {
+		for (level = 0; level < WHEEL_LEVELS; level++) {
+			if (wheel_cascade(wheel, level))
+				break;
+		}
+	}
+
+	if ((wheel->due = wheel->root[index])) {
+		wheel->due->wheel_pprev = &wheel->due;
+		wheel->root[index] = NULL;
+	}
+	wheel->tick++;
+}
+
+/*! \brief Milliseconds until the next tick with entries, or until the next
+ * cascade if that is sooner, since entries on the levels may then be due.
+ */
+static int wheel_wait(struct sched_wheel *wheel)
+{
+	unsigned int tick = wheel->tick;
+	int ms;
+
+	if (wheel->due)
+		return 0;
+
+	if (tick & WHEEL_ROOT_MASK) {
+		while (!wheel->root[tick & WHEEL_ROOT_MASK] && (++tick & WHEEL_ROOT_MASK));
+	}
+
+	ms = tick - wheel_tick(wheel, tris_tvnow());
+
+	return ms < 0 ? 0 : ms;
+}
+
+/*! \brief Call cb for every entry in the context, in no particular order */
+static void sched_traverse(struct sched_context *con, void (*cb)(struct sched *s, void *arg), void *arg)
+{
+	struct sched *s, *next;
+	size_t x, heap_size;
+	int i, level;
+
+	if (!con->wheel) {
+		heap_size = tris_heap_size(con->sched_heap);
+		for (x = 1; x <= heap_size; x++) {
+			cb(tris_heap_peek(con->sched_heap, x), arg);
+		}
+		return;
+	}
+
+	for (s = con->wheel->due; s; s = next) {
+		next = s->wheel_next;
+		cb(s, arg);
+	}
+	for (i = 0; i < WHEEL_ROOT_SIZE; i++) {
+		for (s = con->wheel->root[i]; s; s = next) {
+			next = s->wheel_next;
+			cb(s, arg);
+		}
+	}
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		for (i = 0; i < WHEEL_LEVEL_SIZE; i++) {
+			for (s = con->wheel->level[level][i]; s; s = next) {
+				next = s->wheel_next;
+				cb(s, arg);
+			}
+		}
+	}
+}
+
+static void sched_free_cb(struct sched *s, void *arg)
+{
+	tris_free(s);
+}
+
+struct sched_context *sched_context_create_type(enum sched_context_type type)
 {
 	struct sched_context *tmp;
 
@@ -246,6 +411,19 @@ struct sched_context *sched_context_create(void)
 	tris_mutex_init(&tmp->lock);
 	tmp->eventcnt = 1;
 
+	if (type == SCHED_CONTEXT_WHEEL) {
+		/* Only ever used with the context locked, and sized for many timers */
+		tmp->schedq_ht = tris_hashtab_create(1021, sched_cmp, tris_hashtab_resize_java, tris_hashtab_newsize_java, sched_hash, 0);
+
+		if (!(tmp->wheel = tris_calloc(1, sizeof(*tmp->wheel)))) {
+			sched_context_destroy(tmp);
+			return NULL;
+		}
+		tmp->wheel->start = tris_tvnow();
+
+		return tmp;
+	}
+
 	tmp->schedq_ht = tris_hashtab_create(23, sched_cmp, tris_hashtab_resize_java, tris_hashtab_newsize_java, sched_hash, 1);
 
 	if (!(tmp->sched_heap = tris_heap_create(8, sched_time_cmp,
@@ -257,6 +435,11 @@ struct sched_context *sched_context_create(void)
 	return tmp;
 }
 
+struct sched_context *sched_context_create(void)
+{
+	return sched_context_create_type(SCHED_CONTEXT_HEAP);
+}
+
 void sched_context_destroy(struct sched_context *con)
 {
 	struct sched *s;
@@ -277,6 +460,12 @@ void sched_context_destroy(struct sched_context *con)
 		con->sched_heap = NULL;
 	}
 
+	if (con->wheel) {
+		sched_traverse(con, sched_free_cb, NULL);
+		tris_free(con->wheel);
+		con->wheel = NULL;
+	}
+
 	tris_hashtab_destroy(con->schedq_ht, NULL);
 	con->schedq_ht = NULL;
 	
@@ -332,7 +521,9 @@ int tris_sched_wait(struct sched_context *con)
 	DEBUG(tris_debug(1, "tris_sched_wait()\n"));
 
 	tris_mutex_lock(&con->lock);
-	if ((s = tris_heap_peek(con->sched_heap, 1))) {
+	if (con->wheel) {
+		ms = con->schedcnt ? wheel_wait(con->wheel) : -1;
+	} else if ((s = tris_heap_peek(con->sched_heap, 1))) {
 		ms = tris_tvdiff_ms(s->when, tris_tvnow());
 		if (ms < 0) {
 			ms = 0;
@@ -353,7 +544,17 @@ int tris_sched_wait(struct sched_context *con)
  */
 static void schedule(struct sched_context *con, struct sched *s)
 {
-	tris_heap_push(con->sched_heap, s);
+	if (con->wheel) {
+		/* Nothing runs the ticks of an empty wheel, so catch up first */
+		if (!con->schedcnt) {
+			con->wheel->tick = wheel_tick(con->wheel, tris_tvnow());
+		}
+		/* Round up, so that entries run at most 1 ms early as with the heap */
+		s->wheel_tick = wheel_tick(con->wheel, tris_tvadd(s->when, tris_tv(0, 999)));
+		wheel_insert(con->wheel, s);
+	} else {
+		tris_heap_push(con->sched_heap, s);
+	}
 
 	if (!tris_hashtab_insert_safe(con->schedq_ht, s)) {
 		tris_log(LOG_WARNING,"Schedule Queue entry %d is already in table!\n", s->id);
@@ -444,11 +645,14 @@ int tris_sched_add(struct sched_context *con, int when, tris_sched_cb callback,
 const void *tris_sched_find_data(struct sched_context *con, int id)
 {
 	struct sched tmp,*res;
+	const void *data = NULL;
 	tmp.id = id;
+	tris_mutex_lock(&con->lock);
 	res = tris_hashtab_lookup(con->schedq_ht, &tmp);
 	if (res)
-		return res->data;
-	return NULL;
+		data = res->data;
+	tris_mutex_unlock(&con->lock);
+	return data;
 }
 	
 /*! \brief
@@ -472,7 +676,9 @@ int _tris_sched_del(struct sched_context *con, int id, const char *file, int lin
 	tris_mutex_lock(&con->lock);
 	s = tris_hashtab_lookup(con->schedq_ht, &tmp);
 	if (s) {
-		if (!tris_heap_remove(con->sched_heap, s)) {
+		if (con->wheel) {
+			slot_remove(s);
+		} else if (!tris_heap_remove(con->sched_heap, s)) {
 			tris_log(LOG_WARNING,"sched entry %d not in the sched heap?\n", s->id);
 		}
 
@@ -505,34 +711,40 @@ int _tris_sched_del(struct sched_context *con, int id, const char *file, int lin
 	return 0;
 }
 
+struct sched_report_args {
+	struct tris_cb_names *cbnames;
+	int *countlist;
+};
+
+static void sched_report_cb(struct sched *cur, void *arg)
+{
+	struct sched_report_args *args = arg;
+	struct tris_cb_names *cbnames = args->cbnames;
+	int i;
+
+	/* match the callback to the cblist */
+	for (i = 0; i < cbnames->numassocs; i++) {
+		if (cur->callback == cbnames->cblist[i]) {
+			break;
+		}
+	}
+	args->countlist[i]++;
+}
+
 void tris_sched_report(struct sched_context *con, struct tris_str **buf, struct tris_cb_names *cbnames)
 {
-	int i, x;
-	struct sched *cur;
+	int i;
 	int countlist[cbnames->numassocs + 1];
-	size_t heap_size;
+	struct sched_report_args args = {
+		.cbnames = cbnames,
+		.countlist = countlist,
+	};
 	
 	memset(countlist, 0, sizeof(countlist));
 	tris_str_set(buf, 0, " Highwater = %d\n schedcnt = %d\n", con->highwater, con->schedcnt);
 
 	tris_mutex_lock(&con->lock);
-
-	heap_size = tris_heap_size(con->sched_heap);
-	for (x = 1; x <= heap_size; x++) {
-		cur = tris_heap_peek(con->sched_heap, x);
-		/* match the callback to the cblist */
-		for (i = 0; i < cbnames->numassocs; i++) {
-			if (cur->callback == cbnames->cblist[i]) {
-				break;
-			}
-		}
-		if (i < cbnames->numassocs) {
-			countlist[i]++;
-		} else {
-			countlist[cbnames->numassocs]++;
-		}
-	}
-
+	sched_traverse(con, sched_report_cb, &args);
 	tris_mutex_unlock(&con->lock);
 
 	for (i = 0; i < cbnames->numassocs; i++) {
@@ -542,13 +754,23 @@ void tris_sched_report(struct sched_context *con, struct tris_str **buf, struct
 	tris_str_append(buf, 0, "   <unknown> : %d\n", countlist[cbnames->numassocs]);
 }
 	
+static void sched_dump_cb(struct sched *q, void *arg)
+{
+	struct timeval *when = arg;
+	struct timeval delta = tris_tvsub(q->when, *when);
+
+	tris_debug(1, "|%.4d | %-15p | %-15p | %.6ld : %.6ld |\n", 
+		q->id,
+		q->callback,
+		q->data,
+		(long)delta.tv_sec,
+		(long int)delta.tv_usec);
+}
+
 /*! \brief Dump the contents of the scheduler to LOG_DEBUG */
 void tris_sched_dump(struct sched_context *con)
 {
-	struct sched *q;
 	struct timeval when = tris_tvnow();
-	int x;
-	size_t heap_size;
 #ifdef SCHED_MAX_CACHE
 	tris_debug(1, "Trismedia Schedule Dump (%d in Q, %d Total, %d Cache, %d high-water)\n", con->schedcnt, con->eventcnt - 1, con->schedccnt, con->highwater);
 #else
@@ -559,22 +781,43 @@ void tris_sched_dump(struct sched_context *con)
 	tris_debug(1, "|ID    Callback          Data              Time  (sec:ms)   |\n");
 	tris_debug(1, "+-----+-----------------+-----------------+-----------------+\n");
 	tris_mutex_lock(&con->lock);
-	heap_size = tris_heap_size(con->sched_heap);
-	for (x = 1; x <= heap_size; x++) {
-		struct timeval delta;
-		q = tris_heap_peek(con->sched_heap, x);
-		delta = tris_tvsub(q->when, when);
-		tris_debug(1, "|%.4d | %-15p | %-15p | %.6ld : %.6ld |\n", 
-			q->id,
-			q->callback,
-			q->data,
-			(long)delta.tv_sec,
-			(long int)delta.tv_usec);
-	}
+	sched_traverse(con, sched_dump_cb, &when);
 	tris_mutex_unlock(&con->lock);
 	tris_debug(1, "=============================================================\n");
 }
 
+/*! \brief
+ * Take the next event due before when out of the queue.
+ */
+static struct sched *sched_pop_due(struct sched_context *con, struct timeval when)
+{
+	struct sched_wheel *wheel = con->wheel;
+	struct sched *current;
+	unsigned int now;
+
+	if (!wheel) {
+		if (!(current = tris_heap_peek(con->sched_heap, 1)) || tris_tvcmp(current->when, when) != -1) {
+			return NULL;
+		}
+		return tris_heap_pop(con->sched_heap);
+	}
+
+	now = wheel_tick(wheel, when);
+	while (!wheel->due && (int) (now - wheel->tick) >= 0) {
+		if (!con->schedcnt) {
+			wheel->tick = now + 1;
+			break;
+		}
+		wheel_advance(wheel);
+	}
+
+	if ((current = wheel->due)) {
+		slot_remove(current);
+	}
+
+	return current;
+}
+
 /*! \brief
  * Launch all events which need to be run at this time.
  */
@@ -590,17 +833,12 @@ int tris_sched_runq(struct sched_context *con)
 	tris_mutex_lock(&con->lock);
 
 	when = tris_tvadd(tris_tvnow(), tris_tv(0, 1000));
-	for (numevents = 0; (current = tris_heap_peek(con->sched_heap, 1)); numevents++) {
-		/* schedule all events which are going to expire within 1ms.
-		 * We only care about millisecond accuracy anyway, so this will
-		 * help us get more than one event at one time if they are very
-		 * close together.
-		 */
-		if (tris_tvcmp(current->when, when) != -1) {
-			break;
-		}
-		
-		current = tris_heap_pop(con->sched_heap);
+	/* schedule all events which are going to expire within 1ms.
+	 * We only care about millisecond accuracy anyway, so this will
+	 * help us get more than one event at one time if they are very
+	 * close together.
+	 */
+	for (numevents = 0; (current = sched_pop_due(con, when)); numevents++) {
 
 		if (!tris_hashtab_remove_this_object(con->schedq_ht, current)) {
 			tris_log(LOG_ERROR,"Sched entry %d was in the schedq list but not in the hashtab???\n", current->id);
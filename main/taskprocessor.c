@@ -34,12 +34,13 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 185947 $")
 #include "trismedia/time.h"
 #include "trismedia/astobj2.h"
 #include "trismedia/cli.h"
+#include "trismedia/threadstorage.h"
 #include "trismedia/taskprocessor.h"
 
 
 /*! \brief tps_task structure is queued to a taskprocessor
  *
- * tps_tasks are processed in FIFO order and freed by the taskprocessing
+ * tps_tasks are processed in FIFO order and returned to the task pool by the taskprocessing
  * thread after the task handler returns.  The callback function that is assigned
  * to the execute() function pointer is responsible for releasing datap resources if necessary. */
 struct tps_task {
@@ -47,18 +48,47 @@ struct tps_task {
 	int (*execute)(void *datap);
 	/*! \brief The data pointer for the task execute() function */
 	void *datap;
-	/*! \brief TRIS_LIST_ENTRY overhead */
-	TRIS_LIST_ENTRY(tps_task) list;
+	/*! \brief When the task was pushed, if it is sampled for the enqueue latency statistics */
+	struct timeval queued;
+	/*! \brief Next task in the taskprocessor queue or in the task pool */
+	struct tps_task *volatile next;
 };
 
+/*! \brief Number of enqueue latency buckets: under 10us, 100us, 1ms, 10ms, 100ms, and longer */
+#define TPS_LATENCY_BUCKETS 6
+
+/*! \brief One in this many tasks pushed by a thread has its enqueue latency measured */
+#define TPS_LATENCY_SAMPLE 16
+
 /*! \brief tps_taskprocessor_stats maintain statistics for a taskprocessor. */
 struct tps_taskprocessor_stats {
 	/*! \brief This is the maximum number of tasks queued at any one time */
 	unsigned long max_qsize;
 	/*! \brief This is the current number of tasks processed */
 	unsigned long _tasks_processed_count;
+	/*! \brief Number of sampled tasks by the time they spent queued before they were run */
+	unsigned long latency[TPS_LATENCY_BUCKETS];
+};
+
+/*! \brief A task queue that any number of threads push to, and one thread at a time runs */
+struct tps_queue {
+	/*! \brief Number of tasks queued, counted before a task is linked in */
+	volatile int size;
+	/*! \brief Oldest task in the queue, only used by the thread running the queue */
+	struct tps_task *head;
+	/*! \brief Newest task in the queue, pushing threads swap their task in here */
+	struct tps_task *volatile tail;
+	/*! \brief Placeholder task that keeps the queue from ever being empty */
+	struct tps_task stub;
+	/*! \brief The taskprocessor the queue belongs to */
+	struct tris_taskprocessor *tps;
+	/*! \brief Entry in the worker pool's list of queues with tasks to run */
+	TRIS_LIST_ENTRY(tps_queue) list;
 };
 
+/*! \brief Number of queues the keys pushed to a pooled taskprocessor are spread over */
+#define TPS_POOL_QUEUES 32
+
 /*! \brief A tris_taskprocessor structure is a singleton by name */
 struct tris_taskprocessor {
 	/*! \brief Friendly name of the taskprocessor */
@@ -73,14 +103,44 @@ struct tris_taskprocessor {
 	unsigned char poll_thread_run;
 	/*! \brief Taskprocessor statistics */
 	struct tps_taskprocessor_stats *stats;
-	/*! \brief Taskprocessor current queue size */
-	long tps_queue_size;
-	/*! \brief Taskprocessor queue */
-	TRIS_LIST_HEAD_NOLOCK(tps_queue, tps_task) tps_queue;
+	/*! \brief Taskprocessor queue, run by poll_thread */
+	struct tps_queue tps_queue;
+	/*! \brief Taskprocessor queues by key, run by the worker pool if the taskprocessor is pooled */
+	struct tps_queue *pool_queues;
+	/*! \brief Number of pool_queues waiting for or being run by a pool worker */
+	volatile int pool_busy;
 	/*! \brief Taskprocessor singleton list entry */
 	TRIS_LIST_ENTRY(tris_taskprocessor) list;
 };
 #define TPS_MAX_BUCKETS 7
+
+/*! \brief Most tasks run by a taskprocessor thread before it updates the queue size and task pool */
+#define TPS_BATCH_MAX 256
+
+/*! \brief Most idle tasks kept for reuse, across all taskprocessors */
+#define TPS_TASK_POOL_MAX 4096
+
+/*! \brief Most worker threads started for pooled taskprocessors */
+#define TPS_POOL_MAX_WORKERS 32
+
+/*! \brief Queues of pooled taskprocessors that have tasks to run, oldest first */
+static TRIS_LIST_HEAD_STATIC(tps_pool_ready, tps_queue);
+
+/*! \brief Signalled when a queue is added to tps_pool_ready */
+static tris_cond_t tps_pool_cond;
+
+/*! \brief Broadcast when the pool_busy of a taskprocessor drops to zero, or the workers stop */
+static tris_cond_t tps_pool_idle_cond;
+
+/*! \brief Number of worker threads running the queues of pooled taskprocessors */
+static int tps_pool_workers;
+
+/*! \brief The pool worker threads, joined at shutdown */
+static pthread_t tps_pool_threads[TPS_POOL_MAX_WORKERS];
+
+/*! \brief Set at shutdown, the pool workers exit once the ready queues are run */
+static int tps_pool_stop;
+
 /*! \brief tps_singletons is the astobj2 container for taskprocessor singletons */
 static struct ao2_container *tps_singletons;
 
@@ -104,12 +164,18 @@ static void tps_taskprocessor_destroy(void *tps);
 /*! \brief CLI <example>taskprocessor ping &lt;blah&gt;</example> handler function */
 static int tps_ping_handler(void *datap);
 
-/*! \brief Remove the front task off the taskprocessor queue */
-static struct tps_task *tps_taskprocessor_pop(struct tris_taskprocessor *tps);
+/*! \brief Remove the front task off a taskprocessor queue */
+static struct tps_task *tps_taskprocessor_pop(struct tps_queue *queue);
+
+/*! \brief Link a task in at the back of a taskprocessor queue */
+static void tps_taskprocessor_link(struct tps_queue *queue, struct tps_task *task);
 
 /*! \brief Return the size of the taskprocessor queue */
 static int tps_taskprocessor_depth(struct tris_taskprocessor *tps);
 
+/*! \brief Stop the worker threads of pooled taskprocessors at shutdown */
+static void tps_pool_shutdown(void);
+
 static char *cli_tps_ping(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a);
 static char *cli_tps_report(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a);
 
@@ -127,19 +193,118 @@ int tris_tps_init(void)
 	}
 
 	tris_cond_init(&cli_ping_cond, NULL);
+	tris_cond_init(&tps_pool_cond, NULL);
+	tris_cond_init(&tps_pool_idle_cond, NULL);
 
 	tris_cli_register_multiple(taskprocessor_clis, ARRAY_LEN(taskprocessor_clis));
+	tris_register_atexit(tps_pool_shutdown);
 	return 0;
 }
 
+#ifdef HAVE_GCC_ATOMICS
+/* atomically replace *p with task and return what was there */
+static inline struct tps_task *tps_task_swap(struct tps_task *volatile *p, struct tps_task *task)
+{
+	/* __sync_lock_test_and_set() is only an acquire barrier */
+	__sync_synchronize();
+	return __sync_lock_test_and_set(p, task);
+}
+
+/* atomically replace *p with task if it still is old */
+static inline int tps_task_cas(struct tps_task *volatile *p, struct tps_task *old, struct tps_task *task)
+{
+	return __sync_bool_compare_and_swap(p, old, task);
+}
+#else
+TRIS_MUTEX_DEFINE_STATIC(tps_atomic_lock);
+
+static struct tps_task *tps_task_swap(struct tps_task *volatile *p, struct tps_task *task)
+{
+	struct tps_task *old;
+
+	tris_mutex_lock(&tps_atomic_lock);
+	old = *p;
+	*p = task;
+	tris_mutex_unlock(&tps_atomic_lock);
+	return old;
+}
+
+static int tps_task_cas(struct tps_task *volatile *p, struct tps_task *old, struct tps_task *task)
+{
+	int res;
+
+	tris_mutex_lock(&tps_atomic_lock);
+	if ((res = (*p == old))) {
+		*p = task;
+	}
+	tris_mutex_unlock(&tps_atomic_lock);
+	return res;
+}
+#endif
+
+#if !defined(LOW_MEMORY)
+/*! \brief Tasks handed back by the taskprocessor threads
+ *
+ * Taskprocessor threads push their finished tasks on here, and a pushing thread
+ * whose cache is empty takes the whole list at once.  Nothing is ever popped
+ * off one by one, so the list is not open to the ABA problem. */
+static struct tps_task *volatile tps_task_pool;
+
+/*! \brief Number of tasks in tps_task_pool and in the per-thread caches */
+static volatile int tps_task_pool_count;
+
+struct tps_task_cache {
+	struct tps_task *head;
+	/*! \brief Tasks pushed by this thread, to pick the ones to sample */
+	unsigned int pushed;
+};
+
+static void tps_task_cache_cleanup(void *data);
+
+/*! \brief A per-thread cache of tasks taken from the task pool */
+TRIS_THREADSTORAGE_CUSTOM(tps_task_cache, NULL, tps_task_cache_cleanup);
+
+static void tps_task_cache_cleanup(void *data)
+{
+	struct tps_task_cache *cache = data;
+	struct tps_task *t;
+
+	while ((t = cache->head)) {
+		cache->head = t->next;
+		tris_atomic_fetchadd_int(&tps_task_pool_count, -1);
+		tris_free(t);
+	}
+	tris_free(cache);
+}
+#endif
+
 /* allocate resources for the task */
 static struct tps_task *tps_task_alloc(int (*task_exe)(void *datap), void *datap)
 {
-	struct tps_task *t;
-	if ((t = tris_calloc(1, sizeof(*t)))) {
-		t->execute = task_exe;
-		t->datap = datap;
+	struct tps_task *t = NULL;
+	int sample = 1;
+#if !defined(LOW_MEMORY)
+	struct tps_task_cache *cache;
+
+	if ((cache = tris_threadstorage_get(&tps_task_cache, sizeof(*cache)))) {
+		/* reading the clock twice per task would cost more than the queue itself */
+		sample = !(cache->pushed++ % TPS_LATENCY_SAMPLE);
+		if (!cache->head && tps_task_pool) {
+			cache->head = tps_task_swap(&tps_task_pool, NULL);
+		}
+		if ((t = cache->head)) {
+			cache->head = t->next;
+			tris_atomic_fetchadd_int(&tps_task_pool_count, -1);
+		}
+	}
+#endif
+	if (!t && !(t = tris_malloc(sizeof(*t)))) {
+		return NULL;
 	}
+	t->execute = task_exe;
+	t->datap = datap;
+	t->queued = sample ? tris_tvnow() : tris_tv(0, 0);
+	t->next = NULL;
 	return t;
 }
 
@@ -152,6 +317,38 @@ static void *tps_task_free(struct tps_task *task)
 	return NULL;
 }
 
+/* hand a chain of count finished tasks, first to last, back to the task pool */
+static void tps_task_release(struct tps_task *first, struct tps_task *last, int count)
+{
+#if !defined(LOW_MEMORY)
+	struct tps_task *head;
+
+	if (tris_atomic_fetchadd_int(&tps_task_pool_count, count) + count <= TPS_TASK_POOL_MAX) {
+		do {
+			head = tps_task_pool;
+			last->next = head;
+		} while (!tps_task_cas(&tps_task_pool, head, first));
+		return;
+	}
+	tris_atomic_fetchadd_int(&tps_task_pool_count, -count);
+#endif
+	while (first) {
+		last = first->next;
+		tps_task_free(first);
+		first = last;
+	}
+}
+
+/* account for the time a task spent queued */
+static void tps_taskprocessor_latency(unsigned long *latency, struct tps_task *task)
+{
+	int64_t us = tris_tvdiff_us(tris_tvnow(), task->queued);
+	int bucket, limit;
+
+	for (bucket = 0, limit = 10; bucket < TPS_LATENCY_BUCKETS - 1 && us >= limit; bucket++, limit *= 10);
+	latency[bucket]++;
+}
+
 /* taskprocessor tab completion */
 static char *tps_taskprocessor_tab_complete(struct tris_taskprocessor *p, struct tris_cli_args *a) 
 {
@@ -259,24 +456,86 @@ static char *cli_tps_report(struct tris_cli_entry *e, int cmd, struct tris_cli_a
 	tris_cli(a->fd, "\n\t+----- Processor -----+--- Processed ---+- In Queue -+- Max Depth -+");
 	i = ao2_iterator_init(tps_singletons, 0);
 	while ((p = ao2_iterator_next(&i))) {
-		tris_copy_string(name, p->name, sizeof(name));
-		qsize = p->tps_queue_size;
+		snprintf(name, sizeof(name), "%s%s", p->name, p->pool_queues ? "*" : "");
+		qsize = tps_taskprocessor_depth(p);
 		maxqsize = p->stats->max_qsize;
 		processed = p->stats->_tasks_processed_count;
 		tris_cli(a->fd, "\n%24s   %17ld %12ld %12ld", name, processed, qsize, maxqsize);
 		ao2_ref(p, -1);
 	}
 	tcount = ao2_container_count(tps_singletons); 
-	tris_cli(a->fd, "\n\t+---------------------+-----------------+------------+-------------+\n\t%d taskprocessors\n\n", tcount);
+	tris_cli(a->fd, "\n\t+---------------------+-----------------+------------+-------------+\n\t%d taskprocessors", tcount);
+	if (tps_pool_workers) {
+		tris_cli(a->fd, ", * runs on the pool of %d worker threads", tps_pool_workers);
+	}
+	tris_cli(a->fd, "\n\n");
+
+	tris_cli(a->fd, "\t+----- Processor -----+----------- Enqueue Latency, 1 in %d tasks ------------+", TPS_LATENCY_SAMPLE);
+	tris_cli(a->fd, "\n\t                          <10us   <100us     <1ms    <10ms   <100ms  >=100ms");
+	i = ao2_iterator_init(tps_singletons, 0);
+	while ((p = ao2_iterator_next(&i))) {
+		unsigned long *latency = p->stats->latency;
+
+		tris_cli(a->fd, "\n%24s   %8lu %8lu %8lu %8lu %8lu %8lu", p->name,
+			latency[0], latency[1], latency[2], latency[3], latency[4], latency[5]);
+		ao2_ref(p, -1);
+	}
+	tris_cli(a->fd, "\n\t+---------------------+---------------------------------------------------------+\n\n");
 	return CLI_SUCCESS;	
 }
 
+/* run a batch of the tasks in the queue without taking any lock, and
+ * return how many tasks are left in it */
+static int tps_queue_run(struct tps_queue *queue)
+{
+	struct tris_taskprocessor *i = queue->tps;
+	struct tps_task *t, *done = NULL, *last = NULL;
+	unsigned long latency[TPS_LATENCY_BUCKETS] = { 0, };
+	int size = queue->size, count, x;
+
+	for (count = 0; count < TPS_BATCH_MAX && (t = tps_taskprocessor_pop(queue)); count++) {
+		if (!t->execute) {
+			tris_log(LOG_WARNING, "Task is missing a function to execute!\n");
+		} else if (i->poll_thread_run) {
+			if (!tris_tvzero(t->queued)) {
+				tps_taskprocessor_latency(latency, t);
+			}
+			t->execute(t->datap);
+		}
+		t->next = done;
+		done = t;
+		if (!last) {
+			last = t;
+		}
+	}
+	if (!count) {
+		/* a pushing thread has counted its task but not linked it in yet */
+		sched_yield();
+		return size;
+	}
+	/* the queues of a pooled taskprocessor are run at the same time */
+	if (i->pool_queues) {
+		tris_mutex_lock(&i->taskprocessor_lock);
+	}
+	i->stats->_tasks_processed_count += count;
+	if (size > i->stats->max_qsize) {
+		i->stats->max_qsize = size;
+	}
+	for (x = 0; x < TPS_LATENCY_BUCKETS; x++) {
+		i->stats->latency[x] += latency[x];
+	}
+	if (i->pool_queues) {
+		tris_mutex_unlock(&i->taskprocessor_lock);
+	}
+	tps_task_release(done, last, count);
+	return tris_atomic_fetchadd_int(&queue->size, -count) - count;
+}
+
 /* this is the task processing worker function */
 static void *tps_processing_function(void *data)
 {
 	struct tris_taskprocessor *i = data;
 	struct tps_task *t;
-	int size;
 
 	if (!i) {
 		tris_log(LOG_ERROR, "cannot start thread_function loop without a tris_taskprocessor structure.\n");
@@ -284,48 +543,110 @@ static void *tps_processing_function(void *data)
 	}
 
 	while (i->poll_thread_run) {
- 		tris_mutex_lock(&i->taskprocessor_lock);
- 		if (!i->poll_thread_run) {
-  			tris_mutex_unlock(&i->taskprocessor_lock);
- 			break;
-  		}
- 		if (!(size = tps_taskprocessor_depth(i))) {
- 			tris_cond_wait(&i->poll_cond, &i->taskprocessor_lock);
-  			if (!i->poll_thread_run) {
-  				tris_mutex_unlock(&i->taskprocessor_lock);
-	  			break;
+		if (!tps_taskprocessor_depth(i)) {
+			/* tris_taskprocessor_push() only signals when it finds the queue empty */
+			tris_mutex_lock(&i->taskprocessor_lock);
+			while (!tps_taskprocessor_depth(i) && i->poll_thread_run) {
+				tris_cond_wait(&i->poll_cond, &i->taskprocessor_lock);
 			}
-  		}
-  		tris_mutex_unlock(&i->taskprocessor_lock);
- 		/* stuff is in the queue */
- 		if (!(t = tps_taskprocessor_pop(i))) {
- 			tris_log(LOG_ERROR, "Wtf?? %d tasks in the queue, but we're popping blanks!\n", size);
- 			continue;
- 		}
- 		if (!t->execute) {
- 			tris_log(LOG_WARNING, "Task is missing a function to execute!\n");
- 			tps_task_free(t);
- 			continue;
- 		}
- 		t->execute(t->datap);
- 
- 		tris_mutex_lock(&i->taskprocessor_lock);
- 		if (i->stats) {
- 			i->stats->_tasks_processed_count++;
- 			if (size > i->stats->max_qsize) {
- 				i->stats->max_qsize = size;
- 			}
- 		}
- 		tris_mutex_unlock(&i->taskprocessor_lock);
- 
- 		tps_task_free(t);
-  	}
-	while ((t = tps_taskprocessor_pop(i))) {
+			tris_mutex_unlock(&i->taskprocessor_lock);
+			continue;
+		}
+		/* stuff is in the queue */
+		tps_queue_run(&i->tps_queue);
+	}
+	while ((t = tps_taskprocessor_pop(&i->tps_queue))) {
 		tps_task_free(t);
 	}
 	return NULL;
 }
 
+/* put a queue of a pooled taskprocessor at the back of the line for the workers */
+static void tps_pool_schedule(struct tps_queue *queue)
+{
+	TRIS_LIST_LOCK(&tps_pool_ready);
+	TRIS_LIST_INSERT_TAIL(&tps_pool_ready, queue, list);
+	tris_cond_signal(&tps_pool_cond);
+	TRIS_LIST_UNLOCK(&tps_pool_ready);
+}
+
+/* the worker threads of pooled taskprocessors.  A queue is only ever on the
+ * ready list once, so only one worker at a time runs it and its tasks run in
+ * order.  Different queues of the same taskprocessor run in parallel. */
+static void *tps_pool_worker(void *data)
+{
+	struct tps_queue *queue;
+	struct tris_taskprocessor *tps;
+	int left;
+
+	TRIS_LIST_LOCK(&tps_pool_ready);
+	for (;;) {
+		while (!(queue = TRIS_LIST_REMOVE_HEAD(&tps_pool_ready, list)) && !tps_pool_stop) {
+			tris_cond_wait(&tps_pool_cond, &tps_pool_ready.lock);
+		}
+		if (!queue) {
+			break;
+		}
+		TRIS_LIST_UNLOCK(&tps_pool_ready);
+
+		tps = queue->tps;
+		left = tps_queue_run(queue);
+
+		TRIS_LIST_LOCK(&tps_pool_ready);
+		if (left) {
+			/* let the other queues have a turn before running the rest */
+			TRIS_LIST_INSERT_TAIL(&tps_pool_ready, queue, list);
+		} else if (tris_atomic_dec_and_test(&tps->pool_busy)) {
+			/* the taskprocessor may be destroyed as soon as this is seen */
+			tris_cond_broadcast(&tps_pool_idle_cond);
+		}
+	}
+	TRIS_LIST_UNLOCK(&tps_pool_ready);
+
+	return NULL;
+}
+
+/* start the worker threads of pooled taskprocessors, one per processor */
+static int tps_pool_start(void)
+{
+	int count;
+
+	if (tps_pool_workers || tps_pool_stop) {
+		return tps_pool_stop ? -1 : 0;
+	}
+	count = sysconf(_SC_NPROCESSORS_ONLN);
+	count = MIN(MAX(count, 2), TPS_POOL_MAX_WORKERS);
+	while (tps_pool_workers < count) {
+		if (tris_pthread_create_background(&tps_pool_threads[tps_pool_workers], NULL, tps_pool_worker, NULL)) {
+			tris_log(LOG_ERROR, "Unable to start taskprocessor pool worker thread\n");
+			break;
+		}
+		tps_pool_workers++;
+	}
+	return tps_pool_workers ? 0 : -1;
+}
+
+/* stop the worker threads of pooled taskprocessors once they have run the ready queues */
+static void tps_pool_shutdown(void)
+{
+	int x;
+
+	TRIS_LIST_LOCK(&tps_pool_ready);
+	tps_pool_stop = 1;
+	tris_cond_broadcast(&tps_pool_cond);
+	TRIS_LIST_UNLOCK(&tps_pool_ready);
+
+	for (x = 0; x < tps_pool_workers; x++) {
+		pthread_join(tps_pool_threads[x], NULL);
+	}
+
+	/* nothing runs the pool queues any more, don't keep their taskprocessors waiting */
+	TRIS_LIST_LOCK(&tps_pool_ready);
+	tps_pool_workers = 0;
+	tris_cond_broadcast(&tps_pool_idle_cond);
+	TRIS_LIST_UNLOCK(&tps_pool_ready);
+}
+
 /* hash callback for astobj2 */
 static int tps_hash_cb(const void *obj, const int flags)
 {
@@ -357,8 +678,28 @@ static void tps_taskprocessor_destroy(void *tps)
 	t->poll_thread_run = 0;
 	tris_cond_signal(&t->poll_cond);
 	tris_mutex_unlock(&t->taskprocessor_lock);
-	pthread_join(t->poll_thread, NULL);
-	t->poll_thread = TRIS_PTHREADT_NULL;
+	if (t->poll_thread != TRIS_PTHREADT_NULL) {
+		pthread_join(t->poll_thread, NULL);
+		t->poll_thread = TRIS_PTHREADT_NULL;
+	}
+	if (t->pool_queues) {
+		int x;
+		struct tps_task *task;
+
+		/* the workers release the queued tasks without running them now */
+		TRIS_LIST_LOCK(&tps_pool_ready);
+		while (t->pool_busy && tps_pool_workers) {
+			tris_cond_wait(&tps_pool_idle_cond, &tps_pool_ready.lock);
+		}
+		TRIS_LIST_UNLOCK(&tps_pool_ready);
+		for (x = 0; x < TPS_POOL_QUEUES; x++) {
+			while ((task = tps_taskprocessor_pop(&t->pool_queues[x]))) {
+				tps_task_free(task);
+			}
+		}
+		tris_free(t->pool_queues);
+		t->pool_queues = NULL;
+	}
 	tris_mutex_destroy(&t->taskprocessor_lock);
 	tris_cond_destroy(&t->poll_cond);
 	/* free it */
@@ -369,26 +710,73 @@ static void tps_taskprocessor_destroy(void *tps)
 	tris_free(t->name);
 }
 
-/* pop the front task and return it */
-static struct tps_task *tps_taskprocessor_pop(struct tris_taskprocessor *tps)
+/* set up an empty queue */
+static void tps_queue_init(struct tps_queue *queue, struct tris_taskprocessor *tps)
 {
-	struct tps_task *task;
+	queue->head = queue->tail = &queue->stub;
+	queue->tps = tps;
+}
 
-	if (!tps) {
-		tris_log(LOG_ERROR, "missing taskprocessor\n");
+/* link the task in at the back of the queue, any number of threads may do this at once */
+static void tps_taskprocessor_link(struct tps_queue *queue, struct tps_task *task)
+{
+	struct tps_task *prev;
+
+	task->next = NULL;
+	prev = tps_task_swap(&queue->tail, task);
+	/* until this is set, the thread running the queue sees it end at prev */
+	prev->next = task;
+}
+
+/* pop the front task and return it, only the thread running the queue may do this */
+static struct tps_task *tps_taskprocessor_pop(struct tps_queue *queue)
+{
+	struct tps_task *task, *next;
+
+	if (!queue) {
+		tris_log(LOG_ERROR, "missing taskprocessor queue\n");
 		return NULL;
 	}
-	tris_mutex_lock(&tps->taskprocessor_lock);
-	if ((task = TRIS_LIST_REMOVE_HEAD(&tps->tps_queue, list))) {
-		tps->tps_queue_size--;
+	task = queue->head;
+	next = task->next;
+	if (task == &queue->stub) {
+		if (!next) {
+			return NULL;
+		}
+		queue->head = task = next;
+		next = next->next;
 	}
-	tris_mutex_unlock(&tps->taskprocessor_lock);
-	return task;
+	if (next) {
+		queue->head = next;
+		return task;
+	}
+	if (task != queue->tail) {
+		/* a pushing thread is in the middle of linking in the next task */
+		return NULL;
+	}
+	/* put the stub back behind the last task so it can be taken off */
+	tps_taskprocessor_link(queue, &queue->stub);
+	if ((next = task->next)) {
+		queue->head = next;
+		return task;
+	}
+	return NULL;
 }
 
 static int tps_taskprocessor_depth(struct tris_taskprocessor *tps)
 {
-	return (tps) ? tps->tps_queue_size : -1;
+	int x, depth = 0;
+
+	if (!tps) {
+		return -1;
+	}
+	if (!tps->pool_queues) {
+		return tps->tps_queue.size;
+	}
+	for (x = 0; x < TPS_POOL_QUEUES; x++) {
+		depth += tps->pool_queues[x].size;
+	}
+	return depth;
 }
 
 /* taskprocessor name accessor */
@@ -434,6 +822,8 @@ struct tris_taskprocessor *tris_taskprocessor_get(char *name, enum tris_tps_opti
 
 	tris_cond_init(&p->poll_cond, NULL);
 	tris_mutex_init(&p->taskprocessor_lock);
+	tps_queue_init(&p->tps_queue, p);
+	p->poll_thread = TRIS_PTHREADT_NULL;
 
 	if (!(p->stats = tris_calloc(1, sizeof(*p->stats)))) {
 		ao2_unlock(tps_singletons);
@@ -447,8 +837,19 @@ struct tris_taskprocessor *tris_taskprocessor_get(char *name, enum tris_tps_opti
 		return NULL;
 	}
 	p->poll_thread_run = 1;
-	p->poll_thread = TRIS_PTHREADT_NULL;
-	if (tris_pthread_create(&p->poll_thread, NULL, tps_processing_function, p) < 0) {
+	if (create & TPS_POOLED) {
+		int x;
+
+		if (tps_pool_start() || !(p->pool_queues = tris_calloc(TPS_POOL_QUEUES, sizeof(*p->pool_queues)))) {
+			ao2_unlock(tps_singletons);
+			tris_log(LOG_ERROR, "Taskprocessor '%s' failed to set up its pool queues.\n", p->name);
+			ao2_ref(p, -1);
+			return NULL;
+		}
+		for (x = 0; x < TPS_POOL_QUEUES; x++) {
+			tps_queue_init(&p->pool_queues[x], p);
+		}
+	} else if (tris_pthread_create(&p->poll_thread, NULL, tps_processing_function, p) < 0) {
 		ao2_unlock(tps_singletons);
 		tris_log(LOG_ERROR, "Taskprocessor '%s' failed to create the processing thread.\n", p->name);
 		ao2_ref(p, -1);
@@ -478,24 +879,54 @@ void *tris_taskprocessor_unreference(struct tris_taskprocessor *tps)
 	return NULL;
 }
 
-/* push the task into the taskprocessor queue */	
-int tris_taskprocessor_push(struct tris_taskprocessor *tps, int (*task_exe)(void *datap), void *datap)
+/* push the task into one of the taskprocessor queues */
+static int tps_taskprocessor_push(struct tris_taskprocessor *tps, struct tps_queue *queue, int (*task_exe)(void *datap), void *datap)
 {
 	struct tps_task *t;
 
-	if (!tps || !task_exe) {
-		tris_log(LOG_ERROR, "%s is missing!!\n", (tps) ? "task callback" : "taskprocessor");
-		return -1;
-	}
 	if (!(t = tps_task_alloc(task_exe, datap))) {
 		tris_log(LOG_ERROR, "failed to allocate task!  Can't push to '%s'\n", tps->name);
 		return -1;
 	}
+	/* Count the task before linking it in, so the queue is never left idle
+	 * with a task in it.  A queue only goes idle once the count drops to
+	 * zero, so that is the only time it needs waking up. */
+	if (tris_atomic_fetchadd_int(&queue->size, 1)) {
+		tps_taskprocessor_link(queue, t);
+		return 0;
+	}
+	tps_taskprocessor_link(queue, t);
+	if (tps->pool_queues) {
+		tris_atomic_fetchadd_int(&tps->pool_busy, 1);
+		tps_pool_schedule(queue);
+		return 0;
+	}
 	tris_mutex_lock(&tps->taskprocessor_lock);
-	TRIS_LIST_INSERT_TAIL(&tps->tps_queue, t, list);
-	tps->tps_queue_size++;
 	tris_cond_signal(&tps->poll_cond);
 	tris_mutex_unlock(&tps->taskprocessor_lock);
 	return 0;
 }
 
+/* push the task into the taskprocessor queue */	
+int tris_taskprocessor_push(struct tris_taskprocessor *tps, int (*task_exe)(void *datap), void *datap)
+{
+	if (!tps || !task_exe) {
+		tris_log(LOG_ERROR, "%s is missing!!\n", (tps) ? "task callback" : "taskprocessor");
+		return -1;
+	}
+	return tps_taskprocessor_push(tps, tps->pool_queues ? &tps->pool_queues[0] : &tps->tps_queue, task_exe, datap);
+}
+
+/* push the task into the taskprocessor queue for the key */
+int tris_taskprocessor_push_keyed(struct tris_taskprocessor *tps, const char *key, int (*task_exe)(void *datap), void *datap)
+{
+	if (!tps || !task_exe) {
+		tris_log(LOG_ERROR, "%s is missing!!\n", (tps) ? "task callback" : "taskprocessor");
+		return -1;
+	}
+	if (!tps->pool_queues) {
+		return tps_taskprocessor_push(tps, &tps->tps_queue, task_exe, datap);
+	}
+	return tps_taskprocessor_push(tps, &tps->pool_queues[tris_str_case_hash(S_OR(key, "")) % TPS_POOL_QUEUES], task_exe, datap);
+}
+
@@ -42,6 +42,10 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 208927 $")
 
 #define MAX_RECALC 1000 /* max sample recalc */
 
+#define MAX_POOLED 32 /* max idle pvts kept for reuse by each translator */
+
+#define MAX_BATCH 32 /* max paths tris_translate_batch() works on at once */
+
 /*! \brief the list of translators */
 static TRIS_RWLIST_HEAD_STATIC(translators, tris_translator);
 
@@ -63,6 +67,11 @@ struct translator_path {
  */
 static struct translator_path tr_matrix[MAX_FORMAT][MAX_FORMAT];
 
+/*! \brief protects the pool of idle pvts and the pool counters
+ * of every translator.
+ */
+TRIS_MUTEX_DEFINE_STATIC(pool_lock);
+
 /*! \todo
  * TODO: sample frames for each supported input format.
  * We build this on the fly, by taking an SLIN frame and using
@@ -70,14 +79,14 @@ static struct translator_path tr_matrix[MAX_FORMAT][MAX_FORMAT];
  */
 
 /*! \brief returns the index of the lowest bit set */
-static force_inline int powerof(unsigned int d)
+static force_inline int powerof(format_t d)
 {
-	int x = ffs(d);
+	int x = ffsll(d);
 
 	if (x)
 		return x - 1;
 
-	tris_log(LOG_WARNING, "No bits set? %d\n", d);
+	tris_log(LOG_WARNING, "No bits set? %" PRId64 "\n", d);
 
 	return -1;
 }
@@ -86,6 +95,21 @@ static force_inline int powerof(unsigned int d)
  * wrappers around the translator routines.
  */
 
+/*!
+ * \brief compute the size of a pvt, adding private descriptor,
+ * plc, buffer, TRIS_FRIENDLY_OFFSET.
+ */
+static int pvt_size(struct tris_translator *t, int useplc)
+{
+	int len = sizeof(struct tris_trans_pvt) + t->desc_size;
+
+	if (useplc)
+		len += sizeof(plc_state_t);
+	if (t->buf_size)
+		len += TRIS_FRIENDLY_OFFSET + t->buf_size;
+	return len;
+}
+
 /*!
  * \brief Allocate the descriptor, required outbuf space,
  * and possibly also plc and desc.
@@ -93,20 +117,10 @@ static force_inline int powerof(unsigned int d)
 static void *newpvt(struct tris_translator *t)
 {
 	struct tris_trans_pvt *pvt;
-	int len;
 	int useplc = t->plc_samples > 0 && t->useplc;	/* cache, because it can change on the fly */
 	char *ofs;
 
-	/*
-	 * compute the required size adding private descriptor,
-	 * plc, buffer, TRIS_FRIENDLY_OFFSET.
-	 */
-	len = sizeof(*pvt) + t->desc_size;
-	if (useplc)
-		len += sizeof(plc_state_t);
-	if (t->buf_size)
-		len += TRIS_FRIENDLY_OFFSET + t->buf_size;
-	pvt = tris_calloc(1, len);
+	pvt = tris_calloc(1, pvt_size(t, useplc));
 	if (!pvt)
 		return NULL;
 	pvt->t = t;
@@ -130,6 +144,137 @@ static void *newpvt(struct tris_translator *t)
 	return pvt;
 }
 
+/*! \brief release the codec state and memory of a pvt */
+static void free_pvt(struct tris_trans_pvt *pvt)
+{
+	if (pvt->t->destroy)
+		pvt->t->destroy(pvt);
+	tris_free(pvt);
+}
+
+/*!
+ * \brief Put a pvt back in the state newpvt() left it in.
+ * \retval 0 the pvt can be reused
+ * \retval -1 the pvt must be freed
+ */
+static int reset_pvt(struct tris_trans_pvt *pvt)
+{
+	struct tris_translator *t = pvt->t;
+
+	if (t->reset) {
+		if (t->reset(pvt))
+			return -1;
+	} else if (t->destroy) {
+		/* holds state we don't know how to reset */
+		return -1;
+	} else {
+		if (t->desc_size)
+			memset(pvt->pvt, 0, t->desc_size);
+		if (t->newpvt && t->newpvt(pvt))
+			return -1;
+	}
+	if (pvt->plc)
+		memset(pvt->plc, 0, sizeof(*pvt->plc));
+	memset(&pvt->f, 0, sizeof(pvt->f));
+	pvt->samples = 0;
+	pvt->datalen = 0;
+	pvt->next = NULL;
+	pvt->nextin = pvt->nextout = tris_tv(0, 0);
+	return 0;
+}
+
+/*!
+ * \brief Get a pvt for a translation step, from the pool of the
+ * translator if it has an idle one.
+ */
+static struct tris_trans_pvt *get_pvt(struct tris_translator *t)
+{
+	struct tris_trans_pvt *pvt, *stale = NULL;
+	int useplc = t->plc_samples > 0 && t->useplc;
+
+	tris_mutex_lock(&pool_lock);
+	if ((pvt = t->pool)) {
+		t->pool = pvt->next;
+		t->pool_idle--;
+		pvt->next = NULL;
+		/* plc was turned on or off since this one was allocated */
+		if (!pvt->plc != !useplc) {
+			stale = pvt;
+			pvt = NULL;
+		}
+	}
+	if (pvt) {
+		t->pool_hits++;
+		t->pool_inuse++;
+	}
+	tris_mutex_unlock(&pool_lock);
+
+	if (stale)
+		free_pvt(stale);
+
+	if (pvt) {
+		tris_module_ref(t->module);
+		return pvt;
+	}
+
+	if (!(pvt = newpvt(t)))
+		return NULL;
+	pvt->pooled = 1;
+
+	tris_mutex_lock(&pool_lock);
+	t->pool_misses++;
+	t->pool_inuse++;
+	tris_mutex_unlock(&pool_lock);
+
+	return pvt;
+}
+
+/*!
+ * \brief Return a pvt from tris_translator_build_path() to the pool
+ * of its translator.
+ * \retval 0 the pool took the pvt
+ * \retval -1 the pvt must be freed
+ */
+static int put_pvt(struct tris_trans_pvt *pvt)
+{
+	struct tris_translator *t = pvt->t;
+	int res = -1;
+
+	/* Unlocked peek, so a full pool doesn't cost a reset */
+	if (t->pool_open && t->pool_idle < MAX_POOLED)
+		res = reset_pvt(pvt);
+
+	tris_mutex_lock(&pool_lock);
+	t->pool_inuse--;
+	if (!res && t->pool_open && t->pool_idle < MAX_POOLED) {
+		pvt->next = t->pool;
+		t->pool = pvt;
+		t->pool_idle++;
+	} else
+		res = -1;
+	tris_mutex_unlock(&pool_lock);
+
+	return res;
+}
+
+/*! \brief free the idle pvts of a translator and stop pooling new ones */
+static void close_pool(struct tris_translator *t)
+{
+	struct tris_trans_pvt *pvt, *next;
+
+	tris_mutex_lock(&pool_lock);
+	pvt = t->pool;
+	t->pool = NULL;
+	t->pool_idle = 0;
+	t->pool_open = 0;
+	tris_mutex_unlock(&pool_lock);
+
+	for (; pvt; pvt = next) {
+		next = pvt->next;
+		free_pvt(pvt);
+	}
+}
+
 static void destroy(struct tris_trans_pvt *pvt)
 {
 	struct tris_translator *t = pvt->t;
@@ -145,19 +290,20 @@ static void destroy(struct tris_trans_pvt *pvt)
 		return;
 	}
 
-	if (t->destroy)
-		t->destroy(pvt);
-	tris_free(pvt);
+	if (!pvt->pooled || put_pvt(pvt))
+		free_pvt(pvt);
 	tris_module_unref(t->module);
 }
 
-/*! \brief framein wrapper, deals with plc and bound checks.  */
-static int framein(struct tris_trans_pvt *pvt, struct tris_frame *f)
+/*! \brief first half of the framein wrapper, deals with plc and bound checks.
+ * \retval 0 the frame should be passed to the translator
+ * \retval 1 plc took care of the frame
+ * \retval -1 the frame does not fit
+ */
+static int framein_check(struct tris_trans_pvt *pvt, struct tris_frame *f)
 {
 	int16_t *dst = pvt->outbuf.i16;
-	int ret;
-	int samples = pvt->samples;	/* initial value */
-	
+
 	/* Copy the last in jb timing info to the pvt */
 	tris_copy_flags(&pvt->f, f, TRIS_FRFLAG_HAS_TIMING_INFO);
 	pvt->f.ts = f->ts;
@@ -181,31 +327,81 @@ static int framein(struct tris_trans_pvt *pvt, struct tris_frame *f)
 			}
 			/* We don't want generic PLC. If the codec has native PLC, then do that */
 			if (!pvt->t->native_plc)
-				return 0;
+				return 1;
 		}
 		if (pvt->samples + f->samples > pvt->t->buffer_samples) {
 			tris_log(LOG_WARNING, "Out of buffer space\n");
 			return -1;
 		}
 	}
-	/* we require a framein routine, wouldn't know how to do
-	 * it otherwise.
-	 */
-	ret = pvt->t->framein(pvt, f);
+	return 0;
+}
+
+/*! \brief second half of the framein wrapper, feeds plc with what
+ * the translator stored.
+ * \param samples pvt->samples before framein_check()
+ * \param ret what the translator returned
+ */
+static void framein_done(struct tris_trans_pvt *pvt, int samples, int ret)
+{
 	/* possibly store data for plc */
 	if (!ret && pvt->plc) {
 		int l = pvt->t->plc_samples;
 		if (pvt->samples < l)
 			l = pvt->samples;
-		plc_rx(pvt->plc, dst + pvt->samples - l, l);
+		plc_rx(pvt->plc, pvt->outbuf.i16 + pvt->samples - l, l);
 	}
 	/* diagnostic ... */
 	if (pvt->samples == samples)
 		tris_log(LOG_WARNING, "%s did not update samples %d\n",
 			pvt->t->name, pvt->samples);
+}
+
+/*! \brief framein wrapper, deals with plc and bound checks.  */
+static int framein(struct tris_trans_pvt *pvt, struct tris_frame *f)
+{
+	int ret;
+	int samples = pvt->samples;	/* initial value */
+
+	if ((ret = framein_check(pvt, f)))
+		return ret < 0 ? ret : 0;
+	/* we require a framein routine, wouldn't know how to do
+	 * it otherwise.
+	 */
+	ret = pvt->t->framein(pvt, f);
+	framein_done(pvt, samples, ret);
 	return ret;
 }
 
+/*! \brief framein for the same step of many paths, all using translator t */
+static void framein_batch(struct tris_translator *t, struct tris_trans_pvt **pvts, struct tris_frame **frames, int count)
+{
+	struct tris_trans_pvt *ready[MAX_BATCH];
+	struct tris_frame *ready_frames[MAX_BATCH];
+	int samples[MAX_BATCH];
+	int i, n = 0, ret;
+
+	if (!t->framein_batch || count < 2) {
+		for (i = 0; i < count; i++)
+			framein(pvts[i], frames[i]);
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		samples[n] = pvts[i]->samples;
+		if (framein_check(pvts[i], frames[i]))
+			continue;
+		ready[n] = pvts[i];
+		ready_frames[n++] = frames[i];
+	}
+	if (!n)
+		return;
+
+	ret = t->framein_batch(ready, ready_frames, n);
+	for (i = 0; i < n; i++)
+		framein_done(ready[i], samples[i], ret);
+}
+
 /*! \brief generic frameout routine.
  * If samples and datalen are 0, take whatever is in pvt
  * and reset them, otherwise take the values in the caller and
@@ -232,7 +428,7 @@ struct tris_frame *tris_trans_frameout(struct tris_trans_pvt *pvt,
 	}
 
 	f->frametype = TRIS_FRAME_VOICE;
-	f->subclass = 1 << (pvt->t->dstfmt);
+	f->subclass = 1ULL << (pvt->t->dstfmt);
 	f->mallocd = 0;
 	f->offset = TRIS_FRIENDLY_OFFSET;
 	f->src = pvt->t->name;
@@ -260,12 +456,13 @@ void tris_translator_free_path(struct tris_trans_pvt *p)
 }
 
 /*! \brief Build a chain of translators based upon the given source and dest formats */
-struct tris_trans_pvt *tris_translator_build_path(int dest, int source)
+struct tris_trans_pvt *tris_translator_build_path(format_t dest_format, format_t source_format)
 {
 	struct tris_trans_pvt *head = NULL, *tail = NULL;
-	
-	source = powerof(source);
-	dest = powerof(dest);
+	int source, dest;
+
+	source = powerof(source_format);
+	dest = powerof(dest_format);
 
 	if (source == -1 || dest == -1) {
 		tris_log(LOG_WARNING, "No translator path: (%s codec is not valid)\n", source == -1 ? "starting" : "ending");
@@ -279,12 +476,13 @@ struct tris_trans_pvt *tris_translator_build_path(int dest, int source)
 		struct tris_translator *t = tr_matrix[source][dest].step;
 		if (!t) {
 			tris_log(LOG_WARNING, "No translator path from %s to %s\n", 
-				tris_getformatname(source), tris_getformatname(dest));
+				tris_getformatname(source_format), tris_getformatname(dest_format));
 			TRIS_RWLIST_UNLOCK(&translators);
 			return NULL;
 		}
-		if (!(cur = newpvt(t))) {
-			tris_log(LOG_WARNING, "Failed to build translator step from %d to %d\n", source, dest);
+		if (!(cur = get_pvt(t))) {
+			tris_log(LOG_WARNING, "Failed to build translator step from %s to %s\n",
+				tris_getformatname(1ULL << source), tris_getformatname(dest_format));
 			if (head)
 				tris_translator_free_path(head);	
 			TRIS_RWLIST_UNLOCK(&translators);
@@ -304,21 +502,24 @@ struct tris_trans_pvt *tris_translator_build_path(int dest, int source)
 	return head;
 }
 
-/*! \brief do the actual translation */
-struct tris_frame *tris_translate(struct tris_trans_pvt *path, struct tris_frame *f, int consume)
-{
-	struct tris_trans_pvt *p = path;
-	struct tris_frame *out = f;
+/*! \brief timing of a frame going into a translation path */
+struct translate_timing {
 	struct timeval delivery;
 	int has_timing_info;
 	long ts;
 	long len;
 	int seqno;
+};
 
-	has_timing_info = tris_test_flag(f, TRIS_FRFLAG_HAS_TIMING_INFO);
-	ts = f->ts;
-	len = f->len;
-	seqno = f->seqno;
+/*! \brief predict the timing of the next frame into path, and
+ * remember the timing of this one for timing_out()
+ */
+static void timing_in(struct tris_trans_pvt *path, struct tris_frame *f, struct translate_timing *timing)
+{
+	timing->has_timing_info = tris_test_flag(f, TRIS_FRFLAG_HAS_TIMING_INFO);
+	timing->ts = f->ts;
+	timing->len = f->len;
+	timing->seqno = f->seqno;
 
 	/* XXX hmmm... check this below */
 	if (!tris_tvzero(f->delivery)) {
@@ -342,19 +543,14 @@ struct tris_frame *tris_translate(struct tris_trans_pvt *path, struct tris_frame
 		/* Predict next incoming sample */
 		path->nextin = tris_tvadd(path->nextin, tris_samp2tv(f->samples, tris_format_rate(f->subclass)));
 	}
-	delivery = f->delivery;
-	for ( ; out && p ; p = p->next) {
-		framein(p, out);
-		if (out != f)
-			tris_frfree(out);
-		out = p->t->frameout(p);
-	}
-	if (consume)
-		tris_frfree(f);
-	if (out == NULL)
-		return NULL;
+	timing->delivery = f->delivery;
+}
+
+/*! \brief set the times of a frame coming out of path */
+static struct tris_frame *timing_out(struct tris_trans_pvt *path, struct translate_timing *timing, struct tris_frame *out)
+{
 	/* we have a frame, play with times */
-	if (!tris_tvzero(delivery)) {
+	if (!tris_tvzero(timing->delivery)) {
 		/* Regenerate prediction after a discontinuity */
 		if (tris_tvzero(path->nextout))
 			path->nextout = tris_tvnow();
@@ -367,11 +563,11 @@ struct tris_frame *tris_translate(struct tris_trans_pvt *path, struct tris_frame
 		path->nextout = tris_tvadd(path->nextout, tris_samp2tv(out->samples, tris_format_rate(out->subclass)));
 	} else {
 		out->delivery = tris_tv(0, 0);
-		tris_set2_flag(out, has_timing_info, TRIS_FRFLAG_HAS_TIMING_INFO);
-		if (has_timing_info) {
-			out->ts = ts;
-			out->len = len;
-			out->seqno = seqno;
+		tris_set2_flag(out, timing->has_timing_info, TRIS_FRFLAG_HAS_TIMING_INFO);
+		if (timing->has_timing_info) {
+			out->ts = timing->ts;
+			out->len = timing->len;
+			out->seqno = timing->seqno;
 		}
 	}
 	/* Invalidate prediction if we're entering a silence period */
@@ -380,6 +576,101 @@ struct tris_frame *tris_translate(struct tris_trans_pvt *path, struct tris_frame
 	return out;
 }
 
+/*! \brief do the actual translation */
+struct tris_frame *tris_translate(struct tris_trans_pvt *path, struct tris_frame *f, int consume)
+{
+	struct tris_trans_pvt *p = path;
+	struct tris_frame *out = f;
+	struct translate_timing timing;
+
+	timing_in(path, f, &timing);
+	for ( ; out && p ; p = p->next) {
+		framein(p, out);
+		if (out != f)
+			tris_frfree(out);
+		out = p->t->frameout(p);
+	}
+	if (consume)
+		tris_frfree(f);
+	if (out == NULL)
+		return NULL;
+	return timing_out(path, &timing, out);
+}
+
+/*!
+ * \brief translate up to MAX_BATCH frames, a step at a time
+ *
+ * Every round moves each path on by one step.  Paths whose current step
+ * uses the same translator go to framein_batch() together.
+ */
+static int translate_batch(struct tris_trans_pvt **paths, struct tris_frame **in, struct tris_frame **out, int count)
+{
+	struct tris_trans_pvt *step[MAX_BATCH];
+	struct translate_timing timing[MAX_BATCH];
+	struct tris_trans_pvt *group[MAX_BATCH];
+	struct tris_frame *group_frames[MAX_BATCH];
+	int members[MAX_BATCH];
+	int todo[MAX_BATCH];
+	int i, j, n, left, res = 0;
+
+	for (i = 0; i < count; i++) {
+		timing_in(paths[i], in[i], &timing[i]);
+		step[i] = paths[i];
+		out[i] = in[i];
+	}
+
+	do {
+		left = 0;
+		for (i = 0; i < count; i++) {
+			todo[i] = step[i] && out[i];
+			left += todo[i];
+		}
+		for (i = 0; i < count; i++) {
+			struct tris_translator *t;
+
+			if (!todo[i])
+				continue;
+			t = step[i]->t;
+			for (j = i, n = 0; j < count; j++) {
+				if (!todo[j] || step[j]->t != t)
+					continue;
+				todo[j] = 0;
+				members[n] = j;
+				group[n] = step[j];
+				group_frames[n++] = out[j];
+			}
+			framein_batch(t, group, group_frames, n);
+			for (j = 0; j < n; j++) {
+				int k = members[j];
+
+				if (out[k] != in[k])
+					tris_frfree(out[k]);
+				out[k] = t->frameout(step[k]);
+				step[k] = step[k]->next;
+			}
+		}
+	} while (left);
+
+	for (i = 0; i < count; i++) {
+		if (out[i]) {
+			timing_out(paths[i], &timing[i], out[i]);
+			res++;
+		}
+	}
+
+	return res;
+}
+
+int tris_translate_batch(struct tris_trans_pvt **paths, struct tris_frame **in, struct tris_frame **out, int count)
+{
+	int i, res = 0;
+
+	for (i = 0; i < count; i += MAX_BATCH)
+		res += translate_batch(paths + i, in + i, out + i, MIN(count - i, MAX_BATCH));
+
+	return res;
+}
+
 /*! \brief compute the cost of a single translation step */
 static void calc_cost(struct tris_translator *t, int seconds)
 {
@@ -475,49 +766,44 @@ static void rebuild_matrix(int samples)
 	 * For each triple x, y, z of distinct formats, check if there is
 	 * a path from x to z through y which is cheaper than what is
 	 * currently known, and in case, update the matrix.
-	 * Repeat until the matrix is stable.
+	 * With the intermediate format in the outer loop (Floyd-Warshall)
+	 * a single pass finds the cheapest paths.
 	 */
-	for (;;) {
-		int changed = 0;
+	for (y = 0; y < MAX_FORMAT; y++) {        /* intermediate format */
 		for (x = 0; x < MAX_FORMAT; x++) {      /* source format */
-			for (y = 0; y < MAX_FORMAT; y++) {    /* intermediate format */
-				if (x == y)                     /* skip ourselves */
-					continue;
+			if (x == y)                     /* skip ourselves */
+				continue;
+			if (!tr_matrix[x][y].step)      /* no path from x to y */
+				continue;
 
-				for (z = 0; z<MAX_FORMAT; z++) {  /* dst format */
-					int newcost;
-
-					if (z == x || z == y)       /* skip null conversions */
-						continue;
-					if (!tr_matrix[x][y].step)  /* no path from x to y */
-						continue;
-					if (!tr_matrix[y][z].step)  /* no path from y to z */
-						continue;
-					newcost = tr_matrix[x][y].cost + tr_matrix[y][z].cost;
-					if (tr_matrix[x][z].step && newcost >= tr_matrix[x][z].cost)
-						continue;               /* x->y->z is more expensive than
-						                         * the existing path */
-					/* ok, we can get from x to z via y with a cost that
-					   is the sum of the transition from x to y and
-					   from y to z */
-						 
-					tr_matrix[x][z].step = tr_matrix[x][y].step;
-					tr_matrix[x][z].cost = newcost;
-					tr_matrix[x][z].multistep = 1;
-					tris_debug(3, "Discovered %d cost path from %s to %s, via %s\n", tr_matrix[x][z].cost,
-						  tris_getformatname(1 << x), tris_getformatname(1 << z), tris_getformatname(1 << y));
-					changed++;
-				}
+			for (z = 0; z < MAX_FORMAT; z++) {    /* dst format */
+				int newcost;
+
+				if (z == x || z == y)       /* skip null conversions */
+					continue;
+				if (!tr_matrix[y][z].step)  /* no path from y to z */
+					continue;
+				newcost = tr_matrix[x][y].cost + tr_matrix[y][z].cost;
+				if (tr_matrix[x][z].step && newcost >= tr_matrix[x][z].cost)
+					continue;               /* x->y->z is more expensive than
+					                         * the existing path */
+				/* ok, we can get from x to z via y with a cost that
+				   is the sum of the transition from x to y and
+				   from y to z */
+
+				tr_matrix[x][z].step = tr_matrix[x][y].step;
+				tr_matrix[x][z].cost = newcost;
+				tr_matrix[x][z].multistep = 1;
+				tris_debug(3, "Discovered %d cost path from %s to %s, via %s\n", tr_matrix[x][z].cost,
+					  tris_getformatname(1ULL << x), tris_getformatname(1ULL << z), tris_getformatname(1ULL << y));
 			}
 		}
-		if (!changed)
-			break;
 	}
 }
 
 static char *handle_cli_core_show_translation(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
 {
-#define SHOW_TRANS 16
+#define SHOW_TRANS (MAX_AUDIO_FORMAT + 1)
 	int x, y, z;
 	int curlen = 0, longest = 0, magnitude[SHOW_TRANS] = { 0, };
 
@@ -563,7 +849,7 @@ static char *handle_cli_core_show_translation(struct tris_cli_entry *e, int cmd,
 	tris_cli(a->fd, "          Source Format (Rows) Destination Format (Columns)\n\n");
 	/* Get the length of the longest (usable?) codec name, so we know how wide the left side should be */
 	for (x = 0; x < SHOW_TRANS; x++) {
-		curlen = strlen(tris_getformatname(1 << (x)));
+		curlen = strlen(tris_getformatname(1ULL << (x)));
 		if (curlen > longest)
 			longest = curlen;
 		for (y = 0; y < SHOW_TRANS; y++) {
@@ -573,17 +859,17 @@ static char *handle_cli_core_show_translation(struct tris_cli_entry *e, int cmd,
 		}
 	}
 	for (x = -1; x < SHOW_TRANS; x++) {
-		struct tris_str *out = tris_str_alloca(125);
+		struct tris_str *out = tris_str_alloca(256);
 		/*Go ahead and move to next iteration if dealing with an unknown codec*/
-		if(x >= 0 && !strcmp(tris_getformatname(1 << (x)), "unknown"))
+		if(x >= 0 && !strcmp(tris_getformatname(1ULL << (x)), "unknown"))
 			continue;
 		tris_str_set(&out, -1, " ");
 		for (y = -1; y < SHOW_TRANS; y++) {
 			/*Go ahead and move to next iteration if dealing with an unknown codec*/
-			if (y >= 0 && !strcmp(tris_getformatname(1 << (y)), "unknown"))
+			if (y >= 0 && !strcmp(tris_getformatname(1ULL << (y)), "unknown"))
 				continue;
 			if (y >= 0)
-				curlen = strlen(tris_getformatname(1 << (y)));
+				curlen = strlen(tris_getformatname(1ULL << (y)));
 			if (y >= 0 && magnitude[y] + 1 > curlen) {
 				curlen = magnitude[y] + 1;
 			}
@@ -594,10 +880,10 @@ static char *handle_cli_core_show_translation(struct tris_cli_entry *e, int cmd,
 				tris_str_append(&out, -1, "%*d", curlen + 1, tr_matrix[x][y].cost);
 			} else if (x == -1 && y >= 0) {
 				/* Top row - use a dynamic size */
-				tris_str_append(&out, -1, "%*s", curlen + 1, tris_getformatname(1 << (y)) );
+				tris_str_append(&out, -1, "%*s", curlen + 1, tris_getformatname(1ULL << (y)) );
 			} else if (y == -1 && x >= 0) {
 				/* Left column - use a static size. */
-				tris_str_append(&out, -1, "%*s", longest, tris_getformatname(1 << (x)) );
+				tris_str_append(&out, -1, "%*s", longest, tris_getformatname(1ULL << (x)) );
 			} else if (x >= 0 && y >= 0) {
 				/* Codec not supported */
 				tris_str_append(&out, -1, "%*s", curlen + 1, "-");
@@ -613,8 +899,61 @@ static char *handle_cli_core_show_translation(struct tris_cli_entry *e, int cmd,
 	return CLI_SUCCESS;
 }
 
+static char *handle_cli_core_show_translation_pools(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+#define FORMAT  "%-25s %-9s %-9s %6s %6s %10s %10s %6s %9s\n"
+#define FORMAT2 "%-25s %-9s %-9s %6u %6u %10u %10u %5u%% %7uKB\n"
+	struct tris_translator *t;
+	unsigned int inuse = 0, idle = 0, hits = 0, misses = 0, kbytes = 0;
+
+	switch (cmd) {
+	case CLI_INIT:
+		e->command = "core show translation pools";
+		e->usage =
+			"Usage: core show translation pools\n"
+			"       Displays, for each codec translator, how many translator\n"
+			"       states are in use and idle, how often a translation path\n"
+			"       reused an idle one and the memory they hold, not counting\n"
+			"       what codec libraries allocate on their own.\n";
+		return NULL;
+	case CLI_GENERATE:
+		return NULL;
+	}
+
+	if (a->argc != 4)
+		return CLI_SHOWUSAGE;
+
+	tris_cli(a->fd, FORMAT, "Translator", "Source", "Dest", "InUse", "Idle", "Hits", "Misses", "Hit", "Memory");
+
+	TRIS_RWLIST_RDLOCK(&translators);
+	tris_mutex_lock(&pool_lock);
+	TRIS_RWLIST_TRAVERSE(&translators, t, list) {
+		unsigned int total = t->pool_hits + t->pool_misses;
+		unsigned int kb = (t->pool_inuse + t->pool_idle) * pvt_size(t, t->plc_samples > 0 && t->useplc) / 1024;
+
+		tris_cli(a->fd, FORMAT2, t->name, tris_getformatname(1ULL << t->srcfmt), tris_getformatname(1ULL << t->dstfmt),
+			t->pool_inuse, t->pool_idle, t->pool_hits, t->pool_misses,
+			total ? t->pool_hits * 100 / total : 0, kb);
+		inuse += t->pool_inuse;
+		idle += t->pool_idle;
+		hits += t->pool_hits;
+		misses += t->pool_misses;
+		kbytes += kb;
+	}
+	tris_mutex_unlock(&pool_lock);
+	TRIS_RWLIST_UNLOCK(&translators);
+
+	tris_cli(a->fd, FORMAT2, "Total", "", "", inuse, idle, hits, misses,
+		hits + misses ? hits * 100 / (hits + misses) : 0, kbytes);
+
+	return CLI_SUCCESS;
+#undef FORMAT
+#undef FORMAT2
+}
+
 static struct tris_cli_entry cli_translate[] = {
-	TRIS_CLI_DEFINE(handle_cli_core_show_translation, "Display translation matrix")
+	TRIS_CLI_DEFINE(handle_cli_core_show_translation, "Display translation matrix"),
+	TRIS_CLI_DEFINE(handle_cli_core_show_translation_pools, "Display reuse of translator states"),
 };
 
 /*! \brief register codec translator */
@@ -651,8 +990,8 @@ int __tris_register_translator(struct tris_translator *t, struct tris_module *mo
 			return -1;
 		}
 		if (t->dstfmt != powerof(TRIS_FORMAT_SLINEAR))
-			tris_log(LOG_WARNING, "plc_samples %d format %x\n",
-				t->plc_samples, t->dstfmt);
+			tris_log(LOG_WARNING, "plc_samples %d format %s\n",
+				t->plc_samples, tris_getformatname(1ULL << t->dstfmt));
 	}
 	if (t->srcfmt >= MAX_FORMAT) {
 		tris_log(LOG_WARNING, "Source format %s is larger than MAX_FORMAT\n", tris_getformatname(t->srcfmt));
@@ -682,13 +1021,19 @@ int __tris_register_translator(struct tris_translator *t, struct tris_module *mo
 
 	tris_verb(2, "Registered translator '%s' from format %s to %s, cost %d\n",
 			    term_color(tmp, t->name, COLOR_MAGENTA, COLOR_BLACK, sizeof(tmp)),
-			    tris_getformatname(1 << t->srcfmt), tris_getformatname(1 << t->dstfmt), t->cost);
+			    tris_getformatname(1ULL << t->srcfmt), tris_getformatname(1ULL << t->dstfmt), t->cost);
 
 	if (!added_cli) {
 		tris_cli_register_multiple(cli_translate, ARRAY_LEN(cli_translate));
 		added_cli++;
 	}
 
+	tris_mutex_lock(&pool_lock);
+	t->pool = NULL;
+	t->pool_idle = t->pool_inuse = t->pool_hits = t->pool_misses = 0;
+	t->pool_open = 1;
+	tris_mutex_unlock(&pool_lock);
+
 	TRIS_RWLIST_WRLOCK(&translators);
 
 	/* find any existing translators that provide this same srcfmt/dstfmt,
@@ -726,7 +1071,7 @@ int tris_unregister_translator(struct tris_translator *t)
 	TRIS_RWLIST_TRAVERSE_SAFE_BEGIN(&translators, u, list) {
 		if (u == t) {
 			TRIS_RWLIST_REMOVE_CURRENT(list);
-			tris_verb(2, "Unregistered translator '%s' from format %s to %s\n", term_color(tmp, t->name, COLOR_MAGENTA, COLOR_BLACK, sizeof(tmp)), tris_getformatname(1 << t->srcfmt), tris_getformatname(1 << t->dstfmt));
+			tris_verb(2, "Unregistered translator '%s' from format %s to %s\n", term_color(tmp, t->name, COLOR_MAGENTA, COLOR_BLACK, sizeof(tmp)), tris_getformatname(1ULL << t->srcfmt), tris_getformatname(1ULL << t->dstfmt));
 			found = 1;
 			break;
 		}
@@ -738,6 +1083,9 @@ int tris_unregister_translator(struct tris_translator *t)
 
 	TRIS_RWLIST_UNLOCK(&translators);
 
+	if (found)
+		close_pool(t);
+
 	return (u ? 0 : -1);
 }
 
@@ -758,37 +1106,36 @@ void tris_translator_deactivate(struct tris_translator *t)
 }
 
 /*! \brief Calculate our best translator source format, given costs, and a desired destination */
-int tris_translator_best_choice(int *dst, int *srcs)
+int tris_translator_best_choice(format_t *dst, format_t *srcs)
 {
 	int x,y;
 	int best = -1;
-	int bestdst = 0;
-	int cur, cursrc;
+	format_t bestsrc = 0, bestdst = 0;
+	format_t dsts, cur, cursrc;
 	int besttime = INT_MAX;
 	int beststeps = INT_MAX;
-	int common = ((*dst) & (*srcs)) & TRIS_FORMAT_AUDIO_MASK;	/* are there common formats ? */
+	format_t common = ((*dst) & (*srcs)) & TRIS_FORMAT_AUDIO_MASK;	/* are there common formats ? */
 
 	if (common) { /* yes, pick one and return */
-		for (cur = 1, y = 0; y <= MAX_AUDIO_FORMAT; cur <<= 1, y++) {
-			if (cur & common)	/* guaranteed to find one */
-				break;
-		}
-		/* We are done, this is a common format to both. */
-		*srcs = *dst = cur;
+		/* We are done, the lowest common bit is a format common to both. */
+		*srcs = *dst = common & -common;
 		return 0;
 	} else {	/* No, we will need to translate */
 		TRIS_RWLIST_RDLOCK(&translators);
-		for (cur = 1, y = 0; y <= MAX_AUDIO_FORMAT; cur <<= 1, y++) {
-			if (! (cur & *dst))
-				continue;
-			for (cursrc = 1, x = 0; x <= MAX_AUDIO_FORMAT; cursrc <<= 1, x++) {
-				if (!(*srcs & cursrc) || !tr_matrix[x][y].step ||
+		/* only visit the formats that are set, the masks are sparse */
+		for (dsts = *dst & TRIS_FORMAT_AUDIO_MASK; dsts; dsts &= dsts - 1) {
+			cur = dsts & -dsts;
+			y = powerof(cur);
+			for (cursrc = *srcs & TRIS_FORMAT_AUDIO_MASK; cursrc; cursrc &= cursrc - 1) {
+				x = powerof(cursrc);
+				if (!tr_matrix[x][y].step ||
 				    tr_matrix[x][y].cost >  besttime)
 					continue;	/* not existing or no better */
 				if (tr_matrix[x][y].cost < besttime ||
 				    tr_matrix[x][y].multistep < beststeps) {
 					/* better than what we have so far */
-					best = cursrc;
+					best = 0;
+					bestsrc = 1ULL << x;
 					bestdst = cur;
 					besttime = tr_matrix[x][y].cost;
 					beststeps = tr_matrix[x][y].multistep;
@@ -796,22 +1143,22 @@ int tris_translator_best_choice(int *dst, int *srcs)
 			}
 		}
 		TRIS_RWLIST_UNLOCK(&translators);
-		if (best > -1) {
-			*srcs = best;
+		if (!best) {
+			*srcs = bestsrc;
 			*dst = bestdst;
-			best = 0;
 		}
 		return best;
 	}
 }
 
-unsigned int tris_translate_path_steps(unsigned int dest, unsigned int src)
+unsigned int tris_translate_path_steps(format_t dest_format, format_t src_format)
 {
 	unsigned int res = -1;
+	int src, dest;
 
 	/* convert bitwise format numbers into array indices */
-	src = powerof(src);
-	dest = powerof(dest);
+	src = powerof(src_format);
+	dest = powerof(dest_format);
 
 	if (src == -1 || dest == -1) {
 		tris_log(LOG_WARNING, "No translator path: (%s codec is not valid)\n", src == -1 ? "starting" : "ending");
@@ -827,12 +1174,11 @@ unsigned int tris_translate_path_steps(unsigned int dest, unsigned int src)
 	return res;
 }
 
-unsigned int tris_translate_available_formats(unsigned int dest, unsigned int src)
+format_t tris_translate_available_formats(format_t dest, format_t src)
 {
-	unsigned int res = dest;
-	unsigned int x;
-	unsigned int src_audio = src & TRIS_FORMAT_AUDIO_MASK;
-	unsigned int src_video = src & TRIS_FORMAT_VIDEO_MASK;
+	format_t res = dest;
+	format_t x, bits;
+	int y, src_audio = -1, src_video = -1;
 
 	/* if we don't have a source format, we just have to try all
 	   possible destination formats */
@@ -840,12 +1186,12 @@ unsigned int tris_translate_available_formats(unsigned int dest, unsigned int sr
 		return dest;
 
 	/* If we have a source audio format, get its format index */
-	if (src_audio)
-		src_audio = powerof(src_audio);
+	if (src & TRIS_FORMAT_AUDIO_MASK)
+		src_audio = powerof(src & TRIS_FORMAT_AUDIO_MASK);
 
 	/* If we have a source video format, get its format index */
-	if (src_video)
-		src_video = powerof(src_video);
+	if (src & TRIS_FORMAT_VIDEO_MASK)
+		src_video = powerof(src & TRIS_FORMAT_VIDEO_MASK);
 
 	TRIS_RWLIST_RDLOCK(&translators);
 
@@ -853,10 +1199,9 @@ unsigned int tris_translate_available_formats(unsigned int dest, unsigned int sr
 	   known audio formats to determine whether there exists
 	   a translation path from the source format to the
 	   destination format. */
-	for (x = 1; src_audio && (x & TRIS_FORMAT_AUDIO_MASK); x <<= 1) {
-		/* if this is not a desired format, nothing to do */
-		if (!(dest & x))
-			continue;
+	for (bits = src_audio < 0 ? 0 : dest & TRIS_FORMAT_AUDIO_MASK; bits; bits &= bits - 1) {
+		x = bits & -bits;
+		y = __builtin_ctzll(bits);
 
 		/* if the source is supplying this format, then
 		   we can leave it in the result */
@@ -865,13 +1210,13 @@ unsigned int tris_translate_available_formats(unsigned int dest, unsigned int sr
 
 		/* if we don't have a translation path from the src
 		   to this format, remove it from the result */
-		if (!tr_matrix[src_audio][powerof(x)].step) {
+		if (!tr_matrix[src_audio][y].step) {
 			res &= ~x;
 			continue;
 		}
 
 		/* now check the opposite direction */
-		if (!tr_matrix[powerof(x)][src_audio].step)
+		if (!tr_matrix[y][src_audio].step)
 			res &= ~x;
 	}
 
@@ -879,10 +1224,9 @@ unsigned int tris_translate_available_formats(unsigned int dest, unsigned int sr
 	   known video formats to determine whether there exists
 	   a translation path from the source format to the
 	   destination format. */
-	for (; src_video && (x & TRIS_FORMAT_VIDEO_MASK); x <<= 1) {
-		/* if this is not a desired format, nothing to do */
-		if (!(dest & x))
-			continue;
+	for (bits = src_video < 0 ? 0 : dest & TRIS_FORMAT_VIDEO_MASK; bits; bits &= bits - 1) {
+		x = bits & -bits;
+		y = __builtin_ctzll(bits);
 
 		/* if the source is supplying this format, then
 		   we can leave it in the result */
@@ -891,13 +1235,13 @@ unsigned int tris_translate_available_formats(unsigned int dest, unsigned int sr
 
 		/* if we don't have a translation path from the src
 		   to this format, remove it from the result */
-		if (!tr_matrix[src_video][powerof(x)].step) {
+		if (!tr_matrix[src_video][y].step) {
 			res &= ~x;
 			continue;
 		}
 
 		/* now check the opposite direction */
-		if (!tr_matrix[powerof(x)][src_video].step)
+		if (!tr_matrix[y][src_video].step)
 			res &= ~x;
 	}
 
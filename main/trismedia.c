@@ -112,6 +112,8 @@ int daemon(int, int);  /* defined in libresolv of all places */
 #include "trismedia/features.h"
 #include "trismedia/ulaw.h"
 #include "trismedia/alaw.h"
+#include "trismedia/g711.h"
+#include "trismedia/mix.h"
 #include "trismedia/callerid.h"
 #include "trismedia/image.h"
 #include "trismedia/tdd.h"
@@ -3125,6 +3127,8 @@ int main(int argc, char *argv[])
 	tris_mainpid = getpid();
 	tris_ulaw_init();
 	tris_alaw_init();
+	tris_g711_init();
+	tris_mix_init();
 	callerid_init();
 	tris_builtins_init();
 	tris_utils_init();
@@ -0,0 +1,23 @@
+/*
+ * version.c
+ * Automatically generated
+ */
+
+#include "trismedia.h"
+
+#include "trismedia/tris_version.h"
+
+static const char trismedia_version[] = "2.2";
+
+static const char trismedia_version_num[] = "20200";
+
+const char *tris_get_version(void)
+{
+	return trismedia_version;
+}
+
+const char *tris_get_version_num(void)
+{
+	return trismedia_version_num;
+}
+
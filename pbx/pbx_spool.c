@@ -30,6 +30,9 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 211580 $")
 #include <time.h>
 #include <utime.h>
 #include <dirent.h>
+#ifdef HAVE_INOTIFY
+#include <sys/inotify.h>
+#endif
 
 #include "trismedia/paths.h"	/* use tris_config_TRIS_SPOOL_DIR */
 #include "trismedia/lock.h"
@@ -43,6 +46,11 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 211580 $")
 #include "trismedia/options.h"
 #include "trismedia/res_odbc.h"
 #include "trismedia/acl.h"
+#include "trismedia/astobj2.h"
+#include "trismedia/heap.h"
+#include "trismedia/cli.h"
+#include "trismedia/config.h"
+#include "trismedia/poll-compat.h"
 
 /*
  * pbx_spool is similar in spirit to qcall, but with substantially enhanced functionality...
@@ -62,13 +70,45 @@ enum {
 static char qdir[255];
 static char qdonedir[255];
 
+/*! Default for maxrate in pbx_spool.conf */
+#define DEFAULT_MAXRATE	100
+
+/*! Call files started per second at most, 0 for no limit */
+static int maxrate = DEFAULT_MAXRATE;
+
+/*! \brief A call file waiting in the outgoing directory */
+struct spool_file {
+	time_t next;                              /*!< When the call file is due (its mtime) */
+	ssize_t __heap_index;
+	char name[NAME_MAX + 1];                  /*!< File name in qdir */
+};
+
+#define SPOOL_FILE_BUCKETS	563
+
+/*! Call files by name */
+static struct ao2_container *spool_files;
+/*! The same call files, the one due first on top */
+static struct tris_heap *spool_due;
+
+static struct {
+	int files_seen;                           /*!< New call files found */
+	int events;                               /*!< inotify events handled */
+	int rescans;                              /*!< Full scans of the outgoing directory */
+	int dispatched;                           /*!< Call files serviced */
+	int failed;                               /*!< Call files that could not be serviced */
+	int throttled;                            /*!< Times dispatch waited for maxrate */
+	int inflight;                             /*!< Calls being attempted right now */
+	int monitor_removed;                      /*!< Old recordings removed from the monitor directory */
+	int inotify;                              /*!< Whether the directory is watched with inotify */
+} spool_stats;
+
 struct outgoing {
 	int retries;                              /*!< Current number of retries */
 	int maxretries;                           /*!< Maximum number of retries permitted */
 	int retrytime;                            /*!< How long to wait between retries (in seconds) */
 	int waittime;                             /*!< How long to wait for an answer */
 	long callingpid;                          /*!< PID which is currently calling */
-	int format;                               /*!< Formats (codecs) for this call */
+	format_t format;                               /*!< Formats (codecs) for this call */
 	TRIS_DECLARE_STRING_FIELDS (
 		TRIS_STRING_FIELD(fn);                 /*!< File name of call file */
 		TRIS_STRING_FIELD(tech);               /*!< Which channel technology to use for outgoing call */
@@ -427,6 +467,7 @@ static void *attempt_thread(void *data)
 //		remove_from_queue(o, "Completed");
 	}
 	free_outgoing(o);
+	tris_atomic_fetchadd_int(&spool_stats.inflight, -1);
 	return NULL;
 }
 
@@ -435,8 +476,10 @@ static void launch_service(struct outgoing *o)
 	pthread_t t;
 	int ret;
 
+	tris_atomic_fetchadd_int(&spool_stats.inflight, +1);
 	if ((ret = tris_pthread_create_detached(&t, NULL, attempt_thread, o))) {
 		tris_log(LOG_WARNING, "Unable to create thread :( (returned error: %d)\n", ret);
+		tris_atomic_fetchadd_int(&spool_stats.inflight, -1);
 		free_outgoing(o);
 	}
 }
@@ -590,74 +633,261 @@ static int scan_service(char *fn, time_t now, time_t atime)
 	return res;
 }
 
-static void *scan_thread(void *unused)
+static int spool_file_hash(const void *obj, const int flags)
+{
+	const struct spool_file *sf = obj;
+
+	return tris_str_hash(sf->name);
+}
+
+static int spool_file_cmp(void *obj, void *arg, int flags)
+{
+	struct spool_file *sf = obj, *sf2 = arg;
+
+	return !strcmp(sf->name, sf2->name) ? CMP_MATCH | CMP_STOP : 0;
+}
+
+/*! \brief The heap keeps its largest element on top, so the earliest time compares largest */
+static int spool_file_due_cmp(void *a, void *b)
+{
+	struct spool_file *sf1 = a, *sf2 = b;
+
+	if (sf1->next < sf2->next)
+		return 1;
+	if (sf1->next > sf2->next)
+		return -1;
+	return 0;
+}
+
+static struct spool_file *find_file(const char *name)
+{
+	struct spool_file tmp;
+
+	tris_copy_string(tmp.name, name, sizeof(tmp.name));
+	return ao2_find(spool_files, &tmp, OBJ_POINTER);
+}
+
+/*!
+ * \brief Add a call file to the due heap, or move it if it is already there
+ * \note Only the scan thread changes the heap, under its write lock
+ */
+static void queue_file(const char *name, time_t when)
 {
+	struct spool_file *sf;
+
+	tris_heap_wrlock(spool_due);
+	if ((sf = find_file(name))) {
+		tris_heap_remove(spool_due, sf);
+	} else if ((sf = ao2_alloc(sizeof(*sf), NULL))) {
+		tris_copy_string(sf->name, name, sizeof(sf->name));
+		sf->__heap_index = -1;
+		ao2_link(spool_files, sf);
+		spool_stats.files_seen++;
+	} else {
+		tris_heap_unlock(spool_due);
+		return;
+	}
+	sf->next = when;
+	tris_heap_push(spool_due, sf);
+	tris_heap_unlock(spool_due);
+	ao2_ref(sf, -1);
+}
+
+/*! \brief Stop tracking a call file, it has left the outgoing directory */
+static void forget_file(struct spool_file *sf)
+{
+	tris_heap_wrlock(spool_due);
+	tris_heap_remove(spool_due, sf);
+	tris_heap_unlock(spool_due);
+	ao2_unlink(spool_files, sf);
+}
+
+/*! \brief Queue a call file by name if it is a regular file, or forget it if it is gone */
+static void check_file(const char *name)
+{
+	struct spool_file *sf;
 	struct stat st;
+	char fn[256];
+
+	snprintf(fn, sizeof(fn), "%s/%s", qdir, name);
+	if (!stat(fn, &st) && S_ISREG(st.st_mode)) {
+		queue_file(name, st.st_mtime);
+	} else if ((sf = find_file(name))) {
+		forget_file(sf);
+		ao2_ref(sf, -1);
+	}
+}
+
+/*! \brief Queue every call file in the outgoing directory */
+static void scan_dir(void)
+{
 	DIR *dir;
 	struct dirent *de;
+
+	if (!(dir = opendir(qdir))) {
+		tris_log(LOG_WARNING, "Unable to open directory %s: %s\n", qdir, strerror(errno));
+		return;
+	}
+	while ((de = readdir(dir))) {
+		if (!strcmp(de->d_name, ".") || !strcmp(de->d_name, ".."))
+			continue;
+		check_file(de->d_name);
+	}
+	closedir(dir);
+	spool_stats.rescans++;
+}
+
+/*!
+ * \brief Service a call file that has come due
+ *
+ * Afterwards the file is queued again at its new mtime if it is still
+ * there, which is how retries get scheduled.
+ */
+static void service_file(struct spool_file *sf, time_t now)
+{
+	struct stat st;
 	char fn[256];
 	int res;
-	time_t last = 0, next = 0, now;
+
+	snprintf(fn, sizeof(fn), "%s/%s", qdir, sf->name);
+	if (stat(fn, &st) || !S_ISREG(st.st_mode)) {
+		ao2_unlink(spool_files, sf);
+		return;
+	}
+	if (st.st_mtime > now) {
+		/* Touched into the future since it was queued */
+		queue_file(sf->name, st.st_mtime);
+		return;
+	}
+
+	res = scan_service(fn, now, st.st_atime);
+	spool_stats.dispatched++;
+	if (res < 0) {
+		tris_log(LOG_WARNING, "Failed to scan service '%s'\n", fn);
+		spool_stats.failed++;
+	}
+
+	if (!stat(fn, &st) && S_ISREG(st.st_mode)) {
+		/* An expired entry is checked again next second, as it always was */
+		queue_file(sf->name, MAX(st.st_mtime, now + 1));
+	} else {
+		ao2_unlink(spool_files, sf);
+	}
+}
+
+#ifdef HAVE_INOTIFY
+/*! \brief Queue or forget the call files named in pending inotify events */
+static void read_events(int inotify_fd)
+{
+	char buf[8192] __attribute__((aligned(__alignof__(struct inotify_event))));
+	struct inotify_event *iev;
+	ssize_t len;
+	char *ptr;
+
+	while ((len = read(inotify_fd, buf, sizeof(buf))) > 0) {
+		for (ptr = buf; ptr < buf + len; ptr += sizeof(*iev) + iev->len) {
+			iev = (struct inotify_event *) ptr;
+			spool_stats.events++;
+			if (iev->mask & IN_Q_OVERFLOW) {
+				tris_log(LOG_NOTICE, "Too many changes in %s at once, rescanning it\n", qdir);
+				scan_dir();
+			} else if (iev->len) {
+				check_file(iev->name);
+			}
+		}
+	}
+}
+#endif
+
+static void *scan_thread(void *unused)
+{
+	struct spool_file *sf;
+	time_t now, rate_second = 0;
+	int rate_count = 0, timeout;
 	struct timespec ts = { .tv_sec = 1 };
-  
+#ifdef HAVE_INOTIFY
+	struct pollfd pfd = { .fd = -1, .events = POLLIN };
+#endif
+	struct stat st;
+	time_t last = 0;
+
 	while (!tris_fully_booted) {
 		nanosleep(&ts, NULL);
 	}
 
-	for(;;) {
-		/* Wait a sec */
-		nanosleep(&ts, NULL);
+#ifdef HAVE_INOTIFY
+	/* Watch before scanning so that nothing dropped in between is missed */
+	if ((pfd.fd = inotify_init()) < 0) {
+		tris_log(LOG_WARNING, "Unable to initialize inotify, polling %s instead: %s\n", qdir, strerror(errno));
+	} else if (fcntl(pfd.fd, F_SETFL, O_NONBLOCK) ||
+		inotify_add_watch(pfd.fd, qdir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_ATTRIB | IN_DELETE | IN_MOVED_FROM) < 0) {
+		tris_log(LOG_WARNING, "Unable to watch %s, polling it instead: %s\n", qdir, strerror(errno));
+		close(pfd.fd);
+		pfd.fd = -1;
+	}
+	spool_stats.inotify = pfd.fd > -1;
+#endif
+	scan_dir();
+
+	for (;;) {
 		time(&now);
+		if (now != rate_second) {
+			rate_second = now;
+			rate_count = 0;
+		}
 
-		if (stat(qdir, &st)) {
-			tris_log(LOG_WARNING, "Unable to stat %s\n", qdir);
+		/* Service the call file due first, if it is due and the rate allows */
+		tris_heap_wrlock(spool_due);
+		sf = tris_heap_peek(spool_due, 1);
+		if (sf && sf->next <= now && maxrate && rate_count >= maxrate) {
+			spool_stats.throttled++;
+			timeout = 1000;
+			sf = NULL;
+		} else if (sf && sf->next <= now) {
+			tris_heap_pop(spool_due);
+			/* Popping leaves the old index behind, and it is not in the heap now */
+			sf->__heap_index = -1;
+			ao2_ref(sf, +1);
+			timeout = 0;
+		} else {
+			timeout = sf ? MIN(sf->next - now, 3600) * 1000 : -1;
+			sf = NULL;
+		}
+		tris_heap_unlock(spool_due);
+
+		if (sf) {
+			service_file(sf, now);
+			ao2_ref(sf, -1);
+			rate_count++;
+#ifdef HAVE_INOTIFY
+			/* Keep up with the directory while working through a backlog */
+			if (pfd.fd > -1)
+				read_events(pfd.fd);
+#endif
 			continue;
 		}
 
-		/* Make sure it is time for us to execute our check */
-		if ((st.st_mtime == last) && (next && (next > now)))
+#ifdef HAVE_INOTIFY
+		if (pfd.fd > -1) {
+			if (tris_poll(&pfd, 1, timeout) > 0)
+				read_events(pfd.fd);
 			continue;
-		
-#if 0
-		printf("atime: %ld, mtime: %ld, ctime: %ld\n", st.st_atime, st.st_mtime, st.st_ctime);
-		printf("Ooh, something changed / timeout\n");
+		}
 #endif
-		next = 0;
-		last = st.st_mtime;
-
-		if (!(dir = opendir(qdir))) {
-			tris_log(LOG_WARNING, "Unable to open directory %s: %s\n", qdir, strerror(errno));
+		/* No inotify, so look at the directory every second */
+		if (timeout < 0 || timeout > 1000)
+			timeout = 1000;
+		ts.tv_sec = timeout / 1000;
+		ts.tv_nsec = 0;
+		nanosleep(&ts, NULL);
+		if (stat(qdir, &st)) {
+			tris_log(LOG_WARNING, "Unable to stat %s\n", qdir);
 			continue;
 		}
-
-		while ((de = readdir(dir))) {
-			snprintf(fn, sizeof(fn), "%s/%s", qdir, de->d_name);
-			if (stat(fn, &st)) {
-				tris_log(LOG_WARNING, "Unable to stat %s: %s\n", fn, strerror(errno));
-				continue;
-			}
-			if (!S_ISREG(st.st_mode))
-				continue;
-			if (st.st_mtime <= now) {
-				res = scan_service(fn, now, st.st_atime);
-				if (res > 0) {
-					/* Update next service time */
-					if (!next || (res < next)) {
-						next = res;
-					}
-				} else if (res) {
-					tris_log(LOG_WARNING, "Failed to scan service '%s'\n", fn);
-				} else if (!next) {
-					/* Expired entry: must recheck on the next go-around */
-					next = st.st_mtime;
-				}
-			} else {
-				/* Update "next" update if necessary */
-				if (!next || (st.st_mtime < next))
-					next = st.st_mtime;
-			}
+		if (st.st_mtime != last) {
+			last = st.st_mtime;
+			scan_dir();
 		}
-		closedir(dir);
 	}
 	return NULL;
 }
@@ -668,26 +898,29 @@ static void *scan_monitor(void *unused)
 	DIR *dir;
 	struct dirent *de;
 	char fn[256];
-	time_t now, interval = 1*24*3600;
+	time_t now, oldest, interval = 1*24*3600;
 	struct timespec ts = { .tv_sec = 1 };
 	const char *mdir = "/usr/local/spool/trismedia/monitor/";
-  
+
 	while (!tris_fully_booted) {
 		nanosleep(&ts, NULL);
 	}
 
 	for(;;) {
-		/* Wait a sec */
-		nanosleep(&ts, NULL);
 		time(&now);
+		/* Recordings made from now on are newer, so sleep until the oldest one left is old enough */
+		oldest = now;
+		ts.tv_sec = 60;
 
 		if (stat(mdir, &st)) {
 			tris_log(LOG_WARNING, "Unable to stat %s\n", mdir);
+			nanosleep(&ts, NULL);
 			continue;
 		}
 
 		if (!(dir = opendir(mdir))) {
 			tris_log(LOG_WARNING, "Unable to open directory %s: %s\n", mdir, strerror(errno));
+			nanosleep(&ts, NULL);
 			continue;
 		}
 
@@ -701,19 +934,119 @@ static void *scan_monitor(void *unused)
 				continue;
 			if (st.st_mtime < now - interval) {
 				unlink(fn);
+				spool_stats.monitor_removed++;
 				continue;
 			}
+			if (st.st_mtime < oldest)
+				oldest = st.st_mtime;
 		}
 		closedir(dir);
+
+		ts.tv_sec = MAX(oldest + interval - now, 1);
+		nanosleep(&ts, NULL);
 	}
 	return NULL;
 }
 
+static char *handle_cli_spool_show(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+	struct spool_file *sf;
+	size_t queued, i;
+	int due = 0;
+	time_t now, next = 0;
+
+	switch (cmd) {
+	case CLI_INIT:
+		e->command = "spool show";
+		e->usage =
+			"Usage: spool show\n"
+			"       Show the call files waiting in the outgoing spool and\n"
+			"       how many have been dispatched.\n";
+		return NULL;
+	case CLI_GENERATE:
+		return NULL;
+	}
+
+	if (a->argc != e->args)
+		return CLI_SHOWUSAGE;
+
+	time(&now);
+	tris_heap_rdlock(spool_due);
+	queued = tris_heap_size(spool_due);
+	if ((sf = tris_heap_peek(spool_due, 1)))
+		next = sf->next;
+	for (i = 1; i <= queued && (sf = tris_heap_peek(spool_due, i)); i++) {
+		if (sf->next <= now)
+			due++;
+	}
+	tris_heap_unlock(spool_due);
+
+	tris_cli(a->fd, "Outgoing spool: %s (%s)\n", qdir, spool_stats.inotify ? "inotify" : "polled");
+	tris_cli(a->fd, "Max rate:       ");
+	if (maxrate)
+		tris_cli(a->fd, "%d call files per second\n", maxrate);
+	else
+		tris_cli(a->fd, "unlimited\n");
+	tris_cli(a->fd, "Queued:         %d\n", (int) queued);
+	tris_cli(a->fd, "Due now:        %d\n", due);
+	if (next > now)
+		tris_cli(a->fd, "Next due in:    %ld seconds\n", (long) (next - now));
+	tris_cli(a->fd, "Calls running:  %d\n", spool_stats.inflight);
+	tris_cli(a->fd, "Files seen:     %d\n", spool_stats.files_seen);
+	tris_cli(a->fd, "Dispatched:     %d\n", spool_stats.dispatched);
+	tris_cli(a->fd, "Failed:         %d\n", spool_stats.failed);
+	tris_cli(a->fd, "Throttled:      %d\n", spool_stats.throttled);
+	tris_cli(a->fd, "inotify events: %d\n", spool_stats.events);
+	tris_cli(a->fd, "Full rescans:   %d\n", spool_stats.rescans);
+	tris_cli(a->fd, "Old recordings removed: %d\n", spool_stats.monitor_removed);
+
+	return CLI_SUCCESS;
+}
+
+static struct tris_cli_entry cli_spool[] = {
+	TRIS_CLI_DEFINE(handle_cli_spool_show, "Show outgoing spool statistics"),
+};
+
+static int load_config(int reload)
+{
+	struct tris_config *cfg;
+	struct tris_variable *v;
+	struct tris_flags config_flags = { reload ? CONFIG_FLAG_FILEUNCHANGED : 0 };
+
+	if ((cfg = tris_config_load("pbx_spool.conf", config_flags)) == CONFIG_STATUS_FILEUNCHANGED)
+		return 0;
+	if (cfg == CONFIG_STATUS_FILEINVALID) {
+		tris_log(LOG_ERROR, "Config file pbx_spool.conf is in an invalid format.  Aborting.\n");
+		return -1;
+	}
+
+	maxrate = DEFAULT_MAXRATE;
+	if (!cfg)
+		return 0;
+
+	for (v = tris_variable_browse(cfg, "general"); v; v = v->next) {
+		if (!strcasecmp(v->name, "maxrate")) {
+			if (sscanf(v->value, "%30d", &maxrate) != 1 || maxrate < 0) {
+				tris_log(LOG_WARNING, "Invalid maxrate '%s' at line %d of pbx_spool.conf\n", v->value, v->lineno);
+				maxrate = DEFAULT_MAXRATE;
+			}
+		}
+	}
+	tris_config_destroy(cfg);
+
+	return 0;
+}
+
 static int unload_module(void)
 {
 	return -1;
 }
 
+static int reload(void)
+{
+	return load_config(1);
+}
+
 static int load_module(void)
 {
 	pthread_t thread, mthread;
@@ -725,6 +1058,16 @@ static int load_module(void)
 	}
 	snprintf(qdonedir, sizeof(qdir), "%s/%s", tris_config_TRIS_SPOOL_DIR, "outgoing_done");
 
+	if (load_config(0))
+		return TRIS_MODULE_LOAD_DECLINE;
+
+	if (!(spool_files = ao2_container_alloc(SPOOL_FILE_BUCKETS, spool_file_hash, spool_file_cmp)))
+		return TRIS_MODULE_LOAD_FAILURE;
+	if (!(spool_due = tris_heap_create(8, spool_file_due_cmp, offsetof(struct spool_file, __heap_index)))) {
+		ao2_ref(spool_files, -1);
+		return TRIS_MODULE_LOAD_FAILURE;
+	}
+
 	if ((ret = tris_pthread_create_detached_background(&thread, NULL, scan_thread, NULL))) {
 		tris_log(LOG_WARNING, "Unable to create thread :( (returned error: %d)\n", ret);
 		return TRIS_MODULE_LOAD_FAILURE;
@@ -735,7 +1078,13 @@ static int load_module(void)
 		return TRIS_MODULE_LOAD_FAILURE;
 	}
 
+	tris_cli_register_multiple(cli_spool, ARRAY_LEN(cli_spool));
+
 	return TRIS_MODULE_LOAD_SUCCESS;
 }
 
-TRIS_MODULE_INFO_STANDARD(TRISMEDIA_GPL_KEY, "Outgoing Spool Support");
+TRIS_MODULE_INFO(TRISMEDIA_GPL_KEY, TRIS_MODFLAG_DEFAULT, "Outgoing Spool Support",
+		.load = load_module,
+		.unload = unload_module,
+		.reload = reload,
+	       );
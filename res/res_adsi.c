@@ -239,7 +239,7 @@ static int __adsi_transmit_messages(struct tris_channel *chan, unsigned char **m
 						if (f->subclass == 'D')
 							tris_debug(1, "Off-hook capable CPE only, not ADSI\n");
 						else
-							tris_log(LOG_WARNING, "Unknown ADSI response '%c'\n", f->subclass);
+							tris_log(LOG_WARNING, "Unknown ADSI response '%c'\n", (int) f->subclass);
 						if (!chan->adsicpe)
 							chan->adsicpe = TRIS_ADSI_UNAVAILABLE;
 						errno =	ENOSYS;
@@ -1506,7 +1506,7 @@ static int handle_recordfile(struct tris_channel *chan, AGI *agi, int argc, char
 	int silence = 0;                /* amount of silence to allow */
 	int gotsilence = 0;             /* did we timeout for silence? */
 	char *silencestr = NULL;
-	int rfmt = 0;
+	format_t rfmt = 0;
 
 	/* XXX EAGI FIXME XXX */
 
@@ -1609,7 +1609,7 @@ static int handle_recordfile(struct tris_channel *chan, AGI *agi, int argc, char
 					tris_stream_rewind(fs, 200);
 					tris_truncstream(fs);
 					sample_offset = tris_tellstream(fs);
-					tris_agi_send(agi->fd, chan, "200 result=%d (dtmf) endpos=%ld\n", f->subclass, sample_offset);
+					tris_agi_send(agi->fd, chan, "200 result=%d (dtmf) endpos=%ld\n", (int) f->subclass, sample_offset);
 					tris_closestream(fs);
 					tris_frfree(f);
 					if (sildet)
@@ -2138,7 +2138,8 @@ static int handle_speechrecognize(struct tris_channel *chan, AGI *agi, int argc,
 {
 	struct tris_speech *speech = agi->speech;
 	char *prompt, dtmf = 0, tmp[4096] = "", *buf = tmp;
-	int timeout = 0, offset = 0, old_read_format = 0, res = 0, i = 0;
+	int timeout = 0, offset = 0, res = 0, i = 0;
+	format_t old_read_format = 0;
 	long current_offset = 0;
 	const char *reason = NULL;
 	struct tris_frame *fr = NULL;
@@ -3286,7 +3287,8 @@ static int agi_exec(struct tris_channel *chan, void *data)
 
 static int eagi_exec(struct tris_channel *chan, void *data)
 {
-	int readformat, res;
+	format_t readformat;
+	int res;
 
 	if (tris_check_hangup(chan)) {
 		tris_log(LOG_ERROR, "EAGI cannot be run on a dead/hungup channel, please use AGI.\n");
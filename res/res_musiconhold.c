@@ -129,7 +129,7 @@ static int respawn_time = 20;
 struct moh_files_state {
 	struct mohclass *class;
 	char name[MAX_MUSICCLASS];
-	int origwfmt;
+	format_t origwfmt;
 	int samples;
 	int sample_queue;
 	int pos;
@@ -165,7 +165,7 @@ struct mohclass {
 	int total_files;
 	unsigned int flags;
 	/*! The format from the MOH source, not applicable to "files" mode */
-	int format;
+	format_t format;
 	/*! The pid of the external application delivering MOH */
 	int pid;
 	time_t start;
@@ -183,7 +183,7 @@ struct mohclass {
 
 struct mohdata {
 	int pipe[2];
-	int origwfmt;
+	format_t origwfmt;
 	struct mohclass *parent;
 	struct tris_frame f;
 	TRIS_LIST_ENTRY(mohdata) list;
@@ -245,7 +245,7 @@ static void moh_files_release(struct tris_channel *chan, void *data)
 	}
 
 	if (state->origwfmt && tris_set_write_format(chan, state->origwfmt)) {
-		tris_log(LOG_WARNING, "Unable to restore channel '%s' to format '%d'\n", chan->name, state->origwfmt);
+		tris_log(LOG_WARNING, "Unable to restore channel '%s' to format '%s'\n", chan->name, tris_getformatname(state->origwfmt));
 	}
 
 	state->save_pos = state->pos;
@@ -831,7 +831,7 @@ static void moh_release(struct tris_channel *chan, void *data)
 {
 	struct mohdata *moh = data;
 	struct mohclass *class = moh->parent;
-	int oldwfmt;
+	format_t oldwfmt;
 
 	ao2_lock(class);
 	TRIS_LIST_REMOVE(&moh->parent->members, moh, list);	
@@ -0,0 +1,1211 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 1999 - 2006, Digium, Inc.
+ *
+ * Mark Spencer <markster@digium.com>
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ *
+ * \brief Code shared by the SIP based channel drivers
+ *
+ * \author Mark Spencer <markster@digium.com>
+ */
+
+#include "trismedia.h"
+
+TRISMEDIA_FILE_VERSION(__FILE__, "$Revision$")
+
+#include <ctype.h>
+
+#include "trismedia/module.h"
+#include "trismedia/lock.h"
+#include "trismedia/linkedlists.h"
+#include "trismedia/logger.h"
+#include "trismedia/utils.h"
+#include "trismedia/strings.h"
+#include "trismedia/callerid.h"
+#include "trismedia/cli.h"
+#include "trismedia/netsock.h"
+#include "trismedia/threadstorage.h"
+#include "trismedia/astobj2.h"
+
+#include "trismedia/sip_core.h"
+
+/*! \brief Max amount of UDP packets queued on one worker thread */
+#define SIP_WORKER_MAXQUEUE	1000
+
+/*! \brief Largest packet queued for a batched send, bigger ones are sent right away */
+#define SIP_BATCH_MTU		4096
+
+/*! \brief  Parse multiline SIP headers into one header
+	This is enabled if pedanticsipchecking is enabled */
+int sip_lws2sws(char *msgbuf, int len)
+{
+	int h = 0, t = 0; 
+	int lws = 0; 
+
+	for (; h < len;) { 
+		/* Eliminate all CRs */ 
+		if (msgbuf[h] == '\r') { 
+			h++; 
+			continue; 
+		} 
+		/* Check for end-of-line */ 
+		if (msgbuf[h] == '\n') { 
+			/* Check for end-of-message */ 
+			if (h + 1 == len) 
+				break; 
+			/* Check for a continuation line */ 
+			if (msgbuf[h + 1] == ' ' || msgbuf[h + 1] == '\t') { 
+				/* Merge continuation line */ 
+				h++; 
+				continue; 
+			} 
+			/* Propagate LF and start new line */ 
+			msgbuf[t++] = msgbuf[h++]; 
+			lws = 0;
+			continue; 
+		} 
+		if (msgbuf[h] == ' ' || msgbuf[h] == '\t') { 
+			if (lws) { 
+				h++; 
+				continue; 
+			} 
+			msgbuf[t++] = msgbuf[h++]; 
+			lws = 1; 
+			continue; 
+		} 
+		msgbuf[t++] = msgbuf[h++]; 
+		if (lws) 
+			lws = 0; 
+	} 
+	msgbuf[t] = '\0'; 
+	return t; 
+}
+
+/*! \brief Locate closing quote in a string, skipping escaped quotes.
+ * optionally with a limit on the search.
+ * start must be past the first quote.
+ */
+const char *sip_find_closing_quote(const char *start, const char *lim)
+{
+	char last_char = '\0';
+	const char *s;
+	for (s = start; *s && s != lim; last_char = *s++) {
+		if (*s == '"' && last_char != '\\')
+			break;
+	}
+	return s;
+}
+
+/*! \brief Pick out text in brackets from character string
+	\return pointer to terminated stripped string
+	\param tmp input string that will be modified
+	Examples:
+\verbatim
+	"foo" <bar>	valid input, returns bar
+	foo		returns the whole string
+	< "foo ... >	returns the string between brackets
+	< "foo...	bogus (missing closing bracket), returns the whole string
+			XXX maybe should still skip the opening bracket
+\endverbatim
+ */
+char *sip_get_in_brackets(char *tmp)
+{
+	const char *parse = tmp;
+	char *first_bracket;
+
+	/*
+	 * Skip any quoted text until we find the part in brackets.
+	* On any error give up and return the full string.
+	*/
+	while ( (first_bracket = strchr(parse, '<')) ) {
+		char *first_quote = strchr(parse, '"');
+
+		if (!first_quote || first_quote > first_bracket)
+			break; /* no need to look at quoted part */
+		/* the bracket is within quotes, so ignore it */
+		parse = sip_find_closing_quote(first_quote + 1, NULL);
+		if (!*parse) { /* not found, return full string ? */
+			/* XXX or be robust and return in-bracket part ? */
+			tris_log(LOG_WARNING, "No closing quote found in '%s'\n", tmp);
+			break;
+		}
+		parse++;
+	}
+	if (first_bracket) {
+		char *second_bracket = strchr(first_bracket + 1, '>');
+		if (second_bracket) {
+			*second_bracket = '\0';
+			tmp = first_bracket + 1;
+		} else {
+			tris_log(LOG_WARNING, "No closing bracket found in '%s'\n", tmp);
+		}
+	}
+	
+	return tmp;
+}
+
+/*! \brief * parses a URI in its components.
+ *
+ * \note 
+ * - If scheme is specified, drop it from the top.
+ * - If a component is not requested, do not split around it.
+ * - Multiple scheme's can be specified ',' delimited. ex: "sip:,sips:"
+ *
+ * This means that if we don't have domain, we cannot split
+ * name:pass and domain:port.
+ * It is safe to call with ret_name, pass, domain, port
+ * pointing all to the same place.
+ * Init pointers to empty string so we never get NULL dereferencing.
+ * Overwrites the string.
+ * return 0 on success, other values on error.
+ * \verbatim 
+ * general form we are expecting is sip[s]:username[:password][;parameter]@host[:port][;...] 
+ * \endverbatim
+ * 
+ */
+int sip_parse_uri(char *uri, const char *scheme,
+	char **ret_name, char **pass, char **domain, char **port, char **options, char **transport)
+{
+	char *name = NULL;
+	int error = 0;
+
+	/* init field as required */
+	if (pass)
+		*pass = "";
+	if (port)
+		*port = "";
+	if (scheme) {
+		int l;
+		char *scheme2 = tris_strdupa(scheme);
+		char *cur = strsep(&scheme2, ",");
+		for (; !tris_strlen_zero(cur); cur = strsep(&scheme2, ",")) {
+			l = strlen(cur);
+			if (!strncasecmp(uri, cur, l)) {
+				uri += l;
+				break;
+			}
+		}
+		if (tris_strlen_zero(cur)) {
+			tris_debug(1, "No supported scheme found in '%s' using the scheme[s] %s\n", uri, scheme);
+			error = -1;
+		}
+	}
+	if (transport) {
+		char *t, *type = "";
+		*transport = "";
+		if ((t = strstr(uri, "transport="))) {
+			strsep(&t, "=");
+			if ((type = strsep(&t, ";"))) {
+				*transport = type;
+			}
+		}
+	}
+
+	if (!domain) {
+		/* if we don't want to split around domain, keep everything as a name,
+		 * so we need to do nothing here, except remember why.
+		 */
+	} else {
+		/* store the result in a temp. variable to avoid it being
+		 * overwritten if arguments point to the same place.
+		 */
+		char *c, *dom = "";
+
+		if ((c = strchr(uri, '@')) == NULL) {
+			/* domain-only URI, according to the SIP RFC. */
+			dom = uri;
+			name = "";
+		} else {
+			*c++ = '\0';
+			dom = c;
+			name = uri;
+		}
+
+		/* Remove options in domain and name */
+		dom = strsep(&dom, ";");
+		name = strsep(&name, ";");
+
+		if (port && (c = strchr(dom, ':'))) { /* Remove :port */
+			*c++ = '\0';
+			*port = c;
+		}
+		if (pass && (c = strchr(name, ':'))) {	/* user:password */
+			*c++ = '\0';
+			*pass = c;
+		}
+		*domain = dom;
+	}
+	if (ret_name)	/* same as for domain, store the result only at the end */
+		*ret_name = name;
+	if (options)
+		*options = uri ? uri : "";
+
+	return error;
+}
+
+/* \brief Remove URI parameters at end of URI, not in username part though */
+char *sip_remove_uri_parameters(char *uri)
+{
+	char *atsign;
+	atsign = strchr(uri, '@');	/* First, locate the at sign */
+	if (!atsign)
+		atsign = uri;	/* Ok hostname only, let's stick with the rest */
+	atsign = strchr(atsign, ';');	/* Locate semi colon */
+	if (atsign)
+		*atsign = '\0';	/* Kill at the semi colon */
+	return uri;
+}
+
+/*!
+ * Terminate the uri at the first ';' or space.
+ * Technically we should ignore escaped space per RFC3261 (19.1.1 etc)
+ * but don't do it for the time being. Remember the uri format is:
+ * (User-parameters was added after RFC 3261)
+ *\verbatim
+ *
+ *	sip:user:password;user-parameters@host:port;uri-parameters?headers
+ *	sips:user:password;user-parameters@host:port;uri-parameters?headers
+ *
+ *\endverbatim
+ * \todo As this function does not support user-parameters, it's considered broken
+ *	and needs fixing.
+ */
+char *sip_terminate_uri(char *uri)
+{
+	char *t = uri;
+	while (*t && *t > ' ' && *t != ';')
+		t++;
+	*t = '\0';
+	return uri;
+}
+
+/*! \brief  Get caller id name from SIP headers */
+char *sip_get_calleridname(const char *input, char *output, size_t outputsize)
+{
+	const char *end = strchr(input, '<');	/* first_bracket */
+	const char *tmp = strchr(input, '"');	/* first quote */
+	int bytes = 0;
+	int maxbytes = outputsize - 1;
+
+	if (!end || end == input)	/* we require a part in brackets */
+		return NULL;
+
+	end--; /* move just before "<" */
+
+	if (tmp && tmp <= end) {
+		/* The quote (tmp) precedes the bracket (end+1).
+		 * Find the matching quote and return the content.
+		 */
+		end = strchr(tmp+1, '"');
+		if (!end)
+			return NULL;
+		bytes = (int) (end - tmp);
+		/* protect the output buffer */
+		if (bytes > maxbytes)
+			bytes = maxbytes;
+		tris_copy_string(output, tmp + 1, bytes);
+	} else {
+		/* No quoted string, or it is inside brackets. */
+		/* clear the empty characters in the begining*/
+		input = tris_skip_blanks(input);
+		/* clear the empty characters in the end */
+		while(*end && *end < 33 && end > input)
+			end--;
+		if (end >= input) {
+			bytes = (int) (end - input) + 2;
+			/* protect the output buffer */
+			if (bytes > maxbytes)
+				bytes = maxbytes;
+			tris_copy_string(output, input, bytes);
+		} else
+			return NULL;
+	}
+	return output;
+}
+
+/*! \brief  Get caller id number from Remote-Party-ID header field 
+ *	Returns true if number should be restricted (privacy setting found)
+ *	output is set to NULL if no number found
+ */
+int sip_get_rpid_num(const char *input, char *output, int maxlen)
+{
+	char *start;
+	char *end;
+
+	start = strchr(input, ':');
+	if (!start) {
+		output[0] = '\0';
+		return 0;
+	}
+	start++;
+
+	/* we found "number" */
+	tris_copy_string(output, start, maxlen);
+	output[maxlen-1] = '\0';
+
+	end = strchr(output, '@');
+	if (end)
+		*end = '\0';
+	else
+		output[0] = '\0';
+	if (strstr(input, "privacy=full") || strstr(input, "privacy=uri"))
+		return TRIS_PRES_PROHIB_USER_NUMBER_NOT_SCREENED;
+
+	return 0;
+}
+
+/*! \brief Reads one line of SIP message body */
+char *sip_get_body_by_line(const char *line, const char *name, int nameLen, char delimiter)
+{
+	if (!strncasecmp(line, name, nameLen) && line[nameLen] == delimiter)
+		return tris_skip_blanks(line + nameLen + 1);
+
+	return "";
+}
+
+/*! \brief converts ascii port to int representation. If no
+ *  pt buffer is provided or the pt has errors when being converted
+ *  to an int value, the port provided as the standard is used.
+ */
+int sip_port_str2int(const char *pt, unsigned int standard)
+{
+	int port = standard;
+	if (tris_strlen_zero(pt) || (sscanf(pt, "%30d", &port) != 1) || (port < 1) || (port > 65535)) {
+		port = standard;
+	}
+
+	return port;
+}
+
+/*! \brief Generate 32 byte random string for callid's etc */
+char *sip_generate_random_string(char *buf, size_t size)
+{
+	long val[4];
+	int x;
+
+	for (x=0; x<4; x++)
+		val[x] = tris_random();
+	snprintf(buf, size, "%08lx%08lx%08lx%08lx", val[0], val[1], val[2], val[3]);
+
+	return buf;
+}
+
+/*! \brief Make our SIP dialog tag */
+void sip_make_our_tag(char *tagbuf, size_t len)
+{
+	snprintf(tagbuf, len, "as%08lx", tris_random());
+}
+
+/*! \brief Names of the indexed headers, with their compact form if they have one */
+static const struct sip_header_name {
+	enum sip_header_id id;
+	const char *fullname;
+	const char *shortname;
+} sip_header_names[] = {
+	{ SIP_HDR_ACCEPT,		"Accept",		NULL },
+	{ SIP_HDR_ACCEPT_CONTACT,	"Accept-Contact",	"a" },
+	{ SIP_HDR_ALLOW,		"Allow",		NULL },
+	{ SIP_HDR_ALLOW_EVENTS,		"Allow-Events",		"u" },
+	{ SIP_HDR_ALSO,			"Also",			NULL },
+	{ SIP_HDR_AUTHORIZATION,	"Authorization",	NULL },
+	{ SIP_HDR_CALL_ID,		"Call-ID",		"i" },
+	{ SIP_HDR_CONTACT,		"Contact",		"m" },
+	{ SIP_HDR_CONTENT_ENCODING,	"Content-Encoding",	"e" },
+	{ SIP_HDR_CONTENT_LENGTH,	"Content-Length",	"l" },
+	{ SIP_HDR_CONTENT_TYPE,		"Content-Type",		"c" },
+	{ SIP_HDR_CSEQ,			"CSeq",			NULL },
+	{ SIP_HDR_DIVERSION,		"Diversion",		NULL },
+	{ SIP_HDR_ERROR_INFO,		"Error-Info",		NULL },
+	{ SIP_HDR_EVENT,		"Event",		"o" },
+	{ SIP_HDR_EXPIRES,		"Expires",		NULL },
+	{ SIP_HDR_FROM,			"From",			"f" },
+	{ SIP_HDR_IDENTITY,		"Identity",		"y" },
+	{ SIP_HDR_IDENTITY_INFO,	"Identity-Info",	"n" },
+	{ SIP_HDR_MAX_FORWARDS,		"Max-Forwards",		NULL },
+	{ SIP_HDR_MIN_EXPIRES,		"Min-Expires",		NULL },
+	{ SIP_HDR_MIN_SE,		"Min-SE",		NULL },
+	{ SIP_HDR_P_ASSERTED_IDENTITY,	"P-Asserted-Identity",	NULL },
+	{ SIP_HDR_PRIVACY,		"Privacy",		NULL },
+	{ SIP_HDR_PROXY_AUTHENTICATE,	"Proxy-Authenticate",	NULL },
+	{ SIP_HDR_PROXY_AUTHORIZATION,	"Proxy-Authorization",	NULL },
+	{ SIP_HDR_RECORD_ROUTE,		"Record-Route",		NULL },
+	{ SIP_HDR_REFER_TO,		"Refer-To",		"r" },
+	{ SIP_HDR_REFERRED_BY,		"Referred-By",		"b" },
+	{ SIP_HDR_REJECT_CONTACT,	"Reject-Contact",	"j" },
+	{ SIP_HDR_REMOTE_PARTY_ID,	"Remote-Party-ID",	NULL },
+	{ SIP_HDR_REPLACES,		"Replaces",		NULL },
+	{ SIP_HDR_REQUEST_DISPOSITION,	"Request-Disposition",	"d" },
+	{ SIP_HDR_REQUIRE,		"Require",		NULL },
+	{ SIP_HDR_ROUTE,		"Route",		NULL },
+	{ SIP_HDR_SESSION_EXPIRES,	"Session-Expires",	"x" },
+	{ SIP_HDR_SUBJECT,		"Subject",		"s" },
+	{ SIP_HDR_SUPPORTED,		"Supported",		"k" },
+	{ SIP_HDR_TO,			"To",			"t" },
+	{ SIP_HDR_USER_AGENT,		"User-Agent",		NULL },
+	{ SIP_HDR_VIA,			"Via",			"v" },
+	{ SIP_HDR_WWW_AUTHENTICATE,	"WWW-Authenticate",	NULL },
+};
+
+/*! \brief Size of the header name hash table, a power of two well above the number of names */
+#define SIP_HEADER_HASH_SIZE	256
+
+/*! \brief Open addressed hash of full and compact header names, to sip_header_names[] index plus one */
+static unsigned char sip_header_hash[SIP_HEADER_HASH_SIZE];
+static int sip_header_hash_built;
+
+static unsigned int sip_header_name_hash(const char *name, size_t len)
+{
+	unsigned int hash = len;
+
+	while (len--)
+		hash = hash * 31 + tolower(*(unsigned char *) name++);
+
+	return hash;
+}
+
+/*! \brief Case insensitive compare of a header name of \a len characters with a nul terminated one */
+static int sip_header_name_match(const char *name, size_t len, const char *other)
+{
+	return other && !strncasecmp(name, other, len) && other[len] == '\0';
+}
+
+static void sip_header_hash_add(const char *name, int entry)
+{
+	unsigned int bucket = sip_header_name_hash(name, strlen(name));
+
+	while (sip_header_hash[bucket % SIP_HEADER_HASH_SIZE])
+		bucket++;
+	sip_header_hash[bucket % SIP_HEADER_HASH_SIZE] = entry + 1;
+}
+
+/*! \brief Build the header name lookup table */
+static void sip_header_index_init(void)
+{
+	int x;
+
+	if (sip_header_hash_built)
+		return;
+
+	for (x = 0; x < ARRAY_LEN(sip_header_names); x++) {
+		sip_header_hash_add(sip_header_names[x].fullname, x);
+		if (sip_header_names[x].shortname)
+			sip_header_hash_add(sip_header_names[x].shortname, x);
+	}
+	sip_header_hash_built = 1;
+}
+
+enum sip_header_id sip_header_id(const char *name, size_t len)
+{
+	unsigned int bucket = sip_header_name_hash(name, len);
+	int entry;
+
+	while ((entry = sip_header_hash[bucket % SIP_HEADER_HASH_SIZE])) {
+		const struct sip_header_name *hdr = &sip_header_names[entry - 1];
+
+		if (sip_header_name_match(name, len, hdr->fullname) || sip_header_name_match(name, len, hdr->shortname))
+			return hdr->id;
+		bucket++;
+	}
+
+	return SIP_HDR_UNKNOWN;
+}
+
+enum sip_header_id sip_header_line_id(const char *line, int allow_blanks)
+{
+	const char *c = line;
+	size_t len;
+
+	while (*c && *c != ':' && *c != ' ' && *c != '\t')
+		c++;
+	len = c - line;
+	if (allow_blanks)
+		c = tris_skip_blanks(c);
+	if (*c != ':' || !len)
+		return SIP_HDR_UNKNOWN;
+
+	return sip_header_id(line, len);
+}
+
+const char *sip_header_compact_name(const char *name, const char *_default)
+{
+	enum sip_header_id id = sip_header_id(name, strlen(name));
+	int x;
+
+	/* sip_header_names[] is in enum order */
+	if (id == SIP_HDR_UNKNOWN)
+		return _default;
+	x = id - 1;
+
+	return sip_header_names[x].shortname ? sip_header_names[x].shortname : _default;
+}
+
+void sip_header_index_add(struct sip_header_index *index, int line, enum sip_header_id id)
+{
+	if (id == SIP_HDR_UNKNOWN || line < 0 || line >= SIP_HEADER_INDEX_MAX)
+		return;
+
+	index->next[line] = 0;
+	if (index->last[id])
+		index->next[index->last[id] - 1] = line + 1;
+	else
+		index->first[id] = line + 1;
+	index->last[id] = line + 1;
+}
+
+int sip_header_index_find(const struct sip_header_index *index, enum sip_header_id id, int start)
+{
+	int line;
+
+	for (line = index->first[id]; line; line = index->next[line - 1]) {
+		if (line - 1 >= start)
+			return line - 1;
+	}
+
+	return -1;
+}
+
+const char *sip_header_value(const char *line)
+{
+	const char *c = strchr(line, ':');
+
+	return c ? tris_skip_blanks(c + 1) : "";
+}
+
+int sip_parse_lines(char *msg, ptrdiff_t *header, int maxheaders, int *headers,
+	ptrdiff_t *line, int maxlines, int *lines, struct sip_header_index *index, int allow_blanks)
+{
+	char *c = msg;
+	ptrdiff_t *dst = header;
+	int i = 0, lim = maxheaders - 1;
+	int nheaders = -1;	/* we are working on the headers */
+	int skipping_headers = 0;
+	int res = 0;
+	char *previous;
+
+	memset(index, 0, sizeof(*index));
+	header[0] = 0;
+	for (; *c; c++) {
+		if (*c == '\r') {		/* remove \r */
+			*c = '\0';
+		} else if (*c == '\n') { 	/* end of this line */
+			*c = '\0';
+			previous = msg + dst[i];
+			if (skipping_headers) {
+				/* check to see if this line is blank; if so, turn off
+				   the skipping flag, so the next line will be processed
+				   as a body line */
+				if (tris_strlen_zero(previous))
+					skipping_headers = 0;
+				dst[i] = (c + 1) - msg; /* record start of next line */
+				continue;
+			}
+			if (tris_strlen_zero(previous) && nheaders < 0) {
+				nheaders = i;	/* record number of header lines */
+				dst = line;	/* start working on the body */
+				i = 0;
+				lim = maxlines - 1;
+			} else {
+				if (nheaders < 0 && i > 0)
+					sip_header_index_add(index, i, sip_header_line_id(previous, allow_blanks));
+				/* move to next line, check for overflows */
+				if (i++ == lim) {
+					/* if we're processing headers, then skip any remaining
+					   headers and move on to processing the body, otherwise
+					   we're done */
+					if (nheaders != -1) {
+						res = -1;
+						break;
+					}
+					nheaders = i;
+					dst = line;
+					i = 0;
+					lim = maxlines - 1;
+					skipping_headers = 1;
+				}
+			}
+			dst[i] = (c + 1) - msg; /* record start of next line */
+		}
+	}
+
+	/* Check for last header or body line without CRLF. The RFC for SDP requires CRLF,
+	   but since some devices send without, we'll be generous in what we accept. However,
+	   if we've already reached the maximum number of lines for portion of the message
+	   we were parsing, we can't accept any more, so just ignore it.
+	*/
+	if ((i < lim) && !tris_strlen_zero(msg + dst[i])) {
+		if (nheaders < 0 && i > 0)
+			sip_header_index_add(index, i, sip_header_line_id(msg + dst[i], allow_blanks));
+		i++;
+	}
+
+	if (nheaders >= 0) {	/* we are in the body */
+		*headers = nheaders;
+		*lines = i;
+	} else {		/* no body */
+		*headers = i;
+		*lines = 0;
+		line[0] = c - msg;
+	}
+
+	return res;
+}
+
+/*! \brief A UDP packet waiting for a worker thread */
+struct sip_worker_packet {
+	struct sip_worker_pool *pool;           /*!< Driver that received the packet */
+	unsigned int hash;                      /*!< Hash of the Call-ID, picks the worker */
+	struct sockaddr_in sin;                 /*!< Where the packet came from */
+	int len;                                /*!< Length of the packet */
+	struct tris_str *data;                  /*!< Packet contents */
+	TRIS_LIST_ENTRY(sip_worker_packet) next;
+};
+
+/*! \brief A thread processing the UDP packets of the dialogs hashed to it */
+struct sip_worker {
+	pthread_t thread;
+	tris_mutex_t lock;                      /*!< Protects the packet queue and the counters */
+	tris_cond_t cond;                       /*!< Signalled when a packet is queued, or the worker goes idle */
+	unsigned int stop:1;                    /*!< Exit, leaving what is queued to the next workers */
+	struct sip_worker_pool *current;        /*!< Driver whose packets are processed, or whose replies are not sent yet */
+	int depth;                              /*!< Packets currently queued */
+	int maxdepth;                           /*!< Highest queue depth seen */
+	int processed;                          /*!< Packets processed */
+	int dropped;                            /*!< Packets dropped because the queue was full */
+	TRIS_LIST_HEAD_NOLOCK(, sip_worker_packet) packets;
+};
+
+/*! \brief A driver queuing packets on the shared workers */
+struct sip_worker_pool {
+	const char *name;
+	sip_worker_process_fn *process;
+	int batch;                              /*!< Packets per send system call */
+	struct tris_udp_batch_stats *stats;     /*!< Where batched sends are counted */
+	int count;                              /*!< Threads asked for by the driver */
+	unsigned int paused:1;                  /*!< Changed with all the worker locks held, see sip_worker_pool_pause() */
+	TRIS_LIST_ENTRY(sip_worker_pool) list;
+};
+
+/*! \brief The drivers using the workers, write locked to replace the workers */
+static TRIS_RWLIST_HEAD_STATIC(sip_worker_pools, sip_worker_pool);
+
+/*! \brief The worker threads shared by all the drivers */
+static struct sip_worker *sip_workers;
+static int sip_worker_count;
+
+/*! \brief Extract the Call-ID of a raw UDP packet and hash it
+ * \note Only used to pick a worker thread, so the packet is not parsed
+ * and compact header form "i:" is recognized as well.
+ * \return hash of the Call-ID, 0 if no Call-ID header was found
+ */
+static int sip_worker_callid_hash(const char *buf)
+{
+	const char *line = buf, *c;
+	char callid[256];
+	int i;
+
+	while (*line && *line != '\r' && *line != '\n') {
+		c = NULL;
+		if (!strncasecmp(line, "Call-ID", 7))
+			c = line + 7;
+		else if ((*line == 'i' || *line == 'I') && (line[1] == ':' || line[1] == ' ' || line[1] == '\t'))
+			c = line + 1;
+		if (c) {
+			c = tris_skip_blanks(c);
+			if (*c == ':') {
+				c = tris_skip_blanks(c + 1);
+				for (i = 0; i < sizeof(callid) - 1 && c[i] && c[i] != '\r' && c[i] != '\n' && c[i] != ' ' && c[i] != '\t'; i++)
+					callid[i] = c[i];
+				callid[i] = '\0';
+				return tris_str_case_hash(callid);
+			}
+		}
+		if (!(line = strchr(line, '\n')))
+			break;
+		line++;
+	}
+	return 0;
+}
+
+/*! \brief Worker thread, processes the UDP packets queued to it in order */
+static void *sip_worker_thread(void *data)
+{
+	struct sip_worker *worker = data;
+	struct sip_worker_packet *packet;
+
+	tris_mutex_lock(&worker->lock);
+	for (;;) {
+		/* Packets of a paused driver wait, the others get past them */
+		TRIS_LIST_TRAVERSE(&worker->packets, packet, next) {
+			if (!packet->pool->paused)
+				break;
+		}
+		if (worker->current && (worker->stop || !packet || packet->pool != worker->current)) {
+			/* Going idle or on to another driver, send the replies queued so far */
+			tris_mutex_unlock(&worker->lock);
+			sip_udp_send_end();
+			tris_mutex_lock(&worker->lock);
+			worker->current = NULL;
+			tris_cond_broadcast(&worker->cond);
+			continue;
+		}
+		if (worker->stop)
+			break;
+		if (!packet) {
+			tris_cond_wait(&worker->cond, &worker->lock);
+			continue;
+		}
+		TRIS_LIST_REMOVE(&worker->packets, packet, next);
+		worker->depth--;
+		worker->current = packet->pool;
+		tris_mutex_unlock(&worker->lock);
+
+		sip_udp_send_begin(packet->pool->batch, packet->pool->stats);
+		packet->pool->process(packet->data, packet->len, &packet->sin);
+		tris_free(packet);
+		tris_atomic_fetchadd_int(&worker->processed, 1);
+
+		tris_mutex_lock(&worker->lock);
+	}
+	tris_mutex_unlock(&worker->lock);
+
+	return NULL;
+}
+
+/*! \brief Append a packet to the queue of a worker
+ * \note The worker must be locked
+ */
+static void sip_worker_append(struct sip_worker *worker, struct sip_worker_packet *packet)
+{
+	TRIS_LIST_INSERT_TAIL(&worker->packets, packet, next);
+	if (++worker->depth > worker->maxdepth)
+		worker->maxdepth = worker->depth;
+	tris_cond_signal(&worker->cond);
+}
+
+int sip_worker_pool_queue(struct sip_worker_pool *pool, struct tris_str *data, int len, struct sockaddr_in *sin)
+{
+	struct sip_worker *worker;
+	struct sip_worker_packet *packet;
+
+	if (!(packet = tris_calloc(1, sizeof(*packet))))
+		return -1;
+	packet->pool = pool;
+	packet->hash = sip_worker_callid_hash(data->str);
+	packet->data = data;
+	packet->len = len;
+	packet->sin = *sin;
+
+	TRIS_RWLIST_RDLOCK(&sip_worker_pools);
+	if (!sip_worker_count) {
+		TRIS_RWLIST_UNLOCK(&sip_worker_pools);
+		tris_free(packet);
+		return -1;
+	}
+	worker = &sip_workers[packet->hash % sip_worker_count];
+	tris_mutex_lock(&worker->lock);
+	if (worker->depth >= SIP_WORKER_MAXQUEUE) {
+		/* The sender will retransmit, don't let the queue grow without bounds */
+		worker->dropped++;
+		tris_mutex_unlock(&worker->lock);
+		TRIS_RWLIST_UNLOCK(&sip_worker_pools);
+		tris_free(packet);
+		return -1;
+	}
+	sip_worker_append(worker, packet);
+	tris_mutex_unlock(&worker->lock);
+	TRIS_RWLIST_UNLOCK(&sip_worker_pools);
+
+	return 0;
+}
+
+/*! \brief Stop and join the first \a count workers of a set */
+static void sip_workers_stop(struct sip_worker *workers, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		tris_mutex_lock(&workers[i].lock);
+		workers[i].stop = 1;
+		tris_cond_signal(&workers[i].cond);
+		tris_mutex_unlock(&workers[i].lock);
+	}
+	for (i = 0; i < count; i++)
+		pthread_join(workers[i].thread, NULL);
+}
+
+/*! \brief Start as many workers as the drivers ask for, moving what is queued over to them
+ * \note sip_worker_pools must be write locked
+ */
+static void sip_workers_resize(void)
+{
+	struct sip_worker_pool *pool;
+	struct sip_worker *workers = NULL;
+	struct sip_worker_packet *packet;
+	int count = 0, started = 0, i;
+
+	TRIS_RWLIST_TRAVERSE(&sip_worker_pools, pool, list) {
+		if (pool->count > count)
+			count = pool->count;
+	}
+	if (count == sip_worker_count)
+		return;
+
+	if (count && !(workers = tris_calloc(count, sizeof(*workers))))
+		return;
+
+	for (started = 0; started < count; started++) {
+		struct sip_worker *worker = &workers[started];
+
+		tris_mutex_init(&worker->lock);
+		tris_cond_init(&worker->cond, NULL);
+		TRIS_LIST_HEAD_INIT_NOLOCK(&worker->packets);
+		if (tris_pthread_create_background(&worker->thread, NULL, sip_worker_thread, worker)) {
+			tris_log(LOG_ERROR, "Unable to start SIP worker thread %d, running with %d\n", started, started);
+			tris_mutex_destroy(&worker->lock);
+			tris_cond_destroy(&worker->cond);
+			break;
+		}
+	}
+	if (!started && count) {
+		/* Keep the workers we have */
+		tris_free(workers);
+		return;
+	}
+
+	/* The packets of a dialog all sit on one old worker, in order, and
+	   move to the same new worker.  Nothing is queued meanwhile. */
+	sip_workers_stop(sip_workers, sip_worker_count);
+	for (i = 0; i < sip_worker_count; i++) {
+		while ((packet = TRIS_LIST_REMOVE_HEAD(&sip_workers[i].packets, next))) {
+			struct sip_worker *worker = &workers[packet->hash % started];
+
+			tris_mutex_lock(&worker->lock);
+			sip_worker_append(worker, packet);
+			tris_mutex_unlock(&worker->lock);
+		}
+		tris_mutex_destroy(&sip_workers[i].lock);
+		tris_cond_destroy(&sip_workers[i].cond);
+	}
+	tris_free(sip_workers);
+
+	sip_workers = workers;
+	sip_worker_count = started;
+	if (started)
+		tris_verb(2, "Processing SIP UDP packets on %d worker threads\n", started);
+}
+
+struct sip_worker_pool *sip_worker_pool_create(const char *name, int count, sip_worker_process_fn *process)
+{
+	struct sip_worker_pool *pool;
+
+	if (count <= 0 || !(pool = tris_calloc(1, sizeof(*pool))))
+		return NULL;
+
+	pool->name = name;
+	pool->process = process;
+	pool->count = count;
+
+	TRIS_RWLIST_WRLOCK(&sip_worker_pools);
+	TRIS_RWLIST_INSERT_TAIL(&sip_worker_pools, pool, list);
+	sip_workers_resize();
+	if (!sip_worker_count) {
+		tris_log(LOG_ERROR, "Unable to start %s worker threads, processing packets on the monitor thread\n", name);
+		TRIS_RWLIST_REMOVE(&sip_worker_pools, pool, list);
+		TRIS_RWLIST_UNLOCK(&sip_worker_pools);
+		tris_free(pool);
+		return NULL;
+	}
+	TRIS_RWLIST_UNLOCK(&sip_worker_pools);
+
+	tris_verb(2, "%s processing UDP packets on the shared worker threads\n", name);
+
+	return pool;
+}
+
+/*! \brief Pause or resume a driver on all the workers at once
+ * \note sip_worker_pools must be locked
+ */
+static void sip_worker_pool_set_paused(struct sip_worker_pool *pool, int paused)
+{
+	int i;
+
+	for (i = 0; i < sip_worker_count; i++)
+		tris_mutex_lock(&sip_workers[i].lock);
+	pool->paused = paused;
+	for (i = sip_worker_count - 1; i >= 0; i--) {
+		tris_cond_broadcast(&sip_workers[i].cond);
+		tris_mutex_unlock(&sip_workers[i].lock);
+	}
+}
+
+void sip_worker_pool_pause(struct sip_worker_pool *pool)
+{
+	int i;
+
+	if (!pool)
+		return;
+
+	TRIS_RWLIST_RDLOCK(&sip_worker_pools);
+	sip_worker_pool_set_paused(pool, 1);
+	for (i = 0; i < sip_worker_count; i++) {
+		struct sip_worker *worker = &sip_workers[i];
+
+		tris_mutex_lock(&worker->lock);
+		while (worker->current == pool)
+			tris_cond_wait(&worker->cond, &worker->lock);
+		tris_mutex_unlock(&worker->lock);
+	}
+	TRIS_RWLIST_UNLOCK(&sip_worker_pools);
+}
+
+void sip_worker_pool_resume(struct sip_worker_pool *pool)
+{
+	if (!pool)
+		return;
+
+	TRIS_RWLIST_RDLOCK(&sip_worker_pools);
+	sip_worker_pool_set_paused(pool, 0);
+	TRIS_RWLIST_UNLOCK(&sip_worker_pools);
+}
+
+/*! \brief Does a worker still have something to do for a driver
+ * \note The worker must be locked
+ */
+static int sip_worker_has_packets(struct sip_worker *worker, struct sip_worker_pool *pool)
+{
+	struct sip_worker_packet *packet;
+
+	if (worker->current == pool)
+		return 1;
+	TRIS_LIST_TRAVERSE(&worker->packets, packet, next) {
+		if (packet->pool == pool)
+			return 1;
+	}
+	return 0;
+}
+
+void sip_worker_pool_destroy(struct sip_worker_pool *pool)
+{
+	int i;
+
+	if (!pool)
+		return;
+
+	/* Holding the write lock, nothing more gets queued */
+	TRIS_RWLIST_WRLOCK(&sip_worker_pools);
+	for (i = 0; i < sip_worker_count; i++) {
+		struct sip_worker *worker = &sip_workers[i];
+
+		tris_mutex_lock(&worker->lock);
+		while (sip_worker_has_packets(worker, pool))
+			tris_cond_wait(&worker->cond, &worker->lock);
+		tris_mutex_unlock(&worker->lock);
+	}
+	TRIS_RWLIST_REMOVE(&sip_worker_pools, pool, list);
+	sip_workers_resize();
+	TRIS_RWLIST_UNLOCK(&sip_worker_pools);
+
+	tris_free(pool);
+}
+
+int sip_worker_pool_size(struct sip_worker_pool *pool)
+{
+	return pool ? pool->count : 0;
+}
+
+void sip_worker_pool_show(struct sip_worker_pool *pool, int fd)
+{
+	int i;
+
+	if (!pool)
+		return;
+
+	TRIS_RWLIST_RDLOCK(&sip_worker_pools);
+	for (i = 0; i < sip_worker_count; i++) {
+		struct sip_worker *worker = &sip_workers[i];
+		int depth, maxdepth, dropped;
+
+		tris_mutex_lock(&worker->lock);
+		depth = worker->depth;
+		maxdepth = worker->maxdepth;
+		dropped = worker->dropped;
+		tris_mutex_unlock(&worker->lock);
+
+		tris_cli(fd, "    Worker %-3d            queued %d (max %d), processed %d, dropped %d\n", i,
+			depth, maxdepth, worker->processed, dropped);
+	}
+	TRIS_RWLIST_UNLOCK(&sip_worker_pools);
+}
+
+void sip_worker_pool_set_batching(struct sip_worker_pool *pool, int size, struct tris_udp_batch_stats *stats)
+{
+	if (!pool)
+		return;
+
+	/* Picked up by each worker when it starts on its next packet */
+	pool->stats = stats;
+	pool->batch = size;
+}
+
+/*! \brief Buckets of the dialog index, prime number preferred */
+#ifdef LOW_MEMORY
+#define SIP_DIALOG_BUCKETS	17
+#else
+#define SIP_DIALOG_BUCKETS	563
+#endif
+
+/*! \brief The dialogs of all the drivers, hashed on their Call-ID */
+static struct ao2_container *sip_dialogs;
+
+static int sip_dialog_hash_cb(const void *obj, const int flags)
+{
+	const struct sip_dialog_key *key = obj;
+
+	return tris_str_case_hash(*key->callid);
+}
+
+static int sip_dialog_cmp_cb(void *obj, void *arg, int flags)
+{
+	struct sip_dialog_key *key = obj, *key2 = arg;
+
+	return key->owner == key2->owner && !strcasecmp(*key->callid, *key2->callid) ? CMP_MATCH | CMP_STOP : 0;
+}
+
+/*! \brief The Call-ID to look for, and the check of the driver */
+struct sip_dialog_match {
+	ao2_callback_data_fn *cb;
+	void *data;
+};
+
+static int sip_dialog_match_cb(void *obj, void *arg, void *data, int flags)
+{
+	struct sip_dialog_match *match = data;
+
+	if (!(sip_dialog_cmp_cb(obj, arg, flags) & CMP_MATCH))
+		return 0;
+
+	return match->cb ? match->cb(obj, arg, match->data, flags) : CMP_MATCH | CMP_STOP;
+}
+
+void sip_dialog_index_link(void *dialog)
+{
+	ao2_t_link(sip_dialogs, dialog, "link dialog into the shared index");
+}
+
+void sip_dialog_index_unlink(void *dialog)
+{
+	ao2_t_unlink(sip_dialogs, dialog, "unlink dialog from the shared index");
+}
+
+void *sip_dialog_index_find(const void *owner, const char *callid, ao2_callback_data_fn *cb, void *data)
+{
+	struct sip_dialog_key key = {
+		.callid = &callid,
+		.owner = owner,
+	};
+	struct sip_dialog_match match = {
+		.cb = cb,
+		.data = data,
+	};
+
+	return ao2_t_callback_data(sip_dialogs, OBJ_POINTER, sip_dialog_match_cb, &key, &match, "find dialog in the shared index");
+}
+
+/*! \brief The send batch of a thread */
+struct sip_udp_sender {
+	struct tris_udp_batch *batch;
+	struct tris_udp_batch_stats *stats;     /*!< Counters the queued packets are counted in */
+	unsigned int active:1;                  /*!< Between sip_udp_send_begin() and sip_udp_send_end() */
+};
+
+static void sip_udp_sender_cleanup(void *data)
+{
+	struct sip_udp_sender *sender = data;
+
+	tris_udp_batch_free(sender->batch);
+	tris_free(sender);
+}
+
+TRIS_THREADSTORAGE_CUSTOM(sip_udp_senders, NULL, sip_udp_sender_cleanup);
+
+void sip_udp_send_begin(int size, struct tris_udp_batch_stats *stats)
+{
+	struct sip_udp_sender *sender;
+
+	if (!(sender = tris_threadstorage_get(&sip_udp_senders, sizeof(*sender))))
+		return;
+
+	if (sender->active) {
+		/* Nested, keep going with the batch already started */
+		return;
+	}
+
+	if (size < 2) {
+		size = 0;
+	} else if (size > TRIS_UDP_BATCH_MAX) {
+		size = TRIS_UDP_BATCH_MAX;
+	}
+	if (tris_udp_batch_size(sender->batch) != size) {
+		tris_udp_batch_free(sender->batch);
+		sender->batch = tris_udp_batch_alloc(size, SIP_BATCH_MTU);
+	}
+	sender->stats = stats;
+	sender->active = sender->batch ? 1 : 0;
+}
+
+ssize_t sip_udp_sendto(int fd, const void *buf, size_t len, const struct sockaddr_in *sin, struct tris_udp_batch_stats *stats)
+{
+	struct sip_udp_sender *sender;
+
+	if ((sender = tris_threadstorage_get(&sip_udp_senders, sizeof(*sender))) && sender->active)
+		return tris_udp_batch_sendto(sender->batch, fd, buf, len, sin, sender->stats);
+
+	return tris_udp_batch_sendto(NULL, fd, buf, len, sin, stats);
+}
+
+void sip_udp_send_end(void)
+{
+	struct sip_udp_sender *sender;
+
+	if (!(sender = tris_threadstorage_get(&sip_udp_senders, sizeof(*sender))) || !sender->active)
+		return;
+
+	tris_udp_batch_flush(sender->batch, sender->stats);
+	sender->active = 0;
+}
+
+static int unload_module(void)
+{
+	ao2_t_ref(sip_dialogs, -1, "unref the shared dialog index");
+
+	return 0;
+}
+
+static int load_module(void)
+{
+	sip_header_index_init();
+
+	if (!(sip_dialogs = ao2_t_container_alloc(SIP_DIALOG_BUCKETS, sip_dialog_hash_cb, sip_dialog_cmp_cb, "allocate the shared dialog index")))
+		return TRIS_MODULE_LOAD_DECLINE;
+
+	return TRIS_MODULE_LOAD_SUCCESS;
+}
+
+TRIS_MODULE_INFO(TRISMEDIA_GPL_KEY, TRIS_MODFLAG_GLOBAL_SYMBOLS, "Code shared by the SIP channel drivers",
+		.load = load_module,
+		.unload = unload_module
+	);
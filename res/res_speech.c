@@ -173,7 +173,7 @@ struct tris_speech *tris_speech_new(char *engine_name, int formats)
 {
 	struct tris_speech_engine *engine = NULL;
 	struct tris_speech *new_speech = NULL;
-	int format = TRIS_FORMAT_SLINEAR;
+	format_t format = TRIS_FORMAT_SLINEAR;
 
 	/* Try to find the speech recognition engine that was requested */
 	if (!(engine = find_engine(engine_name)))
@@ -0,0 +1,188 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 2009, Digium, Inc.
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ *
+ * \brief Codec comparison test module
+ *
+ * Encodes and decodes the same few seconds of voice like audio with each
+ * of the given codecs, 20ms at a time, and reports the time spent per
+ * frame and the bitrate, for example to compare opus with speex16.
+ */
+
+/*** MODULEINFO
+	<defaultenabled>no</defaultenabled>
+ ***/
+
+#include "trismedia.h"
+
+#include <math.h>
+
+TRISMEDIA_FILE_VERSION(__FILE__, "$Revision$")
+
+#include "trismedia/module.h"
+#include "trismedia/cli.h"
+#include "trismedia/utils.h"
+#include "trismedia/time.h"
+#include "trismedia/frame.h"
+#include "trismedia/translate.h"
+
+/*! \brief Frames of 20ms coded per codec */
+#define TEST_FRAMES	500
+
+/*! \brief A 150Hz voice with a few harmonics, in syllables of 200ms, over some noise */
+static void fill_voice(short *buf, int samples, int rate)
+{
+	int i, h;
+
+	for (i = 0; i < samples; i++) {
+		double t = (double) i / rate;
+		double v = 0;
+
+		for (h = 1; h <= 5; h++)
+			v += sin(2 * M_PI * 150 * h * t) / h;
+		v *= 0.5 + 0.5 * sin(2 * M_PI * 2.5 * t);
+		buf[i] = 6000 * v + (int) (tris_random() % 200) - 100;
+	}
+}
+
+/*! \brief Code the audio with one codec and print a line for it */
+static int bench_codec(int fd, const char *name)
+{
+	format_t format = tris_getformatbyname(name), slin;
+	struct tris_trans_pvt *encoder = NULL, *decoder = NULL;
+	short *audio;
+	int rate, framesamples, i, bytes = 0, packets = 0;
+	int64_t us_encode = 0, us_decode = 0;
+
+	if (!(format & TRIS_FORMAT_AUDIO_MASK) || (format & (format - 1))) {
+		tris_cli(fd, "%-10s not a single audio format\n", name);
+		return -1;
+	}
+
+	/* Feed wideband codecs wideband audio */
+	slin = tris_format_rate(format) >= 16000 ? TRIS_FORMAT_SLINEAR16 : TRIS_FORMAT_SLINEAR;
+	rate = tris_format_rate(slin);
+	framesamples = rate / 50;
+
+	if (!(encoder = tris_translator_build_path(format, slin)) ||
+		!(decoder = tris_translator_build_path(slin, format))) {
+		tris_cli(fd, "%-10s no translation path to and from %s\n", name, tris_getformatname(slin));
+		if (encoder)
+			tris_translator_free_path(encoder);
+		return -1;
+	}
+
+	if (!(audio = tris_malloc(TEST_FRAMES * framesamples * sizeof(*audio)))) {
+		tris_translator_free_path(encoder);
+		tris_translator_free_path(decoder);
+		return -1;
+	}
+	fill_voice(audio, TEST_FRAMES * framesamples, rate);
+
+	for (i = 0; i < TEST_FRAMES; i++) {
+		struct tris_frame in = {
+			.frametype = TRIS_FRAME_VOICE,
+			.subclass = slin,
+			.datalen = framesamples * sizeof(*audio),
+			.samples = framesamples,
+			.src = "test_codec",
+		};
+		struct tris_frame *coded;
+		struct timeval start;
+
+		in.data.ptr = audio + i * framesamples;
+
+		start = tris_tvnow();
+		coded = tris_translate(encoder, &in, 0);
+		us_encode += tris_tvdiff_us(tris_tvnow(), start);
+		if (!coded)
+			continue;
+
+		bytes += coded->datalen;
+		packets++;
+
+		start = tris_tvnow();
+		tris_translate(decoder, coded, 0);
+		us_decode += tris_tvdiff_us(tris_tvnow(), start);
+	}
+
+	tris_cli(fd, "%-10s %10.2f %10.2f %8.1f %8d\n", name,
+		(double) us_encode / TEST_FRAMES, (double) us_decode / TEST_FRAMES,
+		bytes * 8.0 / (TEST_FRAMES * 20), packets);
+
+	tris_free(audio);
+	tris_translator_free_path(encoder);
+	tris_translator_free_path(decoder);
+
+	return 0;
+}
+
+static char *handle_cli_codec_bench(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+	int i, failures = 0;
+
+	switch (cmd) {
+	case CLI_INIT:
+		e->command = "codec benchmark";
+		e->usage = ""
+			"Usage: codec benchmark <format> [<format> ...]\n"
+			"   Encode and decode the same audio with each format, for\n"
+			"   example 'codec benchmark opus speex16 g722', and show\n"
+			"   the time per 20ms frame and the bitrate.\n"
+			"";
+		return NULL;
+	case CLI_GENERATE:
+		return NULL;
+	}
+
+	if (a->argc < e->args + 1) {
+		return CLI_SHOWUSAGE;
+	}
+
+	tris_cli(a->fd, "Coding %d frames of 20ms with each format ...\n", TEST_FRAMES);
+	tris_cli(a->fd, "%-10s %10s %10s %8s %8s\n", "Format", "Encode us", "Decode us", "kbit/s", "Packets");
+	for (i = e->args; i < a->argc; i++) {
+		if (bench_codec(a->fd, a->argv[i]))
+			failures++;
+	}
+
+	if (failures) {
+		tris_cli(a->fd, "Test failed - %d formats could not be coded\n", failures);
+		return CLI_FAILURE;
+	}
+	tris_cli(a->fd, "Test complete\n");
+
+	return CLI_SUCCESS;
+}
+
+static struct tris_cli_entry cli_codec[] = {
+	TRIS_CLI_DEFINE(handle_cli_codec_bench, "Compare codec CPU use and bitrate"),
+};
+
+static int unload_module(void)
+{
+	tris_cli_unregister_multiple(cli_codec, ARRAY_LEN(cli_codec));
+	return 0;
+}
+
+static int load_module(void)
+{
+	tris_cli_register_multiple(cli_codec, ARRAY_LEN(cli_codec));
+	return TRIS_MODULE_LOAD_SUCCESS;
+}
+
+TRIS_MODULE_INFO_STANDARD(TRISMEDIA_GPL_KEY, "Codec comparison test module");
@@ -0,0 +1,191 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 2009, Digium, Inc.
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ *
+ * \brief Audio mixing kernel test module
+ *
+ * Checks the mixing kernels picked for this CPU against the per sample
+ * saturating helpers, then times a conference of the given size, where
+ * every party hears the mix of all others, 20ms of audio at a time.
+ */
+
+/*** MODULEINFO
+	<defaultenabled>no</defaultenabled>
+ ***/
+
+#include "trismedia.h"
+
+#include <inttypes.h>
+
+TRISMEDIA_FILE_VERSION(__FILE__, "$Revision$")
+
+#include "trismedia/module.h"
+#include "trismedia/cli.h"
+#include "trismedia/utils.h"
+#include "trismedia/time.h"
+#include "trismedia/mix.h"
+
+/*! \brief 20ms of 8kHz audio, plus a few samples to exercise the unrolled loop tails */
+#define TEST_SAMPLES	167
+
+/*! \brief Mixing intervals timed per run */
+#define TEST_TICKS	1000
+
+static void fill_random(short *buf, int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++) {
+		/* Mostly loud audio, so the saturation paths get used */
+		buf[i] = (tris_random() % 65535) - 32767;
+	}
+}
+
+/*! \brief Compare every kernel to the helpers from utils.h, returns the number of mismatches */
+static int check_kernels(void)
+{
+	short a[TEST_SAMPLES], b[TEST_SAMPLES], res[TEST_SAMPLES], ref[TEST_SAMPLES];
+	int acc[TEST_SAMPLES];
+	int i, adjustment, failures = 0;
+
+	fill_random(a, TEST_SAMPLES);
+	fill_random(b, TEST_SAMPLES);
+
+	memcpy(res, a, sizeof(res));
+	memcpy(ref, a, sizeof(ref));
+	tris_mix_add(res, b, TEST_SAMPLES);
+	for (i = 0; i < TEST_SAMPLES; i++)
+		tris_slinear_saturated_add(&ref[i], &b[i]);
+	failures += memcmp(res, ref, sizeof(res)) ? 1 : 0;
+
+	memcpy(res, a, sizeof(res));
+	memcpy(ref, a, sizeof(ref));
+	tris_mix_subtract(res, b, TEST_SAMPLES);
+	for (i = 0; i < TEST_SAMPLES; i++)
+		tris_slinear_saturated_subtract(&ref[i], &b[i]);
+	failures += memcmp(res, ref, sizeof(res)) ? 1 : 0;
+
+	/* Mix minus of a two party mix is the other party */
+	memset(acc, 0, sizeof(acc));
+	tris_mix_accumulate(acc, a, TEST_SAMPLES);
+	tris_mix_accumulate(acc, b, TEST_SAMPLES);
+	tris_mix_minus(res, acc, a, TEST_SAMPLES);
+	failures += memcmp(res, b, sizeof(res)) ? 1 : 0;
+
+	for (adjustment = -40; adjustment <= 40; adjustment += 3) {
+		short adjust_value = abs(adjustment);
+
+		memcpy(res, a, sizeof(res));
+		memcpy(ref, a, sizeof(ref));
+		tris_mix_gain(res, TEST_SAMPLES, adjustment);
+		for (i = 0; i < TEST_SAMPLES; i++) {
+			if (adjustment > 0)
+				tris_slinear_saturated_multiply(&ref[i], &adjust_value);
+			else if (adjustment < 0)
+				tris_slinear_saturated_divide(&ref[i], &adjust_value);
+		}
+		failures += memcmp(res, ref, sizeof(res)) ? 1 : 0;
+	}
+
+	return failures;
+}
+
+static char *handle_cli_mix_bench(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+	unsigned int parties, i, tick;
+	short *in, *out;
+	int acc[TEST_SAMPLES];
+	struct timeval start;
+	int64_t us_total;
+	int failures;
+
+	switch (cmd) {
+	case CLI_INIT:
+		e->command = "mix benchmark";
+		e->usage = ""
+			"Usage: mix benchmark <parties>\n"
+			"   Check the audio mixing kernels and time mixing a\n"
+			"   conference of <parties> parties.\n"
+			"";
+		return NULL;
+	case CLI_GENERATE:
+		return NULL;
+	}
+
+	if (a->argc != e->args + 1) {
+		return CLI_SHOWUSAGE;
+	}
+
+	if (sscanf(a->argv[e->args], "%u", &parties) != 1 || parties < 2 || parties > 10000) {
+		return CLI_SHOWUSAGE;
+	}
+
+	tris_cli(a->fd, "Checking %s mixing kernels ...\n", tris_mix_kernel());
+	if ((failures = check_kernels())) {
+		tris_cli(a->fd, "Test failed - %d kernels do not match the per sample helpers\n", failures);
+		return CLI_FAILURE;
+	}
+
+	if (!(in = tris_malloc(parties * TEST_SAMPLES * sizeof(*in)))) {
+		return CLI_FAILURE;
+	}
+	if (!(out = tris_malloc(parties * TEST_SAMPLES * sizeof(*out)))) {
+		tris_free(in);
+		return CLI_FAILURE;
+	}
+	fill_random(in, parties * TEST_SAMPLES);
+
+	tris_cli(a->fd, "Mixing %u parties for %d intervals ...\n", parties, TEST_TICKS);
+
+	start = tris_tvnow();
+	for (tick = 0; tick < TEST_TICKS; tick++) {
+		memset(acc, 0, sizeof(acc));
+		for (i = 0; i < parties; i++) {
+			tris_mix_accumulate(acc, in + i * TEST_SAMPLES, TEST_SAMPLES);
+		}
+		for (i = 0; i < parties; i++) {
+			tris_mix_minus(out + i * TEST_SAMPLES, acc, in + i * TEST_SAMPLES, TEST_SAMPLES);
+		}
+	}
+	us_total = tris_tvdiff_us(tris_tvnow(), start);
+
+	tris_cli(a->fd, "Test complete - %" PRIi64 " us, %.2f us per interval, %.3f%% of one core at 20ms intervals\n",
+		us_total, (double) us_total / TEST_TICKS, us_total / (TEST_TICKS * 200.0));
+
+	tris_free(in);
+	tris_free(out);
+
+	return CLI_SUCCESS;
+}
+
+static struct tris_cli_entry cli_mix[] = {
+	TRIS_CLI_DEFINE(handle_cli_mix_bench, "Check and benchmark the audio mixing kernels"),
+};
+
+static int unload_module(void)
+{
+	tris_cli_unregister_multiple(cli_mix, ARRAY_LEN(cli_mix));
+	return 0;
+}
+
+static int load_module(void)
+{
+	tris_cli_register_multiple(cli_mix, ARRAY_LEN(cli_mix));
+	return TRIS_MODULE_LOAD_SUCCESS;
+}
+
+TRIS_MODULE_INFO_STANDARD(TRISMEDIA_GPL_KEY, "Audio mixing kernel test module");
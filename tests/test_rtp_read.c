@@ -0,0 +1,206 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 2009, Digium, Inc.
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ *
+ * \brief RTP receive path performance test module
+ *
+ * Sends ulaw RTP packets over the loopback interface to an RTP session and
+ * times reading them back with tris_rtp_read() and tris_file_read(), which
+ * share one header parser, and reports the time spent per packet.
+ */
+
+/*** MODULEINFO
+	<defaultenabled>no</defaultenabled>
+ ***/
+
+#include "trismedia.h"
+
+#include <inttypes.h>
+
+TRISMEDIA_FILE_VERSION(__FILE__, "$Revision$")
+
+#include "trismedia/module.h"
+#include "trismedia/cli.h"
+#include "trismedia/utils.h"
+#include "trismedia/time.h"
+#include "trismedia/frame.h"
+#include "trismedia/rtp.h"
+
+/*! \brief Packets sent before reading them back, small enough for the socket buffer */
+#define TEST_BURST	128
+
+/*! \brief 20ms of ulaw */
+#define TEST_SAMPLES	160
+
+enum test_reader {
+	TEST_RTP_READ,
+	TEST_RTP_READAHEAD,
+	TEST_FILE_READ,
+};
+
+static const char * const reader_names[] = {
+	[TEST_RTP_READ] = "tris_rtp_read",
+	[TEST_RTP_READAHEAD] = "tris_rtp_read, read ahead",
+	[TEST_FILE_READ] = "tris_file_read",
+};
+
+static int send_burst(int s, struct sockaddr_in *to, unsigned int seqno, unsigned int count)
+{
+	unsigned char pkt[12 + TEST_SAMPLES];
+	unsigned int *header = (unsigned int *) pkt;
+	unsigned int i;
+
+	memset(pkt, 0xff, sizeof(pkt));
+
+	for (i = 0; i < count; i++, seqno++) {
+		header[0] = htonl((2 << 30) | (0 << 16) | (seqno & 0xffff));
+		header[1] = htonl(seqno * TEST_SAMPLES);
+		header[2] = htonl(0x12345678);
+		if (sendto(s, pkt, sizeof(pkt), 0, (struct sockaddr *) to, sizeof(*to)) != sizeof(pkt)) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*! \brief Read back one burst, returns the number of voice frames seen */
+static unsigned int read_burst(struct tris_rtp *rtp, enum test_reader reader, unsigned int count)
+{
+	struct tris_frame *f;
+	unsigned int frames = 0, i;
+
+	for (i = 0; i < count; i++) {
+		if (reader == TEST_FILE_READ) {
+			f = tris_file_read(rtp);
+		} else {
+			/* With read ahead this only makes a system call once the batch is used up */
+			f = tris_rtp_read(rtp);
+		}
+		if (f && f->frametype != TRIS_FRAME_NULL) {
+			frames++;
+		}
+	}
+
+	return frames;
+}
+
+static char *handle_cli_rtp_read_bench(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+	struct sockaddr_in us, them;
+	struct in_addr loopback = { .s_addr = htonl(INADDR_LOOPBACK) };
+	socklen_t len = sizeof(them);
+	unsigned int num, sent, frames;
+	int s, reader;
+	struct timeval start;
+	int64_t us_total;
+
+	switch (cmd) {
+	case CLI_INIT:
+		e->command = "rtp read benchmark";
+		e->usage = ""
+			"Usage: rtp read benchmark <num>\n"
+			"   Send <num> RTP packets over loopback and report the time\n"
+			"   spent reading each one back.\n"
+			"";
+		return NULL;
+	case CLI_GENERATE:
+		return NULL;
+	}
+
+	if (a->argc != e->args + 1) {
+		return CLI_SHOWUSAGE;
+	}
+
+	if (sscanf(a->argv[e->args], "%u", &num) != 1 || !num) {
+		return CLI_SHOWUSAGE;
+	}
+
+	if ((s = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
+		tris_cli(a->fd, "Unable to create socket: %s\n", strerror(errno));
+		return CLI_FAILURE;
+	}
+
+	memset(&them, 0, sizeof(them));
+	them.sin_family = AF_INET;
+	them.sin_addr = loopback;
+	if (bind(s, (struct sockaddr *) &them, sizeof(them)) || getsockname(s, (struct sockaddr *) &them, &len)) {
+		tris_cli(a->fd, "Unable to bind socket: %s\n", strerror(errno));
+		close(s);
+		return CLI_FAILURE;
+	}
+
+	for (reader = TEST_RTP_READ; reader <= TEST_FILE_READ; reader++) {
+		struct tris_rtp *rtp;
+
+		if (!(rtp = tris_rtp_new_with_bindaddr(NULL, NULL, 0, 0, loopback))) {
+			tris_cli(a->fd, "Unable to create RTP session\n");
+			close(s);
+			return CLI_FAILURE;
+		}
+		tris_rtp_set_peer(rtp, &them);
+		tris_rtp_get_us(rtp, &us);
+		if (reader == TEST_RTP_READAHEAD) {
+			tris_rtp_set_readahead(rtp);
+		}
+
+		tris_cli(a->fd, "Reading %u packets with %s ...\n", num, reader_names[reader]);
+
+		us_total = 0;
+		frames = 0;
+		for (sent = 0; sent < num; sent += TEST_BURST) {
+			unsigned int count = MIN(TEST_BURST, num - sent);
+
+			if (send_burst(s, &us, sent, count)) {
+				tris_cli(a->fd, "Unable to send RTP packets: %s\n", strerror(errno));
+				tris_rtp_destroy(rtp);
+				close(s);
+				return CLI_FAILURE;
+			}
+			start = tris_tvnow();
+			frames += read_burst(rtp, reader, count);
+			us_total += tris_tvdiff_us(tris_tvnow(), start);
+		}
+
+		tris_cli(a->fd, "Test complete - %" PRIi64 " us, %.1f ns/packet, %u of %u frames read\n",
+			us_total, us_total * 1000.0 / num, frames, num);
+
+		tris_rtp_destroy(rtp);
+	}
+
+	close(s);
+
+	return CLI_SUCCESS;
+}
+
+static struct tris_cli_entry cli_rtp_read[] = {
+	TRIS_CLI_DEFINE(handle_cli_rtp_read_bench, "Benchmark the RTP receive path"),
+};
+
+static int unload_module(void)
+{
+	tris_cli_unregister_multiple(cli_rtp_read, ARRAY_LEN(cli_rtp_read));
+	return 0;
+}
+
+static int load_module(void)
+{
+	tris_cli_register_multiple(cli_rtp_read, ARRAY_LEN(cli_rtp_read));
+	return TRIS_MODULE_LOAD_SUCCESS;
+}
+
+TRIS_MODULE_INFO_STANDARD(TRISMEDIA_GPL_KEY, "RTP receive path performance test module");
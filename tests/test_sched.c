@@ -38,118 +38,103 @@ TRISMEDIA_FILE_VERSION(__FILE__, "$Revision: 187677 $")
 #include "trismedia/utils.h"
 #include "trismedia/sched.h"
 
+static const char *sched_type_names[] = {
+	[SCHED_CONTEXT_HEAP] = "heap",
+	[SCHED_CONTEXT_WHEEL] = "wheel",
+};
+
 static int sched_cb(const void *data)
 {
 	return 0;
 }
 
-static char *handle_cli_sched_test(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+/*! \brief Add 3 scheduler entries, and then remove them, ensuring that the result
+ * of tris_sched_wait() looks appropriate at each step along the way. */
+static int test_ordering(int fd, enum sched_context_type type)
 {
 	struct sched_context *con;
-	char *res = CLI_FAILURE;
+	int res = -1;
 	int id1, id2, id3, wait;
 
-	switch (cmd) {
-	case CLI_INIT:
-		e->command = "sched test";
-		e->usage = ""
-			"Usage: sched test\n"
-			"   Test scheduler entry ordering.\n"
-			"";
-		return NULL;
-	case CLI_GENERATE:
-		return NULL;
-	}
-
-	if (a->argc != e->args) {
-		return CLI_SHOWUSAGE;
-	}
-
-	tris_cli(a->fd, "Testing scheduler entry ordering ...\n");
-
-	if (!(con = sched_context_create())) {
-		tris_cli(a->fd, "Test failed - could not create scheduler context\n");
-		return CLI_FAILURE;
+	if (!(con = sched_context_create_type(type))) {
+		tris_cli(fd, "Test failed - could not create scheduler context\n");
+		return -1;
 	}
 
-	/* Add 3 scheduler entries, and then remove them, ensuring that the result
-	 * of tris_sched_wait() looks appropriate at each step along the way. */
-
 	if ((wait = tris_sched_wait(con)) != -1) {
-		tris_cli(a->fd, "tris_sched_wait() should have returned -1, returned '%d'\n",
+		tris_cli(fd, "tris_sched_wait() should have returned -1, returned '%d'\n",
 				wait);
 		goto return_cleanup;
 	}
 
 	if ((id1 = tris_sched_add(con, 100000, sched_cb, NULL)) == -1) {
-		tris_cli(a->fd, "Failed to add scheduler entry\n");
+		tris_cli(fd, "Failed to add scheduler entry\n");
 		goto return_cleanup;
 	}
 
 	if ((wait = tris_sched_wait(con)) > 100000) {
-		tris_cli(a->fd, "tris_sched_wait() should have returned <= 100000, returned '%d'\n",
+		tris_cli(fd, "tris_sched_wait() should have returned <= 100000, returned '%d'\n",
 				wait);
 		goto return_cleanup;
 	}
 
 	if ((id2 = tris_sched_add(con, 10000, sched_cb, NULL)) == -1) {
-		tris_cli(a->fd, "Failed to add scheduler entry\n");
+		tris_cli(fd, "Failed to add scheduler entry\n");
 		goto return_cleanup;
 	}
 
 	if ((wait = tris_sched_wait(con)) > 10000) {
-		tris_cli(a->fd, "tris_sched_wait() should have returned <= 10000, returned '%d'\n",
+		tris_cli(fd, "tris_sched_wait() should have returned <= 10000, returned '%d'\n",
 				wait);
 		goto return_cleanup;
 	}
 
 	if ((id3 = tris_sched_add(con, 1000, sched_cb, NULL)) == -1) {
-		tris_cli(a->fd, "Failed to add scheduler entry\n");
+		tris_cli(fd, "Failed to add scheduler entry\n");
 		goto return_cleanup;
 	}
 
 	if ((wait = tris_sched_wait(con)) > 1000) {
-		tris_cli(a->fd, "tris_sched_wait() should have returned <= 1000, returned '%d'\n",
+		tris_cli(fd, "tris_sched_wait() should have returned <= 1000, returned '%d'\n",
 				wait);
 		goto return_cleanup;
 	}
 
 	if (tris_sched_del(con, id3) == -1) {
-		tris_cli(a->fd, "Failed to remove scheduler entry\n");
+		tris_cli(fd, "Failed to remove scheduler entry\n");
 		goto return_cleanup;
 	}
 
-	if ((wait = tris_sched_wait(con)) <= 1000) {
-		tris_cli(a->fd, "tris_sched_wait() should have returned > 1000, returned '%d'\n",
+	/* The timing wheel may wake up early to move entries to the next level down */
+	if (type == SCHED_CONTEXT_HEAP && (wait = tris_sched_wait(con)) <= 1000) {
+		tris_cli(fd, "tris_sched_wait() should have returned > 1000, returned '%d'\n",
 				wait);
 		goto return_cleanup;
 	}
 
 	if (tris_sched_del(con, id2) == -1) {
-		tris_cli(a->fd, "Failed to remove scheduler entry\n");
+		tris_cli(fd, "Failed to remove scheduler entry\n");
 		goto return_cleanup;
 	}
 
-	if ((wait = tris_sched_wait(con)) <= 10000) {
-		tris_cli(a->fd, "tris_sched_wait() should have returned > 10000, returned '%d'\n",
+	if (type == SCHED_CONTEXT_HEAP && (wait = tris_sched_wait(con)) <= 10000) {
+		tris_cli(fd, "tris_sched_wait() should have returned > 10000, returned '%d'\n",
 				wait);
 		goto return_cleanup;
 	}
 
 	if (tris_sched_del(con, id1) == -1) {
-		tris_cli(a->fd, "Failed to remove scheduler entry\n");
+		tris_cli(fd, "Failed to remove scheduler entry\n");
 		goto return_cleanup;
 	}
 
 	if ((wait = tris_sched_wait(con)) != -1) {
-		tris_cli(a->fd, "tris_sched_wait() should have returned -1, returned '%d'\n",
+		tris_cli(fd, "tris_sched_wait() should have returned -1, returned '%d'\n",
 				wait);
 		goto return_cleanup;
 	}
 
-	res = CLI_SUCCESS;
-
-	tris_cli(a->fd, "Test passed!\n");
+	res = 0;
 
 return_cleanup:
 	sched_context_destroy(con);
@@ -157,70 +142,169 @@ return_cleanup:
 	return res;
 }
 
-static char *handle_cli_sched_bench(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+/*! \brief Entries to run, in the 600 ms after they are added */
+#define TEST_RUN_ENTRIES	1000
+#define TEST_RUN_SPAN		600
+
+struct test_run {
+	struct timeval when;	/*!< When the entry should run */
+	int ran;
+	int late;		/*!< How late it ran, in ms */
+};
+
+static int test_run_cb(const void *data)
+{
+	struct test_run *run = (struct test_run *) data;
+
+	run->ran = 1;
+	run->late = tris_tvdiff_ms(tris_tvnow(), run->when);
+	return 0;
+}
+
+/*! \brief Run entries spread over more than one turn of the timing wheel root,
+ * ensuring that none runs early or is lost */
+static int test_running(int fd, enum sched_context_type type)
 {
 	struct sched_context *con;
+	struct test_run *runs;
 	struct timeval start;
-	unsigned int num, i;
-	int *sched_ids = NULL;
+	int res = -1, i, wait, late = 0;
+
+	if (!(con = sched_context_create_type(type))) {
+		tris_cli(fd, "Test failed - could not create scheduler context\n");
+		return -1;
+	}
+
+	if (!(runs = tris_calloc(TEST_RUN_ENTRIES, sizeof(*runs)))) {
+		tris_cli(fd, "Test failed - memory allocation failure\n");
+		goto return_cleanup;
+	}
+
+	start = tris_tvnow();
+	for (i = 0; i < TEST_RUN_ENTRIES; i++) {
+		int when = abs(tris_random()) % TEST_RUN_SPAN;
+
+		runs[i].when = tris_tvadd(tris_tvnow(), tris_samp2tv(when, 1000));
+		if (tris_sched_add(con, when, test_run_cb, &runs[i]) == -1) {
+			tris_cli(fd, "Failed to add scheduler entry\n");
+			goto return_cleanup;
+		}
+	}
+
+	while ((wait = tris_sched_wait(con)) != -1) {
+		if (tris_tvdiff_ms(tris_tvnow(), start) > TEST_RUN_SPAN * 2) {
+			tris_cli(fd, "Entries still waiting after %d ms\n", TEST_RUN_SPAN * 2);
+			goto return_cleanup;
+		}
+		if (wait) {
+			usleep(wait * 1000);
+		}
+		tris_sched_runq(con);
+	}
+
+	for (i = 0; i < TEST_RUN_ENTRIES; i++) {
+		/* Entries may run up to 1 ms early */
+		if (!runs[i].ran || runs[i].late < -1) {
+			tris_cli(fd, "Entry %d %s\n", i, runs[i].ran ? "ran early" : "did not run");
+			goto return_cleanup;
+		}
+		late = MAX(late, runs[i].late);
+	}
+
+	tris_cli(fd, "%-6s ran %d entries, at most %d ms late\n", sched_type_names[type], TEST_RUN_ENTRIES, late);
+	res = 0;
+
+return_cleanup:
+	sched_context_destroy(con);
+	if (runs) {
+		tris_free(runs);
+	}
+
+	return res;
+}
+
+static char *handle_cli_sched_test(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+	enum sched_context_type type;
 
 	switch (cmd) {
 	case CLI_INIT:
-		e->command = "sched benchmark";
+		e->command = "sched test";
 		e->usage = ""
-			"Usage: sched test <num>\n"
+			"Usage: sched test\n"
+			"   Test scheduler entry ordering, for the heap and the\n"
+			"   timing wheel.\n"
 			"";
 		return NULL;
 	case CLI_GENERATE:
 		return NULL;
 	}
 
-	if (a->argc != e->args + 1) {
+	if (a->argc != e->args) {
 		return CLI_SHOWUSAGE;
 	}
 
-	if (sscanf(a->argv[e->args], "%u", &num) != 1) {
-		return CLI_SHOWUSAGE;
+	tris_cli(a->fd, "Testing scheduler entry ordering ...\n");
+
+	for (type = SCHED_CONTEXT_HEAP; type <= SCHED_CONTEXT_WHEEL; type++) {
+		if (test_ordering(a->fd, type) || test_running(a->fd, type)) {
+			tris_cli(a->fd, "Test failed for the %s\n", sched_type_names[type]);
+			return CLI_FAILURE;
+		}
 	}
 
-	if (!(con = sched_context_create())) {
-		tris_cli(a->fd, "Test failed - could not create scheduler context\n");
-		return CLI_FAILURE;
+	tris_cli(a->fd, "Test passed!\n");
+
+	return CLI_SUCCESS;
+}
+
+/*! \brief Time adding num entries and deleting them all again
+ * \note Most timers are deleted before they run, like SIP retransmits.
+ */
+static int bench_sched(int fd, enum sched_context_type type, unsigned int num, int *whens)
+{
+	struct sched_context *con;
+	int64_t us_add, us_del;
+	struct timeval start;
+	unsigned int i;
+	int *sched_ids = NULL;
+	int res = -1;
+
+	if (!(con = sched_context_create_type(type))) {
+		tris_cli(fd, "Test failed - could not create scheduler context\n");
+		return -1;
 	}
 
 	if (!(sched_ids = tris_malloc(sizeof(*sched_ids) * num))) {
-		tris_cli(a->fd, "Test failed - memory allocation failure\n");
+		tris_cli(fd, "Test failed - memory allocation failure\n");
 		goto return_cleanup;
 	}
 
-	tris_cli(a->fd, "Testing tris_sched_add() performance - timing how long it takes "
-			"to add %u entries at random time intervals from 0 to 60 seconds\n", num);
-
 	start = tris_tvnow();
 
 	for (i = 0; i < num; i++) {
-		int when = abs(tris_random()) % 60000;
-		if ((sched_ids[i] = tris_sched_add(con, when, sched_cb, NULL)) == -1) {
-			tris_cli(a->fd, "Test failed - sched_add returned -1\n");
+		if ((sched_ids[i] = tris_sched_add(con, whens[i], sched_cb, NULL)) == -1) {
+			tris_cli(fd, "Test failed - sched_add returned -1\n");
 			goto return_cleanup;
 		}
 	}
 
-	tris_cli(a->fd, "Test complete - %" PRIi64 " us\n", tris_tvdiff_us(tris_tvnow(), start));
-
-	tris_cli(a->fd, "Testing tris_sched_del() performance - timing how long it takes "
-			"to delete %u entries with random time intervals from 0 to 60 seconds\n", num);
+	us_add = tris_tvdiff_us(tris_tvnow(), start);
 
 	start = tris_tvnow();
 
 	for (i = 0; i < num; i++) {
 		if (tris_sched_del(con, sched_ids[i]) == -1) {
-			tris_cli(a->fd, "Test failed - sched_del returned -1\n");
+			tris_cli(fd, "Test failed - sched_del returned -1\n");
 			goto return_cleanup;
 		}
 	}
 
-	tris_cli(a->fd, "Test complete - %" PRIi64 " us\n", tris_tvdiff_us(tris_tvnow(), start));
+	us_del = tris_tvdiff_us(tris_tvnow(), start);
+
+	tris_cli(fd, "%-6s %12" PRIi64 " %12" PRIi64 " %10.3f %10.3f\n", sched_type_names[type],
+		us_add, us_del, (double) us_add / num, (double) us_del / num);
+	res = 0;
 
 return_cleanup:
 	sched_context_destroy(con);
@@ -228,6 +312,57 @@ return_cleanup:
 		tris_free(sched_ids);
 	}
 
+	return res;
+}
+
+static char *handle_cli_sched_bench(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+	enum sched_context_type type;
+	unsigned int num, i;
+	int *whens;
+
+	switch (cmd) {
+	case CLI_INIT:
+		e->command = "sched benchmark";
+		e->usage = ""
+			"Usage: sched benchmark <num>\n"
+			"   Time adding <num> entries at random time intervals from\n"
+			"   0 to 60 seconds and deleting them again, for the heap and\n"
+			"   the timing wheel, for example with 100000 entries.\n"
+			"";
+		return NULL;
+	case CLI_GENERATE:
+		return NULL;
+	}
+
+	if (a->argc != e->args + 1) {
+		return CLI_SHOWUSAGE;
+	}
+
+	if (sscanf(a->argv[e->args], "%u", &num) != 1 || !num) {
+		return CLI_SHOWUSAGE;
+	}
+
+	/* Both get the same intervals */
+	if (!(whens = tris_malloc(sizeof(*whens) * num))) {
+		tris_cli(a->fd, "Test failed - memory allocation failure\n");
+		return CLI_FAILURE;
+	}
+	for (i = 0; i < num; i++) {
+		whens[i] = abs(tris_random()) % 60000;
+	}
+
+	tris_cli(a->fd, "Testing tris_sched_add() and tris_sched_del() performance with %u entries\n", num);
+	tris_cli(a->fd, "%-6s %12s %12s %10s %10s\n", "Type", "Add us", "Del us", "Add us/op", "Del us/op");
+
+	for (type = SCHED_CONTEXT_HEAP; type <= SCHED_CONTEXT_WHEEL; type++) {
+		if (bench_sched(a->fd, type, num, whens)) {
+			break;
+		}
+	}
+
+	tris_free(whens);
+
 	return CLI_SUCCESS;
 }
 
@@ -0,0 +1,257 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 2009, Digium, Inc.
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ *
+ * \brief SIP message parser performance test module
+ *
+ * Parses a small corpus of INVITE, REGISTER and OPTIONS messages over and
+ * over with the tokenizer shared by the SIP channel drivers, looking up the
+ * headers find_call() and handle_incoming() need, and reports messages/sec.
+ * The same lookups done by scanning every header line, as the drivers did
+ * before the header index, are timed for comparison.
+ */
+
+/*** MODULEINFO
+	<depend>res_sip_core</depend>
+	<defaultenabled>no</defaultenabled>
+ ***/
+
+#include "trismedia.h"
+
+#include <inttypes.h>
+
+TRISMEDIA_FILE_VERSION(__FILE__, "$Revision$")
+
+#include "trismedia/module.h"
+#include "trismedia/cli.h"
+#include "trismedia/utils.h"
+#include "trismedia/strings.h"
+#include "trismedia/time.h"
+
+#include "trismedia/sip_core.h"
+
+#define TEST_MAX_HEADERS	64
+#define TEST_MAX_LINES		256
+
+static const char * const corpus[] = {
+	"INVITE sip:1000@192.168.1.10 SIP/2.0\r\n"
+	"Via: SIP/2.0/UDP 192.168.1.20:5060;branch=z9hG4bK776asdhds;rport\r\n"
+	"Max-Forwards: 70\r\n"
+	"To: <sip:1000@192.168.1.10>\r\n"
+	"From: \"Alice\" <sip:2000@192.168.1.10>;tag=1928301774\r\n"
+	"Call-ID: a84b4c76e66710@pc33.example.com\r\n"
+	"CSeq: 314159 INVITE\r\n"
+	"Contact: <sip:2000@192.168.1.20:5060>\r\n"
+	"User-Agent: Test Phone 1.0\r\n"
+	"Allow: INVITE, ACK, CANCEL, OPTIONS, BYE, REFER, NOTIFY, MESSAGE, SUBSCRIBE, INFO\r\n"
+	"Supported: replaces, timer\r\n"
+	"Content-Type: application/sdp\r\n"
+	"Content-Length: 142\r\n"
+	"\r\n"
+	"v=0\r\n"
+	"o=alice 2890844526 2890844526 IN IP4 192.168.1.20\r\n"
+	"s=-\r\n"
+	"c=IN IP4 192.168.1.20\r\n"
+	"t=0 0\r\n"
+	"m=audio 49170 RTP/AVP 0 8 101\r\n"
+	"a=rtpmap:0 PCMU/8000\r\n"
+	"a=rtpmap:8 PCMA/8000\r\n"
+	"a=rtpmap:101 telephone-event/8000\r\n",
+
+	"REGISTER sip:192.168.1.10 SIP/2.0\r\n"
+	"Via: SIP/2.0/UDP 192.168.1.21:5060;branch=z9hG4bKnashds7\r\n"
+	"Max-Forwards: 70\r\n"
+	"To: <sip:2001@192.168.1.10>\r\n"
+	"From: <sip:2001@192.168.1.10>;tag=456248\r\n"
+	"Call-ID: 843817637684230@998sdasdh09\r\n"
+	"CSeq: 1826 REGISTER\r\n"
+	"Contact: <sip:2001@192.168.1.21:5060>\r\n"
+	"Authorization: Digest username=\"2001\", realm=\"trismedia\", nonce=\"4a5c1c0b\", uri=\"sip:192.168.1.10\", response=\"6629fae49393a05397450978507c4ef1\", algorithm=MD5\r\n"
+	"Expires: 3600\r\n"
+	"User-Agent: Test Phone 1.0\r\n"
+	"Content-Length: 0\r\n"
+	"\r\n",
+
+	/* compact form */
+	"OPTIONS sip:1000@192.168.1.10 SIP/2.0\r\n"
+	"v: SIP/2.0/UDP 192.168.1.22:5060;branch=z9hG4bKhjhs8ass877\r\n"
+	"Max-Forwards: 70\r\n"
+	"t: <sip:1000@192.168.1.10>\r\n"
+	"f: <sip:2002@192.168.1.10>;tag=1928301774\r\n"
+	"i: a84b4c76e66710\r\n"
+	"CSeq: 63104 OPTIONS\r\n"
+	"m: <sip:2002@192.168.1.22>\r\n"
+	"Accept: application/sdp\r\n"
+	"l: 0\r\n"
+	"\r\n",
+};
+
+/*! \brief The headers looked up for each message, as find_call() and handle_incoming() do */
+static const char * const lookups[] = {
+	"Call-ID", "From", "To", "CSeq", "Via", "Contact", "Content-Length",
+};
+
+/*! \brief Header lookup by scanning all header lines, full name then compact form */
+static const char *scan_header(const char *msg, const ptrdiff_t *header, int headers, const char *name)
+{
+	int pass, x;
+
+	for (pass = 0; name && pass < 2; pass++) {
+		int len = strlen(name);
+		for (x = 0; x < headers; x++) {
+			const char *line = msg + header[x];
+			if (!strncasecmp(line, name, len) && line[len] == ':')
+				return tris_skip_blanks(line + len + 1);
+		}
+		if (pass == 0)
+			name = sip_header_compact_name(name, NULL);
+	}
+
+	return "";
+}
+
+static const char *index_header(const char *msg, const ptrdiff_t *header,
+	const struct sip_header_index *index, const char *name)
+{
+	int x = sip_header_index_find(index, sip_header_id(name, strlen(name)), 0);
+
+	return x < 0 ? "" : sip_header_value(msg + header[x]);
+}
+
+static char *handle_cli_sip_parse_bench(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+	char buf[ARRAY_LEN(corpus)][2048];
+	ptrdiff_t header[TEST_MAX_HEADERS], line[TEST_MAX_LINES];
+	struct sip_header_index index;
+	int headers, lines, pass;
+	unsigned int num, i, x, found = 0;
+	struct timeval start;
+	int64_t us;
+
+	switch (cmd) {
+	case CLI_INIT:
+		e->command = "sip parse benchmark";
+		e->usage = ""
+			"Usage: sip parse benchmark <num>\n"
+			"   Parse <num> SIP messages and report messages/sec.\n"
+			"";
+		return NULL;
+	case CLI_GENERATE:
+		return NULL;
+	}
+
+	if (a->argc != e->args + 1) {
+		return CLI_SHOWUSAGE;
+	}
+
+	if (sscanf(a->argv[e->args], "%u", &num) != 1 || !num) {
+		return CLI_SHOWUSAGE;
+	}
+
+	for (pass = 0; pass < 2; pass++) {
+		tris_cli(a->fd, "Parsing %u messages, header lookup by %s ...\n", num, pass ? "scanning" : "index");
+
+		start = tris_tvnow();
+
+		for (i = 0; i < num; i++) {
+			char *msg = buf[i % ARRAY_LEN(corpus)];
+
+			/* The parser works in place, like on a receive buffer */
+			tris_copy_string(msg, corpus[i % ARRAY_LEN(corpus)], sizeof(buf[0]));
+			sip_parse_lines(msg, header, TEST_MAX_HEADERS, &headers, line, TEST_MAX_LINES, &lines, &index, 0);
+
+			for (x = 0; x < ARRAY_LEN(lookups); x++) {
+				const char *value = pass ? scan_header(msg, header, headers, lookups[x])
+					: index_header(msg, header, &index, lookups[x]);
+				if (*value)
+					found++;
+			}
+		}
+
+		us = tris_tvdiff_us(tris_tvnow(), start);
+		tris_cli(a->fd, "Test complete - %" PRIi64 " us, %.0f messages/sec, %u headers found\n",
+			us, us ? num * 1000000.0 / us : 0.0, found);
+		found = 0;
+	}
+
+	return CLI_SUCCESS;
+}
+
+static char *handle_cli_sip_parse_test(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+	char buf[2048];
+	ptrdiff_t header[TEST_MAX_HEADERS], line[TEST_MAX_LINES];
+	struct sip_header_index index;
+	int headers, lines, i;
+
+	switch (cmd) {
+	case CLI_INIT:
+		e->command = "sip parse test";
+		e->usage = ""
+			"Usage: sip parse test\n"
+			"   Check that indexed header lookups match a scan of the headers.\n"
+			"";
+		return NULL;
+	case CLI_GENERATE:
+		return NULL;
+	}
+
+	if (a->argc != e->args) {
+		return CLI_SHOWUSAGE;
+	}
+
+	for (i = 0; i < ARRAY_LEN(corpus); i++) {
+		int x;
+
+		tris_copy_string(buf, corpus[i], sizeof(buf));
+		sip_parse_lines(buf, header, TEST_MAX_HEADERS, &headers, line, TEST_MAX_LINES, &lines, &index, 0);
+
+		for (x = 0; x < ARRAY_LEN(lookups); x++) {
+			const char *indexed = index_header(buf, header, &index, lookups[x]);
+			const char *scanned = scan_header(buf, header, headers, lookups[x]);
+
+			if (strcmp(indexed, scanned) || !*indexed) {
+				tris_cli(a->fd, "Test failed - message %d header %s: index '%s', scan '%s'\n",
+					i, lookups[x], indexed, scanned);
+				return CLI_FAILURE;
+			}
+		}
+	}
+
+	tris_cli(a->fd, "Test passed!\n");
+
+	return CLI_SUCCESS;
+}
+
+static struct tris_cli_entry cli_sip_parse[] = {
+	TRIS_CLI_DEFINE(handle_cli_sip_parse_bench, "Benchmark SIP message parsing"),
+	TRIS_CLI_DEFINE(handle_cli_sip_parse_test, "Test SIP header index lookups"),
+};
+
+static int unload_module(void)
+{
+	tris_cli_unregister_multiple(cli_sip_parse, ARRAY_LEN(cli_sip_parse));
+	return 0;
+}
+
+static int load_module(void)
+{
+	tris_cli_register_multiple(cli_sip_parse, ARRAY_LEN(cli_sip_parse));
+	return TRIS_MODULE_LOAD_SUCCESS;
+}
+
+TRIS_MODULE_INFO_STANDARD(TRISMEDIA_GPL_KEY, "SIP message parser performance test module");
@@ -0,0 +1,304 @@
+/*
+ * Trismedia -- An open source telephony toolkit.
+ *
+ * Copyright (C) 2009, Digium, Inc.
+ *
+ * See http://www.trismedia.org for more information about
+ * the Trismedia project. Please do not directly contact
+ * any of the maintainers of this project for assistance;
+ * the project provides a web site, mailing lists and IRC
+ * channels for your use.
+ *
+ * This program is free software, distributed under the terms of
+ * the GNU General Public License Version 2. See the LICENSE file
+ * at the top of the source tree.
+ */
+
+/*! \file
+ *
+ * \brief Batched transcoding test module
+ *
+ * Checks the G.711 kernels picked for this CPU against the tables, then
+ * times translating 20ms of u-law to signed linear and back for the given
+ * number of channels, one channel at a time and batched.
+ */
+
+/*** MODULEINFO
+	<defaultenabled>no</defaultenabled>
+ ***/
+
+#include "trismedia.h"
+
+#include <inttypes.h>
+
+TRISMEDIA_FILE_VERSION(__FILE__, "$Revision$")
+
+#include "trismedia/module.h"
+#include "trismedia/cli.h"
+#include "trismedia/utils.h"
+#include "trismedia/time.h"
+#include "trismedia/frame.h"
+#include "trismedia/translate.h"
+#include "trismedia/ulaw.h"
+#include "trismedia/alaw.h"
+#include "trismedia/g711.h"
+
+/*! \brief 20ms of 8kHz audio */
+#define TEST_SAMPLES	160
+
+/*! \brief Intervals timed per run */
+#define TEST_TICKS	1000
+
+/*! \brief Buffers per call when checking the batch kernels */
+#define TEST_BATCH	32
+
+/*!
+ * \brief Compare the batch kernels to the tables, returns the number of mismatches
+ *
+ * The samples are cut into buffers of 1 to 47 samples, so the leftovers at
+ * the end of the buffers get gathered across buffers.
+ */
+static int check_batch_kernels(const short *lin, unsigned char *codes, int total)
+{
+	unsigned char *enc[TEST_BATCH];
+	const unsigned char *cenc[TEST_BATCH];
+	const short *src[TEST_BATCH];
+	short *dec[TEST_BATCH], *res;
+	int samples[TEST_BATCH];
+	int i, n, pos, start, failures = 0;
+
+	if (!(res = tris_malloc(total * sizeof(*res))))
+		return 1;
+
+	for (start = 0; start < total; start = pos) {
+		for (n = 0, pos = start; n < TEST_BATCH && pos < total; n++) {
+			samples[n] = MIN(1 + (pos + n) % 47, total - pos);
+			src[n] = lin + pos;
+			enc[n] = codes + pos;
+			cenc[n] = codes + pos;
+			dec[n] = res + pos;
+			pos += samples[n];
+		}
+		tris_ulaw_encode_batch(enc, src, samples, n);
+		for (i = start; i < pos; i++)
+			failures += codes[i] != TRIS_LIN2MU(lin[i]);
+		tris_ulaw_decode_batch(dec, cenc, samples, n);
+		for (i = start; i < pos; i++)
+			failures += res[i] != TRIS_MULAW(codes[i]);
+		tris_alaw_encode_batch(enc, src, samples, n);
+		for (i = start; i < pos; i++)
+			failures += codes[i] != TRIS_LIN2A(lin[i]);
+		tris_alaw_decode_batch(dec, cenc, samples, n);
+		for (i = start; i < pos; i++)
+			failures += res[i] != TRIS_ALAW(codes[i]);
+	}
+
+	tris_free(res);
+
+	return failures;
+}
+
+/*! \brief Compare the kernels to the tables, returns the number of mismatches */
+static int check_kernels(void)
+{
+	short *lin, res[256];
+	unsigned char *codes;
+	int i, failures = 0;
+
+	lin = tris_malloc(65536 * sizeof(*lin));
+	codes = tris_malloc(65536);
+	if (!lin || !codes) {
+		tris_free(lin);
+		tris_free(codes);
+		return 1;
+	}
+
+	for (i = 0; i < 65536; i++)
+		lin[i] = i - 32768;
+
+	tris_ulaw_encode(codes, lin, 65536);
+	for (i = 0; i < 65536; i++)
+		failures += codes[i] != TRIS_LIN2MU(lin[i]);
+	tris_alaw_encode(codes, lin, 65536);
+	for (i = 0; i < 65536; i++)
+		failures += codes[i] != TRIS_LIN2A(lin[i]);
+
+	for (i = 0; i < 256; i++)
+		codes[i] = i;
+	tris_ulaw_decode(res, codes, 256);
+	for (i = 0; i < 256; i++)
+		failures += res[i] != TRIS_MULAW(i);
+	tris_alaw_decode(res, codes, 256);
+	for (i = 0; i < 256; i++)
+		failures += res[i] != TRIS_ALAW(i);
+
+	failures += check_batch_kernels(lin, codes, 65536);
+
+	tris_free(lin);
+	tris_free(codes);
+
+	return failures;
+}
+
+static void free_paths(struct tris_trans_pvt **paths, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (paths[i])
+			tris_translator_free_path(paths[i]);
+	}
+}
+
+static char *handle_cli_transcode_bench(struct tris_cli_entry *e, int cmd, struct tris_cli_args *a)
+{
+	unsigned int channels, i, tick;
+	unsigned char *ulaw;
+	struct tris_frame *frames, **in, **mid, **out;
+	struct tris_trans_pvt **decoders, **encoders;
+	struct timeval start;
+	int64_t us_single, us_batch;
+	int failures;
+	char *res = CLI_FAILURE;
+
+	switch (cmd) {
+	case CLI_INIT:
+		e->command = "transcode benchmark";
+		e->usage = ""
+			"Usage: transcode benchmark <channels>\n"
+			"   Check the G.711 kernels and time translating u-law to\n"
+			"   signed linear and back for <channels> channels, one at\n"
+			"   a time and batched.\n"
+			"";
+		return NULL;
+	case CLI_GENERATE:
+		return NULL;
+	}
+
+	if (a->argc != e->args + 1) {
+		return CLI_SHOWUSAGE;
+	}
+
+	if (sscanf(a->argv[e->args], "%u", &channels) != 1 || channels < 1 || channels > 10000) {
+		return CLI_SHOWUSAGE;
+	}
+
+	tris_cli(a->fd, "Checking %s G.711 kernels ...\n", tris_g711_kernel());
+	if ((failures = check_kernels())) {
+		tris_cli(a->fd, "Test failed - %d samples do not match the tables\n", failures);
+		return CLI_FAILURE;
+	}
+
+	ulaw = tris_malloc(channels * TEST_SAMPLES);
+	frames = tris_calloc(channels, sizeof(*frames));
+	in = tris_calloc(channels, sizeof(*in));
+	mid = tris_calloc(channels, sizeof(*mid));
+	out = tris_calloc(channels, sizeof(*out));
+	decoders = tris_calloc(channels, sizeof(*decoders));
+	encoders = tris_calloc(channels, sizeof(*encoders));
+	if (!ulaw || !frames || !in || !mid || !out || !decoders || !encoders) {
+		goto cleanup;
+	}
+
+	/* Only codes the encoder produces, so the audio survives a round trip */
+	for (i = 0; i < channels * TEST_SAMPLES; i++)
+		ulaw[i] = TRIS_LIN2MU((short) tris_random());
+
+	for (i = 0; i < channels; i++) {
+		frames[i].frametype = TRIS_FRAME_VOICE;
+		frames[i].subclass = TRIS_FORMAT_ULAW;
+		frames[i].data.ptr = ulaw + i * TEST_SAMPLES;
+		frames[i].datalen = TEST_SAMPLES;
+		frames[i].samples = TEST_SAMPLES;
+		frames[i].src = "test_transcode";
+		in[i] = &frames[i];
+		if (!(decoders[i] = tris_translator_build_path(TRIS_FORMAT_SLINEAR, TRIS_FORMAT_ULAW)) ||
+			!(encoders[i] = tris_translator_build_path(TRIS_FORMAT_ULAW, TRIS_FORMAT_SLINEAR))) {
+			tris_cli(a->fd, "No translation path between ulaw and slin, is codec_ulaw loaded?\n");
+			goto cleanup;
+		}
+	}
+
+	tris_cli(a->fd, "Transcoding %u channels for %d intervals ...\n", channels, TEST_TICKS);
+
+	start = tris_tvnow();
+	for (tick = 0; tick < TEST_TICKS; tick++) {
+		for (i = 0; i < channels; i++) {
+			struct tris_frame *f;
+
+			if ((f = tris_translate(decoders[i], in[i], 0))) {
+				tris_frfree(tris_translate(encoders[i], f, 1));
+			}
+		}
+	}
+	us_single = tris_tvdiff_us(tris_tvnow(), start);
+
+	start = tris_tvnow();
+	for (tick = 0; tick < TEST_TICKS; tick++) {
+		tris_translate_batch(decoders, in, mid, channels);
+		tris_translate_batch(encoders, mid, out, channels);
+		for (i = 0; i < channels; i++) {
+			if (mid[i])
+				tris_frfree(mid[i]);
+			if (out[i])
+				tris_frfree(out[i]);
+		}
+	}
+	us_batch = tris_tvdiff_us(tris_tvnow(), start);
+
+	/* The same audio went through both, so the last frames must match */
+	for (i = 0; i < channels; i++) {
+		struct tris_frame *f;
+
+		tris_translate_batch(&decoders[i], &in[i], &mid[i], 1);
+		if (!mid[i] || !(f = tris_translate(encoders[i], mid[i], 0))) {
+			failures++;
+			continue;
+		}
+		if (f->datalen != TEST_SAMPLES || memcmp(f->data.ptr, ulaw + i * TEST_SAMPLES, TEST_SAMPLES))
+			failures++;
+		tris_frfree(f);
+		tris_frfree(mid[i]);
+	}
+	if (failures) {
+		tris_cli(a->fd, "Test failed - %d channels did not survive the round trip\n", failures);
+		goto cleanup;
+	}
+
+	tris_cli(a->fd, "Test complete - %" PRIi64 " us one at a time, %" PRIi64 " us batched, %.2f us per interval batched\n",
+		us_single, us_batch, (double) us_batch / TEST_TICKS);
+	res = CLI_SUCCESS;
+
+cleanup:
+	if (decoders)
+		free_paths(decoders, channels);
+	if (encoders)
+		free_paths(encoders, channels);
+	tris_free(ulaw);
+	tris_free(frames);
+	tris_free(in);
+	tris_free(mid);
+	tris_free(out);
+	tris_free(decoders);
+	tris_free(encoders);
+
+	return res;
+}
+
+static struct tris_cli_entry cli_transcode[] = {
+	TRIS_CLI_DEFINE(handle_cli_transcode_bench, "Check and benchmark batched transcoding"),
+};
+
+static int unload_module(void)
+{
+	tris_cli_unregister_multiple(cli_transcode, ARRAY_LEN(cli_transcode));
+	return 0;
+}
+
+static int load_module(void)
+{
+	tris_cli_register_multiple(cli_transcode, ARRAY_LEN(cli_transcode));
+	return TRIS_MODULE_LOAD_SUCCESS;
+}
+
+TRIS_MODULE_INFO_STANDARD(TRISMEDIA_GPL_KEY, "Batched transcoding test module");